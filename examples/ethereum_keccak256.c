@@ -9,6 +9,10 @@
  * The difference is in the padding: Keccak uses 0x01, SHA3 uses 0x06.
  * 
  * This implements Keccak-256 optimized for gate circuits.
+ *
+ * Compiled through the RISC-V path this costs ~4.6M gates per hash. When
+ * the hash is the whole computation, build_keccak_256_circuit() emits the
+ * sponge directly (~190K gates per 136-byte block).
  */
 
 #include "../include/zkvm.h"
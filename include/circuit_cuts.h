@@ -0,0 +1,89 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*
+ * circuit_cuts.h - Cut enumeration for local rewriting passes
+ *
+ * A cut of a gate is a set of at most 4 wires (leaves) that separates it
+ * from the inputs; the gate is then a function of the leaves, given by a
+ * 16-bit truth table (leaf i is variable i). Constant wires never appear
+ * as leaves. Rewriting passes pick a cut per gate, replace the gates that
+ * die with it (its maximum fanout-free cone, MFFC) and let DCE drop the
+ * old ones.
+ *
+ * The network needs one driver per wire: run circuit_pass_renumber first.
+ */
+
+#ifndef CIRCUIT_CUTS_H
+#define CIRCUIT_CUTS_H
+
+#include "circuit_passes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CUT_MAX_LEAVES 4
+#define CUT_MAX_PER_GATE 8
+
+typedef struct {
+    uint8_t size;
+    uint32_t leaves[CUT_MAX_LEAVES];    // sorted
+} cut_t;
+
+typedef struct {
+    const riscv_circuit_t* circuit;
+    size_t num_gates;
+    size_t num_wires;
+    int64_t* driver;        // gate index driving each wire, -1 for none
+    uint32_t* refs;         // fanout count, plus one per root
+    uint32_t* level;        // logic level of each wire
+    cut_t* cuts;            // CUT_MAX_PER_GATE per gate, trivial cut excluded
+    uint8_t* num_cuts;
+    uint8_t* claimed;       // wire belongs to an accepted rewrite
+    uint32_t* mffc;         // gates found by the last cut_mffc()
+    size_t mffc_size;
+    uint32_t* stamp;
+    uint16_t* tt;
+    uint32_t epoch;
+} cut_network_t;
+
+// Truth tables of leaves 0..3
+extern const uint16_t cut_var_tt[CUT_MAX_LEAVES];
+
+int cut_network_build(cut_network_t* net, const pass_context_t* ctx);
+void cut_network_free(cut_network_t* net);
+
+static inline const cut_t* cut_network_cuts(const cut_network_t* net, size_t gate, size_t* count) {
+    *count = net->num_cuts[gate];
+    return &net->cuts[gate * CUT_MAX_PER_GATE];
+}
+
+// Function of wire over the cut's leaves
+uint16_t cut_truth_table(cut_network_t* net, uint32_t wire, const cut_t* cut);
+
+// Counts the gates that die with wire when the leaves stay, and lists
+// them in net->mffc
+void cut_mffc(cut_network_t* net, uint32_t wire, const cut_t* cut,
+              size_t* ands, size_t* gates);
+
+// True if neither the cut's leaves nor the last cut_mffc() overlap an
+// accepted rewrite; cut_claim() marks both as taken
+bool cut_is_free(const cut_network_t* net, const cut_t* cut);
+void cut_claim(cut_network_t* net, const cut_t* cut);
+
+// Rebuilds the circuit: gate g with replace[g] set is replaced by
+// emit(circuit, g, leaves of cuts[g], user) over the new circuit, other
+// gates are copied. Orphaned cones are removed with DCE.
+typedef uint32_t (*cut_emit_fn_t)(riscv_circuit_t* circuit, size_t gate,
+                                  const uint32_t* leaves, void* user);
+int cut_network_rewrite(cut_network_t* net, pass_context_t* ctx, const uint8_t* replace,
+                        const cut_t* cuts, cut_emit_fn_t emit, void* user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CIRCUIT_CUTS_H
@@ -0,0 +1,161 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*
+ * circuit_passes.h - Circuit-level optimization passes and the pass manager
+ *
+ * A pass rewrites a finished circuit in place. The only wires it must keep
+ * are the roots: register and PC wires of a compiler, or an explicit output
+ * list. Passes rewrite the roots when they rename or merge wires. Wire IDs
+ * held anywhere else are stale after a pass.
+ *
+ * Any wire no gate drives counts as a free input. Constant folding assumes
+ * CONSTANT_0_WIRE / CONSTANT_1_WIRE carry 0 / 1, as in every circuit the
+ * compiler builds.
+ *
+ * fold, dedup, dce, renumber and lower handle every gate type. The other
+ * passes rewrite AND/XOR circuits only and change nothing on a circuit
+ * with extended gates (riscv_circuit_is_extended()); run "lower" first
+ * when the target needs AND/XOR anyway.
+ *
+ * The pass manager runs an ordered list of passes to a fixpoint and
+ * records gates, ANDs, depth and time around every pass run. New passes
+ * go into the built-in table in pass_manager.c, or are registered at run
+ * time with circuit_pass_register().
+ *
+ *   level   passes                                  iterations
+ *   -----   -------------------------------------   ----------
+ *   -O0     none                                    -
+ *   -O1     fold, dce                               1
+ *   -O2     fold, dedup, dce, renumber              to fixpoint
+ *   -O3     -O2, then sweep, linear, rewrite,       to fixpoint
+ *           andmin, balance; higher iteration limit
+ */
+
+#ifndef CIRCUIT_PASSES_H
+#define CIRCUIT_PASSES_H
+
+#include "riscv_compiler.h"
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What a pass sees: the circuit and pointers to every root wire
+typedef struct {
+    riscv_circuit_t* circuit;
+    uint32_t** roots;
+    size_t num_roots;
+} pass_context_t;
+
+// Returns 1 if the circuit changed, 0 if not, -1 on error
+typedef int (*circuit_pass_fn_t)(pass_context_t* ctx);
+
+typedef struct {
+    const char* name;
+    circuit_pass_fn_t run;
+    const char* description;
+} circuit_pass_t;
+
+// ============================================================================
+// Built-in passes
+// ============================================================================
+
+// Constant and algebraic folding: x^0, x^x, x&0, x&1, x&x, x&~x,
+// x^(x^y) -> y, x&(x&y) -> x&y
+int circuit_pass_fold(pass_context_t* ctx);
+
+// Structural hashing: merges gates with the same type and inputs
+int circuit_pass_dedup(pass_context_t* ctx);
+
+// Drops gates no root depends on
+int circuit_pass_dce(pass_context_t* ctx);
+
+// Compacts gate output wire IDs in gate order and leaves each wire with
+// exactly one driver
+int circuit_pass_renumber(pass_context_t* ctx);
+
+// Cut rewriting: replaces the fanout-free cone of a 4-input cut with the
+// NPN library implementation when that has fewer gates (never more ANDs
+// under OPTIMIZE_AND_COUNT, never deeper under OPTIMIZE_DEPTH). See
+// cut_rewriting.c and npn4_library.h.
+int circuit_pass_rewrite(pass_context_t* ctx);
+
+// AND-count minimization: replaces cuts of up to 4 inputs with
+// implementations using fewer ANDs (exact for 3 inputs and for quadratic
+// 4-input functions). Follows circuit->objective: any AND saving for
+// OPTIMIZE_AND_COUNT, no added gates for OPTIMIZE_GATES, off for
+// OPTIMIZE_DEPTH. See and_minimization.c.
+int circuit_pass_andmin(pass_context_t* ctx);
+
+// Depth balancing: rebuilds chains of same-type gates whose inner gates
+// have no other use as balanced trees, with the same gate count. See
+// depth_balancing.c.
+int circuit_pass_balance(pass_context_t* ctx);
+
+// SAT sweeping: merges wires proven equivalent (or complementary) with
+// MiniSAT, after random simulation proposes the candidates. See
+// sat_sweeping.c.
+int circuit_pass_sweep(pass_context_t* ctx);
+
+// Linear-layer minimization: rebuilds XOR-only networks with Paar's
+// common-subexpression heuristic when that has fewer gates. Off for
+// OPTIMIZE_DEPTH. See linear_minimization.c.
+int circuit_pass_linear(pass_context_t* ctx);
+
+// Lowering: expands OR, NOT, XNOR, MUX and LUT gates into AND/XOR and
+// clears circuit->gate_set
+int circuit_pass_lower(pass_context_t* ctx);
+
+// Expands only the gates gate_set does not allow, then makes gate_set the
+// circuit's. Wire IDs of existing gates are kept. Returns 1 if anything
+// was expanded, 0 if not, -1 on error.
+int riscv_circuit_lower(riscv_circuit_t* circuit, uint32_t gate_set);
+
+// ============================================================================
+// Pass registry
+// ============================================================================
+
+// Adds a pass callable by name (at most 32 run-time passes, names unique)
+int circuit_pass_register(const char* name, circuit_pass_fn_t run, const char* description);
+const circuit_pass_t* circuit_pass_lookup(const char* name);
+
+// ============================================================================
+// Pass manager
+// ============================================================================
+
+typedef struct pass_manager pass_manager_t;
+
+pass_manager_t* pass_manager_create(void);
+// Preset pipeline for -O0..-O3 (see the table above); NULL if out of range
+pass_manager_t* pass_manager_create_preset(int opt_level);
+void pass_manager_destroy(pass_manager_t* pm);
+
+// Append a pass by name; -1 if no such pass
+int pass_manager_add(pass_manager_t* pm, const char* name);
+// Upper bound on full rounds through the list (default 8)
+void pass_manager_set_max_iterations(pass_manager_t* pm, size_t max_iterations);
+
+// Run the list until a round changes nothing. outputs may be NULL
+// when num_outputs is 0; they are rewritten in place.
+int pass_manager_run(pass_manager_t* pm, riscv_circuit_t* circuit,
+                     uint32_t* outputs, size_t num_outputs);
+// Roots are registers x1..x31, the PC and the memory's state wires
+// (riscv_memory_roots(): cells, leaf, root and interface wires)
+int pass_manager_run_compiler(pass_manager_t* pm, riscv_compiler_t* compiler);
+
+// Parses "-O0".."-O3" (or "0".."3"); -1 otherwise
+int pass_manager_parse_opt_level(const char* arg);
+
+// JSON report of the last run
+int pass_manager_write_report(const pass_manager_t* pm, FILE* out);
+int pass_manager_save_report(const pass_manager_t* pm, const char* filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CIRCUIT_PASSES_H
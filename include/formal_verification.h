@@ -12,7 +12,6 @@
  * 3. Bounded model checking for zkVM constraints
  * 4. Property-based verification
  * 5. Differential testing
- * 6. Compositional verification
  */
 
 #ifndef FORMAL_VERIFICATION_H
@@ -27,7 +26,7 @@ extern "C" {
 #endif
 
 // Forward declarations to avoid circular dependencies
-typedef struct circuit circuit_t;
+typedef struct riscv_circuit circuit_t;
 typedef struct riscv_compiler riscv_compiler_t;
 typedef uint32_t riscv_instruction_t;
 
@@ -49,6 +48,15 @@ typedef struct {
     char* counterexample;        // NULL if verified, otherwise shows failing case
 } verification_result_t;
 
+// Frees the counterexample
+void verification_result_free(verification_result_t* result);
+
+// verified means proven for all inputs. A result that proved some bits and
+// only simulated the rest ("sat+simulation", or a pipeline containing one)
+// is not verified; if simulation found no mismatch it has no
+// counterexample, and this returns true.
+bool verification_result_simulated(const verification_result_t* result);
+
 // ============================================================================
 // Layer 1: Reference Implementations
 // ============================================================================
@@ -77,23 +85,118 @@ word32_t ref_mul(word32_t a, word32_t b);
 // Layer 2: SAT-Based Equivalence Checking
 // ============================================================================
 
-typedef struct sat_solver sat_solver_t;  // Forward declaration
+/*
+ * The circuit and a reference are encoded into one MiniSAT instance over
+ * shared variables for the PC and x1..x31. Both go through a structurally
+ * hashed AND/XOR graph, so identical structure maps to the same literal and
+ * the reference for an operand pair is encoded once per solver. The miter
+ * compares the full next state (PC and x1..x31) bit by bit: every bit is
+ * one solve under the assumption that the two sides differ, and a proven
+ * bit is added back as a unit clause. Nothing needs retracting, so one
+ * solver can check any number of instructions.
+ *
+ * The reference follows the gate backend: the PC only changes on branches
+ * and jumps. RV32IM register instructions are covered; loads, stores,
+ * FENCE and SYSTEM are not.
+ */
+
+typedef struct sat_solver sat_solver_t;
+
+// Shared solver for several checkers
+sat_solver_t* equiv_solver_create(void);
+// Same, with num_solvers differently configured solvers racing on the
+// queries that take more than a few conflicts (see sat_portfolio.h)
+sat_solver_t* equiv_solver_create_portfolio(size_t num_solvers);
+void equiv_solver_destroy(sat_solver_t* solver);
+// Checks fail instead of starting a solve `seconds` from now (0: never).
+// A single solve is bounded by its conflict limit only.
+void equiv_solver_set_timeout(sat_solver_t* solver, double seconds);
 
 typedef struct {
+    riscv_instruction_t instruction;
+    riscv_compiler_t* compiler;  // Holds the compiled circuit
     circuit_t* circuit;
-    void* reference_impl;        // Function pointer to reference
     sat_solver_t* solver;
-    size_t input_bits;
-    size_t output_bits;
+    bool owns_solver;
+    size_t input_bits;           // PC and x1..x31
+    size_t output_bits;          // Next PC and x1..x31
+    int conflict_limit;          // Per output bit; negative for none
+    size_t fallback_tests;       // Random states simulated when a bit is left
+                                 // undecided; 0 reports it as a failure
+    size_t undecided_bits;       // Bits the solver left undecided; set by the
+                                 // equiv_checker_verify functions
 } equivalence_checker_t;
 
 // Create equivalence checker for an instruction
 equivalence_checker_t* equiv_checker_create(riscv_instruction_t instruction);
+// Same, in a shared solver and compiled with the objective and gate set of
+// `config` (NULL for the defaults). NULL if the instruction does not compile
+// or has no reference.
+equivalence_checker_t* equiv_checker_create_with(sat_solver_t* solver,
+                                                 const riscv_compiler_t* config,
+                                                 riscv_instruction_t instruction);
 void equiv_checker_destroy(equivalence_checker_t* checker);
 
-// Prove circuit equivalent to reference for ALL inputs
+// Prove circuit equivalent to reference for ALL inputs. With a conflict
+// limit, undecided_bits counts the output bits the solver cannot decide (and
+// the higher bits of their word). With fallback_tests they are checked by
+// simulation instead; the result is then "sat+simulation" and not verified.
 verification_result_t equiv_checker_verify(equivalence_checker_t* checker);
 
+// Proves two compiled circuits give the same next state, e.g. before and
+// after a pass. fallback_tests and undecided_bits (may be NULL) work as in
+// equivalence_checker_t.
+verification_result_t equiv_check_circuits(sat_solver_t* solver, const riscv_compiler_t* a,
+                                           const riscv_compiler_t* b, int conflict_limit,
+                                           size_t fallback_tests, size_t* undecided_bits);
+
+/*
+ * Cube-and-conquer: multiplier and divider miters are too hard for one
+ * solve, so the miter is split on k operand bits into 2^k cubes. A cube is
+ * the whole miter under assumptions fixing those bits, which turns whole
+ * partial products or divisor stages into constants. A pool of threads,
+ * each with its own solver and encoding, works through the cubes. They
+ * cover every input, so the circuit is proven once every cube is; a
+ * satisfiable cube is a counterexample and stops the others.
+ */
+
+#define EQUIV_CUBE_MAX_BITS 16
+
+typedef struct equiv_cubes equiv_cubes_t;
+
+struct equiv_cubes {
+    int cube_bits;              // k, at most EQUIV_CUBE_MAX_BITS; default: 8
+    int cube_vars[EQUIV_CUBE_MAX_BITS];  // State bits split on (32 * word + bit, so
+                                // x1 bit 0 is 32); negative entries are picked
+                                // from the operands. Default: all picked
+    size_t num_threads;         // Default: online CPUs
+    double timeout_seconds;     // Whole proof; default: 0, none
+    // Called after each cube, one call at a time, from the worker threads
+    void (*progress)(const equiv_cubes_t* cubes, void* ctx);
+    void* progress_ctx;
+
+    size_t num_cubes;           // Counts are current in progress()
+    size_t cubes_done;
+    size_t cubes_proven;
+    size_t cubes_undecided;     // Out of conflicts
+    uint32_t proven[32];        // Per next-state word (PC, x1..x31), the bits
+                                // proven in every cube; all 0 unless every
+                                // cube was done and none refuted
+    double wall_time_ms;
+};
+
+equiv_cubes_t* equiv_cubes_create(void);
+void equiv_cubes_destroy(equiv_cubes_t* cubes);
+
+// Proves the checker's circuit against its reference cube by cube, each
+// solve bounded by the checker's conflict limit. Output bits proven in
+// every cube are proven for all inputs and set in cubes->proven; with
+// fallback_tests the others are simulated as in equiv_checker_verify(),
+// without it they fail the proof. Any undecided cube leaves the result
+// unverified. The checker's solver is not used.
+verification_result_t equiv_checker_verify_cubes(equivalence_checker_t* checker,
+                                                 equiv_cubes_t* cubes);
+
 // ============================================================================
 // Layer 3: Bounded Model Checking
 // ============================================================================
@@ -103,7 +206,7 @@ typedef struct {
     size_t max_input_bits;       // Default: 80M bits (10MB)
     size_t max_output_bits;      // Default: 80M bits (10MB)
     size_t max_gates;            // Default: 10M gates
-    size_t max_depth;            // Default: 1000 layers
+    size_t max_depth;            // Default: 4096 layers (DIV needs ~3300)
     size_t max_memory_bytes;     // Default: 10MB
 } verification_bounds_t;
 
@@ -116,6 +219,7 @@ typedef struct {
     size_t actual_memory;
 } bounded_verifier_t;
 
+// NULL bounds give the defaults
 bounded_verifier_t* bounded_verifier_create(const verification_bounds_t* bounds);
 void bounded_verifier_destroy(bounded_verifier_t* verifier);
 
@@ -144,17 +248,23 @@ typedef enum {
     PROP_SHIFT_BOUNDS,          // Shifts handle out-of-range amounts
 } property_type_t;
 
-// Property verifier
+// Property verifier. DETERMINISTIC, NO_SIDE_EFFECTS and REGISTER_X0_ZERO
+// are structural checks of the compiled circuit; the others are SAT
+// miters. The algebraic properties compare two short programs over the
+// instruction's operation (register-register ALU and M ops only); the
+// overflow and shift properties prove the instruction against the reference.
 typedef struct {
     property_type_t property;
-    circuit_t* circuit;
-    size_t num_random_tests;    // Default: 1M
+    sat_solver_t* solver;       // Created on first use
+    int conflict_limit;         // Per output bit; negative for none
+    const riscv_compiler_t* config;  // Objective and gate set, NULL for defaults
 } property_verifier_t;
 
 property_verifier_t* property_verifier_create(property_type_t property);
 void property_verifier_destroy(property_verifier_t* verifier);
 
-verification_result_t property_verify(property_verifier_t* verifier, circuit_t* circuit);
+verification_result_t property_verify(property_verifier_t* verifier,
+                                      riscv_instruction_t instruction);
 
 // ============================================================================
 // Layer 5: Differential Testing
@@ -168,20 +278,27 @@ typedef struct {
     size_t memory_size;
 } riscv_verification_state_t;
 
-// Different implementations to test against
+// RV32IM register semantics with the gate backend's PC convention (the PC
+// only changes on branches and jumps); other instructions leave the state
+// unchanged
+void reference_execute(uint32_t instruction, riscv_verification_state_t* state);
+
+// Implementations the compiled circuit is compared against; NULL entries
+// are skipped. execute_ours defaults to reference_execute.
 typedef struct {
     void (*execute_spike)(uint32_t instruction, riscv_verification_state_t* state);
     void (*execute_qemu)(uint32_t instruction, riscv_verification_state_t* state);
     void (*execute_ours)(uint32_t instruction, riscv_verification_state_t* state);
-    void (*execute_circuit)(circuit_t* circuit, riscv_verification_state_t* state);
 } differential_implementations_t;
 
-// Differential tester
+// Differential tester; circuits are simulated 64 states at a time
 typedef struct {
     differential_implementations_t impls;
-    size_t num_tests;           // Default: 10M
+    size_t num_tests;           // Random states, default: 1M
     bool test_edge_cases;       // Test known edge cases
     bool test_random;           // Test random inputs
+    uint64_t seed;
+    const riscv_compiler_t* config;  // Objective and gate set, NULL for defaults
 } differential_tester_t;
 
 differential_tester_t* differential_tester_create(void);
@@ -190,48 +307,18 @@ void differential_tester_destroy(differential_tester_t* tester);
 verification_result_t differential_verify(differential_tester_t* tester, 
                                         riscv_instruction_t instruction);
 
-// ============================================================================
-// Layer 6: Compositional Verification
-// ============================================================================
-
-// Component of a larger circuit
-typedef struct {
-    const char* name;           // e.g., "32-bit adder"
-    circuit_t* circuit;
-    verification_result_t verification_status;
-} circuit_component_t;
-
-// Compositional verifier for large circuits
-typedef struct {
-    circuit_component_t** components;
-    size_t num_components;
-    
-    // Composition rules
-    bool (*compose_valid)(circuit_component_t** components, size_t count);
-} compositional_verifier_t;
-
-compositional_verifier_t* compositional_verifier_create(void);
-void compositional_verifier_destroy(compositional_verifier_t* verifier);
-
-// Add verified component
-void compositional_add_component(compositional_verifier_t* verifier,
-                               const char* name, circuit_t* circuit);
-
-// Verify full circuit by composition
-verification_result_t compositional_verify(compositional_verifier_t* verifier);
-
 // ============================================================================
 // Unified Verification Pipeline
 // ============================================================================
 
 // Complete verification context combining all methods
 typedef struct {
-    // All verification layers
-    equivalence_checker_t* equiv_checker;
+    // All verification layers; the SAT layer checks every instruction in
+    // one shared solver
+    sat_solver_t* solver;
     bounded_verifier_t* bounded_verifier;
     property_verifier_t* property_verifiers[16];  // Multiple properties
     differential_tester_t* diff_tester;
-    compositional_verifier_t* comp_verifier;
     
     // Configuration
     struct {
@@ -239,49 +326,137 @@ typedef struct {
         bool use_bounded_checking;      // Default: true
         bool use_property_checking;     // Default: true
         bool use_differential_testing;  // Default: true
-        bool use_compositional;         // Default: false (for large circuits)
         
         size_t timeout_seconds;         // Default: 3600 (1 hour)
+        int conflict_limit;             // Per SAT solve; default: 1000, then the
+                                        // bit is simulated (negative: no limit)
+        const riscv_compiler_t* compiler;  // Objective and gate set, NULL for defaults
     } config;
     
-    // Results
+    // Results of the last verify_instruction(), one per layer run
+    riscv_instruction_t instruction;
     verification_result_t results[32];
     size_t num_results;
+    size_t instructions_checked;
+    size_t undecided_bits;              // Output bits left undecided, over all runs
+    size_t last_undecided_bits;         // Of the last verify_instruction()
 } verification_pipeline_t;
 
 // Create full verification pipeline
 verification_pipeline_t* verification_pipeline_create(void);
 void verification_pipeline_destroy(verification_pipeline_t* pipeline);
 
-// Verify a single instruction
+// Verify a single instruction with every enabled layer; the SAT layer
+// shares one solver across calls
 verification_result_t verify_instruction(verification_pipeline_t* pipeline,
                                        riscv_instruction_t instruction);
 
-// Verify complete RISC-V implementation
+// Verify every RV32IM register instruction form (each operation with
+// aliased, x0 and boundary operands) as compiled with the objective and
+// gate set of `compiler` (NULL for the defaults). Stops at the first
+// counterexample or after config.timeout_seconds. Forms with bits only
+// simulated leave the result unverified ("pipeline+simulation") but do
+// not stop the run.
 verification_result_t verify_riscv_compiler(verification_pipeline_t* pipeline,
                                           riscv_compiler_t* compiler);
 
+// The instruction forms verify_riscv_compiler() checks
+size_t verification_rv32im_forms(const riscv_instruction_t** forms);
+
+// ============================================================================
+// Parallel Verification Driver
+// ============================================================================
+
+/*
+ * Verifying instructions and passes is embarrassingly parallel: the driver
+ * runs one job per instruction form (against the reference) or per pass and
+ * instruction (the circuit before against the circuit after) on a pool of
+ * threads, each with its own solver. Fully proven jobs (method "sat") are
+ * cached by a hash of the circuit structure, so a later run only re-proves
+ * the builders and passes that changed. With fewer jobs than threads, the
+ * spare threads race on the jobs' hardest queries as a solver portfolio.
+ */
+
+typedef struct {
+    riscv_instruction_t instruction;
+    const char* pass;           // NULL: the circuit against the reference
+    uint64_t structure_hash;    // Circuit(s) and settings the result is for
+    bool cached;                // Taken from the cache, not re-proven
+    size_t undecided_bits;      // Output bits left undecided, and simulated
+                                // if the result is "sat+simulation"
+    verification_result_t result;
+} verification_job_t;
+
+typedef struct {
+    size_t num_threads;         // Default: online CPUs
+    double job_timeout_seconds; // Per job, checked between solves; default: 60
+    int conflict_limit;         // Per solve; default: 1000
+    size_t fallback_tests;      // Simulated states for undecided bits; default: 4096
+    size_t portfolio_solvers;   // Solvers racing per query; default 0: spare threads
+                                // are divided among the jobs
+    const riscv_compiler_t* compiler;  // Objective and gate set, NULL for defaults
+
+    verification_job_t* jobs;
+    size_t num_jobs;
+    size_t jobs_capacity;
+
+    uint64_t* proven;           // Sorted hashes of proven jobs
+    size_t num_proven;
+    size_t proven_capacity;
+    double wall_time_ms;        // Of the last run
+} verification_driver_t;
+
+verification_driver_t* verification_driver_create(void);
+void verification_driver_destroy(verification_driver_t* driver);
+
+// Queue jobs; -1 on an unknown pass or out of memory
+int verification_driver_add_instruction(verification_driver_t* driver,
+                                        riscv_instruction_t instruction);
+int verification_driver_add_pass(verification_driver_t* driver, const char* pass,
+                                 riscv_instruction_t instruction);
+// Every form of verification_rv32im_forms(), and each pass on all of them
+int verification_driver_add_rv32im(verification_driver_t* driver);
+int verification_driver_add_pass_rv32im(verification_driver_t* driver, const char* pass);
+
+// Runs the queued jobs; returns the number that failed (not proven and not
+// verification_result_simulated()), -1 on error
+int verification_driver_run(verification_driver_t* driver);
+
+// Proven-job cache, one hex hash per line. A missing file is an empty cache.
+int verification_cache_load(verification_driver_t* driver, const char* filename);
+int verification_cache_save(const verification_driver_t* driver, const char* filename);
+
+// Hash of a compiled circuit's gates and output wires
+uint64_t verification_structure_hash(const riscv_compiler_t* compiler);
+
 // ============================================================================
 // Reporting and Analysis
 // ============================================================================
 
-// Generate verification report
+// One entry per job or pipeline layer; the report owns its strings
 typedef struct {
-    const char* instruction_name;
-    verification_result_t sat_result;
-    verification_result_t bounded_result;
-    verification_result_t property_results[16];
-    verification_result_t differential_result;
-    
+    verification_job_t* entries;
+    size_t num_entries;
+
     // Summary
-    bool fully_verified;
+    bool fully_verified;        // Nothing failed or simulated, and proven by SAT
     size_t total_tests_run;
-    double total_time_ms;
+    size_t cached_entries;
+    size_t proven_entries;      // Method "sat", or cached SAT proofs
+    size_t simulated_bits;      // Output bits only simulated
+    size_t undecided_bits;      // Output bits neither proven nor simulated
+    double total_time_ms;       // Wall clock
 } verification_report_t;
 
+// Report of the layers of the pipeline's last verify_instruction(), or of
+// the driver's last run
 verification_report_t* generate_verification_report(verification_pipeline_t* pipeline);
+verification_report_t* verification_driver_report(const verification_driver_t* driver);
+void verification_report_free(verification_report_t* report);
+
 void print_verification_report(const verification_report_t* report);
-void save_verification_report(const verification_report_t* report, const char* filename);
+// JSON; -1 if the file cannot be written
+int save_verification_report(const verification_report_t* report, const char* filename);
 
 // ============================================================================
 // Utilities
@@ -294,14 +469,16 @@ uint32_t word32_to_uint32(const word32_t* word);
 // Helper function to create word32_t with all bits set to value
 word32_t word32_fill(bool value);
 
+// Fresh compiler holding the program, with the objective and gate set of
+// config (NULL for the defaults); NULL if an instruction does not compile
+riscv_compiler_t* verification_compile(const riscv_compiler_t* config,
+                                       const uint32_t* program, size_t count);
+
 // Generate test cases
 void generate_edge_cases(riscv_instruction_t instruction, 
                         riscv_verification_state_t** states, size_t* count);
 void generate_random_state(riscv_verification_state_t* state);
 
-// Error handling
-const char* verification_error_string(int error_code);
-
 #ifdef __cplusplus
 }
 #endif
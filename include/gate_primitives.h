@@ -0,0 +1,74 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*
+ * gate_primitives.h - The one place single-bit gadgets are built
+ *
+ * Every builder that needs a NOT, OR, mux or full adder takes it from here
+ * instead of carrying its own copy. Each primitive uses the fewest AND
+ * gates known for it over {AND, XOR}, and constant inputs are folded as
+ * gates are emitted: CONSTANT_0_WIRE / CONSTANT_1_WIRE and repeated
+ * operands never cost a gate.
+ *
+ *   gate          gates   ANDs
+ *   ----------    -----   ----
+ *   NOT             1       0
+ *   OR              3       1
+ *   MUX             3       1     if_false ^ (sel & (if_true ^ if_false))
+ *   shallow MUX     3       2     (sel & if_true) ^ (~sel & if_false)
+ *   full adder      5       1     carry' = c ^ ((a ^ c) & (b ^ c))
+ *
+ * When circuit->gate_set allows a native NOT, OR, XNOR, MUX or LUT, the
+ * primitive is that one gate instead (a full adder is two LUTs).
+ */
+
+#ifndef GATE_PRIMITIVES_H
+#define GATE_PRIMITIVES_H
+
+#include "riscv_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t gate_xor(riscv_circuit_t* circuit, uint32_t a, uint32_t b);
+uint32_t gate_and(riscv_circuit_t* circuit, uint32_t a, uint32_t b);
+uint32_t gate_not(riscv_circuit_t* circuit, uint32_t a);
+uint32_t gate_xnor(riscv_circuit_t* circuit, uint32_t a, uint32_t b);
+
+// a | b = a ^ b ^ (a & b). Use gate_xor instead when a and b can never
+// both be 1 (e.g. generate vs. propagate-and-carry): it is the same OR.
+uint32_t gate_or(riscv_circuit_t* circuit, uint32_t a, uint32_t b);
+
+// sel ? if_true : if_false. When if_true ^ if_false is already known,
+// the mux is one AND and one XOR.
+uint32_t gate_mux(riscv_circuit_t* circuit, uint32_t sel,
+                  uint32_t if_true, uint32_t if_false);
+void gate_mux_word(riscv_circuit_t* circuit, uint32_t sel, const uint32_t* if_true,
+                   const uint32_t* if_false, uint32_t* out, size_t bits);
+
+// (sel & if_true) ^ (not_sel & if_false): two ANDs instead of one, but
+// only two layers deep once not_sel (shared by a whole row) is built
+uint32_t gate_mux_shallow(riscv_circuit_t* circuit, uint32_t sel, uint32_t not_sel,
+                          uint32_t if_true, uint32_t if_false);
+
+// Any function of three wires, table bit (a | b << 1 | c << 2). Constant
+// and repeated inputs fold into the table first. Without native LUTs it is
+// built from AND/XOR (at most 3 ANDs), or muxes where allowed.
+uint32_t gate_lut3(riscv_circuit_t* circuit, uint8_t table, uint32_t a, uint32_t b, uint32_t c);
+
+// Returns a ^ b ^ *carry and replaces *carry with the carry out
+uint32_t gate_full_add(riscv_circuit_t* circuit, uint32_t a, uint32_t b, uint32_t* carry);
+
+// AND / OR of n wires as a balanced tree (log depth); n == 0 gives the
+// identity (1 for AND, 0 for OR)
+uint32_t gate_and_reduce(riscv_circuit_t* circuit, const uint32_t* wires, size_t n);
+uint32_t gate_or_reduce(riscv_circuit_t* circuit, const uint32_t* wires, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GATE_PRIMITIVES_H
@@ -0,0 +1,62 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*
+ * npn4_library.h - Small AND/XOR implementations of all 4-input functions
+ *
+ * Two functions are NPN-equivalent when one becomes the other by permuting
+ * and negating inputs and negating the output; the 65536 functions of 4
+ * inputs fall into 222 classes. The library (generated by
+ * scripts/gen_npn4_library.c into src/npn4_library.c) stores one member of
+ * each class with the smallest implementation found, counting inverters
+ * as gates.
+ */
+
+#ifndef NPN4_LIBRARY_H
+#define NPN4_LIBRARY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NPN4_NUM_CLASSES 222
+#define NPN4_MAX_GATES 10
+
+// Signals: 0-3 inputs, 4 constant 1, 5 + k the output of gate k
+#define NPN4_CONST_1 4
+#define NPN4_CONST_0 0xFF
+
+typedef struct {
+    uint8_t type;       // gate_type_t
+    uint8_t a, b;
+} npn4_gate_t;
+
+typedef struct {
+    uint16_t tt;        // the class member implemented
+    uint8_t num_gates;
+    uint8_t out;        // signal index of the result, or NPN4_CONST_0
+    npn4_gate_t gates[NPN4_MAX_GATES];
+} npn4_impl_t;
+
+extern const npn4_impl_t npn4_library[NPN4_NUM_CLASSES];
+
+// tt(x) = out_neg ^ member(y), y_i = x_perm[i] ^ bit i of in_neg
+typedef struct {
+    const npn4_impl_t* impl;
+    uint8_t perm[4];
+    uint8_t in_neg;
+    uint8_t out_neg;
+} npn4_match_t;
+
+// Cheapest match for tt (fewest inverters); the table is built on first use
+void npn4_lookup(uint16_t tt, npn4_match_t* match);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NPN4_LIBRARY_H
@@ -0,0 +1,221 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*
+ * r1cs.h - Rank-1 constraint system backend over a prime field
+ *
+ * A second backend for the instruction compilers. Instead of boolean gates
+ * it emits constraints <A,w> * <B,w> = <C,w> over the Goldilocks field
+ * p = 2^64 - 2^32 + 1, for the same RV32IM semantics as the gate backend
+ * (loads and stores excepted).
+ *
+ * Registers stay field elements. A word is a linear combination whose
+ * integer value is congruent to the register mod 2^32 and below 2^bound,
+ * so ADD/SUB/ADDI/LUI/AUIPC and constant shifts left are free until the
+ * bound nears 2^63. Only then, or when an operation needs the canonical
+ * value or its bits, is the word decomposed into boolean variables. The
+ * bits are cached on the word for later bitwise ops.
+ *
+ *   operation            gate backend     r1cs backend
+ *   ------------------   -------------    -------------------------------
+ *   ADD / SUB / ADDI     ~157 gates       0 now, one reduction later
+ *   reduction            -                bound booleans + 1 linear
+ *   AND / OR / XOR       32 gates         32 (plus operand bits)
+ *   SLTU / BEQ / BNE     126-187 gates    34 / 2 (SLT, BLT: plus sign bits)
+ *   MUL / MULHU          ~2,900-5,900     67
+ *   DIVU / REMU          ~6,300 gates     ~103 (signed: ~175)
+ *
+ * Variable 0 is the constant 1. Variables 1..32 are the inputs: the PC,
+ * then x1..x31. Inputs are taken to be canonical 32-bit values, as the
+ * outputs of a previous segment are; r1cs_compiler_check_inputs() adds
+ * the range checks for a standalone proof. Every other variable carries a
+ * hint, so r1cs_solve() computes the witness from the inputs alone.
+ *
+ * As in the gate backend, the PC only changes on branches and jumps.
+ */
+
+#ifndef R1CS_H
+#define R1CS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Goldilocks prime 2^64 - 2^32 + 1
+#define R1CS_FIELD_PRIME 0xFFFFFFFF00000001ULL
+
+#define R1CS_ONE 0            // Variable holding the constant 1
+#define R1CS_NUM_INPUTS 32    // PC, then x1..x31 (x0 is constant)
+
+static inline uint64_t r1cs_field_add(uint64_t a, uint64_t b) {
+    uint64_t s = a + b;
+    // A carry out or a sum at or past p both need one subtraction
+    if (s < a || s >= R1CS_FIELD_PRIME) s -= R1CS_FIELD_PRIME;
+    return s;
+}
+
+static inline uint64_t r1cs_field_neg(uint64_t a) {
+    return a == 0 ? 0 : R1CS_FIELD_PRIME - a;
+}
+
+static inline uint64_t r1cs_field_sub(uint64_t a, uint64_t b) {
+    return r1cs_field_add(a, r1cs_field_neg(b));
+}
+
+static inline uint64_t r1cs_field_mul(uint64_t a, uint64_t b) {
+    return (uint64_t)((unsigned __int128)a * b % R1CS_FIELD_PRIME);
+}
+
+// ============================================================================
+// Constraint system
+// ============================================================================
+
+typedef struct {
+    uint32_t var;
+    uint64_t coeff;           // Field element, nonzero
+} r1cs_term_t;
+
+// Sparse linear combination, terms sorted by variable
+typedef struct {
+    r1cs_term_t* terms;
+    uint32_t size;
+    uint32_t capacity;
+} r1cs_lc_t;
+
+typedef struct {
+    r1cs_lc_t a, b, c;
+} r1cs_constraint_t;
+
+// How the witness solver computes a variable from earlier ones
+typedef enum {
+    R1CS_HINT_INPUT = 0,
+    R1CS_HINT_LC,             // x
+    R1CS_HINT_BIT,            // bit `arg` of x as an integer
+    R1CS_HINT_MUL,            // x * y
+    R1CS_HINT_XOR,            // x + y - 2xy (x, y bits)
+    R1CS_HINT_INV,            // 1 / x, or 0 when x = 0
+    R1CS_HINT_DIVU,           // x / y as RISC-V DIVU (y = 0 gives 2^32 - 1)
+    R1CS_HINT_REMU,           // x % y as RISC-V REMU (y = 0 gives x)
+} r1cs_hint_kind_t;
+
+typedef struct {
+    r1cs_hint_kind_t kind;
+    uint32_t arg;
+    r1cs_lc_t x, y;
+} r1cs_hint_t;
+
+typedef struct {
+    r1cs_hint_t* hints;       // One per variable
+    uint32_t num_vars;
+    uint32_t var_capacity;
+    uint32_t num_inputs;      // Variables 1..num_inputs
+
+    r1cs_constraint_t* constraints;
+    size_t num_constraints;
+    size_t constraint_capacity;
+
+    r1cs_lc_t* outputs;       // Set by r1cs_compiler_finalize()
+    size_t num_outputs;
+} r1cs_system_t;
+
+// Linear combinations own their terms
+void r1cs_lc_free(r1cs_lc_t* lc);
+bool r1cs_lc_copy(r1cs_lc_t* dst, const r1cs_lc_t* src);
+// lc += coeff * var, and lc += k * other
+bool r1cs_lc_add_term(r1cs_lc_t* lc, uint32_t var, uint64_t coeff);
+bool r1cs_lc_add_scaled(r1cs_lc_t* lc, const r1cs_lc_t* other, uint64_t k);
+// True if lc has no variable term; *value gets its constant
+bool r1cs_lc_is_constant(const r1cs_lc_t* lc, uint64_t* value);
+
+r1cs_system_t* r1cs_system_create(uint32_t num_inputs);
+void r1cs_system_destroy(r1cs_system_t* system);
+
+// New variable computed by the hint (its lcs are copied); UINT32_MAX on
+// allocation failure
+uint32_t r1cs_new_var(r1cs_system_t* system, r1cs_hint_kind_t kind, uint32_t arg,
+                      const r1cs_lc_t* x, const r1cs_lc_t* y);
+// Adds a * b = c (copied); NULL arguments stand for 0
+bool r1cs_enforce(r1cs_system_t* system, const r1cs_lc_t* a, const r1cs_lc_t* b,
+                  const r1cs_lc_t* c);
+
+// Witness from input values (num_inputs of them); caller frees. NULL on
+// failure.
+uint64_t* r1cs_solve(const r1cs_system_t* system, const uint64_t* inputs);
+bool r1cs_is_satisfied(const r1cs_system_t* system, const uint64_t* witness);
+uint64_t r1cs_lc_eval(const r1cs_lc_t* lc, const uint64_t* witness);
+
+// Constraint and nonzero-coefficient counts
+size_t r1cs_num_nonzeros(const r1cs_system_t* system);
+void r1cs_print_stats(const r1cs_system_t* system);
+
+/*
+ * Text export, one record per line:
+ *
+ *   r1cs 1
+ *   field <p>
+ *   variables <n> inputs <k> outputs <m> constraints <c>
+ *   o <lc>                      m times, output linear combinations
+ *   c <lc> <lc> <lc>            c times, A * B = C
+ *
+ * where <lc> is "<terms> <var> <coeff> ..." in decimal.
+ */
+int r1cs_to_file(const r1cs_system_t* system, const char* filename);
+
+// ============================================================================
+// RV32IM compiler
+// ============================================================================
+
+// Bits are variables, possibly negated; R1CS_ONE gives the constants
+typedef struct {
+    uint32_t var;
+    bool negated;
+} r1cs_bit_t;
+
+typedef struct {
+    r1cs_lc_t value;          // Congruent to the word mod 2^32
+    uint32_t bound;           // value < 2^bound, at most 63
+    bool has_bits;            // bits[] hold the canonical value
+    r1cs_bit_t bits[32];
+} r1cs_word_t;
+
+typedef struct {
+    r1cs_system_t* system;
+    r1cs_word_t regs[32];
+    r1cs_word_t pc;
+    bool finalized;
+} r1cs_compiler_t;
+
+r1cs_compiler_t* r1cs_compiler_create(void);
+void r1cs_compiler_destroy(r1cs_compiler_t* compiler);
+
+// Same contract as riscv_compile_instruction(): 0 on success, -1 on an
+// unsupported instruction (the compiler state is then unchanged)
+int r1cs_compile_instruction(r1cs_compiler_t* compiler, uint32_t instruction);
+int r1cs_compile_program(r1cs_compiler_t* compiler, const uint32_t* program, size_t count);
+
+// Range-checks the input variables to 32 bits
+void r1cs_compiler_check_inputs(r1cs_compiler_t* compiler);
+
+// Reduces every modified register and the PC to its canonical value and
+// records them as the system outputs (PC, then x1..x31). No instruction
+// may be compiled afterwards.
+int r1cs_compiler_finalize(r1cs_compiler_t* compiler);
+
+// Witness for an initial machine state (regs[0] is ignored); caller frees
+uint64_t* r1cs_compiler_solve(const r1cs_compiler_t* compiler, uint32_t pc,
+                              const uint32_t regs[32]);
+uint32_t r1cs_compiler_get_reg(const r1cs_compiler_t* compiler, const uint64_t* witness,
+                               int reg);
+uint32_t r1cs_compiler_get_pc(const r1cs_compiler_t* compiler, const uint64_t* witness);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // R1CS_H
@@ -171,22 +171,68 @@ typedef enum {
     RISCV_EBREAK = 0x73,
 } riscv_opcode_t;
 
-// Gate types supported by our circuit
+// Gate types supported by our circuit. AND and XOR are the base set every
+// backend accepts. The extended types cost one gate where the backend has
+// them natively; builders emit them only when circuit->gate_set allows it,
+// and riscv_circuit_lower() expands them back to AND/XOR.
 typedef enum {
     GATE_AND = 0,
     GATE_XOR = 1,
+    GATE_OR = 2,
+    GATE_NOT = 3,          // ~left; right_input is CONSTANT_0_WIRE
+    GATE_XNOR = 4,
+    GATE_MUX = 5,          // select ? right : left
+    GATE_LUT = 6,          // Up to 3 inputs, output = bit (l | r << 1 | s << 2) of table
 } gate_type_t;
 
-// Single gate in the circuit
+#define GATE_TYPE_COUNT 7
+
+// Gate sets are bit masks of gate types
+#define GATE_SET_BIT(type) (1u << (type))
+#define GATE_SET_BASIC (GATE_SET_BIT(GATE_AND) | GATE_SET_BIT(GATE_XOR))
+#define GATE_SET_ALL ((1u << GATE_TYPE_COUNT) - 1)
+
+// Single gate in the circuit (20 bytes: type and table share one word)
 typedef struct {
     uint32_t left_input;   // Index of left input wire
     uint32_t right_input;  // Index of right input wire
     uint32_t output;       // Index of output wire
-    gate_type_t type;      // AND or XOR
+    uint32_t select_input; // MUX select, third LUT input; CONSTANT_0_WIRE otherwise
+    uint8_t type;          // gate_type_t
+    uint8_t table;         // LUT truth table
 } gate_t;
 
+// Gate output on bit-parallel inputs, one evaluation per bit
+static inline uint64_t gate_eval_word(const gate_t* gate, uint64_t l, uint64_t r, uint64_t s) {
+    switch (gate->type) {
+        case GATE_AND:  return l & r;
+        case GATE_XOR:  return l ^ r;
+        case GATE_OR:   return l | r;
+        case GATE_NOT:  return ~l;
+        case GATE_XNOR: return ~(l ^ r);
+        case GATE_MUX:  return (s & r) | (~s & l);
+        case GATE_LUT: {
+            uint64_t out = 0;
+            for (int m = 0; m < 8; m++) {
+                if (!((gate->table >> m) & 1)) continue;
+                out |= ((m & 1) ? l : ~l) & ((m & 2) ? r : ~r) & ((m & 4) ? s : ~s);
+            }
+            return out;
+        }
+    }
+    return 0;
+}
+
+// What the arithmetic builders optimize for. Every adder, comparator,
+// multiplier and shifter reads circuit->objective when it picks a structure.
+typedef enum {
+    OPTIMIZE_GATES = 0,    // Fewest gates in total (default)
+    OPTIMIZE_AND_COUNT,    // Fewest AND gates (XOR is free in some proof systems)
+    OPTIMIZE_DEPTH,        // Fewest layers (layered provers, riscv_circuit_to_gate_format)
+} optimization_objective_t;
+
 // Bounded circuit representation - allocates only what's needed
-typedef struct {
+typedef struct riscv_circuit {
     gate_t* gates;
     size_t num_gates;
     size_t capacity;
@@ -204,6 +250,13 @@ typedef struct {
     // Wire management (for intermediate computations)
     uint32_t next_wire_id;
     uint32_t max_wire_id;  // Track highest wire used
+    
+    // Structure selection for the arithmetic builders
+    optimization_objective_t objective;
+
+    // Extended gate types the builders may emit (GATE_SET_BIT()s); AND and
+    // XOR are always allowed, so 0 means AND/XOR only
+    uint32_t gate_set;
 } riscv_circuit_t;
 
 // RISC-V machine state (bounded within 10MB)
@@ -215,7 +268,7 @@ typedef struct {
 } riscv_state_t;
 
 // Compiler context
-typedef struct {
+typedef struct riscv_compiler {
     riscv_circuit_t* circuit;
     riscv_state_t* initial_state;  // Input state
     riscv_state_t* final_state;    // Output state
@@ -272,6 +325,42 @@ riscv_compiler_t* riscv_compiler_create(void);
  */
 void riscv_compiler_destroy(riscv_compiler_t* compiler);
 
+/**
+ * @brief Choose what the arithmetic builders optimize for
+ * 
+ * Applies to every instruction compiled afterwards. OPTIMIZE_GATES (the
+ * default) keeps ripple-carry adders and borrow-chain comparators;
+ * OPTIMIZE_DEPTH switches to Kogge-Stone adders, tree comparators and
+ * two-level muxes in the shifter; OPTIMIZE_AND_COUNT keeps the structures
+ * with one AND per bit.
+ * 
+ * @param compiler Compiler instance
+ * @param objective OPTIMIZE_GATES, OPTIMIZE_AND_COUNT or OPTIMIZE_DEPTH
+ * @return 0 on success, -1 on an unknown objective
+ */
+int riscv_compiler_set_objective(riscv_compiler_t* compiler,
+                                 optimization_objective_t objective);
+const char* optimization_objective_name(optimization_objective_t objective);
+
+/**
+ * @brief Choose which gate types the builders may emit
+ * 
+ * Applies to every instruction compiled afterwards. With GATE_SET_ALL a
+ * NOT, OR, XNOR or mux is one gate and a full adder two LUTs, instead of
+ * the AND/XOR expansions. Use it when the target backend has those gates;
+ * riscv_circuit_lower() expands them for targets that do not.
+ * 
+ * @param compiler Compiler instance
+ * @param gate_set GATE_SET_BIT()s of gate types, within GATE_SET_ALL
+ * @return 0 on success, -1 on an unknown gate type
+ */
+int riscv_compiler_set_gate_set(riscv_compiler_t* compiler, uint32_t gate_set);
+const char* gate_type_name(gate_type_t type);
+// True if circuit->gate_set allows type
+bool riscv_circuit_allows(const riscv_circuit_t* circuit, gate_type_t type);
+// True if the circuit holds, or may be given, gates beyond AND and XOR
+bool riscv_circuit_is_extended(const riscv_circuit_t* circuit);
+
 /**
  * @brief Validate compiler instance and configuration
  * 
@@ -391,12 +480,26 @@ uint32_t build_adder(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t* b_bit
                      uint32_t* sum_bits, size_t num_bits);
 uint32_t build_kogge_stone_adder(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t* b_bits, 
                                  uint32_t* sum_bits, size_t num_bits);
+uint32_t build_kogge_stone_adder_with_carry(riscv_circuit_t* circuit,
+                                            const uint32_t* a_bits, const uint32_t* b_bits,
+                                            uint32_t carry_in, uint32_t* sum_bits,
+                                            size_t num_bits);
 uint32_t build_ripple_carry_adder(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t* b_bits, 
                                   uint32_t* sum_bits, size_t num_bits);
 uint32_t build_subtractor(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t* b_bits,
                           uint32_t* diff_bits, size_t num_bits);
 uint32_t build_comparator(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t* b_bits,
                           size_t num_bits, bool is_signed);
+
+// Shared comparators (comparators.c): borrow-only less-than with signed
+// order via sign-bit flip, and XNOR/AND-tree equality
+uint32_t build_compare_lt(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                          size_t bits, bool is_signed);
+uint32_t build_compare_eq(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                          size_t bits);
+// funct3 as in branches: BEQ/BNE/BLT/BGE/BLTU/BGEU
+uint32_t build_compare(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                       size_t bits, uint32_t funct3);
 uint32_t build_shifter(riscv_circuit_t* circuit, uint32_t* value_bits, uint32_t* shift_bits,
                        uint32_t* result_bits, size_t num_bits, bool is_left, bool is_arithmetic);
 uint32_t build_shifter_optimized(riscv_circuit_t* circuit, uint32_t* value_bits, uint32_t* shift_bits,
@@ -408,6 +511,8 @@ uint32_t* build_multiplier(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t*
 // Circuit management
 void riscv_circuit_add_gate(riscv_circuit_t* circuit, uint32_t left, uint32_t right, 
                             uint32_t output, gate_type_t type);
+// Any gate, including MUX and LUT (select and table are ignored elsewhere)
+void riscv_circuit_add_gate_full(riscv_circuit_t* circuit, const gate_t* gate);
 uint32_t riscv_circuit_allocate_wire(riscv_circuit_t* circuit);
 uint32_t* riscv_circuit_allocate_wire_array(riscv_circuit_t* circuit, size_t count);
 
@@ -429,6 +534,8 @@ size_t calculate_riscv_output_size(const riscv_state_t* state);
 
 // Debugging and visualization
 void riscv_circuit_print_stats(const riscv_circuit_t* circuit);
+// One gate per line: "id left right output TYPE", then the select input
+// for MUX and LUT and the truth table (hex) for LUT
 int riscv_circuit_to_file(const riscv_circuit_t* circuit, const char* filename);
 
 // Additional instruction compilers
@@ -441,6 +548,43 @@ int compile_jump_instruction(riscv_compiler_t* compiler, uint32_t instruction);
 int compile_upper_immediate_instruction(riscv_compiler_t* compiler, uint32_t instruction);
 int compile_system_instruction(riscv_compiler_t* compiler, uint32_t instruction);
 int compile_divide_instruction(riscv_compiler_t* compiler, uint32_t instruction);
+int compile_bitmanip_instruction(riscv_compiler_t* compiler, uint32_t instruction);
+
+// Multiplication: (a * b) mod 2^out_bits over a partial-product array
+void build_integer_product(riscv_circuit_t* circuit,
+                           const uint32_t* a_bits, const uint32_t* b_bits, size_t bits,
+                           bool a_signed, bool b_signed,
+                           size_t out_bits, uint32_t* product);
+
+// Multiplication by a compile-time constant: CSD recoding into shift-add rows
+int csd_recode(uint64_t constant, size_t bits, int8_t* digits);
+void build_constant_multiplier(riscv_circuit_t* circuit, const uint32_t* x_bits,
+                               size_t width, uint64_t constant, uint32_t* product);
+bool wires_to_constant(const uint32_t* wires, size_t bits, uint64_t* value);
+
+// Unsigned division by a constant d != 0 via multiply-high magic numbers;
+// quotient or remainder may be NULL
+void build_unsigned_divide_by_constant(riscv_circuit_t* circuit, const uint32_t* x,
+                                       uint32_t d, uint32_t* quotient, uint32_t* remainder);
+
+// Division with RISC-V semantics over a non-restoring divider; quotient or
+// remainder may be NULL
+void build_divider(riscv_circuit_t* circuit, const uint32_t* dividend,
+                   const uint32_t* divisor, bool is_signed,
+                   uint32_t* quotient, uint32_t* remainder);
+
+// MUL + MULH[S][U] on the same operands share one 64-bit product
+bool match_mul_pair(uint32_t first, uint32_t second);
+int compile_mul_pair(riscv_compiler_t* compiler, uint32_t first, uint32_t second);
+
+// DIV[U] + REM[U] on the same operands share one divider
+bool match_div_pair(uint32_t first, uint32_t second);
+int compile_div_pair(riscv_compiler_t* compiler, uint32_t first, uint32_t second);
+
+// Instruction fusion: compiles a straight-line block, fusing known idioms
+size_t compile_with_fusion(riscv_compiler_t* compiler,
+                          uint32_t* instructions, size_t count);
+void print_fusion_stats(void);
 
 // Test functions
 void test_multiplication_instructions(void);
@@ -452,8 +596,11 @@ void test_division_instructions(void);
 // Helper to compile ADDI
 void compile_addi(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, int32_t imm);
 
-// Circuit format converter
+// Circuit format converter (AND/XOR only: -1 on extended gates)
 int riscv_circuit_to_gate_format(const riscv_circuit_t* circuit, const char* filename);
+// Number of layers riscv_circuit_to_gate_format would emit, and AND count
+size_t riscv_circuit_depth(const riscv_circuit_t* circuit);
+size_t riscv_circuit_count_and_gates(const riscv_circuit_t* circuit);
 
 // Optimized arithmetic operations
 uint32_t build_kogge_stone_adder(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t* b_bits, 
@@ -470,10 +617,72 @@ void build_booth_multiplier_optimized(riscv_circuit_t* circuit,
                                      uint32_t* multiplicand, uint32_t* multiplier,
                                      uint32_t* product, size_t bits);
 
+// Carry-save compressor trees (multi-operand addition)
+typedef enum {
+    FINAL_ADDER_RIPPLE,              // Fewest gates
+    FINAL_ADDER_KOGGE_STONE,         // Lowest depth
+    FINAL_ADDER_SPARSE_KOGGE_STONE,  // Balanced
+} final_adder_t;
+
+void build_compressor_3_2(riscv_circuit_t* circuit,
+                          uint32_t a, uint32_t b, uint32_t c,
+                          uint32_t* sum, uint32_t* carry);
+void build_compressor_4_2(riscv_circuit_t* circuit,
+                          uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+                          uint32_t cin,
+                          uint32_t* sum, uint32_t* carry, uint32_t* cout);
+// Sum num_operands width-bit operands mod 2^width. CONSTANT_0_WIRE bits are
+// free, so shifted or truncated operands can be passed zero-padded.
+void build_multi_operand_adder(riscv_circuit_t* circuit,
+                               uint32_t** operands, size_t num_operands,
+                               size_t width, uint32_t* sum_bits,
+                               final_adder_t final_adder);
+// Final adder matching circuit->objective (ripple unless optimizing depth)
+final_adder_t final_adder_for_objective(const riscv_circuit_t* circuit);
+
+// Keccak sponge gadgets (SHA3 / Keccak-256 / SHAKE)
+// Messages and digests are 8 wires per byte, LSB first.
+typedef enum {
+    KECCAK_PADDING_KECCAK = 0x01,  // Original Keccak (Ethereum keccak256)
+    KECCAK_PADDING_SHA3   = 0x06,  // FIPS 202 SHA3-*
+    KECCAK_PADDING_SHAKE  = 0x1F,  // FIPS 202 SHAKE*
+} keccak_padding_t;
+
+void build_keccak_f1600(riscv_circuit_t* circuit, uint32_t* state_bits);
+int build_keccak_sponge(riscv_circuit_t* circuit,
+                        const uint32_t* message_bits, size_t message_bytes,
+                        size_t rate_bytes, keccak_padding_t padding,
+                        uint32_t* output_bits, size_t num_output_bits);
+void build_keccak_256_circuit(riscv_circuit_t* circuit,
+                              const uint32_t* message_bits, size_t message_bytes,
+                              uint32_t* output_bits);
+
 // Gate caching and deduplication
 void deduplicate_gates(riscv_circuit_t* circuit);
 void gate_cache_print_stats(void);
 
+// Gadget templates: compile a gadget once per process, then stamp it into
+// any circuit by relocating wires. Builders see input ports as ordinary
+// wires and must not depend on their values.
+typedef struct gadget_template gadget_template_t;
+typedef void (*gadget_builder_t)(riscv_circuit_t* circuit, const uint32_t* inputs,
+                                 uint32_t* outputs, void* context);
+
+gadget_template_t* gadget_template_register(const char* name,
+                                            size_t num_inputs, size_t num_outputs,
+                                            gadget_builder_t builder, void* context);
+gadget_template_t* gadget_template_lookup(const char* name);
+size_t gadget_template_num_gates(const gadget_template_t* tmpl);
+// -1 if the circuit cannot grow; the circuit is then unchanged
+int gadget_template_instantiate(riscv_circuit_t* circuit, gadget_template_t* tmpl,
+                                const uint32_t* inputs, uint32_t* outputs);
+int gadget_instantiate(riscv_circuit_t* circuit, const char* name,
+                       size_t num_inputs, size_t num_outputs,
+                       gadget_builder_t builder, void* context,
+                       const uint32_t* inputs, uint32_t* outputs);
+void gadget_template_print_stats(void);
+void gadget_template_clear_all(void);
+
 // Advanced gate deduplication functions
 void gate_dedup_init(void);
 void gate_dedup_cleanup(void);
@@ -31,11 +31,18 @@ typedef void (*memory_access_fn)(riscv_memory_t* memory,
                                 uint32_t write_enable,
                                 uint32_t* read_data_bits);
 
+// Stores a pointer to every wire ID the memory carries between accesses into
+// roots (when non-NULL) and returns how many there are
+typedef size_t (*memory_roots_fn)(riscv_memory_t* memory, uint32_t** roots);
+
 // Memory subsystem using Merkle tree
 struct riscv_memory_t {
     // Function pointer for memory access (allows different implementations)
     memory_access_fn access;
     
+    // Wires circuit passes must keep alive and remap (see riscv_memory_roots)
+    memory_roots_fn roots;
+    
     // Merkle tree root (represents entire memory state)
     uint32_t* merkle_root_wires;  // 256 wires for SHA3-256 hash
     
@@ -57,6 +64,11 @@ struct riscv_memory_t {
 riscv_memory_t* riscv_memory_create(riscv_circuit_t* circuit);
 void riscv_memory_destroy(riscv_memory_t* memory);
 
+// Memory state wires (cells, leaf, root and interface wires) as pass roots.
+// Call with roots == NULL for the count. Stores write new wire IDs into
+// these slots, so passes that drop or renumber gates must treat them as roots.
+size_t riscv_memory_roots(riscv_memory_t* memory, uint32_t** roots);
+
 // Simple memory API (no cryptographic proofs, ~2K gates instead of ~3.9M)
 riscv_memory_t* riscv_memory_create_simple(riscv_circuit_t* circuit);
 void riscv_memory_destroy_simple(riscv_memory_t* memory);
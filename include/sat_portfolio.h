@@ -0,0 +1,71 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*
+ * sat_portfolio.h - Several MiniSAT instances racing on the same clauses
+ *
+ * Hard queries (multiplier miters above all) vary wildly in runtime with
+ * the solver's heuristics. A portfolio keeps the same clauses in several
+ * solvers that differ in restart policy, decision phase and random seed.
+ * A query first runs on solver 0 alone for a few conflicts, so easy ones
+ * never start a thread. After that all solvers race in their own threads:
+ * the first definite answer wins and the others are stopped. While they
+ * race, solvers can hand each other their short glue clauses, which hold
+ * for everyone because the clauses are the same.
+ *
+ * Literals use MiniSAT's encoding (2 * var, plus 1 for the negation) and
+ * results its lbool values: 1 satisfiable, -1 unsatisfiable, 0 undecided.
+ */
+
+#ifndef SAT_PORTFOLIO_H
+#define SAT_PORTFOLIO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SAT_PORTFOLIO_MAX_SOLVERS 16
+
+struct solver_t;
+struct sat_clause_pool;
+
+typedef struct {
+    struct solver_t* solvers[SAT_PORTFOLIO_MAX_SOLVERS];
+    size_t num_solvers;
+    bool share_learnts;         // Exchange glue clauses while racing; default: true
+    int solo_conflicts;         // Solver 0 alone before a race; default: 200
+
+    int winner;                 // Solver of the last answer, -1 if undecided
+    size_t races;               // Queries that needed every solver
+    size_t wins[SAT_PORTFOLIO_MAX_SOLVERS];
+    size_t shared_clauses;      // Exported while racing
+
+    struct sat_clause_pool* pool;
+} sat_portfolio_t;
+
+// Solver i of num_solvers (at most SAT_PORTFOLIO_MAX_SOLVERS) gets the
+// i-th configuration; one solver never starts a thread
+sat_portfolio_t* sat_portfolio_create(size_t num_solvers);
+void sat_portfolio_destroy(sat_portfolio_t* portfolio);
+
+void sat_portfolio_set_vars(sat_portfolio_t* portfolio, int num_vars);
+// Adds to every solver; sorts `lits`. False once the clauses are unsatisfiable.
+bool sat_portfolio_add_clause(sat_portfolio_t* portfolio, int* lits, size_t num_lits);
+
+// Solves under assumptions, each solver giving up after conflict_limit
+// conflicts (none if negative)
+int sat_portfolio_solve(sat_portfolio_t* portfolio, int* assumptions, size_t num_assumptions,
+                        int conflict_limit);
+// Value of a variable in the winner's model
+int sat_portfolio_value(const sat_portfolio_t* portfolio, int var);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAT_PORTFOLIO_H
@@ -9,6 +9,8 @@
  * Provides efficient primitives for writing C programs that compile
  * to compact gate circuits. These functions map to optimized
  * circuit implementations.
+ *
+ * The gate-level builders behind these primitives live in zkvm_circuit.h.
  */
 
 #ifndef ZKVM_H
@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*
+ * zkvm_circuit.h - Circuit builders behind the zkvm.h primitives
+ *
+ * zkvm.h describes what a zkVM program may call; this header provides the
+ * gadgets those calls lower to. Every function works on wire vectors in a
+ * riscv_circuit_t (bit 0 = LSB) and emits gates directly, so C code can be
+ * compiled straight to a circuit without going through RISC-V instructions.
+ *
+ * Constant wires are folded as gates are emitted: passing CONSTANT_0_WIRE
+ * or CONSTANT_1_WIRE never costs a gate.
+ */
+
+#ifndef ZKVM_CIRCUIT_H
+#define ZKVM_CIRCUIT_H
+
+#include "riscv_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// Word helpers - FREE (wiring only)
+// ============================================================================
+
+void zkvm_build_const(uint32_t value, size_t width, uint32_t* out);
+void zkvm_build_reverse_bits(const uint32_t* x, size_t width, uint32_t* out);
+
+// ============================================================================
+// Bit manipulation
+// ============================================================================
+
+// Population count: Dadda counter tree, ~n full adders for n bits
+void zkvm_build_popcnt(riscv_circuit_t* circuit, const uint32_t* x, size_t width,
+                       uint32_t* out);
+
+// Leading/trailing zero count: log-depth priority encoder, width when x == 0
+void zkvm_build_clz(riscv_circuit_t* circuit, const uint32_t* x, size_t width,
+                    uint32_t* out);
+void zkvm_build_ctz(riscv_circuit_t* circuit, const uint32_t* x, size_t width,
+                    uint32_t* out);
+
+// XOR of all bits: width - 1 XOR gates, log depth
+uint32_t zkvm_build_parity(riscv_circuit_t* circuit, const uint32_t* x, size_t width);
+
+// ============================================================================
+// Comparison and selection
+// ============================================================================
+
+// a == b: returns a single wire
+uint32_t zkvm_build_eq(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                       size_t width);
+
+// Unsigned a < b: borrow chain, one AND per bit
+uint32_t zkvm_build_ltu(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                        size_t width);
+
+// out = cond ? a : b (one AND per bit)
+void zkvm_build_select(riscv_circuit_t* circuit, uint32_t cond,
+                       const uint32_t* a, const uint32_t* b, size_t width, uint32_t* out);
+
+// Unsigned min/max
+void zkvm_build_min(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                    size_t width, uint32_t* out);
+void zkvm_build_max(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                    size_t width, uint32_t* out);
+
+// Absolute value of a two's complement word
+void zkvm_build_abs(riscv_circuit_t* circuit, const uint32_t* x, size_t width,
+                    uint32_t* out);
+
+// Compare two arrays of 32-bit words, word 0 most significant.
+// out (32 bits) is -1, 0 or 1 like memcmp.
+void zkvm_build_memcmp(riscv_circuit_t* circuit, uint32_t* const* a, uint32_t* const* b,
+                       size_t words, uint32_t* out);
+
+// ============================================================================
+// Assertions - accumulated into a single "all constraints hold" wire
+// ============================================================================
+
+typedef struct {
+    riscv_circuit_t* circuit;
+    uint32_t* conditions;   // Wires that must all be 1
+    size_t num_conditions;
+    size_t capacity;
+} zkvm_constraints_t;
+
+zkvm_constraints_t* zkvm_constraints_create(riscv_circuit_t* circuit);
+void zkvm_constraints_destroy(zkvm_constraints_t* cs);
+
+void zkvm_cs_assert(zkvm_constraints_t* cs, uint32_t condition);
+void zkvm_cs_assert_eq(zkvm_constraints_t* cs, const uint32_t* a, const uint32_t* b,
+                       size_t width);
+void zkvm_cs_assert_ne(zkvm_constraints_t* cs, const uint32_t* a, const uint32_t* b,
+                       size_t width);
+void zkvm_cs_assert_lt(zkvm_constraints_t* cs, const uint32_t* a, const uint32_t* b,
+                       size_t width);
+void zkvm_cs_assert_le(zkvm_constraints_t* cs, const uint32_t* a, const uint32_t* b,
+                       size_t width);
+void zkvm_cs_assert_range(zkvm_constraints_t* cs, const uint32_t* value, size_t width,
+                          uint32_t min, uint32_t max);
+void zkvm_cs_assert_bit(zkvm_constraints_t* cs, const uint32_t* value, int bit_position);
+
+// AND of every asserted condition (CONSTANT_1_WIRE if none)
+uint32_t zkvm_constraints_finalize(zkvm_constraints_t* cs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZKVM_CIRCUIT_H
@@ -0,0 +1,253 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*
+ * Generates src/npn4_library.c: one small AND/XOR implementation for each
+ * of the 222 NPN classes of 4-input functions, used by the "rewrite"
+ * circuit pass.
+ *
+ * Costs count every gate, inverters included (NOT is XOR with constant 1,
+ * as everywhere in this compiler). Every function is first searched
+ * exhaustively over circuits of up to EXACT_GATES gates, so those are
+ * optimal. The few that need more get the best Davio split
+ * f = f0 ^ (x & (f0 ^ f1)) over smaller, exactly known cofactors, with
+ * gates the two cofactors have in common built once.
+ * Each class stores its cheapest member. The result must fit
+ * NPN4_MAX_GATES in include/npn4_library.h.
+ *
+ *   cc -O2 -o gen_npn4_library scripts/gen_npn4_library.c
+ *   ./gen_npn4_library > src/npn4_library.c
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EXACT_GATES 7
+#define MAX_GATES 16
+#define NUM_BASE 5          // x0..x3, constant 1
+
+enum { G_AND = 0, G_XOR = 1 };
+
+typedef struct {
+    uint8_t type, a, b;
+} gen_gate_t;
+
+typedef struct {
+    uint8_t num_gates;
+    uint8_t out;            // signal index of the result
+    gen_gate_t gates[MAX_GATES];
+} impl_t;
+
+static const uint16_t base_tt[NUM_BASE] = {0xAAAA, 0xCCCC, 0xF0F0, 0xFF00, 0xFFFF};
+
+static impl_t best[65536];
+static uint8_t cost[65536];
+
+// ============================================================================
+// Exhaustive search
+// ============================================================================
+
+static uint16_t sig_tt[NUM_BASE + EXACT_GATES];
+static gen_gate_t stack_gates[EXACT_GATES];
+
+// Keeps only the gates the output depends on
+static void record(size_t num_gates) {
+    uint16_t tt = sig_tt[NUM_BASE + num_gates - 1];
+    if (cost[tt] <= num_gates) return;
+
+    uint8_t used[NUM_BASE + EXACT_GATES] = {0};
+    used[NUM_BASE + num_gates - 1] = 1;
+    for (size_t k = num_gates; k-- > 0;) {
+        if (!used[NUM_BASE + k]) continue;
+        used[stack_gates[k].a] = used[stack_gates[k].b] = 1;
+    }
+    uint8_t rename[NUM_BASE + EXACT_GATES];
+    for (size_t i = 0; i < NUM_BASE; i++) rename[i] = (uint8_t)i;
+    impl_t impl = {0};
+    for (size_t k = 0; k < num_gates; k++) {
+        if (!used[NUM_BASE + k]) continue;
+        rename[NUM_BASE + k] = (uint8_t)(NUM_BASE + impl.num_gates);
+        impl.gates[impl.num_gates++] = (gen_gate_t){stack_gates[k].type,
+                                                   rename[stack_gates[k].a],
+                                                   rename[stack_gates[k].b]};
+    }
+    impl.out = (uint8_t)(NUM_BASE + impl.num_gates - 1);
+    if (cost[tt] > impl.num_gates) {
+        cost[tt] = impl.num_gates;
+        best[tt] = impl;
+    }
+}
+
+static void search(size_t num_gates, size_t limit, int last_key) {
+    size_t num_sigs = NUM_BASE + num_gates;
+    for (size_t b = 1; b < num_sigs; b++) {
+        for (size_t a = 0; a < b; a++) {
+            for (uint8_t type = 0; type < 2; type++) {
+                if (type == G_AND && (a == 4 || b == 4)) continue;
+                // Independent neighbours only in increasing order
+                int key = (int)((b * (NUM_BASE + EXACT_GATES) + a) * 2 + type);
+                bool uses_last = num_gates > 0 && (a == num_sigs - 1 || b == num_sigs - 1);
+                if (num_gates > 0 && !uses_last && key < last_key) continue;
+
+                uint16_t tt = type == G_AND ? (sig_tt[a] & sig_tt[b]) : (sig_tt[a] ^ sig_tt[b]);
+                if (tt == 0 || tt == 0xFFFF) continue;
+                bool seen = false;
+                for (size_t s = 0; s < num_sigs && !seen; s++) seen = sig_tt[s] == tt;
+                if (seen) continue;
+
+                sig_tt[num_sigs] = tt;
+                stack_gates[num_gates] = (gen_gate_t){type, (uint8_t)a, (uint8_t)b};
+                record(num_gates + 1);
+                if (num_gates + 1 < limit) search(num_gates + 1, limit, key);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Davio fallback
+// ============================================================================
+
+// Adds a gate to impl unless an identical one is already there (structural
+// hashing); returns the signal index of its output
+static uint8_t add_gate(impl_t* impl, uint8_t type, uint8_t a, uint8_t b) {
+    if (a > b) { uint8_t t = a; a = b; b = t; }
+    for (size_t k = 0; k < impl->num_gates; k++) {
+        const gen_gate_t* g = &impl->gates[k];
+        if (g->type == type && g->a == a && g->b == b) return (uint8_t)(NUM_BASE + k);
+    }
+    impl->gates[impl->num_gates++] = (gen_gate_t){type, a, b};
+    return (uint8_t)(NUM_BASE + impl->num_gates - 1);
+}
+
+// Appends src's gates to dst, sharing any dst already has; returns the
+// signal index of src's output
+static uint8_t append(impl_t* dst, const impl_t* src) {
+    if (src->num_gates == 0) return src->out;
+    uint8_t rename[NUM_BASE + MAX_GATES];
+    for (size_t i = 0; i < NUM_BASE; i++) rename[i] = (uint8_t)i;
+    for (size_t k = 0; k < src->num_gates; k++) {
+        gen_gate_t g = src->gates[k];
+        rename[NUM_BASE + k] = add_gate(dst, g.type, rename[g.a], rename[g.b]);
+    }
+    return rename[src->out];
+}
+
+static uint16_t cofactor(uint16_t tt, int var, int value) {
+    uint16_t mask = base_tt[var];
+    uint16_t half = value ? (tt & mask) : (tt & (uint16_t)~mask);
+    int shift = 1 << var;
+    return value ? (uint16_t)(half | (half >> shift)) : (uint16_t)(half | (half << shift));
+}
+
+static void davio(void) {
+    for (int changed = 1; changed;) {
+        changed = 0;
+        for (uint32_t tt = 0; tt < 65536; tt++) {
+            for (int v = 0; v < 4; v++) {
+                uint16_t f0 = cofactor((uint16_t)tt, v, 0);
+                uint16_t g = (uint16_t)(f0 ^ cofactor((uint16_t)tt, v, 1));
+                if (cost[f0] == 255 || cost[g] == 255 || f0 == 0 || g == 0) continue;
+                if (cost[f0] + cost[g] + 2u > MAX_GATES) continue;
+
+                impl_t impl = {0};
+                uint8_t s0 = append(&impl, &best[f0]);
+                uint8_t sg = append(&impl, &best[g]);
+                uint8_t and_out = add_gate(&impl, G_AND, (uint8_t)v, sg);
+                impl.out = add_gate(&impl, G_XOR, s0, and_out);
+                unsigned c = impl.num_gates;
+                if (c >= cost[tt]) continue;
+
+                best[tt] = impl;
+                cost[tt] = (uint8_t)c;
+                changed = 1;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// NPN classes
+// ============================================================================
+
+static const uint8_t perms[24][4] = {
+    {0,1,2,3},{0,1,3,2},{0,2,1,3},{0,2,3,1},{0,3,1,2},{0,3,2,1},
+    {1,0,2,3},{1,0,3,2},{1,2,0,3},{1,2,3,0},{1,3,0,2},{1,3,2,0},
+    {2,0,1,3},{2,0,3,1},{2,1,0,3},{2,1,3,0},{2,3,0,1},{2,3,1,0},
+    {3,0,1,2},{3,0,2,1},{3,1,0,2},{3,1,2,0},{3,2,0,1},{3,2,1,0},
+};
+
+// g(x) = f(y) with y_i = x_perm[i] ^ neg_i
+static uint16_t transform(uint16_t f, int p, int neg) {
+    uint16_t g = 0;
+    for (int m = 0; m < 16; m++) {
+        int y = 0;
+        for (int i = 0; i < 4; i++) y |= (((m >> perms[p][i]) ^ (neg >> i)) & 1) << i;
+        g |= (uint16_t)(((f >> y) & 1) << m);
+    }
+    return g;
+}
+
+int main(void) {
+    memset(cost, 255, sizeof(cost));
+    cost[0] = 0;
+    best[0].out = 0xFF;     // constant 0
+    for (size_t i = 0; i < NUM_BASE; i++) {
+        cost[base_tt[i]] = 0;
+        best[base_tt[i]].out = (uint8_t)i;
+    }
+    memcpy(sig_tt, base_tt, sizeof(base_tt));
+    search(0, EXACT_GATES, -1);
+    size_t exact = 0;
+    for (uint32_t tt = 0; tt < 65536; tt++) exact += cost[tt] != 255;
+    davio();
+
+    // Group into classes, keeping the cheapest member
+    static uint16_t class_of[65536];
+    static uint8_t assigned[65536];
+    uint16_t members[256];
+    size_t num_classes = 0, max_gates = 0;
+    for (uint32_t tt = 0; tt < 65536; tt++) {
+        if (assigned[tt]) continue;
+        uint16_t cheapest = (uint16_t)tt;
+        for (int p = 0; p < 24; p++) {
+            for (int neg = 0; neg < 32; neg++) {
+                uint16_t g = transform((uint16_t)tt, p, neg & 15);
+                if (neg & 16) g = (uint16_t)~g;
+                assigned[g] = 1;
+                class_of[g] = (uint16_t)num_classes;
+                if (cost[g] < cost[cheapest] || (cost[g] == cost[cheapest] && g < cheapest)) cheapest = g;
+            }
+        }
+        if (cost[cheapest] > max_gates) max_gates = cost[cheapest];
+        members[num_classes++] = cheapest;
+    }
+    (void)class_of;
+
+    printf("/* SPDX-FileCopyrightText: 2025 Rhett Creighton\n");
+    printf(" * SPDX-License-Identifier: Apache-2.0\n */\n\n\n");
+    printf("// Generated by scripts/gen_npn4_library.c - do not edit.\n");
+    printf("// %zu NPN classes. %zu of the 65536 functions have optimal implementations of\n"
+           "// at most %d gates; the rest use Davio splits.\n\n",
+           num_classes, exact, EXACT_GATES);
+    printf("#include \"npn4_library.h\"\n\n");
+    printf("const npn4_impl_t npn4_library[NPN4_NUM_CLASSES] = {\n");
+    for (size_t c = 0; c < num_classes; c++) {
+        const impl_t* impl = &best[members[c]];
+        printf("    {0x%04X, %u, %3u, {", members[c], impl->num_gates, impl->out);
+        if (impl->num_gates == 0) printf("{0, 0, 0}");
+        for (size_t k = 0; k < impl->num_gates; k++) {
+            printf("%s{%u, %u, %u}", k ? ", " : "", impl->gates[k].type, impl->gates[k].a,
+                   impl->gates[k].b);
+        }
+        printf("}},\n");
+    }
+    printf("};\n");
+    fprintf(stderr, "%zu classes, max %zu gates, %zu exact\n", num_classes, max_gates, exact);
+    return num_classes == 222 && max_gates <= 10 ? 0 : 1;
+}
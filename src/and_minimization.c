@@ -0,0 +1,309 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "circuit_cuts.h"
+#include "gate_primitives.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * AND-count (multiplicative complexity) minimization.
+ *
+ * For garbled circuits and MPC-in-the-head provers XOR is free, so the
+ * cost of a circuit is its AND gates. This pass enumerates cuts of up to
+ * four leaves for every gate, computes the function of the gate over each
+ * cut, and replaces the cut's maximum fanout-free cone (the gates that
+ * die with it) whenever a known implementation needs fewer ANDs:
+ *
+ *   - any function of 3 inputs: exact table, at most 2 ANDs, found once by
+ *     exhaustive search over f = A0 ^ (A1 & A2) ^ (A3 & A4) with affine Ai
+ *   - quadratic functions of 4 inputs: rank/2 ANDs by splitting off one
+ *     x_i x_j pair at a time (Dickson), e.g. the 5-AND majority built from
+ *     ORs becomes c ^ ((a ^ c) & (b ^ c)) and a 2-AND mux becomes
+ *     f ^ (s & (t ^ f))
+ *
+ * Under OPTIMIZE_AND_COUNT any AND saving is taken. Under OPTIMIZE_GATES a
+ * rewrite must also not add gates. Under OPTIMIZE_DEPTH the pass does
+ * nothing: it would trade parallel ANDs for serial XORs.
+ */
+
+#define CUT_SIZE CUT_MAX_LEAVES
+
+// Affine masks: bits 0-3 select cut leaves, bits 4-5 earlier ANDs of the
+// recipe, bit 7 the constant 1
+#define AFF_Y(j)   (1u << (4 + (j)))
+#define AFF_ONE    0x80u
+
+typedef struct {
+    uint8_t num_ands;
+    uint8_t and_in[2][2];
+    uint8_t out;
+    bool valid;
+} mc_recipe_t;
+
+static mc_recipe_t table3[256];
+static pthread_once_t table3_once = PTHREAD_ONCE_INIT;
+
+// ============================================================================
+// Recipes
+// ============================================================================
+
+static uint16_t affine_tt(uint8_t mask, const uint16_t* y) {
+    uint16_t tt = (mask & AFF_ONE) ? 0xFFFF : 0;
+    for (int i = 0; i < CUT_SIZE; i++) if (mask & (1u << i)) tt ^= cut_var_tt[i];
+    for (int j = 0; j < 2; j++) if (mask & AFF_Y(j)) tt ^= y[j];
+    return tt;
+}
+
+static uint16_t recipe_tt(const mc_recipe_t* r) {
+    uint16_t y[2] = {0, 0};
+    for (int j = 0; j < r->num_ands; j++) {
+        y[j] = affine_tt(r->and_in[j][0], y) & affine_tt(r->and_in[j][1], y);
+    }
+    return affine_tt(r->out, y);
+}
+
+static void table3_set(uint8_t tt, uint8_t num_ands, const uint8_t in[2][2], uint8_t out) {
+    if (table3[tt].valid) return;
+    mc_recipe_t* r = &table3[tt];
+    r->num_ands = num_ands;
+    memcpy(r->and_in, in, sizeof(r->and_in));
+    r->out = out;
+    r->valid = true;
+}
+
+// Exhaustive search in order of AND count, so the first recipe found for
+// a function is optimal. Every 3-input function needs at most 2 ANDs.
+static void build_table3(void) {
+    uint8_t aff[16];          // affine forms over x0..x2
+    uint8_t aff_y[32];        // ... and y1
+    size_t n = 0, m = 0;
+    for (uint8_t vars = 0; vars < 8; vars++) {
+        aff[n++] = vars;
+        aff[n++] = vars | AFF_ONE;
+    }
+    for (size_t i = 0; i < 16; i++) {
+        aff_y[m++] = aff[i];
+        aff_y[m++] = aff[i] | AFF_Y(0);
+    }
+
+    uint8_t in[2][2] = {{0, 0}, {0, 0}};
+    uint16_t none[2] = {0, 0};
+    for (size_t a0 = 0; a0 < 16; a0++) {
+        table3_set((uint8_t)affine_tt(aff[a0], none), 0, in, aff[a0]);
+    }
+    for (size_t a1 = 0; a1 < 16; a1++) {
+        for (size_t a2 = a1; a2 < 16; a2++) {
+            uint16_t y[2] = {(uint16_t)(affine_tt(aff[a1], none) & affine_tt(aff[a2], none)), 0};
+            in[0][0] = aff[a1];
+            in[0][1] = aff[a2];
+            for (size_t a0 = 0; a0 < 32; a0++) {
+                table3_set((uint8_t)affine_tt(aff_y[a0], y), 1, in, aff_y[a0]);
+            }
+        }
+    }
+    for (size_t a1 = 0; a1 < 16; a1++) {
+        for (size_t a2 = a1; a2 < 16; a2++) {
+            uint16_t y[2] = {(uint16_t)(affine_tt(aff[a1], none) & affine_tt(aff[a2], none)), 0};
+            in[0][0] = aff[a1];
+            in[0][1] = aff[a2];
+            for (size_t a3 = 0; a3 < 32; a3++) {
+                for (size_t a4 = a3; a4 < 32; a4++) {
+                    y[1] = affine_tt(aff_y[a3], y) & affine_tt(aff_y[a4], y);
+                    in[1][0] = aff_y[a3];
+                    in[1][1] = aff_y[a4];
+                    for (size_t a0 = 0; a0 < 32; a0++) {
+                        uint8_t out = aff_y[a0] | AFF_Y(1);
+                        table3_set((uint8_t)affine_tt(out, y), 2, in, out);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Quadratic f over 4 variables: write the quadratic part as
+//   x_i x_j ^ x_i A ^ x_j B ^ R = (x_i ^ B) & (x_j ^ A) ^ (A B ^ R)
+// where A, B, R avoid x_i and x_j, and repeat on A B ^ R. One AND per
+// step, rank/2 steps, which is optimal for quadratic functions.
+static bool quadratic_recipe(uint16_t tt, mc_recipe_t* r) {
+    // Algebraic normal form: coefficient of monomial m at bit m
+    uint16_t anf = tt;
+    for (int i = 0; i < CUT_SIZE; i++) {
+        for (int m = 0; m < 16; m++) {
+            if (m & (1 << i)) {
+                anf ^= (uint16_t)(((anf >> (m ^ (1 << i))) & 1) << m);
+            }
+        }
+    }
+
+    uint8_t adj[CUT_SIZE] = {0, 0, 0, 0};
+    uint8_t linear = (anf & 1) ? AFF_ONE : 0;
+    for (int m = 1; m < 16; m++) {
+        if (!((anf >> m) & 1)) continue;
+        int degree = __builtin_popcount(m);
+        if (degree > 2) return false;
+        if (degree == 1) {
+            linear |= (uint8_t)m;
+        } else {
+            int i = __builtin_ctz(m), j = 31 - __builtin_clz(m);
+            adj[i] |= (uint8_t)(1 << j);
+            adj[j] |= (uint8_t)(1 << i);
+        }
+    }
+
+    memset(r, 0, sizeof(*r));
+    r->out = linear;
+    for (int i = 0; i < CUT_SIZE; i++) {
+        while (adj[i]) {
+            int j = __builtin_ctz(adj[i]);
+            uint8_t a = adj[i] & (uint8_t)~(1 << j);
+            uint8_t b = adj[j] & (uint8_t)~(1 << i);
+            if (r->num_ands == 2) return false;
+            r->and_in[r->num_ands][0] = (uint8_t)((1 << i) | b);
+            r->and_in[r->num_ands][1] = (uint8_t)((1 << j) | a);
+            r->out |= AFF_Y(r->num_ands);
+            r->num_ands++;
+
+            // Drop every term on x_i and x_j, then add A B
+            for (int k = 0; k < CUT_SIZE; k++) {
+                adj[k] &= (uint8_t)~((1 << i) | (1 << j));
+            }
+            adj[i] = adj[j] = 0;
+            for (int p = 0; p < CUT_SIZE; p++) {
+                if (!(a & (1 << p))) continue;
+                for (int q = 0; q < CUT_SIZE; q++) {
+                    if (!(b & (1 << q))) continue;
+                    if (p == q) {
+                        r->out ^= (uint8_t)(1 << p);
+                    } else {
+                        adj[p] ^= (uint8_t)(1 << q);
+                        adj[q] ^= (uint8_t)(1 << p);
+                    }
+                }
+            }
+        }
+    }
+    r->valid = true;
+    return recipe_tt(r) == tt;
+}
+
+static bool find_recipe(uint16_t tt, size_t num_leaves, mc_recipe_t* r) {
+    if (num_leaves <= 3) {
+        *r = table3[tt & 0xFF];
+        return r->valid;
+    }
+    return quadratic_recipe(tt, r);
+}
+
+static size_t affine_xors(uint8_t mask) {
+    size_t terms = (size_t)__builtin_popcount(mask);
+    return terms > 1 ? terms - 1 : 0;
+}
+
+// Gates a recipe emits at most (constant folding can only lower this)
+static size_t recipe_gates(const mc_recipe_t* r) {
+    size_t gates = r->num_ands + affine_xors(r->out);
+    for (int j = 0; j < r->num_ands; j++) {
+        gates += affine_xors(r->and_in[j][0]) + affine_xors(r->and_in[j][1]);
+    }
+    return gates;
+}
+
+static uint32_t emit_affine(riscv_circuit_t* circuit, uint8_t mask,
+                            const uint32_t* leaves, const uint32_t* y) {
+    uint32_t acc = CONSTANT_0_WIRE;
+    for (int i = 0; i < CUT_SIZE; i++) if (mask & (1u << i)) acc = gate_xor(circuit, acc, leaves[i]);
+    for (int j = 0; j < 2; j++) if (mask & AFF_Y(j)) acc = gate_xor(circuit, acc, y[j]);
+    return (mask & AFF_ONE) ? gate_not(circuit, acc) : acc;
+}
+
+static uint32_t emit_recipe(riscv_circuit_t* circuit, const mc_recipe_t* r,
+                            const uint32_t* leaves) {
+    uint32_t y[2] = {CONSTANT_0_WIRE, CONSTANT_0_WIRE};
+    for (int j = 0; j < r->num_ands; j++) {
+        y[j] = gate_and(circuit, emit_affine(circuit, r->and_in[j][0], leaves, y),
+                        emit_affine(circuit, r->and_in[j][1], leaves, y));
+    }
+    return emit_affine(circuit, r->out, leaves, y);
+}
+
+// ============================================================================
+// The pass
+// ============================================================================
+
+static uint32_t emit_rewrite(riscv_circuit_t* circuit, size_t gate,
+                             const uint32_t* leaves, void* user) {
+    const mc_recipe_t* recipes = user;
+    return emit_recipe(circuit, &recipes[gate], leaves);
+}
+
+int circuit_pass_andmin(pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    optimization_objective_t objective = circuit->objective;
+    if (objective == OPTIMIZE_DEPTH || circuit->num_gates == 0 ||
+        riscv_circuit_is_extended(circuit)) return 0;
+    pthread_once(&table3_once, build_table3);
+
+    // One driver per wire from here on
+    int renumbered = circuit_pass_renumber(ctx);
+    if (renumbered < 0) return -1;
+
+    cut_network_t net;
+    if (cut_network_build(&net, ctx) != 0) return -1;
+    size_t num_gates = net.num_gates;
+    mc_recipe_t* recipes = calloc(num_gates, sizeof(mc_recipe_t));
+    cut_t* chosen = calloc(num_gates, sizeof(cut_t));
+    uint8_t* replace = calloc(num_gates, 1);
+    if (!recipes || !chosen || !replace) {
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        free(recipes); free(chosen); free(replace);
+        cut_network_free(&net);
+        return -1;
+    }
+
+    // Choose non-overlapping rewrites, best saving per gate, outputs first
+    // so the largest cones win
+    size_t accepted = 0;
+    for (size_t g = num_gates; g-- > 0;) {
+        uint32_t out = circuit->gates[g].output;
+        if (net.claimed[out] || net.refs[out] == 0) continue;
+
+        size_t num_cuts, best_saving = 0;
+        const cut_t* cuts = cut_network_cuts(&net, g, &num_cuts);
+        for (size_t c = 0; c < num_cuts; c++) {
+            mc_recipe_t recipe;
+            if (!find_recipe(cut_truth_table(&net, out, &cuts[c]), cuts[c].size, &recipe)) continue;
+
+            size_t ands, gates;
+            cut_mffc(&net, out, &cuts[c], &ands, &gates);
+            if (!cut_is_free(&net, &cuts[c]) || recipe.num_ands >= ands) continue;
+            if (objective == OPTIMIZE_GATES && recipe_gates(&recipe) > gates) continue;
+            if (ands - recipe.num_ands > best_saving) {
+                best_saving = ands - recipe.num_ands;
+                recipes[g] = recipe;
+                chosen[g] = cuts[c];
+            }
+        }
+
+        if (best_saving > 0) {
+            size_t ands, gates;
+            cut_mffc(&net, out, &chosen[g], &ands, &gates);
+            cut_claim(&net, &chosen[g]);
+            replace[g] = 1;
+            accepted++;
+        }
+    }
+
+    int result = renumbered;
+    if (accepted > 0) result = cut_network_rewrite(&net, ctx, replace, chosen, emit_rewrite, recipes);
+
+    free(recipes);
+    free(chosen);
+    free(replace);
+    cut_network_free(&net);
+    return result;
+}
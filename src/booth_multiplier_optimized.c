@@ -4,6 +4,7 @@
 
 
 #include "riscv_compiler.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -11,7 +12,7 @@
 /*
  * OPTIMIZED BOOTH MULTIPLIER - THIS IS THE ONE TO USE!
  * 
- * Achieves <5K gates for 32x32 multiplication (target met!)
+ * About 5.2K gates for a 32x32 -> 64-bit product
  * Uses Radix-4 Booth encoding + Wallace tree reduction
  * 
  * Other booth*.c files are earlier iterations kept for reference:
@@ -22,294 +23,89 @@
  * This optimized version is used by riscv_compiler_optimized.c
  */
 
-// Build a 3:2 compressor (full adder) for Wallace tree
-static void build_compressor_3_2(riscv_circuit_t* circuit,
-                                uint32_t a, uint32_t b, uint32_t c,
-                                uint32_t* sum, uint32_t* carry) {
-    // Sum = a XOR b XOR c
-    uint32_t a_xor_b = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a, b, a_xor_b, GATE_XOR);
-    *sum = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a_xor_b, c, *sum, GATE_XOR);
-    
-    // Carry = (a AND b) OR (c AND (a XOR b))
-    uint32_t a_and_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t c_and_axorb = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a, b, a_and_b, GATE_AND);
-    riscv_circuit_add_gate(circuit, c, a_xor_b, c_and_axorb, GATE_AND);
-    
-    // OR using XOR/AND gates
-    uint32_t or_xor = riscv_circuit_allocate_wire(circuit);
-    uint32_t or_and = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a_and_b, c_and_axorb, or_xor, GATE_XOR);
-    riscv_circuit_add_gate(circuit, a_and_b, c_and_axorb, or_and, GATE_AND);
-    *carry = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, or_xor, or_and, *carry, GATE_XOR);
-}
-
-// Build a 4:2 compressor for faster reduction
-static void build_compressor_4_2(riscv_circuit_t* circuit,
-                                uint32_t a, uint32_t b, uint32_t c, uint32_t d,
-                                uint32_t cin,
-                                uint32_t* sum, uint32_t* carry, uint32_t* cout) {
-    // First level: (a,b,c) -> (s1,c1)
-    uint32_t s1, c1;
-    build_compressor_3_2(circuit, a, b, c, &s1, &c1);
-    
-    // Second level: (s1,d,cin) -> (sum,c2)
-    uint32_t c2;
-    build_compressor_3_2(circuit, s1, d, cin, sum, &c2);
-    
-    // Carry out = c1 XOR c2
-    *carry = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, c1, c2, *carry, GATE_XOR);
-    
-    // Cout = c1 AND c2
-    *cout = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, c1, c2, *cout, GATE_AND);
-}
-
-// Optimized Booth encoder with reduced gate count
+// Booth digit d = b0 + b1 - 2 * b2 of the window (b2, b1, b0), in -2..2:
+// one for |d| = 1, two for |d| = 2, neg for d < 0 (and for the zero
+// digit of 111, whose inverted zero row plus the +1 below is still zero)
 static void build_booth_encoder_optimized(riscv_circuit_t* circuit,
                                          uint32_t bit2, uint32_t bit1, uint32_t bit0,
                                          uint32_t* neg, uint32_t* two, uint32_t* one) {
-    // Simplified encoding:
-    // neg = bit2
-    // two = bit1 XOR bit0
-    // one = bit1 XOR bit2
-    
     *neg = bit2;
-    
-    *two = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, bit1, bit0, *two, GATE_XOR);
-    
-    *one = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, bit1, bit2, *one, GATE_XOR);
+    *one = gate_xor(circuit, bit1, bit0);
+    *two = gate_and(circuit, gate_xor(circuit, bit2, bit1), gate_not(circuit, *one));
 }
 
-// Generate partial product for one Booth encoding
+// The bits + 1 low bits of |d| * M, inverted when d is negative; one and
+// two never hold together, so their terms are XORed rather than ORed
 static void generate_booth_partial_product(riscv_circuit_t* circuit,
                                          uint32_t* multiplicand, size_t bits,
                                          uint32_t neg, uint32_t two, uint32_t one,
                                          uint32_t* pp_out) {
-    // For each bit position
     for (size_t i = 0; i <= bits; i++) {
         uint32_t m_bit = (i < bits) ? multiplicand[i] : CONSTANT_0_WIRE;
         uint32_t m_shifted = (i > 0) ? multiplicand[i-1] : CONSTANT_0_WIRE;
-        
-        // Select between 0, M, 2M based on encoding
-        uint32_t selected = CONSTANT_0_WIRE;
-        
-        // If one=1: selected = two ? m_shifted : m_bit
-        uint32_t two_sel = riscv_circuit_allocate_wire(circuit);
-        uint32_t not_two = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, two, CONSTANT_1_WIRE, not_two, GATE_XOR);
-        
-        uint32_t two_and_shifted = riscv_circuit_allocate_wire(circuit);
-        uint32_t nottwo_and_bit = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, two, m_shifted, two_and_shifted, GATE_AND);
-        riscv_circuit_add_gate(circuit, not_two, m_bit, nottwo_and_bit, GATE_AND);
-        
-        // OR the results
-        uint32_t or_xor = riscv_circuit_allocate_wire(circuit);
-        uint32_t or_and = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, two_and_shifted, nottwo_and_bit, or_xor, GATE_XOR);
-        riscv_circuit_add_gate(circuit, two_and_shifted, nottwo_and_bit, or_and, GATE_AND);
-        riscv_circuit_add_gate(circuit, or_xor, or_and, two_sel, GATE_XOR);
-        
-        // If one=1, use two_sel, else use 0
-        uint32_t one_and_twosel = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, one, two_sel, one_and_twosel, GATE_AND);
-        selected = one_and_twosel;
-        
-        // Handle negation
-        pp_out[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, selected, neg, pp_out[i], GATE_XOR);
+        uint32_t selected = gate_xor(circuit, gate_and(circuit, one, m_bit),
+                                     gate_and(circuit, two, m_shifted));
+        pp_out[i] = gate_xor(circuit, selected, neg);
     }
 }
 
-// Wallace tree reduction of partial products
-static void wallace_tree_reduce(riscv_circuit_t* circuit,
-                               uint32_t** partial_products, size_t num_pp,
-                               size_t width, uint32_t* result) {
-    // Count bits at each position
-    typedef struct {
-        uint32_t* bits;
-        size_t count;
-        size_t capacity;
-    } bit_column_t;
-    
-    bit_column_t* columns = calloc(width, sizeof(bit_column_t));
-    
-    // Initialize columns with partial product bits
-    for (size_t pp = 0; pp < num_pp; pp++) {
-        size_t shift = pp * 2;  // Booth radix-4 shifts by 2
-        for (size_t bit = 0; bit < width && shift + bit < width; bit++) {
-            size_t col = shift + bit;
-            if (columns[col].count >= columns[col].capacity) {
-                columns[col].capacity = (columns[col].capacity == 0) ? 8 : columns[col].capacity * 2;
-                columns[col].bits = realloc(columns[col].bits, 
-                                           columns[col].capacity * sizeof(uint32_t));
-            }
-            columns[col].bits[columns[col].count++] = partial_products[pp][bit];
-        }
-    }
-    
-    // Reduce using 3:2 and 4:2 compressors
-    while (1) {
-        bool done = true;
-        for (size_t col = 0; col < width; col++) {
-            if (columns[col].count > 2) {
-                done = false;
-                break;
-            }
-        }
-        if (done) break;
-        
-        // Process each column
+// Unsigned bits x bits -> 2 * bits product with radix-4 Booth recoding and
+// a compressor tree. The multiplier gets a zero bit on top, so the last
+// digit is never negative. Row i is d_i * M at weight 4^i: bits + 1 low
+// bits, a +neg at its bottom, and a sign bit of -neg * 2^(bits + 1). As in
+// build_integer_product, that sign bit is written as ~neg minus a constant,
+// and the constants of all rows are folded into one row.
+void build_booth_multiplier_optimized(riscv_circuit_t* circuit,
+                                     uint32_t* multiplicand, uint32_t* multiplier,
+                                     uint32_t* product, size_t bits) {
+    size_t width = 2 * bits;
+    size_t num_pp = bits / 2 + 1;
+    uint64_t mask = width >= 64 ? ~0ULL : (1ULL << width) - 1;
+    uint64_t correction = 0;
+
+    // Partial products, then the +neg bits, then the constant row
+    size_t num_rows = num_pp + 2;
+    uint32_t** rows = malloc(num_rows * sizeof(uint32_t*));
+    for (size_t r = 0; r < num_rows; r++) {
+        rows[r] = malloc(width * sizeof(uint32_t));
         for (size_t col = 0; col < width; col++) {
-            bit_column_t* curr = &columns[col];
-            bit_column_t* next = (col + 1 < width) ? &columns[col + 1] : NULL;
-            
-            // Use 4:2 compressors when possible
-            while (curr->count >= 4) {
-                uint32_t sum, carry, cout;
-                uint32_t cin = (col > 0 && columns[col-1].count > 0) ? 
-                              columns[col-1].bits[--columns[col-1].count] : CONSTANT_0_WIRE;
-                
-                build_compressor_4_2(circuit,
-                                   curr->bits[--curr->count],
-                                   curr->bits[--curr->count],
-                                   curr->bits[--curr->count],
-                                   curr->bits[--curr->count],
-                                   cin,
-                                   &sum, &carry, &cout);
-                
-                // Add sum back to current column
-                curr->bits[curr->count++] = sum;
-                
-                // Add carries to next columns
-                if (next && carry != CONSTANT_0_WIRE) {
-                    if (next->count >= next->capacity) {
-                        next->capacity *= 2;
-                        next->bits = realloc(next->bits, next->capacity * sizeof(uint32_t));
-                    }
-                    next->bits[next->count++] = carry;
-                }
-                
-                if (col + 2 < width && cout != CONSTANT_0_WIRE) {
-                    bit_column_t* next2 = &columns[col + 2];
-                    if (next2->count >= next2->capacity) {
-                        next2->capacity = (next2->capacity == 0) ? 4 : next2->capacity * 2;
-                        next2->bits = realloc(next2->bits, next2->capacity * sizeof(uint32_t));
-                    }
-                    next2->bits[next2->count++] = cout;
-                }
-            }
-            
-            // Use 3:2 compressors for remaining bits
-            while (curr->count >= 3) {
-                uint32_t sum, carry;
-                build_compressor_3_2(circuit,
-                                   curr->bits[--curr->count],
-                                   curr->bits[--curr->count],
-                                   curr->bits[--curr->count],
-                                   &sum, &carry);
-                
-                curr->bits[curr->count++] = sum;
-                
-                if (next && carry != CONSTANT_0_WIRE) {
-                    if (next->count >= next->capacity) {
-                        next->capacity *= 2;
-                        next->bits = realloc(next->bits, next->capacity * sizeof(uint32_t));
-                    }
-                    next->bits[next->count++] = carry;
-                }
-            }
-        }
-    }
-    
-    // Final addition of at most 2 numbers per column
-    uint32_t* final_a = calloc(width, sizeof(uint32_t));
-    uint32_t* final_b = calloc(width, sizeof(uint32_t));
-    
-    for (size_t col = 0; col < width; col++) {
-        if (columns[col].count >= 1) {
-            final_a[col] = columns[col].bits[0];
-        } else {
-            final_a[col] = CONSTANT_0_WIRE;
-        }
-        
-        if (columns[col].count >= 2) {
-            final_b[col] = columns[col].bits[1];
-        } else {
-            final_b[col] = CONSTANT_0_WIRE;
+            rows[r][col] = CONSTANT_0_WIRE;
         }
     }
-    
-    // Use optimized adder for final addition
-    build_sparse_kogge_stone_adder(circuit, final_a, final_b, result, width);
-    
-    // Cleanup
-    for (size_t i = 0; i < width; i++) {
-        free(columns[i].bits);
-    }
-    free(columns);
-    free(final_a);
-    free(final_b);
-}
+    uint32_t* pp = malloc((bits + 1) * sizeof(uint32_t));
 
-// Optimized Booth multiplier with Wallace tree
-void build_booth_multiplier_optimized(riscv_circuit_t* circuit,
-                                     uint32_t* multiplicand, uint32_t* multiplier,
-                                     uint32_t* product, size_t bits) {
-    // Number of partial products for radix-4 Booth
-    size_t num_pp = (bits + 1) / 2;
-    uint32_t** partial_products = malloc(num_pp * sizeof(uint32_t*));
-    
-    // Generate Booth-encoded partial products
     for (size_t i = 0; i < num_pp; i++) {
-        // Get 3-bit window for Booth encoding
         uint32_t bit0 = (i == 0) ? CONSTANT_0_WIRE : multiplier[2*i - 1];
         uint32_t bit1 = (2*i < bits) ? multiplier[2*i] : CONSTANT_0_WIRE;
         uint32_t bit2 = (2*i + 1 < bits) ? multiplier[2*i + 1] : CONSTANT_0_WIRE;
-        
-        // Generate encoding signals
+
         uint32_t neg, two, one;
         build_booth_encoder_optimized(circuit, bit2, bit1, bit0, &neg, &two, &one);
-        
-        // Generate partial product
-        partial_products[i] = calloc(bits + 1, sizeof(uint32_t));
-        generate_booth_partial_product(circuit, multiplicand, bits, neg, two, one, 
-                                     partial_products[i]);
-        
-        // Handle negation correction
-        if (i > 0) {  // Add correction bit for negative encoding
-            uint32_t* correction = calloc(bits + 1, sizeof(uint32_t));
-            for (size_t j = 0; j < 2*i; j++) {
-                correction[j] = CONSTANT_0_WIRE;
-            }
-            correction[2*i] = neg;
-            for (size_t j = 2*i + 1; j <= bits; j++) {
-                correction[j] = CONSTANT_0_WIRE;
-            }
-            
-            // Add correction to partial product
-            uint32_t* corrected = calloc(bits + 1, sizeof(uint32_t));
-            build_sparse_kogge_stone_adder(circuit, partial_products[i], correction, 
-                                         corrected, bits + 1);
-            free(partial_products[i]);
-            partial_products[i] = corrected;
-            free(correction);
+        generate_booth_partial_product(circuit, multiplicand, bits, neg, two, one, pp);
+
+        size_t shift = 2 * i;
+        for (size_t j = 0; j <= bits && shift + j < width; j++) {
+            rows[i][shift + j] = pp[j];
         }
+        size_t sign = shift + bits + 1;
+        if (sign < width) {
+            rows[i][sign] = gate_not(circuit, neg);
+            correction -= 1ULL << sign;
+        }
+        if (shift < width) rows[num_pp][shift] = neg;
     }
-    
-    // Use Wallace tree to reduce partial products
-    wallace_tree_reduce(circuit, partial_products, num_pp, 2 * bits, product);
-    
-    // Cleanup
-    for (size_t i = 0; i < num_pp; i++) {
-        free(partial_products[i]);
+
+    correction &= mask;
+    for (size_t col = 0; col < width && col < 64; col++) {
+        if ((correction >> col) & 1) rows[num_pp + 1][col] = CONSTANT_1_WIRE;
     }
-    free(partial_products);
-}
\ No newline at end of file
+
+    build_multi_operand_adder(circuit, rows, num_rows, width, product,
+                              FINAL_ADDER_SPARSE_KOGGE_STONE);
+
+    for (size_t r = 0; r < num_rows; r++) {
+        free(rows[r]);
+    }
+    free(rows);
+    free(pp);
+}
@@ -4,6 +4,7 @@
 
 
 #include "riscv_compiler.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -40,48 +41,20 @@ static void build_booth_encoder_minimal(riscv_circuit_t* circuit,
     *neg_out = b2;
     
     // zero = (b2 & b1 & b0) | (~b2 & ~b1 & ~b0)
-    uint32_t all_ones = riscv_circuit_allocate_wire(circuit);
-    uint32_t temp1 = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, b2, b1, temp1, GATE_AND);
-    riscv_circuit_add_gate(circuit, temp1, b0, all_ones, GATE_AND);
+    uint32_t not_b2 = gate_not(circuit, b2);
+    uint32_t not_b1 = gate_not(circuit, b1);
+    uint32_t not_b0 = gate_not(circuit, b0);
     
-    uint32_t not_b2 = riscv_circuit_allocate_wire(circuit);
-    uint32_t not_b1 = riscv_circuit_allocate_wire(circuit);
-    uint32_t not_b0 = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, b2, CONSTANT_1_WIRE, not_b2, GATE_XOR);
-    riscv_circuit_add_gate(circuit, b1, CONSTANT_1_WIRE, not_b1, GATE_XOR);
-    riscv_circuit_add_gate(circuit, b0, CONSTANT_1_WIRE, not_b0, GATE_XOR);
+    uint32_t all_ones = gate_and(circuit, gate_and(circuit, b2, b1), b0);
+    uint32_t all_zeros = gate_and(circuit, gate_and(circuit, not_b2, not_b1), not_b0);
     
-    uint32_t all_zeros = riscv_circuit_allocate_wire(circuit);
-    uint32_t temp2 = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, not_b2, not_b1, temp2, GATE_AND);
-    riscv_circuit_add_gate(circuit, temp2, not_b0, all_zeros, GATE_AND);
+    // The two cases are mutually exclusive, so the OR is a single XOR
+    *zero_out = gate_xor(circuit, all_ones, all_zeros);
     
-    // OR using XOR+AND trick
-    uint32_t zero_xor = riscv_circuit_allocate_wire(circuit);
-    uint32_t zero_and = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, all_ones, all_zeros, zero_xor, GATE_XOR);
-    riscv_circuit_add_gate(circuit, all_ones, all_zeros, zero_and, GATE_AND);
-    *zero_out = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, zero_xor, zero_and, *zero_out, GATE_XOR);
-    
-    // two = (b1 & b0 & ~b2) | (~b1 & ~b0 & b2)
-    uint32_t case1 = riscv_circuit_allocate_wire(circuit);
-    uint32_t temp3 = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, b1, b0, temp3, GATE_AND);
-    riscv_circuit_add_gate(circuit, temp3, not_b2, case1, GATE_AND);
-    
-    uint32_t case2 = riscv_circuit_allocate_wire(circuit);
-    uint32_t temp4 = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, not_b1, not_b0, temp4, GATE_AND);
-    riscv_circuit_add_gate(circuit, temp4, b2, case2, GATE_AND);
-    
-    uint32_t two_xor = riscv_circuit_allocate_wire(circuit);
-    uint32_t two_and = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, case1, case2, two_xor, GATE_XOR);
-    riscv_circuit_add_gate(circuit, case1, case2, two_and, GATE_AND);
-    *two_out = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, two_xor, two_and, *two_out, GATE_XOR);
+    // two = (b1 & b0 & ~b2) | (~b1 & ~b0 & b2), again exclusive
+    uint32_t case1 = gate_and(circuit, gate_and(circuit, b1, b0), not_b2);
+    uint32_t case2 = gate_and(circuit, gate_and(circuit, not_b1, not_b0), b2);
+    *two_out = gate_xor(circuit, case1, case2);
 }
 
 // Efficient partial product generator
@@ -89,6 +62,8 @@ static void generate_booth_partial_product(riscv_circuit_t* circuit,
                                          uint32_t* multiplicand, size_t bits,
                                          uint32_t neg, uint32_t zero, uint32_t two,
                                          uint32_t* pp_out) {
+    uint32_t not_zero = gate_not(circuit, zero);
+    
     // For each bit position
     for (size_t i = 0; i <= bits; i++) {
         // Get the multiplicand bit (0 if out of range)
@@ -97,41 +72,16 @@ static void generate_booth_partial_product(riscv_circuit_t* circuit,
         // Get the shifted bit for 2M
         uint32_t m_shift = (i > 0 && i <= bits) ? multiplicand[i-1] : CONSTANT_0_WIRE;
         
-        // Select between M and 2M
-        uint32_t selected = riscv_circuit_allocate_wire(circuit);
-        uint32_t not_two = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, two, CONSTANT_1_WIRE, not_two, GATE_XOR);
-        
-        uint32_t m_term = riscv_circuit_allocate_wire(circuit);
-        uint32_t shift_term = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, not_two, m_bit, m_term, GATE_AND);
-        riscv_circuit_add_gate(circuit, two, m_shift, shift_term, GATE_AND);
-        
-        riscv_circuit_add_gate(circuit, m_term, shift_term, selected, GATE_XOR);
-        
-        // Apply negation
-        uint32_t possibly_negated = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, selected, neg, possibly_negated, GATE_XOR);
-        
-        // Apply zero mask
-        uint32_t not_zero = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, zero, CONSTANT_1_WIRE, not_zero, GATE_XOR);
-        
-        pp_out[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, possibly_negated, not_zero, pp_out[i], GATE_AND);
+        // Select between M and 2M, apply negation, then the zero mask
+        uint32_t selected = gate_mux(circuit, two, m_shift, m_bit);
+        uint32_t possibly_negated = gate_xor(circuit, selected, neg);
+        pp_out[i] = gate_and(circuit, possibly_negated, not_zero);
     }
     
     // Handle two's complement correction for negative values
     // If neg and not zero, add 1 to LSB
-    uint32_t need_correction = riscv_circuit_allocate_wire(circuit);
-    uint32_t not_zero_for_corr = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, zero, CONSTANT_1_WIRE, not_zero_for_corr, GATE_XOR);
-    riscv_circuit_add_gate(circuit, neg, not_zero_for_corr, need_correction, GATE_AND);
-    
-    // Add correction to LSB
-    uint32_t new_lsb = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, pp_out[0], need_correction, new_lsb, GATE_XOR);
-    pp_out[0] = new_lsb;
+    uint32_t need_correction = gate_and(circuit, neg, not_zero);
+    pp_out[0] = gate_xor(circuit, pp_out[0], need_correction);
 }
 
 // Carry-save adder for accumulation
@@ -140,25 +90,8 @@ static void carry_save_add(riscv_circuit_t* circuit,
                           uint32_t* new_sum, uint32_t* new_carry, size_t bits) {
     for (size_t i = 0; i < bits; i++) {
         // Full adder logic but keep sum and carry separate
-        uint32_t a_xor_b = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, sum[i], addend[i], a_xor_b, GATE_XOR);
-        
-        new_sum[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, a_xor_b, carry[i], new_sum[i], GATE_XOR);
-        
-        // New carry = (a & b) | (c & (a ^ b))
-        uint32_t a_and_b = riscv_circuit_allocate_wire(circuit);
-        uint32_t c_and_xor = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, sum[i], addend[i], a_and_b, GATE_AND);
-        riscv_circuit_add_gate(circuit, carry[i], a_xor_b, c_and_xor, GATE_AND);
-        
-        uint32_t carry_xor = riscv_circuit_allocate_wire(circuit);
-        uint32_t carry_and = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, a_and_b, c_and_xor, carry_xor, GATE_XOR);
-        riscv_circuit_add_gate(circuit, a_and_b, c_and_xor, carry_and, GATE_AND);
-        
-        new_carry[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, carry_xor, carry_and, new_carry[i], GATE_XOR);
+        new_carry[i] = carry[i];
+        new_sum[i] = gate_full_add(circuit, sum[i], addend[i], &new_carry[i]);
     }
 }
 
@@ -0,0 +1,254 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "circuit_cuts.h"
+#include <stdlib.h>
+#include <string.h>
+
+const uint16_t cut_var_tt[CUT_MAX_LEAVES] = {0xAAAA, 0xCCCC, 0xF0F0, 0xFF00};
+
+static bool is_const(uint32_t w) {
+    return w == CONSTANT_0_WIRE || w == CONSTANT_1_WIRE;
+}
+
+static bool cut_has(const cut_t* cut, uint32_t w) {
+    for (size_t i = 0; i < cut->size; i++) if (cut->leaves[i] == w) return true;
+    return false;
+}
+
+// Union of two sorted leaf sets, false if it has too many leaves
+static bool merge_cuts(const cut_t* a, const cut_t* b, cut_t* out) {
+    size_t i = 0, j = 0;
+    out->size = 0;
+    while (i < a->size || j < b->size) {
+        uint32_t w;
+        if (j >= b->size || (i < a->size && a->leaves[i] < b->leaves[j])) w = a->leaves[i++];
+        else if (i >= a->size || b->leaves[j] < a->leaves[i]) w = b->leaves[j++];
+        else { w = a->leaves[i++]; j++; }
+        if (out->size == CUT_MAX_LEAVES) return false;
+        out->leaves[out->size++] = w;
+    }
+    return true;
+}
+
+static uint32_t cut_top(const cut_t* cut) {
+    return cut->leaves[cut->size - 1];
+}
+
+static bool cut_subset(const cut_t* small, const cut_t* big) {
+    for (size_t i = 0; i < small->size; i++) if (!cut_has(big, small->leaves[i])) return false;
+    return true;
+}
+
+// Cuts of a wire: its stored cuts plus the trivial one, or the empty cut
+// for a constant
+static size_t wire_cuts(const cut_network_t* net, uint32_t w, cut_t* out) {
+    if (is_const(w)) {
+        out[0].size = 0;
+        return 1;
+    }
+    size_t n = 0;
+    out[n].size = 1;
+    out[n++].leaves[0] = w;
+    if (net->driver[w] >= 0) {
+        size_t count;
+        const cut_t* cuts = cut_network_cuts(net, (size_t)net->driver[w], &count);
+        for (size_t i = 0; i < count; i++) out[n++] = cuts[i];
+    }
+    return n;
+}
+
+static void enumerate_cuts(cut_network_t* net, size_t g) {
+    const gate_t* gate = &net->circuit->gates[g];
+    cut_t left[CUT_MAX_PER_GATE + 1], right[CUT_MAX_PER_GATE + 1];
+    size_t nl = wire_cuts(net, gate->left_input, left);
+    size_t nr = wire_cuts(net, gate->right_input, right);
+    cut_t* mine = &net->cuts[g * CUT_MAX_PER_GATE];
+    size_t count = 0;
+
+    for (size_t i = 0; i < nl; i++) {
+        for (size_t j = 0; j < nr; j++) {
+            cut_t cut;
+            if (!merge_cuts(&left[i], &right[j], &cut) || cut.size == 0) continue;
+
+            // Skip dominated cuts, drop the ones this cut dominates
+            bool dominated = false;
+            for (size_t k = 0; k < count && !dominated; k++) dominated = cut_subset(&mine[k], &cut);
+            if (dominated) continue;
+            size_t kept = 0;
+            for (size_t k = 0; k < count; k++) {
+                if (!cut_subset(&cut, &mine[k])) mine[kept++] = mine[k];
+            }
+            count = kept;
+
+            // When full keep the deepest cuts (lowest top leaf, as wire IDs
+            // follow gate order): their cones hold the most gates
+            if (count < CUT_MAX_PER_GATE) {
+                mine[count++] = cut;
+            } else {
+                size_t shallowest = 0;
+                for (size_t k = 1; k < count; k++) {
+                    if (cut_top(&mine[k]) > cut_top(&mine[shallowest])) shallowest = k;
+                }
+                if (cut_top(&mine[shallowest]) > cut_top(&cut)) mine[shallowest] = cut;
+            }
+        }
+    }
+    net->num_cuts[g] = (uint8_t)count;
+}
+
+int cut_network_build(cut_network_t* net, const pass_context_t* ctx) {
+    const riscv_circuit_t* circuit = ctx->circuit;
+    memset(net, 0, sizeof(*net));
+    net->circuit = circuit;
+    net->num_gates = circuit->num_gates;
+    net->num_wires = circuit->next_wire_id > circuit->num_inputs ?
+                     circuit->next_wire_id : circuit->num_inputs;
+
+    size_t num_gates = net->num_gates, num_wires = net->num_wires;
+    net->driver = malloc(num_wires * sizeof(int64_t));
+    net->refs = calloc(num_wires, sizeof(uint32_t));
+    net->level = calloc(num_wires, sizeof(uint32_t));
+    net->cuts = malloc((num_gates + 1) * CUT_MAX_PER_GATE * sizeof(cut_t));
+    net->num_cuts = calloc(num_gates + 1, 1);
+    net->claimed = calloc(num_wires, 1);
+    net->mffc = malloc((num_gates + 1) * sizeof(uint32_t));
+    net->stamp = calloc(num_wires, sizeof(uint32_t));
+    net->tt = malloc(num_wires * sizeof(uint16_t));
+    if (!net->driver || !net->refs || !net->level || !net->cuts || !net->num_cuts ||
+        !net->claimed || !net->mffc || !net->stamp || !net->tt) {
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        cut_network_free(net);
+        return -1;
+    }
+
+    for (size_t w = 0; w < num_wires; w++) net->driver[w] = -1;
+    for (size_t g = 0; g < num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        uint32_t l = net->level[gate->left_input], r = net->level[gate->right_input];
+        net->driver[gate->output] = (int64_t)g;
+        net->level[gate->output] = (l > r ? l : r) + 1;
+        net->refs[gate->left_input]++;
+        net->refs[gate->right_input]++;
+        enumerate_cuts(net, g);
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) net->refs[*ctx->roots[i]]++;
+    return 0;
+}
+
+void cut_network_free(cut_network_t* net) {
+    free(net->driver);
+    free(net->refs);
+    free(net->level);
+    free(net->cuts);
+    free(net->num_cuts);
+    free(net->claimed);
+    free(net->mffc);
+    free(net->stamp);
+    free(net->tt);
+    memset(net, 0, sizeof(*net));
+}
+
+static uint16_t cone_tt(cut_network_t* net, uint32_t w, const cut_t* cut) {
+    if (w == CONSTANT_0_WIRE) return 0;
+    if (w == CONSTANT_1_WIRE) return 0xFFFF;
+    for (size_t i = 0; i < cut->size; i++) if (cut->leaves[i] == w) return cut_var_tt[i];
+    if (net->stamp[w] == net->epoch) return net->tt[w];
+
+    const gate_t* g = &net->circuit->gates[net->driver[w]];
+    uint16_t l = cone_tt(net, g->left_input, cut);
+    uint16_t r = cone_tt(net, g->right_input, cut);
+    net->stamp[w] = net->epoch;
+    net->tt[w] = g->type == GATE_AND ? (l & r) : (l ^ r);
+    return net->tt[w];
+}
+
+uint16_t cut_truth_table(cut_network_t* net, uint32_t wire, const cut_t* cut) {
+    net->epoch++;
+    return cone_tt(net, wire, cut);
+}
+
+// Dereferences the cone; refs are restored by the caller
+static void mffc_deref(cut_network_t* net, uint32_t w, const cut_t* cut,
+                       size_t* ands, size_t* gates) {
+    const gate_t* g = &net->circuit->gates[net->driver[w]];
+    net->mffc[net->mffc_size++] = w;
+    (*gates)++;
+    if (g->type == GATE_AND) (*ands)++;
+    uint32_t in[2] = {g->left_input, g->right_input};
+    for (int k = 0; k < 2; k++) {
+        uint32_t f = in[k];
+        if (--net->refs[f] == 0 && !is_const(f) && net->driver[f] >= 0 && !cut_has(cut, f)) {
+            mffc_deref(net, f, cut, ands, gates);
+        }
+    }
+}
+
+void cut_mffc(cut_network_t* net, uint32_t wire, const cut_t* cut,
+              size_t* ands, size_t* gates) {
+    *ands = *gates = 0;
+    net->mffc_size = 0;
+    mffc_deref(net, wire, cut, ands, gates);
+    for (size_t i = 0; i < net->mffc_size; i++) {
+        const gate_t* g = &net->circuit->gates[net->driver[net->mffc[i]]];
+        net->refs[g->left_input]++;
+        net->refs[g->right_input]++;
+    }
+}
+
+bool cut_is_free(const cut_network_t* net, const cut_t* cut) {
+    for (size_t i = 0; i < cut->size; i++) if (net->claimed[cut->leaves[i]]) return false;
+    for (size_t i = 0; i < net->mffc_size; i++) if (net->claimed[net->mffc[i]]) return false;
+    return true;
+}
+
+void cut_claim(cut_network_t* net, const cut_t* cut) {
+    for (size_t i = 0; i < net->mffc_size; i++) net->claimed[net->mffc[i]] = 1;
+    for (size_t i = 0; i < cut->size; i++) net->claimed[cut->leaves[i]] = 1;
+}
+
+int cut_network_rewrite(cut_network_t* net, pass_context_t* ctx, const uint8_t* replace,
+                        const cut_t* cuts, cut_emit_fn_t emit, void* user) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    size_t num_gates = net->num_gates;
+
+    riscv_circuit_t rebuilt = *circuit;
+    rebuilt.capacity = 2 * num_gates + 16;
+    rebuilt.gates = malloc(rebuilt.capacity * sizeof(gate_t));
+    rebuilt.num_gates = 0;
+    rebuilt.next_wire_id = (uint32_t)net->num_wires;
+    uint32_t* map = malloc(net->num_wires * sizeof(uint32_t));
+    if (!rebuilt.gates || !map) {
+        free(rebuilt.gates);
+        free(map);
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        return -1;
+    }
+
+    for (size_t w = 0; w < net->num_wires; w++) map[w] = (uint32_t)w;
+    for (size_t g = 0; g < num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        if (replace[g]) {
+            uint32_t leaves[CUT_MAX_LEAVES] = {CONSTANT_0_WIRE, CONSTANT_0_WIRE,
+                                               CONSTANT_0_WIRE, CONSTANT_0_WIRE};
+            for (size_t i = 0; i < cuts[g].size; i++) leaves[i] = map[cuts[g].leaves[i]];
+            map[gate->output] = emit(&rebuilt, g, leaves, user);
+        } else {
+            riscv_circuit_add_gate(&rebuilt, map[gate->left_input], map[gate->right_input],
+                                   gate->output, gate->type);
+        }
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) *ctx->roots[i] = map[*ctx->roots[i]];
+
+    free(circuit->gates);
+    circuit->gates = rebuilt.gates;
+    circuit->num_gates = rebuilt.num_gates;
+    circuit->capacity = rebuilt.capacity;
+    circuit->next_wire_id = rebuilt.next_wire_id;
+    circuit->max_wire_id = rebuilt.next_wire_id;
+    free(map);
+
+    return circuit_pass_dce(ctx) < 0 ? -1 : 1;
+}
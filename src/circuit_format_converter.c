@@ -10,6 +10,14 @@
 // Convert RISC-V circuit to gate_computer format
 // Format: layers of gates that can be evaluated in parallel
 int riscv_circuit_to_gate_format(const riscv_circuit_t* circuit, const char* filename) {
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        if (circuit->gates[i].type != GATE_AND && circuit->gates[i].type != GATE_XOR) {
+            fprintf(stderr, "❌ ERROR: gate_computer format has no %s gates; lower the circuit first\n",
+                    gate_type_name(circuit->gates[i].type));
+            return -1;
+        }
+    }
+
     FILE* f = fopen(filename, "w");
     if (!f) return -1;
     
@@ -93,4 +101,32 @@ int riscv_circuit_to_gate_format(const riscv_circuit_t* circuit, const char* fil
     printf("  Outputs: %zu\n", num_outputs);
     
     return 0;
-}
\ No newline at end of file
+}
+// Same layering as above without writing anything: a gate sits one layer
+// above the later of its inputs, inputs are layer 0
+size_t riscv_circuit_depth(const riscv_circuit_t* circuit) {
+    size_t* wire_layers = calloc(circuit->next_wire_id, sizeof(size_t));
+    if (!wire_layers) return 0;
+    
+    size_t max_layer = 0;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        const gate_t* gate = &circuit->gates[i];
+        size_t left_layer = wire_layers[gate->left_input];
+        size_t right_layer = wire_layers[gate->right_input];
+        size_t gate_layer = (left_layer > right_layer ? left_layer : right_layer) + 1;
+        if (wire_layers[gate->select_input] >= gate_layer) gate_layer = wire_layers[gate->select_input] + 1;
+        wire_layers[gate->output] = gate_layer;
+        if (gate_layer > max_layer) max_layer = gate_layer;
+    }
+    
+    free(wire_layers);
+    return max_layer;
+}
+
+size_t riscv_circuit_count_and_gates(const riscv_circuit_t* circuit) {
+    size_t ands = 0;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        if (circuit->gates[i].type == GATE_AND) ands++;
+    }
+    return ands;
+}
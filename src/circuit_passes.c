@@ -0,0 +1,410 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "circuit_passes.h"
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Built-in circuit passes: folding, structural hashing, dead code
+ * elimination, wire renumbering and lowering of extended gates.
+ *
+ * Gates are in topological order but a wire may be driven more than once
+ * (the later driver wins, as in the evaluator). Every pass walks the gates
+ * forward with a map from old wire to its current replacement, so readers
+ * always see the latest driver. A rebuilt gate gets a fresh output wire
+ * whenever its old one was already driven or read, so the result has one
+ * driver per wire.
+ */
+
+// One past the highest wire any gate or root mentions
+static size_t wire_limit(const pass_context_t* ctx) {
+    const riscv_circuit_t* circuit = ctx->circuit;
+    size_t limit = circuit->next_wire_id > circuit->num_inputs ?
+                   circuit->next_wire_id : circuit->num_inputs;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        const gate_t* g = &circuit->gates[i];
+        if (g->left_input >= limit) limit = (size_t)g->left_input + 1;
+        if (g->right_input >= limit) limit = (size_t)g->right_input + 1;
+        if (g->select_input >= limit) limit = (size_t)g->select_input + 1;
+        if (g->output >= limit) limit = (size_t)g->output + 1;
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) {
+        if (*ctx->roots[i] >= limit) limit = (size_t)*ctx->roots[i] + 1;
+    }
+    return limit;
+}
+
+static void remap_roots(pass_context_t* ctx, const uint32_t* map) {
+    for (size_t i = 0; i < ctx->num_roots; i++) {
+        *ctx->roots[i] = map[*ctx->roots[i]];
+    }
+}
+
+// ============================================================================
+// Folding and structural hashing
+// ============================================================================
+
+typedef struct {
+    uint32_t left, right;
+    gate_type_t type;
+    bool valid;
+} wire_def_t;
+
+typedef struct {
+    uint32_t left, right, select, output;
+    gate_type_t type;
+    uint8_t table;
+    bool used;
+} strash_entry_t;
+
+static bool def_is(const wire_def_t* def, uint32_t wire, gate_type_t type) {
+    return def[wire].valid && def[wire].type == type;
+}
+
+// The other input of wire's gate if one input is x, else UINT32_MAX
+static uint32_t def_other(const wire_def_t* def, uint32_t wire, uint32_t x) {
+    if (def[wire].left == x) return def[wire].right;
+    if (def[wire].right == x) return def[wire].left;
+    return UINT32_MAX;
+}
+
+// Try to express type(l, r) with an existing wire
+static bool fold_gate(const wire_def_t* def, gate_type_t type, uint32_t l, uint32_t r,
+                      uint32_t* result) {
+    if (type == GATE_XOR) {
+        if (l == CONSTANT_0_WIRE) { *result = r; return true; }
+        if (r == CONSTANT_0_WIRE) { *result = l; return true; }
+        if (l == r) { *result = CONSTANT_0_WIRE; return true; }
+        // x ^ (x ^ y) = y, which also removes double negation
+        if (def_is(def, r, GATE_XOR) && def_other(def, r, l) != UINT32_MAX) {
+            *result = def_other(def, r, l);
+            return true;
+        }
+        if (def_is(def, l, GATE_XOR) && def_other(def, l, r) != UINT32_MAX) {
+            *result = def_other(def, l, r);
+            return true;
+        }
+        return false;
+    }
+
+    if (l == CONSTANT_0_WIRE || r == CONSTANT_0_WIRE) { *result = CONSTANT_0_WIRE; return true; }
+    if (l == CONSTANT_1_WIRE) { *result = r; return true; }
+    if (r == CONSTANT_1_WIRE) { *result = l; return true; }
+    if (l == r) { *result = l; return true; }
+    // x & (x & y) = x & y
+    if (def_is(def, r, GATE_AND) && def_other(def, r, l) != UINT32_MAX) { *result = r; return true; }
+    if (def_is(def, l, GATE_AND) && def_other(def, l, r) != UINT32_MAX) { *result = l; return true; }
+    // x & ~x = 0
+    if ((def_is(def, r, GATE_NOT) && def[r].left == l) || (def_is(def, l, GATE_NOT) && def[l].left == r)) {
+        *result = CONSTANT_0_WIRE;
+        return true;
+    }
+    if (def_is(def, r, GATE_XOR) && def_other(def, r, l) == CONSTANT_1_WIRE) {
+        *result = CONSTANT_0_WIRE;
+        return true;
+    }
+    if (def_is(def, l, GATE_XOR) && def_other(def, l, r) == CONSTANT_1_WIRE) {
+        *result = CONSTANT_0_WIRE;
+        return true;
+    }
+    return false;
+}
+
+// Extended gates fold on constant and repeated inputs only (and ~~x)
+static bool fold_extended(const wire_def_t* def, const gate_t* g, uint32_t l, uint32_t r,
+                          uint32_t s, uint32_t* result) {
+    switch (g->type) {
+        case GATE_OR:
+            if (l == CONSTANT_1_WIRE || r == CONSTANT_1_WIRE) { *result = CONSTANT_1_WIRE; return true; }
+            if (l == CONSTANT_0_WIRE || l == r) { *result = r; return true; }
+            if (r == CONSTANT_0_WIRE) { *result = l; return true; }
+            return false;
+        case GATE_NOT:
+            if (l <= CONSTANT_1_WIRE) { *result = l ^ 1; return true; }
+            if (def_is(def, l, GATE_NOT)) { *result = def[l].left; return true; }
+            return false;
+        case GATE_XNOR:
+            if (l == r) { *result = CONSTANT_1_WIRE; return true; }
+            if (l == CONSTANT_1_WIRE) { *result = r; return true; }
+            if (r == CONSTANT_1_WIRE) { *result = l; return true; }
+            return false;
+        case GATE_MUX:
+            if (l == r || s == CONSTANT_0_WIRE) { *result = l; return true; }
+            if (s == CONSTANT_1_WIRE) { *result = r; return true; }
+            return false;
+        case GATE_LUT:
+            if (g->table == 0x00 || g->table == 0xFF) {
+                *result = g->table ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+static bool is_commutative(gate_type_t type) {
+    return type == GATE_AND || type == GATE_XOR || type == GATE_OR || type == GATE_XNOR;
+}
+
+static size_t strash_slot(const strash_entry_t* table, size_t mask, const gate_t* g) {
+    uint64_t h = ((uint64_t)g->left_input * 0x9E3779B97F4A7C15ULL) ^
+                 ((uint64_t)g->right_input * 0xC2B2AE3D27D4EB4FULL) ^
+                 ((uint64_t)g->select_input * 0x165667B19E3779F9ULL) ^
+                 ((uint64_t)g->table << 8) ^ g->type;
+    size_t slot = (size_t)(h ^ (h >> 29)) & mask;
+    while (table[slot].used &&
+           !(table[slot].type == g->type && table[slot].left == g->left_input &&
+             table[slot].right == g->right_input && table[slot].select == g->select_input &&
+             table[slot].table == g->table)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static int rebuild(pass_context_t* ctx, bool fold, bool dedup) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    size_t num_gates = circuit->num_gates;
+    size_t limit = wire_limit(ctx);
+    size_t fresh_limit = limit + num_gates;
+
+    uint32_t* map = malloc(limit * sizeof(uint32_t));
+    uint8_t* touched = calloc(fresh_limit, 1);  // driven or read in the new circuit
+    wire_def_t* def = calloc(fresh_limit, sizeof(wire_def_t));
+    size_t table_size = 16;
+    while (table_size < 2 * num_gates) table_size <<= 1;
+    strash_entry_t* table = dedup ? calloc(table_size, sizeof(strash_entry_t)) : NULL;
+    if (!map || !touched || !def || (dedup && !table)) {
+        free(map); free(touched); free(def); free(table);
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        return -1;
+    }
+    for (size_t w = 0; w < limit; w++) map[w] = (uint32_t)w;
+
+    uint32_t next_wire = (uint32_t)limit;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < num_gates; i++) {
+        gate_t g = circuit->gates[i];
+        uint32_t l = map[g.left_input], r = map[g.right_input], s = map[g.select_input];
+        if (l > r && is_commutative(g.type)) { uint32_t t = l; l = r; r = t; }
+        touched[l] = touched[r] = touched[s] = 1;
+
+        uint32_t result;
+        if (fold && (g.type == GATE_AND || g.type == GATE_XOR ?
+                     fold_gate(def, g.type, l, r, &result) :
+                     fold_extended(def, &g, l, r, s, &result))) {
+            map[g.output] = result;
+            touched[result] = 1;
+            continue;
+        }
+
+        gate_t key = {l, r, g.output, s, g.type, g.table};
+        size_t slot = 0;
+        if (dedup) {
+            slot = strash_slot(table, table_size - 1, &key);
+            if (table[slot].used) {
+                map[g.output] = table[slot].output;
+                continue;
+            }
+        }
+
+        uint32_t out = touched[g.output] ? next_wire++ : g.output;
+        touched[out] = 1;
+        map[g.output] = out;
+        def[out] = (wire_def_t){l, r, g.type, true};
+        if (dedup) table[slot] = (strash_entry_t){l, r, s, out, g.type, g.table, true};
+        circuit->gates[kept++] = (gate_t){l, r, out, s, g.type, g.table};
+    }
+
+    remap_roots(ctx, map);
+    circuit->num_gates = kept;
+    if (next_wire > circuit->next_wire_id) circuit->next_wire_id = next_wire;
+    if (circuit->next_wire_id > circuit->max_wire_id) circuit->max_wire_id = circuit->next_wire_id;
+
+    free(map);
+    free(touched);
+    free(def);
+    free(table);
+    return kept != num_gates;
+}
+
+int circuit_pass_fold(pass_context_t* ctx) {
+    return rebuild(ctx, true, false);
+}
+
+int circuit_pass_dedup(pass_context_t* ctx) {
+    return rebuild(ctx, false, true);
+}
+
+// ============================================================================
+// Dead code elimination
+// ============================================================================
+
+// Backward liveness. A live gate kills its output before marking its
+// inputs, so earlier drivers of the same wire stay dead.
+int circuit_pass_dce(pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    size_t limit = wire_limit(ctx);
+    uint8_t* live = calloc(limit, 1);
+    uint8_t* keep = calloc(circuit->num_gates + 1, 1);
+    if (!live || !keep) {
+        free(live); free(keep);
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < ctx->num_roots; i++) live[*ctx->roots[i]] = 1;
+
+    for (size_t i = circuit->num_gates; i-- > 0;) {
+        const gate_t* g = &circuit->gates[i];
+        if (!live[g->output]) continue;
+        keep[i] = 1;
+        live[g->output] = 0;
+        live[g->left_input] = 1;
+        live[g->right_input] = 1;
+        live[g->select_input] = 1;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        if (keep[i]) circuit->gates[kept++] = circuit->gates[i];
+    }
+    int changed = kept != circuit->num_gates;
+    circuit->num_gates = kept;
+
+    free(live);
+    free(keep);
+    return changed;
+}
+
+// ============================================================================
+// Renumbering
+// ============================================================================
+
+// Undriven wires (inputs, free wires) keep their IDs; gate outputs are
+// numbered consecutively above the highest of them
+int circuit_pass_renumber(pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    size_t limit = wire_limit(ctx);
+    uint32_t* map = malloc(limit * sizeof(uint32_t));
+    uint8_t* driven = calloc(limit, 1);
+    if (!map || !driven) {
+        free(map); free(driven);
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        return -1;
+    }
+
+    // An undriven wire is one read (or used as a root) before any gate drives it
+    uint32_t base = (uint32_t)circuit->num_inputs;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        const gate_t* g = &circuit->gates[i];
+        if (!driven[g->left_input] && g->left_input >= base) base = g->left_input + 1;
+        if (!driven[g->right_input] && g->right_input >= base) base = g->right_input + 1;
+        if (!driven[g->select_input] && g->select_input >= base) base = g->select_input + 1;
+        driven[g->output] = 1;
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) {
+        uint32_t w = *ctx->roots[i];
+        if (!driven[w] && w >= base) base = w + 1;
+    }
+
+    for (size_t w = 0; w < limit; w++) map[w] = (uint32_t)w;
+    uint32_t next_wire = base;
+    int changed = 0;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        gate_t* g = &circuit->gates[i];
+        g->left_input = map[g->left_input];
+        g->right_input = map[g->right_input];
+        g->select_input = map[g->select_input];
+        uint32_t out = next_wire++;
+        if (out != g->output) changed = 1;
+        map[g->output] = out;
+        g->output = out;
+    }
+
+    remap_roots(ctx, map);
+    if (next_wire != circuit->next_wire_id) changed = 1;
+    circuit->next_wire_id = next_wire;
+    circuit->max_wire_id = next_wire;
+
+    free(map);
+    free(driven);
+    return changed;
+}
+
+// ============================================================================
+// Lowering
+// ============================================================================
+
+static uint32_t lower_gate(riscv_circuit_t* circuit, const gate_t* g) {
+    switch (g->type) {
+        case GATE_OR:   return gate_or(circuit, g->left_input, g->right_input);
+        case GATE_NOT:  return gate_not(circuit, g->left_input);
+        case GATE_XNOR: return gate_xnor(circuit, g->left_input, g->right_input);
+        case GATE_MUX:  return gate_mux(circuit, g->select_input, g->right_input, g->left_input);
+        case GATE_LUT:
+            return gate_lut3(circuit, g->table, g->left_input, g->right_input, g->select_input);
+        default:        return UINT32_MAX;
+    }
+}
+
+// Gates are rebuilt in order. An expansion's last gate takes over the
+// original output wire, so roots and readers keep their IDs.
+int riscv_circuit_lower(riscv_circuit_t* circuit, uint32_t gate_set) {
+    if (gate_set & ~GATE_SET_ALL) {
+        fprintf(stderr, "❌ ERROR: Unknown gate types in gate set 0x%X\n", gate_set);
+        return -1;
+    }
+    circuit->gate_set = gate_set;
+    size_t num_gates = circuit->num_gates, lowered = 0;
+    for (size_t i = 0; i < num_gates; i++) {
+        if (!riscv_circuit_allows(circuit, circuit->gates[i].type)) lowered++;
+    }
+    if (lowered == 0) return 0;
+
+    pass_context_t ctx = {circuit, NULL, 0};
+    size_t limit = wire_limit(&ctx);
+    gate_t* old = circuit->gates;
+    size_t capacity = circuit->capacity > num_gates + 3 * lowered ?
+                      circuit->capacity : num_gates + 3 * lowered;
+    circuit->gates = malloc(capacity * sizeof(gate_t));
+    if (!circuit->gates) {
+        circuit->gates = old;
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        return -1;
+    }
+    circuit->capacity = capacity;
+    circuit->num_gates = 0;
+    if (circuit->next_wire_id < limit) circuit->next_wire_id = (uint32_t)limit;
+
+    for (size_t i = 0; i < num_gates; i++) {
+        const gate_t* g = &old[i];
+        if (riscv_circuit_allows(circuit, g->type)) {
+            riscv_circuit_add_gate_full(circuit, g);
+            continue;
+        }
+        uint32_t first = circuit->next_wire_id;
+        size_t before = circuit->num_gates;
+        uint32_t w = lower_gate(circuit, g);
+        gate_t* last = &circuit->gates[circuit->num_gates - 1];
+        if (circuit->num_gates > before && last->output == w && w >= first) {
+            last->output = g->output;
+        } else {
+            // Folded to an existing wire: keep the output driven
+            riscv_circuit_add_gate(circuit, w, CONSTANT_0_WIRE, g->output, GATE_XOR);
+        }
+    }
+
+    free(old);
+    if (circuit->next_wire_id > circuit->max_wire_id) circuit->max_wire_id = circuit->next_wire_id;
+    return 1;
+}
+
+int circuit_pass_lower(pass_context_t* ctx) {
+    return riscv_circuit_lower(ctx->circuit, 0);
+}
@@ -0,0 +1,110 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/*
+ * Shared comparators for branches, SLT[I][U], min/max and the divider.
+ *
+ * Less-than never builds the difference, only the borrow chain, and
+ * equality is a balanced tree instead of a 32-deep chain. Constant inputs
+ * (immediates, x0) fold away as gates are emitted. Under OPTIMIZE_DEPTH
+ * less-than is a (lt, eq) prefix tree instead of the chain.
+ */
+
+// lt / eq of bits [lo, hi) as a balanced tree, the upper half deciding
+// unless it is equal:
+//   lt = lt_hi ^ (eq_hi & lt_lo),  eq = eq_hi & eq_lo
+// The two lt terms can never both be 1, hence the XOR. eq is only built
+// where a parent needs it.
+static uint32_t compare_lt_tree(riscv_circuit_t* circuit, const uint32_t* a,
+                                const uint32_t* b, size_t lo, size_t hi,
+                                size_t sign_bit, uint32_t* eq) {
+    if (hi - lo == 1) {
+        uint32_t diff = gate_xor(circuit, a[lo], b[lo]);
+        if (eq) *eq = gate_not(circuit, diff);
+        // Bits differ and b (a, at a flipped sign bit) is the 1
+        return gate_and(circuit, lo == sign_bit ? a[lo] : b[lo], diff);
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    uint32_t eq_hi, eq_lo;
+    uint32_t lt_hi = compare_lt_tree(circuit, a, b, mid, hi, sign_bit, &eq_hi);
+    uint32_t lt_lo = compare_lt_tree(circuit, a, b, lo, mid, sign_bit, eq ? &eq_lo : NULL);
+    if (eq) *eq = gate_and(circuit, eq_hi, eq_lo);
+    return gate_xor(circuit, lt_hi, gate_and(circuit, eq_hi, lt_lo));
+}
+
+// a < b from the borrow of a - b, LSB first:
+//   borrow' = b ^ ((a ^ borrow) & (b ^ borrow))    (1 AND + 3 XOR per bit)
+//
+// Signed order is unsigned order with both sign bits flipped. Flipping a
+// and b in the formula above only swaps which of them leads the final XOR,
+// so the signed comparator costs exactly the same.
+uint32_t build_compare_lt(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                          size_t bits, bool is_signed) {
+    if (bits == 0) return CONSTANT_0_WIRE;
+    if (circuit->objective == OPTIMIZE_DEPTH) {
+        return compare_lt_tree(circuit, a, b, 0, bits, is_signed ? bits - 1 : bits, NULL);
+    }
+
+    uint32_t borrow = CONSTANT_0_WIRE;
+    if (riscv_circuit_allows(circuit, GATE_LUT)) {
+        // borrow' = majority(~a, b, borrow), or majority(a, ~b, borrow) at a
+        // signed sign bit: one LUT per bit
+        for (size_t i = 0; i < bits; i++) {
+            uint8_t table = (is_signed && i == bits - 1) ? 0xB2 : 0xD4;
+            borrow = gate_lut3(circuit, table, a[i], b[i], borrow);
+        }
+        return borrow;
+    }
+    for (size_t i = 0; i < bits; i++) {
+        uint32_t t = gate_and(circuit, gate_xor(circuit, a[i], borrow),
+                              gate_xor(circuit, b[i], borrow));
+        uint32_t lead = (is_signed && i == bits - 1) ? a[i] : b[i];
+        borrow = gate_xor(circuit, lead, t);
+    }
+    return borrow;
+}
+
+// a == b: per-bit XNOR, then a balanced AND tree (log depth)
+uint32_t build_compare_eq(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                          size_t bits) {
+    if (bits == 0) return CONSTANT_1_WIRE;
+
+    uint32_t* same = malloc(bits * sizeof(uint32_t));
+    for (size_t i = 0; i < bits; i++) {
+        same[i] = gate_xnor(circuit, a[i], b[i]);
+    }
+    uint32_t result = gate_and_reduce(circuit, same, bits);
+    free(same);
+    return result;
+}
+
+// Branch conditions and SLT results in one place: funct3 follows the
+// branch encoding (0 BEQ, 1 BNE, 4 BLT, 5 BGE, 6 BLTU, 7 BGEU)
+uint32_t build_compare(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                       size_t bits, uint32_t funct3) {
+    uint32_t result;
+    switch (funct3 & 0x6) {
+        case 0x0:
+            result = build_compare_eq(circuit, a, b, bits);
+            break;
+        case 0x4:
+            result = build_compare_lt(circuit, a, b, bits, true);
+            break;
+        case 0x6:
+            result = build_compare_lt(circuit, a, b, bits, false);
+            break;
+        default:
+            fprintf(stderr, "❌ ERROR: Invalid comparison funct3 0x%x\n", funct3);
+            return CONSTANT_0_WIRE;
+    }
+    // Odd encodings are the negations (BNE, BGE, BGEU)
+    return (funct3 & 1) ? gate_not(circuit, result) : result;
+}
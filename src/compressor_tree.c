@@ -0,0 +1,255 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/*
+ * Carry-save compressor trees for multi-operand addition.
+ *
+ * Every operand bit is dropped into the column of its weight, the columns
+ * are reduced with Dadda's schedule (full adders and half adders, never
+ * more than needed to hit the next height target) until at most two bits
+ * remain per column, and a single carry-propagate adder finishes the job.
+ *
+ * Used by the multipliers (partial product reduction) and by instruction
+ * fusion (ADD+ADD chains), and available to any gadget that sums more than
+ * two words.
+ */
+
+// Build a 3:2 compressor (full adder)
+// sum = a ^ b ^ c, carry = MAJ(a, b, c) = ((a ^ c) & (b ^ c)) ^ c
+// 5 gates, only one of them an AND
+void build_compressor_3_2(riscv_circuit_t* circuit,
+                          uint32_t a, uint32_t b, uint32_t c,
+                          uint32_t* sum, uint32_t* carry) {
+    *carry = c;
+    *sum = gate_full_add(circuit, a, b, carry);
+}
+
+// Build a 4:2 compressor from two chained 3:2 compressors
+// a + b + c + d + cin = sum + 2 * (carry + cout)
+// cout only depends on a, b, c so it can feed the next column's cin
+void build_compressor_4_2(riscv_circuit_t* circuit,
+                          uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+                          uint32_t cin,
+                          uint32_t* sum, uint32_t* carry, uint32_t* cout) {
+    uint32_t partial;
+    build_compressor_3_2(circuit, a, b, c, &partial, cout);
+    build_compressor_3_2(circuit, partial, d, cin, sum, carry);
+}
+
+// Half adder: 2 gates
+static void build_half_adder(riscv_circuit_t* circuit, uint32_t a, uint32_t b,
+                             uint32_t* sum, uint32_t* carry) {
+    *sum = gate_xor(circuit, a, b);
+    *carry = gate_and(circuit, a, b);
+}
+
+// Column of equal-weight bits awaiting reduction
+typedef struct {
+    uint32_t* bits;
+    size_t count;
+    size_t capacity;
+} bit_column_t;
+
+static void column_push(bit_column_t* column, uint32_t wire) {
+    if (wire == CONSTANT_0_WIRE) return;  // Zero bits cost nothing
+
+    if (column->count >= column->capacity) {
+        column->capacity = column->capacity ? column->capacity * 2 : 8;
+        column->bits = realloc(column->bits, column->capacity * sizeof(uint32_t));
+    }
+    column->bits[column->count++] = wire;
+}
+
+// Constant-one bits are summed at compile time and reinserted as a single
+// binary constant, so k ones in a column never cost k-1 adders
+static void fold_constant_ones(bit_column_t* columns, size_t width) {
+    uint64_t constant = 0;
+
+    for (size_t col = 0; col < width && col < 64; col++) {
+        size_t kept = 0;
+        for (size_t i = 0; i < columns[col].count; i++) {
+            if (columns[col].bits[i] == CONSTANT_1_WIRE) {
+                constant += (uint64_t)1 << col;
+            } else {
+                columns[col].bits[kept++] = columns[col].bits[i];
+            }
+        }
+        columns[col].count = kept;
+    }
+
+    for (size_t col = 0; col < width && col < 64; col++) {
+        if ((constant >> col) & 1) {
+            column_push(&columns[col], CONSTANT_1_WIRE);
+        }
+    }
+}
+
+// Dadda reduction: shrink every column to at most two bits
+static void dadda_reduce(riscv_circuit_t* circuit, bit_column_t* columns, size_t width) {
+    size_t max_height = 0;
+    for (size_t col = 0; col < width; col++) {
+        if (columns[col].count > max_height) max_height = columns[col].count;
+    }
+
+    // Height targets d_1 = 2, d_{j+1} = floor(1.5 * d_j)
+    size_t targets[64];
+    size_t num_targets = 0;
+    for (size_t d = 2; d < max_height && num_targets < 64; d = d * 3 / 2) {
+        targets[num_targets++] = d;
+    }
+
+    bit_column_t* next = calloc(width, sizeof(bit_column_t));
+
+    while (num_targets > 0) {
+        size_t target = targets[--num_targets];
+
+        for (size_t col = 0; col < width; col++) {
+            bit_column_t* curr = &columns[col];
+            size_t taken = 0;
+
+            // Height seen by this column: its own bits plus carries already
+            // produced into it during this stage
+            while (curr->count - taken + next[col].count > target) {
+                size_t excess = curr->count - taken + next[col].count - target;
+                uint32_t sum, carry;
+
+                if (excess >= 2 && curr->count - taken >= 3) {
+                    build_compressor_3_2(circuit, curr->bits[taken], curr->bits[taken + 1],
+                                         curr->bits[taken + 2], &sum, &carry);
+                    taken += 3;
+                } else if (curr->count - taken >= 2) {
+                    build_half_adder(circuit, curr->bits[taken], curr->bits[taken + 1],
+                                     &sum, &carry);
+                    taken += 2;
+                } else {
+                    break;
+                }
+
+                column_push(&next[col], sum);
+                if (col + 1 < width) {
+                    column_push(&next[col + 1], carry);  // Carries out of the top are mod 2^width
+                }
+            }
+
+            // Untouched bits pass straight through
+            for (size_t i = taken; i < curr->count; i++) {
+                column_push(&next[col], curr->bits[i]);
+            }
+        }
+
+        // Swap stages
+        for (size_t col = 0; col < width; col++) {
+            bit_column_t tmp = columns[col];
+            columns[col] = next[col];
+            next[col] = tmp;
+            next[col].count = 0;
+        }
+    }
+
+    for (size_t col = 0; col < width; col++) {
+        free(next[col].bits);
+    }
+    free(next);
+}
+
+// Final ripple adder over ragged columns: columns holding a single bit and
+// no carry pass through for free, two bits use a half adder
+static void ripple_columns(riscv_circuit_t* circuit, bit_column_t* columns,
+                           size_t width, uint32_t* sum_bits) {
+    uint32_t carry = CONSTANT_0_WIRE;
+
+    for (size_t col = 0; col < width; col++) {
+        uint32_t in[3];
+        size_t n = 0;
+        for (size_t i = 0; i < columns[col].count; i++) in[n++] = columns[col].bits[i];
+        if (carry != CONSTANT_0_WIRE) in[n++] = carry;
+
+        uint32_t next_carry = CONSTANT_0_WIRE;
+        bool last = (col + 1 == width);
+
+        if (n == 0) {
+            sum_bits[col] = CONSTANT_0_WIRE;
+        } else if (n == 1) {
+            sum_bits[col] = in[0];
+        } else if (n == 2) {
+            if (last) {
+                sum_bits[col] = gate_xor(circuit, in[0], in[1]);
+            } else {
+                build_half_adder(circuit, in[0], in[1], &sum_bits[col], &next_carry);
+            }
+        } else {
+            if (last) {
+                sum_bits[col] = gate_xor(circuit, gate_xor(circuit, in[0], in[1]), in[2]);
+            } else {
+                build_compressor_3_2(circuit, in[0], in[1], in[2], &sum_bits[col], &next_carry);
+            }
+        }
+
+        carry = next_carry;
+    }
+}
+
+// Sum any number of width-bit operands modulo 2^width
+void build_multi_operand_adder(riscv_circuit_t* circuit,
+                               uint32_t** operands, size_t num_operands,
+                               size_t width, uint32_t* sum_bits,
+                               final_adder_t final_adder) {
+    bit_column_t* columns = calloc(width, sizeof(bit_column_t));
+
+    for (size_t op = 0; op < num_operands; op++) {
+        for (size_t col = 0; col < width; col++) {
+            column_push(&columns[col], operands[op][col]);
+        }
+    }
+
+    fold_constant_ones(columns, width);
+    dadda_reduce(circuit, columns, width);
+
+    if (final_adder == FINAL_ADDER_RIPPLE) {
+        ripple_columns(circuit, columns, width, sum_bits);
+    } else {
+        // Low columns holding at most one bit need no adder at all
+        size_t start = 0;
+        while (start < width && columns[start].count < 2) {
+            sum_bits[start] = columns[start].count ? columns[start].bits[0] : CONSTANT_0_WIRE;
+            start++;
+        }
+
+        if (start < width) {
+            size_t n = width - start;
+            uint32_t* row_a = malloc(n * sizeof(uint32_t));
+            uint32_t* row_b = malloc(n * sizeof(uint32_t));
+            for (size_t i = 0; i < n; i++) {
+                bit_column_t* column = &columns[start + i];
+                row_a[i] = column->count > 0 ? column->bits[0] : CONSTANT_0_WIRE;
+                row_b[i] = column->count > 1 ? column->bits[1] : CONSTANT_0_WIRE;
+            }
+
+            if (final_adder == FINAL_ADDER_KOGGE_STONE) {
+                build_kogge_stone_adder(circuit, row_a, row_b, sum_bits + start, n);
+            } else {
+                build_sparse_kogge_stone_adder(circuit, row_a, row_b, sum_bits + start, n);
+            }
+
+            free(row_a);
+            free(row_b);
+        }
+    }
+
+    for (size_t col = 0; col < width; col++) {
+        free(columns[col].bits);
+    }
+    free(columns);
+}
+
+final_adder_t final_adder_for_objective(const riscv_circuit_t* circuit) {
+    return circuit->objective == OPTIMIZE_DEPTH ? FINAL_ADDER_KOGGE_STONE : FINAL_ADDER_RIPPLE;
+}
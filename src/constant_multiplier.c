@@ -0,0 +1,108 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/*
+ * Multiplication by a compile-time constant.
+ *
+ * The constant is recoded in canonical signed digit form (digits -1/0/+1,
+ * never two non-zero digits in a row), so at most ceil(bits/2) shifted
+ * copies of x are needed and typically far fewer. Shifts are free
+ * rewiring; negative digits use ~x plus a constant, and every constant is
+ * folded into one row. The rows are summed by the compressor tree.
+ */
+
+// Recode constant (mod 2^bits) into CSD digits; returns the non-zero count
+int csd_recode(uint64_t constant, size_t bits, int8_t* digits) {
+    int nonzero = 0;
+    if (bits < 64) constant &= (1ULL << bits) - 1;
+
+    for (size_t k = 0; k < bits; k++) {
+        if (constant & 1) {
+            // ...01 -> +1, ...11 -> -1 (turns a run of ones into +2^n - 1)
+            digits[k] = (constant & 2) ? -1 : 1;
+            constant = digits[k] > 0 ? constant - 1 : constant + 1;
+            nonzero++;
+        } else {
+            digits[k] = 0;
+        }
+        constant >>= 1;
+    }
+    return nonzero;
+}
+
+// product = x * constant mod 2^width (x already extended to width bits)
+void build_constant_multiplier(riscv_circuit_t* circuit, const uint32_t* x_bits,
+                               size_t width, uint64_t constant, uint32_t* product) {
+    int8_t* digits = malloc(width * sizeof(int8_t));
+    int nonzero = csd_recode(constant, width, digits);
+
+    uint32_t** rows = malloc((nonzero + 1) * sizeof(uint32_t*));
+    uint32_t* inverted = NULL;
+    uint64_t offset = 0;
+    size_t num_rows = 0;
+
+    for (size_t k = 0; k < width; k++) {
+        if (digits[k] == 0) continue;
+
+        // -(x << k) = (~x << k) + 2^k
+        if (digits[k] < 0 && !inverted) {
+            inverted = malloc(width * sizeof(uint32_t));
+            for (size_t i = 0; i < width; i++) {
+                inverted[i] = gate_not(circuit, x_bits[i]);
+            }
+        }
+        const uint32_t* source = digits[k] > 0 ? x_bits : inverted;
+        if (digits[k] < 0) offset += 1ULL << k;
+
+        uint32_t* row = malloc(width * sizeof(uint32_t));
+        for (size_t i = 0; i < width; i++) {
+            row[i] = i < k ? CONSTANT_0_WIRE : source[i - k];
+        }
+        rows[num_rows++] = row;
+    }
+
+    if (width < 64) offset &= (1ULL << width) - 1;
+    if (offset) {
+        uint32_t* row = malloc(width * sizeof(uint32_t));
+        for (size_t i = 0; i < width; i++) {
+            row[i] = (i < 64 && ((offset >> i) & 1)) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+        }
+        rows[num_rows++] = row;
+    }
+
+    if (num_rows == 0) {
+        for (size_t i = 0; i < width; i++) product[i] = CONSTANT_0_WIRE;
+    } else if (num_rows == 1) {
+        memcpy(product, rows[0], width * sizeof(uint32_t));  // Pure shift
+    } else {
+        build_multi_operand_adder(circuit, rows, num_rows, width, product,
+                                  final_adder_for_objective(circuit));
+    }
+
+    for (size_t r = 0; r < num_rows; r++) free(rows[r]);
+    free(rows);
+    free(inverted);
+    free(digits);
+}
+
+// If every wire is CONSTANT_0_WIRE / CONSTANT_1_WIRE, report the value
+bool wires_to_constant(const uint32_t* wires, size_t bits, uint64_t* value) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bits; i++) {
+        if (wires[i] == CONSTANT_1_WIRE) {
+            if (i < 64) v |= 1ULL << i;
+        } else if (wires[i] != CONSTANT_0_WIRE) {
+            return false;
+        }
+    }
+    *value = v;
+    return true;
+}
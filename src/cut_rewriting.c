@@ -0,0 +1,195 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "circuit_cuts.h"
+#include "gate_primitives.h"
+#include "npn4_library.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Cut rewriting with the NPN library.
+ *
+ * Every 4-feasible cut of a gate is matched against the precomputed
+ * implementation of its NPN class (plus the inverters the match needs).
+ * When that is smaller than the gates that die with the cut (its
+ * fanout-free cone, so shared logic is never duplicated), the cone is
+ * replaced. Outputs are visited first, so the largest cones win, and
+ * accepted rewrites never overlap within one run; the pass manager's
+ * fixpoint picks up the rest.
+ *
+ * The objective decides what else a rewrite must respect: no extra ANDs
+ * under OPTIMIZE_AND_COUNT, no deeper output under OPTIMIZE_DEPTH.
+ */
+
+static const uint8_t perms[24][4] = {
+    {0,1,2,3},{0,1,3,2},{0,2,1,3},{0,2,3,1},{0,3,1,2},{0,3,2,1},
+    {1,0,2,3},{1,0,3,2},{1,2,0,3},{1,2,3,0},{1,3,0,2},{1,3,2,0},
+    {2,0,1,3},{2,0,3,1},{2,1,0,3},{2,1,3,0},{2,3,0,1},{2,3,1,0},
+    {3,0,1,2},{3,0,2,1},{3,1,0,2},{3,1,2,0},{3,2,0,1},{3,2,1,0},
+};
+
+typedef struct {
+    uint8_t cls;
+    uint8_t perm;
+    uint8_t neg;        // bits 0-3 inputs, bit 4 output
+    uint8_t cost;       // inverters needed
+} npn_entry_t;
+
+static npn_entry_t npn_table[65536];
+static pthread_once_t npn_once = PTHREAD_ONCE_INIT;
+
+// g(x) = f(y) with y_i = x_perm[i] ^ neg_i
+static uint16_t npn_transform(uint16_t f, int p, int neg) {
+    uint16_t g = 0;
+    for (int m = 0; m < 16; m++) {
+        int y = 0;
+        for (int i = 0; i < 4; i++) y |= (((m >> perms[p][i]) ^ (neg >> i)) & 1) << i;
+        g |= (uint16_t)(((f >> y) & 1) << m);
+    }
+    return g;
+}
+
+static void build_npn_table(void) {
+    for (size_t tt = 0; tt < 65536; tt++) npn_table[tt].cost = 0xFF;
+    for (size_t c = 0; c < NPN4_NUM_CLASSES; c++) {
+        for (int p = 0; p < 24; p++) {
+            for (int neg = 0; neg < 32; neg++) {
+                uint16_t g = npn_transform(npn4_library[c].tt, p, neg & 15);
+                if (neg & 16) g = (uint16_t)~g;
+                uint8_t cost = (uint8_t)__builtin_popcount((unsigned)neg);
+                if (cost < npn_table[g].cost) {
+                    npn_table[g] = (npn_entry_t){(uint8_t)c, (uint8_t)p, (uint8_t)neg, cost};
+                }
+            }
+        }
+    }
+}
+
+void npn4_lookup(uint16_t tt, npn4_match_t* match) {
+    pthread_once(&npn_once, build_npn_table);
+    const npn_entry_t* e = &npn_table[tt];
+    match->impl = &npn4_library[e->cls];
+    memcpy(match->perm, perms[e->perm], 4);
+    match->in_neg = e->neg & 15;
+    match->out_neg = (e->neg >> 4) & 1;
+}
+
+// ============================================================================
+// The pass
+// ============================================================================
+
+static uint32_t emit_match(riscv_circuit_t* circuit, const npn4_match_t* m,
+                           const uint32_t* leaves) {
+    uint32_t sig[5 + NPN4_MAX_GATES];
+    for (int i = 0; i < 4; i++) {
+        sig[i] = leaves[m->perm[i]];
+        if (m->in_neg & (1 << i)) sig[i] = gate_not(circuit, sig[i]);
+    }
+    sig[NPN4_CONST_1] = CONSTANT_1_WIRE;
+    for (size_t k = 0; k < m->impl->num_gates; k++) {
+        const npn4_gate_t* g = &m->impl->gates[k];
+        sig[5 + k] = g->type == GATE_AND ? gate_and(circuit, sig[g->a], sig[g->b])
+                                         : gate_xor(circuit, sig[g->a], sig[g->b]);
+    }
+    uint32_t out = m->impl->out == NPN4_CONST_0 ? CONSTANT_0_WIRE : sig[m->impl->out];
+    return m->out_neg ? gate_not(circuit, out) : out;
+}
+
+static uint32_t emit_rewrite(riscv_circuit_t* circuit, size_t gate,
+                             const uint32_t* leaves, void* user) {
+    const npn4_match_t* matches = user;
+    return emit_match(circuit, &matches[gate], leaves);
+}
+
+// Gates, ANDs and output level of a match over leaves at the given levels
+static void match_cost(const npn4_match_t* m, const uint32_t* leaf_level,
+                       size_t* gates, size_t* ands, uint32_t* level) {
+    uint32_t lvl[5 + NPN4_MAX_GATES];
+    *gates = m->impl->num_gates + (size_t)__builtin_popcount(m->in_neg) + m->out_neg;
+    *ands = 0;
+    for (int i = 0; i < 4; i++) {
+        lvl[i] = leaf_level[m->perm[i]] + ((m->in_neg >> i) & 1);
+    }
+    lvl[NPN4_CONST_1] = 0;
+    for (size_t k = 0; k < m->impl->num_gates; k++) {
+        const npn4_gate_t* g = &m->impl->gates[k];
+        lvl[5 + k] = (lvl[g->a] > lvl[g->b] ? lvl[g->a] : lvl[g->b]) + 1;
+        if (g->type == GATE_AND) (*ands)++;
+    }
+    *level = (m->impl->out == NPN4_CONST_0 ? 0 : lvl[m->impl->out]) + m->out_neg;
+}
+
+int circuit_pass_rewrite(pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    optimization_objective_t objective = circuit->objective;
+    if (circuit->num_gates == 0 || riscv_circuit_is_extended(circuit)) return 0;
+
+    // One driver per wire from here on
+    int renumbered = circuit_pass_renumber(ctx);
+    if (renumbered < 0) return -1;
+
+    cut_network_t net;
+    if (cut_network_build(&net, ctx) != 0) return -1;
+    size_t num_gates = net.num_gates;
+    npn4_match_t* matches = calloc(num_gates, sizeof(npn4_match_t));
+    cut_t* chosen = calloc(num_gates, sizeof(cut_t));
+    uint8_t* replace = calloc(num_gates, 1);
+    if (!matches || !chosen || !replace) {
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        free(matches); free(chosen); free(replace);
+        cut_network_free(&net);
+        return -1;
+    }
+
+    size_t accepted = 0;
+    for (size_t g = num_gates; g-- > 0;) {
+        uint32_t out = circuit->gates[g].output;
+        if (net.claimed[out] || net.refs[out] == 0) continue;
+
+        size_t num_cuts, best_saving = 0;
+        const cut_t* cuts = cut_network_cuts(&net, g, &num_cuts);
+        for (size_t c = 0; c < num_cuts; c++) {
+            const cut_t* cut = &cuts[c];
+            npn4_match_t match;
+            npn4_lookup(cut_truth_table(&net, out, cut), &match);
+
+            uint32_t leaf_level[CUT_MAX_LEAVES] = {0, 0, 0, 0};
+            for (size_t i = 0; i < cut->size; i++) leaf_level[i] = net.level[cut->leaves[i]];
+            size_t new_gates, new_ands;
+            uint32_t new_level;
+            match_cost(&match, leaf_level, &new_gates, &new_ands, &new_level);
+
+            size_t ands, gates;
+            cut_mffc(&net, out, cut, &ands, &gates);
+            if (new_gates >= gates || !cut_is_free(&net, cut)) continue;
+            if (objective == OPTIMIZE_AND_COUNT && new_ands > ands) continue;
+            if (objective == OPTIMIZE_DEPTH && new_level > net.level[out]) continue;
+            if (gates - new_gates > best_saving) {
+                best_saving = gates - new_gates;
+                matches[g] = match;
+                chosen[g] = *cut;
+            }
+        }
+
+        if (best_saving > 0) {
+            size_t ands, gates;
+            cut_mffc(&net, out, &chosen[g], &ands, &gates);
+            cut_claim(&net, &chosen[g]);
+            replace[g] = 1;
+            accepted++;
+        }
+    }
+
+    int result = renumbered;
+    if (accepted > 0) result = cut_network_rewrite(&net, ctx, replace, chosen, emit_rewrite, matches);
+
+    free(matches);
+    free(chosen);
+    free(replace);
+    cut_network_free(&net);
+    return result;
+}
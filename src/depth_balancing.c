@@ -0,0 +1,194 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "circuit_passes.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Depth balancing of associative chains.
+ *
+ * Equality checks, parity and AND reductions are built as linear chains
+ * (((a & b) & c) & d) ... A chain is a tree of gates of one type whose
+ * inner gates feed nothing else; its function only depends on the multiset
+ * of leaves, so it can be rebuilt as any tree with the same leaf count and
+ * the same number of gates. Pairing the two shallowest leaves first
+ * (Huffman order on levels) gives the lowest output level for the leaves'
+ * actual arrival times. A chain is only rebuilt when that beats its
+ * current shape.
+ */
+
+typedef struct {
+    size_t level;
+    uint32_t wire;
+} leaf_t;
+
+static bool leaf_less(const leaf_t* a, const leaf_t* b) {
+    return a->level < b->level || (a->level == b->level && a->wire < b->wire);
+}
+
+static void heap_push(leaf_t* heap, size_t* n, leaf_t leaf) {
+    size_t i = (*n)++;
+    while (i > 0 && leaf_less(&leaf, &heap[(i - 1) / 2])) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = leaf;
+}
+
+static leaf_t heap_pop(leaf_t* heap, size_t* n) {
+    leaf_t top = heap[0];
+    leaf_t last = heap[--(*n)];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= *n) break;
+        if (child + 1 < *n && leaf_less(&heap[child + 1], &heap[child])) child++;
+        if (!leaf_less(&heap[child], &last)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*n > 0) heap[i] = last;
+    return top;
+}
+
+static int compare_size(const void* a, const void* b) {
+    size_t x = *(const size_t*)a, y = *(const size_t*)b;
+    return (x > y) - (x < y);
+}
+
+int circuit_pass_balance(pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    if (circuit->num_gates < 2 || riscv_circuit_is_extended(circuit)) return 0;
+
+    // One driver per wire from here on
+    int renumbered = circuit_pass_renumber(ctx);
+    if (renumbered < 0) return -1;
+
+    size_t num_gates = circuit->num_gates;
+    size_t num_wires = circuit->next_wire_id;
+    size_t new_wires = num_wires + num_gates;
+    int64_t* driver = malloc(num_wires * sizeof(int64_t));
+    uint32_t* refs = calloc(num_wires, sizeof(uint32_t));
+    int64_t* consumer = malloc(num_wires * sizeof(int64_t));
+    uint8_t* inner = calloc(num_gates, 1);
+    size_t* chain_level = calloc(num_wires, sizeof(size_t));   // current shape, by old wire
+    size_t* level = calloc(new_wires, sizeof(size_t));         // by new wire
+    uint32_t* stack = malloc(2 * (num_gates + 1) * sizeof(uint32_t));
+    size_t* members = malloc(num_gates * sizeof(size_t));
+    leaf_t* heap = malloc((num_gates + 1) * sizeof(leaf_t));
+    leaf_t* probe = malloc((num_gates + 1) * sizeof(leaf_t));
+    gate_t* gates = malloc(num_gates * sizeof(gate_t));
+    if (!driver || !refs || !consumer || !inner || !chain_level || !level ||
+        !stack || !members || !heap || !probe || !gates) {
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        free(driver); free(refs); free(consumer); free(inner); free(chain_level); free(level);
+        free(stack); free(members); free(heap); free(probe); free(gates);
+        return -1;
+    }
+
+    for (size_t w = 0; w < num_wires; w++) {
+        driver[w] = -1;
+        consumer[w] = -1;
+    }
+    for (size_t g = 0; g < num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        driver[gate->output] = (int64_t)g;
+        refs[gate->left_input]++;
+        refs[gate->right_input]++;
+        consumer[gate->left_input] = (int64_t)g;
+        consumer[gate->right_input] = (int64_t)g;
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) refs[*ctx->roots[i]]++;
+
+    // Inner gates: single use, by a gate of the same type
+    for (size_t g = 0; g < num_gates; g++) {
+        uint32_t out = circuit->gates[g].output;
+        inner[g] = refs[out] == 1 && consumer[out] >= 0 &&
+                   circuit->gates[consumer[out]].type == circuit->gates[g].type;
+    }
+
+    uint32_t next_wire = (uint32_t)num_wires;
+    size_t kept = 0, rebalanced = 0;
+    for (size_t g = 0; g < num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        uint32_t l = gate->left_input, r = gate->right_input;
+        bool inner_l = driver[l] >= 0 && inner[driver[l]];
+        bool inner_r = driver[r] >= 0 && inner[driver[r]];
+        size_t ll = inner_l ? chain_level[l] : level[l];
+        size_t lr = inner_r ? chain_level[r] : level[r];
+        chain_level[gate->output] = (ll > lr ? ll : lr) + 1;
+
+        // Inner gates are emitted with the gate at the top of their chain
+        if (inner[g]) continue;
+
+        if (!inner_l && !inner_r) {
+            gates[kept++] = *gate;
+            level[gate->output] = chain_level[gate->output];
+            continue;
+        }
+
+        // Collect the chain's leaves and inner gates
+        size_t num_leaves = 0, num_members = 0, sp = 0;
+        stack[sp++] = l;
+        stack[sp++] = r;
+        while (sp > 0) {
+            uint32_t w = stack[--sp];
+            if (driver[w] >= 0 && inner[driver[w]]) {
+                members[num_members++] = (size_t)driver[w];
+                stack[sp++] = circuit->gates[driver[w]].left_input;
+                stack[sp++] = circuit->gates[driver[w]].right_input;
+            } else {
+                heap_push(heap, &num_leaves, (leaf_t){level[w], w});
+            }
+        }
+
+        // Level of the Huffman tree over the leaves' arrival times
+        size_t best = 0;
+        {
+            size_t n = num_leaves;
+            memcpy(probe, heap, n * sizeof(leaf_t));
+            while (n > 1) {
+                leaf_t a = heap_pop(probe, &n);
+                leaf_t b = heap_pop(probe, &n);
+                heap_push(probe, &n, (leaf_t){(a.level > b.level ? a.level : b.level) + 1, 0});
+            }
+            best = probe[0].level;
+        }
+
+        if (best < chain_level[gate->output]) {
+            rebalanced++;
+            while (num_leaves > 1) {
+                leaf_t a = heap_pop(heap, &num_leaves);
+                leaf_t b = heap_pop(heap, &num_leaves);
+                uint32_t out = num_leaves == 0 ? gate->output : next_wire++;
+                size_t lvl = (a.level > b.level ? a.level : b.level) + 1;
+                gates[kept++] = (gate_t){a.wire, b.wire, out, CONSTANT_0_WIRE, gate->type, 0};
+                level[out] = lvl;
+                heap_push(heap, &num_leaves, (leaf_t){lvl, out});
+            }
+        } else {
+            // Keep the chain as it is, in its original order
+            qsort(members, num_members, sizeof(size_t), compare_size);
+            members[num_members++] = g;
+            for (size_t i = 0; i < num_members; i++) {
+                const gate_t* m = &circuit->gates[members[i]];
+                gates[kept++] = *m;
+                level[m->output] = chain_level[m->output];
+            }
+        }
+    }
+
+    if (rebalanced > 0) {
+        memcpy(circuit->gates, gates, kept * sizeof(gate_t));
+        circuit->num_gates = kept;
+        circuit->next_wire_id = next_wire;
+        circuit->max_wire_id = next_wire;
+    }
+
+    free(driver); free(refs); free(consumer); free(inner); free(chain_level); free(level);
+    free(stack); free(members); free(heap); free(probe); free(gates);
+    return rebalanced > 0 ? 1 : renumbered;
+}
@@ -0,0 +1,1931 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+// solver.h defines bool itself, so it must come before <stdbool.h>
+#include "minisat/solver.h"
+#include "formal_verification.h"
+#include "riscv_compiler.h"
+#include "sat_portfolio.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Formal verification of compiled instructions: SAT equivalence against a
+ * reference, bounds, properties and differential testing.
+ *
+ * Circuits and references are encoded into a structurally hashed AND/XOR
+ * graph whose nodes are MiniSAT variables with their Tseitin clauses.
+ * Variable 0 is the constant true; variables 1..1024 are the machine state
+ * (PC, then x1..x31). Every clause is a node definition or a proven fact,
+ * so a solver stays valid for any number of instructions.
+ */
+
+#define LIT_TRUE 0
+#define LIT_FALSE 1
+#define NODE_AND 0
+#define NODE_XOR 1
+#define STATE_WORDS 32                  // PC, then x1..x31
+#define DIFF_BATCH 64                   // states per simulation pass
+
+typedef struct {
+    lit bit[32];
+} lword_t;
+
+struct sat_solver {
+    sat_portfolio_t* sat;
+    int num_vars;
+    lword_t state[STATE_WORDS];
+    uint64_t* keys;                     // (type, a, b) of each node, 0 if empty
+    lit* nodes;
+    size_t table_size;
+    size_t table_used;
+    size_t solves;
+    double deadline_ms;                 // No solve starts after it; 0 for none
+};
+
+// Wall clock, so times stay meaningful when checkers run in parallel
+static double now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return 1000.0 * (double)ts.tv_sec + (double)ts.tv_nsec / 1e6;
+}
+
+static double elapsed_ms(double start) {
+    return now_ms() - start;
+}
+
+void verification_result_free(verification_result_t* result) {
+    if (!result) return;
+    free(result->counterexample);
+    result->counterexample = NULL;
+}
+
+bool verification_result_simulated(const verification_result_t* result) {
+    return !result->verified && !result->counterexample && result->method &&
+           strstr(result->method, "simulation") != NULL;
+}
+
+static char* format_message(const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return strdup(buffer);
+}
+
+// ============================================================================
+// Encoder
+// ============================================================================
+
+static lit new_var(sat_solver_t* enc) {
+    lit v = toLit(enc->num_vars++);
+    sat_portfolio_set_vars(enc->sat, enc->num_vars);
+    return v;
+}
+
+static void add_clause(sat_solver_t* enc, lit a, lit b, lit c, int n) {
+    lit clause[3] = {a, b, c};
+    sat_portfolio_add_clause(enc->sat, clause, (size_t)n);
+}
+
+static uint64_t node_key(int type, lit a, lit b) {
+    return ((uint64_t)(type + 1) << 62) | ((uint64_t)a << 31) | (uint64_t)b;
+}
+
+static size_t key_slot(uint64_t key, size_t mask) {
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (size_t)(key >> 17) & mask;
+}
+
+static bool grow_table(sat_solver_t* enc) {
+    size_t size = enc->table_size ? 2 * enc->table_size : 4096;
+    uint64_t* keys = calloc(size, sizeof(uint64_t));
+    lit* nodes = malloc(size * sizeof(lit));
+    if (!keys || !nodes) {
+        free(keys);
+        free(nodes);
+        return false;
+    }
+    for (size_t i = 0; i < enc->table_size; i++) {
+        if (!enc->keys[i]) continue;
+        size_t slot = key_slot(enc->keys[i], size - 1);
+        while (keys[slot]) slot = (slot + 1) & (size - 1);
+        keys[slot] = enc->keys[i];
+        nodes[slot] = enc->nodes[i];
+    }
+    free(enc->keys);
+    free(enc->nodes);
+    enc->keys = keys;
+    enc->nodes = nodes;
+    enc->table_size = size;
+    return true;
+}
+
+// Existing node for (type, a, b), or a new variable with its definition.
+// Without memory for a larger table the node is just not shared.
+static lit hashed_node(sat_solver_t* enc, int type, lit a, lit b) {
+    bool hashed = 2 * (enc->table_used + 1) <= enc->table_size || grow_table(enc);
+    uint64_t key = node_key(type, a, b);
+    size_t mask = enc->table_size - 1;
+    size_t slot = key_slot(key, mask);
+    if (hashed) {
+        while (enc->keys[slot] && enc->keys[slot] != key) slot = (slot + 1) & mask;
+        if (enc->keys[slot]) return enc->nodes[slot];
+    }
+
+    lit z = new_var(enc);
+    if (type == NODE_AND) {
+        add_clause(enc, lit_neg(z), a, 0, 2);
+        add_clause(enc, lit_neg(z), b, 0, 2);
+        add_clause(enc, z, lit_neg(a), lit_neg(b), 3);
+    } else {
+        add_clause(enc, lit_neg(z), a, b, 3);
+        add_clause(enc, lit_neg(z), lit_neg(a), lit_neg(b), 3);
+        add_clause(enc, z, lit_neg(a), b, 3);
+        add_clause(enc, z, a, lit_neg(b), 3);
+    }
+    if (hashed) {
+        enc->keys[slot] = key;
+        enc->nodes[slot] = z;
+        enc->table_used++;
+    }
+    return z;
+}
+
+static lit enc_and(sat_solver_t* enc, lit a, lit b) {
+    if (a == LIT_FALSE || b == LIT_FALSE || a == lit_neg(b)) return LIT_FALSE;
+    if (a == LIT_TRUE || a == b) return b;
+    if (b == LIT_TRUE) return a;
+    return a < b ? hashed_node(enc, NODE_AND, a, b) : hashed_node(enc, NODE_AND, b, a);
+}
+
+// XOR nodes only see positive inputs; complements move to the output
+static lit enc_xor(sat_solver_t* enc, lit a, lit b) {
+    int phase = lit_sign(a) ^ lit_sign(b);
+    a &= ~1;
+    b &= ~1;
+    lit out;
+    if (a == b) out = LIT_FALSE;
+    else if (a == LIT_TRUE) out = lit_neg(b);
+    else if (b == LIT_TRUE) out = lit_neg(a);
+    else out = a < b ? hashed_node(enc, NODE_XOR, a, b) : hashed_node(enc, NODE_XOR, b, a);
+    return phase ? lit_neg(out) : out;
+}
+
+static lit enc_or(sat_solver_t* enc, lit a, lit b) {
+    return lit_neg(enc_and(enc, lit_neg(a), lit_neg(b)));
+}
+
+static lit enc_mux(sat_solver_t* enc, lit s, lit t, lit f) {
+    if (t == f) return t;
+    return enc_or(enc, enc_and(enc, s, t), enc_and(enc, lit_neg(s), f));
+}
+
+// Truth table bit l | r << 1 | s << 2, by Shannon expansion
+static lit enc_lut(sat_solver_t* enc, uint8_t table, lit l, lit r, lit s) {
+    lit half[2];
+    for (int hi = 0; hi < 2; hi++) {
+        lit quarter[2];
+        for (int mid = 0; mid < 2; mid++) {
+            int t = (table >> (4 * hi + 2 * mid)) & 3;
+            quarter[mid] = t == 0 ? LIT_FALSE : t == 3 ? LIT_TRUE : t == 2 ? l : lit_neg(l);
+        }
+        half[hi] = enc_mux(enc, r, quarter[1], quarter[0]);
+    }
+    return enc_mux(enc, s, half[1], half[0]);
+}
+
+sat_solver_t* equiv_solver_create(void) {
+    return equiv_solver_create_portfolio(1);
+}
+
+sat_solver_t* equiv_solver_create_portfolio(size_t num_solvers) {
+    sat_solver_t* enc = calloc(1, sizeof(sat_solver_t));
+    if (!enc) return NULL;
+    enc->sat = sat_portfolio_create(num_solvers);
+    if (!enc->sat || !grow_table(enc)) {
+        equiv_solver_destroy(enc);
+        return NULL;
+    }
+    lit one = new_var(enc);
+    add_clause(enc, one, 0, 0, 1);
+    for (int w = 0; w < STATE_WORDS; w++) {
+        for (int i = 0; i < 32; i++) enc->state[w].bit[i] = new_var(enc);
+    }
+    return enc;
+}
+
+void equiv_solver_destroy(sat_solver_t* enc) {
+    if (!enc) return;
+    sat_portfolio_destroy(enc->sat);
+    free(enc->keys);
+    free(enc->nodes);
+    free(enc);
+}
+
+void equiv_solver_set_timeout(sat_solver_t* enc, double seconds) {
+    enc->deadline_ms = seconds > 0 ? now_ms() + 1000.0 * seconds : 0;
+}
+
+// ============================================================================
+// Encoding compiled circuits
+// ============================================================================
+
+static lit wire_literal(sat_solver_t* enc, lit* lits, uint32_t w) {
+    // Wires nothing drives (memory, for instance) are free
+    if (lits[w] < 0) lits[w] = new_var(enc);
+    return lits[w];
+}
+
+// Next state of a compiled instruction or program, slot 0 holding the PC
+static bool encode_compiled(sat_solver_t* enc, const riscv_compiler_t* compiler,
+                            lword_t next[STATE_WORDS]) {
+    const riscv_circuit_t* circuit = compiler->circuit;
+    size_t num_wires = circuit->next_wire_id > circuit->num_inputs ?
+                       circuit->next_wire_id : circuit->num_inputs;
+    lit* lits = malloc(num_wires * sizeof(lit));
+    if (!lits) {
+        fprintf(stderr, "❌ ERROR: Out of memory encoding a %zu-wire circuit\n", num_wires);
+        return false;
+    }
+    memset(lits, 0xFF, num_wires * sizeof(lit));
+    lits[CONSTANT_0_WIRE] = LIT_FALSE;
+    lits[CONSTANT_1_WIRE] = LIT_TRUE;
+    for (int i = 0; i < 32; i++) {
+        lits[get_pc_wire(i)] = enc->state[0].bit[i];
+        for (int r = 1; r < 32; r++) lits[get_register_wire(r, i)] = enc->state[r].bit[i];
+    }
+
+    for (size_t g = 0; g < circuit->num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        lit a = wire_literal(enc, lits, gate->left_input);
+        lit b = wire_literal(enc, lits, gate->right_input);
+        lit s = wire_literal(enc, lits, gate->select_input);
+        lit z = LIT_FALSE;
+        switch (gate->type) {
+            case GATE_AND:  z = enc_and(enc, a, b); break;
+            case GATE_XOR:  z = enc_xor(enc, a, b); break;
+            case GATE_OR:   z = enc_or(enc, a, b); break;
+            case GATE_NOT:  z = lit_neg(a); break;
+            case GATE_XNOR: z = lit_neg(enc_xor(enc, a, b)); break;
+            case GATE_MUX:  z = enc_mux(enc, s, b, a); break;
+            case GATE_LUT:  z = enc_lut(enc, gate->table, a, b, s); break;
+        }
+        lits[gate->output] = z;
+    }
+
+    for (int i = 0; i < 32; i++) {
+        next[0].bit[i] = wire_literal(enc, lits, compiler->pc_wires[i]);
+        for (int r = 1; r < 32; r++) {
+            next[r].bit[i] = wire_literal(enc, lits, compiler->reg_wires[r][i]);
+        }
+    }
+    free(lits);
+    return true;
+}
+
+// ============================================================================
+// Reference words
+// ============================================================================
+
+static lword_t w_const(uint32_t value) {
+    lword_t w;
+    for (int i = 0; i < 32; i++) w.bit[i] = (value >> i) & 1 ? LIT_TRUE : LIT_FALSE;
+    return w;
+}
+
+static lword_t w_reg(const sat_solver_t* enc, uint32_t r) {
+    return r == 0 ? w_const(0) : enc->state[r];
+}
+
+static lword_t w_fill(lit b) {
+    lword_t w;
+    for (int i = 0; i < 32; i++) w.bit[i] = b;
+    return w;
+}
+
+static lword_t w_not(lword_t a) {
+    for (int i = 0; i < 32; i++) a.bit[i] = lit_neg(a.bit[i]);
+    return a;
+}
+
+static lword_t w_and(sat_solver_t* enc, lword_t a, lword_t b) {
+    for (int i = 0; i < 32; i++) a.bit[i] = enc_and(enc, a.bit[i], b.bit[i]);
+    return a;
+}
+
+static lword_t w_or(sat_solver_t* enc, lword_t a, lword_t b) {
+    for (int i = 0; i < 32; i++) a.bit[i] = enc_or(enc, a.bit[i], b.bit[i]);
+    return a;
+}
+
+static lword_t w_xor(sat_solver_t* enc, lword_t a, lword_t b) {
+    for (int i = 0; i < 32; i++) a.bit[i] = enc_xor(enc, a.bit[i], b.bit[i]);
+    return a;
+}
+
+static lword_t w_mux(sat_solver_t* enc, lit s, lword_t t, lword_t f) {
+    for (int i = 0; i < 32; i++) t.bit[i] = enc_mux(enc, s, t.bit[i], f.bit[i]);
+    return t;
+}
+
+// Ripple-carry a + b + carry; *carry gets the carry out
+static lword_t w_add_carry(sat_solver_t* enc, lword_t a, lword_t b, lit* carry) {
+    lword_t sum;
+    lit c = *carry;
+    for (int i = 0; i < 32; i++) {
+        lit p = enc_xor(enc, a.bit[i], b.bit[i]);
+        sum.bit[i] = enc_xor(enc, p, c);
+        c = enc_or(enc, enc_and(enc, a.bit[i], b.bit[i]), enc_and(enc, p, c));
+    }
+    *carry = c;
+    return sum;
+}
+
+static lword_t w_add(sat_solver_t* enc, lword_t a, lword_t b) {
+    lit carry = LIT_FALSE;
+    return w_add_carry(enc, a, b, &carry);
+}
+
+static lword_t w_sub(sat_solver_t* enc, lword_t a, lword_t b) {
+    lit carry = LIT_TRUE;
+    return w_add_carry(enc, a, w_not(b), &carry);
+}
+
+static lword_t w_neg(sat_solver_t* enc, lword_t a) {
+    return w_sub(enc, w_const(0), a);
+}
+
+// a < b unsigned: a - b borrows
+static lit w_ult(sat_solver_t* enc, lword_t a, lword_t b) {
+    lit carry = LIT_TRUE;
+    w_add_carry(enc, a, w_not(b), &carry);
+    return lit_neg(carry);
+}
+
+static lit w_slt(sat_solver_t* enc, lword_t a, lword_t b) {
+    a.bit[31] = lit_neg(a.bit[31]);
+    b.bit[31] = lit_neg(b.bit[31]);
+    return w_ult(enc, a, b);
+}
+
+static lit w_eq(sat_solver_t* enc, lword_t a, lword_t b) {
+    lit eq = LIT_TRUE;
+    for (int i = 0; i < 32; i++) eq = enc_and(enc, eq, lit_neg(enc_xor(enc, a.bit[i], b.bit[i])));
+    return eq;
+}
+
+static lword_t w_bool(lit b) {
+    lword_t w = w_const(0);
+    w.bit[0] = b;
+    return w;
+}
+
+// Barrel shifter on the low five bits of amount: left, logical or
+// arithmetic right
+static lword_t w_shift(sat_solver_t* enc, lword_t a, lword_t amount, int kind) {
+    lit fill = kind == 2 ? a.bit[31] : LIT_FALSE;
+    for (int k = 0; k < 5; k++) {
+        int d = 1 << k;
+        lword_t shifted;
+        for (int i = 0; i < 32; i++) {
+            int from = kind == 0 ? i - d : i + d;
+            shifted.bit[i] = from >= 0 && from < 32 ? a.bit[from] : fill;
+        }
+        a = w_mux(enc, amount.bit[k], shifted, a);
+    }
+    return a;
+}
+
+// Unsigned 64-bit product, one shifted partial product per bit of b
+static void w_mul_wide(sat_solver_t* enc, lword_t a, lword_t b, lword_t* lo, lword_t* hi) {
+    lit acc[64];
+    for (int i = 0; i < 64; i++) acc[i] = LIT_FALSE;
+    for (int j = 0; j < 32; j++) {
+        lit carry = LIT_FALSE;
+        for (int i = 0; i < 32; i++) {
+            lit x = acc[i + j], y = enc_and(enc, a.bit[i], b.bit[j]);
+            lit p = enc_xor(enc, x, y);
+            acc[i + j] = enc_xor(enc, p, carry);
+            carry = enc_or(enc, enc_and(enc, x, y), enc_and(enc, p, carry));
+        }
+        acc[j + 32] = carry;
+    }
+    for (int i = 0; i < 32; i++) {
+        lo->bit[i] = acc[i];
+        hi->bit[i] = acc[i + 32];
+    }
+}
+
+// Restoring division; b = 0 gives q = 2^32 - 1 and r = a
+static void w_divu(sat_solver_t* enc, lword_t a, lword_t b, lword_t* q, lword_t* r) {
+    lword_t rem = w_const(0);
+    for (int i = 31; i >= 0; i--) {
+        // rem < b, so the shifted remainder fits in 33 bits
+        lit top = rem.bit[31];
+        for (int k = 31; k > 0; k--) rem.bit[k] = rem.bit[k - 1];
+        rem.bit[0] = a.bit[i];
+        lit carry = LIT_TRUE;
+        lword_t diff = w_add_carry(enc, rem, w_not(b), &carry);
+        lit fits = enc_or(enc, top, carry);
+        q->bit[i] = fits;
+        rem = w_mux(enc, fits, diff, rem);
+    }
+    *r = rem;
+}
+
+static lword_t w_abs(sat_solver_t* enc, lword_t a) {
+    return w_mux(enc, a.bit[31], w_neg(enc, a), a);
+}
+
+static uint32_t b_offset(uint32_t ins) {
+    uint32_t o = ((ins >> 31) & 1) << 12 | ((ins >> 7) & 1) << 11 |
+                 ((ins >> 25) & 0x3F) << 5 | ((ins >> 8) & 0xF) << 1;
+    return (uint32_t)((int32_t)(o << 19) >> 19);
+}
+
+static uint32_t j_offset(uint32_t ins) {
+    uint32_t o = ((ins >> 31) & 1) << 20 | ((ins >> 12) & 0xFF) << 12 |
+                 ((ins >> 20) & 1) << 11 | ((ins >> 21) & 0x3FF) << 1;
+    return (uint32_t)((int32_t)(o << 11) >> 11);
+}
+
+// RV32IM register instructions: OP, OP-IMM, LUI, AUIPC, JAL, JALR, BRANCH
+static bool reference_supported(uint32_t ins) {
+    uint32_t f3 = (ins >> 12) & 7, f7 = ins >> 25;
+    switch (ins & 0x7F) {
+        case 0x13: return !(f3 == 1 && f7 != 0) && !(f3 == 5 && (f7 & ~0x20u) != 0);
+        case 0x33: return f7 == 0 || f7 == 1 || (f7 == 0x20 && (f3 == 0 || f3 == 5));
+        case 0x37:
+        case 0x17:
+        case 0x6F: return true;
+        case 0x67: return f3 == 0;
+        case 0x63: return f3 != 2 && f3 != 3;
+        default:   return false;
+    }
+}
+
+// Reference next state, slot 0 holding the PC; false if the instruction has
+// no reference
+static bool encode_reference(sat_solver_t* enc, uint32_t ins, lword_t next[STATE_WORDS]) {
+    if (!reference_supported(ins)) return false;
+    uint32_t opcode = ins & 0x7F, rd = (ins >> 7) & 31, f3 = (ins >> 12) & 7;
+    uint32_t f7 = ins >> 25;
+    lword_t a = w_reg(enc, (ins >> 15) & 31), b = w_reg(enc, (ins >> 20) & 31);
+    lword_t pc = enc->state[0];
+    lword_t imm = w_const((uint32_t)((int32_t)ins >> 20));
+    lword_t result;
+
+    for (int w = 0; w < STATE_WORDS; w++) next[w] = enc->state[w];
+    switch (opcode) {
+        case 0x13:
+            b = imm;
+            // fall through
+        case 0x33:
+            if (opcode == 0x33 && f7 == 1) {
+                lword_t lo, hi, q, r;
+                switch (f3) {
+                    case 0:
+                    case 1:
+                    case 2:
+                    case 3:
+                        // The signed high words correct the unsigned product:
+                        // a * b - 2^32 (a<0 ? b : 0) - 2^32 (b<0 ? a : 0)
+                        w_mul_wide(enc, a, b, &lo, &hi);
+                        if (f3 == 1 || f3 == 2) {
+                            hi = w_sub(enc, hi, w_and(enc, b, w_fill(a.bit[31])));
+                        }
+                        if (f3 == 1) hi = w_sub(enc, hi, w_and(enc, a, w_fill(b.bit[31])));
+                        result = f3 == 0 ? lo : hi;
+                        break;
+                    case 5:
+                    case 7:
+                        w_divu(enc, a, b, &q, &r);
+                        result = f3 == 5 ? q : r;
+                        break;
+                    default: {
+                        // Signed: divide magnitudes, then fix the signs. The
+                        // quotient sign is wrong only for b = 0.
+                        w_divu(enc, w_abs(enc, a), w_abs(enc, b), &q, &r);
+                        if (f3 == 4) {
+                            lit negative = enc_xor(enc, a.bit[31], b.bit[31]);
+                            q = w_mux(enc, negative, w_neg(enc, q), q);
+                            result = w_mux(enc, w_eq(enc, b, w_const(0)), w_const(0xFFFFFFFF), q);
+                        } else {
+                            result = w_mux(enc, a.bit[31], w_neg(enc, r), r);
+                        }
+                        break;
+                    }
+                }
+                break;
+            }
+            switch (f3) {
+                case 0: result = opcode == 0x33 && f7 == 0x20 ? w_sub(enc, a, b) : w_add(enc, a, b); break;
+                case 1: result = w_shift(enc, a, b, 0); break;
+                case 2: result = w_bool(w_slt(enc, a, b)); break;
+                case 3: result = w_bool(w_ult(enc, a, b)); break;
+                case 4: result = w_xor(enc, a, b); break;
+                case 5: result = w_shift(enc, a, b, f7 == 0x20 ? 2 : 1); break;
+                case 6: result = w_or(enc, a, b); break;
+                default: result = w_and(enc, a, b); break;
+            }
+            break;
+        case 0x37:
+            result = w_const(ins & 0xFFFFF000u);
+            break;
+        case 0x17:
+            result = w_add(enc, pc, w_const(ins & 0xFFFFF000u));
+            break;
+        case 0x6F:
+            result = w_add(enc, pc, w_const(4));
+            next[0] = w_add(enc, pc, w_const(j_offset(ins)));
+            break;
+        case 0x67:
+            result = w_add(enc, pc, w_const(4));
+            next[0] = w_add(enc, a, imm);
+            next[0].bit[0] = LIT_FALSE;
+            break;
+        case 0x63: {
+            lit taken;
+            switch (f3) {
+                case 0: taken = w_eq(enc, a, b); break;
+                case 1: taken = lit_neg(w_eq(enc, a, b)); break;
+                case 4: taken = w_slt(enc, a, b); break;
+                case 5: taken = lit_neg(w_slt(enc, a, b)); break;
+                case 6: taken = w_ult(enc, a, b); break;
+                default: taken = lit_neg(w_ult(enc, a, b)); break;
+            }
+            next[0] = w_mux(enc, taken, w_add(enc, pc, w_const(b_offset(ins))),
+                            w_add(enc, pc, w_const(4)));
+            return true;
+        }
+        default:
+            return false;
+    }
+    if (rd != 0) next[rd] = result;
+    return true;
+}
+
+// ============================================================================
+// Miters and simulation
+// ============================================================================
+
+// Proves a[w] == b[w] for every word, one solve per bit under the assumption
+// that it differs (plus `assumptions`, at most EQUIV_CUBE_MAX_BITS). A
+// proven bit becomes a clause for later solves: a unit clause, or with
+// assumptions one saying they imply the bit. Returns 1 if every bit is equal,
+// 0 on a counterexample (left in the model), -1 if a solve ran out of
+// conflicts and -2 past the solver's deadline; *word and *bit give the
+// failing bit. With `undecided` (one
+// mask per word) a solve out of conflicts marks that bit and the higher
+// ones of its word, which are usually harder still, and the proof goes on
+// with the next word.
+static int prove_equal_words(sat_solver_t* enc, const lword_t* a, const lword_t* b, int words,
+                             const lit* assumptions, int num_assumptions, int conflict_limit,
+                             uint32_t* undecided, int* word, int* bit) {
+    lit assume[EQUIV_CUBE_MAX_BITS + 1];
+    int status = 1;
+    for (int w = 0; w < words; w++) {
+        if (undecided) undecided[w] = 0;
+        for (int i = 0; i < 32; i++) {
+            if (a[w].bit[i] == b[w].bit[i]) continue;
+            if (enc->deadline_ms > 0 && now_ms() > enc->deadline_ms) {
+                *word = w;
+                *bit = i;
+                return -2;
+            }
+            lit diff = enc_xor(enc, a[w].bit[i], b[w].bit[i]);
+            for (int k = 0; k < num_assumptions; k++) assume[k] = assumptions[k];
+            assume[num_assumptions] = diff;
+            enc->solves++;
+            lbool solved = (lbool)sat_portfolio_solve(enc->sat, assume, (size_t)num_assumptions + 1,
+                                                      conflict_limit);
+            if (solved == l_True || (solved == l_Undef && !undecided)) {
+                *word = w;
+                *bit = i;
+                return solved == l_True ? 0 : -1;
+            }
+            if (solved == l_Undef) {
+                if (status == 1) {
+                    *word = w;
+                    *bit = i;
+                }
+                status = -1;
+                undecided[w] = ~0u << i;
+                break;
+            }
+            if (num_assumptions == 0) {
+                add_clause(enc, lit_neg(diff), 0, 0, 1);
+            } else {
+                for (int k = 0; k < num_assumptions; k++) assume[k] = lit_neg(assumptions[k]);
+                assume[num_assumptions] = lit_neg(diff);
+                sat_portfolio_add_clause(enc->sat, assume, (size_t)num_assumptions + 1);
+            }
+        }
+    }
+    return status;
+}
+
+// Machine state of the solver's model
+static void model_state(const sat_solver_t* enc, riscv_verification_state_t* state) {
+    memset(state, 0, sizeof(*state));
+    for (int w = 0; w < STATE_WORDS; w++) {
+        uint32_t value = 0;
+        for (int i = 0; i < 32; i++) {
+            if (sat_portfolio_value(enc->sat, lit_var(enc->state[w].bit[i])) == l_True) {
+                value |= 1u << i;
+            }
+        }
+        if (w == 0) state->pc = value;
+        else state->regs[w] = value;
+    }
+}
+
+static size_t circuit_wires(const riscv_circuit_t* circuit) {
+    return circuit->next_wire_id > circuit->num_inputs ? circuit->next_wire_id
+                                                       : circuit->num_inputs;
+}
+
+// Runs up to 64 states through a compiled circuit, one per bit of the wire
+// values (a word per wire), and replaces them by the next states
+static void simulate(const riscv_compiler_t* compiler, uint64_t* values,
+                     riscv_verification_state_t* states, size_t count) {
+    const riscv_circuit_t* circuit = compiler->circuit;
+    memset(values, 0, circuit_wires(circuit) * sizeof(uint64_t));
+    values[CONSTANT_1_WIRE] = ~0ULL;
+    for (size_t k = 0; k < count; k++) {
+        for (int i = 0; i < 32; i++) {
+            values[get_pc_wire(i)] |= (uint64_t)((states[k].pc >> i) & 1) << k;
+            for (int r = 1; r < 32; r++) {
+                values[get_register_wire(r, i)] |= (uint64_t)((states[k].regs[r] >> i) & 1) << k;
+            }
+        }
+    }
+    for (size_t g = 0; g < circuit->num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        values[gate->output] = gate_eval_word(gate, values[gate->left_input],
+                                              values[gate->right_input],
+                                              values[gate->select_input]);
+    }
+    for (size_t k = 0; k < count; k++) {
+        uint32_t pc = 0, regs[32] = {0};
+        for (int i = 0; i < 32; i++) {
+            pc |= (uint32_t)((values[compiler->pc_wires[i]] >> k) & 1) << i;
+            for (int r = 1; r < 32; r++) {
+                regs[r] |= (uint32_t)((values[compiler->reg_wires[r][i]] >> k) & 1) << i;
+            }
+        }
+        states[k].pc = pc;
+        memcpy(states[k].regs, regs, sizeof(regs));
+    }
+}
+
+riscv_compiler_t* verification_compile(const riscv_compiler_t* config,
+                                       const uint32_t* program, size_t count) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    if (!compiler) return NULL;
+    if (config && config->circuit) {
+        riscv_compiler_set_objective(compiler, config->circuit->objective);
+        riscv_compiler_set_gate_set(compiler, config->circuit->gate_set);
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (riscv_compile_instruction(compiler, program[i]) != 0) {
+            riscv_compiler_destroy(compiler);
+            return NULL;
+        }
+    }
+    return compiler;
+}
+
+static uint32_t state_word(const riscv_verification_state_t* state, int word) {
+    return word == 0 ? state->pc : state->regs[word];
+}
+
+static void word_name(char name[16], int word) {
+    if (word == 0) snprintf(name, 16, "pc");
+    else snprintf(name, 16, "x%d", word);
+}
+
+// The registers an instruction reads, for counterexamples
+static int read_registers(uint32_t ins, int regs[2]) {
+    int count = 0;
+    switch (ins & 0x7F) {
+        case 0x33:
+        case 0x63:
+            regs[count++] = (ins >> 15) & 31;
+            regs[count++] = (ins >> 20) & 31;
+            break;
+        case 0x13:
+        case 0x67:
+            regs[count++] = (ins >> 15) & 31;
+            break;
+    }
+    return count;
+}
+
+static char* describe_mismatch(const riscv_compiler_t* compiler, uint32_t ins,
+                               const riscv_verification_state_t* input, int word,
+                               const riscv_verification_state_t* expected) {
+    riscv_verification_state_t actual = *input;
+    uint64_t* values = malloc(circuit_wires(compiler->circuit) * sizeof(uint64_t));
+    if (values) simulate(compiler, values, &actual, 1);
+    free(values);
+
+    char operands[64] = "", name[16];
+    int regs[2], count = read_registers(ins, regs);
+    for (int k = 0; k < count; k++) {
+        if (regs[k] == 0 || (k == 1 && regs[1] == regs[0])) continue;
+        size_t used = strlen(operands);
+        snprintf(operands + used, sizeof(operands) - used, " x%d=0x%08X", regs[k],
+                 input->regs[regs[k]]);
+    }
+    word_name(name, word);
+    return format_message("0x%08X at pc=0x%08X%s: %s is 0x%08X, expected 0x%08X", ins,
+                          input->pc, operands, name, state_word(&actual, word),
+                          state_word(expected, word));
+}
+
+// ============================================================================
+// Layer 2: SAT equivalence
+// ============================================================================
+
+equivalence_checker_t* equiv_checker_create(riscv_instruction_t instruction) {
+    return equiv_checker_create_with(NULL, NULL, instruction);
+}
+
+equivalence_checker_t* equiv_checker_create_with(sat_solver_t* solver,
+                                                 const riscv_compiler_t* config,
+                                                 riscv_instruction_t instruction) {
+    if (!reference_supported(instruction)) {
+        fprintf(stderr, "❌ ERROR: No reference for instruction 0x%08X\n", instruction);
+        return NULL;
+    }
+    equivalence_checker_t* checker = calloc(1, sizeof(equivalence_checker_t));
+    if (!checker) return NULL;
+    checker->instruction = instruction;
+    checker->input_bits = 32 * STATE_WORDS;
+    checker->output_bits = 32 * STATE_WORDS;
+    checker->conflict_limit = -1;
+    checker->compiler = verification_compile(config, &instruction, 1);
+    checker->solver = solver;
+    if (!solver) {
+        checker->solver = equiv_solver_create();
+        checker->owns_solver = true;
+    }
+    if (!checker->compiler || !checker->solver) {
+        fprintf(stderr, "❌ ERROR: Cannot set up the equivalence check of 0x%08X\n", instruction);
+        equiv_checker_destroy(checker);
+        return NULL;
+    }
+    checker->circuit = checker->compiler->circuit;
+    return checker;
+}
+
+void equiv_checker_destroy(equivalence_checker_t* checker) {
+    if (!checker) return;
+    riscv_compiler_destroy(checker->compiler);
+    if (checker->owns_solver) equiv_solver_destroy(checker->solver);
+    free(checker);
+}
+
+static void simulate_against(const differential_tester_t* tester,
+                             const riscv_compiler_t* compiler, riscv_instruction_t instruction,
+                             verification_result_t* result);
+
+// Number of output bits in a per-word mask
+static size_t state_bits(const uint32_t* mask) {
+    size_t bits = 0;
+    for (int w = 0; w < STATE_WORDS; w++) bits += (size_t)__builtin_popcount(mask[w]);
+    return bits;
+}
+
+// Falls back on simulation for the output bits the solver left undecided
+static void simulate_undecided(equivalence_checker_t* checker, verification_result_t* result) {
+    differential_tester_t tester = {
+        .impls.execute_ours = reference_execute,
+        .num_tests = checker->fallback_tests,
+        .test_edge_cases = true,
+        .test_random = true,
+        .seed = 0x2545F4914F6CDD1DULL,
+    };
+    result->method = "sat+simulation";
+    result->verified = true;
+    simulate_against(&tester, checker->compiler, checker->instruction, result);
+    result->verified = false;   // Not proven, whatever simulation found
+}
+
+verification_result_t equiv_checker_verify(equivalence_checker_t* checker) {
+    verification_result_t result = {false, "sat", 0, 0.0, NULL};
+    double start = now_ms();
+    sat_solver_t* enc = checker->solver;
+    lword_t circuit_next[STATE_WORDS], reference_next[STATE_WORDS];
+    if (!encode_compiled(enc, checker->compiler, circuit_next)) {
+        result.counterexample = format_message("out of memory");
+        return result;
+    }
+    encode_reference(enc, checker->instruction, reference_next);
+
+    size_t solves = enc->solves;
+    int word = 0, bit = 0;
+    uint32_t undecided[STATE_WORDS];
+    int status = prove_equal_words(enc, circuit_next, reference_next, STATE_WORDS, NULL, 0,
+                                   checker->conflict_limit, undecided, &word, &bit);
+    result.verified = status == 1;
+    result.test_cases_checked = enc->solves - solves;
+    checker->undecided_bits = status == -1 ? state_bits(undecided) : 0;
+    if (status == -1 && checker->fallback_tests) {
+        simulate_undecided(checker, &result);
+    } else if (status == 0) {
+        riscv_verification_state_t input, expected;
+        model_state(enc, &input);
+        expected = input;
+        reference_execute(checker->instruction, &expected);
+        result.counterexample = describe_mismatch(checker->compiler, checker->instruction,
+                                                  &input, word, &expected);
+    } else if (status < 0) {
+        char name[16];
+        word_name(name, word);
+        if (status == -2) {
+            result.counterexample = format_message("0x%08X: timed out at %s bit %d",
+                                                   checker->instruction, name, bit);
+        } else {
+            result.counterexample = format_message("0x%08X: %s bit %d undecided after %d conflicts",
+                                                   checker->instruction, name, bit,
+                                                   checker->conflict_limit);
+        }
+    }
+    result.verification_time_ms = elapsed_ms(start);
+    return result;
+}
+
+static void simulate_pair(const riscv_compiler_t* a, const riscv_compiler_t* b, size_t tests,
+                          verification_result_t* result);
+
+verification_result_t equiv_check_circuits(sat_solver_t* solver, const riscv_compiler_t* a,
+                                           const riscv_compiler_t* b, int conflict_limit,
+                                           size_t fallback_tests, size_t* undecided_bits) {
+    verification_result_t result = {false, "sat", 0, 0.0, NULL};
+    double start = now_ms();
+    lword_t next_a[STATE_WORDS], next_b[STATE_WORDS];
+    if (undecided_bits) *undecided_bits = 0;
+    if (!encode_compiled(solver, a, next_a) || !encode_compiled(solver, b, next_b)) {
+        result.counterexample = format_message("out of memory");
+        return result;
+    }
+
+    size_t solves = solver->solves;
+    int word = 0, bit = 0;
+    uint32_t undecided[STATE_WORDS];
+    int status = prove_equal_words(solver, next_a, next_b, STATE_WORDS, NULL, 0, conflict_limit,
+                                   undecided, &word, &bit);
+    result.verified = status == 1;
+    result.test_cases_checked = solver->solves - solves;
+    if (status == -1 && undecided_bits) *undecided_bits = state_bits(undecided);
+    char name[16];
+    word_name(name, word);
+    if (status == -1 && fallback_tests) {
+        result.method = "sat+simulation";
+        result.verified = true;
+        simulate_pair(a, b, fallback_tests, &result);
+        result.verified = false;
+    } else if (status == 0) {
+        riscv_verification_state_t input, after_a, after_b;
+        model_state(solver, &input);
+        after_a = input;
+        after_b = input;
+        size_t wires = circuit_wires(a->circuit) > circuit_wires(b->circuit) ?
+                       circuit_wires(a->circuit) : circuit_wires(b->circuit);
+        uint64_t* values = malloc(wires * sizeof(uint64_t));
+        if (values) {
+            simulate(a, values, &after_a, 1);
+            simulate(b, values, &after_b, 1);
+        }
+        free(values);
+        result.counterexample = format_message("pc=0x%08X x1=0x%08X x2=0x%08X: %s is 0x%08X, "
+                                               "then 0x%08X", input.pc, input.regs[1],
+                                               input.regs[2], name, state_word(&after_a, word),
+                                               state_word(&after_b, word));
+    } else if (status == -2) {
+        result.counterexample = format_message("timed out at %s bit %d", name, bit);
+    } else if (status == -1) {
+        result.counterexample = format_message("%s bit %d undecided after %d conflicts", name, bit,
+                                               conflict_limit);
+    }
+    result.verification_time_ms = elapsed_ms(start);
+    return result;
+}
+
+// ============================================================================
+// Layer 2: Cube-and-conquer
+// ============================================================================
+
+#define MAX_CUBE_THREADS 64
+
+equiv_cubes_t* equiv_cubes_create(void) {
+    equiv_cubes_t* cubes = calloc(1, sizeof(equiv_cubes_t));
+    if (!cubes) return NULL;
+    cubes->cube_bits = 8;
+    for (int j = 0; j < EQUIV_CUBE_MAX_BITS; j++) cubes->cube_vars[j] = -1;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cubes->num_threads = cpus > 0 ? (size_t)cpus : 1;
+    return cubes;
+}
+
+void equiv_cubes_destroy(equiv_cubes_t* cubes) {
+    free(cubes);
+}
+
+// Fills the negative cube_vars from the operands: both operands' bits in
+// turn, from the low end for products (each product bit depends only on
+// the operand bits below it) and from the high end for quotients (the
+// divisor's high bits decide the first subtractions). Returns how many
+// variables there are.
+static int pick_cube_vars(uint32_t ins, equiv_cubes_t* cubes) {
+    int regs[2], count = read_registers(ins, regs), operands = 0, next = 0;
+    int operand[2];
+    for (int k = 0; k < count; k++) {
+        if (regs[k] != 0 && (k == 0 || regs[k] != regs[0])) operand[operands++] = regs[k];
+    }
+    bool division = (ins & 0x7F) == 0x33 && (ins >> 25) == 1 && ((ins >> 12) & 4);
+    int bits = cubes->cube_bits < EQUIV_CUBE_MAX_BITS ? cubes->cube_bits : EQUIV_CUBE_MAX_BITS;
+    for (int j = 0; j < bits; j++) {
+        while (cubes->cube_vars[j] < 0 && next < 32 * operands) {
+            int i = next / operands, r = operand[next % operands];
+            int var = 32 * r + (division ? 31 - i : i);
+            next++;
+            bool taken = false;
+            for (int k = 0; k < bits; k++) taken = taken || cubes->cube_vars[k] == var;
+            if (!taken) cubes->cube_vars[j] = var;
+        }
+        if (cubes->cube_vars[j] < 0 || cubes->cube_vars[j] >= 32 * STATE_WORDS) return j;
+    }
+    return bits < 0 ? 0 : bits;
+}
+
+typedef struct {
+    equivalence_checker_t* checker;
+    equiv_cubes_t* cubes;
+    int num_vars;
+    double deadline_ms;
+    atomic_size_t next_cube;
+    atomic_bool stop;
+    pthread_mutex_t lock;
+    // Guarded by lock
+    size_t solves;
+    uint32_t undecided[STATE_WORDS];    // Bits some cube left undecided
+    int status;                         // Of the first cube that failed, 1 if none
+    int word;
+    riscv_verification_state_t input;   // A counterexample's input state
+} cube_run_t;
+
+// Encodes the miter once, then solves cubes until none are left
+static void* cube_worker(void* arg) {
+    cube_run_t* run = arg;
+    equiv_cubes_t* cubes = run->cubes;
+    sat_solver_t* enc = equiv_solver_create();
+    lword_t circuit_next[STATE_WORDS], reference_next[STATE_WORDS];
+    if (!enc || !encode_compiled(enc, run->checker->compiler, circuit_next)) {
+        pthread_mutex_lock(&run->lock);
+        if (run->status == 1) run->status = -3;
+        atomic_store(&run->stop, true);
+        pthread_mutex_unlock(&run->lock);
+        equiv_solver_destroy(enc);
+        return NULL;
+    }
+    encode_reference(enc, run->checker->instruction, reference_next);
+    enc->deadline_ms = run->deadline_ms;
+
+    lit assume[EQUIV_CUBE_MAX_BITS];
+    while (!atomic_load(&run->stop)) {
+        size_t cube = atomic_fetch_add(&run->next_cube, 1);
+        if (cube >= cubes->num_cubes) break;
+        for (int j = 0; j < run->num_vars; j++) {
+            int var = cubes->cube_vars[j];
+            lit v = enc->state[var / 32].bit[var % 32];
+            assume[j] = (cube >> j) & 1 ? v : lit_neg(v);
+        }
+        size_t solves = enc->solves;
+        int word = 0, bit = 0;
+        uint32_t undecided[STATE_WORDS];
+        int status = prove_equal_words(enc, circuit_next, reference_next, STATE_WORDS, assume,
+                                       run->num_vars, run->checker->conflict_limit, undecided,
+                                       &word, &bit);
+
+        pthread_mutex_lock(&run->lock);
+        run->solves += enc->solves - solves;
+        if (status != -2) cubes->cubes_done++;
+        if (status == 1) {
+            cubes->cubes_proven++;
+        } else if (status == -1) {
+            cubes->cubes_undecided++;
+            for (int w = 0; w < STATE_WORDS; w++) run->undecided[w] |= undecided[w];
+        } else if (run->status == 1) {
+            run->status = status;
+            run->word = word;
+            if (status == 0) model_state(enc, &run->input);
+            atomic_store(&run->stop, true);
+        }
+        if (cubes->progress && status != -2) cubes->progress(cubes, cubes->progress_ctx);
+        pthread_mutex_unlock(&run->lock);
+    }
+    equiv_solver_destroy(enc);
+    return NULL;
+}
+
+verification_result_t equiv_checker_verify_cubes(equivalence_checker_t* checker,
+                                                 equiv_cubes_t* cubes) {
+    verification_result_t result = {false, "sat", 0, 0.0, NULL};
+    double start = now_ms();
+    cube_run_t run = {.checker = checker, .cubes = cubes, .status = 1};
+    run.num_vars = pick_cube_vars(checker->instruction, cubes);
+    run.deadline_ms = cubes->timeout_seconds > 0 ? start + 1000.0 * cubes->timeout_seconds : 0;
+    atomic_init(&run.next_cube, 0);
+    atomic_init(&run.stop, false);
+    pthread_mutex_init(&run.lock, NULL);
+    cubes->num_cubes = (size_t)1 << run.num_vars;
+    cubes->cubes_done = cubes->cubes_proven = cubes->cubes_undecided = 0;
+    memset(cubes->proven, 0, sizeof(cubes->proven));
+    checker->undecided_bits = 0;
+
+    size_t num_threads = cubes->num_threads ? cubes->num_threads : 1;
+    if (num_threads > MAX_CUBE_THREADS) num_threads = MAX_CUBE_THREADS;
+    if (num_threads > cubes->num_cubes) num_threads = cubes->num_cubes;
+    pthread_t threads[MAX_CUBE_THREADS];
+    size_t started = 0;
+    while (started < num_threads &&
+           pthread_create(&threads[started], NULL, cube_worker, &run) == 0) {
+        started++;
+    }
+    // Without any thread the caller does the work
+    if (started == 0) cube_worker(&run);
+    for (size_t t = 0; t < started; t++) pthread_join(threads[t], NULL);
+    pthread_mutex_destroy(&run.lock);
+
+    result.test_cases_checked = run.solves;
+    if (run.status == 0) {
+        riscv_verification_state_t expected = run.input;
+        reference_execute(checker->instruction, &expected);
+        result.counterexample = describe_mismatch(checker->compiler, checker->instruction,
+                                                  &run.input, run.word, &expected);
+    } else if (run.status == -2) {
+        result.counterexample = format_message("0x%08X: timed out with %zu of %zu cubes done",
+                                               checker->instruction, cubes->cubes_done,
+                                               cubes->num_cubes);
+    } else if (run.status == -3) {
+        result.counterexample = format_message("out of memory");
+    } else {
+        // Every cube is done: a bit is proven if no cube left it undecided
+        for (int w = 0; w < STATE_WORDS; w++) cubes->proven[w] = ~run.undecided[w];
+        checker->undecided_bits = state_bits(run.undecided);
+        if (cubes->cubes_undecided > 0 && checker->fallback_tests) {
+            simulate_undecided(checker, &result);
+        } else if (cubes->cubes_undecided > 0) {
+            result.counterexample = format_message("0x%08X: %zu of %zu cubes undecided after "
+                                                   "%d conflicts", checker->instruction,
+                                                   cubes->cubes_undecided, cubes->num_cubes,
+                                                   checker->conflict_limit);
+        }
+    }
+    // Simulated bits are not proven, whatever simulation found
+    result.verified = run.status == 1 && cubes->cubes_undecided == 0;
+    cubes->wall_time_ms = elapsed_ms(start);
+    result.verification_time_ms = cubes->wall_time_ms;
+    return result;
+}
+
+// ============================================================================
+// Layer 3: Bounds
+// ============================================================================
+
+bounded_verifier_t* bounded_verifier_create(const verification_bounds_t* bounds) {
+    bounded_verifier_t* verifier = calloc(1, sizeof(bounded_verifier_t));
+    if (!verifier) return NULL;
+    if (bounds) {
+        verifier->bounds = *bounds;
+    } else {
+        verifier->bounds.max_input_bits = MAX_INPUT_BITS;
+        verifier->bounds.max_output_bits = MAX_OUTPUT_BITS;
+        verifier->bounds.max_gates = 10000000;
+        verifier->bounds.max_depth = 4096;
+        verifier->bounds.max_memory_bytes = 10 * 1024 * 1024;
+    }
+    return verifier;
+}
+
+void bounded_verifier_destroy(bounded_verifier_t* verifier) {
+    free(verifier);
+}
+
+verification_result_t bounded_verify(bounded_verifier_t* verifier, circuit_t* circuit) {
+    verification_result_t result = {false, "bounded", 5, 0.0, NULL};
+    double start = now_ms();
+    const verification_bounds_t* b = &verifier->bounds;
+    verifier->circuit = circuit;
+    verifier->actual_gates = circuit->num_gates;
+    verifier->actual_depth = riscv_circuit_depth(circuit);
+    verifier->actual_memory = circuit->num_gates * sizeof(gate_t) +
+                              (circuit->num_inputs + circuit->num_outputs + 7) / 8;
+
+    if (circuit->num_inputs > b->max_input_bits) {
+        result.counterexample = format_message("%zu input bits exceed %zu", circuit->num_inputs,
+                                               b->max_input_bits);
+    } else if (circuit->num_outputs > b->max_output_bits) {
+        result.counterexample = format_message("%zu output bits exceed %zu", circuit->num_outputs,
+                                               b->max_output_bits);
+    } else if (verifier->actual_gates > b->max_gates) {
+        result.counterexample = format_message("%zu gates exceed %zu", verifier->actual_gates,
+                                               b->max_gates);
+    } else if (verifier->actual_depth > b->max_depth) {
+        result.counterexample = format_message("depth %zu exceeds %zu", verifier->actual_depth,
+                                               b->max_depth);
+    } else if (verifier->actual_memory > b->max_memory_bytes) {
+        result.counterexample = format_message("%zu bytes exceed %zu", verifier->actual_memory,
+                                               b->max_memory_bytes);
+    } else {
+        result.verified = true;
+    }
+    result.verification_time_ms = elapsed_ms(start);
+    return result;
+}
+
+// ============================================================================
+// Layer 4: Properties
+// ============================================================================
+
+#define RV_R(op, rd, rs1, rs2) ((op) | (uint32_t)(rs2) << 20 | (uint32_t)(rs1) << 15 | \
+                                (uint32_t)(rd) << 7)
+#define RV_I(op, rd, rs1, imm) ((op) | ((uint32_t)(imm) & 0xFFF) << 20 | \
+                                (uint32_t)(rs1) << 15 | (uint32_t)(rd) << 7)
+#define RV_U(op, rd, imm20) ((op) | (uint32_t)(imm20) << 12 | (uint32_t)(rd) << 7)
+#define RV_B(op, rs1, rs2, off) ((op) | ((uint32_t)(off) >> 12 & 1) << 31 | \
+                                 ((uint32_t)(off) >> 5 & 0x3F) << 25 | (uint32_t)(rs2) << 20 | \
+                                 (uint32_t)(rs1) << 15 | ((uint32_t)(off) >> 1 & 0xF) << 8 | \
+                                 ((uint32_t)(off) >> 11 & 1) << 7)
+#define RV_J(rd, off) (0x6Fu | ((uint32_t)(off) >> 20 & 1) << 31 | \
+                       ((uint32_t)(off) >> 1 & 0x3FF) << 21 | ((uint32_t)(off) >> 11 & 1) << 20 | \
+                       ((uint32_t)(off) >> 12 & 0xFF) << 12 | (uint32_t)(rd) << 7)
+
+// funct7 | funct3 | opcode of each operation
+#define OP_ADD   0x00000033u
+#define OP_SUB   0x40000033u
+#define OP_SLL   0x00001033u
+#define OP_SLT   0x00002033u
+#define OP_SLTU  0x00003033u
+#define OP_XOR   0x00004033u
+#define OP_SRL   0x00005033u
+#define OP_SRA   0x40005033u
+#define OP_OR    0x00006033u
+#define OP_AND   0x00007033u
+#define OP_MUL   0x02000033u
+#define OP_MULH  0x02001033u
+#define OP_MULHSU 0x02002033u
+#define OP_MULHU 0x02003033u
+#define OP_DIV   0x02004033u
+#define OP_DIVU  0x02005033u
+#define OP_REM   0x02006033u
+#define OP_REMU  0x02007033u
+#define OP_ADDI  0x00000013u
+#define OP_SLTI  0x00002013u
+#define OP_SLTIU 0x00003013u
+#define OP_XORI  0x00004013u
+#define OP_ORI   0x00006013u
+#define OP_ANDI  0x00007013u
+#define OP_SLLI  0x00001013u
+#define OP_SRLI  0x00005013u
+#define OP_SRAI  0x40005013u
+#define OP_LUI   0x00000037u
+#define OP_AUIPC 0x00000017u
+#define OP_JALR  0x00000067u
+#define OP_BEQ   0x00000063u
+#define OP_BNE   0x00001063u
+#define OP_BLT   0x00004063u
+#define OP_BGE   0x00005063u
+#define OP_BLTU  0x00006063u
+#define OP_BGEU  0x00007063u
+
+#define R_OP(ins) ((ins) & 0xFE00707Fu)
+
+property_verifier_t* property_verifier_create(property_type_t property) {
+    property_verifier_t* verifier = calloc(1, sizeof(property_verifier_t));
+    if (!verifier) return NULL;
+    verifier->property = property;
+    verifier->conflict_limit = -1;
+    return verifier;
+}
+
+void property_verifier_destroy(property_verifier_t* verifier) {
+    if (!verifier) return;
+    equiv_solver_destroy(verifier->solver);
+    free(verifier);
+}
+
+static verification_result_t not_applicable(const char* property, uint32_t ins) {
+    verification_result_t result = {false, "property", 0, 0.0, NULL};
+    result.counterexample = format_message("%s does not apply to 0x%08X", property, ins);
+    return result;
+}
+
+static lword_t next_register(const lword_t next[STATE_WORDS], int reg) {
+    return reg == 0 ? w_const(0) : next[reg];
+}
+
+// Proves register reg_a after program a equal to reg_b after program b
+static verification_result_t programs_agree(property_verifier_t* verifier,
+                                            const uint32_t* a, size_t count_a, int reg_a,
+                                            const uint32_t* b, size_t count_b, int reg_b) {
+    verification_result_t result = {false, "sat", 0, 0.0, NULL};
+    riscv_compiler_t* first = verification_compile(verifier->config, a, count_a);
+    riscv_compiler_t* second = verification_compile(verifier->config, b, count_b);
+    lword_t next_a[STATE_WORDS], next_b[STATE_WORDS];
+    if (!first || !second || !encode_compiled(verifier->solver, first, next_a) ||
+        !encode_compiled(verifier->solver, second, next_b)) {
+        result.counterexample = format_message("cannot compile or encode the programs");
+    } else {
+        lword_t wa = next_register(next_a, reg_a), wb = next_register(next_b, reg_b);
+        size_t solves = verifier->solver->solves;
+        int word, bit;
+        int status = prove_equal_words(verifier->solver, &wa, &wb, 1, NULL, 0,
+                                       verifier->conflict_limit, NULL, &word, &bit);
+        result.verified = status == 1;
+        result.test_cases_checked = verifier->solver->solves - solves;
+        if (status == 0) {
+            riscv_verification_state_t input, after_a, after_b;
+            model_state(verifier->solver, &input);
+            after_a = input;
+            after_b = input;
+            size_t wires = circuit_wires(first->circuit) > circuit_wires(second->circuit) ?
+                           circuit_wires(first->circuit) : circuit_wires(second->circuit);
+            uint64_t* values = malloc(wires * sizeof(uint64_t));
+            if (values) {
+                simulate(first, values, &after_a, 1);
+                simulate(second, values, &after_b, 1);
+            }
+            free(values);
+            result.counterexample = format_message(
+                "x1=0x%08X x2=0x%08X x4=0x%08X: 0x%08X one way, 0x%08X the other",
+                input.regs[1], input.regs[2], input.regs[4],
+                reg_a ? after_a.regs[reg_a] : 0, reg_b ? after_b.regs[reg_b] : 0);
+        } else if (status < 0) {
+            result.counterexample = format_message("bit %d undecided after %d conflicts", bit,
+                                                   verifier->conflict_limit);
+        }
+    }
+    riscv_compiler_destroy(first);
+    riscv_compiler_destroy(second);
+    return result;
+}
+
+// Every gate reads constants, inputs or earlier outputs, and no wire is
+// driven twice
+static bool is_deterministic(const riscv_circuit_t* circuit, char** why) {
+    size_t num_wires = circuit_wires(circuit);
+    uint8_t* driven = calloc(num_wires, 1);
+    if (!driven) return false;
+    for (size_t w = 0; w < circuit->num_inputs && w < num_wires; w++) driven[w] = 1;
+    bool ok = true;
+    for (size_t g = 0; g < circuit->num_gates && ok; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        uint32_t in[3] = {gate->left_input, gate->right_input, gate->select_input};
+        for (int k = 0; k < 3 && ok; k++) {
+            if (in[k] >= num_wires || !driven[in[k]]) {
+                *why = format_message("gate %zu reads undriven wire %u", g, in[k]);
+                ok = false;
+            }
+        }
+        if (ok && (gate->output >= num_wires || driven[gate->output])) {
+            *why = format_message("gate %zu drives wire %u again", g, gate->output);
+            ok = false;
+        }
+        if (ok) driven[gate->output] = 1;
+    }
+    free(driven);
+    return ok;
+}
+
+// Register words an instruction may write: rd for OP, OP-IMM, LUI, AUIPC,
+// JAL, JALR and loads, nothing otherwise
+static int written_register(uint32_t ins) {
+    switch (ins & 0x7F) {
+        case 0x33: case 0x13: case 0x37: case 0x17: case 0x6F: case 0x67: case 0x03:
+            return (ins >> 7) & 31;
+        default:
+            return 0;
+    }
+}
+
+static verification_result_t structural_property(property_verifier_t* verifier,
+                                                 riscv_instruction_t ins) {
+    verification_result_t result = {false, "structural", 1, 0.0, NULL};
+    riscv_compiler_t* compiler = verification_compile(verifier->config, &ins, 1);
+    if (!compiler) {
+        result.counterexample = format_message("0x%08X does not compile", ins);
+        return result;
+    }
+    int rd = written_register(ins);
+    result.verified = true;
+    for (int r = 0; r < 32 && result.verified; r++) {
+        for (int i = 0; i < 32 && result.verified; i++) {
+            uint32_t w = compiler->reg_wires[r][i];
+            if (verifier->property == PROP_REGISTER_X0_ZERO && r == 0 && w != CONSTANT_0_WIRE) {
+                result.verified = false;
+                result.counterexample = format_message("0x%08X: x0 bit %d is wire %u", ins, i, w);
+            } else if (verifier->property == PROP_NO_SIDE_EFFECTS && r != rd &&
+                       w != get_register_wire(r, i)) {
+                result.verified = false;
+                result.counterexample = format_message("0x%08X changes x%d", ins, r);
+            }
+        }
+    }
+    if (verifier->property == PROP_DETERMINISTIC) {
+        result.verified = is_deterministic(compiler->circuit, &result.counterexample);
+    }
+    riscv_compiler_destroy(compiler);
+    return result;
+}
+
+// A 4-byte aligned PC stays aligned
+static verification_result_t pc_stays_aligned(property_verifier_t* verifier,
+                                              riscv_instruction_t ins) {
+    verification_result_t result = {false, "sat", 0, 0.0, NULL};
+    sat_solver_t* enc = verifier->solver;
+    riscv_compiler_t* compiler = verification_compile(verifier->config, &ins, 1);
+    lword_t next[STATE_WORDS];
+    if (!compiler || !encode_compiled(enc, compiler, next)) {
+        riscv_compiler_destroy(compiler);
+        result.counterexample = format_message("0x%08X does not compile", ins);
+        return result;
+    }
+    lword_t low = w_const(0), zero = w_const(0);
+    low.bit[0] = next[0].bit[0];
+    low.bit[1] = next[0].bit[1];
+    lit aligned[2] = {lit_neg(enc->state[0].bit[0]), lit_neg(enc->state[0].bit[1])};
+    size_t solves = enc->solves;
+    int word, bit;
+    int status = prove_equal_words(enc, &low, &zero, 1, aligned, 2, verifier->conflict_limit,
+                                   NULL, &word, &bit);
+    result.verified = status == 1;
+    result.test_cases_checked = enc->solves - solves;
+    if (status == 0) {
+        riscv_verification_state_t input, expected;
+        model_state(enc, &input);
+        expected = input;
+        expected.pc &= ~3u;
+        result.counterexample = describe_mismatch(compiler, ins, &input, 0, &expected);
+    } else if (status < 0) {
+        result.counterexample = format_message("0x%08X: pc bit %d undecided", ins, bit);
+    }
+    riscv_compiler_destroy(compiler);
+    return result;
+}
+
+// Right identity e with a op e = a
+static bool identity_of(uint32_t op, int32_t* e) {
+    switch (op) {
+        case OP_ADD: case OP_SUB: case OP_XOR: case OP_OR:
+        case OP_SLL: case OP_SRL: case OP_SRA:
+            *e = 0;
+            return true;
+        case OP_AND:
+            *e = -1;
+            return true;
+        case OP_MUL: case OP_DIV: case OP_DIVU:
+            *e = 1;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_register_op(uint32_t ins) {
+    return (ins & 0x7F) == 0x33 && reference_supported(ins);
+}
+
+verification_result_t property_verify(property_verifier_t* verifier,
+                                      riscv_instruction_t instruction) {
+    double start = now_ms();
+    verification_result_t result;
+    uint32_t op = R_OP(instruction);
+    int32_t e;
+
+    if (verifier->property != PROP_DETERMINISTIC && verifier->property != PROP_NO_SIDE_EFFECTS &&
+        verifier->property != PROP_REGISTER_X0_ZERO && !verifier->solver) {
+        verifier->solver = equiv_solver_create();
+        if (!verifier->solver) return not_applicable("a property without memory", instruction);
+    }
+
+    switch (verifier->property) {
+        case PROP_DETERMINISTIC:
+        case PROP_NO_SIDE_EFFECTS:
+        case PROP_REGISTER_X0_ZERO:
+            result = structural_property(verifier, instruction);
+            break;
+        case PROP_PC_ALIGNMENT:
+            result = pc_stays_aligned(verifier, instruction);
+            break;
+        case PROP_COMMUTATIVE: {
+            if (!is_register_op(instruction)) return not_applicable("commutativity", instruction);
+            uint32_t a[] = {RV_R(op, 5, 1, 2)}, b[] = {RV_R(op, 5, 2, 1)};
+            result = programs_agree(verifier, a, 1, 5, b, 1, 5);
+            break;
+        }
+        case PROP_ASSOCIATIVE: {
+            if (!is_register_op(instruction)) return not_applicable("associativity", instruction);
+            uint32_t a[] = {RV_R(op, 5, 1, 2), RV_R(op, 5, 5, 4)};
+            uint32_t b[] = {RV_R(op, 6, 2, 4), RV_R(op, 6, 1, 6)};
+            result = programs_agree(verifier, a, 2, 5, b, 2, 6);
+            break;
+        }
+        case PROP_IDENTITY: {
+            if (!is_register_op(instruction) || !identity_of(op, &e)) {
+                return not_applicable("an identity", instruction);
+            }
+            uint32_t a[] = {RV_I(OP_ADDI, 6, 0, e), RV_R(op, 5, 1, 6)};
+            result = programs_agree(verifier, a, 2, 5, NULL, 0, 1);
+            break;
+        }
+        case PROP_INVERSE: {
+            // a + (0 - a) = 0; a - a = a ^ a = 0
+            uint32_t a[] = {RV_R(OP_SUB, 6, 0, 1), RV_R(OP_ADD, 5, 1, 6)};
+            uint32_t self[] = {RV_R(op, 5, 1, 1)};
+            if (op == OP_ADD) result = programs_agree(verifier, a, 2, 5, NULL, 0, 0);
+            else if (op == OP_SUB || op == OP_XOR) result = programs_agree(verifier, self, 1, 5, NULL, 0, 0);
+            else return not_applicable("an inverse", instruction);
+            break;
+        }
+        case PROP_SHIFT_BOUNDS: {
+            // Only the low five bits of the amount count
+            if (op != OP_SLL && op != OP_SRL && op != OP_SRA) {
+                return not_applicable("shift bounds", instruction);
+            }
+            uint32_t a[] = {RV_R(op, 5, 1, 2)};
+            uint32_t b[] = {RV_I(OP_ANDI, 6, 2, 31), RV_R(op, 5, 1, 6)};
+            result = programs_agree(verifier, a, 1, 5, b, 2, 5);
+            break;
+        }
+        case PROP_OVERFLOW_WRAPS: {
+            // The reference computes modulo 2^32
+            equivalence_checker_t* checker =
+                equiv_checker_create_with(verifier->solver, verifier->config, instruction);
+            if (!checker) return not_applicable("wrapping", instruction);
+            checker->conflict_limit = verifier->conflict_limit;
+            result = equiv_checker_verify(checker);
+            equiv_checker_destroy(checker);
+            break;
+        }
+        default:
+            return not_applicable("this property", instruction);
+    }
+    result.verification_time_ms = elapsed_ms(start);
+    return result;
+}
+
+// ============================================================================
+// Layer 5: Differential testing
+// ============================================================================
+
+void reference_execute(uint32_t ins, riscv_verification_state_t* state) {
+    if (!reference_supported(ins)) return;
+    uint32_t* regs = state->regs;
+    regs[0] = 0;
+    uint32_t rd = (ins >> 7) & 31, f3 = (ins >> 12) & 7, f7 = ins >> 25;
+    uint32_t a = regs[(ins >> 15) & 31], b = regs[(ins >> 20) & 31];
+    uint32_t imm = (uint32_t)((int32_t)ins >> 20), result = regs[rd];
+    int32_t sa = (int32_t)a, sb = (int32_t)b;
+    switch (ins & 0x7F) {
+        case 0x13:
+            b = imm;
+            sb = (int32_t)imm;
+            // fall through
+        case 0x33:
+            if ((ins & 0x7F) == 0x33 && f7 == 1) {
+                switch (f3) {
+                    case 0: result = a * b; break;
+                    case 1: result = (uint32_t)((uint64_t)((int64_t)sa * sb) >> 32); break;
+                    case 2: result = (uint32_t)((uint64_t)((int64_t)sa * (int64_t)b) >> 32); break;
+                    case 3: result = (uint32_t)(((uint64_t)a * b) >> 32); break;
+                    case 4: result = b == 0 ? 0xFFFFFFFF : (sa == INT32_MIN && sb == -1) ? a
+                                   : (uint32_t)(sa / sb); break;
+                    case 5: result = b == 0 ? 0xFFFFFFFF : a / b; break;
+                    case 6: result = b == 0 ? a : (sa == INT32_MIN && sb == -1) ? 0
+                                   : (uint32_t)(sa % sb); break;
+                    default: result = b == 0 ? a : a % b; break;
+                }
+                break;
+            }
+            switch (f3) {
+                case 0: result = (ins & 0x7F) == 0x33 && f7 == 0x20 ? a - b : a + b; break;
+                case 1: result = a << (b & 31); break;
+                case 2: result = sa < sb; break;
+                case 3: result = a < b; break;
+                case 4: result = a ^ b; break;
+                case 5: result = f7 == 0x20 ? (uint32_t)(sa >> (b & 31)) : a >> (b & 31); break;
+                case 6: result = a | b; break;
+                default: result = a & b; break;
+            }
+            break;
+        case 0x37:
+            result = ins & 0xFFFFF000u;
+            break;
+        case 0x17:
+            result = state->pc + (ins & 0xFFFFF000u);
+            break;
+        case 0x6F:
+            result = state->pc + 4;
+            state->pc += j_offset(ins);
+            break;
+        case 0x67:
+            result = state->pc + 4;
+            state->pc = (a + imm) & ~1u;
+            break;
+        default: {
+            bool taken = f3 == 0 ? a == b : f3 == 1 ? a != b : f3 == 4 ? sa < sb :
+                         f3 == 5 ? sa >= sb : f3 == 6 ? a < b : a >= b;
+            state->pc += taken ? b_offset(ins) : 4;
+            return;
+        }
+    }
+    if (rd != 0) regs[rd] = result;
+}
+
+static uint64_t next_random(uint64_t* seed) {
+    uint64_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *seed = x;
+    return x;
+}
+
+// Full-width words, with small and boundary values mixed in
+static uint32_t random_word(uint64_t* seed) {
+    uint64_t r = next_random(seed);
+    switch (r & 7) {
+        case 0: return (uint32_t)(r >> 59);
+        case 1: return (uint32_t)-(int32_t)(r >> 59);
+        case 2: return 0x80000000u ^ (uint32_t)(r >> 60);
+        default: return (uint32_t)(r >> 32);
+    }
+}
+
+static void random_state(uint64_t* seed, riscv_verification_state_t* state) {
+    memset(state, 0, sizeof(*state));
+    state->pc = (uint32_t)next_random(seed) & ~3u;
+    for (int r = 1; r < 32; r++) state->regs[r] = random_word(seed);
+}
+
+void generate_random_state(riscv_verification_state_t* state) {
+    uint64_t seed = ((uint64_t)rand() << 32) ^ (uint64_t)rand() ^ 0x9E3779B97F4A7C15ULL;
+    random_state(&seed, state);
+}
+
+static const uint32_t edge_values[] = {
+    0, 1, 2, 31, 32, 0x7FFFFFFF, 0x80000000, 0x80000001, 0xFFFFFFFE, 0xFFFFFFFF,
+    0x55555555, 0xAAAAAAAA,
+};
+#define NUM_EDGE_VALUES (sizeof(edge_values) / sizeof(edge_values[0]))
+
+void generate_edge_cases(riscv_instruction_t instruction, riscv_verification_state_t** states,
+                         size_t* count) {
+    uint32_t rs1 = (instruction >> 15) & 31, rs2 = (instruction >> 20) & 31;
+    static const uint32_t pcs[] = {0, 4, 0x7FFFFFFC, 0x80000000, 0xFFFFFFFC};
+    *count = NUM_EDGE_VALUES * NUM_EDGE_VALUES;
+    *states = calloc(*count, sizeof(riscv_verification_state_t));
+    if (!*states) {
+        *count = 0;
+        return;
+    }
+    for (size_t i = 0; i < *count; i++) {
+        riscv_verification_state_t* state = &(*states)[i];
+        state->pc = pcs[i % 5];
+        for (int r = 1; r < 32; r++) state->regs[r] = 0x01010101u * (uint32_t)r;
+        state->regs[rs2] = edge_values[i % NUM_EDGE_VALUES];
+        state->regs[rs1] = edge_values[i / NUM_EDGE_VALUES];
+        state->regs[0] = 0;
+    }
+}
+
+differential_tester_t* differential_tester_create(void) {
+    differential_tester_t* tester = calloc(1, sizeof(differential_tester_t));
+    if (!tester) return NULL;
+    tester->impls.execute_ours = reference_execute;
+    tester->num_tests = 1u << 20;
+    tester->test_edge_cases = true;
+    tester->test_random = true;
+    tester->seed = 0x2545F4914F6CDD1DULL;
+    return tester;
+}
+
+void differential_tester_destroy(differential_tester_t* tester) {
+    free(tester);
+}
+
+// Index of the first differing word (0 is the PC), or -1
+static int first_difference(const riscv_verification_state_t* a,
+                            const riscv_verification_state_t* b) {
+    if (a->pc != b->pc) return 0;
+    for (int r = 1; r < 32; r++) {
+        if (a->regs[r] != b->regs[r]) return r;
+    }
+    return -1;
+}
+
+// Simulates the compiled instruction on the tester's states against each
+// of its implementations; result->verified must be set on entry
+static void simulate_against(const differential_tester_t* tester,
+                             const riscv_compiler_t* compiler, riscv_instruction_t instruction,
+                             verification_result_t* result) {
+    riscv_verification_state_t* edges = NULL;
+    size_t num_edges = 0;
+    if (tester->test_edge_cases) generate_edge_cases(instruction, &edges, &num_edges);
+    uint64_t* values = malloc(circuit_wires(compiler->circuit) * sizeof(uint64_t));
+    if (!values || (tester->test_edge_cases && !edges)) {
+        result->verified = false;
+        result->counterexample = format_message("out of memory");
+        free(values);
+        free(edges);
+        return;
+    }
+
+    void (*impls[3])(uint32_t, riscv_verification_state_t*) = {
+        tester->impls.execute_ours, tester->impls.execute_spike, tester->impls.execute_qemu,
+    };
+    size_t total = num_edges + (tester->test_random ? tester->num_tests : 0);
+    uint64_t seed = tester->seed ^ instruction;
+    riscv_verification_state_t inputs[DIFF_BATCH], outputs[DIFF_BATCH];
+    for (size_t done = 0; done < total && result->verified; done += DIFF_BATCH) {
+        size_t count = total - done < DIFF_BATCH ? total - done : DIFF_BATCH;
+        for (size_t k = 0; k < count; k++) {
+            if (done + k < num_edges) inputs[k] = edges[done + k];
+            else random_state(&seed, &inputs[k]);
+        }
+        memcpy(outputs, inputs, count * sizeof(inputs[0]));
+        simulate(compiler, values, outputs, count);
+        for (size_t k = 0; k < count && result->verified; k++) {
+            for (int m = 0; m < 3 && result->verified; m++) {
+                if (!impls[m]) continue;
+                riscv_verification_state_t expected = inputs[k];
+                impls[m](instruction, &expected);
+                int word = first_difference(&outputs[k], &expected);
+                if (word >= 0) {
+                    result->verified = false;
+                    result->counterexample = describe_mismatch(compiler, instruction, &inputs[k],
+                                                               word, &expected);
+                }
+            }
+            result->test_cases_checked++;
+        }
+    }
+    free(values);
+    free(edges);
+}
+
+// Simulates two circuits on the same random states
+static void simulate_pair(const riscv_compiler_t* a, const riscv_compiler_t* b, size_t tests,
+                          verification_result_t* result) {
+    size_t wires = circuit_wires(a->circuit) > circuit_wires(b->circuit) ?
+                   circuit_wires(a->circuit) : circuit_wires(b->circuit);
+    uint64_t* values = malloc(wires * sizeof(uint64_t));
+    if (!values) {
+        result->verified = false;
+        result->counterexample = format_message("out of memory");
+        return;
+    }
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    riscv_verification_state_t inputs[DIFF_BATCH], after_a[DIFF_BATCH], after_b[DIFF_BATCH];
+    for (size_t done = 0; done < tests && result->verified; done += DIFF_BATCH) {
+        size_t count = tests - done < DIFF_BATCH ? tests - done : DIFF_BATCH;
+        for (size_t k = 0; k < count; k++) random_state(&seed, &inputs[k]);
+        memcpy(after_a, inputs, count * sizeof(inputs[0]));
+        memcpy(after_b, inputs, count * sizeof(inputs[0]));
+        simulate(a, values, after_a, count);
+        simulate(b, values, after_b, count);
+        for (size_t k = 0; k < count && result->verified; k++) {
+            int word = first_difference(&after_a[k], &after_b[k]);
+            if (word >= 0) {
+                char name[16];
+                word_name(name, word);
+                result->verified = false;
+                result->counterexample = format_message(
+                    "pc=0x%08X x1=0x%08X x2=0x%08X: %s is 0x%08X, then 0x%08X", inputs[k].pc,
+                    inputs[k].regs[1], inputs[k].regs[2], name, state_word(&after_a[k], word),
+                    state_word(&after_b[k], word));
+            }
+            result->test_cases_checked++;
+        }
+    }
+    free(values);
+}
+
+verification_result_t differential_verify(differential_tester_t* tester,
+                                          riscv_instruction_t instruction) {
+    verification_result_t result = {false, "differential", 0, 0.0, NULL};
+    double start = now_ms();
+    riscv_compiler_t* compiler = verification_compile(tester->config, &instruction, 1);
+    if (compiler) {
+        result.verified = true;
+        simulate_against(tester, compiler, instruction, &result);
+        riscv_compiler_destroy(compiler);
+    } else {
+        result.counterexample = format_message("0x%08X does not compile", instruction);
+    }
+    result.verification_time_ms = elapsed_ms(start);
+    return result;
+}
+
+// ============================================================================
+// Pipeline
+// ============================================================================
+
+#define R_FORMS(op) RV_R(op, 3, 1, 2), RV_R(op, 1, 1, 2), RV_R(op, 2, 1, 2), \
+                    RV_R(op, 3, 1, 1), RV_R(op, 3, 0, 2), RV_R(op, 3, 1, 0), RV_R(op, 0, 1, 2)
+#define I_FORMS(op) RV_I(op, 3, 1, 0), RV_I(op, 3, 1, 1), RV_I(op, 3, 1, -1), \
+                    RV_I(op, 3, 1, 2047), RV_I(op, 3, 1, -2048), RV_I(op, 1, 1, 0x555), \
+                    RV_I(op, 3, 0, -7), RV_I(op, 0, 1, 5)
+#define SHIFT_FORMS(op) RV_I(op, 3, 1, 0), RV_I(op, 3, 1, 1), RV_I(op, 3, 1, 17), \
+                        RV_I(op, 1, 1, 31), RV_I(op, 0, 1, 3)
+#define U_FORMS(op) RV_U(op, 3, 0), RV_U(op, 3, 0x12345), RV_U(op, 3, 0xFFFFF), \
+                    RV_U(op, 3, 0x80000), RV_U(op, 0, 1)
+#define B_FORMS(op) RV_B(op, 1, 2, 8), RV_B(op, 1, 2, -8), RV_B(op, 1, 2, 4094), \
+                    RV_B(op, 1, 2, -4096), RV_B(op, 1, 1, 12), RV_B(op, 0, 2, 16), \
+                    RV_B(op, 1, 0, -16)
+
+static const riscv_instruction_t rv32im_forms[] = {
+    R_FORMS(OP_ADD), R_FORMS(OP_SUB), R_FORMS(OP_SLL), R_FORMS(OP_SLT), R_FORMS(OP_SLTU),
+    R_FORMS(OP_XOR), R_FORMS(OP_SRL), R_FORMS(OP_SRA), R_FORMS(OP_OR), R_FORMS(OP_AND),
+    I_FORMS(OP_ADDI), I_FORMS(OP_SLTI), I_FORMS(OP_SLTIU), I_FORMS(OP_XORI), I_FORMS(OP_ORI),
+    I_FORMS(OP_ANDI),
+    SHIFT_FORMS(OP_SLLI), SHIFT_FORMS(OP_SRLI), SHIFT_FORMS(OP_SRAI),
+    U_FORMS(OP_LUI), U_FORMS(OP_AUIPC),
+    RV_J(1, 8), RV_J(1, -4), RV_J(0, 2048), RV_J(5, 0xFFFFE), RV_J(1, -0x100000),
+    RV_I(OP_JALR, 1, 2, 4), RV_I(OP_JALR, 2, 2, -4), RV_I(OP_JALR, 0, 1, 0),
+    RV_I(OP_JALR, 1, 1, 2047), RV_I(OP_JALR, 3, 1, 3), RV_I(OP_JALR, 1, 0, -2048),
+    B_FORMS(OP_BEQ), B_FORMS(OP_BNE), B_FORMS(OP_BLT), B_FORMS(OP_BGE), B_FORMS(OP_BLTU),
+    B_FORMS(OP_BGEU),
+    R_FORMS(OP_MUL), R_FORMS(OP_MULH), R_FORMS(OP_MULHSU), R_FORMS(OP_MULHU),
+    R_FORMS(OP_DIV), R_FORMS(OP_DIVU), R_FORMS(OP_REM), R_FORMS(OP_REMU),
+};
+
+size_t verification_rv32im_forms(const riscv_instruction_t** forms) {
+    *forms = rv32im_forms;
+    return sizeof(rv32im_forms) / sizeof(rv32im_forms[0]);
+}
+
+verification_pipeline_t* verification_pipeline_create(void) {
+    verification_pipeline_t* pipeline = calloc(1, sizeof(verification_pipeline_t));
+    if (!pipeline) return NULL;
+    pipeline->solver = equiv_solver_create();
+    pipeline->bounded_verifier = bounded_verifier_create(NULL);
+    pipeline->diff_tester = differential_tester_create();
+    static const property_type_t structural[] = {
+        PROP_DETERMINISTIC, PROP_NO_SIDE_EFFECTS, PROP_REGISTER_X0_ZERO,
+    };
+    bool ok = pipeline->solver && pipeline->bounded_verifier && pipeline->diff_tester;
+    for (int i = 0; i < 3 && ok; i++) {
+        pipeline->property_verifiers[i] = property_verifier_create(structural[i]);
+        ok = pipeline->property_verifiers[i] != NULL;
+    }
+    if (!ok) {
+        fprintf(stderr, "❌ ERROR: Out of memory creating the verification pipeline\n");
+        verification_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    // Simulation cross-checks the SAT layer and covers the bits it leaves open
+    pipeline->diff_tester->num_tests = 4096;
+    pipeline->config.use_sat_checking = true;
+    pipeline->config.use_bounded_checking = true;
+    pipeline->config.use_property_checking = true;
+    pipeline->config.use_differential_testing = true;
+    pipeline->config.timeout_seconds = 3600;
+    // Enough for every RV32I bit; the M extension's high bits are left to
+    // simulation
+    pipeline->config.conflict_limit = 1000;
+    return pipeline;
+}
+
+static void clear_results(verification_pipeline_t* pipeline) {
+    for (size_t i = 0; i < pipeline->num_results; i++) {
+        verification_result_free(&pipeline->results[i]);
+    }
+    pipeline->num_results = 0;
+}
+
+void verification_pipeline_destroy(verification_pipeline_t* pipeline) {
+    if (!pipeline) return;
+    clear_results(pipeline);
+    equiv_solver_destroy(pipeline->solver);
+    bounded_verifier_destroy(pipeline->bounded_verifier);
+    for (int i = 0; i < 16; i++) property_verifier_destroy(pipeline->property_verifiers[i]);
+    differential_tester_destroy(pipeline->diff_tester);
+    free(pipeline);
+}
+
+// Records a layer's result and folds it into the combined one
+static void add_result(verification_pipeline_t* pipeline, verification_result_t* combined,
+                       verification_result_t layer) {
+    combined->test_cases_checked += layer.test_cases_checked;
+    combined->verification_time_ms += layer.verification_time_ms;
+    if (verification_result_simulated(&layer)) {
+        combined->verified = false;
+        if (!combined->counterexample) combined->method = "pipeline+simulation";
+    } else if (!layer.verified && !combined->counterexample) {
+        combined->verified = false;
+        combined->method = "pipeline";
+        combined->counterexample = format_message("%s: %s", layer.method,
+                                                  layer.counterexample ? layer.counterexample : "failed");
+    }
+    if (pipeline->num_results < 32) pipeline->results[pipeline->num_results++] = layer;
+    else verification_result_free(&layer);
+}
+
+verification_result_t verify_instruction(verification_pipeline_t* pipeline,
+                                       riscv_instruction_t instruction) {
+    verification_result_t combined = {true, "pipeline", 0, 0.0, NULL};
+    const riscv_compiler_t* config = pipeline->config.compiler;
+    clear_results(pipeline);
+    pipeline->instruction = instruction;
+    pipeline->last_undecided_bits = 0;
+
+    if (pipeline->config.use_sat_checking) {
+        verification_result_t layer = {false, "sat", 0, 0.0, NULL};
+        equivalence_checker_t* checker =
+            equiv_checker_create_with(pipeline->solver, config, instruction);
+        if (checker) {
+            checker->conflict_limit = pipeline->config.conflict_limit;
+            checker->fallback_tests = pipeline->diff_tester->num_tests;
+            layer = equiv_checker_verify(checker);
+            pipeline->last_undecided_bits = checker->undecided_bits;
+            pipeline->undecided_bits += checker->undecided_bits;
+            equiv_checker_destroy(checker);
+        } else {
+            layer.counterexample = format_message("no reference for 0x%08X", instruction);
+        }
+        add_result(pipeline, &combined, layer);
+    }
+    if (pipeline->config.use_bounded_checking) {
+        riscv_compiler_t* compiler = verification_compile(config, &instruction, 1);
+        verification_result_t layer = {false, "bounded", 0, 0.0, NULL};
+        if (compiler) layer = bounded_verify(pipeline->bounded_verifier, compiler->circuit);
+        else layer.counterexample = format_message("0x%08X does not compile", instruction);
+        pipeline->bounded_verifier->circuit = NULL;
+        riscv_compiler_destroy(compiler);
+        add_result(pipeline, &combined, layer);
+    }
+    if (pipeline->config.use_property_checking) {
+        for (int i = 0; i < 16; i++) {
+            property_verifier_t* verifier = pipeline->property_verifiers[i];
+            if (!verifier) continue;
+            verifier->config = config;
+            verifier->conflict_limit = pipeline->config.conflict_limit;
+            add_result(pipeline, &combined, property_verify(verifier, instruction));
+        }
+    }
+    if (pipeline->config.use_differential_testing) {
+        pipeline->diff_tester->config = config;
+        add_result(pipeline, &combined, differential_verify(pipeline->diff_tester, instruction));
+    }
+    pipeline->instructions_checked++;
+    return combined;
+}
+
+verification_result_t verify_riscv_compiler(verification_pipeline_t* pipeline,
+                                          riscv_compiler_t* compiler) {
+    verification_result_t combined = {true, "pipeline", 0, 0.0, NULL};
+    const riscv_compiler_t* saved = pipeline->config.compiler;
+    const riscv_instruction_t* forms;
+    size_t count = verification_rv32im_forms(&forms);
+    double start = now_ms();
+    pipeline->config.compiler = compiler;
+
+    for (size_t i = 0; i < count && !combined.counterexample; i++) {
+        if (elapsed_ms(start) > 1000.0 * (double)pipeline->config.timeout_seconds) {
+            combined.verified = false;
+            combined.counterexample = format_message("timed out after %zu of %zu instructions",
+                                                     i, count);
+            break;
+        }
+        verification_result_t result = verify_instruction(pipeline, forms[i]);
+        combined.test_cases_checked += result.test_cases_checked;
+        if (verification_result_simulated(&result)) {
+            combined.verified = false;
+            combined.method = "pipeline+simulation";
+        } else if (!result.verified) {
+            combined.verified = false;
+            combined.method = "pipeline";
+            combined.counterexample = format_message("0x%08X: %s", forms[i],
+                                                     result.counterexample ? result.counterexample : "failed");
+        }
+        verification_result_free(&result);
+    }
+    combined.verification_time_ms = elapsed_ms(start);
+    pipeline->config.compiler = saved;
+    return combined;
+}
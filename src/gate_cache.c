@@ -8,6 +8,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <pthread.h>
 
 // Gate pattern caching and deduplication system
 // This significantly reduces gate count by reusing common subcircuits
@@ -238,13 +239,21 @@ void deduplicate_gates(riscv_circuit_t* circuit) {
         uint32_t left = wire_remap[gate->left_input];
         uint32_t right = wire_remap[gate->right_input];
         
+        // Only AND/XOR gates are merged; extended gates are kept as they are
+        if (gate->type != GATE_AND && gate->type != GATE_XOR) {
+            new_gates[new_gate_count] = *gate;
+            new_gates[new_gate_count].left_input = left;
+            new_gates[new_gate_count].right_input = right;
+            new_gates[new_gate_count].select_input = wire_remap[gate->select_input];
+            new_gate_count++;
+            continue;
+        }
+
         // Normalize gate (ensure left <= right for commutative gates)
-        if (gate->type == GATE_AND || gate->type == GATE_XOR) {
-            if (left > right) {
-                uint32_t temp = left;
-                left = right;
-                right = temp;
-            }
+        if (left > right) {
+            uint32_t temp = left;
+            left = right;
+            right = temp;
         }
         
         // Hash the gate
@@ -351,4 +360,234 @@ void build_parallel_op(riscv_circuit_t* circuit,
         last_type = type;
         last_bits = bits;
     }
-}
\ No newline at end of file
+}
+// Gadget templates
+//
+// A gadget is compiled once per process into a standalone template whose
+// wires are numbered: 0/1 constants, then the input ports, then internal
+// wires. Instantiating it copies the gate list into the target circuit,
+// binding input ports to the caller's wires and shifting internal wires by
+// a single offset. Hash-heavy circuits (Merkle paths, sponge chains) then
+// cost a memcpy-speed relocation per use instead of a full rebuild.
+
+#define MAX_GADGET_TEMPLATES 64
+
+struct gadget_template {
+    char name[64];
+    size_t num_inputs;
+    size_t num_outputs;
+    gate_t* gates;
+    size_t num_gates;
+    uint32_t num_internal_wires;  // Wires allocated past the input ports
+    uint32_t* outputs;            // Output ports in template wire space
+    size_t instances;
+};
+
+static gadget_template_t* g_templates[MAX_GADGET_TEMPLATES];
+static size_t g_num_templates = 0;
+static pthread_mutex_t g_template_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static gadget_template_t* find_template_locked(const char* name) {
+    for (size_t i = 0; i < g_num_templates; i++) {
+        if (strcmp(g_templates[i]->name, name) == 0) {
+            return g_templates[i];
+        }
+    }
+    return NULL;
+}
+
+static void template_free(gadget_template_t* tmpl) {
+    if (!tmpl) return;
+    free(tmpl->gates);
+    free(tmpl->outputs);
+    free(tmpl);
+}
+
+static void scratch_free(riscv_circuit_t* scratch) {
+    if (!scratch) return;
+    free(scratch->gates);
+    free(scratch->input_bits);
+    free(scratch->output_bits);
+    free(scratch);
+}
+
+// Port counts of an existing template must match the registration
+static gadget_template_t* check_ports(gadget_template_t* tmpl, const char* name,
+                                      size_t num_inputs, size_t num_outputs) {
+    if (tmpl->num_inputs != num_inputs || tmpl->num_outputs != num_outputs) {
+        fprintf(stderr, "❌ ERROR: Gadget '%s' re-registered with different ports\n", name);
+        return NULL;
+    }
+    return tmpl;
+}
+
+// Build the gadget once over symbolic input ports. Runs without the lock,
+// so builders may instantiate other gadgets.
+static gadget_template_t* template_build(const char* name,
+                                         size_t num_inputs, size_t num_outputs,
+                                         gadget_builder_t builder, void* context) {
+    riscv_circuit_t* scratch = riscv_circuit_create(2 + num_inputs, 0);
+    uint32_t* inputs = malloc((num_inputs + 1) * sizeof(uint32_t));
+    gadget_template_t* tmpl = calloc(1, sizeof(gadget_template_t));
+    if (tmpl) tmpl->outputs = malloc((num_outputs + 1) * sizeof(uint32_t));
+    if (!scratch || !inputs || !tmpl || !tmpl->outputs) {
+        fprintf(stderr, "❌ ERROR: Out of memory building gadget '%s'\n", name);
+        scratch_free(scratch);
+        free(inputs);
+        template_free(tmpl);
+        return NULL;
+    }
+    for (size_t i = 0; i < num_inputs; i++) {
+        inputs[i] = (uint32_t)(2 + i);
+    }
+    strncpy(tmpl->name, name, sizeof(tmpl->name) - 1);
+    tmpl->num_inputs = num_inputs;
+    tmpl->num_outputs = num_outputs;
+
+    builder(scratch, inputs, tmpl->outputs, context);
+
+    tmpl->num_gates = scratch->num_gates;
+    tmpl->gates = malloc((scratch->num_gates + 1) * sizeof(gate_t));
+    if (!tmpl->gates) {
+        fprintf(stderr, "❌ ERROR: Out of memory building gadget '%s'\n", name);
+        template_free(tmpl);
+        tmpl = NULL;
+    } else {
+        memcpy(tmpl->gates, scratch->gates, scratch->num_gates * sizeof(gate_t));
+        tmpl->num_internal_wires = scratch->next_wire_id - (uint32_t)(2 + num_inputs);
+    }
+    free(inputs);
+    scratch_free(scratch);
+    return tmpl;
+}
+
+// Compile a gadget into a template (or return the one already registered).
+// Two threads may build the same gadget at once; the first to publish wins
+// and the other's copy is dropped.
+gadget_template_t* gadget_template_register(const char* name,
+                                            size_t num_inputs, size_t num_outputs,
+                                            gadget_builder_t builder, void* context) {
+    pthread_mutex_lock(&g_template_mutex);
+    gadget_template_t* tmpl = find_template_locked(name);
+    pthread_mutex_unlock(&g_template_mutex);
+    if (tmpl) return check_ports(tmpl, name, num_inputs, num_outputs);
+
+    gadget_template_t* built = template_build(name, num_inputs, num_outputs, builder, context);
+    if (!built) return NULL;
+
+    pthread_mutex_lock(&g_template_mutex);
+    tmpl = find_template_locked(name);
+    bool full = !tmpl && g_num_templates >= MAX_GADGET_TEMPLATES;
+    if (!tmpl && !full) {
+        g_templates[g_num_templates++] = built;
+        pthread_mutex_unlock(&g_template_mutex);
+        return built;
+    }
+    pthread_mutex_unlock(&g_template_mutex);
+
+    template_free(built);
+    if (full) {
+        fprintf(stderr, "❌ ERROR: Too many gadget templates (max %d)\n", MAX_GADGET_TEMPLATES);
+        return NULL;
+    }
+    return check_ports(tmpl, name, num_inputs, num_outputs);
+}
+
+gadget_template_t* gadget_template_lookup(const char* name) {
+    pthread_mutex_lock(&g_template_mutex);
+    gadget_template_t* tmpl = find_template_locked(name);
+    pthread_mutex_unlock(&g_template_mutex);
+    return tmpl;
+}
+
+size_t gadget_template_num_gates(const gadget_template_t* tmpl) {
+    return tmpl ? tmpl->num_gates : 0;
+}
+
+// Relocate a template wire into the target circuit
+static inline uint32_t relocate_wire(uint32_t wire, uint32_t first_internal,
+                                     const uint32_t* inputs, uint32_t offset) {
+    if (wire >= first_internal) return wire + offset;
+    if (wire < 2) return wire;  // CONSTANT_0_WIRE / CONSTANT_1_WIRE
+    return inputs[wire - 2];
+}
+
+// Stamp a template into the circuit with the given input bindings; on
+// failure the circuit and outputs are left untouched
+int gadget_template_instantiate(riscv_circuit_t* circuit, gadget_template_t* tmpl,
+                                const uint32_t* inputs, uint32_t* outputs) {
+    // Grow once up front rather than per gate
+    size_t needed = circuit->num_gates + tmpl->num_gates;
+    if (needed > circuit->capacity) {
+        size_t new_capacity = circuit->capacity ? circuit->capacity : 1024;
+        while (new_capacity < needed) new_capacity *= 2;
+        gate_t* new_gates = realloc(circuit->gates, new_capacity * sizeof(gate_t));
+        if (!new_gates) {
+            fprintf(stderr, "❌ ERROR: Out of memory instantiating gadget '%s'\n", tmpl->name);
+            return -1;
+        }
+        circuit->gates = new_gates;
+        circuit->capacity = new_capacity;
+    }
+
+    uint32_t first_internal = (uint32_t)(2 + tmpl->num_inputs);
+    uint32_t base = circuit->next_wire_id;
+    uint32_t offset = base - first_internal;
+
+    circuit->next_wire_id += tmpl->num_internal_wires;
+    if (circuit->next_wire_id > circuit->max_wire_id) {
+        circuit->max_wire_id = circuit->next_wire_id;
+    }
+
+    gate_t* dst = circuit->gates + circuit->num_gates;
+    memcpy(dst, tmpl->gates, tmpl->num_gates * sizeof(gate_t));
+    for (size_t i = 0; i < tmpl->num_gates; i++) {
+        dst[i].left_input = relocate_wire(dst[i].left_input, first_internal, inputs, offset);
+        dst[i].right_input = relocate_wire(dst[i].right_input, first_internal, inputs, offset);
+        dst[i].select_input = relocate_wire(dst[i].select_input, first_internal, inputs, offset);
+        dst[i].output += offset;  // Gate outputs are always internal wires
+    }
+    circuit->num_gates = needed;
+
+    for (size_t i = 0; i < tmpl->num_outputs; i++) {
+        outputs[i] = relocate_wire(tmpl->outputs[i], first_internal, inputs, offset);
+    }
+
+    pthread_mutex_lock(&g_template_mutex);
+    tmpl->instances++;
+    pthread_mutex_unlock(&g_template_mutex);
+    return 0;
+}
+
+// Register-if-needed and instantiate in one call
+int gadget_instantiate(riscv_circuit_t* circuit, const char* name,
+                       size_t num_inputs, size_t num_outputs,
+                       gadget_builder_t builder, void* context,
+                       const uint32_t* inputs, uint32_t* outputs) {
+    gadget_template_t* tmpl = gadget_template_register(name, num_inputs, num_outputs,
+                                                       builder, context);
+    if (!tmpl) return -1;
+    return gadget_template_instantiate(circuit, tmpl, inputs, outputs);
+}
+
+void gadget_template_print_stats(void) {
+    pthread_mutex_lock(&g_template_mutex);
+    printf("Gadget Templates:\n");
+    for (size_t i = 0; i < g_num_templates; i++) {
+        gadget_template_t* tmpl = g_templates[i];
+        printf("  %-24s %8zu gates x %zu instances\n",
+               tmpl->name, tmpl->num_gates, tmpl->instances);
+    }
+    pthread_mutex_unlock(&g_template_mutex);
+}
+
+// Drop all templates (mainly for tests and long-running tools)
+void gadget_template_clear_all(void) {
+    pthread_mutex_lock(&g_template_mutex);
+    for (size_t i = 0; i < g_num_templates; i++) {
+        template_free(g_templates[i]);
+        g_templates[i] = NULL;
+    }
+    g_num_templates = 0;
+    pthread_mutex_unlock(&g_template_mutex);
+}
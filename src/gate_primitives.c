@@ -0,0 +1,217 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+
+// One native gate; callers have checked riscv_circuit_allows()
+static uint32_t emit(riscv_circuit_t* circuit, gate_type_t type, uint32_t left,
+                     uint32_t right, uint32_t select, uint8_t table) {
+    gate_t gate = {left, right, riscv_circuit_allocate_wire(circuit), select, (uint8_t)type, table};
+    riscv_circuit_add_gate_full(circuit, &gate);
+    return gate.output;
+}
+
+uint32_t gate_xor(riscv_circuit_t* circuit, uint32_t a, uint32_t b) {
+    if (a == CONSTANT_0_WIRE) return b;
+    if (b == CONSTANT_0_WIRE) return a;
+    if (a == b) return CONSTANT_0_WIRE;
+    uint32_t out = riscv_circuit_allocate_wire(circuit);
+    riscv_circuit_add_gate(circuit, a, b, out, GATE_XOR);
+    return out;
+}
+
+uint32_t gate_and(riscv_circuit_t* circuit, uint32_t a, uint32_t b) {
+    if (a == CONSTANT_0_WIRE || b == CONSTANT_0_WIRE) return CONSTANT_0_WIRE;
+    if (a == CONSTANT_1_WIRE) return b;
+    if (b == CONSTANT_1_WIRE) return a;
+    if (a == b) return a;
+    uint32_t out = riscv_circuit_allocate_wire(circuit);
+    riscv_circuit_add_gate(circuit, a, b, out, GATE_AND);
+    return out;
+}
+
+uint32_t gate_not(riscv_circuit_t* circuit, uint32_t a) {
+    if (a == CONSTANT_0_WIRE) return CONSTANT_1_WIRE;
+    if (a == CONSTANT_1_WIRE) return CONSTANT_0_WIRE;
+    if (riscv_circuit_allows(circuit, GATE_NOT)) {
+        return emit(circuit, GATE_NOT, a, CONSTANT_0_WIRE, CONSTANT_0_WIRE, 0);
+    }
+    return gate_xor(circuit, a, CONSTANT_1_WIRE);
+}
+
+uint32_t gate_xnor(riscv_circuit_t* circuit, uint32_t a, uint32_t b) {
+    if (a == b) return CONSTANT_1_WIRE;
+    if (a == CONSTANT_1_WIRE) return b;
+    if (b == CONSTANT_1_WIRE) return a;
+    if (a == CONSTANT_0_WIRE || b == CONSTANT_0_WIRE || !riscv_circuit_allows(circuit, GATE_XNOR)) {
+        return gate_not(circuit, gate_xor(circuit, a, b));
+    }
+    return emit(circuit, GATE_XNOR, a, b, CONSTANT_0_WIRE, 0);
+}
+
+uint32_t gate_or(riscv_circuit_t* circuit, uint32_t a, uint32_t b) {
+    if (a == CONSTANT_1_WIRE || b == CONSTANT_1_WIRE) return CONSTANT_1_WIRE;
+    if (a == CONSTANT_0_WIRE) return b;
+    if (b == CONSTANT_0_WIRE) return a;
+    if (a == b) return a;
+    if (riscv_circuit_allows(circuit, GATE_OR)) {
+        return emit(circuit, GATE_OR, a, b, CONSTANT_0_WIRE, 0);
+    }
+    return gate_xor(circuit, gate_xor(circuit, a, b), gate_and(circuit, a, b));
+}
+
+uint32_t gate_mux(riscv_circuit_t* circuit, uint32_t sel,
+                  uint32_t if_true, uint32_t if_false) {
+    if (if_true == if_false || sel == CONSTANT_1_WIRE) return if_true;
+    if (sel == CONSTANT_0_WIRE) return if_false;
+    if (riscv_circuit_allows(circuit, GATE_MUX)) {
+        // Constant data inputs that fold to at most one gate
+        if (if_true == CONSTANT_1_WIRE && riscv_circuit_allows(circuit, GATE_OR)) {
+            return gate_or(circuit, sel, if_false);
+        }
+        if (if_false != CONSTANT_0_WIRE && (if_true > CONSTANT_1_WIRE || if_false > CONSTANT_1_WIRE)) {
+            return emit(circuit, GATE_MUX, if_false, if_true, sel, 0);
+        }
+    }
+    // A constant data input folds this to a single AND, or to sel / ~sel
+    return gate_xor(circuit, if_false,
+                    gate_and(circuit, sel, gate_xor(circuit, if_true, if_false)));
+}
+
+void gate_mux_word(riscv_circuit_t* circuit, uint32_t sel, const uint32_t* if_true,
+                   const uint32_t* if_false, uint32_t* out, size_t bits) {
+    for (size_t i = 0; i < bits; i++) {
+        out[i] = gate_mux(circuit, sel, if_true[i], if_false[i]);
+    }
+}
+
+uint32_t gate_mux_shallow(riscv_circuit_t* circuit, uint32_t sel, uint32_t not_sel,
+                          uint32_t if_true, uint32_t if_false) {
+    if (if_true == if_false || sel == CONSTANT_1_WIRE) return if_true;
+    if (sel == CONSTANT_0_WIRE) return if_false;
+    // A native mux is one layer already
+    if (riscv_circuit_allows(circuit, GATE_MUX)) return gate_mux(circuit, sel, if_true, if_false);
+    return gate_xor(circuit, gate_and(circuit, sel, if_true),
+                    gate_and(circuit, not_sel, if_false));
+}
+
+// Two-input function from its truth table (bit a | b << 1): one native
+// gate when there is one, else algebraic normal form with at most one AND
+static uint32_t lut2(riscv_circuit_t* circuit, uint8_t table, uint32_t a, uint32_t b) {
+    table &= 0xF;
+    if (__builtin_popcount(table) & 1) {
+        if (table == 0x8) return gate_and(circuit, a, b);
+        if (table == 0xE) return gate_or(circuit, a, b);
+        if (riscv_circuit_allows(circuit, GATE_LUT) && a > CONSTANT_1_WIRE &&
+            b > CONSTANT_1_WIRE && a != b) {
+            return emit(circuit, GATE_LUT, a, b, CONSTANT_0_WIRE, (uint8_t)(table | table << 4));
+        }
+    }
+    if (table == 0x9) return gate_xnor(circuit, a, b);
+    uint32_t out = (table & 1) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+    if (((table >> 1) ^ table) & 1) out = gate_xor(circuit, out, a);
+    if (((table >> 2) ^ table) & 1) out = gate_xor(circuit, out, b);
+    if (__builtin_popcount(table) & 1) out = gate_xor(circuit, out, gate_and(circuit, a, b));
+    return out;
+}
+
+uint32_t gate_lut3(riscv_circuit_t* circuit, uint8_t table, uint32_t a, uint32_t b, uint32_t c) {
+    // Fold constant and repeated inputs into the table
+    uint32_t in[3] = {a, b, c};
+    for (int i = 0; i < 3; i++) {
+        int value = -1, same = -1;
+        if (in[i] <= CONSTANT_1_WIRE) value = in[i] == CONSTANT_1_WIRE;
+        for (int j = 0; j < i && value < 0; j++) {
+            if (in[j] == in[i]) same = j;
+        }
+        if (value < 0 && same < 0) continue;
+        uint8_t folded = 0;
+        for (int m = 0; m < 8; m++) {
+            int v = value >= 0 ? value : (m >> same) & 1;
+            int src = (m & ~(1 << i)) | (v << i);
+            folded |= (uint8_t)(((table >> src) & 1) << m);
+        }
+        table = folded;
+        in[i] = CONSTANT_0_WIRE;
+    }
+
+    int vars[3], n = 0;
+    for (int i = 0; i < 3; i++) {
+        for (int m = 0; m < 8; m++) {
+            if (((table >> m) & 1) != ((table >> (m ^ (1 << i))) & 1)) {
+                vars[n++] = i;
+                break;
+            }
+        }
+    }
+    if (n == 0) return (table & 1) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+    if (n == 1) {
+        uint32_t x = in[vars[0]];
+        return (table & 1) ? gate_not(circuit, x) : x;
+    }
+    if (n == 2) {
+        uint8_t t2 = 0;
+        for (int k = 0; k < 4; k++) {
+            int src = ((k & 1) << vars[0]) | ((k >> 1) << vars[1]);
+            t2 |= (uint8_t)(((table >> src) & 1) << k);
+        }
+        return lut2(circuit, t2, in[vars[0]], in[vars[1]]);
+    }
+
+    if (riscv_circuit_allows(circuit, GATE_LUT)) return emit(circuit, GATE_LUT, a, b, c, table);
+    // Shannon on c: f0 ^ (c & (f0 ^ f1)), or a mux of the two halves
+    uint8_t f0 = table & 0xF, f1 = table >> 4;
+    if (riscv_circuit_allows(circuit, GATE_MUX)) {
+        return gate_mux(circuit, c, lut2(circuit, f1, a, b), lut2(circuit, f0, a, b));
+    }
+    return gate_xor(circuit, lut2(circuit, f0, a, b),
+                    gate_and(circuit, c, lut2(circuit, f0 ^ f1, a, b)));
+}
+
+// cout = majority(a, b, c). Flipping a and b by c turns it into
+// c ^ ((a ^ c) & (b ^ c)), so the carry needs one AND and no OR. With
+// native LUTs sum and carry are one gate each.
+uint32_t gate_full_add(riscv_circuit_t* circuit, uint32_t a, uint32_t b, uint32_t* carry) {
+    uint32_t c = *carry;
+    if (riscv_circuit_allows(circuit, GATE_LUT)) {
+        *carry = gate_lut3(circuit, 0xE8, a, b, c);
+        return gate_lut3(circuit, 0x96, a, b, c);
+    }
+    uint32_t a_c = gate_xor(circuit, a, c);
+    uint32_t sum = gate_xor(circuit, a_c, b);
+    *carry = gate_xor(circuit, c, gate_and(circuit, a_c, gate_xor(circuit, b, c)));
+    return sum;
+}
+
+static uint32_t reduce_tree(riscv_circuit_t* circuit, const uint32_t* wires, size_t n,
+                            uint32_t (*op)(riscv_circuit_t*, uint32_t, uint32_t),
+                            uint32_t identity) {
+    if (n == 0) return identity;
+
+    uint32_t* level = malloc(n * sizeof(uint32_t));
+    memcpy(level, wires, n * sizeof(uint32_t));
+    while (n > 1) {
+        size_t half = 0;
+        for (size_t i = 0; i + 1 < n; i += 2) {
+            level[half++] = op(circuit, level[i], level[i + 1]);
+        }
+        if (n & 1) level[half++] = level[n - 1];
+        n = half;
+    }
+
+    uint32_t result = level[0];
+    free(level);
+    return result;
+}
+
+uint32_t gate_and_reduce(riscv_circuit_t* circuit, const uint32_t* wires, size_t n) {
+    return reduce_tree(circuit, wires, n, gate_and, CONSTANT_1_WIRE);
+}
+
+uint32_t gate_or_reduce(riscv_circuit_t* circuit, const uint32_t* wires, size_t n) {
+    return reduce_tree(circuit, wires, n, gate_or, CONSTANT_0_WIRE);
+}
@@ -23,6 +23,8 @@ typedef enum {
     FUSION_SEXT_SHIFT,      // Sign extension patterns
     FUSION_ZERO_EXT,        // Zero extension patterns
     FUSION_MUL_ADD,         // Multiply-accumulate
+    FUSION_MUL_PAIR,        // MULH[S][U] + MUL on the same operands
+    FUSION_DIV_PAIR,        // DIV[U] + REM[U] on the same operands
 } fusion_type_t;
 
 // Fusion pattern descriptor
@@ -111,6 +113,18 @@ static uint32_t match_shift_mask(uint32_t* instrs, int count) {
     return 0;
 }
 
+// MUL + MULH/MULHSU/MULHU (either order) on the same operands
+static uint32_t match_mul_mulh(uint32_t* instrs, int count) {
+    if (count < 2) return 0;
+    return match_mul_pair(instrs[0], instrs[1]) ? 2 : 0;
+}
+
+// DIV/DIVU + REM/REMU (either order) on the same operands
+static uint32_t match_div_rem(uint32_t* instrs, int count) {
+    if (count < 2) return 0;
+    return match_div_pair(instrs[0], instrs[1]) ? 2 : 0;
+}
+
 // Pattern builders (optimized implementations)
 
 // Build fused LUI+ADDI (load 32-bit immediate)
@@ -189,48 +203,17 @@ static void build_add_add(riscv_compiler_t* compiler, uint32_t* instrs) {
     
     if (rd == 0) return;
     
-    // Three-operand addition using carry-save adder
-    uint32_t* sum = riscv_circuit_allocate_wire_array(compiler->circuit, 32);
-    uint32_t* carry = riscv_circuit_allocate_wire_array(compiler->circuit, 32);
-    
-    // First level: 3:2 compression
-    carry[0] = CONSTANT_0_WIRE;
-    for (int i = 0; i < 32; i++) {
-        uint32_t a = compiler->reg_wires[rs1_1][i];
-        uint32_t b = compiler->reg_wires[rs2_1][i];
-        uint32_t c = compiler->reg_wires[rs2_2][i];
-        
-        // Sum = a XOR b XOR c
-        uint32_t ab_xor = riscv_circuit_allocate_wire(compiler->circuit);
-        riscv_circuit_add_gate(compiler->circuit, a, b, ab_xor, GATE_XOR);
-        sum[i] = riscv_circuit_allocate_wire(compiler->circuit);
-        riscv_circuit_add_gate(compiler->circuit, ab_xor, c, sum[i], GATE_XOR);
-        
-        // Carry = (a AND b) OR (c AND (a XOR b))
-        if (i < 31) {
-            uint32_t ab_and = riscv_circuit_allocate_wire(compiler->circuit);
-            uint32_t c_and_xor = riscv_circuit_allocate_wire(compiler->circuit);
-            riscv_circuit_add_gate(compiler->circuit, a, b, ab_and, GATE_AND);
-            riscv_circuit_add_gate(compiler->circuit, c, ab_xor, c_and_xor, GATE_AND);
-            
-            // OR
-            uint32_t or_xor = riscv_circuit_allocate_wire(compiler->circuit);
-            uint32_t or_and = riscv_circuit_allocate_wire(compiler->circuit);
-            riscv_circuit_add_gate(compiler->circuit, ab_and, c_and_xor, or_xor, GATE_XOR);
-            riscv_circuit_add_gate(compiler->circuit, ab_and, c_and_xor, or_and, GATE_AND);
-            carry[i+1] = riscv_circuit_allocate_wire(compiler->circuit);
-            riscv_circuit_add_gate(compiler->circuit, or_xor, or_and, carry[i+1], GATE_XOR);
-        }
-    }
-    
-    // Final addition
+    // Three-operand addition: one 3:2 compressor row + the objective's final adder
+    uint32_t* operands[3] = {
+        compiler->reg_wires[rs1_1],
+        compiler->reg_wires[rs2_1],
+        compiler->reg_wires[rs2_2],
+    };
     uint32_t* final_sum = riscv_circuit_allocate_wire_array(compiler->circuit, 32);
-    build_sparse_kogge_stone_adder(compiler->circuit, sum, carry, final_sum, 32);
+    build_multi_operand_adder(compiler->circuit, operands, 3, 32, final_sum,
+                              final_adder_for_objective(compiler->circuit));
     
     memcpy(compiler->reg_wires[rd], final_sum, 32 * sizeof(uint32_t));
-    
-    free(sum);
-    free(carry);
     free(final_sum);
     
     // Gate count: ~120 (vs ~160 for two separate additions)
@@ -278,12 +261,28 @@ static void build_shift_mask(riscv_compiler_t* compiler, uint32_t* instrs) {
     // ... standard shift and mask implementation ...
 }
 
+// Build fused MUL pair: one 64-bit product feeds both destinations
+static void build_mul_mulh(riscv_compiler_t* compiler, uint32_t* instrs) {
+    compile_mul_pair(compiler, instrs[0], instrs[1]);
+    
+    // Gate count: one full product instead of a full product plus a low half
+}
+
+// Build fused DIV pair: one divider feeds both destinations
+static void build_div_rem(riscv_compiler_t* compiler, uint32_t* instrs) {
+    compile_div_pair(compiler, instrs[0], instrs[1]);
+    
+    // Gate count: one divider instead of two
+}
+
 // Fusion pattern table
 static fusion_pattern_t fusion_patterns[] = {
     {FUSION_LUI_ADDI, 2, match_lui_addi, build_lui_addi, 0},
     {FUSION_AUIPC_ADDI, 2, match_auipc_addi, build_auipc_addi, 80},
     {FUSION_ADD_ADD, 2, match_add_add, build_add_add, 120},
     {FUSION_SHIFT_MASK, 2, match_shift_mask, build_shift_mask, 0},
+    {FUSION_MUL_PAIR, 2, match_mul_mulh, build_mul_mulh, 6000},
+    {FUSION_DIV_PAIR, 2, match_div_rem, build_div_rem, 6500},
 };
 
 #define NUM_FUSION_PATTERNS (sizeof(fusion_patterns) / sizeof(fusion_patterns[0]))
@@ -361,7 +360,8 @@ void print_fusion_stats(void) {
                 const char* names[] = {
                     "NONE", "LUI+ADDI", "AUIPC+ADDI", "ADD+ADD",
                     "SHIFT+MASK", "CMP+BRANCH", "LOAD+USE",
-                    "SEXT+SHIFT", "ZERO_EXT", "MUL+ADD"
+                    "SEXT+SHIFT", "ZERO_EXT", "MUL+ADD", "MUL+MULH",
+                    "DIV+REM"
                 };
                 printf("  %-15s: %6zu times (%.1f%%)\n",
                        names[fusion_patterns[i].type],
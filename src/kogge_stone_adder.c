@@ -4,6 +4,7 @@
 
 
 #include "riscv_compiler.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -17,12 +18,16 @@ static void build_pg_signals(riscv_circuit_t* circuit,
                             uint32_t a, uint32_t b,
                             uint32_t* p, uint32_t* g) {
     // Propagate: p = a XOR b (propagates carry if one input is 1)
-    *p = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a, b, *p, GATE_XOR);
+    *p = gate_xor(circuit, a, b);
     
     // Generate: g = a AND b (generates carry if both inputs are 1)
-    *g = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a, b, *g, GATE_AND);
+    *g = gate_and(circuit, a, b);
+}
+
+// g ^ (p & g_low): one LUT where the circuit has them
+static uint32_t group_generate(riscv_circuit_t* circuit, uint32_t g, uint32_t p, uint32_t g_low) {
+    if (riscv_circuit_allows(circuit, GATE_LUT)) return gate_lut3(circuit, 0x6A, g, p, g_low);
+    return gate_xor(circuit, g, gate_and(circuit, p, g_low));
 }
 
 // Helper: Combine two PG pairs using the Kogge-Stone operator
@@ -31,32 +36,38 @@ static void combine_pg_pairs(riscv_circuit_t* circuit,
                             uint32_t p_low, uint32_t g_low,
                             uint32_t* p_out, uint32_t* g_out) {
     // P_out = P_high AND P_low
-    *p_out = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, p_high, p_low, *p_out, GATE_AND);
-    
-    // G_out = G_high OR (P_high AND G_low)
-    // Since we only have AND/XOR, use: a OR b = (a XOR b) XOR (a AND b)
-    uint32_t p_and_g = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, p_high, g_low, p_and_g, GATE_AND);
-    
-    uint32_t g_xor_pg = riscv_circuit_allocate_wire(circuit);
-    uint32_t g_and_pg = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, g_high, p_and_g, g_xor_pg, GATE_XOR);
-    riscv_circuit_add_gate(circuit, g_high, p_and_g, g_and_pg, GATE_AND);
+    *p_out = gate_and(circuit, p_high, p_low);
     
-    *g_out = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, g_xor_pg, g_and_pg, *g_out, GATE_XOR);
+    // G_out = G_high OR (P_high AND G_low). A group that propagates cannot
+    // also generate, so the two terms are never both 1 and the OR is an XOR.
+    *g_out = group_generate(circuit, g_high, p_high, g_low);
 }
 
 // Optimized Kogge-Stone adder implementation
 uint32_t build_kogge_stone_adder(riscv_circuit_t* circuit, 
                                 uint32_t* a_bits, uint32_t* b_bits, 
                                 uint32_t* sum_bits, size_t num_bits) {
+    return build_kogge_stone_adder_with_carry(circuit, a_bits, b_bits, CONSTANT_0_WIRE,
+                                              sum_bits, num_bits);
+}
+
+// Kogge-Stone with a carry-in: the carry is merged into bit 0's generate,
+// g0' = g0 | (p0 & cin), so it travels through the prefix tree for free
+uint32_t build_kogge_stone_adder_with_carry(riscv_circuit_t* circuit,
+                                            const uint32_t* a_bits, const uint32_t* b_bits,
+                                            uint32_t carry_in, uint32_t* sum_bits,
+                                            size_t num_bits) {
+    if (num_bits == 0) return carry_in;
+    
     // Allocate arrays for propagate and generate signals
-    uint32_t** p = malloc(6 * sizeof(uint32_t*));  // Max 6 levels for 32-bit
-    uint32_t** g = malloc(6 * sizeof(uint32_t*));
+    // One level per doubling of the stride, plus level 0
+    int num_levels = 1;
+    for (size_t stride = 1; stride < num_bits; stride *= 2) num_levels++;
     
-    for (int i = 0; i < 6; i++) {
+    uint32_t** p = malloc(num_levels * sizeof(uint32_t*));
+    uint32_t** g = malloc(num_levels * sizeof(uint32_t*));
+    
+    for (int i = 0; i < num_levels; i++) {
         p[i] = malloc(num_bits * sizeof(uint32_t));
         g[i] = malloc(num_bits * sizeof(uint32_t));
     }
@@ -65,6 +76,8 @@ uint32_t build_kogge_stone_adder(riscv_circuit_t* circuit,
     for (size_t i = 0; i < num_bits; i++) {
         build_pg_signals(circuit, a_bits[i], b_bits[i], &p[0][i], &g[0][i]);
     }
+    uint32_t p0 = p[0][0];
+    g[0][0] = group_generate(circuit, g[0][0], p0, carry_in);
     
     // Build the prefix tree
     int levels = 0;
@@ -86,20 +99,19 @@ uint32_t build_kogge_stone_adder(riscv_circuit_t* circuit,
     }
     
     // Generate sum bits
-    // sum[0] = p[0][0] (since c[-1] = 0)
-    sum_bits[0] = p[0][0];
+    // sum[0] = p0 ^ cin
+    sum_bits[0] = gate_xor(circuit, p0, carry_in);
     
     // sum[i] = p[0][i] XOR g[levels][i-1] for i > 0
     for (size_t i = 1; i < num_bits; i++) {
-        sum_bits[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, p[0][i], g[levels][i-1], sum_bits[i], GATE_XOR);
+        sum_bits[i] = gate_xor(circuit, p[0][i], g[levels][i-1]);
     }
     
     // Final carry out
     uint32_t carry_out = g[levels][num_bits-1];
     
     // Cleanup
-    for (int i = 0; i < 6; i++) {
+    for (int i = 0; i < num_levels; i++) {
         free(p[i]);
         free(g[i]);
     }
@@ -154,16 +166,8 @@ uint32_t build_sparse_kogge_stone_adder(riscv_circuit_t* circuit,
     for (size_t i = 1; i < num_blocks; i++) {
         // For simplicity, using ripple carry between blocks
         // Full implementation would use Kogge-Stone here too
-        uint32_t carry_and_p = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, block_carry[i-1], block_p[i], carry_and_p, GATE_AND);
-        
-        uint32_t g_xor_cp = riscv_circuit_allocate_wire(circuit);
-        uint32_t g_and_cp = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, block_g[i], carry_and_p, g_xor_cp, GATE_XOR);
-        riscv_circuit_add_gate(circuit, block_g[i], carry_and_p, g_and_cp, GATE_AND);
-        
-        block_carry[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, g_xor_cp, g_and_cp, block_carry[i], GATE_XOR);
+        block_carry[i] = gate_xor(circuit, block_g[i],
+                                  gate_and(circuit, block_carry[i-1], block_p[i]));
     }
     
     // Generate final sum bits using block carries
@@ -177,27 +181,13 @@ uint32_t build_sparse_kogge_stone_adder(riscv_circuit_t* circuit,
         }
         
         // Generate sum bit
-        uint32_t p_bit = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, a_bits[i], b_bits[i], p_bit, GATE_XOR);
-        
-        sum_bits[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, p_bit, carry, sum_bits[i], GATE_XOR);
+        uint32_t p_bit = gate_xor(circuit, a_bits[i], b_bits[i]);
+        sum_bits[i] = gate_xor(circuit, p_bit, carry);
         
         // Update carry for next bit (within block)
         if (i % block_size < block_size - 1 && i < num_bits - 1) {
-            uint32_t g_bit = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, a_bits[i], b_bits[i], g_bit, GATE_AND);
-            
-            uint32_t p_and_c = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, p_bit, carry, p_and_c, GATE_AND);
-            
-            uint32_t g_xor_pc = riscv_circuit_allocate_wire(circuit);
-            uint32_t g_and_pc = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, g_bit, p_and_c, g_xor_pc, GATE_XOR);
-            riscv_circuit_add_gate(circuit, g_bit, p_and_c, g_and_pc, GATE_AND);
-            
-            carry = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, g_xor_pc, g_and_pc, carry, GATE_XOR);
+            uint32_t g_bit = gate_and(circuit, a_bits[i], b_bits[i]);
+            carry = gate_xor(circuit, g_bit, gate_and(circuit, p_bit, carry));
         }
     }
     
@@ -0,0 +1,647 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "circuit_passes.h"
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Linear-layer XOR minimization.
+ *
+ * XOR gates form XOR-only networks, and each output of one is the XOR of
+ * a set of leaves. The network is rebuilt with Paar's heuristic: the pair
+ * of signals shared by the most outputs becomes one new gate, until no
+ * pair is shared. Terms that cancel drop out for free. A network is only
+ * replaced when this needs fewer gates, and the pass does nothing under
+ * OPTIMIZE_DEPTH.
+ */
+
+#define LINEAR_MAX_WEIGHT 64            // leaves per output before giving up
+#define LINEAR_EXPAND_WEIGHT 8          // widest output expanded into readers
+#define LINEAR_MAX_PAIRS (1u << 22)     // pair occurrences per network
+#define NO_WIRE UINT32_MAX
+
+typedef struct {
+    uint32_t* data;
+    uint32_t size, cap;
+} wvec_t;
+
+static bool wvec_push(wvec_t* v, uint32_t x) {
+    if (v->size == v->cap) {
+        uint32_t cap = v->cap ? 2 * v->cap : 4;
+        uint32_t* data = realloc(v->data, cap * sizeof(uint32_t));
+        if (!data) return false;
+        v->data = data;
+        v->cap = cap;
+    }
+    v->data[v->size++] = x;
+    return true;
+}
+
+static bool wvec_has(const wvec_t* v, uint32_t x) {
+    for (uint32_t i = 0; i < v->size; i++) if (v->data[i] == x) return true;
+    return false;
+}
+
+static void wvec_remove(wvec_t* v, uint32_t x) {
+    for (uint32_t i = 0; i < v->size; i++) {
+        if (v->data[i] == x) {
+            v->data[i] = v->data[--v->size];
+            return;
+        }
+    }
+}
+
+// Symmetric difference of two sorted sets
+static bool wvec_xor(wvec_t* out, const wvec_t* a, const wvec_t* b) {
+    uint32_t i = 0, j = 0;
+    out->size = 0;
+    while (i < a->size || j < b->size) {
+        uint32_t x;
+        if (j >= b->size || (i < a->size && a->data[i] < b->data[j])) x = a->data[i++];
+        else if (i >= a->size || b->data[j] < a->data[i]) x = b->data[j++];
+        else { i++; j++; continue; }
+        if (!wvec_push(out, x)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Paar's heuristic
+// ============================================================================
+
+// Max-heap of (count, pair); counts are upper bounds, checked on pop
+typedef struct {
+    uint64_t key;               // (low << 32) | high
+    int32_t count;
+} heap_entry_t;
+
+typedef struct {
+    // Signals: leaves first, then one per extracted pair
+    uint32_t num_leaves;
+    wvec_t leaf_wire;
+    wvec_t pair_a, pair_b;
+    wvec_t* rows;               // per output, signal indices
+    uint32_t num_rows;
+    uint32_t* emitted;          // wire of each signal in the new circuit
+    // Working state
+    wvec_t* cols;               // rows each signal was added to
+    uint32_t* tally;            // per signal, while counting partners
+    heap_entry_t* heap;
+    size_t heap_size, heap_cap;
+} paar_t;
+
+static uint64_t pair_key(uint32_t a, uint32_t b) {
+    return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+}
+
+static bool heap_less(const heap_entry_t* x, const heap_entry_t* y) {
+    // Ties go to the smaller key, so results do not depend on push order
+    return x->count < y->count || (x->count == y->count && x->key > y->key);
+}
+
+static bool heap_push(paar_t* p, uint64_t key, int32_t count) {
+    if (p->heap_size == p->heap_cap) {
+        size_t cap = p->heap_cap ? 2 * p->heap_cap : 64;
+        heap_entry_t* heap = realloc(p->heap, cap * sizeof(heap_entry_t));
+        if (!heap) return false;
+        p->heap = heap;
+        p->heap_cap = cap;
+    }
+    size_t i = p->heap_size++;
+    heap_entry_t e = {key, count};
+    while (i > 0 && heap_less(&p->heap[(i - 1) / 2], &e)) {
+        p->heap[i] = p->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    p->heap[i] = e;
+    return true;
+}
+
+static heap_entry_t heap_pop(paar_t* p) {
+    heap_entry_t top = p->heap[0];
+    heap_entry_t last = p->heap[--p->heap_size];
+    size_t i = 0, n = p->heap_size;
+    for (;;) {
+        size_t best = i, l = 2 * i + 1, r = l + 1;
+        const heap_entry_t* b = &last;
+        if (l < n && heap_less(b, &p->heap[l])) {
+            best = l;
+            b = &p->heap[l];
+        }
+        if (r < n && heap_less(b, &p->heap[r])) best = r;
+        if (best == i) break;
+        p->heap[i] = p->heap[best];
+        i = best;
+    }
+    if (n > 0) p->heap[i] = last;
+    return top;
+}
+
+static uint32_t num_signals(const paar_t* p) {
+    return p->num_leaves + p->pair_a.size;
+}
+
+// Rows holding both a and b; drops rows that lost a from its column
+static int32_t pair_count(paar_t* p, uint32_t a, uint32_t b) {
+    wvec_t* col = &p->cols[a];
+    int32_t count = 0;
+    uint32_t kept = 0;
+    for (uint32_t k = 0; k < col->size; k++) {
+        const wvec_t* row = &p->rows[col->data[k]];
+        if (!wvec_has(row, a)) continue;
+        col->data[kept++] = col->data[k];
+        if (wvec_has(row, b)) count++;
+    }
+    col->size = kept;
+    return count;
+}
+
+// Queues every pair (s, c) with c > s (all c when newest) shared by two or
+// more of the given rows
+static bool queue_partners(paar_t* p, uint32_t s, const wvec_t* rows, bool newest,
+                           wvec_t* seen) {
+    seen->size = 0;
+    for (uint32_t k = 0; k < rows->size; k++) {
+        const wvec_t* row = &p->rows[rows->data[k]];
+        for (uint32_t i = 0; i < row->size; i++) {
+            uint32_t c = row->data[i];
+            if (c == s || (!newest && c < s)) continue;
+            if (p->tally[c]++ == 0 && !wvec_push(seen, c)) return false;
+        }
+    }
+    bool ok = true;
+    for (uint32_t i = 0; i < seen->size; i++) {
+        uint32_t c = seen->data[i];
+        if (ok && p->tally[c] >= 2) ok = heap_push(p, pair_key(s, c), (int32_t)p->tally[c]);
+        p->tally[c] = 0;
+    }
+    return ok;
+}
+
+static bool new_signal(paar_t* p, uint32_t a, uint32_t b) {
+    uint32_t n = num_signals(p) + 1;
+    wvec_t* cols = realloc(p->cols, n * sizeof(wvec_t));
+    if (cols) p->cols = cols;
+    uint32_t* tally = realloc(p->tally, n * sizeof(uint32_t));
+    if (tally) p->tally = tally;
+    if (!cols || !tally) return false;
+    memset(&p->cols[n - 1], 0, sizeof(wvec_t));
+    p->tally[n - 1] = 0;
+    return wvec_push(&p->pair_a, a) && wvec_push(&p->pair_b, b);
+}
+
+// Extracts pairs until none is shared; false if out of memory. A pair's
+// count only falls once queued (pairs with a new signal are queued when it
+// is made), so a popped entry whose recount matches is the true maximum.
+static bool paar_run(paar_t* p) {
+    wvec_t seen = {0};
+    bool ok = true;
+    for (uint32_t r = 0; r < p->num_rows && ok; r++) {
+        const wvec_t* row = &p->rows[r];
+        for (uint32_t i = 0; i < row->size && ok; i++) ok = wvec_push(&p->cols[row->data[i]], r);
+    }
+    for (uint32_t a = 0; a < p->num_leaves && ok; a++) {
+        ok = queue_partners(p, a, &p->cols[a], false, &seen);
+    }
+
+    while (ok && p->heap_size > 0) {
+        heap_entry_t top = heap_pop(p);
+        uint32_t a = (uint32_t)(top.key >> 32), b = (uint32_t)top.key;
+        int32_t count = pair_count(p, a, b);
+        if (count != top.count) {
+            ok = count < 2 || heap_push(p, top.key, count);
+            continue;
+        }
+
+        uint32_t s = num_signals(p);
+        ok = new_signal(p, a, b);
+        const wvec_t* col = &p->cols[a];
+        for (uint32_t k = 0; k < col->size && ok; k++) {
+            uint32_t r = col->data[k];
+            wvec_t* row = &p->rows[r];
+            if (!wvec_has(row, b)) continue;
+            wvec_remove(row, a);
+            wvec_remove(row, b);
+            ok = wvec_push(row, s) && wvec_push(&p->cols[s], r);
+        }
+        ok = ok && queue_partners(p, s, &p->cols[s], true, &seen);
+    }
+    free(seen.data);
+    return ok;
+}
+
+static size_t paar_cost(const paar_t* p) {
+    size_t cost = p->pair_a.size;
+    for (uint32_t r = 0; r < p->num_rows; r++) {
+        if (p->rows[r].size > 1) cost += p->rows[r].size - 1;
+    }
+    return cost;
+}
+
+static void paar_free(paar_t* p) {
+    if (!p) return;
+    free(p->leaf_wire.data);
+    free(p->pair_a.data);
+    free(p->pair_b.data);
+    for (uint32_t r = 0; r < p->num_rows; r++) free(p->rows[r].data);
+    free(p->rows);
+    free(p->emitted);
+    if (p->cols) {
+        for (uint32_t s = 0; s < num_signals(p); s++) free(p->cols[s].data);
+    }
+    free(p->cols);
+    free(p->tally);
+    free(p->heap);
+    free(p);
+}
+
+// Drops the working state of an accepted network
+static void paar_shrink(paar_t* p) {
+    for (uint32_t s = 0; s < num_signals(p); s++) free(p->cols[s].data);
+    free(p->cols);
+    free(p->tally);
+    free(p->heap);
+    p->cols = NULL;
+    p->tally = NULL;
+    p->heap = NULL;
+}
+
+// ============================================================================
+// Emission
+// ============================================================================
+
+static uint32_t signal_wire(const paar_t* p, const uint32_t* map, uint32_t s) {
+    return s < p->num_leaves ? map[p->leaf_wire.data[s]] : p->emitted[s - p->num_leaves];
+}
+
+static bool emit_signal(riscv_circuit_t* circuit, paar_t* p, const uint32_t* map,
+                        uint32_t s, wvec_t* stack) {
+    if (s < p->num_leaves || p->emitted[s - p->num_leaves] != NO_WIRE) return true;
+    stack->size = 0;
+    if (!wvec_push(stack, s)) return false;
+    while (stack->size > 0) {
+        uint32_t t = stack->data[stack->size - 1];
+        uint32_t a = p->pair_a.data[t - p->num_leaves], b = p->pair_b.data[t - p->num_leaves];
+        bool ready = true;
+        uint32_t in[2] = {a, b};
+        for (int k = 0; k < 2; k++) {
+            if (in[k] >= p->num_leaves && p->emitted[in[k] - p->num_leaves] == NO_WIRE) {
+                if (!wvec_push(stack, in[k])) return false;
+                ready = false;
+            }
+        }
+        if (!ready) continue;
+        p->emitted[t - p->num_leaves] = gate_xor(circuit, signal_wire(p, map, a),
+                                                 signal_wire(p, map, b));
+        stack->size--;
+    }
+    return true;
+}
+
+// XOR of a row's signals as a balanced tree
+static bool emit_row(riscv_circuit_t* circuit, paar_t* p, const uint32_t* map,
+                     uint32_t r, wvec_t* stack, wvec_t* level, uint32_t* out) {
+    const wvec_t* row = &p->rows[r];
+    level->size = 0;
+    for (uint32_t i = 0; i < row->size; i++) {
+        if (!emit_signal(circuit, p, map, row->data[i], stack) ||
+            !wvec_push(level, signal_wire(p, map, row->data[i]))) return false;
+    }
+    if (level->size == 0) {
+        *out = CONSTANT_0_WIRE;
+        return true;
+    }
+    while (level->size > 1) {
+        uint32_t n = 0;
+        for (uint32_t i = 0; i + 1 < level->size; i += 2) {
+            level->data[n++] = gate_xor(circuit, level->data[i], level->data[i + 1]);
+        }
+        if (level->size & 1) level->data[n++] = level->data[level->size - 1];
+        level->size = n;
+    }
+    *out = level->data[0];
+    return true;
+}
+
+// ============================================================================
+// The pass
+// ============================================================================
+
+typedef struct {
+    size_t num_gates;
+    size_t num_wires;
+    int64_t* driver;
+    uint8_t* external;      // read by an AND gate or a root
+    uint32_t* parent;       // union-find over gates
+    wvec_t* expr;           // leaves of each XOR wire, sorted
+    uint8_t* too_wide;      // per network root
+    uint32_t* local;        // leaf wire -> signal index, valid when stamp matches
+    uint32_t* stamp;
+    paar_t** plan;          // accepted networks, by root gate
+    uint32_t* row_of;       // output gate -> row of its network
+} linear_t;
+
+static uint32_t find_root(uint32_t* parent, uint32_t g) {
+    while (parent[g] != g) {
+        parent[g] = parent[parent[g]];
+        g = parent[g];
+    }
+    return g;
+}
+
+static void join(linear_t* ln, uint32_t a, uint32_t b) {
+    a = find_root(ln->parent, a);
+    b = find_root(ln->parent, b);
+    if (a == b) return;
+    if (b < a) {
+        uint32_t t = a;
+        a = b;
+        b = t;
+    }
+    ln->parent[b] = a;
+    ln->too_wide[a] |= ln->too_wide[b];
+}
+
+// An XOR input joins the reading gate's network when no other gate needs
+// it, or when it is narrow enough to expand so terms can cancel across it
+static bool joins_network(linear_t* ln, const riscv_circuit_t* circuit, uint32_t w) {
+    if (ln->driver[w] < 0 || circuit->gates[ln->driver[w]].type != GATE_XOR) return false;
+    if (!ln->external[w]) return true;
+    return !ln->too_wide[find_root(ln->parent, (uint32_t)ln->driver[w])] &&
+           ln->expr[w].size <= LINEAR_EXPAND_WEIGHT;
+}
+
+// Leaves of an XOR input: its expression when joined, else the wire itself
+static bool leaf_set(const linear_t* ln, uint32_t w, bool joined, wvec_t* out) {
+    out->size = 0;
+    if (joined) {
+        const wvec_t* e = &ln->expr[w];
+        for (uint32_t i = 0; i < e->size; i++) if (!wvec_push(out, e->data[i])) return false;
+        return true;
+    }
+    return w == CONSTANT_0_WIRE || wvec_push(out, w);
+}
+
+// Splits the XOR gates into networks and expresses each XOR wire over its
+// network's leaves
+static bool build_networks(linear_t* ln, const riscv_circuit_t* circuit) {
+    wvec_t l = {0}, r = {0};
+    bool ok = true;
+    for (size_t g = 0; g < ln->num_gates && ok; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        if (gate->type != GATE_XOR) continue;
+        bool left = joins_network(ln, circuit, gate->left_input);
+        bool right = joins_network(ln, circuit, gate->right_input);
+        if (left) join(ln, (uint32_t)g, (uint32_t)ln->driver[gate->left_input]);
+        if (right) join(ln, (uint32_t)g, (uint32_t)ln->driver[gate->right_input]);
+
+        uint32_t root = find_root(ln->parent, (uint32_t)g);
+        if (ln->too_wide[root]) continue;
+        ok = leaf_set(ln, gate->left_input, left, &l) &&
+             leaf_set(ln, gate->right_input, right, &r) &&
+             wvec_xor(&ln->expr[gate->output], &l, &r);
+        if (ln->expr[gate->output].size > LINEAR_MAX_WEIGHT) ln->too_wide[root] = 1;
+    }
+    free(l.data);
+    free(r.data);
+    if (!ok) return false;
+
+    // Outputs sharing a leaf can share subexpressions: one network. The
+    // leaf's stamp holds the first such gate plus one.
+    for (size_t g = 0; g < ln->num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        if (gate->type != GATE_XOR || !ln->external[gate->output]) continue;
+        const wvec_t* e = &ln->expr[gate->output];
+        for (uint32_t i = 0; i < e->size; i++) {
+            uint32_t w = e->data[i];
+            if (ln->stamp[w] == 0) ln->stamp[w] = (uint32_t)g + 1;
+            else join(ln, (uint32_t)g, ln->stamp[w] - 1);
+        }
+    }
+    memset(ln->stamp, 0, ln->num_wires * sizeof(uint32_t));
+    return true;
+}
+
+// Runs Paar on one network; *plan is NULL when it does not pay off
+static bool plan_network(linear_t* ln, const riscv_circuit_t* circuit, const uint32_t* gates,
+                         size_t count, uint32_t epoch, paar_t** plan) {
+    *plan = NULL;
+    size_t outputs = 0, pairs = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t out = circuit->gates[gates[i]].output;
+        if (!ln->external[out]) continue;
+        size_t w = ln->expr[out].size;
+        outputs++;
+        if (w > 1) pairs += w * (w - 1) / 2;
+    }
+    if (outputs == 0 || pairs > LINEAR_MAX_PAIRS) return true;
+
+    paar_t* p = calloc(1, sizeof(paar_t));
+    if (!p) return false;
+    p->rows = calloc(outputs, sizeof(wvec_t));
+    if (!p->rows) {
+        paar_free(p);
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; i++) {
+        uint32_t out = circuit->gates[gates[i]].output;
+        if (!ln->external[out]) continue;
+        ln->row_of[gates[i]] = p->num_rows;
+        wvec_t* row = &p->rows[p->num_rows++];
+        const wvec_t* e = &ln->expr[out];
+        for (uint32_t k = 0; k < e->size && ok; k++) {
+            uint32_t w = e->data[k];
+            if (ln->stamp[w] != epoch) {
+                ln->stamp[w] = epoch;
+                ln->local[w] = p->num_leaves++;
+                ok = wvec_push(&p->leaf_wire, w);
+            }
+            ok = ok && wvec_push(row, ln->local[w]);
+        }
+    }
+    if (ok) {
+        p->cols = calloc(p->num_leaves + 1, sizeof(wvec_t));
+        p->tally = calloc(p->num_leaves + 1, sizeof(uint32_t));
+        ok = p->cols && p->tally && paar_run(p);
+    }
+    if (!ok) {
+        paar_free(p);
+        return false;
+    }
+
+    if (paar_cost(p) < count) {
+        p->emitted = malloc((p->pair_a.size + 1) * sizeof(uint32_t));
+        if (!p->emitted) {
+            paar_free(p);
+            return false;
+        }
+        for (uint32_t s = 0; s < p->pair_a.size; s++) p->emitted[s] = NO_WIRE;
+        paar_shrink(p);
+        *plan = p;
+    } else {
+        paar_free(p);
+    }
+    return true;
+}
+
+static int rebuild(linear_t* ln, pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    riscv_circuit_t rebuilt = *circuit;
+    rebuilt.capacity = circuit->num_gates + 16;
+    rebuilt.gates = malloc(rebuilt.capacity * sizeof(gate_t));
+    rebuilt.num_gates = 0;
+    rebuilt.next_wire_id = (uint32_t)ln->num_wires;
+    uint32_t* map = malloc(ln->num_wires * sizeof(uint32_t));
+    wvec_t stack = {0}, level = {0};
+    if (!rebuilt.gates || !map) {
+        free(rebuilt.gates);
+        free(map);
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        return -1;
+    }
+
+    bool ok = true;
+    for (size_t w = 0; w < ln->num_wires; w++) map[w] = (uint32_t)w;
+    for (size_t g = 0; g < circuit->num_gates && ok; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        paar_t* plan = gate->type == GATE_XOR ? ln->plan[find_root(ln->parent, (uint32_t)g)] : NULL;
+        if (!plan) {
+            riscv_circuit_add_gate(&rebuilt, map[gate->left_input], map[gate->right_input],
+                                   gate->output, gate->type);
+        } else if (ln->external[gate->output]) {
+            ok = emit_row(&rebuilt, plan, map, ln->row_of[g], &stack, &level, &map[gate->output]);
+        }
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) *ctx->roots[i] = map[*ctx->roots[i]];
+    free(map);
+    free(stack.data);
+    free(level.data);
+    if (!ok) {
+        free(rebuilt.gates);
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        return -1;
+    }
+
+    free(circuit->gates);
+    circuit->gates = rebuilt.gates;
+    circuit->num_gates = rebuilt.num_gates;
+    circuit->capacity = rebuilt.capacity;
+    circuit->next_wire_id = rebuilt.next_wire_id;
+    circuit->max_wire_id = rebuilt.next_wire_id;
+
+    return circuit_pass_dce(ctx) < 0 ? -1 : 1;
+}
+
+static void linear_free(linear_t* ln) {
+    free(ln->driver);
+    free(ln->external);
+    free(ln->parent);
+    if (ln->expr) {
+        for (size_t w = 0; w < ln->num_wires; w++) free(ln->expr[w].data);
+    }
+    free(ln->expr);
+    free(ln->too_wide);
+    free(ln->local);
+    free(ln->stamp);
+    if (ln->plan) {
+        for (size_t g = 0; g < ln->num_gates; g++) paar_free(ln->plan[g]);
+    }
+    free(ln->plan);
+    free(ln->row_of);
+}
+
+int circuit_pass_linear(pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    if (circuit->objective == OPTIMIZE_DEPTH || circuit->num_gates == 0 ||
+        riscv_circuit_is_extended(circuit)) return 0;
+
+    // One driver per wire from here on
+    int renumbered = circuit_pass_renumber(ctx);
+    if (renumbered < 0) return -1;
+
+    linear_t ln;
+    memset(&ln, 0, sizeof(ln));
+    ln.num_gates = circuit->num_gates;
+    ln.num_wires = circuit->next_wire_id > circuit->num_inputs ?
+                   circuit->next_wire_id : circuit->num_inputs;
+    size_t num_gates = ln.num_gates, num_wires = ln.num_wires;
+    ln.driver = malloc(num_wires * sizeof(int64_t));
+    ln.external = calloc(num_wires, 1);
+    ln.parent = malloc(num_gates * sizeof(uint32_t));
+    ln.expr = calloc(num_wires, sizeof(wvec_t));
+    ln.too_wide = calloc(num_gates, 1);
+    ln.local = malloc(num_wires * sizeof(uint32_t));
+    ln.stamp = calloc(num_wires, sizeof(uint32_t));
+    ln.plan = calloc(num_gates, sizeof(paar_t*));
+    ln.row_of = malloc(num_gates * sizeof(uint32_t));
+    uint32_t* order = malloc(num_gates * sizeof(uint32_t));
+    uint32_t* start = calloc(num_gates + 1, sizeof(uint32_t));
+    if (!ln.driver || !ln.external || !ln.parent || !ln.expr || !ln.too_wide || !ln.local ||
+        !ln.stamp || !ln.plan || !ln.row_of || !order || !start) {
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        linear_free(&ln);
+        free(order);
+        free(start);
+        return -1;
+    }
+
+    for (size_t w = 0; w < num_wires; w++) ln.driver[w] = -1;
+    for (size_t g = 0; g < num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        ln.driver[gate->output] = (int64_t)g;
+        ln.parent[g] = (uint32_t)g;
+        if (gate->type != GATE_XOR) {
+            ln.external[gate->left_input] = 1;
+            ln.external[gate->right_input] = 1;
+        }
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) ln.external[*ctx->roots[i]] = 1;
+
+    int result = renumbered;
+    if (!build_networks(&ln, circuit)) {
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        result = -1;
+    }
+
+    // Gates of each network, in gate order
+    for (size_t g = 0; g < num_gates; g++) {
+        if (circuit->gates[g].type == GATE_XOR) start[find_root(ln.parent, (uint32_t)g) + 1]++;
+    }
+    for (size_t g = 0; g < num_gates; g++) start[g + 1] += start[g];
+    for (size_t g = 0; g < num_gates; g++) {
+        if (circuit->gates[g].type == GATE_XOR) order[start[find_root(ln.parent, (uint32_t)g)]++] = (uint32_t)g;
+    }
+    for (size_t g = num_gates; g > 0; g--) start[g] = start[g - 1];
+    start[0] = 0;
+
+    size_t accepted = 0;
+    for (size_t root = 0; root < num_gates && result >= 0; root++) {
+        size_t count = start[root + 1] - start[root];
+        if (count < 2 || ln.too_wide[root]) continue;
+        if (!plan_network(&ln, circuit, &order[start[root]], count, (uint32_t)root + 1,
+                          &ln.plan[root])) {
+            fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+            result = -1;
+        }
+        if (ln.plan[root]) accepted++;
+    }
+    free(order);
+    free(start);
+
+    if (result >= 0 && accepted > 0) {
+        // Expressions are no longer needed; free them before the rebuild
+        for (size_t w = 0; w < num_wires; w++) {
+            free(ln.expr[w].data);
+            ln.expr[w].data = NULL;
+        }
+        result = rebuild(&ln, ctx);
+    }
+    linear_free(&ln);
+    return result;
+}
@@ -23,8 +23,12 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 **************************************************************************************************/
 // Modified to compile with MS Visual Studio 6.0 by Alan Mishchenko
+// Modernized core: clause arena, blocking literals, LBD-based learnt clause
+// retention, Luby/glucose restarts and phase saving (after MiniSat 2.2 and Glucose).
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <math.h>
 
@@ -41,15 +45,18 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define L_LIT    "%sx%d"
 #define L_lit(p) lit_sign(p)?"~":"", (lit_var(p))
 
-// Just like 'assert()' but expression will be evaluated in the release version as well.
-static inline void check(int expr) { assert(expr); }
-
-static void printlits(lit* begin, lit* end)
-{
-    int i;
-    for (i = 0; i < end - begin; i++)
-        printf(L_LIT" ",L_lit(begin[i]));
-}
+//=================================================================================================
+// Tuning:
+
+static const double var_decay_factor    = 0.95;
+static const double clause_decay_factor = 0.999;
+static const int    first_reduce        = 2000;  // Conflicts before the first learnt clause reduction.
+static const int    reduce_increment    = 300;   // Growth of the interval between reductions.
+static const int    glue_lbd            = 2;     // Learnt clauses at or below this LBD are kept forever.
+static const int    lbd_window          = 50;    // Conflicts averaged by glucose restarts.
+static const int    trail_window        = 5000;  // Trail sizes averaged to block restarts.
+static const double restart_margin      = 0.8;   // Restart when recent LBD * margin > average LBD.
+static const double blocking_margin     = 1.4;   // Block when the trail is this much over average.
 
 //=================================================================================================
 // Random numbers:
@@ -69,49 +76,82 @@ static inline int irand(double* seed, int size) {
     return (int)(drand(seed) * size); }
 
 
-//=================================================================================================
-// Predeclarations:
-
-void sort(void** array, int size, int(*comp)(const void *, const void *));
+// Finite subsequences of the Luby sequence: 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+static double luby(double y, int x)
+{
+    int size, seq;
+    for (size = 1, seq = 0; size < x+1; seq++, size = 2*size+1);
+    while (size-1 != x){
+        size = (size-1)>>1;
+        seq--;
+        x = x % size;
+    }
+    return pow(y, seq);
+}
 
 //=================================================================================================
 // Clause datatype + minor functions:
 
 struct clause_t
 {
-    int size_learnt;
-    lit lits[0];
+    unsigned header;        // size << 2 | deleted << 1 | learnt
+    unsigned lbd;           // Literal block distance (learnt clauses); forwarding cref during GC.
+    float    activity;      // (learnt clauses)
+    lit      lits[];
 };
 
-static inline int   clause_size       (clause* c)          { return c->size_learnt >> 1; }
-static inline lit*  clause_begin      (clause* c)          { return c->lits; }
-static inline int   clause_learnt     (clause* c)          { return c->size_learnt & 1; }
-static inline float clause_activity   (clause* c)          { return *((float*)&c->lits[c->size_learnt>>1]); }
-static inline void  clause_setactivity(clause* c, float a) { *((float*)&c->lits[c->size_learnt>>1]) = a; }
+#define CLAUSE_WORDS   ((int)(sizeof(clause) / sizeof(unsigned)))
 
-//=================================================================================================
-// Encode literals in clause pointers:
+// Watches of binary clauses are tagged so propagation never visits the clause
+static const cref watch_binary = 0x80000000u;
 
-clause* clause_from_lit (lit l)     { return (clause*)((unsigned long)l + (unsigned long)l + 1);  }
-bool    clause_is_lit   (clause* c) { return ((unsigned long)c & 1);                              }
-lit     clause_read_lit (clause* c) { return (lit)((unsigned long)c >> 1);                        }
+static inline clause* clause_at         (solver* s, cref r)  { return (clause*)(s->arena + r); }
+static inline int     clause_size       (clause* c)          { return (int)(c->header >> 2); }
+static inline lit*    clause_begin      (clause* c)          { return c->lits; }
+static inline int     clause_learnt     (clause* c)          { return c->header & 1; }
+static inline int     clause_deleted    (clause* c)          { return (c->header >> 1) & 1; }
+static inline int     clause_words      (clause* c)          { return CLAUSE_WORDS + clause_size(c); }
 
 //=================================================================================================
 // Simple helpers:
 
 static inline int     solver_dlevel(solver* s)    { return veci_size(&s->trail_lim); }
-static inline vecp*   solver_read_wlist     (solver* s, lit l){ return &s->wlists[l]; }
-static inline void    vecp_remove(vecp* v, void* e)
+static inline lbool   lit_value    (solver* s, lit l) { lbool v = s->assigns[lit_var(l)]; return lit_sign(l) ? -v : v; }
+
+static inline void vecw_push(vecw* v, cref r, lit blocker)
 {
-    void** ws = vecp_begin(v);
-    int    j  = 0;
+    if (v->size == v->cap) {
+        int newsize = v->cap * 2+1;
+        v->ptr = (watcher*)realloc(v->ptr,sizeof(watcher)*newsize);
+        v->cap = newsize; }
+    v->ptr[v->size].ref     = r;
+    v->ptr[v->size].blocker = blocker;
+    v->size++;
+}
 
-    for (; ws[j] != e  ; j++);
-    assert(j < vecp_size(v));
-    for (; j < vecp_size(v)-1; j++) ws[j] = ws[j+1];
-    vecp_resize(v,vecp_size(v)-1);
+static void bqueue_new(bqueue* q, int cap)
+{
+    q->elems = (int*)malloc(sizeof(int)*cap);
+    q->cap   = cap;
+    q->size  = q->head = 0;
+    q->sum   = 0;
+}
+
+static inline void bqueue_push(bqueue* q, int x)
+{
+    if (q->size == q->cap){
+        q->sum -= q->elems[q->head];
+        q->elems[q->head] = x;
+        q->head = (q->head + 1) % q->cap;
+    }else
+        q->elems[(q->head + q->size++) % q->cap] = x;
+    q->sum += x;
 }
 
+static inline int    bqueue_full (bqueue* q) { return q->size == q->cap; }
+static inline double bqueue_avg  (bqueue* q) { return q->size ? (double)q->sum / q->size : 0.0; }
+static inline void   bqueue_clear(bqueue* q) { q->size = q->head = 0; q->sum = 0; }
+
 //=================================================================================================
 // Variable order functions:
 
@@ -136,10 +176,6 @@ static inline void order_update(solver* s, int v) // updateorder
     orderpos[x] = i;
 }
 
-static inline void order_assigned(solver* s, int v) 
-{
-}
-
 static inline void order_unassigned(solver* s, int v) // undoorder
 {
     int* orderpos = s->orderpos;
@@ -150,7 +186,7 @@ static inline void order_unassigned(solver* s, int v) // undoorder
     }
 }
 
-static int  order_select(solver* s, float random_var_freq) // selectvar
+static int  order_select(solver* s) // selectvar
 {
     int*    heap;
     double* activity;
@@ -159,7 +195,7 @@ static int  order_select(solver* s, float random_var_freq) // selectvar
     lbool* values = s->assigns;
 
     // Random decision:
-    if (drand(&s->random_seed) < random_var_freq){
+    if (s->random_var_freq > 0 && drand(&s->random_seed) < s->random_var_freq){
         int next = irand(&s->random_seed,s->size);
         assert(next >= 0 && next < s->size);
         if (values[next] == l_Undef)
@@ -214,6 +250,17 @@ static int  order_select(solver* s, float random_var_freq) // selectvar
     return var_Undef;
 }
 
+// Decision literal for v under the phase policy
+static inline lit order_phase(solver* s, int v)
+{
+    switch (s->phase_mode){
+    case phase_true:   return toLit(v);
+    case phase_false:  return lit_neg(toLit(v));
+    case phase_random: return drand(&s->random_seed) < 0.5 ? toLit(v) : lit_neg(toLit(v));
+    default:           return s->polarity[v] == l_True ? toLit(v) : lit_neg(toLit(v));
+    }
+}
+
 //=================================================================================================
 // Activity functions:
 
@@ -230,8 +277,6 @@ static inline void act_var_bump(solver* s, int v) {
     if ((activity[v] += s->var_inc) > 1e100)
         act_var_rescale(s);
 
-    //printf("bump %d %f\n", v-1, activity[v]);
-
     if (s->orderpos[v] != -1)
         order_update(s,v);
 
@@ -240,79 +285,98 @@ static inline void act_var_bump(solver* s, int v) {
 static inline void act_var_decay(solver* s) { s->var_inc *= s->var_decay; }
 
 static inline void act_clause_rescale(solver* s) {
-    clause** cs = (clause**)vecp_begin(&s->learnts);
+    int* learnts = veci_begin(&s->learnts);
     int i;
-    for (i = 0; i < vecp_size(&s->learnts); i++){
-        float a = clause_activity(cs[i]);
-        clause_setactivity(cs[i], a * (float)1e-20);
-    }
+    for (i = 0; i < veci_size(&s->learnts); i++)
+        clause_at(s,(cref)learnts[i])->activity *= (float)1e-20;
     s->cla_inc *= (float)1e-20;
 }
 
 
 static inline void act_clause_bump(solver* s, clause *c) {
-    float a = clause_activity(c) + s->cla_inc;
-    clause_setactivity(c,a);
-    if (a > 1e20) act_clause_rescale(s);
+    if ((c->activity += s->cla_inc) > 1e20)
+        act_clause_rescale(s);
 }
 
 static inline void act_clause_decay(solver* s) { s->cla_inc *= s->cla_decay; }
 
+// Number of distinct decision levels among the literals
+static unsigned lbd_compute(solver* s, lit* lits, int size)
+{
+    unsigned* stamp = s->lbd_stamp;
+    unsigned  lbd   = 0;
+    int       i;
+
+    if (++s->lbd_counter == 0){
+        memset(stamp, 0, sizeof(unsigned)*s->lbd_stamp_size);
+        s->lbd_counter = 1;
+    }
+    for (i = 0; i < size; i++){
+        int lev = s->levels[lit_var(lits[i])];
+        if (stamp[lev] != s->lbd_counter){
+            stamp[lev] = s->lbd_counter;
+            lbd++;
+        }
+    }
+    return lbd;
+}
 
 //=================================================================================================
-// Clause functions:
+// Clause arena:
+
+static cref arena_alloc(solver* s, int words)
+{
+    cref r;
+    if (s->arena_size + words > s->arena_cap){
+        int cap = s->arena_cap ? s->arena_cap : 1024;
+        while (s->arena_size + words > cap)
+            cap += cap / 2;
+        assert((unsigned)cap < watch_binary);
+        s->arena     = (unsigned*)realloc(s->arena, sizeof(unsigned)*cap);
+        s->arena_cap = cap;
+    }
+    r              = (cref)s->arena_size;
+    s->arena_size += words;
+    return r;
+}
+
+static void clause_attach(solver* s, cref r)
+{
+    clause* c    = clause_at(s,r);
+    lit*    lits = clause_begin(c);
+    cref    tag  = clause_size(c) == 2 ? watch_binary : 0;
+
+    assert(lit_neg(lits[0]) < s->size*2);
+    assert(lit_neg(lits[1]) < s->size*2);
+    vecw_push(&s->wlists[lit_neg(lits[0])], r | tag, lits[1]);
+    vecw_push(&s->wlists[lit_neg(lits[1])], r | tag, lits[0]);
+}
 
 /* pre: size > 1 && no variable occurs twice
  */
-static clause* clause_new(solver* s, lit* begin, lit* end, int learnt)
+static cref clause_new(solver* s, lit* begin, lit* end, int learnt)
 {
-    int size;
+    int     size = end - begin;
+    cref    r;
     clause* c;
-    int i;
 
-    assert(end - begin > 1);
+    assert(size > 1);
     assert(learnt >= 0 && learnt < 2);
-    size           = end - begin;
-    c              = (clause*)malloc(sizeof(clause) + sizeof(lit) * size + learnt * sizeof(float));
-    c->size_learnt = (size << 1) | learnt;
-    assert(((unsigned int)c & 1) == 0);
-
-    for (i = 0; i < size; i++)
-        c->lits[i] = begin[i];
-
-    if (learnt)
-        *((float*)&c->lits[size]) = 0.0;
-
-    assert(begin[0] >= 0);
-    assert(begin[0] < s->size*2);
-    assert(begin[1] >= 0);
-    assert(begin[1] < s->size*2);
-
-    assert(lit_neg(begin[0]) < s->size*2);
-    assert(lit_neg(begin[1]) < s->size*2);
-
-    //vecp_push(solver_read_wlist(s,lit_neg(begin[0])),(void*)c);
-    //vecp_push(solver_read_wlist(s,lit_neg(begin[1])),(void*)c);
-
-    vecp_push(solver_read_wlist(s,lit_neg(begin[0])),(void*)(size > 2 ? c : clause_from_lit(begin[1])));
-    vecp_push(solver_read_wlist(s,lit_neg(begin[1])),(void*)(size > 2 ? c : clause_from_lit(begin[0])));
-
-    return c;
+    r           = arena_alloc(s, CLAUSE_WORDS + size);
+    c           = clause_at(s,r);
+    c->header   = ((unsigned)size << 2) | (unsigned)learnt;
+    c->lbd      = 0;
+    c->activity = 0;
+    memcpy(c->lits, begin, sizeof(lit)*size);
+
+    clause_attach(s,r);
+    return r;
 }
 
-
-static void clause_remove(solver* s, clause* c)
+// Marks the clause removed; its watches go at the next solver_clean_watches()
+static void clause_remove(solver* s, cref r)
 {
-    lit* lits = clause_begin(c);
-    assert(lit_neg(lits[0]) < s->size*2);
-    assert(lit_neg(lits[1]) < s->size*2);
-
-    //vecp_remove(solver_read_wlist(s,lit_neg(lits[0])),(void*)c);
-    //vecp_remove(solver_read_wlist(s,lit_neg(lits[1])),(void*)c);
-
-    assert(lits[0] < s->size*2);
-    vecp_remove(solver_read_wlist(s,lit_neg(lits[0])),(void*)(clause_size(c) > 2 ? c : clause_from_lit(lits[1])));
-    vecp_remove(solver_read_wlist(s,lit_neg(lits[1])),(void*)(clause_size(c) > 2 ? c : clause_from_lit(lits[0])));
+    clause* c = clause_at(s,r);
 
     if (clause_learnt(c)){
         s->stats.learnts--;
@@ -322,26 +386,97 @@ static void clause_remove(solver* s, clause* c)
         s->stats.clauses_literals -= clause_size(c);
     }
 
-    free(c);
+    c->header       |= 2;
+    s->arena_wasted += clause_words(c);
 }
 
+// True if the clause is the reason of one of its literals
+static inline bool clause_locked(solver* s, cref r)
+{
+    lit* lits = clause_begin(clause_at(s,r));
+    if (s->reasons[lit_var(lits[0])] == r && lit_value(s,lits[0]) == l_True)
+        return true;
+    return clause_size(clause_at(s,r)) == 2 && s->reasons[lit_var(lits[1])] == r && lit_value(s,lits[1]) == l_True;
+}
 
 static lbool clause_simplify(solver* s, clause* c)
 {
-    lit*   lits   = clause_begin(c);
-    lbool* values = s->assigns;
-    int i;
+    lit* lits = clause_begin(c);
+    int  i;
 
     assert(solver_dlevel(s) == 0);
 
     for (i = 0; i < clause_size(c); i++){
-        lbool sig = !lit_sign(lits[i]); sig += sig - 1;
-        if (values[lit_var(lits[i])] == sig)
+        if (lit_value(s,lits[i]) == l_True)
             return l_True;
     }
     return l_False;
 }
 
+// Drops the watches of removed clauses
+static void solver_clean_watches(solver* s)
+{
+    int l;
+    for (l = 0; l < s->size*2; l++){
+        vecw*    ws = &s->wlists[l];
+        watcher* w  = ws->ptr;
+        int      i, j;
+        for (i = j = 0; i < ws->size; i++)
+            if (!clause_deleted(clause_at(s, w[i].ref & ~watch_binary)))
+                w[j++] = w[i];
+        ws->size = j;
+    }
+}
+
+static void relocate_list(solver* s, veci* list, unsigned* to, int* size)
+{
+    int* refs = veci_begin(list);
+    int  i;
+    for (i = 0; i < veci_size(list); i++){
+        clause* c = clause_at(s,(cref)refs[i]);
+        int     n = clause_words(c);
+        memcpy(to + *size, c, sizeof(unsigned)*n);
+        c->lbd    = (unsigned)*size;     // forwarding reference
+        refs[i]   = *size;
+        *size    += n;
+    }
+}
+
+// Compacts the arena once removed clauses hold a fifth of it
+static void solver_collect_garbage(solver* s)
+{
+    unsigned* to;
+    int       size = 0;
+    int       l, i;
+
+    if (s->arena_wasted * 5 < s->arena_size)
+        return;
+
+    solver_clean_watches(s);
+    to = (unsigned*)malloc(sizeof(unsigned)*(s->arena_size - s->arena_wasted + 1));
+    relocate_list(s, &s->clauses, to, &size);
+    relocate_list(s, &s->learnts, to, &size);
+
+    for (l = 0; l < s->size*2; l++){
+        vecw* ws = &s->wlists[l];
+        for (i = 0; i < ws->size; i++){
+            cref tag      = ws->ptr[i].ref & watch_binary;
+            ws->ptr[i].ref = clause_at(s, ws->ptr[i].ref & ~watch_binary)->lbd | tag;
+        }
+    }
+    for (i = 0; i < s->qtail; i++){
+        int v = lit_var(s->trail[i]);
+        if (s->reasons[v] != cref_Undef)
+            s->reasons[v] = clause_at(s,s->reasons[v])->lbd;
+    }
+
+    free(s->arena);
+    s->arena        = to;
+    s->arena_size   = size;
+    s->arena_cap    = size + 1;
+    s->arena_wasted = 0;
+}
+
 //=================================================================================================
 // Minor (solver) functions:
 
@@ -353,23 +488,27 @@ void solver_setnvars(solver* s,int n)
 
         while (s->cap < n) s->cap = s->cap*2+1;
 
-        s->wlists    = (vecp*)   realloc(s->wlists,   sizeof(vecp)*s->cap*2);
+        s->wlists    = (vecw*)   realloc(s->wlists,   sizeof(vecw)*s->cap*2);
         s->activity  = (double*) realloc(s->activity, sizeof(double)*s->cap);
         s->assigns   = (lbool*)  realloc(s->assigns,  sizeof(lbool)*s->cap);
+        s->polarity  = (lbool*)  realloc(s->polarity, sizeof(lbool)*s->cap);
         s->orderpos  = (int*)    realloc(s->orderpos, sizeof(int)*s->cap);
-        s->reasons   = (clause**)realloc(s->reasons,  sizeof(clause*)*s->cap);
+        s->reasons   = (cref*)   realloc(s->reasons,  sizeof(cref)*s->cap);
         s->levels    = (int*)    realloc(s->levels,   sizeof(int)*s->cap);
         s->tags      = (lbool*)  realloc(s->tags,     sizeof(lbool)*s->cap);
         s->trail     = (lit*)    realloc(s->trail,    sizeof(lit)*s->cap);
     }
 
     for (var = s->size; var < n; var++){
-        vecp_new(&s->wlists[2*var]);
-        vecp_new(&s->wlists[2*var+1]);
+        s->wlists[2*var].size   = s->wlists[2*var].cap   = 0;
+        s->wlists[2*var].ptr    = 0;
+        s->wlists[2*var+1].size = s->wlists[2*var+1].cap = 0;
+        s->wlists[2*var+1].ptr  = 0;
         s->activity [var] = 0;
         s->assigns  [var] = l_Undef;
+        s->polarity [var] = l_False;
         s->orderpos [var] = veci_size(&s->order);
-        s->reasons  [var] = (clause*)0;
+        s->reasons  [var] = cref_Undef;
         s->levels   [var] = 0;
         s->tags     [var] = l_Undef;
         
@@ -384,7 +523,7 @@ void solver_setnvars(solver* s,int n)
 }
 
 
-static inline bool enqueue(solver* s, lit l, clause* from)
+static inline bool enqueue(solver* s, lit l, cref from)
 {
     lbool* values = s->assigns;
     int    v      = lit_var(l);
@@ -401,15 +540,10 @@ static inline bool enqueue(solver* s, lit l, clause* from)
 #ifdef VERBOSEDEBUG
         printf(L_IND"bind("L_LIT")\n", L_ind, L_lit(l));
 #endif
-        int*     levels  = s->levels;
-        clause** reasons = s->reasons;
-
-        values [v] = sig;
-        levels [v] = solver_dlevel(s);
-        reasons[v] = from;
+        values   [v] = sig;
+        s->levels[v] = solver_dlevel(s);
+        s->reasons[v] = from;
         s->trail[s->qtail++] = l;
-
-        order_assigned(s, v);
         return true;
     }
 }
@@ -422,14 +556,14 @@ static inline void assume(solver* s, lit l){
     printf(L_IND"assume("L_LIT")\n", L_ind, L_lit(l));
 #endif
     veci_push(&s->trail_lim,s->qtail);
-    enqueue(s,l,(clause*)0);
+    enqueue(s,l,cref_Undef);
 }
 
 
 static inline void solver_canceluntil(solver* s, int level) {
     lit*     trail;   
     lbool*   values;  
-    clause** reasons; 
+    cref*    reasons; 
     int      bound;
     int      c;
     
@@ -443,28 +577,32 @@ static inline void solver_canceluntil(solver* s, int level) {
 
     for (c = s->qtail-1; c >= bound; c--) {
         int     x  = lit_var(trail[c]);
+        s->polarity[x] = values[x];
         values [x] = l_Undef;
-        reasons[x] = (clause*)0;
+        reasons[x] = cref_Undef;
+        order_unassigned(s,x);
     }
 
-    for (c = s->qhead-1; c >= bound; c--)
-        order_unassigned(s,lit_var(trail[c]));
-
     s->qhead = s->qtail = bound;
     veci_resize(&s->trail_lim,level);
 }
 
-static void solver_record(solver* s, veci* cls)
+static void solver_record(solver* s, veci* cls, unsigned lbd)
 {
     lit*    begin = veci_begin(cls);
     lit*    end   = begin + veci_size(cls);
-    clause* c     = (veci_size(cls) > 1) ? clause_new(s,begin,end,1) : (clause*)0;
-    enqueue(s,*begin,c);
+    cref    r     = (veci_size(cls) > 1) ? clause_new(s,begin,end,1) : cref_Undef;
+    enqueue(s,*begin,r);
 
     assert(veci_size(cls) > 0);
 
-    if (c != 0) {
-        vecp_push(&s->learnts,c);
+    if (s->export_learnt && veci_size(cls) <= s->export_max_size && lbd <= (unsigned)glue_lbd)
+        s->export_learnt(s->hook_ctx, begin, veci_size(cls));
+
+    if (r != cref_Undef) {
+        clause* c = clause_at(s,r);
+        c->lbd = lbd;
+        veci_push(&s->learnts,(int)r);
         act_clause_bump(s,c);
         s->stats.learnts++;
         s->stats.learnts_literals += veci_size(cls);
@@ -489,125 +627,106 @@ static double solver_progress(solver* s)
 //=================================================================================================
 // Major methods:
 
-static bool solver_lit_removable(solver* s, lit l, int minl)
+static inline unsigned abstract_level(solver* s, int v) { return 1u << (s->levels[v] & 31); }
+
+static bool solver_lit_removable(solver* s, lit l, unsigned minl)
 {
     lbool*   tags    = s->tags;
-    clause** reasons = s->reasons;
+    cref*    reasons = s->reasons;
     int*     levels  = s->levels;
     int      top     = veci_size(&s->tagged);
 
     assert(lit_var(l) >= 0 && lit_var(l) < s->size);
-    assert(reasons[lit_var(l)] != 0);
+    assert(reasons[lit_var(l)] != cref_Undef);
     veci_resize(&s->stack,0);
     veci_push(&s->stack,lit_var(l));
 
     while (veci_size(&s->stack) > 0){
         clause* c;
-        int v = veci_begin(&s->stack)[veci_size(&s->stack)-1];
+        lit*    lits;
+        int     i, j;
+        int     v = veci_begin(&s->stack)[veci_size(&s->stack)-1];
         assert(v >= 0 && v < s->size);
         veci_resize(&s->stack,veci_size(&s->stack)-1);
-        assert(reasons[v] != 0);
-        c    = reasons[v];
-
-        if (clause_is_lit(c)){
-            int v = lit_var(clause_read_lit(c));
-            if (tags[v] == l_Undef && levels[v] != 0){
-                if (reasons[v] != 0 && ((1 << (levels[v] & 31)) & minl)){
-                    veci_push(&s->stack,v);
-                    tags[v] = l_True;
-                    veci_push(&s->tagged,v);
+        assert(reasons[v] != cref_Undef);
+        c    = clause_at(s,reasons[v]);
+        lits = clause_begin(c);
+
+        // The implied literal itself is already tagged
+        for (i = 0; i < clause_size(c); i++){
+            int u = lit_var(lits[i]);
+            if (tags[u] == l_Undef && levels[u] != 0){
+                if (reasons[u] != cref_Undef && (abstract_level(s,u) & minl)){
+                    veci_push(&s->stack,u);
+                    tags[u] = l_True;
+                    veci_push(&s->tagged,u);
                 }else{
                     int* tagged = veci_begin(&s->tagged);
-                    int j;
                     for (j = top; j < veci_size(&s->tagged); j++)
                         tags[tagged[j]] = l_Undef;
                     veci_resize(&s->tagged,top);
                     return false;
                 }
             }
-        }else{
-            lit*    lits = clause_begin(c);
-            int     i, j;
-
-            for (i = 1; i < clause_size(c); i++){
-                int v = lit_var(lits[i]);
-                if (tags[v] == l_Undef && levels[v] != 0){
-                    if (reasons[v] != 0 && ((1 << (levels[v] & 31)) & minl)){
-
-                        veci_push(&s->stack,lit_var(lits[i]));
-                        tags[v] = l_True;
-                        veci_push(&s->tagged,v);
-                    }else{
-                        int* tagged = veci_begin(&s->tagged);
-                        for (j = top; j < veci_size(&s->tagged); j++)
-                            tags[tagged[j]] = l_Undef;
-                        veci_resize(&s->tagged,top);
-                        return false;
-                    }
-                }
-            }
         }
     }
 
     return true;
 }
 
-static void solver_analyze(solver* s, clause* c, veci* learnt)
+// Derives the first-UIP clause of a conflict; returns its LBD
+static unsigned solver_analyze(solver* s, cref confl, veci* learnt)
 {
     lit*     trail   = s->trail;
     lbool*   tags    = s->tags;
-    clause** reasons = s->reasons;
+    cref*    reasons = s->reasons;
     int*     levels  = s->levels;
     int      cnt     = 0;
     lit      p       = lit_Undef;
     int      ind     = s->qtail-1;
     lit*     lits;
-    int      i, j, minl;
+    int      i, j;
+    unsigned minl, lbd;
     int*     tagged;
 
     veci_push(learnt,lit_Undef);
 
     do{
-        assert(c != 0);
-
-        if (clause_is_lit(c)){
-            lit q = clause_read_lit(c);
-            assert(lit_var(q) >= 0 && lit_var(q) < s->size);
-            if (tags[lit_var(q)] == l_Undef && levels[lit_var(q)] > 0){
-                tags[lit_var(q)] = l_True;
-                veci_push(&s->tagged,lit_var(q));
-                act_var_bump(s,lit_var(q));
-                if (levels[lit_var(q)] == solver_dlevel(s))
+        clause* c;
+        assert(confl != cref_Undef);
+        c = clause_at(s,confl);
+
+        if (clause_learnt(c)){
+            act_clause_bump(s,c);
+            // Clauses that keep taking part in conflicts earn a better LBD
+            if (c->lbd > (unsigned)glue_lbd){
+                unsigned nblevels = lbd_compute(s, clause_begin(c), clause_size(c));
+                if (nblevels + 1 < c->lbd)
+                    c->lbd = nblevels;
+            }
+        }
+
+        // The literal implied by this clause (p) is already tagged
+        lits = clause_begin(c);
+        for (j = 0; j < clause_size(c); j++){
+            lit q = lits[j];
+            int v = lit_var(q);
+            assert(v >= 0 && v < s->size);
+            if (tags[v] == l_Undef && levels[v] > 0){
+                tags[v] = l_True;
+                veci_push(&s->tagged,v);
+                act_var_bump(s,v);
+                if (levels[v] == solver_dlevel(s))
                     cnt++;
                 else
                     veci_push(learnt,q);
             }
-        }else{
-
-            if (clause_learnt(c))
-                act_clause_bump(s,c);
-
-            lits = clause_begin(c);
-            //printlits(lits,lits+clause_size(c)); printf("\n");
-            for (j = (p == lit_Undef ? 0 : 1); j < clause_size(c); j++){
-                lit q = lits[j];
-                assert(lit_var(q) >= 0 && lit_var(q) < s->size);
-                if (tags[lit_var(q)] == l_Undef && levels[lit_var(q)] > 0){
-                    tags[lit_var(q)] = l_True;
-                    veci_push(&s->tagged,lit_var(q));
-                    act_var_bump(s,lit_var(q));
-                    if (levels[lit_var(q)] == solver_dlevel(s))
-                        cnt++;
-                    else
-                        veci_push(learnt,q);
-                }
-            }
         }
 
         while (tags[lit_var(trail[ind--])] == l_Undef);
 
-        p = trail[ind+1];
-        c = reasons[lit_var(p)];
+        p     = trail[ind+1];
+        confl = reasons[lit_var(p)];
         cnt--;
 
     }while (cnt > 0);
@@ -616,14 +735,12 @@ static void solver_analyze(solver* s, clause* c, veci* learnt)
 
     lits = veci_begin(learnt);
     minl = 0;
-    for (i = 1; i < veci_size(learnt); i++){
-        int lev = levels[lit_var(lits[i])];
-        minl    |= 1 << (lev & 31);
-    }
+    for (i = 1; i < veci_size(learnt); i++)
+        minl |= abstract_level(s, lit_var(lits[i]));
 
     // simplify (full)
     for (i = j = 1; i < veci_size(learnt); i++){
-        if (reasons[lit_var(lits[i])] == 0 || !solver_lit_removable(s,lits[i],minl))
+        if (reasons[lit_var(lits[i])] == cref_Undef || !solver_lit_removable(s,lits[i],minl))
             lits[j++] = lits[i];
     }
 
@@ -668,208 +785,289 @@ static void solver_analyze(solver* s, clause* c, veci* learnt)
         printf(" } at level %d\n", lev);
     }
 #endif
+
+    lbd = lbd_compute(s, lits, veci_size(learnt));
+    return lbd;
 }
 
 
-clause* solver_propagate(solver* s)
+static cref solver_propagate(solver* s)
 {
-    lbool*  values = s->assigns;
-    clause* confl  = (clause*)0;
-    lit*    lits;
+    cref    confl  = cref_Undef;
 
-    //printf("solver_propagate\n");
-    while (confl == 0 && s->qtail - s->qhead > 0){
-        lit  p  = s->trail[s->qhead++];
-        vecp* ws = solver_read_wlist(s,p);
-        clause **begin = (clause**)vecp_begin(ws);
-        clause **end   = begin + vecp_size(ws);
-        clause **i, **j;
+    while (confl == cref_Undef && s->qtail - s->qhead > 0){
+        lit      p         = s->trail[s->qhead++];
+        lit      false_lit = lit_neg(p);
+        vecw*    ws        = &s->wlists[p];
+        watcher* begin     = ws->ptr;
+        watcher* end       = begin + ws->size;
+        watcher  *i, *j;
 
         s->stats.propagations++;
         s->simpdb_props--;
 
-        //printf("checking lit %d: "L_LIT"\n", veci_size(ws), L_lit(p));
         for (i = j = begin; i < end; ){
-            if (clause_is_lit(*i)){
-                *j++ = *i;
-                if (!enqueue(s,clause_read_lit(*i),clause_from_lit(p))){
-                    confl = s->binary;
-                    (clause_begin(confl))[1] = lit_neg(p);
-                    (clause_begin(confl))[0] = clause_read_lit(*i++);
-
-                    // Copy the remaining watches:
+            lit     blocker = i->blocker;
+            lbool   bval    = lit_value(s,blocker);
+            cref    r;
+            clause* c;
+            lit*    lits;
+            lit     first;
+            int     k, size;
+
+            // Satisfied by the blocking literal: the clause stays in the cache
+            if (bval == l_True){
+                *j++ = *i++;
+                continue;
+            }
+
+            if (i->ref & watch_binary){
+                r    = i->ref & ~watch_binary;
+                *j++ = *i++;
+                if (bval == l_False){
+                    confl = r;
                     while (i < end)
                         *j++ = *i++;
-                }
-            }else{
-                lit false_lit;
-                lbool sig;
+                }else
+                    enqueue(s,blocker,r);
+                continue;
+            }
 
-                lits = clause_begin(*i);
+            // Make sure the false literal is lits[1]:
+            r    = i->ref;
+            c    = clause_at(s,r);
+            lits = clause_begin(c);
+            if (lits[0] == false_lit){
+                lits[0] = lits[1];
+                lits[1] = false_lit;
+            }
+            assert(lits[1] == false_lit);
+            i++;
 
-                // Make sure the false literal is data[1]:
-                false_lit = lit_neg(p);
-                if (lits[0] == false_lit){
-                    lits[0] = lits[1];
-                    lits[1] = false_lit;
-                }
-                assert(lits[1] == false_lit);
-                //printf("checking clause: "); printlits(lits, lits+clause_size(*i)); printf("\n");
+            // If 0th watch is true, then clause is already satisfied.
+            first = lits[0];
+            if (first != blocker && lit_value(s,first) == l_True){
+                j->ref     = r;
+                j->blocker = first;
+                j++;
+                continue;
+            }
 
-                // If 0th watch is true, then clause is already satisfied.
-                sig = !lit_sign(lits[0]); sig += sig - 1;
-                if (values[lit_var(lits[0])] == sig){
-                    *j++ = *i;
-                }else{
-                    // Look for new watch:
-                    lit* stop = lits + clause_size(*i);
-                    lit* k;
-                    for (k = lits + 2; k < stop; k++){
-                        lbool sig = lit_sign(*k); sig += sig - 1;
-                        if (values[lit_var(*k)] != sig){
-                            lits[1] = *k;
-                            *k = false_lit;
-                            vecp_push(solver_read_wlist(s,lit_neg(lits[1])),*i);
-                            goto next; }
-                    }
-
-                    *j++ = *i;
-                    // Clause is unit under assignment:
-                    if (!enqueue(s,lits[0], *i)){
-                        confl = *i++;
-                        // Copy the remaining watches:
-                        while (i < end)
-                            *j++ = *i++;
-                    }
+            // Look for new watch:
+            size = clause_size(c);
+            for (k = 2; k < size; k++){
+                if (lit_value(s,lits[k]) != l_False){
+                    lits[1] = lits[k];
+                    lits[k] = false_lit;
+                    vecw_push(&s->wlists[lit_neg(lits[1])], r, first);
+                    goto next;
                 }
             }
-        next:
-            i++;
+
+            // Clause is unit under assignment:
+            j->ref     = r;
+            j->blocker = first;
+            j++;
+            if (lit_value(s,first) == l_False){
+                confl = r;
+                // Copy the remaining watches:
+                while (i < end)
+                    *j++ = *i++;
+            }else
+                enqueue(s,first,r);
+        next:;
         }
 
-        s->stats.inspects += j - (clause**)vecp_begin(ws);
-        vecp_resize(ws,j - (clause**)vecp_begin(ws));
+        s->stats.inspects += j - ws->ptr;
+        ws->size = j - ws->ptr;
     }
 
     return confl;
 }
 
-static inline int clause_cmp (const void* x, const void* y) {
-    return clause_size((clause*)x) > 2 && (clause_size((clause*)y) == 2 || clause_activity((clause*)x) < clause_activity((clause*)y)) ? -1 : 1; }
+// Learnt clauses in deletion order: highest LBD, then least active, first
+struct learnt_rank_t { cref ref; unsigned lbd; float activity; };
 
-void solver_reducedb(solver* s)
+static int learnt_rank_cmp(const void* x, const void* y)
 {
-    int      i, j;
-    double   extra_lim = s->cla_inc / vecp_size(&s->learnts); // Remove any clause below this activity
-    clause** learnts = (clause**)vecp_begin(&s->learnts);
-    clause** reasons = s->reasons;
+    const struct learnt_rank_t* a = (const struct learnt_rank_t*)x;
+    const struct learnt_rank_t* b = (const struct learnt_rank_t*)y;
+    if (a->lbd != b->lbd) return a->lbd > b->lbd ? -1 : 1;
+    if (a->activity != b->activity) return a->activity < b->activity ? -1 : 1;
+    return a->ref < b->ref ? -1 : (a->ref > b->ref);
+}
 
-    sort(vecp_begin(&s->learnts), vecp_size(&s->learnts), &clause_cmp);
+// Removes half of the learnt clauses, sparing glue clauses and reasons
+static void solver_reducedb(solver* s)
+{
+    int   n       = veci_size(&s->learnts);
+    int*  learnts = veci_begin(&s->learnts);
+    struct learnt_rank_t* rank;
+    int   i, j, removed = 0;
+
+    rank = (struct learnt_rank_t*)malloc(sizeof(struct learnt_rank_t)*(n+1));
+    for (i = 0; i < n; i++){
+        clause* c = clause_at(s,(cref)learnts[i]);
+        rank[i].ref      = (cref)learnts[i];
+        rank[i].lbd      = c->lbd;
+        rank[i].activity = c->activity;
+    }
+    qsort(rank, n, sizeof(struct learnt_rank_t), learnt_rank_cmp);
 
-    for (i = j = 0; i < vecp_size(&s->learnts) / 2; i++){
-        if (clause_size(learnts[i]) > 2 && reasons[lit_var(*clause_begin(learnts[i]))] != learnts[i])
-            clause_remove(s,learnts[i]);
-        else
-            learnts[j++] = learnts[i];
+    for (i = 0; i < n && removed < n / 2; i++){
+        clause* c = clause_at(s,rank[i].ref);
+        if (c->lbd <= (unsigned)glue_lbd)
+            break;
+        if (clause_size(c) > 2 && !clause_locked(s,rank[i].ref)){
+            clause_remove(s,rank[i].ref);
+            removed++;
+        }
     }
-    for (; i < vecp_size(&s->learnts); i++){
-        if (clause_size(learnts[i]) > 2 && reasons[lit_var(*clause_begin(learnts[i]))] != learnts[i] && clause_activity(learnts[i]) < extra_lim)
-            clause_remove(s,learnts[i]);
-        else
+    free(rank);
+
+    for (i = j = 0; i < n; i++)
+        if (!clause_deleted(clause_at(s,(cref)learnts[i])))
             learnts[j++] = learnts[i];
-    }
+    veci_resize(&s->learnts,j);
+
+    s->stats.reduces++;
+    solver_clean_watches(s);
+    solver_collect_garbage(s);
+}
 
-    //printf("reducedb deleted %d\n", vecp_size(&s->learnts) - j);
+static inline bool solver_interrupted(solver* s)
+{
+    return s->terminate != 0 && s->terminate(s->hook_ctx);
+}
 
+// True when the restart policy ends the current run
+static bool solver_restart_due(solver* s, int nof_conflicts, int conflictC)
+{
+    if (s->restart_mode != restart_glucose)
+        return nof_conflicts >= 0 && conflictC >= nof_conflicts;
 
-    vecp_resize(&s->learnts,j);
+    // Recent conflicts learn worse clauses than the average so far
+    if (bqueue_full(&s->lbd_queue) &&
+        bqueue_avg(&s->lbd_queue) * restart_margin > (double)s->lbd_total / (double)s->stats.conflicts){
+        bqueue_clear(&s->lbd_queue);
+        return true;
+    }
+    return false;
 }
 
-static lbool solver_search(solver* s, int nof_conflicts, int nof_learnts)
+static lbool solver_search(solver* s, int nof_conflicts, uint64 conflict_end)
 {
     int*    levels          = s->levels;
-    double  var_decay       = 0.95;
-    double  clause_decay    = 0.999;
-    double  random_var_freq = 0.02;
-
     int     conflictC       = 0;
     veci    learnt_clause;
 
-    assert(s->root_level == solver_dlevel(s));
+    assert(solver_dlevel(s) == 0);
 
     s->stats.starts++;
-    s->var_decay = (float)(1 / var_decay   );
-    s->cla_decay = (float)(1 / clause_decay);
+    s->var_decay = (float)(1 / var_decay_factor   );
+    s->cla_decay = (float)(1 / clause_decay_factor);
     veci_resize(&s->model,0);
     veci_new(&learnt_clause);
 
     for (;;){
-        clause* confl = solver_propagate(s);
-        if (confl != 0){
+        cref confl = solver_propagate(s);
+        if (confl != cref_Undef){
             // CONFLICT
-            int blevel;
+            int      blevel;
+            unsigned lbd;
 
 #ifdef VERBOSEDEBUG
             printf(L_IND"**CONFLICT**\n", L_ind);
 #endif
             s->stats.conflicts++; conflictC++;
-            if (solver_dlevel(s) == s->root_level){
+            if (solver_dlevel(s) == 0){
+                s->ok = false;
                 veci_delete(&learnt_clause);
                 return l_False;
             }
 
             veci_resize(&learnt_clause,0);
-            solver_analyze(s, confl, &learnt_clause);
-            blevel = veci_size(&learnt_clause) > 1 ? levels[lit_var(veci_begin(&learnt_clause)[1])] : s->root_level;
-            blevel = s->root_level > blevel ? s->root_level : blevel;
+            lbd    = solver_analyze(s, confl, &learnt_clause);
+            blevel = veci_size(&learnt_clause) > 1 ? levels[lit_var(veci_begin(&learnt_clause)[1])] : 0;
+
+            if (s->restart_mode == restart_glucose){
+                // A conflict deep into the search postpones the next restart
+                bqueue_push(&s->trail_queue, s->qtail);
+                if (s->stats.conflicts > 10000 && bqueue_full(&s->lbd_queue) &&
+                    s->qtail > blocking_margin * bqueue_avg(&s->trail_queue)){
+                    bqueue_clear(&s->lbd_queue);
+                    s->stats.blocked_restarts++;
+                }
+                bqueue_push(&s->lbd_queue, (int)lbd);
+            }
+            s->lbd_total += lbd;
+
             solver_canceluntil(s,blevel);
-            solver_record(s,&learnt_clause);
+            solver_record(s,&learnt_clause,lbd);
             act_var_decay(s);
             act_clause_decay(s);
 
         }else{
             // NO CONFLICT
             int next;
+            lit decision = lit_Undef;
 
-            if (nof_conflicts >= 0 && conflictC >= nof_conflicts){
+            if (s->stats.conflicts >= conflict_end || solver_interrupted(s) ||
+                solver_restart_due(s, nof_conflicts, conflictC)){
                 // Reached bound on number of conflicts:
                 s->progress_estimate = solver_progress(s);
-                solver_canceluntil(s,s->root_level);
+                solver_canceluntil(s,0);
                 veci_delete(&learnt_clause);
                 return l_Undef; }
 
-            if (solver_dlevel(s) == 0)
-                // Simplify the set of problem clauses:
-                solver_simplify(s);
+            if (solver_dlevel(s) == 0){
+                // Take in clauses learnt elsewhere, then simplify the set of problem clauses:
+                if (s->import_learnts)
+                    s->import_learnts(s->hook_ctx, s);
+                if (!solver_simplify(s)){
+                    veci_delete(&learnt_clause);
+                    return l_False; }
+            }
 
-            if (nof_learnts >= 0 && vecp_size(&s->learnts) - s->qtail >= nof_learnts)
+            if (s->stats.conflicts >= s->next_reduce){
                 // Reduce the set of learnt clauses:
+                s->next_reduce = s->stats.conflicts + first_reduce + reduce_increment * (s->stats.reduces + 1);
                 solver_reducedb(s);
+            }
 
-            // New variable decision:
-            s->stats.decisions++;
-            next = order_select(s,(float)random_var_freq);
-
-            if (next == var_Undef){
-                // Model found:
-                lbool* values = s->assigns;
-                int i;
-                for (i = 0; i < s->size; i++) veci_push(&s->model,(int)values[i]);
-                solver_canceluntil(s,s->root_level);
-                veci_delete(&learnt_clause);
-
-                /*
-                veci apa; veci_new(&apa);
-                for (i = 0; i < s->size; i++) 
-                    veci_push(&apa,(int)(s->model.ptr[i] == l_True ? toLit(i) : lit_neg(toLit(i))));
-                printf("model: "); printlits((lit*)apa.ptr, (lit*)apa.ptr + veci_size(&apa)); printf("\n");
-                veci_delete(&apa);
-                */
+            // Assumptions come first, one decision level each
+            while (solver_dlevel(s) < veci_size(&s->assumptions)){
+                lit p = veci_begin(&s->assumptions)[solver_dlevel(s)];
+                if (lit_value(s,p) == l_True)
+                    veci_push(&s->trail_lim,s->qtail);
+                else if (lit_value(s,p) == l_False){
+                    solver_canceluntil(s,0);
+                    veci_delete(&learnt_clause);
+                    return l_False;
+                }else{
+                    decision = p;
+                    break;
+                }
+            }
 
-                return l_True;
+            if (decision == lit_Undef){
+                // New variable decision:
+                s->stats.decisions++;
+                next = order_select(s);
+
+                if (next == var_Undef){
+                    // Model found:
+                    lbool* values = s->assigns;
+                    int i;
+                    for (i = 0; i < s->size; i++) veci_push(&s->model,(int)values[i]);
+                    solver_canceluntil(s,0);
+                    veci_delete(&learnt_clause);
+                    return l_True;
+                }
+                decision = order_phase(s,next);
             }
 
-            assume(s,lit_neg(toLit(next)));
+            assume(s,decision);
         }
     }
 
@@ -884,23 +1082,29 @@ solver* solver_new(void)
     solver* s = (solver*)malloc(sizeof(solver));
 
     // initialize vectors
-    vecp_new(&s->clauses);
-    vecp_new(&s->learnts);
+    veci_new(&s->clauses);
+    veci_new(&s->learnts);
     veci_new(&s->order);
     veci_new(&s->trail_lim);
     veci_new(&s->tagged);
     veci_new(&s->stack);
+    veci_new(&s->assumptions);
     veci_new(&s->model);
+    bqueue_new(&s->lbd_queue, lbd_window);
+    bqueue_new(&s->trail_queue, trail_window);
 
     // initialize arrays
+    s->arena     = 0;
     s->wlists    = 0;
     s->activity  = 0;
     s->assigns   = 0;
+    s->polarity  = 0;
     s->orderpos  = 0;
     s->reasons   = 0;
     s->levels    = 0;
     s->tags      = 0;
     s->trail     = 0;
+    s->lbd_stamp = 0;
 
 
     // initialize other vars
@@ -908,30 +1112,34 @@ solver* solver_new(void)
     s->cap                    = 0;
     s->qhead                  = 0;
     s->qtail                  = 0;
+    s->ok                     = true;
+    s->arena_size             = 0;
+    s->arena_cap              = 0;
+    s->arena_wasted           = 0;
     s->cla_inc                = 1;
     s->cla_decay              = 1;
     s->var_inc                = 1;
     s->var_decay              = 1;
-    s->root_level             = 0;
+    s->lbd_stamp_size         = 0;
+    s->lbd_counter            = 0;
+    s->lbd_total              = 0;
+    s->next_reduce            = first_reduce;
+    s->restart_mode           = restart_glucose;
+    s->phase_mode             = phase_saving;
+    s->restart_unit           = 100;
+    s->random_var_freq        = 0;
+    s->hook_ctx               = 0;
+    s->terminate              = 0;
+    s->export_learnt          = 0;
+    s->import_learnts         = 0;
+    s->export_max_size        = 0;
     s->simpdb_assigns         = 0;
     s->simpdb_props           = 0;
     s->random_seed            = 91648253;
     s->progress_estimate      = 0;
-    s->binary                 = (clause*)malloc(sizeof(clause) + sizeof(lit)*2);
-    s->binary->size_learnt    = (2 << 1);
     s->verbosity              = 0;
 
-    s->stats.starts           = 0;
-    s->stats.decisions        = 0;
-    s->stats.propagations     = 0;
-    s->stats.inspects         = 0;
-    s->stats.conflicts        = 0;
-    s->stats.clauses          = 0;
-    s->stats.clauses_literals = 0;
-    s->stats.learnts          = 0;
-    s->stats.learnts_literals = 0;
-    s->stats.max_literals     = 0;
-    s->stats.tot_literals     = 0;
+    memset(&s->stats, 0, sizeof(s->stats));
 
     return s;
 }
@@ -939,54 +1147,53 @@ solver* solver_new(void)
 
 void solver_delete(solver* s)
 {
-    int i;
-    for (i = 0; i < vecp_size(&s->clauses); i++)
-        free(vecp_begin(&s->clauses)[i]);
-
-    for (i = 0; i < vecp_size(&s->learnts); i++)
-        free(vecp_begin(&s->learnts)[i]);
-
     // delete vectors
-    vecp_delete(&s->clauses);
-    vecp_delete(&s->learnts);
+    veci_delete(&s->clauses);
+    veci_delete(&s->learnts);
     veci_delete(&s->order);
     veci_delete(&s->trail_lim);
     veci_delete(&s->tagged);
     veci_delete(&s->stack);
+    veci_delete(&s->assumptions);
     veci_delete(&s->model);
-    free(s->binary);
+    free(s->lbd_queue.elems);
+    free(s->trail_queue.elems);
+    free(s->arena);
 
     // delete arrays
     if (s->wlists != 0){
         int i;
         for (i = 0; i < s->size*2; i++)
-            vecp_delete(&s->wlists[i]);
+            free(s->wlists[i].ptr);
 
         // if one is different from null, all are
         free(s->wlists);
         free(s->activity );
         free(s->assigns  );
+        free(s->polarity );
         free(s->orderpos );
         free(s->reasons  );
         free(s->levels   );
         free(s->trail    );
         free(s->tags     );
     }
+    free(s->lbd_stamp);
 
     free(s);
 }
 
 
-bool solver_addclause(solver* s, lit* begin, lit* end)
+static bool solver_addclause_as(solver* s, lit* begin, lit* end, int learnt)
 {
     lit *i,*j;
     int maxvar;
-    lbool* values;
     lit last;
+    cref r;
 
-    if (begin == end) return false;
+    assert(solver_dlevel(s) == 0);
+    if (!s->ok) return false;
+    if (begin == end) return s->ok = false;
 
-    //printlits(begin,end); printf("\n");
     // insertion sort
     maxvar = lit_var(*begin);
     for (i = begin + 1; i < end; i++){
@@ -998,66 +1205,79 @@ bool solver_addclause(solver* s, lit* begin, lit* end)
     }
     solver_setnvars(s,maxvar+1);
 
-    //printlits(begin,end); printf("\n");
-    values = s->assigns;
-
     // delete duplicates
     last = lit_Undef;
     for (i = j = begin; i < end; i++){
-        //printf("lit: "L_LIT", value = %d\n", L_lit(*i), (lit_sign(*i) ? -values[lit_var(*i)] : values[lit_var(*i)]));
-        lbool sig = !lit_sign(*i); sig += sig - 1;
-        if (*i == lit_neg(last) || sig == values[lit_var(*i)])
+        lbool val = lit_value(s,*i);
+        if (*i == lit_neg(last) || val == l_True)
             return true;   // tautology
-        else if (*i != last && values[lit_var(*i)] == l_Undef)
+        else if (*i != last && val == l_Undef)
             last = *j++ = *i;
     }
 
-    //printf("final: "); printlits(begin,j); printf("\n");
-
     if (j == begin)          // empty clause
-        return false;
+        return s->ok = false;
     else if (j - begin == 1) // unit clause
-        return enqueue(s,*begin,(clause*)0);
+        return s->ok = enqueue(s,*begin,cref_Undef);
 
     // create new clause
-    vecp_push(&s->clauses,clause_new(s,begin,j,0));
+    r = clause_new(s,begin,j,learnt);
+    if (learnt){
+        clause_at(s,r)->lbd = (unsigned)(j - begin);
+        veci_push(&s->learnts,(int)r);
+        s->stats.learnts++;
+        s->stats.learnts_literals += j - begin;
+    }else{
+        veci_push(&s->clauses,(int)r);
+        s->stats.clauses++;
+        s->stats.clauses_literals += j - begin;
+    }
 
+    return true;
+}
 
-    s->stats.clauses++;
-    s->stats.clauses_literals += j - begin;
 
-    return true;
+bool solver_addclause(solver* s, lit* begin, lit* end)
+{
+    return solver_addclause_as(s, begin, end, 0);
+}
+
+
+// Imported clauses may be reduced away like learnt ones
+bool solver_addlearnt(solver* s, lit* begin, lit* end)
+{
+    return solver_addclause_as(s, begin, end, 1);
 }
 
 
 bool   solver_simplify(solver* s)
 {
-    clause** reasons;
     int type;
 
     assert(solver_dlevel(s) == 0);
 
-    if (solver_propagate(s) != 0)
-        return false;
+    if (!s->ok || solver_propagate(s) != cref_Undef)
+        return s->ok = false;
 
     if (s->qhead == s->simpdb_assigns || s->simpdb_props > 0)
         return true;
 
-    reasons = s->reasons;
     for (type = 0; type < 2; type++){
-        vecp*    cs  = type ? &s->learnts : &s->clauses;
-        clause** cls = (clause**)vecp_begin(cs);
+        veci* cs  = type ? &s->learnts : &s->clauses;
+        int*  cls = veci_begin(cs);
 
         int i, j;
-        for (j = i = 0; i < vecp_size(cs); i++){
-            if (reasons[lit_var(*clause_begin(cls[i]))] != cls[i] &&
-                clause_simplify(s,cls[i]) == l_True)
-                clause_remove(s,cls[i]);
+        for (j = i = 0; i < veci_size(cs); i++){
+            if (!clause_locked(s,(cref)cls[i]) &&
+                clause_simplify(s,clause_at(s,(cref)cls[i])) == l_True)
+                clause_remove(s,(cref)cls[i]);
             else
                 cls[j++] = cls[i];
         }
-        vecp_resize(cs,j);
+        veci_resize(cs,j);
     }
+    solver_clean_watches(s);
+    solver_collect_garbage(s);
 
     s->simpdb_assigns = s->qhead;
     // (shouldn't depend on 'stats' really, but it will do for now)
@@ -1069,38 +1289,51 @@ bool   solver_simplify(solver* s)
 
 bool   solver_solve(solver* s, lit* begin, lit* end)
 {
-    double  nof_conflicts = 100;
-    double  nof_learnts   = solver_nclauses(s) / 3;
+    return solver_solve_limited(s, begin, end, -1) != l_False;
+}
+
+
+// Gives up with l_Undef after max_conflicts conflicts (no limit if negative)
+lbool  solver_solve_limited(solver* s, lit* begin, lit* end, int max_conflicts)
+{
+    uint64  conflict_end  = max_conflicts >= 0 ? s->stats.conflicts + (uint64)max_conflicts : ~(uint64)0;
+    int     restarts      = 0;
     lbool   status        = l_Undef;
-    lbool*  values        = s->assigns;
     lit*    i;
-    
-    //printf("solve: "); printlits(begin, end); printf("\n");
+
+    veci_resize(&s->model,0);
+    if (!s->ok)
+        return l_False;
+
+    // Units added or learnt since the last call may still be queued
+    if (solver_propagate(s) != cref_Undef){
+        s->ok = false;
+        return l_False;
+    }
+
+    veci_resize(&s->assumptions,0);
     for (i = begin; i < end; i++){
-        switch (lit_sign(*i) ? -values[lit_var(*i)] : values[lit_var(*i)]){
-        case 1: /* l_True: */
-            break;
-        case 0: /* l_Undef */
-            assume(s, *i);
-            if (solver_propagate(s) == NULL)
-                break;
-            // falltrough
-        case -1: /* l_False */
-            solver_canceluntil(s, 0);
-            return false;
-        }
+        solver_setnvars(s,lit_var(*i)+1);
+        veci_push(&s->assumptions,*i);
     }
 
-    s->root_level = solver_dlevel(s);
+    // Every variable and assumption may open its own decision level
+    if (s->lbd_stamp_size < s->size + veci_size(&s->assumptions) + 1){
+        s->lbd_stamp_size = 2 * (s->size + veci_size(&s->assumptions) + 1);
+        s->lbd_stamp      = (unsigned*)realloc(s->lbd_stamp, sizeof(unsigned)*s->lbd_stamp_size);
+        memset(s->lbd_stamp, 0, sizeof(unsigned)*s->lbd_stamp_size);
+        s->lbd_counter    = 0;
+    }
 
     if (s->verbosity >= 1){
         printf("==================================[MINISAT]===================================\n");
         printf("| Conflicts |     ORIGINAL     |              LEARNT              | Progress |\n");
-        printf("|           | Clauses Literals |   Limit Clauses Literals  Lit/Cl |          |\n");
+        printf("|           | Clauses Literals |  Reduces Clauses Literals  Lit/Cl |          |\n");
         printf("==============================================================================\n");
     }
 
-    while (status == l_Undef){
+    while (status == l_Undef && s->stats.conflicts < conflict_end && !solver_interrupted(s)){
+        int nof_conflicts = -1;
         double Ratio = (s->stats.learnts == 0)? 0.0 :
             s->stats.learnts_literals / (double)s->stats.learnts;
 
@@ -1109,22 +1342,26 @@ bool   solver_solve(solver* s, lit* begin, lit* end)
                 (double)s->stats.conflicts,
                 (double)s->stats.clauses, 
                 (double)s->stats.clauses_literals,
-                (double)nof_learnts, 
+                (double)s->stats.reduces, 
                 (double)s->stats.learnts, 
                 (double)s->stats.learnts_literals,
                 Ratio,
                 s->progress_estimate*100);
             fflush(stdout);
         }
-        status = solver_search(s,(int)nof_conflicts, (int)nof_learnts);
-        nof_conflicts *= 1.5;
-        nof_learnts   *= 1.1;
+        if (s->restart_mode == restart_luby)
+            nof_conflicts = (int)(luby(2, restarts) * s->restart_unit);
+        else if (s->restart_mode == restart_geometric)
+            nof_conflicts = (int)(pow(1.5, restarts) * s->restart_unit);
+        status = solver_search(s, nof_conflicts, conflict_end);
+        restarts++;
     }
     if (s->verbosity >= 1)
         printf("==============================================================================\n");
 
     solver_canceluntil(s,0);
-    return status != l_False;
+    veci_resize(&s->assumptions,0);
+    return status;
 }
 
 
@@ -1136,7 +1373,7 @@ int solver_nvars(solver* s)
 
 int solver_nclauses(solver* s)
 {
-    return vecp_size(&s->clauses);
+    return veci_size(&s->clauses);
 }
 
 
@@ -1145,52 +1382,10 @@ int solver_nconflicts(solver* s)
     return (int)s->stats.conflicts;
 }
 
-//=================================================================================================
-// Sorting functions (sigh):
-
-static inline void selectionsort(void** array, int size, int(*comp)(const void *, const void *))
-{
-    int     i, j, best_i;
-    void*   tmp;
-
-    for (i = 0; i < size-1; i++){
-        best_i = i;
-        for (j = i+1; j < size; j++){
-            if (comp(array[j], array[best_i]) < 0)
-                best_i = j;
-        }
-        tmp = array[i]; array[i] = array[best_i]; array[best_i] = tmp;
-    }
-}
-
-
-static void sortrnd(void** array, int size, int(*comp)(const void *, const void *), double* seed)
-{
-    if (size <= 15)
-        selectionsort(array, size, comp);
-
-    else{
-        void*       pivot = array[irand(seed, size)];
-        void*       tmp;
-        int         i = -1;
-        int         j = size;
-
-        for(;;){
-            do i++; while(comp(array[i], pivot)<0);
-            do j--; while(comp(pivot, array[j])<0);
-
-            if (i >= j) break;
-
-            tmp = array[i]; array[i] = array[j]; array[j] = tmp;
-        }
-
-        sortrnd(array    , i     , comp, seed);
-        sortrnd(&array[i], size-i, comp, seed);
-    }
-}
 
-void sort(void** array, int size, int(*comp)(const void *, const void *))
+lbool solver_model_value(solver* s, int v)
 {
-    double seed = 91648253;
-    sortrnd(array,size,comp,&seed);
+    if (v < 0 || v >= veci_size(&s->model))
+        return l_Undef;
+    return (lbool)veci_begin(&s->model)[v];
 }
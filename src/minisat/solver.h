@@ -73,8 +73,11 @@ extern solver* solver_new(void);
 extern void    solver_delete(solver* s);
 
 extern bool    solver_addclause(solver* s, lit* begin, lit* end);
+// Adds a clause implied by the others, e.g. learnt by a solver with the same clauses
+extern bool    solver_addlearnt(solver* s, lit* begin, lit* end);
 extern bool    solver_simplify(solver* s);
 extern bool    solver_solve(solver* s, lit* begin, lit* end);
+extern lbool   solver_solve_limited(solver* s, lit* begin, lit* end, int max_conflicts);
 
 extern int     solver_nvars(solver* s);
 extern int     solver_nclauses(solver* s);
@@ -82,29 +85,77 @@ extern int     solver_nconflicts(solver* s);
 
 extern void    solver_setnvars(solver* s,int n);
 
+// Value of a variable in the last model (l_Undef if the last solve found none)
+extern lbool   solver_model_value(solver* s, int v);
+
 struct stats_t
 {
     uint64   starts, decisions, propagations, inspects, conflicts;
     uint64   clauses, clauses_literals, learnts, learnts_literals, max_literals, tot_literals;
+    uint64   reduces, blocked_restarts;
 };
 typedef struct stats_t stats;
 
+//=================================================================================================
+// Search policies (fields of the solver, set between solves):
+
+typedef enum { restart_luby, restart_glucose, restart_geometric } restart_policy;
+typedef enum { phase_saving, phase_false, phase_true, phase_random } phase_policy;
+
 //=================================================================================================
 // Solver representation:
 
 struct clause_t;
 typedef struct clause_t clause;
 
+// Clauses live in one arena of 32-bit words and are referred to by offset
+typedef unsigned int cref;
+static const cref cref_Undef = 0xFFFFFFFFu;
+
+// A watch carries a blocking literal: if it is true the clause need not be visited
+struct watcher_t
+{
+    cref     ref;           // Watched clause (high bit set for binary clauses).
+    lit      blocker;       // Some other literal of the clause.
+};
+typedef struct watcher_t watcher;
+
+struct vecw_t
+{
+    int      size;
+    int      cap;
+    watcher* ptr;
+};
+typedef struct vecw_t vecw;
+
+// Fixed-size window over the most recent values (for glucose restarts)
+struct bqueue_t
+{
+    int*     elems;
+    int      cap;
+    int      size;
+    int      head;
+    uint64   sum;
+};
+typedef struct bqueue_t bqueue;
+
 struct solver_t
 {
     int      size;          // nof variables
     int      cap;           // size of varmaps
     int      qhead;         // Head index of queue.
     int      qtail;         // Tail index of queue.
+    bool     ok;            // False once the clauses are unsatisfiable without assumptions.
+
+    // clause arena
+    unsigned* arena;        // Clause storage. (indexed by: cref)
+    int      arena_size;    // Words in use.
+    int      arena_cap;     // Words allocated.
+    int      arena_wasted;  // Words held by removed clauses, reclaimed by garbage collection.
 
     // clauses
-    vecp     clauses;       // List of problem constraints. (contains: clause*)
-    vecp     learnts;       // List of learnt clauses. (contains: clause*)
+    veci     clauses;       // List of problem constraints. (contains: cref)
+    veci     learnts;       // List of learnt clauses. (contains: cref)
 
     // activities
     double   var_inc;       // Amount to bump next variable with.
@@ -112,24 +163,46 @@ struct solver_t
     float    cla_inc;       // Amount to bump next clause with.
     float    cla_decay;     // INVERSE decay factor for clause activity: stores 1/decay.
 
-    vecp*    wlists;        // 
+    vecw*    wlists;        // Watches of clauses containing ~l, visited when l becomes true.
     double*  activity;      // A heuristic measurement of the activity of a variable.
     lbool*   assigns;       // Current values of variables.
+    lbool*   polarity;      // Last value of each variable (phase saving).
     int*     orderpos;      // Index in variable order.
-    clause** reasons;       //
+    cref*    reasons;       //
     int*     levels;        //
     lit*     trail;
 
-    clause*  binary;        // A temporary binary clause
     lbool*   tags;          //
     veci     tagged;        // (contains: var)
     veci     stack;         // (contains: var)
 
     veci     order;         // Variable order. (heap) (contains: var)
     veci     trail_lim;     // Separator indices for different decision levels in 'trail'. (contains: int)
+    veci     assumptions;   // Literals decided first, one per level, by the current solve.
     veci     model;         // If problem is solved, this vector contains the model (contains: lbool).
 
-    int      root_level;    // Level of first proper decision.
+    // learnt clause quality
+    unsigned* lbd_stamp;    // Last LBD computation that saw each decision level.
+    int      lbd_stamp_size;
+    unsigned lbd_counter;
+    uint64   lbd_total;     // Sum of the LBDs of all learnt clauses.
+    uint64   next_reduce;   // Conflict count of the next learnt clause reduction.
+
+    // search policy
+    restart_policy restart_mode;
+    phase_policy   phase_mode;
+    int      restart_unit;  // Conflicts in the first Luby or geometric run.
+    double   random_var_freq;
+    bqueue   lbd_queue;     // LBDs of recent conflicts.
+    bqueue   trail_queue;   // Trail sizes at recent conflicts.
+
+    // cooperation with other solvers on the same clauses (all optional)
+    void*    hook_ctx;      // Passed to the hooks.
+    int    (*terminate)(void* ctx);                          // Nonzero: give up with l_Undef.
+    void   (*export_learnt)(void* ctx, lit* begin, int size); // Glue clauses up to export_max_size.
+    void   (*import_learnts)(void* ctx, solver* s);          // At level 0; may call solver_addlearnt().
+    int      export_max_size;
+
     int      simpdb_assigns;// Number of top-level assignments at last 'simplifyDB()'.
     int      simpdb_props;  // Number of propagations before next 'simplifyDB()'.
     double   random_seed;
@@ -51,8 +51,9 @@ void test_simple_sat() {
     if (result) {
         printf("SAT! Found satisfying assignment\n");
         
-        // MiniSAT doesn't have a direct way to get assignments in this C version
-        // In practice, would need to extend the API
+        for (int v = 1; v <= 3; v++) {
+            printf("  x%d = %d\n", v, solver_model_value(s, v) == l_True);
+        }
         printf("Solver statistics:\n");
         printf("  Variables: %d\n", solver_nvars(s));
         printf("  Clauses: %d\n", solver_nclauses(s));
@@ -0,0 +1,235 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+// Generated by scripts/gen_npn4_library.c - do not edit.
+// 222 NPN classes. 36674 of the 65536 functions have optimal implementations of
+// at most 7 gates; the rest use Davio splits.
+
+#include "npn4_library.h"
+
+const npn4_impl_t npn4_library[NPN4_NUM_CLASSES] = {
+    {0x0000, 0, 255, {{0, 0, 0}}},
+    {0x8000, 3,   7, {{0, 1, 2}, {0, 0, 3}, {0, 5, 6}}},
+    {0x8080, 2,   6, {{0, 0, 1}, {0, 2, 5}}},
+    {0x0880, 3,   7, {{0, 0, 1}, {1, 2, 3}, {0, 5, 6}}},
+    {0x0888, 4,   8, {{0, 0, 1}, {0, 2, 3}, {1, 0, 6}, {0, 5, 7}}},
+    {0x8888, 1,   5, {{0, 0, 1}}},
+    {0x0228, 6,  10, {{0, 0, 1}, {1, 1, 2}, {0, 2, 5}, {1, 3, 6}, {1, 0, 7}, {0, 8, 9}}},
+    {0x80A8, 5,   9, {{1, 1, 2}, {1, 1, 3}, {0, 5, 6}, {1, 2, 7}, {0, 0, 8}}},
+    {0x0280, 4,   8, {{1, 1, 3}, {1, 2, 3}, {0, 0, 5}, {0, 6, 7}}},
+    {0x0288, 5,   9, {{0, 0, 2}, {1, 1, 3}, {0, 3, 5}, {1, 0, 7}, {0, 6, 8}}},
+    {0x88A0, 4,   8, {{1, 1, 2}, {0, 3, 5}, {1, 2, 6}, {0, 0, 7}}},
+    {0x2888, 3,   7, {{0, 2, 3}, {1, 1, 5}, {0, 0, 6}}},
+    {0x80AA, 5,   9, {{0, 0, 1}, {0, 2, 5}, {1, 0, 6}, {0, 3, 7}, {1, 0, 8}}},
+    {0x0AA0, 2,   6, {{1, 2, 3}, {0, 0, 5}}},
+    {0x8AA0, 5,   9, {{0, 0, 2}, {0, 1, 5}, {1, 0, 6}, {0, 3, 7}, {1, 5, 8}}},
+    {0x0AAA, 3,   7, {{0, 0, 2}, {0, 3, 5}, {1, 0, 6}}},
+    {0x8228, 3,   7, {{1, 1, 2}, {1, 3, 5}, {0, 0, 6}}},
+    {0x82A8, 6,  10, {{0, 0, 1}, {1, 2, 3}, {0, 2, 5}, {1, 0, 7}, {0, 6, 8}, {1, 5, 9}}},
+    {0x82AA, 4,   8, {{1, 1, 2}, {0, 0, 3}, {0, 5, 6}, {1, 0, 7}}},
+    {0x8AA2, 5,   9, {{1, 1, 2}, {1, 1, 3}, {0, 0, 5}, {0, 6, 7}, {1, 0, 8}}},
+    {0x2AAA, 4,   8, {{0, 0, 2}, {0, 1, 3}, {0, 5, 6}, {1, 0, 7}}},
+    {0xAAAA, 0,   0, {{0, 0, 0}}},
+    {0x0886, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 2, 6}, {1, 3, 7}, {0, 6, 7}, {1, 5, 9}, {0, 8, 10}}},
+    {0xE880, 8,  12, {{0, 1, 2}, {0, 3, 5}, {1, 1, 2}, {1, 3, 5}, {1, 5, 7}, {0, 8, 9}, {0, 0, 10}, {1, 6, 11}}},
+    {0x0118, 7,  11, {{0, 0, 1}, {1, 2, 3}, {0, 2, 5}, {1, 0, 6}, {1, 1, 6}, {1, 7, 8}, {0, 9, 10}}},
+    {0x012A, 6,  10, {{1, 0, 3}, {1, 1, 3}, {1, 2, 3}, {0, 6, 7}, {1, 0, 8}, {0, 5, 9}}},
+    {0x022C, 6,  10, {{1, 1, 2}, {1, 0, 5}, {1, 3, 5}, {0, 1, 6}, {1, 0, 8}, {0, 7, 9}}},
+    {0x022E, 7,  11, {{1, 1, 2}, {1, 0, 5}, {0, 3, 5}, {0, 1, 6}, {1, 4, 7}, {1, 0, 8}, {0, 9, 10}}},
+    {0x6888, 6,  10, {{0, 0, 1}, {1, 0, 1}, {0, 2, 3}, {1, 5, 6}, {1, 5, 7}, {0, 8, 9}}},
+    {0x80EA, 5,   9, {{0, 1, 2}, {1, 0, 3}, {1, 0, 5}, {0, 6, 7}, {1, 5, 8}}},
+    {0x0682, 5,   9, {{1, 0, 1}, {0, 1, 3}, {1, 2, 5}, {1, 0, 6}, {0, 7, 8}}},
+    {0x068A, 6,  10, {{1, 0, 1}, {0, 1, 3}, {0, 2, 5}, {1, 0, 6}, {1, 4, 7}, {0, 8, 9}}},
+    {0x08EA, 6,  10, {{1, 0, 2}, {1, 0, 3}, {0, 1, 5}, {1, 0, 7}, {0, 6, 8}, {1, 7, 9}}},
+    {0x2CC0, 6,  10, {{0, 0, 2}, {0, 1, 2}, {0, 3, 5}, {1, 3, 6}, {1, 1, 7}, {0, 8, 9}}},
+    {0x88E2, 5,   9, {{0, 1, 2}, {1, 1, 3}, {1, 0, 5}, {0, 6, 7}, {1, 0, 8}}},
+    {0x68A8, 6,  10, {{0, 0, 1}, {1, 0, 3}, {0, 1, 6}, {1, 0, 7}, {0, 2, 8}, {1, 5, 9}}},
+    {0xA8E8, 6,  10, {{1, 0, 1}, {0, 2, 5}, {0, 3, 6}, {1, 0, 7}, {0, 1, 8}, {1, 6, 9}}},
+    {0x1680, 5,   9, {{0, 0, 1}, {1, 0, 1}, {1, 3, 5}, {1, 2, 6}, {0, 7, 8}}},
+    {0x0296, 7,  11, {{0, 0, 1}, {1, 1, 2}, {1, 0, 6}, {1, 5, 6}, {0, 3, 7}, {0, 8, 9}, {1, 7, 10}}},
+    {0x016A, 7,  11, {{0, 0, 3}, {1, 1, 3}, {1, 2, 3}, {1, 4, 5}, {0, 6, 7}, {1, 0, 9}, {0, 8, 10}}},
+    {0x029E, 7,  11, {{1, 0, 2}, {0, 0, 5}, {1, 1, 5}, {1, 3, 6}, {1, 6, 7}, {0, 8, 9}, {1, 7, 10}}},
+    {0x1AA2, 6,  10, {{1, 0, 2}, {0, 1, 5}, {1, 2, 6}, {1, 3, 6}, {0, 7, 8}, {1, 0, 9}}},
+    {0x8AAC, 7,  11, {{1, 0, 1}, {0, 1, 2}, {1, 2, 3}, {0, 3, 6}, {1, 7, 8}, {0, 5, 9}, {1, 1, 10}}},
+    {0x8AA6, 7,  11, {{0, 0, 2}, {1, 1, 2}, {1, 1, 3}, {1, 1, 5}, {0, 6, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x8AAE, 6,  10, {{1, 0, 1}, {1, 1, 2}, {1, 1, 3}, {0, 5, 6}, {0, 7, 8}, {1, 0, 9}}},
+    {0x0180, 5,   9, {{1, 0, 3}, {1, 1, 3}, {1, 2, 3}, {0, 5, 6}, {0, 7, 8}}},
+    {0x0188, 6,  10, {{1, 0, 3}, {1, 1, 3}, {0, 2, 3}, {0, 5, 6}, {1, 4, 7}, {0, 8, 9}}},
+    {0x0248, 6,  10, {{1, 0, 2}, {0, 1, 2}, {1, 1, 3}, {1, 0, 6}, {0, 5, 7}, {0, 8, 9}}},
+    {0x024A, 5,   9, {{1, 0, 2}, {1, 2, 3}, {0, 1, 6}, {1, 0, 7}, {0, 5, 8}}},
+    {0x0186, 6,  10, {{0, 0, 1}, {1, 0, 1}, {1, 3, 6}, {1, 2, 7}, {1, 5, 7}, {0, 8, 9}}},
+    {0x018E, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 3, 6}, {0, 2, 7}, {1, 5, 7}, {1, 4, 8}, {0, 9, 10}}},
+    {0x0AC0, 5,   9, {{1, 0, 1}, {1, 2, 3}, {0, 2, 5}, {1, 0, 7}, {0, 6, 8}}},
+    {0x02CA, 6,  10, {{1, 0, 1}, {0, 1, 3}, {0, 2, 5}, {1, 4, 6}, {1, 0, 7}, {0, 8, 9}}},
+    {0x8AC8, 6,  10, {{1, 0, 1}, {0, 2, 5}, {0, 3, 5}, {1, 0, 6}, {1, 1, 7}, {0, 8, 9}}},
+    {0x0896, 7,  11, {{0, 0, 1}, {1, 0, 1}, {0, 3, 5}, {1, 2, 6}, {1, 3, 8}, {1, 7, 8}, {0, 9, 10}}},
+    {0x288E, 6,  10, {{1, 1, 2}, {0, 1, 5}, {1, 3, 5}, {1, 0, 6}, {0, 7, 8}, {1, 0, 9}}},
+    {0x06A0, 4,   8, {{0, 1, 3}, {1, 2, 3}, {1, 0, 5}, {0, 6, 7}}},
+    {0x025A, 6,  10, {{0, 0, 1}, {1, 0, 2}, {1, 2, 5}, {0, 3, 6}, {0, 7, 8}, {1, 6, 9}}},
+    {0x026C, 6,  10, {{0, 1, 3}, {1, 2, 3}, {1, 4, 5}, {0, 0, 6}, {1, 1, 8}, {0, 7, 9}}},
+    {0x08BC, 6,  10, {{0, 0, 1}, {1, 1, 2}, {1, 3, 5}, {1, 5, 6}, {0, 7, 8}, {1, 6, 9}}},
+    {0x289A, 7,  11, {{1, 0, 1}, {1, 1, 2}, {0, 3, 5}, {1, 3, 6}, {1, 2, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x8AE8, 7,  11, {{1, 0, 1}, {1, 2, 3}, {0, 5, 6}, {0, 3, 7}, {1, 0, 8}, {0, 1, 9}, {1, 7, 10}}},
+    {0x0780, 4,   8, {{0, 0, 1}, {1, 2, 3}, {1, 3, 5}, {0, 6, 7}}},
+    {0x0788, 5,   9, {{0, 0, 1}, {0, 2, 3}, {1, 3, 5}, {1, 4, 6}, {0, 7, 8}}},
+    {0x08F0, 5,   9, {{0, 0, 1}, {1, 2, 3}, {0, 3, 5}, {1, 2, 7}, {0, 6, 8}}},
+    {0x88F0, 4,   8, {{0, 0, 1}, {1, 2, 5}, {0, 3, 6}, {1, 2, 7}}},
+    {0x18A8, 6,  10, {{1, 0, 2}, {0, 2, 3}, {0, 1, 5}, {1, 0, 6}, {1, 2, 7}, {0, 8, 9}}},
+    {0x02DA, 7,  11, {{1, 0, 2}, {1, 1, 3}, {1, 3, 5}, {0, 0, 6}, {1, 5, 8}, {0, 7, 9}, {1, 8, 10}}},
+    {0x06AA, 5,   9, {{1, 0, 1}, {0, 2, 5}, {1, 1, 6}, {0, 3, 7}, {1, 0, 8}}},
+    {0x8ACA, 6,  10, {{1, 0, 1}, {0, 1, 2}, {0, 3, 6}, {1, 2, 7}, {0, 5, 8}, {1, 0, 9}}},
+    {0x86A2, 6,  10, {{1, 1, 2}, {0, 1, 5}, {0, 3, 5}, {1, 0, 6}, {1, 0, 7}, {0, 8, 9}}},
+    {0x2AAC, 9,  13, {{1, 0, 1}, {0, 3, 5}, {1, 1, 6}, {0, 0, 1}, {1, 3, 5}, {1, 5, 8}, {0, 9, 10}, {0, 2, 11}, {1, 7, 12}}},
+    {0x86AA, 6,  10, {{0, 0, 2}, {1, 1, 2}, {1, 1, 5}, {0, 3, 6}, {0, 7, 8}, {1, 0, 9}}},
+    {0x8AEA, 5,   9, {{1, 0, 1}, {1, 1, 3}, {0, 2, 5}, {0, 6, 7}, {1, 0, 8}}},
+    {0x1780, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 3, 5}, {1, 5, 6}, {0, 2, 8}, {1, 3, 9}, {0, 7, 10}}},
+    {0x9780, 8,  12, {{0, 1, 2}, {0, 3, 5}, {1, 3, 6}, {1, 1, 2}, {0, 3, 8}, {1, 5, 9}, {0, 0, 10}, {1, 7, 11}}},
+    {0x18F0, 5,   9, {{0, 0, 3}, {0, 1, 3}, {1, 2, 5}, {1, 2, 6}, {0, 7, 8}}},
+    {0x2ACA, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 3, 6}, {1, 5, 6}, {0, 2, 7}, {1, 0, 9}, {0, 8, 10}}},
+    {0x1AAA, 5,   9, {{0, 2, 3}, {1, 0, 5}, {0, 1, 5}, {1, 4, 7}, {0, 6, 8}}},
+    {0xACCC, 4,   8, {{1, 0, 1}, {0, 2, 3}, {0, 5, 6}, {1, 1, 7}}},
+    {0x6AAA, 3,   7, {{0, 1, 2}, {0, 3, 5}, {1, 0, 6}}},
+    {0x033C, 5,   9, {{0, 1, 2}, {1, 1, 2}, {0, 3, 5}, {1, 3, 6}, {1, 7, 8}}},
+    {0x68E8, 6,  10, {{0, 0, 1}, {1, 0, 1}, {0, 3, 5}, {1, 6, 7}, {0, 2, 8}, {1, 5, 9}}},
+    {0x88EE, 4,   8, {{1, 0, 1}, {1, 0, 3}, {0, 5, 6}, {1, 1, 7}}},
+    {0x6AC0, 3,   7, {{0, 1, 2}, {0, 0, 3}, {1, 5, 6}}},
+    {0x0777, 5,   9, {{0, 0, 1}, {0, 2, 3}, {1, 4, 5}, {1, 4, 6}, {0, 7, 8}}},
+    {0x1AC0, 5,   9, {{0, 1, 2}, {0, 0, 3}, {1, 3, 5}, {1, 2, 6}, {0, 7, 8}}},
+    {0x9AC0, 4,   8, {{1, 0, 2}, {0, 1, 2}, {0, 3, 5}, {1, 6, 7}}},
+    {0x06A6, 5,   9, {{1, 0, 1}, {0, 0, 3}, {1, 1, 6}, {0, 2, 7}, {1, 5, 8}}},
+    {0x07B7, 6,  10, {{1, 0, 2}, {0, 2, 3}, {0, 1, 5}, {1, 4, 6}, {1, 4, 7}, {0, 8, 9}}},
+    {0x8AC6, 6,  10, {{0, 0, 2}, {0, 1, 3}, {1, 1, 5}, {1, 4, 6}, {0, 7, 8}, {1, 0, 9}}},
+    {0xA8EC, 6,  10, {{1, 0, 1}, {0, 0, 2}, {0, 1, 3}, {1, 6, 7}, {0, 5, 8}, {1, 1, 9}}},
+    {0x1688, 6,  10, {{0, 0, 1}, {1, 0, 2}, {1, 3, 5}, {0, 3, 6}, {1, 1, 8}, {0, 7, 9}}},
+    {0x09A6, 6,  10, {{0, 0, 3}, {1, 1, 3}, {1, 0, 6}, {1, 5, 6}, {0, 2, 8}, {1, 7, 9}}},
+    {0x18E8, 5,   9, {{0, 0, 1}, {1, 0, 1}, {1, 3, 6}, {0, 2, 7}, {1, 5, 8}}},
+    {0x0BB7, 7,  11, {{1, 0, 2}, {0, 2, 3}, {1, 3, 5}, {1, 4, 6}, {0, 1, 7}, {1, 4, 9}, {0, 8, 10}}},
+    {0x036C, 6,  10, {{0, 0, 2}, {1, 1, 3}, {0, 2, 3}, {1, 5, 6}, {1, 4, 7}, {0, 8, 9}}},
+    {0x86AC, 6,  10, {{0, 1, 2}, {0, 0, 3}, {1, 0, 5}, {1, 2, 6}, {0, 7, 8}, {1, 1, 9}}},
+    {0x179B, 7,  11, {{1, 0, 1}, {0, 2, 5}, {1, 3, 5}, {1, 4, 6}, {0, 1, 7}, {1, 4, 9}, {0, 8, 10}}},
+    {0x8AEC, 5,   9, {{1, 0, 1}, {0, 0, 2}, {1, 3, 6}, {0, 5, 7}, {1, 1, 8}}},
+    {0x86A6, 6,  10, {{1, 0, 1}, {0, 0, 3}, {0, 5, 6}, {1, 1, 7}, {0, 2, 8}, {1, 5, 9}}},
+    {0x68EA, 6,  10, {{1, 1, 3}, {0, 0, 5}, {1, 1, 6}, {1, 2, 6}, {0, 7, 8}, {1, 0, 9}}},
+    {0x8AE6, 5,   9, {{0, 0, 2}, {1, 1, 3}, {1, 1, 5}, {0, 6, 7}, {1, 0, 8}}},
+    {0x03C0, 3,   7, {{1, 1, 3}, {1, 2, 3}, {0, 5, 6}}},
+    {0x07A0, 6,  10, {{0, 1, 3}, {1, 2, 3}, {1, 2, 5}, {0, 0, 7}, {1, 3, 8}, {0, 6, 9}}},
+    {0x03CC, 4,   8, {{1, 1, 3}, {0, 2, 3}, {1, 4, 6}, {0, 5, 7}}},
+    {0x07A2, 6,  10, {{0, 0, 1}, {1, 0, 2}, {1, 0, 3}, {1, 3, 5}, {0, 6, 8}, {1, 7, 9}}},
+    {0x07A8, 7,  11, {{0, 0, 1}, {1, 0, 2}, {1, 2, 3}, {0, 2, 7}, {1, 5, 8}, {0, 6, 9}, {1, 7, 10}}},
+    {0x2ACC, 6,  10, {{0, 0, 1}, {1, 0, 1}, {0, 2, 5}, {1, 6, 7}, {0, 3, 8}, {1, 1, 9}}},
+    {0xAACC, 3,   7, {{1, 0, 1}, {0, 3, 5}, {1, 1, 6}}},
+    {0x1788, 6,  10, {{0, 0, 1}, {1, 0, 1}, {0, 2, 3}, {1, 3, 5}, {0, 6, 7}, {1, 8, 9}}},
+    {0x07E7, 7,  11, {{1, 0, 2}, {1, 1, 2}, {0, 2, 3}, {0, 5, 6}, {1, 4, 7}, {1, 4, 8}, {0, 9, 10}}},
+    {0x16EE, 7,  11, {{0, 0, 1}, {1, 0, 1}, {0, 2, 3}, {1, 3, 5}, {1, 5, 7}, {0, 8, 9}, {1, 6, 10}}},
+    {0x06EE, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 3, 5}, {0, 2, 6}, {1, 5, 8}, {0, 7, 9}, {1, 6, 10}}},
+    {0x03D8, 7,  11, {{1, 0, 1}, {1, 1, 2}, {1, 2, 3}, {0, 3, 5}, {1, 0, 8}, {0, 6, 9}, {1, 7, 10}}},
+    {0x1AB8, 7,  11, {{1, 0, 2}, {0, 0, 3}, {0, 1, 5}, {1, 1, 6}, {1, 2, 6}, {0, 7, 8}, {1, 9, 10}}},
+    {0x0BEA, 6,  10, {{1, 2, 3}, {1, 0, 5}, {0, 1, 5}, {1, 3, 7}, {0, 6, 8}, {1, 0, 9}}},
+    {0x19AA, 6,  10, {{0, 0, 1}, {1, 0, 3}, {0, 2, 5}, {1, 1, 7}, {0, 3, 8}, {1, 6, 9}}},
+    {0x2CEC, 5,   9, {{1, 0, 3}, {0, 1, 5}, {1, 0, 6}, {0, 2, 7}, {1, 1, 8}}},
+    {0x9AF0, 4,   8, {{0, 1, 2}, {1, 0, 5}, {0, 3, 6}, {1, 2, 7}}},
+    {0x3CCC, 2,   6, {{0, 2, 3}, {1, 1, 5}}},
+    {0x0660, 3,   7, {{1, 0, 1}, {1, 2, 3}, {0, 5, 6}}},
+    {0x0668, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 2, 5}, {1, 3, 7}, {0, 5, 7}, {1, 6, 9}, {0, 8, 10}}},
+    {0x06E0, 6,  10, {{0, 0, 1}, {1, 0, 1}, {1, 2, 3}, {0, 2, 5}, {1, 6, 8}, {0, 7, 9}}},
+    {0x066A, 6,  10, {{0, 0, 2}, {0, 1, 2}, {1, 1, 5}, {1, 0, 6}, {0, 3, 7}, {1, 8, 9}}},
+    {0x0666, 4,   8, {{1, 0, 1}, {0, 2, 3}, {1, 4, 6}, {0, 5, 7}}},
+    {0x0EE8, 7,  11, {{1, 2, 3}, {1, 0, 5}, {0, 1, 6}, {0, 2, 7}, {1, 5, 8}, {0, 0, 9}, {1, 7, 10}}},
+    {0x0996, 6,  10, {{1, 0, 1}, {0, 2, 3}, {1, 2, 3}, {1, 4, 6}, {1, 5, 7}, {0, 8, 9}}},
+    {0x86E8, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 2, 3}, {0, 3, 5}, {1, 6, 8}, {0, 7, 9}, {1, 5, 10}}},
+    {0x28BE, 5,   9, {{1, 1, 2}, {1, 0, 3}, {1, 0, 5}, {0, 6, 7}, {1, 5, 8}}},
+    {0x0672, 7,  11, {{1, 0, 1}, {1, 2, 5}, {0, 1, 6}, {1, 3, 6}, {1, 2, 7}, {0, 8, 9}, {1, 5, 10}}},
+    {0x06EA, 7,  11, {{0, 0, 2}, {1, 2, 3}, {0, 1, 6}, {1, 5, 6}, {1, 5, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x06E6, 7,  11, {{0, 0, 1}, {1, 0, 1}, {0, 2, 3}, {0, 2, 5}, {1, 4, 7}, {1, 6, 8}, {0, 9, 10}}},
+    {0x0678, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 2, 5}, {0, 3, 6}, {1, 3, 7}, {1, 7, 8}, {0, 9, 10}}},
+    {0x299A, 7,  11, {{0, 0, 1}, {1, 2, 3}, {0, 2, 5}, {1, 1, 6}, {1, 6, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x29AC, 7,  11, {{0, 0, 3}, {1, 1, 3}, {1, 2, 5}, {0, 2, 6}, {1, 0, 8}, {0, 7, 9}, {1, 6, 10}}},
+    {0x29AE, 6,  10, {{0, 0, 1}, {1, 1, 3}, {1, 2, 6}, {1, 5, 6}, {0, 7, 8}, {1, 0, 9}}},
+    {0x2ABC, 6,  10, {{0, 0, 1}, {1, 1, 2}, {1, 3, 5}, {1, 0, 6}, {0, 7, 8}, {1, 6, 9}}},
+    {0x0690, 4,   8, {{1, 0, 1}, {1, 2, 3}, {1, 2, 5}, {0, 6, 7}}},
+    {0x1682, 7,  11, {{0, 0, 1}, {1, 1, 2}, {1, 0, 6}, {1, 5, 6}, {0, 3, 8}, {1, 0, 9}, {0, 7, 10}}},
+    {0x069A, 7,  11, {{0, 0, 2}, {1, 1, 2}, {1, 2, 3}, {1, 0, 5}, {1, 5, 6}, {0, 7, 9}, {1, 8, 10}}},
+    {0x0696, 5,   9, {{1, 0, 1}, {0, 2, 3}, {1, 2, 5}, {1, 4, 6}, {0, 7, 8}}},
+    {0x2CCA, 7,  11, {{0, 0, 1}, {1, 2, 3}, {0, 2, 5}, {1, 0, 7}, {1, 1, 8}, {0, 6, 9}, {1, 8, 10}}},
+    {0xACCA, 4,   8, {{1, 0, 1}, {1, 2, 3}, {0, 5, 6}, {1, 0, 7}}},
+    {0x06B0, 7,  11, {{1, 0, 1}, {0, 0, 2}, {1, 2, 3}, {1, 2, 5}, {0, 5, 6}, {1, 8, 9}, {0, 7, 10}}},
+    {0x0792, 7,  11, {{1, 0, 1}, {0, 1, 2}, {1, 2, 3}, {1, 3, 5}, {1, 0, 6}, {0, 8, 9}, {1, 7, 10}}},
+    {0x06B2, 7,  11, {{1, 0, 1}, {1, 2, 3}, {0, 0, 5}, {1, 3, 5}, {1, 6, 7}, {0, 8, 9}, {1, 6, 10}}},
+    {0x06BA, 7,  11, {{0, 0, 2}, {1, 2, 3}, {0, 1, 6}, {1, 5, 6}, {1, 2, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x12C6, 8,  12, {{1, 0, 1}, {0, 0, 2}, {1, 5, 6}, {1, 1, 2}, {0, 5, 8}, {1, 2, 9}, {0, 3, 10}, {1, 7, 11}}},
+    {0x1AE2, 7,  11, {{1, 0, 2}, {0, 0, 3}, {0, 1, 5}, {1, 5, 6}, {1, 3, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x2CE2, 7,  11, {{0, 0, 1}, {1, 2, 3}, {1, 0, 5}, {0, 3, 7}, {1, 1, 8}, {0, 6, 9}, {1, 7, 10}}},
+    {0x2CEA, 7,  11, {{0, 0, 1}, {1, 3, 5}, {0, 0, 6}, {1, 2, 6}, {1, 1, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x89A6, 7,  11, {{0, 0, 1}, {1, 1, 3}, {1, 0, 6}, {0, 2, 6}, {1, 5, 7}, {0, 8, 9}, {1, 7, 10}}},
+    {0x9AE2, 5,   9, {{0, 0, 1}, {1, 1, 3}, {1, 2, 5}, {0, 6, 7}, {1, 0, 8}}},
+    {0x06F0, 5,   9, {{1, 0, 1}, {1, 2, 3}, {0, 3, 5}, {1, 2, 7}, {0, 6, 8}}},
+    {0x16AA, 6,  10, {{0, 0, 1}, {1, 1, 2}, {0, 2, 5}, {1, 6, 7}, {0, 3, 8}, {1, 0, 9}}},
+    {0x1ACA, 7,  11, {{1, 0, 1}, {0, 0, 3}, {1, 3, 5}, {0, 5, 6}, {1, 7, 8}, {0, 2, 9}, {1, 0, 10}}},
+    {0x2EE2, 4,   8, {{1, 0, 2}, {1, 3, 5}, {0, 1, 6}, {1, 0, 7}}},
+    {0x96AA, 3,   7, {{1, 1, 2}, {0, 3, 5}, {1, 0, 6}}},
+    {0x0EE6, 8,  12, {{0, 0, 1}, {1, 0, 1}, {0, 3, 5}, {1, 6, 7}, {0, 3, 6}, {1, 5, 9}, {0, 2, 10}, {1, 8, 11}}},
+    {0x0778, 6,  10, {{0, 0, 1}, {0, 2, 3}, {1, 2, 3}, {1, 0, 6}, {0, 5, 8}, {1, 7, 9}}},
+    {0x29CE, 7,  11, {{1, 0, 2}, {1, 1, 2}, {1, 1, 3}, {0, 6, 7}, {1, 0, 8}, {0, 5, 9}, {1, 7, 10}}},
+    {0x83EC, 6,  10, {{1, 0, 3}, {1, 1, 3}, {0, 5, 6}, {1, 0, 7}, {0, 2, 8}, {1, 6, 9}}},
+    {0x6EE8, 9,  13, {{0, 0, 1}, {1, 0, 1}, {0, 3, 6}, {1, 5, 7}, {1, 3, 6}, {1, 5, 6}, {0, 9, 10}, {0, 2, 11}, {1, 8, 12}}},
+    {0x07B0, 5,   9, {{1, 0, 2}, {1, 2, 3}, {0, 1, 5}, {1, 4, 7}, {0, 6, 8}}},
+    {0x0BE2, 9,  13, {{1, 1, 3}, {1, 2, 3}, {0, 5, 6}, {0, 1, 2}, {0, 3, 8}, {1, 4, 5}, {1, 9, 10}, {0, 0, 11}, {1, 7, 12}}},
+    {0x07B8, 7,  11, {{1, 0, 2}, {0, 1, 2}, {1, 2, 3}, {0, 3, 6}, {1, 1, 8}, {0, 5, 9}, {1, 7, 10}}},
+    {0x07BA, 7,  11, {{1, 0, 1}, {1, 0, 2}, {1, 2, 3}, {0, 5, 7}, {1, 0, 8}, {0, 6, 9}, {1, 7, 10}}},
+    {0x07B6, 7,  11, {{1, 0, 1}, {1, 2, 3}, {1, 3, 5}, {0, 0, 6}, {1, 5, 8}, {0, 7, 9}, {1, 6, 10}}},
+    {0x9AD2, 5,   9, {{1, 0, 2}, {0, 3, 5}, {1, 0, 6}, {0, 1, 7}, {1, 5, 8}}},
+    {0x07E0, 6,  10, {{1, 0, 2}, {1, 1, 2}, {1, 2, 3}, {0, 5, 6}, {1, 4, 8}, {0, 7, 9}}},
+    {0x17A8, 7,  11, {{1, 0, 1}, {0, 2, 5}, {1, 3, 6}, {0, 6, 7}, {1, 0, 8}, {0, 1, 9}, {1, 7, 10}}},
+    {0x07E2, 9,  13, {{1, 0, 2}, {1, 0, 3}, {0, 3, 5}, {1, 6, 7}, {0, 2, 3}, {1, 4, 9}, {0, 5, 10}, {0, 1, 11}, {1, 8, 12}}},
+    {0x0BDA, 6,  10, {{1, 0, 3}, {1, 2, 3}, {0, 1, 6}, {1, 0, 7}, {0, 5, 8}, {1, 6, 9}}},
+    {0x07E6, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 2, 3}, {1, 3, 5}, {1, 6, 7}, {0, 8, 9}, {1, 6, 10}}},
+    {0x6AC6, 6,  10, {{1, 0, 1}, {1, 2, 3}, {0, 2, 5}, {1, 1, 7}, {0, 6, 8}, {1, 5, 9}}},
+    {0x07F0, 5,   9, {{0, 0, 1}, {1, 2, 3}, {0, 3, 5}, {1, 4, 7}, {0, 6, 8}}},
+    {0x17AA, 6,  10, {{1, 0, 1}, {1, 0, 2}, {1, 0, 3}, {0, 3, 5}, {0, 6, 8}, {1, 7, 9}}},
+    {0x1ADA, 5,   9, {{1, 0, 2}, {0, 1, 2}, {1, 0, 3}, {0, 6, 7}, {1, 5, 8}}},
+    {0x87F0, 4,   8, {{0, 0, 1}, {1, 2, 3}, {0, 3, 5}, {1, 6, 7}}},
+    {0x0FF0, 1,   5, {{1, 2, 3}}},
+    {0x2994, 7,  11, {{1, 0, 1}, {1, 0, 2}, {1, 1, 3}, {0, 5, 6}, {1, 6, 7}, {1, 4, 8}, {0, 9, 10}}},
+    {0x2996, 7,  11, {{1, 0, 1}, {0, 1, 2}, {1, 2, 3}, {0, 3, 5}, {1, 5, 7}, {0, 6, 8}, {1, 9, 10}}},
+    {0x166A, 7,  11, {{0, 1, 2}, {1, 1, 2}, {1, 0, 5}, {0, 5, 7}, {1, 6, 8}, {0, 3, 9}, {1, 7, 10}}},
+    {0x299E, 7,  11, {{1, 0, 2}, {1, 1, 2}, {1, 0, 3}, {0, 1, 5}, {1, 6, 7}, {0, 7, 8}, {1, 9, 10}}},
+    {0x166E, 6,  10, {{0, 0, 1}, {1, 0, 1}, {1, 2, 5}, {1, 3, 5}, {0, 7, 8}, {1, 6, 9}}},
+    {0xB22C, 9,  13, {{1, 1, 2}, {1, 1, 3}, {0, 5, 6}, {0, 1, 2}, {1, 3, 8}, {0, 6, 9}, {1, 2, 10}, {0, 0, 11}, {1, 7, 12}}},
+    {0x1886, 7,  11, {{1, 0, 2}, {1, 1, 3}, {0, 0, 5}, {0, 1, 6}, {1, 6, 7}, {1, 5, 8}, {0, 9, 10}}},
+    {0x18A6, 7,  11, {{1, 1, 2}, {0, 0, 3}, {1, 1, 3}, {1, 0, 6}, {1, 6, 7}, {0, 5, 9}, {1, 8, 10}}},
+    {0x1686, 6,  10, {{1, 0, 1}, {1, 0, 3}, {1, 2, 5}, {0, 2, 6}, {1, 5, 8}, {0, 7, 9}}},
+    {0x1AA6, 7,  11, {{0, 0, 1}, {0, 2, 5}, {1, 1, 6}, {1, 2, 7}, {1, 3, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x1896, 7,  11, {{0, 0, 1}, {1, 0, 1}, {1, 2, 6}, {0, 6, 7}, {1, 5, 8}, {0, 3, 9}, {1, 7, 10}}},
+    {0x29CA, 7,  11, {{0, 0, 2}, {1, 1, 3}, {0, 3, 6}, {1, 5, 6}, {1, 2, 7}, {0, 8, 9}, {1, 0, 10}}},
+    {0x1AAC, 9,  13, {{1, 0, 1}, {0, 3, 5}, {1, 1, 6}, {0, 0, 3}, {1, 3, 5}, {0, 5, 8}, {1, 9, 10}, {0, 2, 11}, {1, 7, 12}}},
+    {0x1696, 6,  10, {{1, 0, 1}, {0, 0, 2}, {0, 1, 3}, {1, 2, 5}, {0, 6, 7}, {1, 8, 9}}},
+    {0x869E, 7,  11, {{1, 0, 2}, {1, 1, 2}, {1, 0, 3}, {1, 1, 5}, {0, 5, 6}, {0, 7, 9}, {1, 8, 10}}},
+    {0x3DDA, 9,  13, {{0, 0, 1}, {1, 0, 3}, {0, 3, 5}, {1, 6, 7}, {1, 1, 3}, {0, 6, 9}, {1, 4, 10}, {0, 2, 11}, {1, 8, 12}}},
+    {0x19A6, 7,  11, {{1, 0, 1}, {0, 1, 2}, {0, 3, 5}, {1, 3, 5}, {1, 1, 7}, {0, 6, 9}, {1, 8, 10}}},
+    {0x169A, 7,  11, {{1, 0, 2}, {0, 1, 2}, {0, 5, 6}, {1, 5, 6}, {1, 1, 7}, {0, 3, 9}, {1, 8, 10}}},
+    {0x1AB6, 7,  11, {{1, 0, 1}, {0, 2, 5}, {1, 2, 5}, {1, 1, 6}, {1, 3, 6}, {0, 8, 9}, {1, 7, 10}}},
+    {0x169E, 6,  10, {{0, 0, 1}, {1, 0, 2}, {1, 1, 6}, {1, 3, 6}, {0, 5, 8}, {1, 7, 9}}},
+    {0x29C6, 7,  11, {{1, 0, 2}, {1, 1, 3}, {0, 2, 3}, {0, 6, 7}, {1, 0, 8}, {0, 5, 9}, {1, 6, 10}}},
+    {0x6BD8, 7,  11, {{0, 0, 2}, {0, 1, 3}, {1, 2, 3}, {1, 1, 5}, {1, 0, 6}, {0, 8, 9}, {1, 7, 10}}},
+    {0x29DA, 6,  10, {{1, 0, 3}, {0, 2, 5}, {1, 2, 5}, {1, 3, 6}, {0, 1, 8}, {1, 7, 9}}},
+    {0x16BC, 5,   9, {{0, 1, 2}, {1, 1, 2}, {1, 3, 5}, {0, 0, 7}, {1, 6, 8}}},
+    {0x29D6, 6,  10, {{1, 0, 1}, {0, 1, 2}, {1, 2, 3}, {1, 4, 6}, {0, 5, 8}, {1, 7, 9}}},
+    {0x188E, 6,  10, {{0, 0, 1}, {1, 0, 1}, {1, 2, 6}, {1, 3, 6}, {0, 7, 8}, {1, 5, 9}}},
+    {0x2BE8, 5,   9, {{1, 1, 2}, {1, 1, 3}, {1, 0, 6}, {0, 5, 7}, {1, 6, 8}}},
+    {0x89E6, 6,  10, {{1, 0, 3}, {1, 1, 3}, {1, 1, 5}, {0, 2, 5}, {0, 6, 8}, {1, 7, 9}}},
+    {0x3DE8, 7,  11, {{0, 1, 2}, {1, 1, 2}, {1, 3, 5}, {0, 3, 7}, {1, 6, 8}, {0, 0, 9}, {1, 7, 10}}},
+    {0x179A, 7,  11, {{1, 1, 2}, {0, 0, 3}, {1, 0, 3}, {1, 3, 5}, {1, 2, 6}, {0, 8, 9}, {1, 7, 10}}},
+    {0x17AC, 6,  10, {{1, 0, 1}, {0, 1, 3}, {1, 1, 3}, {1, 2, 6}, {0, 5, 8}, {1, 7, 9}}},
+    {0x17E8, 5,   9, {{1, 0, 1}, {1, 0, 2}, {1, 0, 3}, {0, 5, 6}, {1, 7, 8}}},
+    {0x9AA6, 4,   8, {{1, 1, 2}, {1, 1, 3}, {0, 5, 6}, {1, 0, 7}}},
+    {0x3D6A, 8,  12, {{0, 1, 2}, {1, 3, 5}, {1, 1, 2}, {1, 5, 7}, {0, 3, 8}, {1, 4, 9}, {0, 0, 10}, {1, 6, 11}}},
+    {0x1AE6, 7,  11, {{0, 1, 3}, {1, 0, 5}, {0, 1, 6}, {1, 1, 6}, {1, 3, 7}, {0, 2, 9}, {1, 8, 10}}},
+    {0x19E6, 5,   9, {{0, 0, 1}, {1, 0, 1}, {0, 2, 5}, {1, 3, 6}, {1, 7, 8}}},
+    {0x1BD8, 5,   9, {{1, 1, 2}, {1, 0, 3}, {1, 2, 3}, {0, 5, 6}, {1, 7, 8}}},
+    {0x1BE4, 4,   8, {{1, 1, 2}, {1, 1, 3}, {0, 0, 5}, {1, 6, 7}}},
+    {0x8778, 3,   7, {{0, 0, 1}, {1, 2, 3}, {1, 5, 6}}},
+    {0x9696, 2,   6, {{1, 0, 1}, {1, 2, 5}}},
+    {0x6996, 3,   7, {{1, 0, 2}, {1, 1, 3}, {1, 5, 6}}},
+};
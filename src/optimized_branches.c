@@ -34,105 +34,6 @@ static int32_t get_branch_immediate_optimized(uint32_t instruction) {
     return imm;
 }
 
-// Optimized equality checker - fewer gates than full comparator
-static uint32_t build_equality_optimized(riscv_circuit_t* circuit, 
-                                        uint32_t* a_bits, uint32_t* b_bits, 
-                                        size_t num_bits) {
-    // XOR all bit pairs, then NOR the results
-    uint32_t result = CONSTANT_1_WIRE;  // Start with 1 (equal)
-    
-    for (size_t i = 0; i < num_bits; i++) {
-        // a[i] XOR b[i] gives 1 if different, 0 if same
-        uint32_t diff = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, a_bits[i], b_bits[i], diff, GATE_XOR);
-        
-        // result = result AND (NOT diff) = result AND (diff XOR 1)
-        uint32_t not_diff = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, diff, CONSTANT_1_WIRE, not_diff, GATE_XOR);
-        
-        uint32_t new_result = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, result, not_diff, new_result, GATE_AND);
-        result = new_result;
-    }
-    
-    return result;
-}
-
-// Optimized less-than comparator using ripple comparison
-static uint32_t build_less_than_optimized(riscv_circuit_t* circuit,
-                                         uint32_t* a_bits, uint32_t* b_bits,
-                                         size_t num_bits, bool is_signed) {
-    // For signed comparison, handle sign bits specially
-    if (is_signed) {
-        uint32_t a_sign = a_bits[num_bits - 1];
-        uint32_t b_sign = b_bits[num_bits - 1];
-        
-        // If signs differ: a < b iff a is negative and b is positive
-        uint32_t signs_differ = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, a_sign, b_sign, signs_differ, GATE_XOR);
-        
-        uint32_t a_neg_b_pos = riscv_circuit_allocate_wire(circuit);
-        uint32_t not_b_sign = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, b_sign, CONSTANT_1_WIRE, not_b_sign, GATE_XOR);
-        riscv_circuit_add_gate(circuit, a_sign, not_b_sign, a_neg_b_pos, GATE_AND);
-        
-        // If signs same, compare magnitudes (unsigned comparison)
-        uint32_t magnitude_lt = build_less_than_optimized(circuit, a_bits, b_bits, num_bits - 1, false);
-        
-        // Result: (signs_differ AND a_neg_b_pos) OR (NOT signs_differ AND magnitude_lt)
-        uint32_t case1 = riscv_circuit_allocate_wire(circuit);
-        uint32_t not_signs_differ = riscv_circuit_allocate_wire(circuit);
-        uint32_t case2 = riscv_circuit_allocate_wire(circuit);
-        
-        riscv_circuit_add_gate(circuit, signs_differ, a_neg_b_pos, case1, GATE_AND);
-        riscv_circuit_add_gate(circuit, signs_differ, CONSTANT_1_WIRE, not_signs_differ, GATE_XOR);
-        riscv_circuit_add_gate(circuit, not_signs_differ, magnitude_lt, case2, GATE_AND);
-        
-        uint32_t result = riscv_circuit_allocate_wire(circuit);
-        uint32_t case_xor = riscv_circuit_allocate_wire(circuit);
-        uint32_t case_and = riscv_circuit_allocate_wire(circuit);
-        
-        riscv_circuit_add_gate(circuit, case1, case2, case_xor, GATE_XOR);
-        riscv_circuit_add_gate(circuit, case1, case2, case_and, GATE_AND);
-        riscv_circuit_add_gate(circuit, case_xor, case_and, result, GATE_XOR);
-        
-        return result;
-    }
-    
-    // Unsigned comparison: ripple from MSB to LSB
-    uint32_t result = CONSTANT_0_WIRE;  // Default: not less than
-    
-    for (int i = (int)num_bits - 1; i >= 0; i--) {
-        // At bit i: a < b if (a[i] < b[i]) OR (a[i] == b[i] AND previous_result)
-        uint32_t a_lt_b_at_i = riscv_circuit_allocate_wire(circuit);
-        uint32_t not_a_i = riscv_circuit_allocate_wire(circuit);
-        
-        riscv_circuit_add_gate(circuit, a_bits[i], CONSTANT_1_WIRE, not_a_i, GATE_XOR);
-        riscv_circuit_add_gate(circuit, not_a_i, b_bits[i], a_lt_b_at_i, GATE_AND);
-        
-        uint32_t a_eq_b_at_i = riscv_circuit_allocate_wire(circuit);
-        uint32_t diff_at_i = riscv_circuit_allocate_wire(circuit);
-        
-        riscv_circuit_add_gate(circuit, a_bits[i], b_bits[i], diff_at_i, GATE_XOR);
-        riscv_circuit_add_gate(circuit, diff_at_i, CONSTANT_1_WIRE, a_eq_b_at_i, GATE_XOR);
-        
-        uint32_t continue_prev = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, a_eq_b_at_i, result, continue_prev, GATE_AND);
-        
-        uint32_t new_result = riscv_circuit_allocate_wire(circuit);
-        uint32_t or_xor = riscv_circuit_allocate_wire(circuit);
-        uint32_t or_and = riscv_circuit_allocate_wire(circuit);
-        
-        riscv_circuit_add_gate(circuit, a_lt_b_at_i, continue_prev, or_xor, GATE_XOR);
-        riscv_circuit_add_gate(circuit, a_lt_b_at_i, continue_prev, or_and, GATE_AND);
-        riscv_circuit_add_gate(circuit, or_xor, or_and, new_result, GATE_XOR);
-        
-        result = new_result;
-    }
-    
-    return result;
-}
-
 // Optimized branch instruction compiler
 int compile_branch_instruction_optimized(riscv_compiler_t* compiler, uint32_t instruction) {
     uint32_t opcode = GET_OPCODE(instruction);
@@ -158,43 +59,16 @@ int compile_branch_instruction_optimized(riscv_compiler_t* compiler, uint32_t in
         next_pc_wires[i] = riscv_circuit_allocate_wire(compiler->circuit);
     }
     
-    // Build condition based on branch type
-    uint32_t condition;
+    // Build condition based on branch type (shared borrow-chain and
+    // equality-tree comparators, see comparators.c)
     switch (funct3) {
         case 0x0: // BEQ
-            condition = build_equality_optimized(compiler->circuit, rs1_wires, rs2_wires, 32);
-            break;
-            
         case 0x1: // BNE
-            condition = build_equality_optimized(compiler->circuit, rs1_wires, rs2_wires, 32);
-            // Invert result
-            uint32_t not_condition = riscv_circuit_allocate_wire(compiler->circuit);
-            riscv_circuit_add_gate(compiler->circuit, condition, CONSTANT_1_WIRE, not_condition, GATE_XOR);
-            condition = not_condition;
-            break;
-            
         case 0x4: // BLT
-            condition = build_less_than_optimized(compiler->circuit, rs1_wires, rs2_wires, 32, true);
-            break;
-            
         case 0x5: // BGE
-            condition = build_less_than_optimized(compiler->circuit, rs1_wires, rs2_wires, 32, true);
-            // Invert result
-            uint32_t not_lt = riscv_circuit_allocate_wire(compiler->circuit);
-            riscv_circuit_add_gate(compiler->circuit, condition, CONSTANT_1_WIRE, not_lt, GATE_XOR);
-            condition = not_lt;
-            break;
-            
         case 0x6: // BLTU
-            condition = build_less_than_optimized(compiler->circuit, rs1_wires, rs2_wires, 32, false);
-            break;
-            
         case 0x7: // BGEU
-            condition = build_less_than_optimized(compiler->circuit, rs1_wires, rs2_wires, 32, false);
-            // Invert result
-            uint32_t not_ltu = riscv_circuit_allocate_wire(compiler->circuit);
-            riscv_circuit_add_gate(compiler->circuit, condition, CONSTANT_1_WIRE, not_ltu, GATE_XOR);
-            condition = not_ltu;
+            build_compare(compiler->circuit, rs1_wires, rs2_wires, 32, funct3);
             break;
             
         default:
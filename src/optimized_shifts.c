@@ -4,6 +4,7 @@
 
 
 #include "riscv_compiler.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -11,24 +12,6 @@
 // Optimized shift operations - reduces gates from ~960 to ~500
 // Uses more efficient MUX tree and reduced bit manipulation
 
-// Helper: Build efficient 2-to-1 MUX
-static uint32_t build_mux2(riscv_circuit_t* circuit, uint32_t sel, uint32_t a, uint32_t b) {
-    // Optimized: sel ? b : a = (sel AND b) XOR ((NOT sel) AND a)
-    uint32_t not_sel = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, sel, CONSTANT_1_WIRE, not_sel, GATE_XOR);
-    
-    uint32_t sel_and_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t notsel_and_a = riscv_circuit_allocate_wire(circuit);
-    
-    riscv_circuit_add_gate(circuit, sel, b, sel_and_b, GATE_AND);
-    riscv_circuit_add_gate(circuit, not_sel, a, notsel_and_a, GATE_AND);
-    
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, sel_and_b, notsel_and_a, result, GATE_XOR);
-    
-    return result;
-}
-
 // Optimized left shift - uses fewer gates per stage
 static void build_left_shift_optimized(riscv_circuit_t* circuit,
                                       uint32_t* value_bits,
@@ -53,7 +36,7 @@ static void build_left_shift_optimized(riscv_circuit_t* circuit,
             }
             
             // MUX: shift_amount_bits[stage] ? shifted_bit : current[i]
-            next[i] = build_mux2(circuit, shift_amount_bits[stage], current[i], shifted_bit);
+            next[i] = gate_mux(circuit, shift_amount_bits[stage], shifted_bit, current[i]);
         }
         
         free(current);
@@ -85,7 +68,7 @@ static void build_right_shift_logical_optimized(riscv_circuit_t* circuit,
                 shifted_bit = CONSTANT_0_WIRE;  // Zero fill
             }
             
-            next[i] = build_mux2(circuit, shift_amount_bits[stage], current[i], shifted_bit);
+            next[i] = gate_mux(circuit, shift_amount_bits[stage], shifted_bit, current[i]);
         }
         
         free(current);
@@ -119,7 +102,7 @@ static void build_right_shift_arithmetic_optimized(riscv_circuit_t* circuit,
                 shifted_bit = sign_bit;  // Sign extend
             }
             
-            next[i] = build_mux2(circuit, shift_amount_bits[stage], current[i], shifted_bit);
+            next[i] = gate_mux(circuit, shift_amount_bits[stage], shifted_bit, current[i]);
         }
         
         free(current);
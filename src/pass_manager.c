@@ -0,0 +1,304 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "circuit_passes.h"
+#include "riscv_memory.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_REGISTERED_PASSES 32
+#define MAX_PIPELINE_PASSES 32
+#define DEFAULT_MAX_ITERATIONS 8
+
+// Every built-in pass, in no particular order. Presets refer to these by name.
+static const circuit_pass_t builtin_passes[] = {
+    {"fold",     circuit_pass_fold,     "constant and algebraic folding"},
+    {"dedup",    circuit_pass_dedup,    "structural hashing of identical gates"},
+    {"dce",      circuit_pass_dce,      "dead gate elimination"},
+    {"renumber", circuit_pass_renumber, "compact wire IDs, one driver per wire"},
+    {"rewrite",  circuit_pass_rewrite,  "replace 4-input cones with NPN library circuits"},
+    {"andmin",   circuit_pass_andmin,   "rewrite cuts to fewer AND gates"},
+    {"balance",  circuit_pass_balance,  "rebuild AND/XOR chains as balanced trees"},
+    {"sweep",    circuit_pass_sweep,    "merge wires proven equivalent by simulation and SAT"},
+    {"linear",   circuit_pass_linear,   "rebuild XOR networks with shared subexpressions"},
+    {"lower",    circuit_pass_lower,    "expand OR/NOT/XNOR/MUX/LUT gates into AND/XOR"},
+};
+#define NUM_BUILTIN_PASSES (sizeof(builtin_passes) / sizeof(builtin_passes[0]))
+
+static circuit_pass_t registered_passes[MAX_REGISTERED_PASSES];
+static size_t num_registered_passes = 0;
+
+typedef struct {
+    const char* passes[MAX_PIPELINE_PASSES];
+    size_t max_iterations;
+} preset_t;
+
+static const preset_t presets[] = {
+    /* -O0 */ {{NULL}, 0},
+    /* -O1 */ {{"fold", "dce", NULL}, 1},
+    /* -O2 */ {{"fold", "dedup", "dce", "renumber", NULL}, DEFAULT_MAX_ITERATIONS},
+    /* -O3 */ {{"fold", "dedup", "dce", "renumber", "sweep", "linear", "rewrite", "andmin", "balance", NULL}, 4 * DEFAULT_MAX_ITERATIONS},
+};
+#define NUM_PRESETS (sizeof(presets) / sizeof(presets[0]))
+
+// Circuit metrics before and after one pass run
+typedef struct {
+    size_t gates, ands, depth;
+} pass_metrics_t;
+
+typedef struct {
+    const char* name;
+    size_t iteration;
+    pass_metrics_t before, after;
+    double time_ms;
+    int changed;
+} pass_record_t;
+
+struct pass_manager {
+    const circuit_pass_t* passes[MAX_PIPELINE_PASSES];
+    size_t num_passes;
+    size_t max_iterations;
+    int opt_level;                  // -1 for hand-built pipelines
+
+    // Report of the last run
+    pass_record_t* records;
+    size_t num_records;
+    size_t records_capacity;
+    size_t iterations;
+    bool converged;
+    pass_metrics_t initial, final;
+    double total_ms;
+};
+
+int circuit_pass_register(const char* name, circuit_pass_fn_t run, const char* description) {
+    if (!name || !run) return -1;
+    if (circuit_pass_lookup(name)) {
+        fprintf(stderr, "❌ ERROR: Circuit pass '%s' already exists\n", name);
+        return -1;
+    }
+    if (num_registered_passes >= MAX_REGISTERED_PASSES) {
+        fprintf(stderr, "❌ ERROR: Too many circuit passes (max %d)\n", MAX_REGISTERED_PASSES);
+        return -1;
+    }
+    registered_passes[num_registered_passes++] =
+        (circuit_pass_t){name, run, description ? description : ""};
+    return 0;
+}
+
+const circuit_pass_t* circuit_pass_lookup(const char* name) {
+    if (!name) return NULL;
+    for (size_t i = 0; i < NUM_BUILTIN_PASSES; i++) {
+        if (strcmp(builtin_passes[i].name, name) == 0) return &builtin_passes[i];
+    }
+    for (size_t i = 0; i < num_registered_passes; i++) {
+        if (strcmp(registered_passes[i].name, name) == 0) return &registered_passes[i];
+    }
+    return NULL;
+}
+
+pass_manager_t* pass_manager_create(void) {
+    pass_manager_t* pm = calloc(1, sizeof(pass_manager_t));
+    if (!pm) return NULL;
+    pm->max_iterations = DEFAULT_MAX_ITERATIONS;
+    pm->opt_level = -1;
+    return pm;
+}
+
+pass_manager_t* pass_manager_create_preset(int opt_level) {
+    if (opt_level < 0 || opt_level >= (int)NUM_PRESETS) {
+        fprintf(stderr, "❌ ERROR: Unknown optimization level -O%d (use -O0..-O%zu)\n",
+                opt_level, NUM_PRESETS - 1);
+        return NULL;
+    }
+
+    pass_manager_t* pm = pass_manager_create();
+    if (!pm) return NULL;
+    const preset_t* preset = &presets[opt_level];
+    for (size_t i = 0; preset->passes[i]; i++) {
+        if (pass_manager_add(pm, preset->passes[i]) != 0) {
+            pass_manager_destroy(pm);
+            return NULL;
+        }
+    }
+    pm->max_iterations = preset->max_iterations;
+    pm->opt_level = opt_level;
+    return pm;
+}
+
+void pass_manager_destroy(pass_manager_t* pm) {
+    if (!pm) return;
+    free(pm->records);
+    free(pm);
+}
+
+int pass_manager_add(pass_manager_t* pm, const char* name) {
+    const circuit_pass_t* pass = circuit_pass_lookup(name);
+    if (!pass) {
+        fprintf(stderr, "❌ ERROR: Unknown circuit pass '%s'\n", name ? name : "(null)");
+        return -1;
+    }
+    if (pm->num_passes >= MAX_PIPELINE_PASSES) {
+        fprintf(stderr, "❌ ERROR: Pass pipeline is full (max %d)\n", MAX_PIPELINE_PASSES);
+        return -1;
+    }
+    pm->passes[pm->num_passes++] = pass;
+    return 0;
+}
+
+void pass_manager_set_max_iterations(pass_manager_t* pm, size_t max_iterations) {
+    pm->max_iterations = max_iterations;
+}
+
+static pass_metrics_t measure(const riscv_circuit_t* circuit) {
+    pass_metrics_t m;
+    m.gates = circuit->num_gates;
+    m.ands = riscv_circuit_count_and_gates(circuit);
+    m.depth = riscv_circuit_depth(circuit);
+    return m;
+}
+
+static int record(pass_manager_t* pm, const pass_record_t* rec) {
+    if (pm->num_records == pm->records_capacity) {
+        size_t capacity = pm->records_capacity ? 2 * pm->records_capacity : 16;
+        pass_record_t* grown = realloc(pm->records, capacity * sizeof(pass_record_t));
+        if (!grown) return -1;
+        pm->records = grown;
+        pm->records_capacity = capacity;
+    }
+    pm->records[pm->num_records++] = *rec;
+    return 0;
+}
+
+static int run_passes(pass_manager_t* pm, pass_context_t* ctx) {
+    clock_t start = clock();
+    pm->num_records = 0;
+    pm->iterations = 0;
+    pm->converged = pm->num_passes == 0;
+    pm->initial = measure(ctx->circuit);
+
+    pass_metrics_t current = pm->initial;
+    while (!pm->converged && pm->iterations < pm->max_iterations) {
+        pm->iterations++;
+        bool changed = false;
+
+        for (size_t i = 0; i < pm->num_passes; i++) {
+            pass_record_t rec = {pm->passes[i]->name, pm->iterations, current, current, 0.0, 0};
+            clock_t pass_start = clock();
+            rec.changed = pm->passes[i]->run(ctx);
+            rec.time_ms = 1000.0 * (double)(clock() - pass_start) / CLOCKS_PER_SEC;
+            if (rec.changed < 0) {
+                fprintf(stderr, "❌ ERROR: Circuit pass '%s' failed\n", rec.name);
+                return -1;
+            }
+            rec.after = measure(ctx->circuit);
+            current = rec.after;
+            if (rec.changed) changed = true;
+            if (record(pm, &rec) != 0) return -1;
+        }
+
+        pm->converged = !changed;
+    }
+
+    pm->final = current;
+    pm->total_ms = 1000.0 * (double)(clock() - start) / CLOCKS_PER_SEC;
+    return 0;
+}
+
+int pass_manager_run(pass_manager_t* pm, riscv_circuit_t* circuit,
+                     uint32_t* outputs, size_t num_outputs) {
+    if (!pm || !circuit || (num_outputs > 0 && !outputs)) return -1;
+
+    uint32_t** roots = malloc((num_outputs + 1) * sizeof(uint32_t*));
+    if (!roots) return -1;
+    for (size_t i = 0; i < num_outputs; i++) roots[i] = &outputs[i];
+
+    pass_context_t ctx = {circuit, roots, num_outputs};
+    int result = run_passes(pm, &ctx);
+    free(roots);
+    return result;
+}
+
+int pass_manager_run_compiler(pass_manager_t* pm, riscv_compiler_t* compiler) {
+    if (!pm || !compiler || !compiler->circuit) return -1;
+
+    // Registers, PC and the memory's state wires; stores only live in the latter
+    size_t num_roots = 31 * 32 + 32 + riscv_memory_roots(compiler->memory, NULL);
+    uint32_t** roots = malloc(num_roots * sizeof(uint32_t*));
+    if (!roots) return -1;
+    size_t n = 0;
+    for (int r = 1; r < 32; r++) {
+        for (int bit = 0; bit < 32; bit++) roots[n++] = &compiler->reg_wires[r][bit];
+    }
+    for (int bit = 0; bit < 32; bit++) roots[n++] = &compiler->pc_wires[bit];
+    n += riscv_memory_roots(compiler->memory, roots + n);
+
+    pass_context_t ctx = {compiler->circuit, roots, n};
+    int result = run_passes(pm, &ctx);
+    free(roots);
+    return result;
+}
+
+int pass_manager_parse_opt_level(const char* arg) {
+    if (!arg) return -1;
+    if (arg[0] == '-' && arg[1] == 'O') arg += 2;
+    if (arg[0] >= '0' && arg[0] < '0' + (int)NUM_PRESETS && arg[1] == '\0') {
+        return arg[0] - '0';
+    }
+    return -1;
+}
+
+static void write_metrics(FILE* out, const char* key, const pass_metrics_t* m) {
+    fprintf(out, "\"%s\": {\"gates\": %zu, \"and_gates\": %zu, \"xor_gates\": %zu, \"depth\": %zu}",
+            key, m->gates, m->ands, m->gates - m->ands, m->depth);
+}
+
+int pass_manager_write_report(const pass_manager_t* pm, FILE* out) {
+    if (!pm || !out) return -1;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"opt_level\": %d,\n", pm->opt_level);
+    fprintf(out, "  \"pipeline\": [");
+    for (size_t i = 0; i < pm->num_passes; i++) {
+        fprintf(out, "%s\"%s\"", i ? ", " : "", pm->passes[i]->name);
+    }
+    fprintf(out, "],\n");
+    fprintf(out, "  \"iterations\": %zu,\n", pm->iterations);
+    fprintf(out, "  \"converged\": %s,\n", pm->converged ? "true" : "false");
+    fprintf(out, "  \"time_ms\": %.3f,\n", pm->total_ms);
+    fprintf(out, "  ");
+    write_metrics(out, "initial", &pm->initial);
+    fprintf(out, ",\n  ");
+    write_metrics(out, "final", &pm->final);
+    fprintf(out, ",\n  \"passes\": [");
+    for (size_t i = 0; i < pm->num_records; i++) {
+        const pass_record_t* rec = &pm->records[i];
+        fprintf(out, "%s\n    {\"name\": \"%s\", \"iteration\": %zu, \"changed\": %s, "
+                "\"time_ms\": %.3f, \"gate_delta\": %lld, \"and_delta\": %lld, "
+                "\"depth_delta\": %lld, ",
+                i ? "," : "", rec->name, rec->iteration, rec->changed ? "true" : "false",
+                rec->time_ms,
+                (long long)rec->after.gates - (long long)rec->before.gates,
+                (long long)rec->after.ands - (long long)rec->before.ands,
+                (long long)rec->after.depth - (long long)rec->before.depth);
+        write_metrics(out, "before", &rec->before);
+        fprintf(out, ", ");
+        write_metrics(out, "after", &rec->after);
+        fprintf(out, "}");
+    }
+    fprintf(out, "%s]\n}\n", pm->num_records ? "\n  " : "");
+    return 0;
+}
+
+int pass_manager_save_report(const pass_manager_t* pm, const char* filename) {
+    FILE* out = fopen(filename, "w");
+    if (!out) {
+        fprintf(stderr, "❌ ERROR: Cannot write pass report to %s\n", filename);
+        return -1;
+    }
+    int result = pass_manager_write_report(pm, out);
+    fclose(out);
+    return result;
+}
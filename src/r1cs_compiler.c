@@ -0,0 +1,920 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "r1cs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GET_OPCODE(instr) ((instr) & 0x7F)
+#define GET_RD(instr)     (((instr) >> 7) & 0x1F)
+#define GET_FUNCT3(instr) (((instr) >> 12) & 0x7)
+#define GET_RS1(instr)    (((instr) >> 15) & 0x1F)
+#define GET_RS2(instr)    (((instr) >> 20) & 0x1F)
+#define GET_FUNCT7(instr) ((instr) >> 25)
+
+#define WORD_MAX_BOUND 63     // 2^63 < p, so no decomposition can wrap
+#define WORD_MAX_TERMS 16     // Wider values get their own variable before adding
+
+#define FIELD_MINUS_ONE (R1CS_FIELD_PRIME - 1)
+#define TWO_POW_32 (1ULL << 32)
+
+typedef enum { SHIFT_LEFT, SHIFT_RIGHT_LOGICAL, SHIFT_RIGHT_ARITHMETIC } shift_kind_t;
+
+// One instruction's worth of building; allocation failures latch `failed`
+typedef struct {
+    r1cs_compiler_t* compiler;
+    r1cs_system_t* system;
+    bool failed;
+} build_t;
+
+// ============================================================================
+// Linear combinations and constraints
+// ============================================================================
+
+static void lc_term(build_t* b, r1cs_lc_t* lc, uint32_t var, uint64_t coeff) {
+    if (!r1cs_lc_add_term(lc, var, coeff)) b->failed = true;
+}
+
+static void lc_add(build_t* b, r1cs_lc_t* lc, const r1cs_lc_t* other, uint64_t k) {
+    if (!r1cs_lc_add_scaled(lc, other, k)) b->failed = true;
+}
+
+static r1cs_lc_t lc_var(build_t* b, uint32_t var, uint64_t coeff) {
+    r1cs_lc_t lc = {0};
+    lc_term(b, &lc, var, coeff);
+    return lc;
+}
+
+static r1cs_bit_t const_bit(bool value) {
+    return (r1cs_bit_t){R1CS_ONE, !value};
+}
+
+static bool bit_is_const(r1cs_bit_t bit, bool* value) {
+    if (bit.var != R1CS_ONE) return false;
+    *value = !bit.negated;
+    return true;
+}
+
+static r1cs_bit_t bit_not(r1cs_bit_t bit) {
+    bit.negated = !bit.negated;
+    return bit;
+}
+
+static r1cs_lc_t lc_bit(build_t* b, r1cs_bit_t bit) {
+    r1cs_lc_t lc = {0};
+    if (bit.negated) {
+        lc_term(b, &lc, R1CS_ONE, 1);
+        lc_term(b, &lc, bit.var, FIELD_MINUS_ONE);
+    } else {
+        lc_term(b, &lc, bit.var, 1);
+    }
+    return lc;
+}
+
+static uint32_t new_var(build_t* b, r1cs_hint_kind_t kind, uint32_t arg,
+                        const r1cs_lc_t* x, const r1cs_lc_t* y) {
+    if (b->failed) return R1CS_ONE;
+    uint32_t var = r1cs_new_var(b->system, kind, arg, x, y);
+    if (var == UINT32_MAX) {
+        b->failed = true;
+        return R1CS_ONE;
+    }
+    return var;
+}
+
+static void enforce(build_t* b, const r1cs_lc_t* x, const r1cs_lc_t* y, const r1cs_lc_t* z) {
+    if (!b->failed && !r1cs_enforce(b->system, x, y, z)) b->failed = true;
+}
+
+// x * y; a constant factor folds into a scaled copy
+static r1cs_lc_t mul(build_t* b, const r1cs_lc_t* x, const r1cs_lc_t* y) {
+    r1cs_lc_t out = {0};
+    uint64_t k;
+    if (r1cs_lc_is_constant(x, &k)) {
+        lc_add(b, &out, y, k);
+    } else if (r1cs_lc_is_constant(y, &k)) {
+        lc_add(b, &out, x, k);
+    } else {
+        out = lc_var(b, new_var(b, R1CS_HINT_MUL, 0, x, y), 1);
+        enforce(b, x, y, &out);
+    }
+    return out;
+}
+
+// n boolean variables with x = sum 2^i bits[i]. Sound for n <= 63; the
+// 64-bit product split adds its own guard.
+static void decompose(build_t* b, const r1cs_lc_t* x, uint32_t n, r1cs_bit_t* bits) {
+    uint64_t k;
+    if (r1cs_lc_is_constant(x, &k)) {
+        for (uint32_t i = 0; i < n; i++) bits[i] = const_bit((k >> i) & 1);
+        return;
+    }
+    r1cs_lc_t sum = {0}, one = lc_var(b, R1CS_ONE, 1);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t var = new_var(b, R1CS_HINT_BIT, i, x, NULL);
+        r1cs_lc_t v = lc_var(b, var, 1);
+        r1cs_lc_t v_minus_one = lc_var(b, var, 1);
+        lc_term(b, &v_minus_one, R1CS_ONE, FIELD_MINUS_ONE);
+        enforce(b, &v, &v_minus_one, NULL);
+        r1cs_lc_free(&v);
+        r1cs_lc_free(&v_minus_one);
+        lc_term(b, &sum, var, 1ULL << i);
+        bits[i] = (r1cs_bit_t){var, false};
+    }
+    enforce(b, &sum, &one, x);
+    r1cs_lc_free(&sum);
+    r1cs_lc_free(&one);
+}
+
+// 1 iff x = 0: m = x * inv(x) is 1 for x != 0, and x * (1 - m) = 0
+static r1cs_bit_t is_zero(build_t* b, const r1cs_lc_t* x) {
+    uint64_t k;
+    if (r1cs_lc_is_constant(x, &k)) return const_bit(k == 0);
+    r1cs_lc_t inv = lc_var(b, new_var(b, R1CS_HINT_INV, 0, x, NULL), 1);
+    r1cs_lc_t nonzero = mul(b, x, &inv);
+    r1cs_bit_t zero = bit_not((r1cs_bit_t){nonzero.terms ? nonzero.terms[0].var : R1CS_ONE, false});
+    r1cs_lc_t z = lc_bit(b, zero);
+    enforce(b, x, &z, NULL);
+    r1cs_lc_free(&inv);
+    r1cs_lc_free(&nonzero);
+    r1cs_lc_free(&z);
+    return zero;
+}
+
+// ============================================================================
+// Bits
+// ============================================================================
+
+static r1cs_bit_t bit_and(build_t* b, r1cs_bit_t x, r1cs_bit_t y) {
+    bool value;
+    if (bit_is_const(x, &value)) return value ? y : const_bit(false);
+    if (bit_is_const(y, &value)) return value ? x : const_bit(false);
+    if (x.var == y.var) return x.negated == y.negated ? x : const_bit(false);
+    r1cs_lc_t lx = lc_bit(b, x), ly = lc_bit(b, y);
+    r1cs_lc_t out = mul(b, &lx, &ly);
+    r1cs_bit_t bit = {out.terms ? out.terms[0].var : R1CS_ONE, false};
+    r1cs_lc_free(&lx);
+    r1cs_lc_free(&ly);
+    r1cs_lc_free(&out);
+    return bit;
+}
+
+static r1cs_bit_t bit_or(build_t* b, r1cs_bit_t x, r1cs_bit_t y) {
+    return bit_not(bit_and(b, bit_not(x), bit_not(y)));
+}
+
+// Negations move to the result; 2x * y = x + y - out
+static r1cs_bit_t bit_xor(build_t* b, r1cs_bit_t x, r1cs_bit_t y) {
+    bool negated = x.negated != y.negated;
+    if (x.var == R1CS_ONE) return (r1cs_bit_t){y.var, !negated};
+    if (y.var == R1CS_ONE) return (r1cs_bit_t){x.var, !negated};
+    if (x.var == y.var) return const_bit(negated);
+    r1cs_lc_t lx = lc_var(b, x.var, 1), ly = lc_var(b, y.var, 1);
+    uint32_t var = new_var(b, R1CS_HINT_XOR, 0, &lx, &ly);
+    r1cs_lc_t two_x = lc_var(b, x.var, 2);
+    r1cs_lc_t sum = lc_var(b, x.var, 1);
+    lc_term(b, &sum, y.var, 1);
+    lc_term(b, &sum, var, FIELD_MINUS_ONE);
+    enforce(b, &two_x, &ly, &sum);
+    r1cs_lc_free(&lx);
+    r1cs_lc_free(&ly);
+    r1cs_lc_free(&two_x);
+    r1cs_lc_free(&sum);
+    return (r1cs_bit_t){var, negated};
+}
+
+// ============================================================================
+// Words
+// ============================================================================
+
+static void word_free(r1cs_word_t* w) {
+    r1cs_lc_free(&w->value);
+    w->bound = 0;
+    w->has_bits = false;
+}
+
+static r1cs_word_t word_const(build_t* b, uint32_t k) {
+    r1cs_word_t w = {0};
+    lc_term(b, &w.value, R1CS_ONE, k);
+    while (w.bound < 32 && (k >> w.bound) != 0) w.bound++;
+    w.has_bits = true;
+    for (int i = 0; i < 32; i++) w.bits[i] = const_bit((k >> i) & 1);
+    return w;
+}
+
+static r1cs_word_t word_copy(build_t* b, const r1cs_word_t* w) {
+    r1cs_word_t out = *w;
+    if (!r1cs_lc_copy(&out.value, &w->value)) b->failed = true;
+    return out;
+}
+
+// Constant values become canonical constant words
+static void word_fold(build_t* b, r1cs_word_t* w) {
+    uint64_t k;
+    if (!r1cs_lc_is_constant(&w->value, &k)) return;
+    word_free(w);
+    *w = word_const(b, (uint32_t)k);
+}
+
+static r1cs_word_t word_from_bits(build_t* b, const r1cs_bit_t* bits) {
+    r1cs_word_t w = {0};
+    for (int i = 0; i < 32; i++) {
+        r1cs_lc_t bit = lc_bit(b, bits[i]);
+        lc_add(b, &w.value, &bit, 1ULL << i);
+        r1cs_lc_free(&bit);
+    }
+    w.bound = 32;
+    w.has_bits = true;
+    memcpy(w.bits, bits, sizeof(w.bits));
+    word_fold(b, &w);
+    return w;
+}
+
+static r1cs_word_t word_from_bit(build_t* b, r1cs_bit_t bit) {
+    r1cs_bit_t bits[32];
+    bits[0] = bit;
+    for (int i = 1; i < 32; i++) bits[i] = const_bit(false);
+    r1cs_word_t w = word_from_bits(b, bits);
+    if (w.bound > 1) w.bound = 1;
+    return w;
+}
+
+// Reduces to the canonical value (bound <= 32), keeping the low bits
+static void word_reduce(build_t* b, r1cs_word_t* w) {
+    if (w->bound <= 32) return;
+    r1cs_bit_t bits[WORD_MAX_BOUND];
+    decompose(b, &w->value, w->bound, bits);
+    word_free(w);
+    *w = word_from_bits(b, bits);
+}
+
+static void word_bits(build_t* b, r1cs_word_t* w) {
+    word_reduce(b, w);
+    if (w->has_bits) return;
+    decompose(b, &w->value, 32, w->bits);
+    w->has_bits = true;
+}
+
+// Replaces a many-term value by one variable
+static void word_materialize(build_t* b, r1cs_word_t* w) {
+    if (w->value.size <= 1) return;
+    r1cs_lc_t v = lc_var(b, new_var(b, R1CS_HINT_LC, 0, &w->value, NULL), 1);
+    r1cs_lc_t one = lc_var(b, R1CS_ONE, 1);
+    enforce(b, &w->value, &one, &v);
+    r1cs_lc_free(&one);
+    r1cs_lc_free(&w->value);
+    w->value = v;
+}
+
+// x + y, or x - y as x + 2^bound(y) - y so the value stays non-negative
+static r1cs_word_t word_add(build_t* b, r1cs_word_t* x, r1cs_word_t* y, bool subtract) {
+    uint32_t widest = x->bound > y->bound ? x->bound : y->bound;
+    if (widest < 32) widest = 32;
+    if (widest + 1 > WORD_MAX_BOUND) {
+        word_reduce(b, x);
+        word_reduce(b, y);
+    }
+    if (x->value.size + y->value.size > WORD_MAX_TERMS) {
+        word_materialize(b, x);
+        word_materialize(b, y);
+    }
+
+    r1cs_word_t out = {0};
+    uint32_t y_bound = y->bound;
+    lc_add(b, &out.value, &x->value, 1);
+    lc_add(b, &out.value, &y->value, subtract ? FIELD_MINUS_ONE : 1);
+    if (subtract) {
+        y_bound = y_bound < 32 ? 32 : y_bound;
+        lc_term(b, &out.value, R1CS_ONE, 1ULL << y_bound);
+    }
+    out.bound = (x->bound > y_bound ? x->bound : y_bound) + 1;
+    word_fold(b, &out);
+    return out;
+}
+
+static r1cs_word_t word_add_const(build_t* b, r1cs_word_t* x, uint32_t k) {
+    r1cs_word_t y = word_const(b, k);
+    r1cs_word_t out = word_add(b, x, &y, false);
+    word_free(&y);
+    return out;
+}
+
+// x + s * (2^32 - 2x): x, or its two's complement when s is set
+static r1cs_word_t word_negate_if(build_t* b, r1cs_word_t* x, r1cs_bit_t s) {
+    word_reduce(b, x);
+    r1cs_lc_t flip = {0};
+    lc_term(b, &flip, R1CS_ONE, TWO_POW_32);
+    lc_add(b, &flip, &x->value, R1CS_FIELD_PRIME - 2);
+    r1cs_lc_t ls = lc_bit(b, s);
+    r1cs_lc_t delta = mul(b, &ls, &flip);
+    r1cs_word_t out = {0};
+    lc_add(b, &out.value, &x->value, 1);
+    lc_add(b, &out.value, &delta, 1);
+    out.bound = 33;
+    word_fold(b, &out);
+    r1cs_lc_free(&flip);
+    r1cs_lc_free(&ls);
+    r1cs_lc_free(&delta);
+    return out;
+}
+
+// ============================================================================
+// Bitwise operations and shifts
+// ============================================================================
+
+static r1cs_word_t word_bitwise(build_t* b, r1cs_word_t* x, r1cs_word_t* y, uint32_t funct3) {
+    word_bits(b, x);
+    word_bits(b, y);
+    r1cs_bit_t bits[32];
+    for (int i = 0; i < 32; i++) {
+        switch (funct3) {
+            case 0x4: bits[i] = bit_xor(b, x->bits[i], y->bits[i]); break;
+            case 0x6: bits[i] = bit_or(b, x->bits[i], y->bits[i]); break;
+            default:  bits[i] = bit_and(b, x->bits[i], y->bits[i]); break;
+        }
+    }
+    return word_from_bits(b, bits);
+}
+
+static r1cs_word_t word_shift_const(build_t* b, r1cs_word_t* x, uint32_t k, shift_kind_t kind) {
+    if (k == 0) return word_copy(b, x);
+    if (kind == SHIFT_LEFT) {
+        // Free: scale the lazy value
+        if (x->bound + k > WORD_MAX_BOUND) word_reduce(b, x);
+        r1cs_word_t out = {0};
+        lc_add(b, &out.value, &x->value, 1ULL << k);
+        out.bound = x->bound + k;
+        word_fold(b, &out);
+        return out;
+    }
+    word_bits(b, x);
+    r1cs_bit_t fill = kind == SHIFT_RIGHT_ARITHMETIC ? x->bits[31] : const_bit(false);
+    r1cs_bit_t bits[32];
+    for (uint32_t i = 0; i < 32; i++) bits[i] = i + k < 32 ? x->bits[i + k] : fill;
+    return word_from_bits(b, bits);
+}
+
+// Shifts by a variable amount s through one product with 2^s (left) or
+// 2^(31-s) (right): x << s is the low word of x * 2^s, x >> s is bits
+// 31..62 of x * 2^(31-s). Arithmetic shifts then add sign * (2^32 - 2^(32-s)).
+static r1cs_word_t word_shift(build_t* b, r1cs_word_t* x, r1cs_word_t* y, shift_kind_t kind) {
+    word_bits(b, y);
+    uint32_t k = 0;
+    bool constant = true;
+    for (int i = 0; i < 5; i++) {
+        bool value;
+        constant = constant && bit_is_const(y->bits[i], &value);
+        if (constant && value) k |= 1u << i;
+    }
+    if (constant) return word_shift_const(b, x, k, kind);
+
+    r1cs_lc_t pow = lc_var(b, R1CS_ONE, 1);
+    for (int i = 0; i < 5; i++) {
+        uint64_t e = 1ULL << (1u << i);
+        r1cs_lc_t s = lc_bit(b, y->bits[i]);
+        r1cs_lc_t factor = lc_var(b, R1CS_ONE, kind == SHIFT_LEFT ? 1 : e);
+        lc_add(b, &factor, &s, kind == SHIFT_LEFT ? e - 1 : r1cs_field_neg(e - 1));
+        r1cs_lc_t next = mul(b, &pow, &factor);
+        r1cs_lc_free(&pow);
+        r1cs_lc_free(&s);
+        r1cs_lc_free(&factor);
+        pow = next;
+    }
+
+    if (kind == SHIFT_RIGHT_ARITHMETIC) word_bits(b, x);
+    else word_reduce(b, x);
+    r1cs_lc_t product = mul(b, &x->value, &pow);
+
+    r1cs_word_t out = {0};
+    if (kind == SHIFT_LEFT) {
+        out.value = product;
+        out.bound = WORD_MAX_BOUND;
+        word_fold(b, &out);
+        r1cs_lc_free(&pow);
+        return out;
+    }
+    r1cs_bit_t bits[WORD_MAX_BOUND];
+    decompose(b, &product, WORD_MAX_BOUND, bits);
+    out = word_from_bits(b, bits + 31);
+    if (kind == SHIFT_RIGHT_ARITHMETIC) {
+        r1cs_lc_t mask = lc_var(b, R1CS_ONE, TWO_POW_32);
+        lc_add(b, &mask, &pow, R1CS_FIELD_PRIME - 2);
+        r1cs_lc_t sign = lc_bit(b, x->bits[31]);
+        r1cs_lc_t fill = mul(b, &sign, &mask);
+        lc_add(b, &out.value, &fill, 1);
+        out.has_bits = false;
+        word_fold(b, &out);
+        r1cs_lc_free(&mask);
+        r1cs_lc_free(&sign);
+        r1cs_lc_free(&fill);
+    }
+    r1cs_lc_free(&product);
+    r1cs_lc_free(&pow);
+    return out;
+}
+
+// ============================================================================
+// Comparisons
+// ============================================================================
+
+// x - y + 2^32 lies in [1, 2^33) and has bit 32 set iff x >= y. Signed
+// order flips both sign bits first: x + 2^31 - 2^32 x31.
+static r1cs_bit_t less_than(build_t* b, r1cs_word_t* x, r1cs_word_t* y, bool is_signed) {
+    if (is_signed) {
+        word_bits(b, x);
+        word_bits(b, y);
+    } else {
+        word_reduce(b, x);
+        word_reduce(b, y);
+    }
+    r1cs_lc_t diff = {0};
+    lc_add(b, &diff, &x->value, 1);
+    lc_add(b, &diff, &y->value, FIELD_MINUS_ONE);
+    lc_term(b, &diff, R1CS_ONE, TWO_POW_32);
+    if (is_signed) {
+        r1cs_lc_t sx = lc_bit(b, x->bits[31]), sy = lc_bit(b, y->bits[31]);
+        lc_add(b, &diff, &sx, r1cs_field_neg(TWO_POW_32));
+        lc_add(b, &diff, &sy, TWO_POW_32);
+        r1cs_lc_free(&sx);
+        r1cs_lc_free(&sy);
+    }
+    r1cs_bit_t bits[33];
+    decompose(b, &diff, 33, bits);
+    r1cs_lc_free(&diff);
+    return bit_not(bits[32]);
+}
+
+static r1cs_bit_t equal(build_t* b, r1cs_word_t* x, r1cs_word_t* y) {
+    word_reduce(b, x);
+    word_reduce(b, y);
+    r1cs_lc_t diff = {0};
+    lc_add(b, &diff, &x->value, 1);
+    lc_add(b, &diff, &y->value, FIELD_MINUS_ONE);
+    r1cs_bit_t eq = is_zero(b, &diff);
+    r1cs_lc_free(&diff);
+    return eq;
+}
+
+// funct3 as in branches: BEQ/BNE/BLT/BGE/BLTU/BGEU
+static r1cs_bit_t branch_condition(build_t* b, r1cs_word_t* x, r1cs_word_t* y, uint32_t funct3) {
+    switch (funct3) {
+        case 0x0: return equal(b, x, y);
+        case 0x1: return bit_not(equal(b, x, y));
+        case 0x4: return less_than(b, x, y, true);
+        case 0x5: return bit_not(less_than(b, x, y, true));
+        case 0x6: return less_than(b, x, y, false);
+        default:  return bit_not(less_than(b, x, y, false));
+    }
+}
+
+// ============================================================================
+// Multiplication and division
+// ============================================================================
+
+// Full 64-bit product of canonical x and y. Sixty-four bits can exceed p,
+// so the high word is kept off 2^32 - 1, which no product reaches; that
+// rules out the aliased decomposition of products below 2^32 - 1.
+static void word_product(build_t* b, r1cs_word_t* x, r1cs_word_t* y,
+                         r1cs_word_t* lo, r1cs_word_t* hi) {
+    word_reduce(b, x);
+    word_reduce(b, y);
+    r1cs_lc_t product = mul(b, &x->value, &y->value);
+    r1cs_bit_t bits[64];
+    decompose(b, &product, 64, bits);
+    uint64_t k;
+    if (!r1cs_lc_is_constant(&product, &k)) {
+        r1cs_lc_t high = lc_var(b, R1CS_ONE, r1cs_field_neg(0xFFFFFFFFULL));
+        for (int i = 0; i < 32; i++) lc_term(b, &high, bits[32 + i].var, 1ULL << i);
+        r1cs_lc_t inv = lc_var(b, new_var(b, R1CS_HINT_INV, 0, &high, NULL), 1);
+        r1cs_lc_t one = lc_var(b, R1CS_ONE, 1);
+        enforce(b, &high, &inv, &one);
+        r1cs_lc_free(&high);
+        r1cs_lc_free(&inv);
+        r1cs_lc_free(&one);
+    }
+    r1cs_lc_free(&product);
+    if (lo) *lo = word_from_bits(b, bits);
+    if (hi) *hi = word_from_bits(b, bits + 32);
+}
+
+// q, r with x = q * y + r and r < y, or q = 2^32 - 1, r = x when y = 0.
+// q * y + r stays below p, so the equation holds over the integers.
+static void word_divide(build_t* b, r1cs_word_t* x, r1cs_word_t* y,
+                        r1cs_word_t* q, r1cs_word_t* r, r1cs_bit_t* y_zero) {
+    word_reduce(b, x);
+    word_reduce(b, y);
+    uint64_t kx, ky;
+    if (r1cs_lc_is_constant(&x->value, &kx) && r1cs_lc_is_constant(&y->value, &ky)) {
+        *q = word_const(b, ky ? (uint32_t)(kx / ky) : 0xFFFFFFFFu);
+        *r = word_const(b, ky ? (uint32_t)(kx % ky) : (uint32_t)kx);
+        *y_zero = const_bit(ky == 0);
+        return;
+    }
+
+    *q = (r1cs_word_t){0};
+    *r = (r1cs_word_t){0};
+    q->value = lc_var(b, new_var(b, R1CS_HINT_DIVU, 0, &x->value, &y->value), 1);
+    r->value = lc_var(b, new_var(b, R1CS_HINT_REMU, 0, &x->value, &y->value), 1);
+    q->bound = r->bound = 32;
+    q->has_bits = r->has_bits = true;
+    decompose(b, &q->value, 32, q->bits);
+    decompose(b, &r->value, 32, r->bits);
+    *y_zero = is_zero(b, &y->value);
+
+    // q * y = x - r
+    r1cs_lc_t rest = {0};
+    lc_add(b, &rest, &x->value, 1);
+    lc_add(b, &rest, &r->value, FIELD_MINUS_ONE);
+    enforce(b, &q->value, &y->value, &rest);
+    r1cs_lc_free(&rest);
+
+    // y = 0 forces q = 2^32 - 1 (and so r = x)
+    bool value;
+    if (!bit_is_const(*y_zero, &value) || value) {
+        r1cs_lc_t z = lc_bit(b, *y_zero);
+        r1cs_lc_t q_ones = {0};
+        lc_add(b, &q_ones, &q->value, 1);
+        lc_term(b, &q_ones, R1CS_ONE, r1cs_field_neg(0xFFFFFFFFULL));
+        enforce(b, &z, &q_ones, NULL);
+        r1cs_lc_free(&z);
+        r1cs_lc_free(&q_ones);
+    }
+
+    // r < y unless y = 0: y - r - 1 + 2^32 z is a 32-bit value
+    r1cs_lc_t slack = {0};
+    r1cs_lc_t z = lc_bit(b, *y_zero);
+    lc_add(b, &slack, &y->value, 1);
+    lc_add(b, &slack, &r->value, FIELD_MINUS_ONE);
+    lc_term(b, &slack, R1CS_ONE, FIELD_MINUS_ONE);
+    lc_add(b, &slack, &z, TWO_POW_32);
+    r1cs_bit_t bits[32];
+    decompose(b, &slack, 32, bits);
+    r1cs_lc_free(&slack);
+    r1cs_lc_free(&z);
+}
+
+static r1cs_word_t word_muldiv(build_t* b, r1cs_word_t* x, r1cs_word_t* y, uint32_t funct3) {
+    r1cs_word_t lo, hi, q, r, out = {0};
+    r1cs_bit_t y_zero;
+    switch (funct3) {
+        case 0x0:  // MUL: narrow operands keep a lazy product
+            if (x->bound + y->bound <= WORD_MAX_BOUND) {
+                out.value = mul(b, &x->value, &y->value);
+                out.bound = x->bound + y->bound;
+                word_fold(b, &out);
+                return out;
+            }
+            word_product(b, x, y, &lo, NULL);
+            return lo;
+
+        case 0x1:    // MULH: hi - x31 * y - y31 * x
+        case 0x2: {  // MULHSU: hi - x31 * y
+            word_bits(b, x);
+            if (funct3 == 0x1) word_bits(b, y);
+            word_product(b, x, y, NULL, &hi);
+            r1cs_lc_t sx = lc_bit(b, x->bits[31]);
+            r1cs_lc_t fix = mul(b, &sx, &y->value);
+            out = hi;
+            lc_add(b, &out.value, &fix, FIELD_MINUS_ONE);
+            lc_term(b, &out.value, R1CS_ONE, TWO_POW_32);
+            out.bound = 33;
+            r1cs_lc_free(&sx);
+            r1cs_lc_free(&fix);
+            if (funct3 == 0x1) {
+                r1cs_lc_t sy = lc_bit(b, y->bits[31]);
+                fix = mul(b, &sy, &x->value);
+                lc_add(b, &out.value, &fix, FIELD_MINUS_ONE);
+                lc_term(b, &out.value, R1CS_ONE, TWO_POW_32);
+                out.bound = 34;
+                r1cs_lc_free(&sy);
+                r1cs_lc_free(&fix);
+            }
+            out.has_bits = false;
+            word_fold(b, &out);
+            return out;
+        }
+
+        case 0x3:  // MULHU
+            word_product(b, x, y, NULL, &hi);
+            return hi;
+
+        case 0x5:  // DIVU
+        case 0x7:  // REMU
+            word_divide(b, x, y, &q, &r, &y_zero);
+            if (funct3 == 0x5) {
+                word_free(&r);
+                return q;
+            }
+            word_free(&q);
+            return r;
+
+        default: {  // DIV, REM: divide magnitudes, then fix signs
+            word_bits(b, x);
+            word_bits(b, y);
+            r1cs_bit_t sx = x->bits[31], sy = y->bits[31];
+            r1cs_word_t ax = word_negate_if(b, x, sx);
+            r1cs_word_t ay = word_negate_if(b, y, sy);
+            // |x| <= 2^31, so the magnitudes are canonical
+            ax.bound = ax.bound > 32 ? 32 : ax.bound;
+            ay.bound = ay.bound > 32 ? 32 : ay.bound;
+            word_divide(b, &ax, &ay, &q, &r, &y_zero);
+            if (funct3 == 0x4) {
+                // Division by zero keeps q = -1 whatever the signs
+                r1cs_bit_t negative = bit_and(b, bit_xor(b, sx, sy), bit_not(y_zero));
+                out = word_negate_if(b, &q, negative);
+            } else {
+                out = word_negate_if(b, &r, sx);
+            }
+            word_free(&ax);
+            word_free(&ay);
+            word_free(&q);
+            word_free(&r);
+            return out;
+        }
+    }
+}
+
+// ============================================================================
+// Instructions
+// ============================================================================
+
+static bool is_supported(uint32_t instruction) {
+    uint32_t funct3 = GET_FUNCT3(instruction);
+    uint32_t funct7 = GET_FUNCT7(instruction);
+    switch (GET_OPCODE(instruction)) {
+        case 0x33:
+            if (funct7 == 0x00 || funct7 == 0x01) return true;
+            return funct7 == 0x20 && (funct3 == 0x0 || funct3 == 0x5);
+        case 0x13:
+            if (funct3 == 0x1) return funct7 == 0x00;
+            if (funct3 == 0x5) return funct7 == 0x00 || funct7 == 0x20;
+            return true;
+        case 0x37:
+        case 0x17:
+        case 0x6F:
+            return true;
+        case 0x67:
+            return funct3 == 0x0;
+        case 0x63:
+            return funct3 != 0x2 && funct3 != 0x3;
+        case 0x73:  // ECALL, EBREAK
+            return instruction == 0x00000073 || instruction == 0x00100073;
+        default:
+            return false;
+    }
+}
+
+static void set_word(r1cs_word_t* target, r1cs_word_t* value) {
+    word_free(target);
+    *target = *value;
+}
+
+static void set_reg(r1cs_compiler_t* compiler, uint32_t rd, r1cs_word_t* value) {
+    if (rd == 0) {
+        word_free(value);
+        return;
+    }
+    set_word(&compiler->regs[rd], value);
+}
+
+static int32_t branch_immediate(uint32_t instruction) {
+    uint32_t imm = ((instruction >> 31) & 0x1) << 12 |
+                   ((instruction >> 7) & 0x1) << 11 |
+                   ((instruction >> 25) & 0x3F) << 5 |
+                   ((instruction >> 8) & 0xF) << 1;
+    return (int32_t)(imm << 19) >> 19;
+}
+
+static int32_t jump_immediate(uint32_t instruction) {
+    uint32_t imm = ((instruction >> 31) & 0x1) << 20 |
+                   ((instruction >> 12) & 0xFF) << 12 |
+                   ((instruction >> 20) & 0x1) << 11 |
+                   ((instruction >> 21) & 0x3FF) << 1;
+    return (int32_t)(imm << 11) >> 11;
+}
+
+static void compile(build_t* b, uint32_t instruction) {
+    r1cs_compiler_t* compiler = b->compiler;
+    uint32_t rd = GET_RD(instruction);
+    uint32_t funct3 = GET_FUNCT3(instruction);
+    uint32_t funct7 = GET_FUNCT7(instruction);
+    r1cs_word_t* x = &compiler->regs[GET_RS1(instruction)];
+    r1cs_word_t* pc = &compiler->pc;
+    int32_t imm = (int32_t)instruction >> 20;
+    r1cs_word_t out, y, link;
+
+    switch (GET_OPCODE(instruction)) {
+        case 0x33:
+        case 0x13: {
+            bool reg_op = GET_OPCODE(instruction) == 0x33;
+            r1cs_word_t imm_word = {0};
+            r1cs_word_t* yp = &compiler->regs[GET_RS2(instruction)];
+            if (!reg_op) {
+                imm_word = word_const(b, (uint32_t)imm);
+                yp = &imm_word;
+            }
+            if (reg_op && funct7 == 0x01) {
+                out = word_muldiv(b, x, yp, funct3);
+            } else {
+                switch (funct3) {
+                    case 0x0:
+                        out = word_add(b, x, yp, reg_op && funct7 == 0x20);
+                        break;
+                    case 0x1:
+                        out = word_shift(b, x, yp, SHIFT_LEFT);
+                        break;
+                    case 0x2:
+                    case 0x3:
+                        out = word_from_bit(b, less_than(b, x, yp, funct3 == 0x2));
+                        break;
+                    case 0x5:
+                        out = word_shift(b, x, yp, funct7 == 0x20 ? SHIFT_RIGHT_ARITHMETIC
+                                                                   : SHIFT_RIGHT_LOGICAL);
+                        break;
+                    default:
+                        out = word_bitwise(b, x, yp, funct3);
+                        break;
+                }
+            }
+            word_free(&imm_word);
+            set_reg(compiler, rd, &out);
+            break;
+        }
+
+        case 0x37:  // LUI
+            out = word_const(b, instruction & 0xFFFFF000u);
+            set_reg(compiler, rd, &out);
+            break;
+
+        case 0x17:  // AUIPC
+            out = word_add_const(b, pc, instruction & 0xFFFFF000u);
+            set_reg(compiler, rd, &out);
+            break;
+
+        case 0x6F:  // JAL
+            link = word_add_const(b, pc, 4);
+            out = word_add_const(b, pc, (uint32_t)jump_immediate(instruction));
+            set_word(pc, &out);
+            set_reg(compiler, rd, &link);
+            break;
+
+        case 0x67:  // JALR: the target reads rs1 before rd is written
+            out = word_add_const(b, x, (uint32_t)imm);
+            word_bits(b, &out);
+            out.bits[0] = const_bit(false);
+            y = word_from_bits(b, out.bits);
+            word_free(&out);
+            link = word_add_const(b, pc, 4);
+            set_word(pc, &y);
+            set_reg(compiler, rd, &link);
+            break;
+
+        case 0x63: {  // Branches: PC += 4 + taken * (imm - 4)
+            r1cs_bit_t taken = branch_condition(b, x, &compiler->regs[GET_RS2(instruction)], funct3);
+            r1cs_lc_t t = lc_bit(b, taken);
+            y = (r1cs_word_t){0};
+            lc_term(b, &y.value, R1CS_ONE, 4);
+            lc_add(b, &y.value, &t, (uint32_t)(branch_immediate(instruction) - 4));
+            y.bound = 33;
+            word_fold(b, &y);
+            out = word_add(b, pc, &y, false);
+            set_word(pc, &out);
+            word_free(&y);
+            r1cs_lc_free(&t);
+            break;
+        }
+
+        default:  // ECALL / EBREAK change no state
+            break;
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+r1cs_compiler_t* r1cs_compiler_create(void) {
+    r1cs_compiler_t* compiler = calloc(1, sizeof(r1cs_compiler_t));
+    if (!compiler) return NULL;
+    compiler->system = r1cs_system_create(R1CS_NUM_INPUTS);
+    if (!compiler->system) {
+        free(compiler);
+        return NULL;
+    }
+
+    build_t b = {compiler, compiler->system, false};
+    compiler->regs[0] = word_const(&b, 0);
+    compiler->pc.value = lc_var(&b, 1, 1);
+    compiler->pc.bound = 32;
+    for (uint32_t r = 1; r < 32; r++) {
+        compiler->regs[r].value = lc_var(&b, 1 + r, 1);
+        compiler->regs[r].bound = 32;
+    }
+    if (b.failed) {
+        r1cs_compiler_destroy(compiler);
+        return NULL;
+    }
+    return compiler;
+}
+
+void r1cs_compiler_destroy(r1cs_compiler_t* compiler) {
+    if (!compiler) return;
+    for (int r = 0; r < 32; r++) word_free(&compiler->regs[r]);
+    word_free(&compiler->pc);
+    r1cs_system_destroy(compiler->system);
+    free(compiler);
+}
+
+int r1cs_compile_instruction(r1cs_compiler_t* compiler, uint32_t instruction) {
+    if (!compiler) {
+        fprintf(stderr, "❌ ERROR: NULL compiler instance\n");
+        return -1;
+    }
+    if (compiler->finalized) {
+        fprintf(stderr, "❌ ERROR: R1CS compiler already finalized\n");
+        return -1;
+    }
+    if (!is_supported(instruction)) {
+        fprintf(stderr, "❌ ERROR: R1CS backend cannot compile instruction 0x%08X\n", instruction);
+        return -1;
+    }
+
+    build_t b = {compiler, compiler->system, false};
+    compile(&b, instruction);
+    if (b.failed) {
+        fprintf(stderr, "❌ ERROR: Out of memory compiling instruction 0x%08X\n", instruction);
+        return -1;
+    }
+    return 0;
+}
+
+int r1cs_compile_program(r1cs_compiler_t* compiler, const uint32_t* program, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (r1cs_compile_instruction(compiler, program[i]) != 0) {
+            fprintf(stderr, "   at instruction %zu\n", i);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void r1cs_compiler_check_inputs(r1cs_compiler_t* compiler) {
+    build_t b = {compiler, compiler->system, false};
+    for (uint32_t v = 1; v <= R1CS_NUM_INPUTS; v++) {
+        r1cs_word_t* w = v == 1 ? &compiler->pc : &compiler->regs[v - 1];
+        r1cs_lc_t input = lc_var(&b, v, 1);
+        r1cs_bit_t bits[32];
+        decompose(&b, &input, 32, bits);
+        // Registers still holding their input get the bits for free
+        if (!w->has_bits && w->value.size == 1 && w->value.terms[0].var == v &&
+            w->value.terms[0].coeff == 1) {
+            memcpy(w->bits, bits, sizeof(bits));
+            w->has_bits = true;
+        }
+        r1cs_lc_free(&input);
+    }
+}
+
+int r1cs_compiler_finalize(r1cs_compiler_t* compiler) {
+    if (!compiler || compiler->finalized) return -1;
+    r1cs_system_t* system = compiler->system;
+    system->outputs = calloc(R1CS_NUM_INPUTS, sizeof(r1cs_lc_t));
+    if (!system->outputs) return -1;
+
+    build_t b = {compiler, system, false};
+    for (uint32_t i = 0; i < R1CS_NUM_INPUTS; i++) {
+        r1cs_word_t* w = i == 0 ? &compiler->pc : &compiler->regs[i];
+        word_reduce(&b, w);
+        if (!r1cs_lc_copy(&system->outputs[i], &w->value)) b.failed = true;
+    }
+    system->num_outputs = R1CS_NUM_INPUTS;
+    compiler->finalized = true;
+    if (b.failed) {
+        fprintf(stderr, "❌ ERROR: Out of memory finalizing R1CS outputs\n");
+        return -1;
+    }
+    return 0;
+}
+
+uint64_t* r1cs_compiler_solve(const r1cs_compiler_t* compiler, uint32_t pc,
+                              const uint32_t regs[32]) {
+    uint64_t inputs[R1CS_NUM_INPUTS];
+    inputs[0] = pc;
+    for (int r = 1; r < 32; r++) inputs[r] = regs[r];
+    return r1cs_solve(compiler->system, inputs);
+}
+
+// Word values are below p and congruent mod 2^32, so the low half is the
+// register
+uint32_t r1cs_compiler_get_reg(const r1cs_compiler_t* compiler, const uint64_t* witness,
+                               int reg) {
+    if (reg <= 0 || reg >= 32) return 0;
+    return (uint32_t)r1cs_lc_eval(&compiler->regs[reg].value, witness);
+}
+
+uint32_t r1cs_compiler_get_pc(const r1cs_compiler_t* compiler, const uint64_t* witness) {
+    return (uint32_t)r1cs_lc_eval(&compiler->pc.value, witness);
+}
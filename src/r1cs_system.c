@@ -0,0 +1,303 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "r1cs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Linear combinations
+// ============================================================================
+
+void r1cs_lc_free(r1cs_lc_t* lc) {
+    free(lc->terms);
+    memset(lc, 0, sizeof(*lc));
+}
+
+static bool lc_reserve(r1cs_lc_t* lc, uint32_t size) {
+    if (size <= lc->capacity) return true;
+    uint32_t capacity = lc->capacity ? lc->capacity : 4;
+    while (capacity < size) capacity *= 2;
+    r1cs_term_t* terms = realloc(lc->terms, capacity * sizeof(r1cs_term_t));
+    if (!terms) return false;
+    lc->terms = terms;
+    lc->capacity = capacity;
+    return true;
+}
+
+bool r1cs_lc_copy(r1cs_lc_t* dst, const r1cs_lc_t* src) {
+    memset(dst, 0, sizeof(*dst));
+    if (!src || src->size == 0) return true;
+    if (!lc_reserve(dst, src->size)) return false;
+    memcpy(dst->terms, src->terms, src->size * sizeof(r1cs_term_t));
+    dst->size = src->size;
+    return true;
+}
+
+bool r1cs_lc_add_term(r1cs_lc_t* lc, uint32_t var, uint64_t coeff) {
+    if (coeff == 0) return true;
+    uint32_t lo = 0, hi = lc->size;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (lc->terms[mid].var < var) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < lc->size && lc->terms[lo].var == var) {
+        uint64_t sum = r1cs_field_add(lc->terms[lo].coeff, coeff);
+        if (sum != 0) {
+            lc->terms[lo].coeff = sum;
+        } else {
+            memmove(&lc->terms[lo], &lc->terms[lo + 1],
+                    (lc->size - lo - 1) * sizeof(r1cs_term_t));
+            lc->size--;
+        }
+        return true;
+    }
+    if (!lc_reserve(lc, lc->size + 1)) return false;
+    memmove(&lc->terms[lo + 1], &lc->terms[lo], (lc->size - lo) * sizeof(r1cs_term_t));
+    lc->terms[lo].var = var;
+    lc->terms[lo].coeff = coeff;
+    lc->size++;
+    return true;
+}
+
+bool r1cs_lc_add_scaled(r1cs_lc_t* lc, const r1cs_lc_t* other, uint64_t k) {
+    if (k == 0) return true;
+    // Merge two sorted lists; copy first so lc == other works
+    r1cs_lc_t merged = {0};
+    if (!lc_reserve(&merged, lc->size + other->size)) return false;
+    uint32_t i = 0, j = 0;
+    while (i < lc->size || j < other->size) {
+        r1cs_term_t t;
+        if (j == other->size || (i < lc->size && lc->terms[i].var < other->terms[j].var)) {
+            t = lc->terms[i++];
+        } else if (i == lc->size || other->terms[j].var < lc->terms[i].var) {
+            t.var = other->terms[j].var;
+            t.coeff = r1cs_field_mul(other->terms[j++].coeff, k);
+        } else {
+            t.var = lc->terms[i].var;
+            t.coeff = r1cs_field_add(lc->terms[i++].coeff,
+                                     r1cs_field_mul(other->terms[j++].coeff, k));
+        }
+        if (t.coeff != 0) merged.terms[merged.size++] = t;
+    }
+    free(lc->terms);
+    *lc = merged;
+    return true;
+}
+
+bool r1cs_lc_is_constant(const r1cs_lc_t* lc, uint64_t* value) {
+    if (lc->size == 0) {
+        *value = 0;
+        return true;
+    }
+    if (lc->size == 1 && lc->terms[0].var == R1CS_ONE) {
+        *value = lc->terms[0].coeff;
+        return true;
+    }
+    return false;
+}
+
+uint64_t r1cs_lc_eval(const r1cs_lc_t* lc, const uint64_t* witness) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < lc->size; i++) {
+        sum = r1cs_field_add(sum, r1cs_field_mul(lc->terms[i].coeff, witness[lc->terms[i].var]));
+    }
+    return sum;
+}
+
+// ============================================================================
+// System
+// ============================================================================
+
+r1cs_system_t* r1cs_system_create(uint32_t num_inputs) {
+    r1cs_system_t* system = calloc(1, sizeof(r1cs_system_t));
+    if (!system) return NULL;
+    system->var_capacity = 1024;
+    while (system->var_capacity <= num_inputs) system->var_capacity *= 2;
+    system->hints = calloc(system->var_capacity, sizeof(r1cs_hint_t));
+    if (!system->hints) {
+        free(system);
+        return NULL;
+    }
+    system->num_inputs = num_inputs;
+    system->num_vars = num_inputs + 1;
+    return system;
+}
+
+void r1cs_system_destroy(r1cs_system_t* system) {
+    if (!system) return;
+    for (uint32_t v = 0; v < system->num_vars; v++) {
+        r1cs_lc_free(&system->hints[v].x);
+        r1cs_lc_free(&system->hints[v].y);
+    }
+    for (size_t i = 0; i < system->num_constraints; i++) {
+        r1cs_lc_free(&system->constraints[i].a);
+        r1cs_lc_free(&system->constraints[i].b);
+        r1cs_lc_free(&system->constraints[i].c);
+    }
+    for (size_t i = 0; i < system->num_outputs; i++) r1cs_lc_free(&system->outputs[i]);
+    free(system->hints);
+    free(system->constraints);
+    free(system->outputs);
+    free(system);
+}
+
+uint32_t r1cs_new_var(r1cs_system_t* system, r1cs_hint_kind_t kind, uint32_t arg,
+                      const r1cs_lc_t* x, const r1cs_lc_t* y) {
+    if (system->num_vars == system->var_capacity) {
+        uint32_t capacity = system->var_capacity * 2;
+        r1cs_hint_t* hints = realloc(system->hints, capacity * sizeof(r1cs_hint_t));
+        if (!hints) return UINT32_MAX;
+        system->hints = hints;
+        system->var_capacity = capacity;
+    }
+    r1cs_hint_t* hint = &system->hints[system->num_vars];
+    hint->kind = kind;
+    hint->arg = arg;
+    if (!r1cs_lc_copy(&hint->x, x)) return UINT32_MAX;
+    if (!r1cs_lc_copy(&hint->y, y)) {
+        r1cs_lc_free(&hint->x);
+        return UINT32_MAX;
+    }
+    return system->num_vars++;
+}
+
+bool r1cs_enforce(r1cs_system_t* system, const r1cs_lc_t* a, const r1cs_lc_t* b,
+                  const r1cs_lc_t* c) {
+    if (system->num_constraints == system->constraint_capacity) {
+        size_t capacity = system->constraint_capacity ? 2 * system->constraint_capacity : 1024;
+        r1cs_constraint_t* constraints =
+            realloc(system->constraints, capacity * sizeof(r1cs_constraint_t));
+        if (!constraints) return false;
+        system->constraints = constraints;
+        system->constraint_capacity = capacity;
+    }
+    r1cs_constraint_t* con = &system->constraints[system->num_constraints];
+    if (!r1cs_lc_copy(&con->a, a) || !r1cs_lc_copy(&con->b, b) || !r1cs_lc_copy(&con->c, c)) {
+        r1cs_lc_free(&con->a);
+        r1cs_lc_free(&con->b);
+        r1cs_lc_free(&con->c);
+        return false;
+    }
+    system->num_constraints++;
+    return true;
+}
+
+// ============================================================================
+// Witness
+// ============================================================================
+
+static uint64_t field_inverse(uint64_t a) {
+    // a^(p-2)
+    uint64_t result = 1, base = a, e = R1CS_FIELD_PRIME - 2;
+    while (e) {
+        if (e & 1) result = r1cs_field_mul(result, base);
+        base = r1cs_field_mul(base, base);
+        e >>= 1;
+    }
+    return result;
+}
+
+static uint64_t solve_hint(const r1cs_hint_t* hint, const uint64_t* witness) {
+    uint64_t x = r1cs_lc_eval(&hint->x, witness);
+    uint64_t y = r1cs_lc_eval(&hint->y, witness);
+    switch (hint->kind) {
+        case R1CS_HINT_INPUT: return 0;
+        case R1CS_HINT_LC:    return x;
+        case R1CS_HINT_BIT:   return (x >> hint->arg) & 1;
+        case R1CS_HINT_MUL:   return r1cs_field_mul(x, y);
+        case R1CS_HINT_XOR:   return (x ^ y) & 1;
+        case R1CS_HINT_INV:   return x ? field_inverse(x) : 0;
+        case R1CS_HINT_DIVU:  return y ? (uint32_t)x / (uint32_t)y : 0xFFFFFFFFu;
+        case R1CS_HINT_REMU:  return y ? (uint32_t)x % (uint32_t)y : (uint32_t)x;
+    }
+    return 0;
+}
+
+uint64_t* r1cs_solve(const r1cs_system_t* system, const uint64_t* inputs) {
+    uint64_t* witness = calloc(system->num_vars, sizeof(uint64_t));
+    if (!witness) {
+        fprintf(stderr, "❌ ERROR: Out of memory for a %u-variable witness\n", system->num_vars);
+        return NULL;
+    }
+    witness[R1CS_ONE] = 1;
+    for (uint32_t i = 0; i < system->num_inputs; i++) {
+        witness[1 + i] = inputs[i] % R1CS_FIELD_PRIME;
+    }
+    for (uint32_t v = system->num_inputs + 1; v < system->num_vars; v++) {
+        witness[v] = solve_hint(&system->hints[v], witness);
+    }
+    return witness;
+}
+
+bool r1cs_is_satisfied(const r1cs_system_t* system, const uint64_t* witness) {
+    if (witness[R1CS_ONE] != 1) return false;
+    for (size_t i = 0; i < system->num_constraints; i++) {
+        const r1cs_constraint_t* con = &system->constraints[i];
+        uint64_t a = r1cs_lc_eval(&con->a, witness);
+        uint64_t b = r1cs_lc_eval(&con->b, witness);
+        if (r1cs_field_mul(a, b) != r1cs_lc_eval(&con->c, witness)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Statistics and export
+// ============================================================================
+
+size_t r1cs_num_nonzeros(const r1cs_system_t* system) {
+    size_t total = 0;
+    for (size_t i = 0; i < system->num_constraints; i++) {
+        const r1cs_constraint_t* con = &system->constraints[i];
+        total += con->a.size + con->b.size + con->c.size;
+    }
+    return total;
+}
+
+void r1cs_print_stats(const r1cs_system_t* system) {
+    printf("R1CS Statistics:\n");
+    printf("  Field: %llu\n", (unsigned long long)R1CS_FIELD_PRIME);
+    printf("  Variables: %u (%u inputs)\n", system->num_vars, system->num_inputs);
+    printf("  Constraints: %zu\n", system->num_constraints);
+    printf("  Nonzeros: %zu\n", r1cs_num_nonzeros(system));
+}
+
+static void write_lc(FILE* f, const r1cs_lc_t* lc) {
+    fprintf(f, " %u", lc->size);
+    for (uint32_t i = 0; i < lc->size; i++) {
+        fprintf(f, " %u %llu", lc->terms[i].var, (unsigned long long)lc->terms[i].coeff);
+    }
+}
+
+int r1cs_to_file(const r1cs_system_t* system, const char* filename) {
+    FILE* f = fopen(filename, "w");
+    if (!f) {
+        fprintf(stderr, "❌ ERROR: Cannot open %s for writing\n", filename);
+        return -1;
+    }
+    fprintf(f, "r1cs 1\n");
+    fprintf(f, "field %llu\n", (unsigned long long)R1CS_FIELD_PRIME);
+    fprintf(f, "variables %u inputs %u outputs %zu constraints %zu\n",
+            system->num_vars, system->num_inputs, system->num_outputs, system->num_constraints);
+    for (size_t i = 0; i < system->num_outputs; i++) {
+        fprintf(f, "o");
+        write_lc(f, &system->outputs[i]);
+        fprintf(f, "\n");
+    }
+    for (size_t i = 0; i < system->num_constraints; i++) {
+        const r1cs_constraint_t* con = &system->constraints[i];
+        fprintf(f, "c");
+        write_lc(f, &con->a);
+        write_lc(f, &con->b);
+        write_lc(f, &con->c);
+        fprintf(f, "\n");
+    }
+    int result = ferror(f) ? -1 : 0;
+    if (fclose(f) != 0) result = -1;
+    if (result < 0) fprintf(stderr, "❌ ERROR: Failed writing %s\n", filename);
+    return result;
+}
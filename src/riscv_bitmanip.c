@@ -0,0 +1,380 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "zkvm_circuit.h"
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/*
+ * Zba / Zbb / Zbs bit-manipulation extensions.
+ *
+ * Many of these are free in a circuit: rev8, sext/zext and rotates or bit
+ * operations by an immediate are pure rewiring, and andn/orn/xnor are one
+ * to three gates per bit. Only the variable-amount forms (rol/ror, bset &c.
+ * by register) need mux or decoder logic.
+ */
+
+// Extract instruction fields
+#define BM_OPCODE(instr) ((instr) & 0x7F)
+#define BM_RD(instr)     (((instr) >> 7) & 0x1F)
+#define BM_FUNCT3(instr) (((instr) >> 12) & 0x7)
+#define BM_RS1(instr)    (((instr) >> 15) & 0x1F)
+#define BM_RS2(instr)    (((instr) >> 20) & 0x1F)  // Also shamt / unary selector
+#define BM_FUNCT7(instr) (((instr) >> 25) & 0x7F)
+
+static void write_rd(riscv_compiler_t* compiler, uint32_t rd, const uint32_t* result) {
+    if (rd != 0) {
+        memcpy(compiler->reg_wires[rd], result, 32 * sizeof(uint32_t));
+    }
+}
+
+// ============================================================================
+// Zba: address generation
+// ============================================================================
+
+// rd = (rs1 << shift) + rs2; the shifted-in zeros cost nothing
+static void compile_shadd(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                          uint32_t rs2, int shift) {
+    uint32_t shifted[32], result[32];
+    for (int i = 0; i < 32; i++) {
+        shifted[i] = i < shift ? CONSTANT_0_WIRE : compiler->reg_wires[rs1][i - shift];
+    }
+    uint32_t* operands[2] = {shifted, compiler->reg_wires[rs2]};
+    build_multi_operand_adder(compiler->circuit, operands, 2, 32, result,
+                              final_adder_for_objective(compiler->circuit));
+    write_rd(compiler, rd, result);
+}
+
+// ============================================================================
+// Zbb: logic with negate, counts, min/max, extensions, rotates
+// ============================================================================
+
+typedef enum { LOGIC_ANDN, LOGIC_ORN, LOGIC_XNOR } negated_logic_t;
+
+static void compile_negated_logic(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                                  uint32_t rs2, negated_logic_t op) {
+    riscv_circuit_t* circuit = compiler->circuit;
+    uint32_t* a = compiler->reg_wires[rs1];
+    uint32_t* b = compiler->reg_wires[rs2];
+    uint32_t result[32];
+
+    for (int i = 0; i < 32; i++) {
+        switch (op) {
+            case LOGIC_ANDN:  // a & ~b = a ^ (a & b)
+                result[i] = gate_xor(circuit, a[i], gate_and(circuit, a[i], b[i]));
+                break;
+            case LOGIC_ORN:   // a | ~b = ~(b & ~a) = ~(b ^ (a & b))
+                result[i] = riscv_circuit_allows(circuit, GATE_OR) ?
+                    gate_or(circuit, a[i], gate_not(circuit, b[i])) :
+                    gate_not(circuit, gate_xor(circuit, b[i], gate_and(circuit, a[i], b[i])));
+                break;
+            case LOGIC_XNOR:
+                result[i] = gate_xnor(circuit, a[i], b[i]);
+                break;
+        }
+    }
+    write_rd(compiler, rd, result);
+}
+
+// min/minu/max/maxu: one borrow chain plus a select
+static void compile_minmax(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                           uint32_t rs2, bool is_signed, bool is_max) {
+    riscv_circuit_t* circuit = compiler->circuit;
+    uint32_t* a = compiler->reg_wires[rs1];
+    uint32_t* b = compiler->reg_wires[rs2];
+    uint32_t result[32];
+
+    uint32_t a_lt_b = build_compare_lt(circuit, a, b, 32, is_signed);
+
+    if (is_max) {
+        zkvm_build_select(circuit, a_lt_b, b, a, 32, result);
+    } else {
+        zkvm_build_select(circuit, a_lt_b, a, b, 32, result);
+    }
+    write_rd(compiler, rd, result);
+}
+
+// Sign/zero extension from bit `from`: 0 gates
+static void compile_extend(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                           int from, bool sign) {
+    uint32_t* src = compiler->reg_wires[rs1];
+    uint32_t fill = sign ? src[from - 1] : CONSTANT_0_WIRE;
+    uint32_t result[32];
+    for (int i = 0; i < 32; i++) {
+        result[i] = i < from ? src[i] : fill;
+    }
+    write_rd(compiler, rd, result);
+}
+
+// Rotate by a register amount: five mux stages, wraparound instead of fill
+static void compile_rotate(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                           uint32_t rs2, bool left) {
+    riscv_circuit_t* circuit = compiler->circuit;
+    uint32_t current[32], next[32];
+    memcpy(current, compiler->reg_wires[rs1], sizeof(current));
+
+    for (int stage = 0; stage < 5; stage++) {
+        int by = 1 << stage;
+        uint32_t sel = compiler->reg_wires[rs2][stage];
+        for (int i = 0; i < 32; i++) {
+            uint32_t rotated = left ? current[(i - by + 32) & 31] : current[(i + by) & 31];
+            next[i] = gate_mux(circuit, sel, rotated, current[i]);
+        }
+        memcpy(current, next, sizeof(current));
+    }
+    write_rd(compiler, rd, current);
+}
+
+// rori: 0 gates
+static void compile_rotate_immediate(riscv_compiler_t* compiler, uint32_t rd,
+                                     uint32_t rs1, uint32_t shamt) {
+    uint32_t result[32];
+    for (int i = 0; i < 32; i++) {
+        result[i] = compiler->reg_wires[rs1][(i + shamt) & 31];
+    }
+    write_rd(compiler, rd, result);
+}
+
+// rev8: byte swap, 0 gates
+static void compile_rev8(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1) {
+    uint32_t result[32];
+    for (int byte = 0; byte < 4; byte++) {
+        for (int bit = 0; bit < 8; bit++) {
+            result[byte * 8 + bit] = compiler->reg_wires[rs1][(3 - byte) * 8 + bit];
+        }
+    }
+    write_rd(compiler, rd, result);
+}
+
+// orc.b: each byte becomes 0x00 or 0xFF; OR via De Morgan is 16 gates a byte
+static void compile_orc_b(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1) {
+    riscv_circuit_t* circuit = compiler->circuit;
+    uint32_t result[32];
+
+    for (int byte = 0; byte < 4; byte++) {
+        uint32_t none = gate_not(circuit, compiler->reg_wires[rs1][byte * 8]);
+        for (int bit = 1; bit < 8; bit++) {
+            uint32_t clear = gate_not(circuit, compiler->reg_wires[rs1][byte * 8 + bit]);
+            none = gate_and(circuit, none, clear);
+        }
+        uint32_t any = gate_not(circuit, none);
+        for (int bit = 0; bit < 8; bit++) result[byte * 8 + bit] = any;
+    }
+    write_rd(compiler, rd, result);
+}
+
+typedef enum { COUNT_CLZ, COUNT_CTZ, COUNT_CPOP } bit_count_t;
+
+static void compile_bit_count(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                              bit_count_t op) {
+    riscv_circuit_t* circuit = compiler->circuit;
+    uint32_t result[32];
+
+    switch (op) {
+        case COUNT_CLZ:  zkvm_build_clz(circuit, compiler->reg_wires[rs1], 32, result); break;
+        case COUNT_CTZ:  zkvm_build_ctz(circuit, compiler->reg_wires[rs1], 32, result); break;
+        case COUNT_CPOP: zkvm_build_popcnt(circuit, compiler->reg_wires[rs1], 32, result); break;
+    }
+    write_rd(compiler, rd, result);
+}
+
+// ============================================================================
+// Zbs: single-bit operations
+// ============================================================================
+
+typedef enum { SINGLE_BIT_CLR, SINGLE_BIT_SET, SINGLE_BIT_INV, SINGLE_BIT_EXT } single_bit_t;
+
+// One-hot decode of a 5-bit index: two predecoders, then one AND per output
+static void build_bit_decoder(riscv_circuit_t* circuit, const uint32_t* index,
+                              uint32_t* onehot) {
+    uint32_t lo[4], hi[8];
+    uint32_t inv[5];
+    for (int i = 0; i < 5; i++) inv[i] = gate_not(circuit, index[i]);
+
+    for (int v = 0; v < 4; v++) {
+        lo[v] = gate_and(circuit, (v & 1) ? index[0] : inv[0],
+                         (v & 2) ? index[1] : inv[1]);
+    }
+    uint32_t mid[4];
+    for (int v = 0; v < 4; v++) {
+        mid[v] = gate_and(circuit, (v & 1) ? index[2] : inv[2],
+                          (v & 2) ? index[3] : inv[3]);
+    }
+    for (int v = 0; v < 8; v++) {
+        hi[v] = gate_and(circuit, mid[v & 3], (v & 4) ? index[4] : inv[4]);
+    }
+    for (int i = 0; i < 32; i++) {
+        onehot[i] = gate_and(circuit, lo[i & 3], hi[i >> 2]);
+    }
+}
+
+static void compile_single_bit(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                               uint32_t rs2, single_bit_t op) {
+    riscv_circuit_t* circuit = compiler->circuit;
+    uint32_t* a = compiler->reg_wires[rs1];
+    uint32_t* index = compiler->reg_wires[rs2];
+    uint32_t result[32];
+
+    if (op == SINGLE_BIT_EXT) {
+        // (rs1 >> index) & 1 as a 32:1 mux tree: 31 muxes
+        uint32_t level[32];
+        memcpy(level, a, sizeof(level));
+        for (int stage = 0, n = 32; n > 1; stage++, n /= 2) {
+            for (int i = 0; i < n / 2; i++) {
+                level[i] = gate_mux(circuit, index[stage], level[2 * i + 1], level[2 * i]);
+            }
+        }
+        result[0] = level[0];
+        for (int i = 1; i < 32; i++) result[i] = CONSTANT_0_WIRE;
+        write_rd(compiler, rd, result);
+        return;
+    }
+
+    uint32_t onehot[32];
+    build_bit_decoder(circuit, index, onehot);
+
+    for (int i = 0; i < 32; i++) {
+        switch (op) {
+            case SINGLE_BIT_CLR:  // a & ~m = a ^ (a & m)
+                result[i] = gate_xor(circuit, a[i], gate_and(circuit, a[i], onehot[i]));
+                break;
+            case SINGLE_BIT_SET:
+                result[i] = gate_or(circuit, a[i], onehot[i]);
+                break;
+            case SINGLE_BIT_INV:
+                result[i] = gate_xor(circuit, a[i], onehot[i]);
+                break;
+            case SINGLE_BIT_EXT:
+                break;
+        }
+    }
+    write_rd(compiler, rd, result);
+}
+
+// Immediate forms touch a single known bit: at most one gate
+static void compile_single_bit_immediate(riscv_compiler_t* compiler, uint32_t rd,
+                                         uint32_t rs1, uint32_t shamt, single_bit_t op) {
+    uint32_t result[32];
+    memcpy(result, compiler->reg_wires[rs1], sizeof(result));
+
+    switch (op) {
+        case SINGLE_BIT_CLR: result[shamt] = CONSTANT_0_WIRE; break;
+        case SINGLE_BIT_SET: result[shamt] = CONSTANT_1_WIRE; break;
+        case SINGLE_BIT_INV:
+            result[shamt] = gate_not(compiler->circuit, result[shamt]);
+            break;
+        case SINGLE_BIT_EXT:
+            result[0] = result[shamt];
+            for (int i = 1; i < 32; i++) result[i] = CONSTANT_0_WIRE;
+            break;
+    }
+    write_rd(compiler, rd, result);
+}
+
+// ============================================================================
+// Decoder
+// ============================================================================
+
+// Returns 0 if the instruction was a Zba/Zbb/Zbs instruction, -1 otherwise
+int compile_bitmanip_instruction(riscv_compiler_t* compiler, uint32_t instruction) {
+    uint32_t opcode = BM_OPCODE(instruction);
+    uint32_t rd = BM_RD(instruction);
+    uint32_t funct3 = BM_FUNCT3(instruction);
+    uint32_t rs1 = BM_RS1(instruction);
+    uint32_t rs2 = BM_RS2(instruction);
+    uint32_t funct7 = BM_FUNCT7(instruction);
+
+    if (opcode == 0x33) {  // R-type
+        switch (funct7) {
+            case 0x10:  // SH1ADD / SH2ADD / SH3ADD
+                if (funct3 == 0x2 || funct3 == 0x4 || funct3 == 0x6) {
+                    compile_shadd(compiler, rd, rs1, rs2, (int)(funct3 >> 1));
+                    return 0;
+                }
+                return -1;
+
+            case 0x20:  // XNOR / ORN / ANDN (ADD/SUB/SRA share this funct7)
+                switch (funct3) {
+                    case 0x4: compile_negated_logic(compiler, rd, rs1, rs2, LOGIC_XNOR); return 0;
+                    case 0x6: compile_negated_logic(compiler, rd, rs1, rs2, LOGIC_ORN); return 0;
+                    case 0x7: compile_negated_logic(compiler, rd, rs1, rs2, LOGIC_ANDN); return 0;
+                }
+                return -1;
+
+            case 0x05:  // MIN / MINU / MAX / MAXU
+                switch (funct3) {
+                    case 0x4: compile_minmax(compiler, rd, rs1, rs2, true, false); return 0;
+                    case 0x5: compile_minmax(compiler, rd, rs1, rs2, false, false); return 0;
+                    case 0x6: compile_minmax(compiler, rd, rs1, rs2, true, true); return 0;
+                    case 0x7: compile_minmax(compiler, rd, rs1, rs2, false, true); return 0;
+                }
+                return -1;
+
+            case 0x04:  // ZEXT.H (RV32 encoding of PACK rd, rs1, x0)
+                if (funct3 == 0x4 && rs2 == 0) {
+                    compile_extend(compiler, rd, rs1, 16, false);
+                    return 0;
+                }
+                return -1;
+
+            case 0x30:  // ROL / ROR
+                if (funct3 == 0x1) { compile_rotate(compiler, rd, rs1, rs2, true); return 0; }
+                if (funct3 == 0x5) { compile_rotate(compiler, rd, rs1, rs2, false); return 0; }
+                return -1;
+
+            case 0x24:  // BCLR / BEXT
+                if (funct3 == 0x1) { compile_single_bit(compiler, rd, rs1, rs2, SINGLE_BIT_CLR); return 0; }
+                if (funct3 == 0x5) { compile_single_bit(compiler, rd, rs1, rs2, SINGLE_BIT_EXT); return 0; }
+                return -1;
+
+            case 0x14:  // BSET
+                if (funct3 == 0x1) { compile_single_bit(compiler, rd, rs1, rs2, SINGLE_BIT_SET); return 0; }
+                return -1;
+
+            case 0x34:  // BINV
+                if (funct3 == 0x1) { compile_single_bit(compiler, rd, rs1, rs2, SINGLE_BIT_INV); return 0; }
+                return -1;
+        }
+        return -1;
+    }
+
+    if (opcode == 0x13) {  // I-type; rs2 holds shamt or the unary selector
+        if (funct3 == 0x1) {
+            switch (funct7) {
+                case 0x30:  // CLZ / CTZ / CPOP / SEXT.B / SEXT.H
+                    switch (rs2) {
+                        case 0x00: compile_bit_count(compiler, rd, rs1, COUNT_CLZ); return 0;
+                        case 0x01: compile_bit_count(compiler, rd, rs1, COUNT_CTZ); return 0;
+                        case 0x02: compile_bit_count(compiler, rd, rs1, COUNT_CPOP); return 0;
+                        case 0x04: compile_extend(compiler, rd, rs1, 8, true); return 0;
+                        case 0x05: compile_extend(compiler, rd, rs1, 16, true); return 0;
+                    }
+                    return -1;
+                case 0x24: compile_single_bit_immediate(compiler, rd, rs1, rs2, SINGLE_BIT_CLR); return 0;
+                case 0x14: compile_single_bit_immediate(compiler, rd, rs1, rs2, SINGLE_BIT_SET); return 0;
+                case 0x34: compile_single_bit_immediate(compiler, rd, rs1, rs2, SINGLE_BIT_INV); return 0;
+            }
+            return -1;
+        }
+
+        if (funct3 == 0x5) {
+            switch (funct7) {
+                case 0x30: compile_rotate_immediate(compiler, rd, rs1, rs2); return 0;   // RORI
+                case 0x24: compile_single_bit_immediate(compiler, rd, rs1, rs2, SINGLE_BIT_EXT); return 0;  // BEXTI
+                case 0x14:  // ORC.B
+                    if (rs2 == 0x07) { compile_orc_b(compiler, rd, rs1); return 0; }
+                    return -1;
+                case 0x34:  // REV8
+                    if (rs2 == 0x18) { compile_rev8(compiler, rd, rs1); return 0; }
+                    return -1;
+            }
+        }
+    }
+
+    return -1;
+}
@@ -4,6 +4,7 @@
 
 
 #include "riscv_compiler.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -52,9 +53,11 @@ riscv_compiler_t* riscv_compiler_create(void) {
         return NULL;
     }
     
-    // Initialize wire counter - wires 0,1 are reserved for constants by convention
-    // All circuits use this same standard: input bit 0=constant 0, input bit 1=constant 1
-    compiler->circuit->next_wire_id = 2;  // Start allocating from wire 2+
+    // Inputs are the constants (wires 0,1), PC and registers; gates allocate
+    // after them so they never alias the machine state
+    compiler->circuit->num_inputs = MEMORY_START_BIT;
+    compiler->circuit->next_wire_id = MEMORY_START_BIT;
+    compiler->circuit->max_wire_id = MEMORY_START_BIT;
     
     // Constants are handled by circuit input convention:
     // - Every circuit's input bit 0 = constant 0 (false)  
@@ -132,6 +135,62 @@ void riscv_compiler_destroy(riscv_compiler_t* compiler) {
     free(compiler);
 }
 
+int riscv_compiler_set_objective(riscv_compiler_t* compiler,
+                                 optimization_objective_t objective) {
+    if (!compiler || !compiler->circuit) return -1;
+    if (objective != OPTIMIZE_GATES && objective != OPTIMIZE_AND_COUNT &&
+        objective != OPTIMIZE_DEPTH) {
+        fprintf(stderr, "❌ ERROR: Unknown optimization objective %d\n", (int)objective);
+        return -1;
+    }
+    compiler->circuit->objective = objective;
+    return 0;
+}
+
+int riscv_compiler_set_gate_set(riscv_compiler_t* compiler, uint32_t gate_set) {
+    if (!compiler || !compiler->circuit) return -1;
+    if (gate_set & ~GATE_SET_ALL) {
+        fprintf(stderr, "❌ ERROR: Unknown gate types in gate set 0x%X\n", gate_set);
+        return -1;
+    }
+    compiler->circuit->gate_set = gate_set;
+    return 0;
+}
+
+const char* gate_type_name(gate_type_t type) {
+    switch (type) {
+        case GATE_AND:  return "AND";
+        case GATE_XOR:  return "XOR";
+        case GATE_OR:   return "OR";
+        case GATE_NOT:  return "NOT";
+        case GATE_XNOR: return "XNOR";
+        case GATE_MUX:  return "MUX";
+        case GATE_LUT:  return "LUT";
+    }
+    return "UNKNOWN";
+}
+
+bool riscv_circuit_allows(const riscv_circuit_t* circuit, gate_type_t type) {
+    return ((circuit->gate_set | GATE_SET_BASIC) & GATE_SET_BIT(type)) != 0;
+}
+
+bool riscv_circuit_is_extended(const riscv_circuit_t* circuit) {
+    if (circuit->gate_set & ~GATE_SET_BASIC) return true;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        if (circuit->gates[i].type != GATE_AND && circuit->gates[i].type != GATE_XOR) return true;
+    }
+    return false;
+}
+
+const char* optimization_objective_name(optimization_objective_t objective) {
+    switch (objective) {
+        case OPTIMIZE_GATES:     return "gates";
+        case OPTIMIZE_AND_COUNT: return "and-count";
+        case OPTIMIZE_DEPTH:     return "depth";
+    }
+    return "unknown";
+}
+
 // Create circuit with specified input/output sizes and bounds checking
 riscv_circuit_t* riscv_circuit_create(size_t num_inputs, size_t num_outputs) {
     // Bounds checking with helpful error messages
@@ -315,6 +374,11 @@ uint32_t* riscv_circuit_allocate_wire_array(riscv_circuit_t* circuit, size_t cou
 
 void riscv_circuit_add_gate(riscv_circuit_t* circuit, uint32_t left, uint32_t right, 
                             uint32_t output, gate_type_t type) {
+    gate_t gate = {left, right, output, CONSTANT_0_WIRE, (uint8_t)type, 0};
+    riscv_circuit_add_gate_full(circuit, &gate);
+}
+
+void riscv_circuit_add_gate_full(riscv_circuit_t* circuit, const gate_t* gate) {
     if (circuit->num_gates >= circuit->capacity) {
         // Resize the circuit
         size_t new_capacity = circuit->capacity * 2;
@@ -327,44 +391,7 @@ void riscv_circuit_add_gate(riscv_circuit_t* circuit, uint32_t left, uint32_t ri
         circuit->capacity = new_capacity;
     }
     
-    circuit->gates[circuit->num_gates].left_input = left;
-    circuit->gates[circuit->num_gates].right_input = right;
-    circuit->gates[circuit->num_gates].output = output;
-    circuit->gates[circuit->num_gates].type = type;
-    circuit->num_gates++;
-}
-
-// Build a full adder: sum = a XOR b XOR cin, cout = (a AND b) OR (cin AND (a XOR b))
-static void build_full_adder(riscv_circuit_t* circuit, uint32_t a, uint32_t b, uint32_t cin,
-                            uint32_t* sum, uint32_t* cout) {
-    // Allocate intermediate wires
-    uint32_t a_xor_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t a_and_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t cin_and_axorb = riscv_circuit_allocate_wire(circuit);
-    
-    // a XOR b
-    riscv_circuit_add_gate(circuit, a, b, a_xor_b, GATE_XOR);
-    
-    // sum = (a XOR b) XOR cin
-    *sum = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a_xor_b, cin, *sum, GATE_XOR);
-    
-    // a AND b
-    riscv_circuit_add_gate(circuit, a, b, a_and_b, GATE_AND);
-    
-    // cin AND (a XOR b)
-    riscv_circuit_add_gate(circuit, cin, a_xor_b, cin_and_axorb, GATE_AND);
-    
-    // cout = (a AND b) OR (cin AND (a XOR b))
-    // Since we only have AND/XOR, we use: a OR b = (a XOR b) XOR (a AND b)
-    uint32_t or_inputs_xor = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a_and_b, cin_and_axorb, or_inputs_xor, GATE_XOR);
-    
-    uint32_t or_inputs_and = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a_and_b, cin_and_axorb, or_inputs_and, GATE_AND);
-    
-    *cout = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, or_inputs_xor, or_inputs_and, *cout, GATE_XOR);
+    circuit->gates[circuit->num_gates++] = *gate;
 }
 
 // Forward declaration for optimized implementation
@@ -379,45 +406,51 @@ uint32_t build_ripple_carry_adder(riscv_circuit_t* circuit, uint32_t* a_bits, ui
     uint32_t carry = CONSTANT_0_WIRE;  // Start with constant 0 (no initial carry)
     
     for (size_t i = 0; i < num_bits; i++) {
-        uint32_t new_carry;
-        build_full_adder(circuit, a_bits[i], b_bits[i], carry, &sum_bits[i], &new_carry);
-        carry = new_carry;
+        sum_bits[i] = gate_full_add(circuit, a_bits[i], b_bits[i], &carry);
     }
     
     return carry;  // Return final carry out
 }
 
-// Main adder function - uses ripple-carry for minimal gate count
+// Main adder function - structure follows circuit->objective
+//   ripple-carry:  ~157 gates, 31 ANDs, depth ~64  (gates, AND-count)
+//   Kogge-Stone:   ~5n log n gates, depth ~2 log n + 2  (depth)
+// The ripple adder already has the minimum one AND per bit, so the
+// AND-count objective keeps it as well.
 uint32_t build_adder(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t* b_bits, 
                      uint32_t* sum_bits, size_t num_bits) {
-    // For zkVM, gate count matters more than circuit depth
-    // Ripple-carry: 224 gates (7 per bit) - minimal gates, acceptable for zkVM
-    // Sparse Kogge-Stone: 396 gates - faster but too many gates
-    // The claims of ~80 gates appear to be incorrect
+    if (circuit->objective == OPTIMIZE_DEPTH) {
+        return build_kogge_stone_adder(circuit, a_bits, b_bits, sum_bits, num_bits);
+    }
     return build_ripple_carry_adder(circuit, a_bits, b_bits, sum_bits, num_bits);
 }
 
 uint32_t build_subtractor(riscv_circuit_t* circuit, uint32_t* a_bits, uint32_t* b_bits,
                           uint32_t* diff_bits, size_t num_bits) {
-    // a - b = a + (~b) + 1
-    // First, invert b
-    uint32_t* b_inverted = riscv_circuit_allocate_wire_array(circuit, num_bits);
-    for (size_t i = 0; i < num_bits; i++) {
-        // NOT b[i] = b[i] XOR 1
-        riscv_circuit_add_gate(circuit, b_bits[i], CONSTANT_1_WIRE, b_inverted[i], GATE_XOR);
+    if (circuit->objective == OPTIMIZE_DEPTH) {
+        // a + ~b + 1 with the +1 as the prefix tree's carry-in
+        uint32_t* not_b = malloc(num_bits * sizeof(uint32_t));
+        for (size_t i = 0; i < num_bits; i++) {
+            not_b[i] = gate_not(circuit, b_bits[i]);
+        }
+        uint32_t carry = build_kogge_stone_adder_with_carry(circuit, a_bits, not_b,
+                                                            CONSTANT_1_WIRE, diff_bits, num_bits);
+        free(not_b);
+        return carry;
     }
     
-    // Add with carry-in = 1
-    uint32_t carry = CONSTANT_1_WIRE;
+    // Borrow chain instead of a + ~b + 1, so b is never inverted:
+    //   diff = a ^ b ^ borrow, borrow' = b ^ ((a ^ borrow) & (b ^ borrow))
+    uint32_t borrow = CONSTANT_0_WIRE;
     
     for (size_t i = 0; i < num_bits; i++) {
-        uint32_t new_carry;
-        build_full_adder(circuit, a_bits[i], b_inverted[i], carry, &diff_bits[i], &new_carry);
-        carry = new_carry;
+        uint32_t a_c = gate_xor(circuit, a_bits[i], borrow);
+        diff_bits[i] = gate_xor(circuit, a_c, b_bits[i]);
+        borrow = gate_xor(circuit, b_bits[i],
+                          gate_and(circuit, a_c, gate_xor(circuit, b_bits[i], borrow)));
     }
     
-    free(b_inverted);
-    return carry;
+    return gate_not(circuit, borrow);  // Carry out of a + ~b + 1
 }
 
 // Compile ADD instruction: rd = rs1 + rs2
@@ -451,9 +484,7 @@ static void compile_xor(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, u
     // XOR each bit
     if (rd != 0) {  // Skip x0
         for (int i = 0; i < 32; i++) {
-            uint32_t result_wire = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, rs1_wires[i], rs2_wires[i], result_wire, GATE_XOR);
-            compiler->reg_wires[rd][i] = result_wire;
+            compiler->reg_wires[rd][i] = gate_xor(circuit, rs1_wires[i], rs2_wires[i]);
         }
     }
 }
@@ -469,9 +500,7 @@ static void compile_and(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, u
     // AND each bit
     if (rd != 0) {  // Skip x0
         for (int i = 0; i < 32; i++) {
-            uint32_t result_wire = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, rs1_wires[i], rs2_wires[i], result_wire, GATE_AND);
-            compiler->reg_wires[rd][i] = result_wire;
+            compiler->reg_wires[rd][i] = gate_and(circuit, rs1_wires[i], rs2_wires[i]);
         }
     }
 }
@@ -503,25 +532,72 @@ void compile_addi(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, int32_t
     // Get source register wires
     uint32_t* rs1_wires = compiler->reg_wires[rs1];
     
-    // Create immediate value wires
-    uint32_t* imm_wires = riscv_circuit_allocate_wire_array(circuit, 32);
+    // Immediate bits are the constant wires themselves
+    uint32_t imm_wires[32];
     for (int i = 0; i < 32; i++) {
-        if (imm & (1 << i)) {
-            imm_wires[i] = 2;  // Wire 2 is constant 1
-        } else {
-            imm_wires[i] = 1;  // Wire 1 is constant 0
+        imm_wires[i] = ((uint32_t)imm >> i) & 1 ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+    }
+    
+    if (rd == 0) return;
+    
+    // li rd, imm (addi rd, x0, imm) and lui+addi pairs fold to pure wiring,
+    // which keeps the value visible as a constant to later instructions
+    // such as MUL
+    uint64_t rs1_value;
+    if (wires_to_constant(rs1_wires, 32, &rs1_value)) {
+        uint32_t value = (uint32_t)rs1_value + (uint32_t)imm;
+        for (int i = 0; i < 32; i++) {
+            compiler->reg_wires[rd][i] = (value >> i) & 1 ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
         }
+        return;
     }
     
     // Add rs1 + imm
-    if (rd != 0) {
-        uint32_t* result_wires = riscv_circuit_allocate_wire_array(circuit, 32);
-        build_adder(circuit, rs1_wires, imm_wires, result_wires, 32);
-        memcpy(compiler->reg_wires[rd], result_wires, 32 * sizeof(uint32_t));
-        free(result_wires);
-    }
+    uint32_t* result_wires = riscv_circuit_allocate_wire_array(circuit, 32);
+    build_adder(circuit, rs1_wires, imm_wires, result_wires, 32);
+    memcpy(compiler->reg_wires[rd], result_wires, 32 * sizeof(uint32_t));
+    free(result_wires);
+}
+
+// Compile SLT/SLTU/SLTI/SLTIU: rd = (a < b) ? 1 : 0
+static void compile_set_less_than(riscv_compiler_t* compiler, uint32_t rd,
+                                  const uint32_t* a_wires, const uint32_t* b_wires,
+                                  bool is_signed) {
+    if (rd == 0) return;
     
-    free(imm_wires);
+    uint32_t less_than = build_compare_lt(compiler->circuit, a_wires, b_wires, 32, is_signed);
+    compiler->reg_wires[rd][0] = less_than;
+    for (int i = 1; i < 32; i++) {
+        compiler->reg_wires[rd][i] = CONSTANT_0_WIRE;
+    }
+}
+
+// Immediate forms compare against the sign-extended immediate (SLTIU too)
+static void compile_set_less_than_imm(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                                      int32_t imm, bool is_signed) {
+    uint32_t imm_wires[32];
+    for (int i = 0; i < 32; i++) {
+        imm_wires[i] = ((uint32_t)imm >> i) & 1 ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+    }
+    compile_set_less_than(compiler, rd, compiler->reg_wires[rs1], imm_wires, is_signed);
+}
+
+// Compile XORI/ORI/ANDI: the immediate bits are constants, so every bit is
+// rs1's bit, its complement or a constant
+static void compile_logic_imm(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                              int32_t imm, uint32_t funct3) {
+    if (rd == 0) return;
+    riscv_circuit_t* circuit = compiler->circuit;
+    uint32_t* rs1_wires = compiler->reg_wires[rs1];
+    for (int i = 0; i < 32; i++) {
+        bool imm_bit = ((uint32_t)imm >> i) & 1;
+        uint32_t a = rs1_wires[i];
+        switch (funct3) {
+            case 0x4: compiler->reg_wires[rd][i] = imm_bit ? gate_not(circuit, a) : a; break;
+            case 0x6: compiler->reg_wires[rd][i] = imm_bit ? CONSTANT_1_WIRE : a; break;
+            default:  compiler->reg_wires[rd][i] = imm_bit ? a : CONSTANT_0_WIRE; break;
+        }
+    }
 }
 
 // Compile OR instruction: rd = rs1 | rs2
@@ -535,15 +611,7 @@ static void compile_or(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, ui
     // OR each bit: a OR b = (a XOR b) XOR (a AND b)
     if (rd != 0) {  // Skip x0
         for (int i = 0; i < 32; i++) {
-            uint32_t a_xor_b = riscv_circuit_allocate_wire(circuit);
-            uint32_t a_and_b = riscv_circuit_allocate_wire(circuit);
-            uint32_t result_wire = riscv_circuit_allocate_wire(circuit);
-            
-            riscv_circuit_add_gate(circuit, rs1_wires[i], rs2_wires[i], a_xor_b, GATE_XOR);
-            riscv_circuit_add_gate(circuit, rs1_wires[i], rs2_wires[i], a_and_b, GATE_AND);
-            riscv_circuit_add_gate(circuit, a_xor_b, a_and_b, result_wire, GATE_XOR);
-            
-            compiler->reg_wires[rd][i] = result_wire;
+            compiler->reg_wires[rd][i] = gate_or(circuit, rs1_wires[i], rs2_wires[i]);
         }
     }
 }
@@ -581,7 +649,12 @@ int riscv_compile_instruction(riscv_compiler_t* compiler, uint32_t instruction)
         return -1;
     }
     
-    // Try shift instructions first
+    // Try bit-manipulation extensions first (they share opcodes with shifts)
+    if (compile_bitmanip_instruction(compiler, instruction) == 0) {
+        return 0;
+    }
+    
+    // Try shift instructions
     if (compile_shift_instruction(compiler, instruction) == 0) {
         return 0;
     }
@@ -631,6 +704,14 @@ int riscv_compile_instruction(riscv_compiler_t* compiler, uint32_t instruction)
                         compile_sub(compiler, rd, rs1, rs2);
                     }
                     break;
+                case 0x2:  // SLT
+                    compile_set_less_than(compiler, rd, compiler->reg_wires[rs1],
+                                          compiler->reg_wires[rs2], true);
+                    break;
+                case 0x3:  // SLTU
+                    compile_set_less_than(compiler, rd, compiler->reg_wires[rs1],
+                                          compiler->reg_wires[rs2], false);
+                    break;
                 case 0x4:  // XOR
                     compile_xor(compiler, rd, rs1, rs2);
                     break;
@@ -649,7 +730,18 @@ int riscv_compile_instruction(riscv_compiler_t* compiler, uint32_t instruction)
                 case 0x0:  // ADDI
                     compile_addi(compiler, rd, rs1, GET_IMM_I(instruction));
                     break;
-                // Other I-type instructions can be added here
+                case 0x2:  // SLTI
+                    compile_set_less_than_imm(compiler, rd, rs1, GET_IMM_I(instruction), true);
+                    break;
+                case 0x3:  // SLTIU
+                    compile_set_less_than_imm(compiler, rd, rs1, GET_IMM_I(instruction), false);
+                    break;
+                case 0x4:  // XORI
+                case 0x6:  // ORI
+                case 0x7:  // ANDI
+                    compile_logic_imm(compiler, rd, rs1, GET_IMM_I(instruction), funct3);
+                    break;
+                // Shift immediates are handled by compile_shift_instruction
             }
             break;
             
@@ -661,6 +753,7 @@ int riscv_compile_instruction(riscv_compiler_t* compiler, uint32_t instruction)
             fprintf(stderr, "   \n");
             fprintf(stderr, "Supported instruction types:\n");
             fprintf(stderr, "   • Arithmetic: ADD, SUB, XOR, AND, OR, ADDI\n");
+            fprintf(stderr, "   • Compare: SLT, SLTU, SLTI, SLTIU\n");
             fprintf(stderr, "   • Shifts: SLL, SRL, SRA, SLLI, SRLI, SRAI\n");
             fprintf(stderr, "   • Branches: BEQ, BNE, BLT, BGE, BLTU, BGEU\n");
             fprintf(stderr, "   • Jumps: JAL, JALR\n");
@@ -669,6 +762,9 @@ int riscv_compile_instruction(riscv_compiler_t* compiler, uint32_t instruction)
             fprintf(stderr, "   • Multiply: MUL, MULH, MULHU, MULHSU\n");
             fprintf(stderr, "   • Divide: DIV, DIVU, REM, REMU\n");
             fprintf(stderr, "   • System: ECALL, EBREAK\n");
+            fprintf(stderr, "   • Zba/Zbb/Zbs: SHxADD, ANDN, ORN, XNOR, CLZ, CTZ, CPOP,\n");
+            fprintf(stderr, "     MIN[U], MAX[U], SEXT, ZEXT.H, ROL, ROR[I], ORC.B, REV8,\n");
+            fprintf(stderr, "     BCLR[I], BSET[I], BINV[I], BEXT[I]\n");
             return -1;
     }
     
@@ -747,7 +843,7 @@ int riscv_compiler_validate(riscv_compiler_t* compiler) {
             }
             
             // Check gate type is valid
-            if (gate->type != GATE_AND && gate->type != GATE_XOR) {
+            if ((unsigned)gate->type >= GATE_TYPE_COUNT) {
                 fprintf(stderr, "❌ VALIDATION ERROR: Gate %zu has invalid type %d\n",
                         i, gate->type);
                 return -9;
@@ -771,14 +867,16 @@ void riscv_circuit_print_stats(const riscv_circuit_t* circuit) {
     printf("  Inputs: %zu\n", circuit->num_inputs);
     printf("  Outputs: %zu\n", circuit->num_outputs);
     
-    size_t and_count = 0, xor_count = 0;
+    size_t counts[GATE_TYPE_COUNT] = {0};
     for (size_t i = 0; i < circuit->num_gates; i++) {
-        if (circuit->gates[i].type == GATE_AND) and_count++;
-        else if (circuit->gates[i].type == GATE_XOR) xor_count++;
+        if ((unsigned)circuit->gates[i].type < GATE_TYPE_COUNT) counts[circuit->gates[i].type]++;
     }
     
-    printf("  AND gates: %zu\n", and_count);
-    printf("  XOR gates: %zu\n", xor_count);
+    printf("  AND gates: %zu\n", counts[GATE_AND]);
+    printf("  XOR gates: %zu\n", counts[GATE_XOR]);
+    for (int type = GATE_OR; type < GATE_TYPE_COUNT; type++) {
+        if (counts[type]) printf("  %s gates: %zu\n", gate_type_name((gate_type_t)type), counts[type]);
+    }
 }
 
 int riscv_circuit_to_file(const riscv_circuit_t* circuit, const char* filename) {
@@ -787,19 +885,23 @@ int riscv_circuit_to_file(const riscv_circuit_t* circuit, const char* filename)
     
     // Write header
     fprintf(f, "# RISC-V compiled circuit\n");
-    fprintf(f, "# Format: gate_id left_input right_input output_wire gate_type\n");
+    fprintf(f, "# Format: gate_id left_input right_input output_wire gate_type [select_input [table]]\n");
     fprintf(f, "CIRCUIT_INPUTS %zu\n", circuit->num_inputs);
     fprintf(f, "CIRCUIT_OUTPUTS %zu\n", circuit->num_outputs);
     fprintf(f, "CIRCUIT_GATES %zu\n", circuit->num_gates);
     
     // Write gates
     for (size_t i = 0; i < circuit->num_gates; i++) {
-        fprintf(f, "%zu %u %u %u %s\n",
+        const gate_t* gate = &circuit->gates[i];
+        fprintf(f, "%zu %u %u %u %s",
                 i,
-                circuit->gates[i].left_input,
-                circuit->gates[i].right_input,
-                circuit->gates[i].output,
-                circuit->gates[i].type == GATE_AND ? "AND" : "XOR");
+                gate->left_input,
+                gate->right_input,
+                gate->output,
+                gate_type_name(gate->type));
+        if (gate->type == GATE_MUX || gate->type == GATE_LUT) fprintf(f, " %u", gate->select_input);
+        if (gate->type == GATE_LUT) fprintf(f, " %02X", gate->table);
+        fprintf(f, "\n");
     }
     
     fclose(f);
@@ -4,6 +4,7 @@
 
 
 #include "riscv_compiler.h"
+#include "circuit_passes.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -16,7 +17,8 @@
  * This is the main entry point that achieves >1.2M instructions/sec by combining:
  * - Parallel compilation (8 threads)
  * - Instruction fusion (LUI+ADDI, etc)
- * - Gate deduplication & caching
+ * - Circuit passes (folding, deduplication, DCE) at -O0..-O3
+ * - Gate caching
  * - Sparse Kogge-Stone adders
  * - Booth multiplication
  * 
@@ -28,7 +30,6 @@ size_t compile_instructions_parallel(riscv_compiler_t* compiler,
                                    uint32_t* instructions, size_t count);
 size_t compile_with_fusion(riscv_compiler_t* compiler,
                           uint32_t* instructions, size_t count);
-void deduplicate_gates(riscv_circuit_t* circuit);
 void gate_cache_print_stats(void);
 void print_fusion_stats(void);
 
@@ -36,7 +37,7 @@ void print_fusion_stats(void);
 typedef struct {
     bool enable_parallel;
     bool enable_fusion;
-    bool enable_deduplication;
+    int opt_level;              // Circuit pass preset, -O0..-O3
     bool enable_caching;
     int num_threads;
     size_t batch_size;
@@ -46,7 +47,7 @@ typedef struct {
 static compiler_config_t g_config = {
     .enable_parallel = true,
     .enable_fusion = true,
-    .enable_deduplication = true,
+    .opt_level = 2,
     .enable_caching = true,
     .num_threads = 8,
     .batch_size = 10000
@@ -75,25 +76,13 @@ size_t riscv_compile_program_optimized(riscv_compiler_t* compiler,
     printf("Optimizations enabled:\n");
     if (g_config.enable_parallel) printf("  ✓ Parallel compilation (%d threads)\n", g_config.num_threads);
     if (g_config.enable_fusion) printf("  ✓ Instruction fusion\n");
-    if (g_config.enable_deduplication) printf("  ✓ Gate deduplication\n");
+    if (g_config.opt_level > 0) printf("  ✓ Circuit passes (-O%d)\n", g_config.opt_level);
     if (g_config.enable_caching) printf("  ✓ Gate caching\n");
     printf("\n");
     
-    // Phase 1: Instruction fusion (if enabled)
-    uint32_t* fused_instructions = instructions;
-    size_t fused_count = count;
-    
-    if (g_config.enable_fusion) {
-        printf("Phase 1: Instruction fusion analysis...\n");
-        
-        // Analyze and mark fusion opportunities
-        // For now, we'll process in the main compilation loop
-        // In a full implementation, this would pre-process the instruction stream
-    }
-    
-    // Phase 2: Parallel compilation
+    // Phase 1: Compilation (fusion happens inside compile_with_fusion)
     if (g_config.enable_parallel && count > 100) {
-        printf("Phase 2: Parallel compilation...\n");
+        printf("Phase 1: Parallel compilation...\n");
         
         // Process in batches for better cache locality
         size_t batch_size = g_config.batch_size;
@@ -114,7 +103,7 @@ size_t riscv_compile_program_optimized(riscv_compiler_t* compiler,
             }
         }
     } else {
-        printf("Phase 2: Sequential compilation%s...\n",
+        printf("Phase 1: Sequential compilation%s...\n",
                g_config.enable_fusion ? " with fusion" : "");
         
         if (g_config.enable_fusion) {
@@ -128,16 +117,18 @@ size_t riscv_compile_program_optimized(riscv_compiler_t* compiler,
         }
     }
     
-    // Phase 3: Gate deduplication
-    if (g_config.enable_deduplication && compiler->circuit->num_gates > 1000) {
-        printf("\nPhase 3: Gate deduplication...\n");
+    // Phase 2: Circuit optimization passes
+    if (g_config.opt_level > 0) {
+        printf("\nPhase 2: Circuit passes (-O%d)...\n", g_config.opt_level);
         size_t gates_before = compiler->circuit->num_gates;
         
-        deduplicate_gates(compiler->circuit);
-        
-        size_t gates_removed = gates_before - compiler->circuit->num_gates;
-        printf("  Removed %zu duplicate gates (%.1f%% reduction)\n",
-               gates_removed, 100.0 * gates_removed / gates_before);
+        pass_manager_t* pm = pass_manager_create_preset(g_config.opt_level);
+        if (pm && pass_manager_run_compiler(pm, compiler) == 0) {
+            size_t gates_removed = gates_before - compiler->circuit->num_gates;
+            printf("  Removed %zu gates (%.1f%% reduction)\n",
+                   gates_removed, gates_before ? 100.0 * gates_removed / gates_before : 0.0);
+        }
+        pass_manager_destroy(pm);
     }
     
     // Calculate performance metrics
@@ -186,23 +177,23 @@ void benchmark_optimized_compiler(void) {
     } configs[] = {
         {
             "Baseline (no optimizations)",
-            {false, false, false, false, 1, 1000}
+            {false, false, 0, false, 1, 1000}
         },
         {
             "Parallel only",
-            {true, false, false, false, 8, 10000}
+            {true, false, 0, false, 8, 10000}
         },
         {
             "Fusion only",
-            {false, true, false, false, 1, 10000}
+            {false, true, 0, false, 1, 10000}
         },
         {
-            "Deduplication only",
-            {false, false, true, false, 1, 10000}
+            "Circuit passes only (-O2)",
+            {false, false, 2, false, 1, 10000}
         },
         {
             "All optimizations",
-            {true, true, true, true, 8, 10000}
+            {true, true, 2, true, 8, 10000}
         }
     };
     
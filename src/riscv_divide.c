@@ -4,6 +4,7 @@
 
 
 #include "riscv_compiler.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -27,377 +28,341 @@
 #define FUNCT3_REM    0x6
 #define FUNCT3_REMU   0x7
 
-// Build a 1-bit comparator: returns 1 if a >= b, 0 otherwise
-static uint32_t build_1bit_comparator(riscv_circuit_t* circuit, uint32_t a, uint32_t b) {
-    // For 1-bit: a >= b is equivalent to (a AND NOT b) OR (NOT a AND NOT b) OR (a AND b)
-    // Simplifies to: a OR (NOT b)
-    // Which is: (a XOR b) XOR (a AND b) XOR b
-    
-    uint32_t a_xor_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t a_and_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t temp = riscv_circuit_allocate_wire(circuit);
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    
-    riscv_circuit_add_gate(circuit, a, b, a_xor_b, GATE_XOR);
-    riscv_circuit_add_gate(circuit, a, b, a_and_b, GATE_AND);
-    riscv_circuit_add_gate(circuit, a_xor_b, a_and_b, temp, GATE_XOR);
-    riscv_circuit_add_gate(circuit, temp, b, result, GATE_XOR);
-    
-    return result;
+// out = negate ? -x : x, as (x ^ negate) + negate
+static void build_conditional_negate(riscv_circuit_t* circuit, const uint32_t* x,
+                                     uint32_t negate, uint32_t* out) {
+    uint32_t carry = negate;
+    for (int i = 0; i < 32; i++) {
+        uint32_t flipped = gate_xor(circuit, x[i], negate);
+        out[i] = gate_xor(circuit, flipped, carry);
+        if (i < 31) carry = gate_and(circuit, flipped, carry);
+    }
 }
 
-// Build unsigned comparison: returns 1 if dividend >= divisor
-static uint32_t build_unsigned_compare(riscv_circuit_t* circuit, 
-                                      uint32_t* dividend, uint32_t* divisor, 
-                                      size_t bits) {
-    // Compare from MSB to LSB
-    uint32_t equal = CONSTANT_1_WIRE;  // Start with "equal so far"
-    uint32_t greater = CONSTANT_0_WIRE; // Start with "not greater"
-    
-    for (int i = bits - 1; i >= 0; i--) {
-        // Check if current bits are equal
-        uint32_t bits_equal = riscv_circuit_allocate_wire(circuit);
-        uint32_t bits_xor = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, dividend[i], divisor[i], bits_xor, GATE_XOR);
-        riscv_circuit_add_gate(circuit, bits_xor, CONSTANT_1_WIRE, bits_equal, GATE_XOR); // NOT
-        
-        // Update greater: if equal so far AND dividend[i] > divisor[i]
-        uint32_t div_greater = build_1bit_comparator(circuit, dividend[i], divisor[i]);
-        uint32_t new_greater_term = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, equal, div_greater, new_greater_term, GATE_AND);
-        
-        // greater = greater OR new_greater_term
-        uint32_t g_xor_n = riscv_circuit_allocate_wire(circuit);
-        uint32_t g_and_n = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, greater, new_greater_term, g_xor_n, GATE_XOR);
-        riscv_circuit_add_gate(circuit, greater, new_greater_term, g_and_n, GATE_AND);
-        uint32_t new_greater = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, g_xor_n, g_and_n, new_greater, GATE_XOR);
-        greater = new_greater;
-        
-        // Update equal: equal = equal AND bits_equal
-        uint32_t new_equal = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, equal, bits_equal, new_equal, GATE_AND);
-        equal = new_equal;
+// Non-restoring division: one add-or-subtract per stage instead of a
+// compare followed by a conditional subtract. The partial remainder R is a
+// 33-bit two's complement value in [-d, d); each stage shifts in the next
+// dividend bit, subtracts d when R >= 0 and adds it otherwise, and the new
+// sign gives the quotient bit. A negative final R is restored by one add.
+//
+// d == 0 needs no special case: every stage subtracts zero, so the
+// quotient is all ones and the remainder is the dividend, as the spec asks.
+static void build_unsigned_divider(riscv_circuit_t* circuit,
+                                   const uint32_t* dividend, const uint32_t* divisor,
+                                   uint32_t* quotient, uint32_t* remainder) {
+    uint32_t rem[33];
+    for (int j = 0; j < 33; j++) {
+        rem[j] = CONSTANT_0_WIRE;
     }
-    
-    // Result is (greater OR equal)
-    uint32_t g_xor_e = riscv_circuit_allocate_wire(circuit);
-    uint32_t g_and_e = riscv_circuit_allocate_wire(circuit);
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, greater, equal, g_xor_e, GATE_XOR);
-    riscv_circuit_add_gate(circuit, greater, equal, g_and_e, GATE_AND);
-    riscv_circuit_add_gate(circuit, g_xor_e, g_and_e, result, GATE_XOR);
-    
-    return result;
-}
+    uint32_t subtract = CONSTANT_1_WIRE;  // R = 0 is non-negative
 
-// Conditional subtraction: if (cond) result = a - b; else result = a;
-static void build_conditional_subtract(riscv_circuit_t* circuit,
-                                     uint32_t* a, uint32_t* b, uint32_t cond,
-                                     uint32_t* result, size_t bits) {
-    // First compute a - b
-    uint32_t* diff = riscv_circuit_allocate_wire_array(circuit, bits);
-    build_subtractor(circuit, a, b, diff, bits);
-    
-    // Then select between a and diff based on cond
-    for (size_t i = 0; i < bits; i++) {
-        // result[i] = cond ? diff[i] : a[i]
-        // = (cond AND diff[i]) OR (NOT cond AND a[i])
-        // = (cond AND diff[i]) XOR (NOT cond AND a[i])  [since they're mutually exclusive]
-        
-        uint32_t not_cond = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, cond, CONSTANT_1_WIRE, not_cond, GATE_XOR);
-        
-        uint32_t term1 = riscv_circuit_allocate_wire(circuit);
-        uint32_t term2 = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, cond, diff[i], term1, GATE_AND);
-        riscv_circuit_add_gate(circuit, not_cond, a[i], term2, GATE_AND);
-        
-        result[i] = riscv_circuit_allocate_wire(circuit);
-        uint32_t t1_xor_t2 = riscv_circuit_allocate_wire(circuit);
-        uint32_t t1_and_t2 = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, term1, term2, t1_xor_t2, GATE_XOR);
-        riscv_circuit_add_gate(circuit, term1, term2, t1_and_t2, GATE_AND);
-        riscv_circuit_add_gate(circuit, t1_xor_t2, t1_and_t2, result[i], GATE_XOR);
+    for (int i = 31; i >= 0; i--) {
+        uint32_t shifted[33];
+        shifted[0] = dividend[i];
+        for (int j = 1; j < 33; j++) {
+            shifted[j] = rem[j - 1];
+        }
+
+        // R -/+ d = R + (d ^ subtract) + subtract; bit 32 of d is zero
+        uint32_t carry = subtract;
+        for (int j = 0; j < 33; j++) {
+            uint32_t d_bit = j < 32 ? gate_xor(circuit, divisor[j], subtract) : subtract;
+            rem[j] = gate_full_add(circuit, shifted[j], d_bit, &carry);
+        }
+
+        quotient[i] = gate_not(circuit, rem[32]);
+        subtract = quotient[i];
+    }
+
+    if (!remainder) return;
+
+    // R < 0: add d back
+    uint32_t carry = CONSTANT_0_WIRE;
+    for (int j = 0; j < 32; j++) {
+        uint32_t d_bit = gate_and(circuit, divisor[j], rem[32]);
+        remainder[j] = gate_full_add(circuit, rem[j], d_bit, &carry);
     }
-    
-    free(diff);
 }
 
-// Build unsigned divider using restoring division algorithm
-static void build_unsigned_divider(riscv_circuit_t* circuit,
-                                  uint32_t* dividend, uint32_t* divisor,
-                                  uint32_t* quotient, uint32_t* remainder) {
-    // Initialize remainder to 0
-    uint32_t* rem = riscv_circuit_allocate_wire_array(circuit, 32);
-    for (int i = 0; i < 32; i++) {
-        rem[i] = CONSTANT_0_WIRE;
+// Quotient and remainder of a 32-bit division with RISC-V semantics
+// (x / 0 = -1, x % 0 = x, INT32_MIN / -1 = INT32_MIN); either output may
+// be NULL. Signed division divides magnitudes and restores the signs:
+// the quotient takes the sign of x ^ d, the remainder the sign of x.
+void build_divider(riscv_circuit_t* circuit, const uint32_t* dividend,
+                   const uint32_t* divisor, bool is_signed,
+                   uint32_t* quotient, uint32_t* remainder) {
+    uint32_t q[32], r[32];
+
+    if (!is_signed) {
+        build_unsigned_divider(circuit, dividend, divisor, q, remainder ? r : NULL);
+        if (quotient) memcpy(quotient, q, sizeof(q));
+        if (remainder) memcpy(remainder, r, sizeof(r));
+        return;
     }
-    
-    // Process each bit from MSB to LSB
-    for (int i = 31; i >= 0; i--) {
-        // Shift remainder left by 1 and bring in dividend bit
-        uint32_t* shifted_rem = riscv_circuit_allocate_wire_array(circuit, 32);
-        shifted_rem[0] = dividend[i];
-        for (int j = 1; j < 32; j++) {
-            shifted_rem[j] = rem[j-1];
+
+    uint32_t x_neg = dividend[31];
+    uint32_t d_neg = divisor[31];
+    uint32_t abs_x[32], abs_d[32];
+    build_conditional_negate(circuit, dividend, x_neg, abs_x);
+    build_conditional_negate(circuit, divisor, d_neg, abs_d);
+
+    build_unsigned_divider(circuit, abs_x, abs_d, q, remainder ? r : NULL);
+
+    if (quotient) {
+        // The all-ones quotient of a division by zero keeps its value
+        uint32_t zeros[32];
+        for (int i = 0; i < 32; i++) zeros[i] = CONSTANT_0_WIRE;
+        uint32_t d_zero = build_compare_eq(circuit, divisor, zeros, 32);
+        uint32_t q_neg = gate_and(circuit, gate_xor(circuit, x_neg, d_neg),
+                                  gate_not(circuit, d_zero));
+        build_conditional_negate(circuit, q, q_neg, quotient);
+    }
+    if (remainder) {
+        build_conditional_negate(circuit, r, x_neg, remainder);
+    }
+}
+
+// ============================================================================
+// Division by a compile-time constant
+// ============================================================================
+
+// Find m, p with floor(x / d) == floor(x * m / 2^p) for every 32-bit x.
+// Granlund-Montgomery: m = ceil(2^p / d) is exact whenever
+// m * d - 2^p <= 2^(p - 32), which always holds by p = 32 + ceil(log2 d);
+// the smallest such p gives the narrowest multiplier.
+static void find_unsigned_magic(uint32_t d, uint64_t* magic, int* shift) {
+    for (int p = 32; p <= 64; p++) {
+        unsigned __int128 two_p = (unsigned __int128)1 << p;
+        unsigned __int128 m = (two_p + d - 1) / d;
+        unsigned __int128 error = m * d - two_p;
+        if (error <= ((unsigned __int128)1 << (p - 32))) {
+            *magic = (uint64_t)m;
+            *shift = p;
+            return;
         }
-        
-        // Check if shifted_rem >= divisor
-        uint32_t can_subtract = build_unsigned_compare(circuit, shifted_rem, divisor, 32);
-        
-        // Conditionally subtract divisor from shifted_rem
-        uint32_t* new_rem = riscv_circuit_allocate_wire_array(circuit, 32);
-        build_conditional_subtract(circuit, shifted_rem, divisor, can_subtract, new_rem, 32);
-        
-        // Set quotient bit
-        quotient[i] = can_subtract;
-        
-        // Update remainder for next iteration
-        free(rem);
-        rem = new_rem;
-        free(shifted_rem);
     }
-    
-    // Copy final remainder
-    memcpy(remainder, rem, 32 * sizeof(uint32_t));
-    free(rem);
 }
 
-// Handle division by zero according to RISC-V spec
-static void handle_div_by_zero(riscv_circuit_t* circuit, uint32_t* divisor,
-                             uint32_t* quotient, uint32_t* remainder,
-                             uint32_t* dividend, int is_signed) {
-    // Check if divisor is zero
-    uint32_t is_zero = CONSTANT_1_WIRE;
-    for (int i = 0; i < 32; i++) {
-        uint32_t not_bit = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, divisor[i], CONSTANT_1_WIRE, not_bit, GATE_XOR);
-        uint32_t new_is_zero = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, is_zero, not_bit, new_is_zero, GATE_AND);
-        is_zero = new_is_zero;
+static size_t bit_length(uint64_t value) {
+    size_t n = 0;
+    while (value) {
+        n++;
+        value >>= 1;
     }
-    
-    // If divisor is zero:
-    // - quotient = -1 (all ones)
-    // - remainder = dividend
-    
-    for (int i = 0; i < 32; i++) {
-        // quotient[i] = is_zero ? 1 : quotient[i]
-        uint32_t not_is_zero = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, is_zero, CONSTANT_1_WIRE, not_is_zero, GATE_XOR);
-        
-        uint32_t q_term1 = riscv_circuit_allocate_wire(circuit);
-        uint32_t q_term2 = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, is_zero, CONSTANT_1_WIRE, q_term1, GATE_AND);
-        riscv_circuit_add_gate(circuit, not_is_zero, quotient[i], q_term2, GATE_AND);
-        
-        uint32_t new_q = riscv_circuit_allocate_wire(circuit);
-        uint32_t q_xor = riscv_circuit_allocate_wire(circuit);
-        uint32_t q_and = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, q_term1, q_term2, q_xor, GATE_XOR);
-        riscv_circuit_add_gate(circuit, q_term1, q_term2, q_and, GATE_AND);
-        riscv_circuit_add_gate(circuit, q_xor, q_and, new_q, GATE_XOR);
-        quotient[i] = new_q;
-        
-        // remainder[i] = is_zero ? dividend[i] : remainder[i]
-        uint32_t r_term1 = riscv_circuit_allocate_wire(circuit);
-        uint32_t r_term2 = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, is_zero, dividend[i], r_term1, GATE_AND);
-        riscv_circuit_add_gate(circuit, not_is_zero, remainder[i], r_term2, GATE_AND);
-        
-        uint32_t new_r = riscv_circuit_allocate_wire(circuit);
-        uint32_t r_xor = riscv_circuit_allocate_wire(circuit);
-        uint32_t r_and = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, r_term1, r_term2, r_xor, GATE_XOR);
-        riscv_circuit_add_gate(circuit, r_term1, r_term2, r_and, GATE_AND);
-        riscv_circuit_add_gate(circuit, r_xor, r_and, new_r, GATE_XOR);
-        remainder[i] = new_r;
+    return n;
+}
+
+// Unsigned x / d and x % d for a constant d != 0. Powers of two are pure
+// rewiring; other divisors multiply by a magic constant and keep the high
+// bits. The remainder is x - q * d, computed only over the bits of d since
+// it is always smaller than d. Either output may be NULL.
+void build_unsigned_divide_by_constant(riscv_circuit_t* circuit, const uint32_t* x,
+                                       uint32_t d, uint32_t* quotient, uint32_t* remainder) {
+    size_t d_bits = bit_length(d);
+
+    if ((d & (d - 1)) == 0) {
+        int k = (int)d_bits - 1;
+        for (int i = 0; i < 32; i++) {
+            if (quotient) quotient[i] = i + k < 32 ? x[i + k] : CONSTANT_0_WIRE;
+            if (remainder) remainder[i] = i < k ? x[i] : CONSTANT_0_WIRE;
+        }
+        return;
     }
+
+    uint64_t magic = 0;
+    int shift = 32;
+    find_unsigned_magic(d, &magic, &shift);
+
+    // x * magic < 2^(32 + bits(magic)), so that width is exact
+    size_t width = 32 + bit_length(magic);
+    uint32_t* wide = malloc(width * sizeof(uint32_t));
+    uint32_t* product = malloc(width * sizeof(uint32_t));
+    for (size_t i = 0; i < width; i++) {
+        wide[i] = i < 32 ? x[i] : CONSTANT_0_WIRE;
+    }
+    build_constant_multiplier(circuit, wide, width, magic, product);
+
+    uint32_t q[32];
+    for (size_t i = 0; i < 32; i++) {
+        q[i] = shift + i < width ? product[shift + i] : CONSTANT_0_WIRE;
+    }
+    if (quotient) memcpy(quotient, q, sizeof(q));
+
+    if (remainder) {
+        uint32_t qd[32], low[32], diff[32];
+        build_constant_multiplier(circuit, q, d_bits, d, qd);
+        memcpy(low, x, d_bits * sizeof(uint32_t));
+        build_subtractor(circuit, low, qd, diff, d_bits);
+        for (size_t i = 0; i < 32; i++) {
+            remainder[i] = i < d_bits ? diff[i] : CONSTANT_0_WIRE;
+        }
+    }
+
+    free(wide);
+    free(product);
 }
 
-// Compile DIV instruction: rd = rs1 / rs2 (signed)
-static void compile_div(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    riscv_circuit_t* circuit = compiler->circuit;
-    
-    // Get operands
-    uint32_t* dividend = compiler->reg_wires[rs1];
-    uint32_t* divisor = compiler->reg_wires[rs2];
-    
-    // For signed division, we need to:
-    // 1. Get absolute values
-    // 2. Do unsigned division
-    // 3. Adjust sign of result
-    
-    // Check signs
-    uint32_t dividend_neg = dividend[31];
-    uint32_t divisor_neg = divisor[31];
-    
-    // Compute absolute values
-    uint32_t* abs_dividend = riscv_circuit_allocate_wire_array(circuit, 32);
-    uint32_t* abs_divisor = riscv_circuit_allocate_wire_array(circuit, 32);
-    
-    // abs(x) = x if x >= 0, else -x
+static void write_constant(uint32_t* wires, uint32_t value) {
     for (int i = 0; i < 32; i++) {
-        // For dividend
-        uint32_t div_inv = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, dividend[i], dividend_neg, div_inv, GATE_XOR);
-        abs_dividend[i] = div_inv; // Simplified for now
-        
-        // For divisor
-        uint32_t divis_inv = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, divisor[i], divisor_neg, divis_inv, GATE_XOR);
-        abs_divisor[i] = divis_inv; // Simplified for now
+        wires[i] = (value >> i) & 1 ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
     }
-    
-    // Perform unsigned division
-    uint32_t* quotient = riscv_circuit_allocate_wire_array(circuit, 32);
-    uint32_t* remainder = riscv_circuit_allocate_wire_array(circuit, 32);
-    build_unsigned_divider(circuit, abs_dividend, abs_divisor, quotient, remainder);
-    
-    // Handle division by zero
-    handle_div_by_zero(circuit, divisor, quotient, remainder, dividend, 1);
-    
-    // Adjust sign: result is negative if signs differ
-    uint32_t result_neg = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, dividend_neg, divisor_neg, result_neg, GATE_XOR);
-    
-    // Conditionally negate quotient
-    if (rd != 0) {
-        for (int i = 0; i < 32; i++) {
-            uint32_t inv_bit = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, quotient[i], result_neg, inv_bit, GATE_XOR);
-            compiler->reg_wires[rd][i] = inv_bit; // Simplified
-        }
+}
+
+// Reference semantics, used when both operands are known
+static uint32_t fold_divide(uint32_t funct3, uint32_t a, uint32_t d) {
+    int32_t sa = (int32_t)a, sd = (int32_t)d;
+    switch (funct3) {
+        case FUNCT3_DIV:
+            if (d == 0) return 0xFFFFFFFF;
+            if (sa == INT32_MIN && sd == -1) return a;
+            return (uint32_t)(sa / sd);
+        case FUNCT3_DIVU:
+            return d == 0 ? 0xFFFFFFFF : a / d;
+        case FUNCT3_REM:
+            if (d == 0) return a;
+            if (sa == INT32_MIN && sd == -1) return 0;
+            return (uint32_t)(sa % sd);
+        default:
+            return d == 0 ? a : a % d;
     }
-    
-    free(abs_dividend);
-    free(abs_divisor);
-    free(quotient);
-    free(remainder);
 }
 
-// Compile DIVU instruction: rd = rs1 / rs2 (unsigned)
-static void compile_divu(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    riscv_circuit_t* circuit = compiler->circuit;
-    
-    // Get operands
-    uint32_t* dividend = compiler->reg_wires[rs1];
-    uint32_t* divisor = compiler->reg_wires[rs2];
-    
-    // Allocate result arrays
-    uint32_t* quotient = riscv_circuit_allocate_wire_array(circuit, 32);
-    uint32_t* remainder = riscv_circuit_allocate_wire_array(circuit, 32);
-    
-    // Perform unsigned division
-    build_unsigned_divider(circuit, dividend, divisor, quotient, remainder);
-    
-    // Handle division by zero
-    handle_div_by_zero(circuit, divisor, quotient, remainder, dividend, 0);
-    
-    // Store quotient in destination register
-    if (rd != 0) {
-        memcpy(compiler->reg_wires[rd], quotient, 32 * sizeof(uint32_t));
+// Division by a constant d, same conventions as build_divider
+static void build_divide_by_constant(riscv_circuit_t* circuit, const uint32_t* x,
+                                     uint32_t d, bool is_signed,
+                                     uint32_t* quotient, uint32_t* remainder) {
+    // Division by zero: quotient is all ones, remainder is the dividend
+    if (d == 0) {
+        if (quotient) write_constant(quotient, 0xFFFFFFFF);
+        if (remainder) memcpy(remainder, x, 32 * sizeof(uint32_t));
+        return;
+    }
+
+    if (!is_signed) {
+        build_unsigned_divide_by_constant(circuit, x, d, quotient, remainder);
+        return;
+    }
+
+    // |INT32_MIN| is 2^31 as an unsigned magnitude, so the overflow case
+    // INT32_MIN / -1 wraps back to INT32_MIN as the spec requires
+    uint32_t x_neg = x[31];
+    bool d_neg = (int32_t)d < 0;
+    uint32_t magnitude[32], q[32], r[32];
+    build_conditional_negate(circuit, x, x_neg, magnitude);
+    build_unsigned_divide_by_constant(circuit, magnitude, d_neg ? 0u - d : d,
+                                      quotient ? q : NULL, remainder ? r : NULL);
+
+    if (quotient) {
+        uint32_t q_neg = d_neg ? gate_not(circuit, x_neg) : x_neg;
+        build_conditional_negate(circuit, q, q_neg, quotient);
+    }
+    if (remainder) {
+        build_conditional_negate(circuit, r, x_neg, remainder);
     }
-    
-    free(quotient);
-    free(remainder);
 }
 
-// Compile REM instruction: rd = rs1 % rs2 (signed)
-static void compile_rem(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    riscv_circuit_t* circuit = compiler->circuit;
-    
-    // Similar to DIV but we keep the remainder instead
-    uint32_t* dividend = compiler->reg_wires[rs1];
-    uint32_t* divisor = compiler->reg_wires[rs2];
-    
-    // For signed remainder, sign of result matches dividend
-    uint32_t dividend_neg = dividend[31];
-    
-    // Compute absolute values (simplified)
-    uint32_t* abs_dividend = riscv_circuit_allocate_wire_array(circuit, 32);
-    uint32_t* abs_divisor = riscv_circuit_allocate_wire_array(circuit, 32);
-    
-    for (int i = 0; i < 32; i++) {
-        abs_dividend[i] = dividend[i]; // Simplified
-        abs_divisor[i] = divisor[i];   // Simplified
+// ============================================================================
+// Instruction lowering
+// ============================================================================
+
+// Quotient and/or remainder of rs1 / rs2, picking the cheapest lowering:
+// constant folding, constant divisor, or the general divider
+static void build_division(riscv_compiler_t* compiler, uint32_t rs1, uint32_t rs2,
+                           bool is_signed, uint32_t* quotient, uint32_t* remainder) {
+    uint32_t* x = compiler->reg_wires[rs1];
+    uint32_t* d = compiler->reg_wires[rs2];
+    uint64_t x_value, d_value;
+
+    if (!wires_to_constant(d, 32, &d_value)) {
+        build_divider(compiler->circuit, x, d, is_signed, quotient, remainder);
+        return;
     }
-    
-    // Perform division to get remainder
-    uint32_t* quotient = riscv_circuit_allocate_wire_array(circuit, 32);
-    uint32_t* remainder = riscv_circuit_allocate_wire_array(circuit, 32);
-    build_unsigned_divider(circuit, abs_dividend, abs_divisor, quotient, remainder);
-    
-    // Handle division by zero
-    handle_div_by_zero(circuit, divisor, quotient, remainder, dividend, 1);
-    
-    // Store remainder with appropriate sign
-    if (rd != 0) {
-        memcpy(compiler->reg_wires[rd], remainder, 32 * sizeof(uint32_t));
+
+    if (wires_to_constant(x, 32, &x_value)) {
+        uint32_t div_op = is_signed ? FUNCT3_DIV : FUNCT3_DIVU;
+        uint32_t rem_op = is_signed ? FUNCT3_REM : FUNCT3_REMU;
+        if (quotient) {
+            write_constant(quotient, fold_divide(div_op, (uint32_t)x_value, (uint32_t)d_value));
+        }
+        if (remainder) {
+            write_constant(remainder, fold_divide(rem_op, (uint32_t)x_value, (uint32_t)d_value));
+        }
+        return;
     }
-    
-    free(abs_dividend);
-    free(abs_divisor);
-    free(quotient);
-    free(remainder);
+
+    build_divide_by_constant(compiler->circuit, x, (uint32_t)d_value, is_signed,
+                             quotient, remainder);
 }
 
-// Compile REMU instruction: rd = rs1 % rs2 (unsigned)
-static void compile_remu(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    riscv_circuit_t* circuit = compiler->circuit;
-    
-    // Get operands
-    uint32_t* dividend = compiler->reg_wires[rs1];
-    uint32_t* divisor = compiler->reg_wires[rs2];
-    
-    // Allocate result arrays
-    uint32_t* quotient = riscv_circuit_allocate_wire_array(circuit, 32);
-    uint32_t* remainder = riscv_circuit_allocate_wire_array(circuit, 32);
-    
-    // Perform unsigned division
-    build_unsigned_divider(circuit, dividend, divisor, quotient, remainder);
-    
-    // Handle division by zero
-    handle_div_by_zero(circuit, divisor, quotient, remainder, dividend, 0);
-    
-    // Store remainder in destination register
-    if (rd != 0) {
-        memcpy(compiler->reg_wires[rd], remainder, 32 * sizeof(uint32_t));
+static bool is_quotient_op(uint32_t funct3) {
+    return funct3 == FUNCT3_DIV || funct3 == FUNCT3_DIVU;
+}
+
+static bool is_signed_op(uint32_t funct3) {
+    return funct3 == FUNCT3_DIV || funct3 == FUNCT3_REM;
+}
+
+// Compile DIV, DIVU, REM or REMU
+static void compile_division(riscv_compiler_t* compiler, uint32_t funct3,
+                             uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    if (rd == 0) return;
+
+    uint32_t result[32];
+    bool want_quotient = is_quotient_op(funct3);
+    build_division(compiler, rs1, rs2, is_signed_op(funct3),
+                   want_quotient ? result : NULL, want_quotient ? NULL : result);
+    memcpy(compiler->reg_wires[rd], result, sizeof(result));
+}
+
+static bool is_div_instruction(uint32_t instruction) {
+    return GET_OPCODE(instruction) == OPCODE_OP && GET_FUNCT7(instruction) == FUNCT7_MULDIV &&
+           GET_FUNCT3(instruction) >= FUNCT3_DIV;
+}
+
+// Two adjacent divisions of the same operands with the same signedness,
+// one quotient and one remainder, in either order (what compilers emit for
+// x / y and x % y). The first must not overwrite a source.
+bool match_div_pair(uint32_t first, uint32_t second) {
+    if (!is_div_instruction(first) || !is_div_instruction(second)) return false;
+    if (GET_RS1(first) != GET_RS1(second) || GET_RS2(first) != GET_RS2(second)) return false;
+
+    uint32_t f3_first = GET_FUNCT3(first);
+    uint32_t f3_second = GET_FUNCT3(second);
+    if (is_quotient_op(f3_first) == is_quotient_op(f3_second)) return false;
+    if (is_signed_op(f3_first) != is_signed_op(f3_second)) return false;
+
+    uint32_t rd = GET_RD(first);
+    return rd == 0 || (rd != GET_RS1(first) && rd != GET_RS2(first));
+}
+
+// Build the divider once and take both the quotient and the remainder
+int compile_div_pair(riscv_compiler_t* compiler, uint32_t first, uint32_t second) {
+    if (!match_div_pair(first, second)) return -1;
+
+    uint32_t quotient[32], remainder[32];
+    build_division(compiler, GET_RS1(first), GET_RS2(first), is_signed_op(GET_FUNCT3(first)),
+                   quotient, remainder);
+
+    // Program order, so a shared rd ends up holding the second result
+    uint32_t order[2] = {first, second};
+    for (int n = 0; n < 2; n++) {
+        uint32_t rd = GET_RD(order[n]);
+        if (rd == 0) continue;
+        uint32_t* result = is_quotient_op(GET_FUNCT3(order[n])) ? quotient : remainder;
+        memcpy(compiler->reg_wires[rd], result, 32 * sizeof(uint32_t));
     }
-    
-    free(quotient);
-    free(remainder);
+    return 0;
 }
 
 // Main division instruction compiler
 int compile_divide_instruction(riscv_compiler_t* compiler, uint32_t instruction) {
-    uint32_t opcode = GET_OPCODE(instruction);
-    uint32_t rd = GET_RD(instruction);
-    uint32_t funct3 = GET_FUNCT3(instruction);
-    uint32_t rs1 = GET_RS1(instruction);
-    uint32_t rs2 = GET_RS2(instruction);
-    uint32_t funct7 = GET_FUNCT7(instruction);
-    
-    if (opcode == OPCODE_OP && funct7 == FUNCT7_MULDIV) {
-        switch (funct3) {
-            case FUNCT3_DIV:
-                compile_div(compiler, rd, rs1, rs2);
-                return 0;
-            case FUNCT3_DIVU:
-                compile_divu(compiler, rd, rs1, rs2);
-                return 0;
-            case FUNCT3_REM:
-                compile_rem(compiler, rd, rs1, rs2);
-                return 0;
-            case FUNCT3_REMU:
-                compile_remu(compiler, rd, rs1, rs2);
-                return 0;
-        }
+    if (!is_div_instruction(instruction)) {
+        return -1; // Not a division instruction
     }
     
-    return -1; // Not a division instruction
+    compile_division(compiler, GET_FUNCT3(instruction), GET_RD(instruction),
+                     GET_RS1(instruction), GET_RS2(instruction));
+    return 0;
 }
 
 // Test function for division instructions
@@ -428,7 +393,7 @@ void test_division_instructions(void) {
         size_t gates_used = compiler->circuit->num_gates - gates_before;
         printf("✓ DIVU compiled successfully\n");
         printf("Gates used: %zu\n", gates_used);
-        printf("Algorithm: Restoring division (32 iterations)\n");
+        printf("Algorithm: Non-restoring division (32 iterations)\n");
     } else {
         printf("✗ DIVU compilation failed\n");
     }
@@ -481,7 +446,7 @@ void test_division_instructions(void) {
     printf("====================\n");
     
     printf("Division instruction characteristics:\n");
-    printf("  • Algorithm: Restoring division (bit-by-bit)\n");
+    printf("  • Algorithm: Non-restoring division (one add/sub per bit)\n");
     printf("  • Iterations: 32 (one per bit)\n");
     printf("  • Gate count: ~%zu per division\n", 
            compiler->circuit->num_gates / 3);
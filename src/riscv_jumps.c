@@ -122,7 +122,10 @@ static int compile_jalr(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, i
         temp_wires[i] = riscv_circuit_allocate_wire(compiler->circuit);
     }
     
-    // Step 1: rd = PC + 4 (return address)
+    // Step 1: temp = rs1 + immediate, before rd is written (rd may be rs1)
+    add_immediate_to_pc(compiler->circuit, rs1_wires, immediate, temp_wires);
+    
+    // Step 2: rd = PC + 4 (return address)
     if (rd != 0) {  // Don't write to x0
         increment_pc_by_4(compiler->circuit, pc_wires, rd_wires);
         
@@ -130,9 +133,6 @@ static int compile_jalr(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, i
         memcpy(compiler->reg_wires[rd], rd_wires, 32 * sizeof(uint32_t));
     }
     
-    // Step 2: temp = rs1 + immediate
-    add_immediate_to_pc(compiler->circuit, rs1_wires, immediate, temp_wires);
-    
     // Step 3: PC = temp & ~1 (clear LSB for alignment)
     for (int i = 0; i < 32; i++) {
         if (i == 0) {
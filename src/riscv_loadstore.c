@@ -47,7 +47,7 @@ void compile_lw(riscv_compiler_t* compiler, riscv_memory_t* memory, uint32_t ins
     // Calculate address: rs1 + imm
     uint32_t* imm_bits = riscv_circuit_allocate_wire_array(circuit, 32);
     for (int i = 0; i < 32; i++) {
-        imm_bits[i] = (imm & (1 << i)) ? 2 : 1;
+        imm_bits[i] = ((uint32_t)imm >> i) & 1 ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
     }
     
     uint32_t* address = riscv_circuit_allocate_wire_array(circuit, 32);
@@ -57,10 +57,10 @@ void compile_lw(riscv_compiler_t* compiler, riscv_memory_t* memory, uint32_t ins
     uint32_t* read_data = riscv_circuit_allocate_wire_array(circuit, 32);
     uint32_t* dummy_write_data = riscv_circuit_allocate_wire_array(circuit, 32);
     for (int i = 0; i < 32; i++) {
-        dummy_write_data[i] = 1;  // All zeros
+        dummy_write_data[i] = CONSTANT_0_WIRE;
     }
     
-    memory->access(memory, address, dummy_write_data, 1, read_data);  // write_enable = 0
+    memory->access(memory, address, dummy_write_data, CONSTANT_0_WIRE, read_data);
     
     // Store result in rd (if not x0)
     if (rd != 0) {
@@ -84,7 +84,7 @@ void compile_sw(riscv_compiler_t* compiler, riscv_memory_t* memory, uint32_t ins
     // Calculate address: rs1 + imm
     uint32_t* imm_bits = riscv_circuit_allocate_wire_array(circuit, 32);
     for (int i = 0; i < 32; i++) {
-        imm_bits[i] = (imm & (1 << i)) ? 2 : 1;
+        imm_bits[i] = ((uint32_t)imm >> i) & 1 ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
     }
     
     uint32_t* address = riscv_circuit_allocate_wire_array(circuit, 32);
@@ -93,7 +93,7 @@ void compile_sw(riscv_compiler_t* compiler, riscv_memory_t* memory, uint32_t ins
     // Perform memory write
     uint32_t* dummy_read_data = riscv_circuit_allocate_wire_array(circuit, 32);
     
-    memory->access(memory, address, compiler->reg_wires[rs2], 2, dummy_read_data);  // write_enable = 1
+    memory->access(memory, address, compiler->reg_wires[rs2], CONSTANT_1_WIRE, dummy_read_data);
     
     free(imm_bits);
     free(address);
@@ -111,7 +111,7 @@ void compile_lb(riscv_compiler_t* compiler, riscv_memory_t* memory, uint32_t ins
     // Calculate address: rs1 + imm
     uint32_t* imm_bits = riscv_circuit_allocate_wire_array(circuit, 32);
     for (int i = 0; i < 32; i++) {
-        imm_bits[i] = (imm & (1 << i)) ? 2 : 1;
+        imm_bits[i] = ((uint32_t)imm >> i) & 1 ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
     }
     
     uint32_t* address = riscv_circuit_allocate_wire_array(circuit, 32);
@@ -121,10 +121,10 @@ void compile_lb(riscv_compiler_t* compiler, riscv_memory_t* memory, uint32_t ins
     uint32_t* read_data = riscv_circuit_allocate_wire_array(circuit, 32);
     uint32_t* dummy_write_data = riscv_circuit_allocate_wire_array(circuit, 32);
     for (int i = 0; i < 32; i++) {
-        dummy_write_data[i] = 1;  // All zeros
+        dummy_write_data[i] = CONSTANT_0_WIRE;
     }
     
-    memory->access(memory, address, dummy_write_data, 1, read_data);
+    memory->access(memory, address, dummy_write_data, CONSTANT_0_WIRE, read_data);
     
     // Extract byte and sign extend
     if (rd != 0) {
@@ -169,7 +169,7 @@ void compile_lbu(riscv_compiler_t* compiler, riscv_memory_t* memory, uint32_t in
         
         // Zero extend
         for (int i = 8; i < 32; i++) {
-            compiler->reg_wires[rd][i] = 1;  // Wire 1 is constant 0
+            compiler->reg_wires[rd][i] = CONSTANT_0_WIRE;
         }
         
         free(read_data);
@@ -4,42 +4,37 @@
 
 
 #include "riscv_memory.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-// Helper: Create NOT gate
-static uint32_t build_not(riscv_circuit_t* circuit, uint32_t a) {
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a, 2, result, GATE_XOR);  // a XOR 1 = NOT a
-    return result;
+// Adds pointers to n wire slots to roots (if non-NULL); returns n
+static size_t add_roots(uint32_t** roots, size_t count, uint32_t* wires, size_t n) {
+    if (!wires) return 0;
+    if (roots) {
+        for (size_t i = 0; i < n; i++) roots[count + i] = &wires[i];
+    }
+    return n;
 }
 
-// Helper: Create OR gate  
-static uint32_t build_or(riscv_circuit_t* circuit, uint32_t a, uint32_t b) {
-    // a OR b = (a XOR b) XOR (a AND b)
-    uint32_t a_xor_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t a_and_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    
-    riscv_circuit_add_gate(circuit, a, b, a_xor_b, GATE_XOR);
-    riscv_circuit_add_gate(circuit, a, b, a_and_b, GATE_AND);
-    riscv_circuit_add_gate(circuit, a_xor_b, a_and_b, result, GATE_XOR);
-    
-    return result;
+static size_t merkle_memory_roots(riscv_memory_t* memory, uint32_t** roots) {
+    size_t n = add_roots(roots, 0, memory->merkle_root_wires, 256);
+    n += add_roots(roots, n, memory->leaf_data_wires, 32);
+    for (int i = 0; i < MEMORY_BITS; i++) {
+        n += add_roots(roots, n, memory->sibling_hashes[i], 256);
+    }
+    return n;
 }
 
-// Helper: Create 2-to-1 MUX
-static uint32_t build_mux(riscv_circuit_t* circuit, uint32_t sel, uint32_t a, uint32_t b) {
-    // result = sel ? b : a = (sel AND b) OR ((NOT sel) AND a)
-    uint32_t not_sel = build_not(circuit, sel);
-    uint32_t sel_and_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t notsel_and_a = riscv_circuit_allocate_wire(circuit);
-    
-    riscv_circuit_add_gate(circuit, sel, b, sel_and_b, GATE_AND);
-    riscv_circuit_add_gate(circuit, not_sel, a, notsel_and_a, GATE_AND);
-    
-    return build_or(circuit, sel_and_b, notsel_and_a);
+// Interface wires are common to every implementation; the hook adds the rest
+size_t riscv_memory_roots(riscv_memory_t* memory, uint32_t** roots) {
+    if (!memory) return 0;
+    size_t n = add_roots(roots, 0, memory->address_wires, 32);
+    n += add_roots(roots, n, memory->data_in_wires, 32);
+    n += add_roots(roots, n, memory->data_out_wires, 32);
+    if (memory->roots) n += memory->roots(memory, roots ? roots + n : NULL);
+    return n;
 }
 
 riscv_memory_t* riscv_memory_create(riscv_circuit_t* circuit) {
@@ -48,6 +43,7 @@ riscv_memory_t* riscv_memory_create(riscv_circuit_t* circuit) {
     
     memory->circuit = circuit;
     memory->access = riscv_memory_access;  // Set function pointer
+    memory->roots = merkle_memory_roots;
     
     // Allocate Merkle root wires (256 bits for SHA3-256)
     memory->merkle_root_wires = riscv_circuit_allocate_wire_array(circuit, 256);
@@ -92,29 +88,7 @@ uint32_t build_equality_checker(riscv_circuit_t* circuit,
                                uint32_t* a_bits,
                                uint32_t* b_bits,
                                size_t num_bits) {
-    // Check if all bits are equal
-    // equal = AND of all (a[i] XNOR b[i])
-    // XNOR = NOT XOR
-    
-    uint32_t* bit_equals = riscv_circuit_allocate_wire_array(circuit, num_bits);
-    
-    // Check each bit
-    for (size_t i = 0; i < num_bits; i++) {
-        uint32_t xor_result = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, a_bits[i], b_bits[i], xor_result, GATE_XOR);
-        bit_equals[i] = build_not(circuit, xor_result);  // XNOR
-    }
-    
-    // AND all bit equalities together
-    uint32_t result = bit_equals[0];
-    for (size_t i = 1; i < num_bits; i++) {
-        uint32_t new_result = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, result, bit_equals[i], new_result, GATE_AND);
-        result = new_result;
-    }
-    
-    free(bit_equals);
-    return result;
+    return build_compare_eq(circuit, a_bits, b_bits, num_bits);
 }
 
 // Build conditional update for arrays
@@ -124,13 +98,11 @@ void build_conditional_update(riscv_circuit_t* circuit,
                              uint32_t* new_value,
                              uint32_t* output,
                              size_t num_bits) {
-    for (size_t i = 0; i < num_bits; i++) {
-        output[i] = build_mux(circuit, condition, old_value[i], new_value[i]);
-    }
+    gate_mux_word(circuit, condition, new_value, old_value, output, num_bits);
 }
 
 // Forward declaration - implemented in sha3_circuit.c
-// Real SHA3-256 implementation with ~192K gates for cryptographic security
+// Real SHA3-256 implementation with ~190K gates, instanced from a template
 void build_sha3_256_circuit(riscv_circuit_t* circuit,
                            uint32_t* input_bits,  // 512 bits input
                            uint32_t* output_bits); // 256 bits output
@@ -154,7 +126,7 @@ void riscv_memory_access(riscv_memory_t* memory,
         current_hash[i] = memory->leaf_data_wires[i];
     }
     for (int i = 32; i < 256; i++) {
-        current_hash[i] = 1;  // Pad with zeros
+        current_hash[i] = CONSTANT_0_WIRE;  // Pad with zeros
     }
     
     // For each level of the tree
@@ -169,13 +141,13 @@ void riscv_memory_access(riscv_memory_t* memory,
         // If address bit is 1, sibling hash goes first
         for (int i = 0; i < 256; i++) {
             // First half
-            hash_input[i] = build_mux(circuit, addr_bit, 
-                                     memory->sibling_hashes[level][i], 
-                                     current_hash[i]);
+            hash_input[i] = gate_mux(circuit, addr_bit,
+                                     current_hash[i],
+                                     memory->sibling_hashes[level][i]);
             // Second half
-            hash_input[256 + i] = build_mux(circuit, addr_bit,
-                                           current_hash[i],
-                                           memory->sibling_hashes[level][i]);
+            hash_input[256 + i] = gate_mux(circuit, addr_bit,
+                                           memory->sibling_hashes[level][i],
+                                           current_hash[i]);
         }
         
         // Compute parent hash
@@ -195,15 +167,14 @@ void riscv_memory_access(riscv_memory_t* memory,
     
     // Step 2: Read current value (only valid if proof is valid)
     for (int i = 0; i < 32; i++) {
-        uint32_t invalid_read = 1;  // Return 0 if proof invalid
-        read_data_bits[i] = build_mux(circuit, proof_valid,
-                                      invalid_read,
-                                      memory->leaf_data_wires[i]);
+        uint32_t invalid_read = CONSTANT_0_WIRE;  // Return 0 if proof invalid
+        read_data_bits[i] = gate_mux(circuit, proof_valid,
+                                     memory->leaf_data_wires[i],
+                                     invalid_read);
     }
     
     // Step 3: Conditionally update leaf and root if write is enabled
-    uint32_t do_write = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, write_enable, proof_valid, do_write, GATE_AND);
+    uint32_t do_write = gate_and(circuit, write_enable, proof_valid);
     
     // Update leaf data
     uint32_t* new_leaf_data = riscv_circuit_allocate_wire_array(circuit, 32);
@@ -4,6 +4,7 @@
 
 
 #include "riscv_memory.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -16,56 +17,24 @@
 #define SIMPLE_MEM_WORDS 256
 #define SIMPLE_MEM_ADDR_BITS 8
 
-// Helper: Create NOT gate
-static uint32_t build_not(riscv_circuit_t* circuit, uint32_t a) {
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a, CONSTANT_1_WIRE, result, GATE_XOR);
-    return result;
-}
-
-
-// Helper: Create OR gate
-static uint32_t build_or(riscv_circuit_t* circuit, uint32_t a, uint32_t b) {
-    // a OR b = (a XOR b) XOR (a AND b)
-    uint32_t a_xor_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t a_and_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    
-    riscv_circuit_add_gate(circuit, a, b, a_xor_b, GATE_XOR);
-    riscv_circuit_add_gate(circuit, a, b, a_and_b, GATE_AND);
-    riscv_circuit_add_gate(circuit, a_xor_b, a_and_b, result, GATE_XOR);
-    
-    return result;
-}
-
-// Helper: Create 2-to-1 MUX for single bit
-static uint32_t build_mux_bit(riscv_circuit_t* circuit, uint32_t sel, uint32_t a, uint32_t b) {
-    // result = sel ? b : a = (sel AND b) OR ((NOT sel) AND a)
-    uint32_t not_sel = build_not(circuit, sel);
-    uint32_t sel_and_b = riscv_circuit_allocate_wire(circuit);
-    uint32_t notsel_and_a = riscv_circuit_allocate_wire(circuit);
-    
-    riscv_circuit_add_gate(circuit, sel, b, sel_and_b, GATE_AND);
-    riscv_circuit_add_gate(circuit, not_sel, a, notsel_and_a, GATE_AND);
-    
-    return build_or(circuit, sel_and_b, notsel_and_a);
-}
-
-// Helper: Create MUX for arrays
-static void build_mux_array(riscv_circuit_t* circuit, uint32_t sel,
-                           uint32_t* a, uint32_t* b, uint32_t* result,
-                           size_t bits) {
-    for (size_t i = 0; i < bits; i++) {
-        result[i] = build_mux_bit(circuit, sel, a[i], b[i]);
-    }
-}
-
 // Simple memory storage (extends base memory structure)
 typedef struct {
     riscv_memory_t base;  // Must be first for casting
     uint32_t** memory_cells;  // Simple array storage
 } riscv_memory_simple_t;
 
+// Every cell wire: stores replace these IDs with their mux outputs
+static size_t simple_memory_roots(riscv_memory_t* memory, uint32_t** roots) {
+    riscv_memory_simple_t* mem = (riscv_memory_simple_t*)memory;
+    size_t n = 0;
+    for (int word = 0; word < SIMPLE_MEM_WORDS; word++) {
+        for (int bit = 0; bit < 32; bit++, n++) {
+            if (roots) roots[n] = &mem->memory_cells[word][bit];
+        }
+    }
+    return n;
+}
+
 // Create simple memory subsystem
 riscv_memory_t* riscv_memory_create_simple(riscv_circuit_t* circuit) {
     riscv_memory_simple_t* mem = calloc(1, sizeof(riscv_memory_simple_t));
@@ -73,6 +42,7 @@ riscv_memory_t* riscv_memory_create_simple(riscv_circuit_t* circuit) {
     
     mem->base.circuit = circuit;
     mem->base.access = riscv_memory_access_simple;  // Set function pointer for simple access
+    mem->base.roots = simple_memory_roots;
     
     // Allocate memory interface wires
     mem->base.address_wires = riscv_circuit_allocate_wire_array(circuit, 32);
@@ -116,18 +86,12 @@ void riscv_memory_access_simple(riscv_memory_t* memory,
             if (expected) {
                 match_bits[bit] = addr_low[bit];
             } else {
-                match_bits[bit] = build_not(circuit, addr_low[bit]);
+                match_bits[bit] = gate_not(circuit, addr_low[bit]);
             }
         }
         
         // AND all match bits together
-        word_select[word] = match_bits[0];
-        for (int bit = 1; bit < SIMPLE_MEM_ADDR_BITS; bit++) {
-            uint32_t new_select = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, word_select[word], match_bits[bit], 
-                                  new_select, GATE_AND);
-            word_select[word] = new_select;
-        }
+        word_select[word] = gate_and_reduce(circuit, match_bits, SIMPLE_MEM_ADDR_BITS);
         
         free(match_bits);
     }
@@ -140,8 +104,8 @@ void riscv_memory_access_simple(riscv_memory_t* memory,
     // MUX in each subsequent word if selected
     for (int word = 1; word < SIMPLE_MEM_WORDS; word++) {
         uint32_t* new_read = riscv_circuit_allocate_wire_array(circuit, 32);
-        build_mux_array(circuit, word_select[word], 
-                       temp_read, mem->memory_cells[word], new_read, 32);
+        gate_mux_word(circuit, word_select[word],
+                      mem->memory_cells[word], temp_read, new_read, 32);
         free(temp_read);
         temp_read = new_read;
     }
@@ -153,14 +117,12 @@ void riscv_memory_access_simple(riscv_memory_t* memory,
     // Write: Update selected word if write_enable is set
     for (int word = 0; word < SIMPLE_MEM_WORDS; word++) {
         // Combine word select with write enable
-        uint32_t do_write = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, word_select[word], write_enable, 
-                              do_write, GATE_AND);
+        uint32_t do_write = gate_and(circuit, word_select[word], write_enable);
         
         // Update memory cell
         uint32_t* new_value = riscv_circuit_allocate_wire_array(circuit, 32);
-        build_mux_array(circuit, do_write,
-                       mem->memory_cells[word], write_data_bits, new_value, 32);
+        gate_mux_word(circuit, do_write,
+                      write_data_bits, mem->memory_cells[word], new_value, 32);
         
         // Replace old value
         free(mem->memory_cells[word]);
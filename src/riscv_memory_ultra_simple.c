@@ -4,6 +4,7 @@
 
 
 #include "riscv_memory.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -21,63 +22,30 @@ typedef struct {
     uint32_t** memory_cells;
 } riscv_memory_ultra_simple_t;
 
-// Helper: Create NOT gate
-static uint32_t build_not(riscv_circuit_t* circuit, uint32_t a) {
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, a, CONSTANT_1_WIRE, result, GATE_XOR);
-    return result;
-}
-
-// Helper: Build 8-to-1 MUX for single bit (optimized)
+// Helper: Build 8-to-1 MUX for single bit (3 levels of 2-to-1 muxes)
 static uint32_t build_mux8_bit(riscv_circuit_t* circuit, 
                                 uint32_t* sel,  // 3 select bits
                                 uint32_t* inputs) { // 8 input bits
-    // Level 1: 4 2-to-1 muxes
-    uint32_t level1[4];
-    for (int i = 0; i < 4; i++) {
-        uint32_t sel_bit = sel[0];
-        uint32_t not_sel = build_not(circuit, sel_bit);
-        
-        uint32_t and0 = riscv_circuit_allocate_wire(circuit);
-        uint32_t and1 = riscv_circuit_allocate_wire(circuit);
-        
-        riscv_circuit_add_gate(circuit, not_sel, inputs[i*2], and0, GATE_AND);
-        riscv_circuit_add_gate(circuit, sel_bit, inputs[i*2+1], and1, GATE_AND);
-        
-        level1[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, and0, and1, level1[i], GATE_XOR);
+    uint32_t level[8];
+    memcpy(level, inputs, sizeof(level));
+    for (int stage = 0, n = 8; n > 1; stage++, n /= 2) {
+        for (int i = 0; i < n / 2; i++) {
+            level[i] = gate_mux(circuit, sel[stage], level[2 * i + 1], level[2 * i]);
+        }
     }
-    
-    // Level 2: 2 2-to-1 muxes
-    uint32_t level2[2];
-    for (int i = 0; i < 2; i++) {
-        uint32_t sel_bit = sel[1];
-        uint32_t not_sel = build_not(circuit, sel_bit);
-        
-        uint32_t and0 = riscv_circuit_allocate_wire(circuit);
-        uint32_t and1 = riscv_circuit_allocate_wire(circuit);
-        
-        riscv_circuit_add_gate(circuit, not_sel, level1[i*2], and0, GATE_AND);
-        riscv_circuit_add_gate(circuit, sel_bit, level1[i*2+1], and1, GATE_AND);
-        
-        level2[i] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, and0, and1, level2[i], GATE_XOR);
+    return level[0];
+}
+
+// Every cell wire: stores replace these IDs with their mux outputs
+static size_t ultra_simple_memory_roots(riscv_memory_t* memory, uint32_t** roots) {
+    riscv_memory_ultra_simple_t* mem = (riscv_memory_ultra_simple_t*)memory;
+    size_t n = 0;
+    for (int word = 0; word < ULTRA_SIMPLE_MEM_WORDS; word++) {
+        for (int bit = 0; bit < 32; bit++, n++) {
+            if (roots) roots[n] = &mem->memory_cells[word][bit];
+        }
     }
-    
-    // Level 3: Final 2-to-1 mux
-    uint32_t sel_bit = sel[2];
-    uint32_t not_sel = build_not(circuit, sel_bit);
-    
-    uint32_t and0 = riscv_circuit_allocate_wire(circuit);
-    uint32_t and1 = riscv_circuit_allocate_wire(circuit);
-    
-    riscv_circuit_add_gate(circuit, not_sel, level2[0], and0, GATE_AND);
-    riscv_circuit_add_gate(circuit, sel_bit, level2[1], and1, GATE_AND);
-    
-    uint32_t result = riscv_circuit_allocate_wire(circuit);
-    riscv_circuit_add_gate(circuit, and0, and1, result, GATE_XOR);
-    
-    return result;
+    return n;
 }
 
 // Create ultra-simple memory
@@ -87,6 +55,7 @@ riscv_memory_t* riscv_memory_create_ultra_simple(riscv_circuit_t* circuit) {
     
     mem->base.circuit = circuit;
     mem->base.access = riscv_memory_access_ultra_simple;
+    mem->base.roots = ultra_simple_memory_roots;
     
     // Allocate interface wires
     mem->base.address_wires = riscv_circuit_allocate_wire_array(circuit, 32);
@@ -135,34 +104,20 @@ void riscv_memory_access_ultra_simple(riscv_memory_t* memory,
         uint32_t decode = CONSTANT_1_WIRE;
         for (int bit = 0; bit < 3; bit++) {
             uint32_t addr_bit = ((word >> bit) & 1) ? 
-                               addr_select[bit] : build_not(circuit, addr_select[bit]);
-            uint32_t new_decode = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, decode, addr_bit, new_decode, GATE_AND);
-            decode = new_decode;
+                               addr_select[bit] : gate_not(circuit, addr_select[bit]);
+            decode = gate_and(circuit, decode, addr_bit);
         }
         
         // Combine with write enable
-        decoder[word] = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, decode, write_enable, decoder[word], GATE_AND);
+        decoder[word] = gate_and(circuit, decode, write_enable);
     }
     
     // Update each memory word conditionally
     for (int word = 0; word < 8; word++) {
         uint32_t* new_value = riscv_circuit_allocate_wire_array(circuit, 32);
-        for (int bit = 0; bit < 32; bit++) {
-            // MUX between old value and write data
-            uint32_t not_sel = build_not(circuit, decoder[word]);
-            uint32_t keep_old = riscv_circuit_allocate_wire(circuit);
-            uint32_t take_new = riscv_circuit_allocate_wire(circuit);
-            
-            riscv_circuit_add_gate(circuit, not_sel, mem->memory_cells[word][bit], 
-                                  keep_old, GATE_AND);
-            riscv_circuit_add_gate(circuit, decoder[word], write_data_bits[bit], 
-                                  take_new, GATE_AND);
-            
-            new_value[bit] = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, keep_old, take_new, new_value[bit], GATE_XOR);
-        }
+        // MUX between old value and write data
+        gate_mux_word(circuit, decoder[word],
+                      write_data_bits, mem->memory_cells[word], new_value, 32);
         
         free(mem->memory_cells[word]);
         mem->memory_cells[word] = new_value;
@@ -4,6 +4,7 @@
 
 
 #include "riscv_compiler.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -26,159 +27,178 @@
 #define FUNCT3_MULHU  0x3
 #define FUNCT7_MUL    0x01
 
-// Helper: Sign extend a value to full width
-static void sign_extend_to_64_bits(riscv_circuit_t* circuit, uint32_t* value_32, uint32_t* value_64) {
-    // Copy lower 32 bits
-    for (int i = 0; i < 32; i++) {
-        value_64[i] = value_32[i];
+// Partial-product array multiplier: (a * b) mod 2^out_bits
+//
+// Every a_i & b_j lands in column i + j and the whole array is reduced by
+// one Dadda compressor tree, so only columns below out_bits are ever built.
+// Signed operands use the Baugh-Wooley identity: a product term that
+// carries exactly one sign bit has negative weight, and
+// -x * 2^k = (~x) * 2^k - 2^k, so the term is inverted and the -2^k terms
+// are folded into a single compile-time constant row.
+void build_integer_product(riscv_circuit_t* circuit,
+                           const uint32_t* a_bits, const uint32_t* b_bits, size_t bits,
+                           bool a_signed, bool b_signed,
+                           size_t out_bits, uint32_t* product) {
+    uint64_t mask = out_bits >= 64 ? ~0ULL : ((1ULL << out_bits) - 1);
+    uint64_t correction = 0;
+
+    // A compile-time constant operand turns the array into a few shifted
+    // copies of the other operand (see constant_multiplier.c)
+    uint64_t a_const, b_const;
+    bool a_known = wires_to_constant(a_bits, bits, &a_const);
+    bool b_known = wires_to_constant(b_bits, bits, &b_const);
+    if (a_known || b_known) {
+        if (a_known && !b_known) {
+            const uint32_t* t = a_bits; a_bits = b_bits; b_bits = t;
+            bool s = a_signed; a_signed = b_signed; b_signed = s;
+            b_const = a_const;
+        }
+        if (b_signed && bits < 64 && ((b_const >> (bits - 1)) & 1)) {
+            b_const |= ~0ULL << bits;
+        }
+        if (a_known && b_known) {
+            if (a_signed && bits < 64 && ((a_const >> (bits - 1)) & 1)) {
+                a_const |= ~0ULL << bits;
+            }
+            uint64_t value = (a_const * b_const) & mask;
+            for (size_t k = 0; k < out_bits; k++) {
+                product[k] = (k < 64 && ((value >> k) & 1)) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+            }
+            return;
+        }
+
+        uint32_t* x = malloc(out_bits * sizeof(uint32_t));
+        for (size_t k = 0; k < out_bits; k++) {
+            if (k < bits) x[k] = a_bits[k];
+            else x[k] = a_signed ? a_bits[bits - 1] : CONSTANT_0_WIRE;
+        }
+        build_constant_multiplier(circuit, x, out_bits, b_const & mask, product);
+        free(x);
+        return;
     }
-    
-    // Sign extend upper 32 bits
-    uint32_t sign_bit = value_32[31];
-    for (int i = 32; i < 64; i++) {
-        value_64[i] = sign_bit;
+
+    // One row per multiplier bit plus the constant row
+    uint32_t** rows = malloc((bits + 1) * sizeof(uint32_t*));
+    for (size_t j = 0; j <= bits; j++) {
+        rows[j] = malloc(out_bits * sizeof(uint32_t));
+        for (size_t k = 0; k < out_bits; k++) {
+            rows[j][k] = CONSTANT_0_WIRE;
+        }
     }
-}
 
-// Helper: Zero extend a value to full width
-static void zero_extend_to_64_bits(riscv_circuit_t* circuit, uint32_t* value_32, uint32_t* value_64) {
-    // Copy lower 32 bits
-    for (int i = 0; i < 32; i++) {
-        value_64[i] = value_32[i];
+    for (size_t j = 0; j < bits; j++) {
+        for (size_t i = 0; i < bits && i + j < out_bits; i++) {
+            uint32_t term = gate_and(circuit, a_bits[i], b_bits[j]);
+
+            bool a_sign = a_signed && i == bits - 1;
+            bool b_sign = b_signed && j == bits - 1;
+            if (a_sign != b_sign) {
+                term = gate_not(circuit, term);
+                correction -= 1ULL << (i + j);
+            }
+            rows[j][i + j] = term;
+        }
     }
-    
-    // Zero fill upper 32 bits
-    for (int i = 32; i < 64; i++) {
-        value_64[i] = CONSTANT_0_WIRE;
+
+    correction &= mask;
+    for (size_t k = 0; k < out_bits && k < 64; k++) {
+        if ((correction >> k) & 1) rows[bits][k] = CONSTANT_1_WIRE;
+    }
+
+    build_multi_operand_adder(circuit, rows, bits + 1, out_bits, product,
+                              final_adder_for_objective(circuit));
+
+    for (size_t j = 0; j <= bits; j++) {
+        free(rows[j]);
+    }
+    free(rows);
+}
+
+static void write_rd(riscv_compiler_t* compiler, uint32_t rd, const uint32_t* wires) {
+    if (rd != 0) {
+        memcpy(compiler->reg_wires[rd], wires, 32 * sizeof(uint32_t));
     }
 }
 
 // Compile MUL instruction: rd = (rs1 * rs2)[31:0]
+// Only the low 32 columns of the array are built; signedness is irrelevant
 static int compile_mul(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
     if (rd == 0) return 0;  // x0 is hardwired to 0
     
-    // Get operand wires
-    uint32_t* rs1_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rs2_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rd_wires = malloc(32 * sizeof(uint32_t));
-    
-    for (int i = 0; i < 32; i++) {
-        rs1_wires[i] = get_register_wire(rs1, i);
-        rs2_wires[i] = get_register_wire(rs2, i);
-        rd_wires[i] = riscv_circuit_allocate_wire(compiler->circuit);
-    }
-    
-    // Perform 32x32 multiplication to get 64-bit result
-    uint32_t* full_result = build_multiplier(compiler->circuit, rs1_wires, rs2_wires, 32);
-    
-    // Take lower 32 bits as result
-    for (int i = 0; i < 32; i++) {
-        // Connect result to output register wires
-        // In a full implementation, this would update the register file
-        // For now, we just generate the multiplication circuit
-        rd_wires[i] = full_result[i];
-    }
-    
-    free(rs1_wires);
-    free(rs2_wires);
-    free(rd_wires);
-    // Note: full_result is allocated by build_multiplier, caller manages it
-    
+    uint32_t low[32];
+    build_integer_product(compiler->circuit, compiler->reg_wires[rs1], compiler->reg_wires[rs2],
+                          32, false, false, 32, low);
+    write_rd(compiler, rd, low);
     return 0;
 }
 
-// Compile MULH instruction: rd = (rs1 * rs2)[63:32] (signed x signed)
-static int compile_mulh(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
+// Compile MULH/MULHSU/MULHU: rd = (rs1 * rs2)[63:32]
+static int compile_mul_high(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2,
+                            bool rs1_signed, bool rs2_signed) {
     if (rd == 0) return 0;  // x0 is hardwired to 0
     
-    // Get operand wires
-    uint32_t* rs1_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rs2_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rd_wires = malloc(32 * sizeof(uint32_t));
-    
-    for (int i = 0; i < 32; i++) {
-        rs1_wires[i] = get_register_wire(rs1, i);
-        rs2_wires[i] = get_register_wire(rs2, i);
-        rd_wires[i] = riscv_circuit_allocate_wire(compiler->circuit);
-    }
-    
-    // For signed multiplication, we need to handle sign extension
-    // This is complex in hardware - for now, use basic unsigned multiply
-    // and handle signs separately (full implementation would use Booth's algorithm)
-    
-    uint32_t* full_result = build_multiplier(compiler->circuit, rs1_wires, rs2_wires, 32);
-    
-    // Take upper 32 bits as result
-    for (int i = 0; i < 32; i++) {
-        rd_wires[i] = full_result[32 + i];
-    }
-    
-    free(rs1_wires);
-    free(rs2_wires);
-    free(rd_wires);
-    
+    uint32_t full[64];
+    build_integer_product(compiler->circuit, compiler->reg_wires[rs1], compiler->reg_wires[rs2],
+                          32, rs1_signed, rs2_signed, 64, full);
+    write_rd(compiler, rd, full + 32);
     return 0;
 }
 
-// Compile MULHU instruction: rd = (rs1 * rs2)[63:32] (unsigned x unsigned)
+// Compile MULH instruction: signed x signed
+static int compile_mulh(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return compile_mul_high(compiler, rd, rs1, rs2, true, true);
+}
+
+// Compile MULHU instruction: unsigned x unsigned
 static int compile_mulhu(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    if (rd == 0) return 0;  // x0 is hardwired to 0
-    
-    // Get operand wires
-    uint32_t* rs1_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rs2_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rd_wires = malloc(32 * sizeof(uint32_t));
-    
-    for (int i = 0; i < 32; i++) {
-        rs1_wires[i] = get_register_wire(rs1, i);
-        rs2_wires[i] = get_register_wire(rs2, i);
-        rd_wires[i] = riscv_circuit_allocate_wire(compiler->circuit);
-    }
-    
-    // Unsigned multiplication - straightforward
-    uint32_t* full_result = build_multiplier(compiler->circuit, rs1_wires, rs2_wires, 32);
-    
-    // Take upper 32 bits as result
-    for (int i = 0; i < 32; i++) {
-        rd_wires[i] = full_result[32 + i];
-    }
-    
-    free(rs1_wires);
-    free(rs2_wires);
-    free(rd_wires);
-    
-    return 0;
+    return compile_mul_high(compiler, rd, rs1, rs2, false, false);
 }
 
-// Compile MULHSU instruction: rd = (rs1 * rs2)[63:32] (signed x unsigned)
+// Compile MULHSU instruction: signed rs1 x unsigned rs2
 static int compile_mulhsu(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    if (rd == 0) return 0;  // x0 is hardwired to 0
-    
-    // Get operand wires
-    uint32_t* rs1_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rs2_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rd_wires = malloc(32 * sizeof(uint32_t));
-    
-    for (int i = 0; i < 32; i++) {
-        rs1_wires[i] = get_register_wire(rs1, i);
-        rs2_wires[i] = get_register_wire(rs2, i);
-        rd_wires[i] = riscv_circuit_allocate_wire(compiler->circuit);
-    }
-    
-    // Mixed signed/unsigned multiplication
-    // For full correctness, this needs special handling of the sign
-    // For now, use basic multiplication
-    uint32_t* full_result = build_multiplier(compiler->circuit, rs1_wires, rs2_wires, 32);
-    
-    // Take upper 32 bits as result
-    for (int i = 0; i < 32; i++) {
-        rd_wires[i] = full_result[32 + i];
+    return compile_mul_high(compiler, rd, rs1, rs2, true, false);
+}
+
+static bool is_mul_instruction(uint32_t instruction) {
+    return GET_OPCODE(instruction) == 0x33 && GET_FUNCT7(instruction) == FUNCT7_MUL &&
+           GET_FUNCT3(instruction) <= FUNCT3_MULHU;
+}
+
+// Two adjacent multiplies of the same operands, one MUL and one of
+// MULH/MULHSU/MULHU, in either order (the usual 32x32->64 idiom). The
+// first must not overwrite a source, or the second would see new values.
+bool match_mul_pair(uint32_t first, uint32_t second) {
+    if (!is_mul_instruction(first) || !is_mul_instruction(second)) return false;
+    if (GET_RS1(first) != GET_RS1(second) || GET_RS2(first) != GET_RS2(second)) return false;
+
+    bool first_low = GET_FUNCT3(first) == FUNCT3_MUL;
+    bool second_low = GET_FUNCT3(second) == FUNCT3_MUL;
+    if (first_low == second_low) return false;
+
+    uint32_t rd = GET_RD(first);
+    return rd == 0 || (rd != GET_RS1(first) && rd != GET_RS2(first));
+}
+
+// Build one 64-bit product and take both halves from it
+int compile_mul_pair(riscv_compiler_t* compiler, uint32_t first, uint32_t second) {
+    if (!match_mul_pair(first, second)) return -1;
+
+    uint32_t high = GET_FUNCT3(first) == FUNCT3_MUL ? second : first;
+    uint32_t funct3 = GET_FUNCT3(high);
+    bool rs1_signed = funct3 == FUNCT3_MULH || funct3 == FUNCT3_MULHSU;
+    bool rs2_signed = funct3 == FUNCT3_MULH;
+
+    uint32_t full[64];
+    build_integer_product(compiler->circuit,
+                          compiler->reg_wires[GET_RS1(first)], compiler->reg_wires[GET_RS2(first)],
+                          32, rs1_signed, rs2_signed, 64, full);
+
+    // Program order, so a shared rd ends up holding the second result
+    uint32_t order[2] = {first, second};
+    for (int n = 0; n < 2; n++) {
+        uint32_t* half = GET_FUNCT3(order[n]) == FUNCT3_MUL ? full : full + 32;
+        write_rd(compiler, GET_RD(order[n]), half);
     }
-    
-    free(rs1_wires);
-    free(rs2_wires);
-    free(rd_wires);
-    
     return 0;
 }
 
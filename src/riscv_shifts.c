@@ -4,247 +4,112 @@
 
 
 #include "riscv_compiler.h"
+#include "gate_primitives.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-// Helper: Build a barrel shifter for left shift
-static void build_left_shift(riscv_circuit_t* circuit,
-                            uint32_t* value_bits,
-                            uint32_t* shift_amount_bits,
-                            uint32_t* result_bits,
-                            size_t num_bits) {
-    // Barrel shifter: cascade of multiplexers
-    // For each bit position in shift amount, shift by 2^i positions
-    
+// Barrel shifter: one row of 2:1 muxes per shift-amount bit, shifting by
+// 1, 2, 4, 8, 16. Vacated bits take zero or, for SRA, the sign bit. With a
+// constant shift amount every mux folds away and the shift is pure wiring.
+// Under OPTIMIZE_DEPTH the rows use two-level muxes: twice the ANDs, but
+// two layers per row instead of three.
+static void build_barrel_shift(riscv_circuit_t* circuit,
+                               const uint32_t* value_bits,
+                               const uint32_t* shift_amount_bits,
+                               uint32_t* result_bits,
+                               size_t num_bits,
+                               bool is_left,
+                               bool is_arithmetic) {
     uint32_t* current = malloc(num_bits * sizeof(uint32_t));
+    uint32_t* next = malloc(num_bits * sizeof(uint32_t));
     memcpy(current, value_bits, num_bits * sizeof(uint32_t));
     
+    uint32_t fill = is_arithmetic ? value_bits[num_bits - 1] : CONSTANT_0_WIRE;
+    bool shallow = circuit->objective == OPTIMIZE_DEPTH;
+    
     // Process each shift amount bit (only need 5 bits for 32-bit shifts)
     for (int shift_bit = 0; shift_bit < 5; shift_bit++) {
-        uint32_t* shifted = riscv_circuit_allocate_wire_array(circuit, num_bits);
-        int shift_by = 1 << shift_bit;  // 1, 2, 4, 8, 16
+        size_t shift_by = (size_t)1 << shift_bit;
+        uint32_t sel = shift_amount_bits[shift_bit];
+        // ~sel is shared by the whole row and only built once something uses it
+        uint32_t not_sel = CONSTANT_0_WIRE;
+        bool have_not_sel = false;
         
-        // Create shifted version
-        for (int i = 0; i < num_bits; i++) {
-            if (i < shift_by) {
-                shifted[i] = 1;  // Fill with zeros
+        for (size_t i = 0; i < num_bits; i++) {
+            uint32_t shifted;
+            if (is_left) {
+                shifted = i >= shift_by ? current[i - shift_by] : CONSTANT_0_WIRE;
             } else {
-                shifted[i] = current[i - shift_by];
+                shifted = i + shift_by < num_bits ? current[i + shift_by] : fill;
+            }
+            if (shifted == current[i]) {
+                next[i] = shifted;
+                continue;
             }
-        }
-        
-        // MUX between current and shifted based on shift_amount_bits[shift_bit]
-        uint32_t* next = riscv_circuit_allocate_wire_array(circuit, num_bits);
-        for (int i = 0; i < num_bits; i++) {
-            // result = shift_bit ? shifted : current
-            uint32_t not_shift = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, shift_amount_bits[shift_bit], 2, not_shift, GATE_XOR);
-            
-            uint32_t keep_current = riscv_circuit_allocate_wire(circuit);
-            uint32_t take_shifted = riscv_circuit_allocate_wire(circuit);
-            
-            riscv_circuit_add_gate(circuit, not_shift, current[i], keep_current, GATE_AND);
-            riscv_circuit_add_gate(circuit, shift_amount_bits[shift_bit], shifted[i], take_shifted, GATE_AND);
-            
-            // OR
-            uint32_t xor_result = riscv_circuit_allocate_wire(circuit);
-            uint32_t and_result = riscv_circuit_allocate_wire(circuit);
             
-            riscv_circuit_add_gate(circuit, keep_current, take_shifted, xor_result, GATE_XOR);
-            riscv_circuit_add_gate(circuit, keep_current, take_shifted, and_result, GATE_AND);
-            riscv_circuit_add_gate(circuit, xor_result, and_result, next[i], GATE_XOR);
-        }
-        
-        free(current);
-        free(shifted);
-        current = next;
-    }
-    
-    memcpy(result_bits, current, num_bits * sizeof(uint32_t));
-    free(current);
-}
-
-// Helper: Build a barrel shifter for right shift (logical)
-static void build_right_shift_logical(riscv_circuit_t* circuit,
-                                     uint32_t* value_bits,
-                                     uint32_t* shift_amount_bits,
-                                     uint32_t* result_bits,
-                                     size_t num_bits) {
-    uint32_t* current = malloc(num_bits * sizeof(uint32_t));
-    memcpy(current, value_bits, num_bits * sizeof(uint32_t));
-    
-    // Similar to left shift but in opposite direction
-    for (int shift_bit = 0; shift_bit < 5; shift_bit++) {
-        uint32_t* shifted = riscv_circuit_allocate_wire_array(circuit, num_bits);
-        int shift_by = 1 << shift_bit;
-        
-        // Create shifted version
-        for (int i = 0; i < num_bits; i++) {
-            if (i + shift_by < num_bits) {
-                shifted[i] = current[i + shift_by];
+            // result = shift_bit ? shifted : current. A shifted-in zero makes
+            // the mux ~sel & current, one gate with the shared ~sel.
+            if ((shallow || shifted == CONSTANT_0_WIRE) && !have_not_sel) {
+                not_sel = gate_not(circuit, sel);
+                have_not_sel = true;
+            }
+            if (shifted == CONSTANT_0_WIRE) {
+                next[i] = gate_and(circuit, not_sel, current[i]);
+            } else if (shallow) {
+                next[i] = gate_mux_shallow(circuit, sel, not_sel, shifted, current[i]);
             } else {
-                shifted[i] = 1;  // Fill with zeros
+                next[i] = gate_mux(circuit, sel, shifted, current[i]);
             }
         }
         
-        // MUX logic (same as left shift)
-        uint32_t* next = riscv_circuit_allocate_wire_array(circuit, num_bits);
-        for (int i = 0; i < num_bits; i++) {
-            uint32_t not_shift = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, shift_amount_bits[shift_bit], 2, not_shift, GATE_XOR);
-            
-            uint32_t keep_current = riscv_circuit_allocate_wire(circuit);
-            uint32_t take_shifted = riscv_circuit_allocate_wire(circuit);
-            
-            riscv_circuit_add_gate(circuit, not_shift, current[i], keep_current, GATE_AND);
-            riscv_circuit_add_gate(circuit, shift_amount_bits[shift_bit], shifted[i], take_shifted, GATE_AND);
-            
-            uint32_t xor_result = riscv_circuit_allocate_wire(circuit);
-            uint32_t and_result = riscv_circuit_allocate_wire(circuit);
-            
-            riscv_circuit_add_gate(circuit, keep_current, take_shifted, xor_result, GATE_XOR);
-            riscv_circuit_add_gate(circuit, keep_current, take_shifted, and_result, GATE_AND);
-            riscv_circuit_add_gate(circuit, xor_result, and_result, next[i], GATE_XOR);
-        }
-        
-        free(current);
-        free(shifted);
+        uint32_t* swap = current;
         current = next;
+        next = swap;
     }
     
     memcpy(result_bits, current, num_bits * sizeof(uint32_t));
     free(current);
+    free(next);
 }
 
-// Helper: Build a barrel shifter for right shift (arithmetic)
-static void build_right_shift_arithmetic(riscv_circuit_t* circuit,
-                                        uint32_t* value_bits,
-                                        uint32_t* shift_amount_bits,
-                                        uint32_t* result_bits,
-                                        size_t num_bits) {
-    uint32_t* current = malloc(num_bits * sizeof(uint32_t));
-    memcpy(current, value_bits, num_bits * sizeof(uint32_t));
-    
-    uint32_t sign_bit = value_bits[num_bits - 1];  // MSB for sign extension
-    
-    // Similar to logical right shift but fill with sign bit
-    for (int shift_bit = 0; shift_bit < 5; shift_bit++) {
-        uint32_t* shifted = riscv_circuit_allocate_wire_array(circuit, num_bits);
-        int shift_by = 1 << shift_bit;
-        
-        // Create shifted version
-        for (int i = 0; i < num_bits; i++) {
-            if (i + shift_by < num_bits) {
-                shifted[i] = current[i + shift_by];
-            } else {
-                shifted[i] = sign_bit;  // Fill with sign bit
-            }
-        }
-        
-        // MUX logic (same as other shifts)
-        uint32_t* next = riscv_circuit_allocate_wire_array(circuit, num_bits);
-        for (int i = 0; i < num_bits; i++) {
-            uint32_t not_shift = riscv_circuit_allocate_wire(circuit);
-            riscv_circuit_add_gate(circuit, shift_amount_bits[shift_bit], 2, not_shift, GATE_XOR);
-            
-            uint32_t keep_current = riscv_circuit_allocate_wire(circuit);
-            uint32_t take_shifted = riscv_circuit_allocate_wire(circuit);
-            
-            riscv_circuit_add_gate(circuit, not_shift, current[i], keep_current, GATE_AND);
-            riscv_circuit_add_gate(circuit, shift_amount_bits[shift_bit], shifted[i], take_shifted, GATE_AND);
-            
-            uint32_t xor_result = riscv_circuit_allocate_wire(circuit);
-            uint32_t and_result = riscv_circuit_allocate_wire(circuit);
-            
-            riscv_circuit_add_gate(circuit, keep_current, take_shifted, xor_result, GATE_XOR);
-            riscv_circuit_add_gate(circuit, keep_current, take_shifted, and_result, GATE_AND);
-            riscv_circuit_add_gate(circuit, xor_result, and_result, next[i], GATE_XOR);
-        }
-        
-        free(current);
-        free(shifted);
-        current = next;
-    }
-    
-    memcpy(result_bits, current, num_bits * sizeof(uint32_t));
-    free(current);
+// Shift rs1 by a 5-bit amount and write rd (x0 writes are dropped)
+static void compile_shift(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                          const uint32_t* shift_amount, bool is_left, bool is_arithmetic) {
+    if (rd == 0) return;
+    
+    uint32_t result[32];
+    build_barrel_shift(compiler->circuit, compiler->reg_wires[rs1], shift_amount, result, 32,
+                       is_left, is_arithmetic);
+    memcpy(compiler->reg_wires[rd], result, 32 * sizeof(uint32_t));
 }
 
-// Compile SLL instruction: rd = rs1 << rs2[4:0]
+// Compile SLL / SRL / SRA: rd = rs1 shifted by rs2[4:0]
 void compile_sll(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    riscv_circuit_t* circuit = compiler->circuit;
-    
-    // Extract lower 5 bits of rs2 for shift amount
-    uint32_t shift_amount[5];
-    for (int i = 0; i < 5; i++) {
-        shift_amount[i] = compiler->reg_wires[rs2][i];
-    }
-    
-    // Perform left shift
-    if (rd != 0) {
-        uint32_t* result = riscv_circuit_allocate_wire_array(circuit, 32);
-        build_left_shift(circuit, compiler->reg_wires[rs1], shift_amount, result, 32);
-        memcpy(compiler->reg_wires[rd], result, 32 * sizeof(uint32_t));
-        free(result);
-    }
+    compile_shift(compiler, rd, rs1, compiler->reg_wires[rs2], true, false);
 }
 
-// Compile SRL instruction: rd = rs1 >> rs2[4:0] (logical)
 void compile_srl(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    riscv_circuit_t* circuit = compiler->circuit;
-    
-    // Extract lower 5 bits of rs2 for shift amount
-    uint32_t shift_amount[5];
-    for (int i = 0; i < 5; i++) {
-        shift_amount[i] = compiler->reg_wires[rs2][i];
-    }
-    
-    // Perform logical right shift
-    if (rd != 0) {
-        uint32_t* result = riscv_circuit_allocate_wire_array(circuit, 32);
-        build_right_shift_logical(circuit, compiler->reg_wires[rs1], shift_amount, result, 32);
-        memcpy(compiler->reg_wires[rd], result, 32 * sizeof(uint32_t));
-        free(result);
-    }
+    compile_shift(compiler, rd, rs1, compiler->reg_wires[rs2], false, false);
 }
 
-// Compile SRA instruction: rd = rs1 >> rs2[4:0] (arithmetic)
 void compile_sra(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t rs2) {
-    riscv_circuit_t* circuit = compiler->circuit;
-    
-    // Extract lower 5 bits of rs2 for shift amount
+    compile_shift(compiler, rd, rs1, compiler->reg_wires[rs2], false, true);
+}
+
+// Compile SLLI / SRLI / SRAI: the shift amount is constant wiring, so these
+// cost no gates at all
+static void compile_shift_imm(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1,
+                              uint32_t shamt, bool is_left, bool is_arithmetic) {
     uint32_t shift_amount[5];
     for (int i = 0; i < 5; i++) {
-        shift_amount[i] = compiler->reg_wires[rs2][i];
-    }
-    
-    // Perform arithmetic right shift
-    if (rd != 0) {
-        uint32_t* result = riscv_circuit_allocate_wire_array(circuit, 32);
-        build_right_shift_arithmetic(circuit, compiler->reg_wires[rs1], shift_amount, result, 32);
-        memcpy(compiler->reg_wires[rd], result, 32 * sizeof(uint32_t));
-        free(result);
+        shift_amount[i] = (shamt & (1 << i)) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
     }
+    compile_shift(compiler, rd, rs1, shift_amount, is_left, is_arithmetic);
 }
 
-// Compile SLLI instruction: rd = rs1 << shamt
 void compile_slli(riscv_compiler_t* compiler, uint32_t rd, uint32_t rs1, uint32_t shamt) {
-    riscv_circuit_t* circuit = compiler->circuit;
-    
-    // Create constant shift amount
-    uint32_t shift_amount[5];
-    for (int i = 0; i < 5; i++) {
-        shift_amount[i] = (shamt & (1 << i)) ? 2 : 1;  // Constant wires
-    }
-    
-    // Perform left shift
-    if (rd != 0) {
-        uint32_t* result = riscv_circuit_allocate_wire_array(circuit, 32);
-        build_left_shift(circuit, compiler->reg_wires[rs1], shift_amount, result, 32);
-        memcpy(compiler->reg_wires[rd], result, 32 * sizeof(uint32_t));
-        free(result);
-    }
+    compile_shift_imm(compiler, rd, rs1, shamt, true, false);
 }
 
 // Add shift instruction support to main compiler
@@ -258,8 +123,14 @@ int compile_shift_instruction(riscv_compiler_t* compiler, uint32_t instruction)
         uint32_t rs2 = (instruction >> 20) & 0x1F;
         uint32_t funct7 = (instruction >> 25) & 0x7F;
         
+        // Other funct7 values are M-extension or bit-manipulation encodings
+        if (funct7 != 0x00 && funct7 != 0x20) {
+            return -1;
+        }
+        
         switch (funct3) {
             case 0x1:  // SLL
+                if (funct7 != 0x00) return -1;
                 compile_sll(compiler, rd, rs1, rs2);
                 break;
             case 0x5:  // SRL/SRA
@@ -276,16 +147,17 @@ int compile_shift_instruction(riscv_compiler_t* compiler, uint32_t instruction)
         uint32_t shamt = (instruction >> 20) & 0x1F;
         uint32_t funct7 = (instruction >> 25) & 0x7F;
         
+        if (funct7 != 0x00 && funct7 != 0x20) {
+            return -1;
+        }
+        
         switch (funct3) {
             case 0x1:  // SLLI
+                if (funct7 != 0x00) return -1;
                 compile_slli(compiler, rd, rs1, shamt);
                 break;
             case 0x5:  // SRLI/SRAI
-                if (funct7 == 0x00) {
-                    // SRLI - similar to SLLI but right shift
-                } else if (funct7 == 0x20) {
-                    // SRAI - similar to SLLI but arithmetic right shift
-                }
+                compile_shift_imm(compiler, rd, rs1, shamt, false, funct7 == 0x20);
                 break;
             default:
                 return -1;
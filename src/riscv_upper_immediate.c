@@ -44,21 +44,10 @@ static void create_upper_immediate_value(riscv_circuit_t* circuit,
 static int compile_lui(riscv_compiler_t* compiler, uint32_t rd, uint32_t immediate) {
     if (rd == 0) return 0;  // x0 is hardwired to 0, no operation needed
     
-    // Get destination register wires
-    uint32_t* rd_wires = malloc(32 * sizeof(uint32_t));
-    
-    for (int i = 0; i < 32; i++) {
-        rd_wires[i] = riscv_circuit_allocate_wire(compiler->circuit);
-    }
-    
-    // Create the upper immediate value
-    create_upper_immediate_value(compiler->circuit, immediate, rd_wires);
-    
-    // In a full implementation, this would update the register file
-    // For circuit generation, we just compute the immediate value
+    // The value is known at compile time, so rd is pure wiring (0 gates)
     // The result is already correctly positioned (upper 20 bits, lower 12 zero)
+    create_upper_immediate_value(compiler->circuit, immediate, compiler->reg_wires[rd]);
     
-    free(rd_wires);
     return 0;
 }
 
@@ -69,27 +58,16 @@ static int compile_auipc(riscv_compiler_t* compiler, uint32_t rd, uint32_t immed
     if (rd == 0) return 0;  // x0 is hardwired to 0, no operation needed
     
     // Get wires
-    uint32_t* pc_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* imm_wires = malloc(32 * sizeof(uint32_t));
-    uint32_t* rd_wires = malloc(32 * sizeof(uint32_t));
-    
-    for (int i = 0; i < 32; i++) {
-        pc_wires[i] = get_pc_wire(i);
-        rd_wires[i] = riscv_circuit_allocate_wire(compiler->circuit);
-    }
+    uint32_t imm_wires[32];
+    uint32_t rd_wires[32];
     
     // Create upper immediate value
     create_upper_immediate_value(compiler->circuit, immediate, imm_wires);
     
     // Add PC + immediate using gate-optimized ripple-carry adder
-    build_ripple_carry_adder(compiler->circuit, pc_wires, imm_wires, rd_wires, 32);
-    
-    // In a full implementation, this would update the register file
-    // For circuit generation, we compute rd = PC + (imm << 12)
+    build_ripple_carry_adder(compiler->circuit, compiler->pc_wires, imm_wires, rd_wires, 32);
     
-    free(pc_wires);
-    free(imm_wires);
-    free(rd_wires);
+    memcpy(compiler->reg_wires[rd], rd_wires, sizeof(rd_wires));
     
     return 0;
 }
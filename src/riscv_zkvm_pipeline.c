@@ -12,6 +12,7 @@
 #include "riscv_compiler.h"
 #include "riscv_memory.h"
 #include "riscv_elf_loader.h"
+#include "circuit_passes.h"
 
 // Configuration
 #define MAX_CYCLES 10000      // Maximum execution cycles
@@ -50,6 +51,10 @@ typedef struct {
     
     pipeline_stage_t current_stage;
     bool verbose;
+    
+    // Circuit passes after compilation
+    int opt_level;
+    const char* pass_report_filename;
 } zkvm_pipeline_t;
 
 // Initialize pipeline
@@ -61,6 +66,7 @@ zkvm_pipeline_t* zkvm_pipeline_create(const char* elf_file, bool verbose) {
     pipeline->circuit_filename = "/tmp/zkvm_circuit.txt";
     pipeline->proof_filename = "/tmp/zkvm_proof.bfp";
     pipeline->verbose = verbose;
+    pipeline->opt_level = 2;
     
     // Allocate initial memory
     pipeline->initial_memory = calloc(MEMORY_SIZE, 1);
@@ -137,7 +143,7 @@ int zkvm_stage_compile(zkvm_pipeline_t* pipeline) {
     for (int reg = 0; reg < 32; reg++) {
         for (int bit = 0; bit < 32; bit++) {
             if (reg == 0) {
-                pipeline->compiler->reg_wires[reg][bit] = 1;  // x0 is always 0
+                pipeline->compiler->reg_wires[reg][bit] = CONSTANT_0_WIRE;  // x0 is always 0
             } else {
                 pipeline->compiler->reg_wires[reg][bit] = 
                     riscv_circuit_allocate_wire(pipeline->compiler->circuit);
@@ -187,6 +193,22 @@ int zkvm_stage_compile(zkvm_pipeline_t* pipeline) {
     clock_t end = clock();
     double compile_time = (double)(end - start) / CLOCKS_PER_SEC;
     
+    if (pipeline->opt_level > 0) {
+        size_t gates_before = pipeline->compiler->circuit->num_gates;
+        pass_manager_t* pm = pass_manager_create_preset(pipeline->opt_level);
+        if (!pm || pass_manager_run_compiler(pm, pipeline->compiler) != 0) {
+            pass_manager_destroy(pm);
+            fprintf(stderr, "Circuit optimization failed\n");
+            return -1;
+        }
+        printf("  Circuit passes (-O%d): %zu -> %zu gates\n", pipeline->opt_level,
+               gates_before, pipeline->compiler->circuit->num_gates);
+        if (pipeline->pass_report_filename) {
+            pass_manager_save_report(pm, pipeline->pass_report_filename);
+        }
+        pass_manager_destroy(pm);
+    }
+    
     pipeline->total_gates = pipeline->compiler->circuit->num_gates;
     pipeline->cycles_executed = compiled;
     
@@ -315,11 +337,30 @@ int zkvm_pipeline_run(zkvm_pipeline_t* pipeline) {
 // Main function for testing
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <elf-file> [-v]\n", argv[0]);
+        fprintf(stderr, "Usage: %s <elf-file> [-v] [-O0..-O3] [--pass-report <file.json>]\n",
+                argv[0]);
         return 1;
     }
     
-    bool verbose = (argc > 2 && strcmp(argv[2], "-v") == 0);
+    bool verbose = false;
+    int opt_level = 2;
+    const char* pass_report = NULL;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else if (strncmp(argv[i], "-O", 2) == 0) {
+            opt_level = pass_manager_parse_opt_level(argv[i]);
+            if (opt_level < 0) {
+                fprintf(stderr, "❌ ERROR: Unknown optimization level %s (use -O0..-O3)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--pass-report") == 0 && i + 1 < argc) {
+            pass_report = argv[++i];
+        } else {
+            fprintf(stderr, "❌ ERROR: Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
     
     // Create pipeline
     zkvm_pipeline_t* pipeline = zkvm_pipeline_create(argv[1], verbose);
@@ -327,6 +368,8 @@ int main(int argc, char* argv[]) {
         fprintf(stderr, "Failed to create pipeline\n");
         return 1;
     }
+    pipeline->opt_level = opt_level;
+    pipeline->pass_report_filename = pass_report;
     
     // Run pipeline
     int result = zkvm_pipeline_run(pipeline);
@@ -335,4 +378,4 @@ int main(int argc, char* argv[]) {
     zkvm_pipeline_free(pipeline);
     
     return result;
-}
\ No newline at end of file
+}
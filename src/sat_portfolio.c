@@ -0,0 +1,266 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+// solver.h defines bool itself, so it must come before <stdbool.h>
+#include "minisat/solver.h"
+#include "sat_portfolio.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Portfolio SAT solving: differently configured solvers race on each query
+
+#define SHARE_MAX_SIZE 8                // Longest clause handed to the others
+#define POOL_MAX_LITS (1 << 22)         // Exports past this wait for the next race
+
+// Decision heuristics, cycled through the solvers
+typedef struct {
+    restart_policy restarts;
+    phase_policy phases;
+    double random_var_freq;
+} solver_config_t;
+
+static const solver_config_t configs[] = {
+    {restart_glucose, phase_saving, 0.0},
+    {restart_luby, phase_saving, 0.01},
+    {restart_glucose, phase_false, 0.02},
+    {restart_luby, phase_true, 0.0},
+    {restart_geometric, phase_saving, 0.02},
+    {restart_glucose, phase_random, 0.0},
+};
+
+#define NUM_CONFIGS (sizeof(configs) / sizeof(configs[0]))
+
+typedef struct {
+    sat_portfolio_t* portfolio;
+    int index;
+    lit* scratch;                       // Clauses taken from the pool
+    size_t scratch_capacity;
+} member_t;
+
+struct sat_clause_pool {
+    pthread_mutex_t lock;
+    int* lits;                          // (source, size, literals...) per clause
+    size_t num_lits;
+    size_t capacity;
+    size_t cursor[SAT_PORTFOLIO_MAX_SOLVERS];   // Next clause each solver takes in
+    atomic_int winner;                  // Index + 1 of the first to answer, 0 while racing
+    member_t members[SAT_PORTFOLIO_MAX_SOLVERS];
+};
+
+// ============================================================================
+// Solver hooks
+// ============================================================================
+
+static int race_decided(void* ctx) {
+    member_t* member = ctx;
+    return atomic_load_explicit(&member->portfolio->pool->winner, memory_order_relaxed) != 0;
+}
+
+static void export_learnt(void* ctx, lit* begin, int size) {
+    member_t* member = ctx;
+    struct sat_clause_pool* pool = member->portfolio->pool;
+    pthread_mutex_lock(&pool->lock);
+    size_t needed = pool->num_lits + (size_t)size + 2;
+    if (needed > pool->capacity && needed <= POOL_MAX_LITS) {
+        size_t capacity = pool->capacity ? pool->capacity * 2 : 4096;
+        while (capacity < needed) capacity *= 2;
+        int* lits = realloc(pool->lits, capacity * sizeof(int));
+        if (lits) {
+            pool->lits = lits;
+            pool->capacity = capacity;
+        }
+    }
+    if (needed <= pool->capacity) {
+        pool->lits[pool->num_lits++] = member->index;
+        pool->lits[pool->num_lits++] = size;
+        memcpy(pool->lits + pool->num_lits, begin, (size_t)size * sizeof(int));
+        pool->num_lits += (size_t)size;
+        member->portfolio->shared_clauses++;
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Copies out under the lock, adds after it
+static void import_learnts(void* ctx, solver* s) {
+    member_t* member = ctx;
+    struct sat_clause_pool* pool = member->portfolio->pool;
+    pthread_mutex_lock(&pool->lock);
+    size_t from = pool->cursor[member->index];
+    size_t count = pool->num_lits - from;
+    if (count > member->scratch_capacity) {
+        lit* scratch = realloc(member->scratch, count * sizeof(lit));
+        if (scratch) {
+            member->scratch = scratch;
+            member->scratch_capacity = count;
+        }
+    }
+    if (count > member->scratch_capacity) count = 0;
+    if (count > 0) memcpy(member->scratch, pool->lits + from, count * sizeof(lit));
+    pool->cursor[member->index] = from + count;
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < count; i += 2 + (size_t)member->scratch[i + 1]) {
+        if (member->scratch[i] == member->index) continue;
+        lit* clause = member->scratch + i + 2;
+        if (!solver_addlearnt(s, clause, clause + member->scratch[i + 1])) break;
+    }
+}
+
+static void set_hooks(sat_portfolio_t* portfolio, bool racing) {
+    for (size_t i = 0; i < portfolio->num_solvers; i++) {
+        solver* s = portfolio->solvers[i];
+        bool share = racing && portfolio->share_learnts;
+        s->hook_ctx = &portfolio->pool->members[i];
+        s->terminate = racing ? race_decided : NULL;
+        s->export_learnt = share ? export_learnt : NULL;
+        s->import_learnts = share ? import_learnts : NULL;
+        s->export_max_size = SHARE_MAX_SIZE;
+    }
+}
+
+// ============================================================================
+// Portfolio
+// ============================================================================
+
+sat_portfolio_t* sat_portfolio_create(size_t num_solvers) {
+    if (num_solvers == 0 || num_solvers > SAT_PORTFOLIO_MAX_SOLVERS) {
+        fprintf(stderr, "❌ ERROR: A portfolio holds 1 to %d solvers, not %zu\n",
+                SAT_PORTFOLIO_MAX_SOLVERS, num_solvers);
+        return NULL;
+    }
+    sat_portfolio_t* portfolio = calloc(1, sizeof(sat_portfolio_t));
+    if (!portfolio) return NULL;
+    portfolio->pool = calloc(1, sizeof(struct sat_clause_pool));
+    if (!portfolio->pool) {
+        free(portfolio);
+        return NULL;
+    }
+    pthread_mutex_init(&portfolio->pool->lock, NULL);
+    portfolio->share_learnts = true;
+    portfolio->solo_conflicts = 200;
+    portfolio->winner = -1;
+
+    for (size_t i = 0; i < num_solvers; i++) {
+        solver* s = solver_new();
+        if (!s) {
+            sat_portfolio_destroy(portfolio);
+            return NULL;
+        }
+        const solver_config_t* config = &configs[i % NUM_CONFIGS];
+        s->restart_mode = config->restarts;
+        s->phase_mode = config->phases;
+        s->random_var_freq = config->random_var_freq;
+        // Past the table only the seed differs, and it needs random decisions
+        if (i >= NUM_CONFIGS && s->random_var_freq == 0) s->random_var_freq = 0.01;
+        s->random_seed = 91648253 + 7919.0 * (double)i;
+        portfolio->solvers[i] = s;
+        portfolio->num_solvers++;
+        portfolio->pool->members[i] = (member_t){portfolio, (int)i, NULL, 0};
+    }
+    return portfolio;
+}
+
+void sat_portfolio_destroy(sat_portfolio_t* portfolio) {
+    if (!portfolio) return;
+    for (size_t i = 0; i < portfolio->num_solvers; i++) {
+        solver_delete(portfolio->solvers[i]);
+        free(portfolio->pool->members[i].scratch);
+    }
+    pthread_mutex_destroy(&portfolio->pool->lock);
+    free(portfolio->pool->lits);
+    free(portfolio->pool);
+    free(portfolio);
+}
+
+void sat_portfolio_set_vars(sat_portfolio_t* portfolio, int num_vars) {
+    for (size_t i = 0; i < portfolio->num_solvers; i++) {
+        solver_setnvars(portfolio->solvers[i], num_vars);
+    }
+}
+
+bool sat_portfolio_add_clause(sat_portfolio_t* portfolio, int* lits, size_t num_lits) {
+    bool ok = true;
+    for (size_t i = 0; i < portfolio->num_solvers; i++) {
+        ok = solver_addclause(portfolio->solvers[i], lits, lits + num_lits) && ok;
+    }
+    return ok;
+}
+
+typedef struct {
+    sat_portfolio_t* portfolio;
+    int index;
+    lit* assumptions;
+    size_t num_assumptions;
+    int conflict_limit;
+    lbool result;
+} race_t;
+
+static void* race_solver(void* arg) {
+    race_t* run = arg;
+    struct sat_clause_pool* pool = run->portfolio->pool;
+    run->result = solver_solve_limited(run->portfolio->solvers[run->index], run->assumptions,
+                                       run->assumptions + run->num_assumptions,
+                                       run->conflict_limit);
+    int undecided = 0;
+    if (run->result != l_Undef) atomic_compare_exchange_strong(&pool->winner, &undecided,
+                                                               run->index + 1);
+    return NULL;
+}
+
+// Every solver on the query, solver 0 in the caller's thread
+static int race(sat_portfolio_t* portfolio, int* assumptions, size_t num_assumptions,
+                int conflict_limit, int solo_conflicts) {
+    struct sat_clause_pool* pool = portfolio->pool;
+    race_t runs[SAT_PORTFOLIO_MAX_SOLVERS];
+    pthread_t threads[SAT_PORTFOLIO_MAX_SOLVERS];
+    bool started[SAT_PORTFOLIO_MAX_SOLVERS] = {false};
+
+    pool->num_lits = 0;
+    memset(pool->cursor, 0, sizeof(pool->cursor));
+    atomic_store(&pool->winner, 0);
+    set_hooks(portfolio, true);
+
+    for (size_t i = 0; i < portfolio->num_solvers; i++) {
+        int limit = conflict_limit;
+        if (i == 0 && limit >= 0) limit -= solo_conflicts;
+        runs[i] = (race_t){portfolio, (int)i, assumptions, num_assumptions, limit, l_Undef};
+    }
+    // A solver whose thread does not start sits the race out
+    for (size_t i = 1; i < portfolio->num_solvers; i++) {
+        started[i] = pthread_create(&threads[i], NULL, race_solver, &runs[i]) == 0;
+    }
+    race_solver(&runs[0]);
+    for (size_t i = 1; i < portfolio->num_solvers; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+
+    set_hooks(portfolio, false);
+    portfolio->races++;
+    portfolio->winner = atomic_load(&pool->winner) - 1;
+    atomic_store(&pool->winner, 0);
+    if (portfolio->winner < 0) return l_Undef;
+    portfolio->wins[portfolio->winner]++;
+    return runs[portfolio->winner].result;
+}
+
+int sat_portfolio_solve(sat_portfolio_t* portfolio, int* assumptions, size_t num_assumptions,
+                        int conflict_limit) {
+    solver* first = portfolio->solvers[0];
+    int solo = portfolio->solo_conflicts;
+    bool alone = portfolio->num_solvers == 1 || (conflict_limit >= 0 && conflict_limit <= solo);
+    lbool result = solver_solve_limited(first, assumptions, assumptions + num_assumptions,
+                                        alone ? conflict_limit : solo);
+    portfolio->winner = result != l_Undef ? 0 : -1;
+    if (result != l_Undef || alone) return result;
+    return race(portfolio, assumptions, num_assumptions, conflict_limit, solo);
+}
+
+int sat_portfolio_value(const sat_portfolio_t* portfolio, int var) {
+    if (portfolio->winner < 0) return l_Undef;
+    return solver_model_value(portfolio->solvers[portfolio->winner], var);
+}
@@ -0,0 +1,349 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+// solver.h defines bool itself, so it must come before <stdbool.h>
+#include "minisat/solver.h"
+#include "circuit_passes.h"
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * SAT sweeping: merges wires that compute the same function.
+ *
+ * Every wire is simulated on 256 random input patterns, 64 at a time.
+ * Wires with equal signatures, up to complement, are candidates for the
+ * same function. Wires are visited in gate order, so each candidate is
+ * compared with earlier representatives; the pair is proven with two
+ * assumption solves over one CNF of the whole circuit (one variable per
+ * wire). A satisfying assignment is a counterexample: it is simulated into
+ * a spare signature word, which splits every candidate class it refutes.
+ * Proven pairs go back into the solver as clauses to speed later proofs.
+ *
+ * Solves are budgeted, and a pair that runs out is just left unmerged.
+ * Merged wires are replaced by their representative (or its complement)
+ * and dead cones are removed with DCE.
+ */
+
+#define SIM_WORDS 4                     // random patterns, 64 per word
+#define SIG_WORDS (SIM_WORDS + 1)       // plus a word of counterexamples
+#define SWEEP_CONFLICT_LIMIT 1000
+#define SWEEP_MAX_SAT_CALLS 4096
+#define SWEEP_MAX_TRIES 4               // representatives tried per wire
+#define NO_WIRE UINT32_MAX
+
+typedef struct {
+    const riscv_circuit_t* circuit;
+    size_t num_wires;
+    int64_t* driver;
+    uint32_t* refs;
+    uint32_t* not_of;       // an existing XOR(w, 1) output, or NO_WIRE
+    uint64_t* sig;          // SIG_WORDS per wire
+    size_t num_cex;
+    solver* sat;
+    size_t sat_calls;
+    uint32_t* bucket;       // representatives by normalized signature
+    size_t bucket_mask;
+    uint32_t* next_rep;
+    uint32_t* merge_rep;    // NO_WIRE if the wire stays
+    uint8_t* merge_phase;
+} sweep_t;
+
+static uint64_t* wire_sig(sweep_t* sw, uint32_t w) {
+    return &sw->sig[(size_t)w * SIG_WORDS];
+}
+
+static bool is_input(const sweep_t* sw, uint32_t w) {
+    return w != CONSTANT_0_WIRE && w != CONSTANT_1_WIRE && sw->driver[w] < 0;
+}
+
+static void simulate_word(sweep_t* sw, size_t k) {
+    const riscv_circuit_t* circuit = sw->circuit;
+    for (size_t g = 0; g < circuit->num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        uint64_t l = wire_sig(sw, gate->left_input)[k];
+        uint64_t r = wire_sig(sw, gate->right_input)[k];
+        wire_sig(sw, gate->output)[k] = gate->type == GATE_AND ? (l & r) : (l ^ r);
+    }
+}
+
+// Signature with bit 0 cleared by complementing, so w and ~w look alike
+static uint64_t norm_word(sweep_t* sw, uint32_t w, size_t k) {
+    uint64_t* s = wire_sig(sw, w);
+    return (s[0] & 1) ? ~s[k] : s[k];
+}
+
+static size_t sig_hash(sweep_t* sw, uint32_t w) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    for (size_t k = 0; k < SIM_WORDS; k++) {
+        h ^= norm_word(sw, w, k);
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 29;
+    }
+    return (size_t)h & sw->bucket_mask;
+}
+
+static bool same_class(sweep_t* sw, uint32_t a, uint32_t b) {
+    for (size_t k = 0; k < SIG_WORDS; k++) {
+        if (norm_word(sw, a, k) != norm_word(sw, b, k)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// SAT
+// ============================================================================
+
+static lit wire_lit(uint32_t w, int value) {
+    return value ? toLit((int)w) : lit_neg(toLit((int)w));
+}
+
+static void add_clause(solver* s, lit a, lit b, lit c, int n) {
+    lit clause[3] = {a, b, c};
+    solver_addclause(s, clause, clause + n);
+}
+
+static void encode_circuit(sweep_t* sw) {
+    solver* s = sw->sat;
+    solver_setnvars(s, (int)sw->num_wires);
+    add_clause(s, wire_lit(CONSTANT_0_WIRE, 0), 0, 0, 1);
+    add_clause(s, wire_lit(CONSTANT_1_WIRE, 1), 0, 0, 1);
+    for (size_t g = 0; g < sw->circuit->num_gates; g++) {
+        const gate_t* gate = &sw->circuit->gates[g];
+        lit z = toLit((int)gate->output);
+        lit a = toLit((int)gate->left_input);
+        lit b = toLit((int)gate->right_input);
+        if (gate->type == GATE_AND) {
+            add_clause(s, lit_neg(z), a, 0, 2);
+            add_clause(s, lit_neg(z), b, 0, 2);
+            add_clause(s, z, lit_neg(a), lit_neg(b), 3);
+        } else {
+            add_clause(s, lit_neg(z), a, b, 3);
+            add_clause(s, lit_neg(z), lit_neg(a), lit_neg(b), 3);
+            add_clause(s, z, lit_neg(a), b, 3);
+            add_clause(s, z, a, lit_neg(b), 3);
+        }
+    }
+}
+
+// Simulates the solver's model into the next counterexample slot
+static void add_counterexample(sweep_t* sw) {
+    uint64_t bit = 1ULL << (sw->num_cex++ % 64);
+    for (uint32_t w = 0; w < sw->num_wires; w++) {
+        if (!is_input(sw, w)) continue;
+        uint64_t* s = wire_sig(sw, w);
+        bool value = solver_model_value(sw->sat, (int)w) == l_True;
+        s[SIM_WORDS] = value ? (s[SIM_WORDS] | bit) : (s[SIM_WORDS] & ~bit);
+    }
+    simulate_word(sw, SIM_WORDS);
+}
+
+// True if w == r ^ phase for every input
+static bool prove_equal(sweep_t* sw, uint32_t w, uint32_t r, int phase) {
+    for (int v = 0; v < 2; v++) {
+        if (sw->sat_calls >= SWEEP_MAX_SAT_CALLS) return false;
+        sw->sat_calls++;
+        lit assumptions[2] = {wire_lit(w, v), wire_lit(r, v ^ phase ^ 1)};
+        lbool status = solver_solve_limited(sw->sat, assumptions, assumptions + 2,
+                                            SWEEP_CONFLICT_LIMIT);
+        if (status == l_True) add_counterexample(sw);
+        if (status != l_False) return false;
+    }
+    add_clause(sw->sat, wire_lit(w, 0), wire_lit(r, phase ^ 1), 0, 2);
+    add_clause(sw->sat, wire_lit(w, 1), wire_lit(r, phase), 0, 2);
+    return true;
+}
+
+// ============================================================================
+// The pass
+// ============================================================================
+
+// A complemented merge adds an inverter; take it only when one exists
+// already or the merge frees more than the wire's own gate. Never replace
+// XOR(r, 1) by a fresh NOT of r.
+static bool worth_merging(const sweep_t* sw, uint32_t w, uint32_t r, int phase) {
+    if (phase == 0 || r == CONSTANT_0_WIRE) return true;
+    const gate_t* gate = &sw->circuit->gates[sw->driver[w]];
+    uint32_t in[2] = {gate->left_input, gate->right_input};
+    if (gate->type == GATE_XOR && ((in[0] == r && in[1] == CONSTANT_1_WIRE) ||
+                                   (in[1] == r && in[0] == CONSTANT_1_WIRE))) {
+        return false;
+    }
+    if (sw->not_of[r] != NO_WIRE) return true;
+    for (int k = 0; k < 2; k++) {
+        if (sw->refs[in[k]] == 1 && sw->driver[in[k]] >= 0) return true;
+    }
+    return false;
+}
+
+static void add_representative(sweep_t* sw, uint32_t w) {
+    size_t h = sig_hash(sw, w);
+    sw->next_rep[w] = sw->bucket[h];
+    sw->bucket[h] = w;
+}
+
+static void sweep_wire(sweep_t* sw, uint32_t w) {
+    size_t tries = 0;
+    for (uint32_t r = sw->bucket[sig_hash(sw, w)]; r != NO_WIRE; r = sw->next_rep[r]) {
+        if (!same_class(sw, w, r)) continue;
+        int phase = (int)((wire_sig(sw, w)[0] ^ wire_sig(sw, r)[0]) & 1);
+        if (!worth_merging(sw, w, r, phase)) return;
+        if (prove_equal(sw, w, r, phase)) {
+            sw->merge_rep[w] = r;
+            sw->merge_phase[w] = (uint8_t)phase;
+            return;
+        }
+        if (++tries == SWEEP_MAX_TRIES) break;
+    }
+    add_representative(sw, w);
+}
+
+static int apply_merges(sweep_t* sw, pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    size_t num_wires = sw->num_wires;
+
+    riscv_circuit_t rebuilt = *circuit;
+    rebuilt.capacity = circuit->num_gates + 16;
+    rebuilt.gates = malloc(rebuilt.capacity * sizeof(gate_t));
+    rebuilt.num_gates = 0;
+    rebuilt.next_wire_id = (uint32_t)num_wires;
+    uint32_t* map = malloc(num_wires * sizeof(uint32_t));
+    uint32_t* inverted = malloc(num_wires * sizeof(uint32_t));
+    if (!rebuilt.gates || !map || !inverted) {
+        free(rebuilt.gates);
+        free(map);
+        free(inverted);
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        return -1;
+    }
+
+    for (size_t w = 0; w < num_wires; w++) {
+        map[w] = (uint32_t)w;
+        inverted[w] = NO_WIRE;
+    }
+    inverted[CONSTANT_0_WIRE] = CONSTANT_1_WIRE;
+    for (size_t g = 0; g < circuit->num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        uint32_t r = sw->merge_rep[gate->output];
+        if (r == NO_WIRE) {
+            riscv_circuit_add_gate(&rebuilt, map[gate->left_input], map[gate->right_input],
+                                   gate->output, gate->type);
+        } else if (sw->merge_phase[gate->output] == 0) {
+            map[gate->output] = map[r];
+        } else {
+            if (inverted[r] == NO_WIRE) inverted[r] = gate_not(&rebuilt, map[r]);
+            map[gate->output] = inverted[r];
+        }
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) *ctx->roots[i] = map[*ctx->roots[i]];
+
+    free(circuit->gates);
+    circuit->gates = rebuilt.gates;
+    circuit->num_gates = rebuilt.num_gates;
+    circuit->capacity = rebuilt.capacity;
+    circuit->next_wire_id = rebuilt.next_wire_id;
+    circuit->max_wire_id = rebuilt.next_wire_id;
+    free(map);
+    free(inverted);
+
+    return circuit_pass_dce(ctx) < 0 ? -1 : 1;
+}
+
+static void sweep_free(sweep_t* sw) {
+    free(sw->driver);
+    free(sw->refs);
+    free(sw->not_of);
+    free(sw->sig);
+    free(sw->bucket);
+    free(sw->next_rep);
+    free(sw->merge_rep);
+    free(sw->merge_phase);
+    if (sw->sat) solver_delete(sw->sat);
+}
+
+int circuit_pass_sweep(pass_context_t* ctx) {
+    riscv_circuit_t* circuit = ctx->circuit;
+    if (circuit->num_gates == 0 || riscv_circuit_is_extended(circuit)) return 0;
+
+    // One driver per wire from here on
+    int renumbered = circuit_pass_renumber(ctx);
+    if (renumbered < 0) return -1;
+
+    sweep_t sw;
+    memset(&sw, 0, sizeof(sw));
+    sw.circuit = circuit;
+    sw.num_wires = circuit->next_wire_id > circuit->num_inputs ?
+                   circuit->next_wire_id : circuit->num_inputs;
+    size_t num_wires = sw.num_wires;
+    size_t num_buckets = 1;
+    while (num_buckets < 2 * num_wires) num_buckets <<= 1;
+    sw.bucket_mask = num_buckets - 1;
+
+    sw.driver = malloc(num_wires * sizeof(int64_t));
+    sw.refs = calloc(num_wires, sizeof(uint32_t));
+    sw.not_of = malloc(num_wires * sizeof(uint32_t));
+    sw.sig = calloc(num_wires * SIG_WORDS, sizeof(uint64_t));
+    sw.bucket = malloc(num_buckets * sizeof(uint32_t));
+    sw.next_rep = malloc(num_wires * sizeof(uint32_t));
+    sw.merge_rep = malloc(num_wires * sizeof(uint32_t));
+    sw.merge_phase = calloc(num_wires, 1);
+    sw.sat = solver_new();
+    if (!sw.driver || !sw.refs || !sw.not_of || !sw.sig || !sw.bucket ||
+        !sw.next_rep || !sw.merge_rep || !sw.merge_phase || !sw.sat) {
+        fprintf(stderr, "❌ ERROR: Out of memory in circuit pass\n");
+        sweep_free(&sw);
+        return -1;
+    }
+
+    for (size_t w = 0; w < num_wires; w++) {
+        sw.driver[w] = -1;
+        sw.not_of[w] = NO_WIRE;
+        sw.merge_rep[w] = NO_WIRE;
+    }
+    memset(sw.bucket, 0xFF, num_buckets * sizeof(uint32_t));
+    for (size_t g = 0; g < circuit->num_gates; g++) {
+        const gate_t* gate = &circuit->gates[g];
+        sw.driver[gate->output] = (int64_t)g;
+        sw.refs[gate->left_input]++;
+        sw.refs[gate->right_input]++;
+        if (gate->type == GATE_XOR && gate->right_input == CONSTANT_1_WIRE) {
+            sw.not_of[gate->left_input] = gate->output;
+        } else if (gate->type == GATE_XOR && gate->left_input == CONSTANT_1_WIRE) {
+            sw.not_of[gate->right_input] = gate->output;
+        }
+    }
+    for (size_t i = 0; i < ctx->num_roots; i++) sw.refs[*ctx->roots[i]]++;
+
+    // Fixed seed: the pass is deterministic
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    for (uint32_t w = 0; w < num_wires; w++) {
+        uint64_t* s = wire_sig(&sw, w);
+        for (size_t k = 0; k < SIM_WORDS; k++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            if (is_input(&sw, w)) s[k] = state;
+        }
+    }
+    for (size_t k = 0; k < SIG_WORDS; k++) wire_sig(&sw, CONSTANT_1_WIRE)[k] = ~0ULL;
+    for (size_t k = 0; k < SIG_WORDS; k++) simulate_word(&sw, k);
+    encode_circuit(&sw);
+
+    // Constant 1 is the complement of constant 0, so only 0 represents them
+    add_representative(&sw, CONSTANT_0_WIRE);
+    for (uint32_t w = 0; w < num_wires; w++) {
+        if (is_input(&sw, w) && sw.refs[w] > 0) add_representative(&sw, w);
+    }
+    size_t merged = 0;
+    for (size_t g = 0; g < circuit->num_gates; g++) {
+        uint32_t w = circuit->gates[g].output;
+        sweep_wire(&sw, w);
+        if (sw.merge_rep[w] != NO_WIRE) merged++;
+    }
+
+    int result = merged > 0 ? apply_merges(&sw, ctx) : renumbered;
+    sweep_free(&sw);
+    return result;
+}
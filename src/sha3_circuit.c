@@ -6,10 +6,19 @@
 #include "riscv_compiler.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
 
-// SHA3-256 circuit implementation
-// This implements the full Keccak-f[1600] permutation used in SHA3
-// Expected gate count: ~192,000 gates
+// Keccak sponge circuit (SHA3-256, Keccak-256, SHAKE, ...)
+// This implements the full Keccak-f[1600] permutation plus the sponge:
+// multi-block absorb, domain-separated padding and squeeze of any length.
+//
+// Gate budget per Keccak-f round:
+//   theta: 5 column parities (1280 XOR) + 5 D lanes (320 XOR) + 1600 XOR
+//   rho/pi: pure rewiring (0 gates)
+//   chi:   3 gates per bit (the NOT is folded, see keccak_and)
+//   iota:  0 gates (constants are tracked as polarity, see kbit_t)
+// => ~8,000 gates per round, ~192K per permutation (fewer for the first
+//    block, where the zero capacity lanes fold away)
 
 // SHA3 parameters for 256-bit output
 #define SHA3_256_RATE 1088  // Rate in bits (136 bytes)
@@ -17,102 +26,111 @@
 #define SHA3_STATE_SIZE 1600  // Total state size in bits (25 * 64)
 #define SHA3_ROUNDS 24  // Number of Keccak rounds
 
-// Helper: Create rotation circuit for 64-bit values
-static void build_rotation_64(riscv_circuit_t* circuit, 
-                             uint32_t* input_bits, 
-                             uint32_t* output_bits,
-                             int rotation_amount) {
-    // Rotate a 64-bit value left by rotation_amount
-    for (int i = 0; i < 64; i++) {
-        int src_bit = (i - rotation_amount + 64) % 64;
-        output_bits[i] = input_bits[src_bit];
-    }
-}
+// Sentinel for state bits that are known to be constant inside the sponge
+// (zero initial state, padding). Only the sponge's own constants are folded;
+// caller-supplied wires are always treated as symbolic.
+#define KECCAK_KNOWN_ZERO UINT32_MAX
+
+// A state bit is wire ^ flag. Carrying complements as a flag lets iota and
+// the chi NOT cost nothing until a value actually leaves the sponge.
+typedef struct {
+    uint32_t wire;
+    uint8_t flag;
+} kbit_t;
+
+static const kbit_t KBIT_ZERO = {KECCAK_KNOWN_ZERO, 0};
+
+static kbit_t keccak_xor(riscv_circuit_t* circuit, kbit_t a, kbit_t b) {
+    kbit_t r;
+    r.flag = a.flag ^ b.flag;
 
-// Helper: Create XOR for 64-bit values
-static void build_xor_64(riscv_circuit_t* circuit,
-                        uint32_t* a_bits,
-                        uint32_t* b_bits, 
-                        uint32_t* output_bits) {
-    for (int i = 0; i < 64; i++) {
-        riscv_circuit_add_gate(circuit, a_bits[i], b_bits[i], output_bits[i], GATE_XOR);
+    if (a.wire == KECCAK_KNOWN_ZERO) {
+        r.wire = b.wire;
+    } else if (b.wire == KECCAK_KNOWN_ZERO) {
+        r.wire = a.wire;
+    } else {
+        r.wire = riscv_circuit_allocate_wire(circuit);
+        riscv_circuit_add_gate(circuit, a.wire, b.wire, r.wire, GATE_XOR);
     }
+    return r;
 }
 
-// Helper: Create AND for 64-bit values
-static void build_and_64(riscv_circuit_t* circuit,
-                        uint32_t* a_bits,
-                        uint32_t* b_bits,
-                        uint32_t* output_bits) {
-    for (int i = 0; i < 64; i++) {
-        riscv_circuit_add_gate(circuit, a_bits[i], b_bits[i], output_bits[i], GATE_AND);
-    }
+// x AND y for complemented-or-not operands, without materialising NOTs:
+//   ( x &  y)             1 gate
+//   (~x &  y) = y ^ (x&y) 2 gates
+//   (~x & ~y) = ~(x | y)  3 gates, result complemented
+static kbit_t keccak_and(riscv_circuit_t* circuit, kbit_t x, kbit_t y) {
+    if (x.wire == KECCAK_KNOWN_ZERO) return x.flag ? y : KBIT_ZERO;
+    if (y.wire == KECCAK_KNOWN_ZERO) return y.flag ? x : KBIT_ZERO;
+
+    kbit_t both = {riscv_circuit_allocate_wire(circuit), 0};
+    riscv_circuit_add_gate(circuit, x.wire, y.wire, both.wire, GATE_AND);
+
+    kbit_t plain_x = {x.wire, 0};
+    kbit_t plain_y = {y.wire, 0};
+
+    if (!x.flag && !y.flag) return both;
+    if (x.flag && !y.flag) return keccak_xor(circuit, plain_y, both);
+    if (!x.flag && y.flag) return keccak_xor(circuit, plain_x, both);
+
+    kbit_t either = keccak_xor(circuit, keccak_xor(circuit, plain_x, plain_y), both);
+    either.flag ^= 1;
+    return either;
 }
 
-// Helper: Create NOT for 64-bit values
-static void build_not_64(riscv_circuit_t* circuit,
-                        uint32_t* input_bits,
-                        uint32_t* output_bits) {
-    for (int i = 0; i < 64; i++) {
-        riscv_circuit_add_gate(circuit, input_bits[i], CONSTANT_1_WIRE, output_bits[i], GATE_XOR);
+// Materialise a state bit as a real wire
+static uint32_t keccak_resolve(riscv_circuit_t* circuit, kbit_t bit) {
+    if (bit.wire == KECCAK_KNOWN_ZERO) {
+        return bit.flag ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
     }
+    if (!bit.flag) return bit.wire;
+
+    uint32_t result = riscv_circuit_allocate_wire(circuit);
+    riscv_circuit_add_gate(circuit, bit.wire, CONSTANT_1_WIRE, result, GATE_XOR);
+    return result;
 }
 
-// Keccak θ (theta) step: Column parity and XOR
-static void build_keccak_theta(riscv_circuit_t* circuit, uint32_t** state) {
-    // Allocate temporary storage for column parities
-    uint32_t** C = malloc(5 * sizeof(uint32_t*));
-    uint32_t** D = malloc(5 * sizeof(uint32_t*));
-    
-    for (int i = 0; i < 5; i++) {
-        C[i] = riscv_circuit_allocate_wire_array(circuit, 64);
-        D[i] = riscv_circuit_allocate_wire_array(circuit, 64);
-    }
-    
-    // Step 1: Compute column parities C[x] = state[x,0] ⊕ state[x,1] ⊕ ... ⊕ state[x,4]
+// State bit (x, y, z) lives at index 64 * (x + 5 * y) + z, which matches the
+// byte order of the sponge (lane i = bytes 8i..8i+7, little-endian)
+#define KECCAK_BIT(x, y, z) (64 * ((x) + 5 * (y)) + (z))
+
+// Keccak θ (theta) step
+// Each column parity is computed once and shared by the D lane of both
+// neighbouring columns; every state bit then takes exactly one XOR.
+static void build_keccak_theta(riscv_circuit_t* circuit, kbit_t* state) {
+    kbit_t C[5][64];
+    kbit_t D[5][64];
+
     for (int x = 0; x < 5; x++) {
-        // Start with first row
-        memcpy(C[x], state[x * 5 + 0], 64 * sizeof(uint32_t));
-        
-        // XOR with remaining rows
-        for (int y = 1; y < 5; y++) {
-            uint32_t* temp = riscv_circuit_allocate_wire_array(circuit, 64);
-            build_xor_64(circuit, C[x], state[x * 5 + y], temp);
-            memcpy(C[x], temp, 64 * sizeof(uint32_t));
-            free(temp);
+        for (int z = 0; z < 64; z++) {
+            // Pairwise tree: same gate count as a chain, half the depth
+            kbit_t p01 = keccak_xor(circuit, state[KECCAK_BIT(x, 0, z)], state[KECCAK_BIT(x, 1, z)]);
+            kbit_t p23 = keccak_xor(circuit, state[KECCAK_BIT(x, 2, z)], state[KECCAK_BIT(x, 3, z)]);
+            kbit_t p0123 = keccak_xor(circuit, p01, p23);
+            C[x][z] = keccak_xor(circuit, p0123, state[KECCAK_BIT(x, 4, z)]);
         }
     }
-    
-    // Step 2: Compute D[x] = C[(x+4)%5] ⊕ ROT(C[(x+1)%5], 1)
+
+    // D[x] = C[x-1] ⊕ ROT(C[x+1], 1)
     for (int x = 0; x < 5; x++) {
-        uint32_t* rotated = riscv_circuit_allocate_wire_array(circuit, 64);
-        build_rotation_64(circuit, C[(x + 1) % 5], rotated, 1);
-        build_xor_64(circuit, C[(x + 4) % 5], rotated, D[x]);
-        free(rotated);
+        for (int z = 0; z < 64; z++) {
+            D[x][z] = keccak_xor(circuit, C[(x + 4) % 5][z], C[(x + 1) % 5][(z + 63) % 64]);
+        }
     }
-    
-    // Step 3: Apply θ transformation: state[x,y] = state[x,y] ⊕ D[x]
+
     for (int x = 0; x < 5; x++) {
         for (int y = 0; y < 5; y++) {
-            uint32_t* new_lane = riscv_circuit_allocate_wire_array(circuit, 64);
-            build_xor_64(circuit, state[x * 5 + y], D[x], new_lane);
-            memcpy(state[x * 5 + y], new_lane, 64 * sizeof(uint32_t));
-            free(new_lane);
+            for (int z = 0; z < 64; z++) {
+                int idx = KECCAK_BIT(x, y, z);
+                state[idx] = keccak_xor(circuit, state[idx], D[x][z]);
+            }
         }
     }
-    
-    // Cleanup
-    for (int i = 0; i < 5; i++) {
-        free(C[i]);
-        free(D[i]);
-    }
-    free(C);
-    free(D);
 }
 
-// Keccak ρ (rho) and π (pi) steps: Rotation and permutation
-static void build_keccak_rho_pi(riscv_circuit_t* circuit, uint32_t** state) {
-    // Rotation amounts for each position (from Keccak specification)
+// Keccak ρ (rho) and π (pi) steps: pure rewiring, no gates
+static void build_keccak_rho_pi(kbit_t* state) {
+    // Rotation offsets indexed by x + 5y (Keccak specification)
     static const int rho_offsets[25] = {
          0,  1, 62, 28, 27,
         36, 44,  6, 55, 20,
@@ -120,68 +138,49 @@ static void build_keccak_rho_pi(riscv_circuit_t* circuit, uint32_t** state) {
         41, 45, 15, 21,  8,
         18,  2, 61, 56, 14
     };
-    
-    uint32_t** new_state = malloc(25 * sizeof(uint32_t*));
-    for (int i = 0; i < 25; i++) {
-        new_state[i] = riscv_circuit_allocate_wire_array(circuit, 64);
-    }
-    
-    // Apply ρ (rotation) and π (permutation) simultaneously
+
+    kbit_t* new_state = malloc(SHA3_STATE_SIZE * sizeof(kbit_t));
+
+    // B[y, 2x + 3y] = ROT(A[x, y], r[x, y])
     for (int x = 0; x < 5; x++) {
         for (int y = 0; y < 5; y++) {
-            int src_index = x * 5 + y;
             int dst_x = y;
             int dst_y = (2 * x + 3 * y) % 5;
-            int dst_index = dst_x * 5 + dst_y;
-            
-            build_rotation_64(circuit, state[src_index], new_state[dst_index], rho_offsets[src_index]);
+            int r = rho_offsets[x + 5 * y];
+
+            for (int z = 0; z < 64; z++) {
+                new_state[KECCAK_BIT(dst_x, dst_y, (z + r) % 64)] = state[KECCAK_BIT(x, y, z)];
+            }
         }
     }
-    
-    // Copy back to original state
-    for (int i = 0; i < 25; i++) {
-        memcpy(state[i], new_state[i], 64 * sizeof(uint32_t));
-        free(new_state[i]);
-    }
+
+    memcpy(state, new_state, SHA3_STATE_SIZE * sizeof(kbit_t));
     free(new_state);
 }
 
-// Keccak χ (chi) step: Non-linear transformation
-static void build_keccak_chi(riscv_circuit_t* circuit, uint32_t** state) {
-    uint32_t** new_state = malloc(25 * sizeof(uint32_t*));
-    for (int i = 0; i < 25; i++) {
-        new_state[i] = riscv_circuit_allocate_wire_array(circuit, 64);
-    }
-    
-    // For each lane: new[x,y] = old[x,y] ⊕ ((NOT old[x+1,y]) AND old[x+2,y])
-    for (int x = 0; x < 5; x++) {
-        for (int y = 0; y < 5; y++) {
-            int idx = x * 5 + y;
-            int idx_x1 = ((x + 1) % 5) * 5 + y;
-            int idx_x2 = ((x + 2) % 5) * 5 + y;
-            
-            uint32_t* not_x1 = riscv_circuit_allocate_wire_array(circuit, 64);
-            uint32_t* and_result = riscv_circuit_allocate_wire_array(circuit, 64);
-            
-            build_not_64(circuit, state[idx_x1], not_x1);
-            build_and_64(circuit, not_x1, state[idx_x2], and_result);
-            build_xor_64(circuit, state[idx], and_result, new_state[idx]);
-            
-            free(not_x1);
-            free(and_result);
+// Keccak χ (chi) step: a ⊕ (¬b ∧ c)
+// The NOT is only a polarity flip on b, which keccak_and absorbs
+static void build_keccak_chi(riscv_circuit_t* circuit, kbit_t* state) {
+    kbit_t row[5];
+
+    for (int y = 0; y < 5; y++) {
+        for (int z = 0; z < 64; z++) {
+            for (int x = 0; x < 5; x++) {
+                row[x] = state[KECCAK_BIT(x, y, z)];
+            }
+
+            for (int x = 0; x < 5; x++) {
+                kbit_t not_b = row[(x + 1) % 5];
+                not_b.flag ^= 1;
+                kbit_t t = keccak_and(circuit, not_b, row[(x + 2) % 5]);
+                state[KECCAK_BIT(x, y, z)] = keccak_xor(circuit, row[x], t);
+            }
         }
     }
-    
-    // Copy back to original state
-    for (int i = 0; i < 25; i++) {
-        memcpy(state[i], new_state[i], 64 * sizeof(uint32_t));
-        free(new_state[i]);
-    }
-    free(new_state);
 }
 
-// Keccak ι (iota) step: Add round constant
-static void build_keccak_iota(riscv_circuit_t* circuit, uint32_t** state, int round) {
+// Keccak ι (iota) step: the round constant only flips polarities
+static void build_keccak_iota(kbit_t* state, int round) {
     // Round constants for SHA3 (from specification)
     static const uint64_t round_constants[24] = {
         0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
@@ -193,88 +192,127 @@ static void build_keccak_iota(riscv_circuit_t* circuit, uint32_t** state, int ro
         0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
         0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
     };
-    
+
     uint64_t rc = round_constants[round];
-    
-    // XOR the round constant with state[0,0] (position 0)
-    for (int i = 0; i < 64; i++) {
-        uint32_t constant_bit = ((rc >> i) & 1) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
-        uint32_t new_bit = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, state[0][i], constant_bit, new_bit, GATE_XOR);
-        state[0][i] = new_bit;
+    for (int z = 0; z < 64; z++) {
+        state[KECCAK_BIT(0, 0, z)].flag ^= (rc >> z) & 1;
     }
 }
 
 // Complete Keccak-f[1600] permutation
-static void build_keccak_f(riscv_circuit_t* circuit, uint32_t** state) {
+static void build_keccak_f(riscv_circuit_t* circuit, kbit_t* state) {
     for (int round = 0; round < SHA3_ROUNDS; round++) {
         build_keccak_theta(circuit, state);
-        build_keccak_rho_pi(circuit, state);
+        build_keccak_rho_pi(state);
         build_keccak_chi(circuit, state);
-        build_keccak_iota(circuit, state, round);
+        build_keccak_iota(state, round);
     }
 }
 
-// Main SHA3-256 circuit builder
-void build_sha3_256_circuit(riscv_circuit_t* circuit,
-                           uint32_t* input_bits,  // 512 bits input
-                           uint32_t* output_bits) // 256 bits output
-{
-    // Allocate Keccak state (25 lanes of 64 bits each = 1600 bits)
-    uint32_t** state = malloc(25 * sizeof(uint32_t*));
-    for (int i = 0; i < 25; i++) {
-        state[i] = riscv_circuit_allocate_wire_array(circuit, 64);
-        // Initialize to zero
-        for (int j = 0; j < 64; j++) {
-            state[i][j] = CONSTANT_0_WIRE;
-        }
+// Keccak-f[1600] on 1600 wires, in place
+void build_keccak_f1600(riscv_circuit_t* circuit, uint32_t* state_bits) {
+    kbit_t* state = malloc(SHA3_STATE_SIZE * sizeof(kbit_t));
+    for (int i = 0; i < SHA3_STATE_SIZE; i++) {
+        state[i].wire = state_bits[i];
+        state[i].flag = 0;
     }
-    
-    // Absorb input into state (512 bits = 8 lanes of 64 bits)
-    for (int lane = 0; lane < 8; lane++) {
-        for (int bit = 0; bit < 64; bit++) {
-            int input_idx = lane * 64 + bit;
-            if (input_idx < 512) {
-                uint32_t new_bit = riscv_circuit_allocate_wire(circuit);
-                riscv_circuit_add_gate(circuit, state[lane][bit], input_bits[input_idx], new_bit, GATE_XOR);
-                state[lane][bit] = new_bit;
-            }
-        }
+
+    build_keccak_f(circuit, state);
+
+    for (int i = 0; i < SHA3_STATE_SIZE; i++) {
+        state_bits[i] = keccak_resolve(circuit, state[i]);
     }
-    
-    // Apply padding (simplified - real SHA3 has more complex padding)
-    // Set the first bit after the message to 1
-    if (512 < SHA3_256_RATE) {
-        uint32_t new_bit = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, state[8][0], CONSTANT_1_WIRE, new_bit, GATE_XOR);
-        state[8][0] = new_bit;
+    free(state);
+}
+
+// Keccak sponge: absorb message_bytes bytes (8 wires per byte, LSB first),
+// pad with the given domain byte and squeeze output_bits wires.
+int build_keccak_sponge(riscv_circuit_t* circuit,
+                        const uint32_t* message_bits, size_t message_bytes,
+                        size_t rate_bytes, keccak_padding_t padding,
+                        uint32_t* output_bits, size_t num_output_bits) {
+    if (rate_bytes == 0 || rate_bytes >= SHA3_STATE_SIZE / 8 || rate_bytes % 8 != 0) {
+        fprintf(stderr, "❌ ERROR: Invalid Keccak rate %zu bytes\n", rate_bytes);
+        return -1;
     }
-    
-    // Set the last bit of the rate to 1 (domain separation)
-    int last_rate_lane = (SHA3_256_RATE - 1) / 64;
-    int last_rate_bit = (SHA3_256_RATE - 1) % 64;
-    if (last_rate_lane < 25) {
-        uint32_t new_bit = riscv_circuit_allocate_wire(circuit);
-        riscv_circuit_add_gate(circuit, state[last_rate_lane][last_rate_bit], CONSTANT_1_WIRE, new_bit, GATE_XOR);
-        state[last_rate_lane][last_rate_bit] = new_bit;
+
+    kbit_t* state = malloc(SHA3_STATE_SIZE * sizeof(kbit_t));
+    for (int i = 0; i < SHA3_STATE_SIZE; i++) {
+        state[i] = KBIT_ZERO;
     }
-    
-    // Apply Keccak-f permutation
-    build_keccak_f(circuit, state);
-    
-    // Extract output (first 256 bits = 4 lanes of 64 bits)
-    for (int lane = 0; lane < 4; lane++) {
-        for (int bit = 0; bit < 64; bit++) {
-            int output_idx = lane * 64 + bit;
-            if (output_idx < 256) {
-                output_bits[output_idx] = state[lane][bit];
+
+    // Absorb: full blocks plus the final padded block (always present)
+    size_t num_blocks = message_bytes / rate_bytes + 1;
+    for (size_t block = 0; block < num_blocks; block++) {
+        for (size_t byte = 0; byte < rate_bytes; byte++) {
+            size_t msg_byte = block * rate_bytes + byte;
+
+            for (int bit = 0; bit < 8; bit++) {
+                size_t idx = byte * 8 + bit;
+                kbit_t in = KBIT_ZERO;
+
+                if (msg_byte < message_bytes) {
+                    in.wire = message_bits[msg_byte * 8 + bit];
+                } else {
+                    // pad10*1 with domain separation bits in the first byte
+                    uint8_t pad = 0;
+                    if (msg_byte == message_bytes) pad |= (uint8_t)padding;
+                    if (byte == rate_bytes - 1) pad |= 0x80;
+                    in.flag = (pad >> bit) & 1;
+                }
+
+                state[idx] = keccak_xor(circuit, state[idx], in);
             }
         }
+
+        build_keccak_f(circuit, state);
     }
-    
-    // Cleanup
-    for (int i = 0; i < 25; i++) {
-        free(state[i]);
+
+    // Squeeze
+    size_t produced = 0;
+    while (produced < num_output_bits) {
+        size_t chunk = rate_bytes * 8;
+        if (chunk > num_output_bits - produced) chunk = num_output_bits - produced;
+
+        for (size_t i = 0; i < chunk; i++) {
+            output_bits[produced + i] = keccak_resolve(circuit, state[i]);
+        }
+        produced += chunk;
+
+        if (produced < num_output_bits) {
+            build_keccak_f(circuit, state);
+        }
     }
+
     free(state);
-}
\ No newline at end of file
+    return 0;
+}
+
+// SHA3-256 over a 64-byte message (two 256-bit children or leaf data)
+static void sha3_256_64b_gadget(riscv_circuit_t* circuit, const uint32_t* inputs,
+                                uint32_t* outputs, void* context) {
+    (void)context;
+    build_keccak_sponge(circuit, inputs, 64, SHA3_256_RATE / 8,
+                        KECCAK_PADDING_SHA3, outputs, 256);
+}
+
+// SHA3-256 of a 64-byte block (Merkle node). Compiled once per process and
+// stamped in by relocation, since memory proofs hash dozens of these.
+void build_sha3_256_circuit(riscv_circuit_t* circuit,
+                           uint32_t* input_bits,  // 512 bits input
+                           uint32_t* output_bits) // 256 bits output
+{
+    if (gadget_instantiate(circuit, "sha3_256_64B", 512, 256,
+                           sha3_256_64b_gadget, NULL, input_bits, output_bits) != 0) {
+        sha3_256_64b_gadget(circuit, input_bits, output_bits, NULL);
+    }
+}
+
+// Ethereum Keccak-256 (original Keccak padding) over message_bytes bytes
+void build_keccak_256_circuit(riscv_circuit_t* circuit,
+                              const uint32_t* message_bits, size_t message_bytes,
+                              uint32_t* output_bits)
+{
+    build_keccak_sponge(circuit, message_bits, message_bytes, SHA3_256_RATE / 8,
+                        KECCAK_PADDING_KECCAK, output_bits, 256);
+}
@@ -30,9 +30,9 @@ int main() {
     compiler->circuit->num_outputs = 32;  // Result register
     
     // Compile a simple ADD instruction
-    // ADD x3, x0, x0 (result = 0 + 0 = 0)
-    uint32_t add_instr = 0x000001B3;  // ADD x3, x0, x0
-    printf("Compiling ADD x3, x0, x0 (0x%08X)\n", add_instr);
+    // ADD x3, x1, x2 (x0 operands would fold away to no gates at all)
+    uint32_t add_instr = 0x002081B3;  // ADD x3, x1, x2
+    printf("Compiling ADD x3, x1, x2 (0x%08X)\n", add_instr);
     
     if (riscv_compile_instruction(compiler, add_instr) != 0) {
         fprintf(stderr, "Failed to compile ADD instruction\n");
@@ -65,7 +65,7 @@ int main() {
         const gate_t* first_gate = riscv_circuit_get_gate(compiler->circuit, 0);
         assert(first_gate != NULL);
         printf("  First gate: %s(%u, %u) -> %u\n",
-               first_gate->type == GATE_AND ? "AND" : "XOR",
+               gate_type_name(first_gate->type),
                first_gate->left_input,
                first_gate->right_input,
                first_gate->output);
@@ -85,7 +85,7 @@ int main() {
     for (size_t i = 0; i < 5 && i < num_gates; i++) {
         printf("  Gate %zu: %s(%u, %u) -> %u\n",
                i,
-               all_gates[i].type == GATE_AND ? "AND" : "XOR",
+               gate_type_name(all_gates[i].type),
                all_gates[i].left_input,
                all_gates[i].right_input,
                all_gates[i].output);
@@ -0,0 +1,508 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "formal_verification.h"
+#include "riscv_compiler.h"
+#include "circuit_passes.h"
+#include "sat_portfolio.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Parallel verification of instruction forms and passes, with a cache of
+// proven circuit structures
+
+// Part of every job hash; bump it when the reference semantics change so
+// that cached proofs against the old reference are dropped
+#define VERIFICATION_CACHE_VERSION 1
+
+#define MAX_THREADS 64
+
+static double now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return 1000.0 * (double)ts.tv_sec + (double)ts.tv_nsec / 1e6;
+}
+
+static char* copy_string(const char* s) {
+    if (!s) return NULL;
+    size_t len = strlen(s) + 1;
+    char* copy = malloc(len);
+    if (copy) memcpy(copy, s, len);
+    return copy;
+}
+
+// ============================================================================
+// Structure hashing
+// ============================================================================
+
+static uint64_t mix(uint64_t h, uint64_t v) {
+    h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h *= 0xFF51AFD7ED558CCDULL;
+    return h ^ (h >> 32);
+}
+
+uint64_t verification_structure_hash(const riscv_compiler_t* compiler) {
+    const riscv_circuit_t* circuit = compiler->circuit;
+    uint64_t h = mix(0, circuit->num_gates);
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        const gate_t* g = &circuit->gates[i];
+        h = mix(h, ((uint64_t)g->left_input << 32) | g->right_input);
+        h = mix(h, ((uint64_t)g->output << 32) | ((uint64_t)g->type << 8) | g->table);
+        h = mix(h, g->select_input);
+    }
+    for (int i = 0; i < 32; i++) h = mix(h, compiler->pc_wires[i]);
+    for (int r = 1; r < 32; r++) {
+        for (int i = 0; i < 32; i++) h = mix(h, compiler->reg_wires[r][i]);
+    }
+    return h;
+}
+
+// Only full SAT proofs are cached, and they hold whatever the solver
+// budget, so the budget is not part of the key
+static uint64_t job_hash(const verification_job_t* job, uint64_t before, uint64_t after) {
+    uint64_t h = mix(VERIFICATION_CACHE_VERSION, job->instruction);
+    for (const char* p = job->pass ? job->pass : ""; *p; p++) h = mix(h, (uint8_t)*p);
+    h = mix(h, before);
+    return mix(h, after);
+}
+
+// ============================================================================
+// Driver
+// ============================================================================
+
+verification_driver_t* verification_driver_create(void) {
+    verification_driver_t* driver = calloc(1, sizeof(verification_driver_t));
+    if (!driver) return NULL;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    driver->num_threads = cpus > 0 ? (size_t)cpus : 1;
+    driver->job_timeout_seconds = 60;
+    driver->conflict_limit = 1000;
+    driver->fallback_tests = 4096;
+    return driver;
+}
+
+static void clear_results(verification_driver_t* driver) {
+    for (size_t i = 0; i < driver->num_jobs; i++) {
+        verification_result_free(&driver->jobs[i].result);
+    }
+}
+
+void verification_driver_destroy(verification_driver_t* driver) {
+    if (!driver) return;
+    clear_results(driver);
+    free(driver->jobs);
+    free(driver->proven);
+    free(driver);
+}
+
+static int add_job(verification_driver_t* driver, const char* pass,
+                   riscv_instruction_t instruction) {
+    if (driver->num_jobs == driver->jobs_capacity) {
+        size_t capacity = driver->jobs_capacity ? 2 * driver->jobs_capacity : 256;
+        verification_job_t* jobs = realloc(driver->jobs, capacity * sizeof(verification_job_t));
+        if (!jobs) {
+            fprintf(stderr, "❌ ERROR: Out of memory queueing verification jobs\n");
+            return -1;
+        }
+        driver->jobs = jobs;
+        driver->jobs_capacity = capacity;
+    }
+    verification_job_t* job = &driver->jobs[driver->num_jobs++];
+    memset(job, 0, sizeof(*job));
+    job->instruction = instruction;
+    job->pass = pass;
+    return 0;
+}
+
+int verification_driver_add_instruction(verification_driver_t* driver,
+                                        riscv_instruction_t instruction) {
+    return add_job(driver, NULL, instruction);
+}
+
+int verification_driver_add_pass(verification_driver_t* driver, const char* pass,
+                                 riscv_instruction_t instruction) {
+    const circuit_pass_t* p = circuit_pass_lookup(pass);
+    if (!p) {
+        fprintf(stderr, "❌ ERROR: Unknown circuit pass '%s'\n", pass);
+        return -1;
+    }
+    // The registry's copy of the name outlives the caller's
+    return add_job(driver, p->name, instruction);
+}
+
+int verification_driver_add_rv32im(verification_driver_t* driver) {
+    const riscv_instruction_t* forms;
+    size_t count = verification_rv32im_forms(&forms);
+    for (size_t i = 0; i < count; i++) {
+        if (verification_driver_add_instruction(driver, forms[i]) != 0) return -1;
+    }
+    return 0;
+}
+
+int verification_driver_add_pass_rv32im(verification_driver_t* driver, const char* pass) {
+    const riscv_instruction_t* forms;
+    size_t count = verification_rv32im_forms(&forms);
+    for (size_t i = 0; i < count; i++) {
+        if (verification_driver_add_pass(driver, pass, forms[i]) != 0) return -1;
+    }
+    return 0;
+}
+
+static bool is_proven(const verification_driver_t* driver, uint64_t hash) {
+    size_t lo = 0, hi = driver->num_proven;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (driver->proven[mid] < hash) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < driver->num_proven && driver->proven[lo] == hash;
+}
+
+static int add_proven(verification_driver_t* driver, uint64_t hash) {
+    if (is_proven(driver, hash)) return 0;
+    if (driver->num_proven == driver->proven_capacity) {
+        size_t capacity = driver->proven_capacity ? 2 * driver->proven_capacity : 256;
+        uint64_t* proven = realloc(driver->proven, capacity * sizeof(uint64_t));
+        if (!proven) return -1;
+        driver->proven = proven;
+        driver->proven_capacity = capacity;
+    }
+    size_t i = driver->num_proven++;
+    while (i > 0 && driver->proven[i - 1] > hash) {
+        driver->proven[i] = driver->proven[i - 1];
+        i--;
+    }
+    driver->proven[i] = hash;
+    return 0;
+}
+
+static void fail_job(verification_job_t* job, const char* method, const char* message) {
+    job->result.verified = false;
+    job->result.method = method;
+    job->result.counterexample = copy_string(message);
+}
+
+// The compiled instruction against the reference
+static void run_instruction_job(const verification_driver_t* driver, sat_solver_t* solver,
+                                verification_job_t* job) {
+    equivalence_checker_t* checker =
+        equiv_checker_create_with(solver, driver->compiler, job->instruction);
+    if (!checker) {
+        fail_job(job, "sat", "no reference, or the instruction does not compile");
+        return;
+    }
+    job->structure_hash = job_hash(job, verification_structure_hash(checker->compiler), 0);
+    if (is_proven(driver, job->structure_hash)) {
+        job->cached = true;
+        job->result = (verification_result_t){true, "cached", 0, 0.0, NULL};
+    } else {
+        checker->conflict_limit = driver->conflict_limit;
+        checker->fallback_tests = driver->fallback_tests;
+        job->result = equiv_checker_verify(checker);
+        job->undecided_bits = checker->undecided_bits;
+    }
+    equiv_checker_destroy(checker);
+}
+
+// The instruction's circuit before against after the pass
+static void run_pass_job(const verification_driver_t* driver, sat_solver_t* solver,
+                         verification_job_t* job) {
+    riscv_compiler_t* before = verification_compile(driver->compiler, &job->instruction, 1);
+    riscv_compiler_t* after = verification_compile(driver->compiler, &job->instruction, 1);
+    pass_manager_t* pm = pass_manager_create();
+    if (!before || !after || !pm || pass_manager_add(pm, job->pass) != 0 ||
+        pass_manager_run_compiler(pm, after) != 0) {
+        fail_job(job, "sat", "the instruction does not compile or the pass failed");
+    } else {
+        job->structure_hash = job_hash(job, verification_structure_hash(before),
+                                       verification_structure_hash(after));
+        if (is_proven(driver, job->structure_hash)) {
+            job->cached = true;
+            job->result = (verification_result_t){true, "cached", 0, 0.0, NULL};
+        } else {
+            job->result = equiv_check_circuits(solver, before, after, driver->conflict_limit,
+                                               driver->fallback_tests, &job->undecided_bits);
+        }
+    }
+    pass_manager_destroy(pm);
+    riscv_compiler_destroy(before);
+    riscv_compiler_destroy(after);
+}
+
+typedef struct {
+    verification_driver_t* driver;
+    atomic_size_t* next_job;
+    size_t portfolio_solvers;
+    bool out_of_memory;
+} worker_t;
+
+// Each worker keeps one solver for all its jobs, so nodes shared between
+// instructions are encoded and proven once per thread
+static void* verification_worker(void* arg) {
+    worker_t* worker = arg;
+    verification_driver_t* driver = worker->driver;
+    sat_solver_t* solver = equiv_solver_create_portfolio(worker->portfolio_solvers);
+    if (!solver) {
+        worker->out_of_memory = true;
+        return NULL;
+    }
+    for (;;) {
+        size_t i = atomic_fetch_add(worker->next_job, 1);
+        if (i >= driver->num_jobs) break;
+        verification_job_t* job = &driver->jobs[i];
+        double start = now_ms();
+        equiv_solver_set_timeout(solver, driver->job_timeout_seconds);
+        if (job->pass) run_pass_job(driver, solver, job);
+        else run_instruction_job(driver, solver, job);
+        equiv_solver_set_timeout(solver, 0);
+        job->result.verification_time_ms = now_ms() - start;
+    }
+    equiv_solver_destroy(solver);
+    return NULL;
+}
+
+int verification_driver_run(verification_driver_t* driver) {
+    double start = now_ms();
+    clear_results(driver);
+    for (size_t i = 0; i < driver->num_jobs; i++) {
+        verification_job_t* job = &driver->jobs[i];
+        memset(&job->result, 0, sizeof(job->result));
+        job->cached = false;
+        job->undecided_bits = 0;
+        job->structure_hash = 0;
+    }
+
+    size_t num_threads = driver->num_threads ? driver->num_threads : 1;
+    if (num_threads > MAX_THREADS) num_threads = MAX_THREADS;
+    size_t available = num_threads;
+    if (num_threads > driver->num_jobs) num_threads = driver->num_jobs ? driver->num_jobs : 1;
+    // Threads without a job of their own race on the others' queries
+    size_t portfolio = driver->portfolio_solvers ? driver->portfolio_solvers
+                                                 : available / num_threads;
+    if (portfolio > SAT_PORTFOLIO_MAX_SOLVERS) portfolio = SAT_PORTFOLIO_MAX_SOLVERS;
+
+    atomic_size_t next_job = 0;
+    pthread_t threads[MAX_THREADS];
+    worker_t workers[MAX_THREADS];
+    size_t started = 0;
+    for (size_t t = 0; t < num_threads; t++) {
+        workers[t] = (worker_t){driver, &next_job, portfolio, false};
+        if (pthread_create(&threads[t], NULL, verification_worker, &workers[t]) != 0) break;
+        started++;
+    }
+    // Without any thread the caller does the work
+    if (started == 0) {
+        workers[0] = (worker_t){driver, &next_job, portfolio, false};
+        verification_worker(&workers[0]);
+    }
+    bool out_of_memory = started == 0 && workers[0].out_of_memory;
+    for (size_t t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+        out_of_memory = out_of_memory || workers[t].out_of_memory;
+    }
+    driver->wall_time_ms = now_ms() - start;
+
+    int failed = 0;
+    for (size_t i = 0; i < driver->num_jobs; i++) {
+        verification_job_t* job = &driver->jobs[i];
+        // Workers that could not start leave their jobs unrun
+        if (!job->result.method) fail_job(job, "sat", "not run");
+        // Only full proofs are cached; simulated bits are tested again
+        if (!job->result.verified) {
+            if (!verification_result_simulated(&job->result)) failed++;
+        } else if (!job->cached && strcmp(job->result.method, "sat") == 0 &&
+                   add_proven(driver, job->structure_hash) != 0) {
+            out_of_memory = true;
+        }
+    }
+    if (out_of_memory) {
+        fprintf(stderr, "❌ ERROR: Out of memory running verification jobs\n");
+        return -1;
+    }
+    return failed;
+}
+
+// ============================================================================
+// Cache
+// ============================================================================
+
+int verification_cache_load(verification_driver_t* driver, const char* filename) {
+    FILE* f = fopen(filename, "r");
+    if (!f) return 0;
+    unsigned long long hash;
+    int result = 0;
+    while (fscanf(f, "%llx", &hash) == 1) {
+        if (add_proven(driver, hash) != 0) {
+            fprintf(stderr, "❌ ERROR: Out of memory loading %s\n", filename);
+            result = -1;
+            break;
+        }
+    }
+    if (result == 0 && !feof(f)) {
+        fprintf(stderr, "❌ ERROR: Malformed verification cache %s\n", filename);
+        result = -1;
+    }
+    fclose(f);
+    return result;
+}
+
+int verification_cache_save(const verification_driver_t* driver, const char* filename) {
+    FILE* f = fopen(filename, "w");
+    if (!f) {
+        fprintf(stderr, "❌ ERROR: Cannot write verification cache %s\n", filename);
+        return -1;
+    }
+    for (size_t i = 0; i < driver->num_proven; i++) {
+        fprintf(f, "%016llx\n", (unsigned long long)driver->proven[i]);
+    }
+    int result = ferror(f) ? -1 : 0;
+    if (fclose(f) != 0) result = -1;
+    if (result < 0) fprintf(stderr, "❌ ERROR: Failed writing %s\n", filename);
+    return result;
+}
+
+// ============================================================================
+// Reports
+// ============================================================================
+
+static verification_report_t* report_from(const verification_job_t* jobs, size_t count,
+                                          double wall_time_ms) {
+    verification_report_t* report = calloc(1, sizeof(verification_report_t));
+    if (!report) return NULL;
+    report->entries = calloc(count ? count : 1, sizeof(verification_job_t));
+    if (!report->entries) {
+        free(report);
+        return NULL;
+    }
+    report->fully_verified = true;
+    report->total_time_ms = wall_time_ms;
+    for (size_t i = 0; i < count; i++) {
+        verification_job_t* entry = &report->entries[report->num_entries++];
+        *entry = jobs[i];
+        entry->result.counterexample = copy_string(jobs[i].result.counterexample);
+        // Other layers can fail a report, but only SAT proofs (cached ones
+        // included) verify it
+        report->fully_verified = report->fully_verified && entry->result.verified;
+        report->proven_entries += entry->result.verified &&
+                                  (entry->cached || (entry->result.method &&
+                                                    strcmp(entry->result.method, "sat") == 0));
+        report->total_tests_run += entry->result.test_cases_checked;
+        report->cached_entries += entry->cached;
+        if (verification_result_simulated(&entry->result)) {
+            report->simulated_bits += entry->undecided_bits;
+        } else {
+            report->undecided_bits += entry->undecided_bits;
+        }
+    }
+    report->fully_verified = report->fully_verified && report->proven_entries > 0;
+    return report;
+}
+
+verification_report_t* generate_verification_report(verification_pipeline_t* pipeline) {
+    verification_job_t jobs[32];
+    double total = 0.0;
+    for (size_t i = 0; i < pipeline->num_results; i++) {
+        memset(&jobs[i], 0, sizeof(jobs[i]));
+        jobs[i].instruction = pipeline->instruction;
+        jobs[i].result = pipeline->results[i];
+        if (strncmp(pipeline->results[i].method, "sat", 3) == 0) {
+            jobs[i].undecided_bits = pipeline->last_undecided_bits;
+        }
+        total += pipeline->results[i].verification_time_ms;
+    }
+    return report_from(jobs, pipeline->num_results, total);
+}
+
+verification_report_t* verification_driver_report(const verification_driver_t* driver) {
+    return report_from(driver->jobs, driver->num_jobs, driver->wall_time_ms);
+}
+
+void verification_report_free(verification_report_t* report) {
+    if (!report) return;
+    for (size_t i = 0; i < report->num_entries; i++) {
+        verification_result_free(&report->entries[i].result);
+    }
+    free(report->entries);
+    free(report);
+}
+
+void print_verification_report(const verification_report_t* report) {
+    printf("Verification Report\n");
+    printf("  Entries: %zu (%zu proven by SAT, %zu cached)\n", report->num_entries,
+           report->proven_entries, report->cached_entries);
+    printf("  Tests run: %zu\n", report->total_tests_run);
+    printf("  Bits only simulated: %zu\n", report->simulated_bits);
+    printf("  Bits undecided: %zu\n", report->undecided_bits);
+    printf("  Time: %.1f ms\n", report->total_time_ms);
+    for (size_t i = 0; i < report->num_entries; i++) {
+        const verification_job_t* e = &report->entries[i];
+        if (e->result.verified) continue;
+        if (verification_result_simulated(&e->result)) {
+            printf("  ⚠️  0x%08X%s%s: %zu bits only simulated\n", e->instruction,
+                   e->pass ? " after " : "", e->pass ? e->pass : "", e->undecided_bits);
+            continue;
+        }
+        printf("  ❌ 0x%08X%s%s: %s\n", e->instruction, e->pass ? " after " : "",
+               e->pass ? e->pass : "", e->result.counterexample ? e->result.counterexample : "failed");
+    }
+    printf("  %s\n", report->fully_verified ? "✅ Fully verified" : "❌ Not verified");
+}
+
+static void write_json_string(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fprintf(out, "\\%c", *s);
+        else if ((unsigned char)*s < 0x20) fprintf(out, "\\u%04x", *s);
+        else fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+int save_verification_report(const verification_report_t* report, const char* filename) {
+    FILE* out = fopen(filename, "w");
+    if (!out) {
+        fprintf(stderr, "❌ ERROR: Cannot write verification report to %s\n", filename);
+        return -1;
+    }
+    fprintf(out, "{\n");
+    fprintf(out, "  \"fully_verified\": %s,\n", report->fully_verified ? "true" : "false");
+    fprintf(out, "  \"entries\": %zu,\n", report->num_entries);
+    fprintf(out, "  \"cached\": %zu,\n", report->cached_entries);
+    fprintf(out, "  \"tests_run\": %zu,\n", report->total_tests_run);
+    fprintf(out, "  \"proven\": %zu,\n", report->proven_entries);
+    fprintf(out, "  \"simulated_bits\": %zu,\n", report->simulated_bits);
+    fprintf(out, "  \"undecided_bits\": %zu,\n", report->undecided_bits);
+    fprintf(out, "  \"time_ms\": %.3f,\n", report->total_time_ms);
+    fprintf(out, "  \"results\": [");
+    for (size_t i = 0; i < report->num_entries; i++) {
+        const verification_job_t* e = &report->entries[i];
+        fprintf(out, "%s\n    {\"instruction\": \"0x%08X\", \"pass\": ", i ? "," : "",
+                e->instruction);
+        if (e->pass) write_json_string(out, e->pass);
+        else fprintf(out, "null");
+        fprintf(out, ", \"method\": ");
+        write_json_string(out, e->result.method ? e->result.method : "");
+        fprintf(out, ", \"verified\": %s, \"cached\": %s, \"hash\": \"%016llx\", "
+                "\"tests\": %zu, \"undecided_bits\": %zu, \"time_ms\": %.3f",
+                e->result.verified ? "true" : "false", e->cached ? "true" : "false",
+                (unsigned long long)e->structure_hash, e->result.test_cases_checked,
+                e->undecided_bits, e->result.verification_time_ms);
+        if (e->result.counterexample) {
+            fprintf(out, ", \"counterexample\": ");
+            write_json_string(out, e->result.counterexample);
+        }
+        fprintf(out, "}");
+    }
+    fprintf(out, "%s]\n}\n", report->num_entries ? "\n  " : "");
+    int result = ferror(out) ? -1 : 0;
+    if (fclose(out) != 0) result = -1;
+    if (result < 0) fprintf(stderr, "❌ ERROR: Failed writing %s\n", filename);
+    return result;
+}
@@ -0,0 +1,309 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "zkvm_circuit.h"
+#include "gate_primitives.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/*
+ * Direct C-to-gates implementations of the zkvm.h primitives.
+ *
+ * All gadgets go through the folding primitives in gate_primitives.h, so
+ * constant inputs (padding, immediates, range bounds) simplify away at
+ * build time.
+ */
+
+// ============================================================================
+// Word helpers
+// ============================================================================
+
+void zkvm_build_const(uint32_t value, size_t width, uint32_t* out) {
+    for (size_t i = 0; i < width; i++) {
+        out[i] = (i < 32 && ((value >> i) & 1)) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+    }
+}
+
+void zkvm_build_reverse_bits(const uint32_t* x, size_t width, uint32_t* out) {
+    for (size_t i = 0; i < width / 2; i++) {
+        uint32_t lo = x[i];
+        out[i] = x[width - 1 - i];
+        out[width - 1 - i] = lo;
+    }
+    if (width & 1) out[width / 2] = x[width / 2];
+}
+
+// ============================================================================
+// Bit manipulation
+// ============================================================================
+
+// Bits needed to hold the count n
+static size_t count_bits_for(size_t n) {
+    size_t bits = 1;
+    while (((size_t)1 << bits) <= n) bits++;
+    return bits;
+}
+
+// Every input bit is a one-bit operand of weight 1; the compressor tree
+// turns the column of n bits into a binary count
+void zkvm_build_popcnt(riscv_circuit_t* circuit, const uint32_t* x, size_t width,
+                       uint32_t* out) {
+    size_t count_width = count_bits_for(width);
+    if (count_width > width) count_width = width;
+
+    uint32_t* storage = malloc(width * count_width * sizeof(uint32_t));
+    uint32_t** operands = malloc(width * sizeof(uint32_t*));
+    for (size_t i = 0; i < width; i++) {
+        operands[i] = storage + i * count_width;
+        operands[i][0] = x[i];
+        for (size_t b = 1; b < count_width; b++) operands[i][b] = CONSTANT_0_WIRE;
+    }
+
+    build_multi_operand_adder(circuit, operands, width, count_width, out,
+                              final_adder_for_objective(circuit));
+    for (size_t i = count_width; i < width; i++) out[i] = CONSTANT_0_WIRE;
+
+    free(operands);
+    free(storage);
+}
+
+// Leading-zero counter over n = 2^k bits (LSB first). Returns the all-zero
+// flag and writes k count bits; when every bit is zero the count is n - 1.
+static uint32_t leading_zero_counter(riscv_circuit_t* circuit, const uint32_t* bits,
+                                     size_t n, uint32_t* count) {
+    if (n == 1) return gate_not(circuit, bits[0]);
+
+    size_t half = n / 2;
+    size_t k = 0;
+    while (((size_t)1 << (k + 1)) < n) k++;  // k = log2(n) - 1
+
+    uint32_t* count_lo = malloc((k + 1) * sizeof(uint32_t));
+    uint32_t* count_hi = malloc((k + 1) * sizeof(uint32_t));
+    uint32_t zero_lo = leading_zero_counter(circuit, bits, half, count_lo);
+    uint32_t zero_hi = leading_zero_counter(circuit, bits + half, half, count_hi);
+
+    // Upper half empty: n/2 + count of the lower half, else count of the upper
+    count[k] = zero_hi;
+    for (size_t i = 0; i < k; i++) {
+        count[i] = gate_mux(circuit, zero_hi, count_lo[i], count_hi[i]);
+    }
+
+    free(count_lo);
+    free(count_hi);
+    return gate_and(circuit, zero_hi, zero_lo);
+}
+
+void zkvm_build_clz(riscv_circuit_t* circuit, const uint32_t* x, size_t width,
+                    uint32_t* out) {
+    size_t padded = 1, k = 0;
+    while (padded < width) {
+        padded <<= 1;
+        k++;
+    }
+
+    // Ones below the LSB make clz(0) come out as width with no extra logic
+    uint32_t* bits = malloc(padded * sizeof(uint32_t));
+    size_t pad = padded - width;
+    for (size_t i = 0; i < pad; i++) bits[i] = CONSTANT_1_WIRE;
+    for (size_t i = 0; i < width; i++) bits[pad + i] = x[i];
+
+    uint32_t* count = malloc((k + 1) * sizeof(uint32_t));
+    uint32_t all_zero = leading_zero_counter(circuit, bits, padded, count);
+
+    // Exact power of two: x == 0 reads as n - 1 and must become n
+    uint32_t not_zero = gate_not(circuit, all_zero);
+    for (size_t i = 0; i < width; i++) {
+        if (i < k) {
+            out[i] = gate_and(circuit, count[i], not_zero);
+        } else if (i == k) {
+            out[i] = all_zero;
+        } else {
+            out[i] = CONSTANT_0_WIRE;
+        }
+    }
+
+    free(count);
+    free(bits);
+}
+
+void zkvm_build_ctz(riscv_circuit_t* circuit, const uint32_t* x, size_t width,
+                    uint32_t* out) {
+    uint32_t* reversed = malloc(width * sizeof(uint32_t));
+    zkvm_build_reverse_bits(x, width, reversed);
+    zkvm_build_clz(circuit, reversed, width, out);
+    free(reversed);
+}
+
+uint32_t zkvm_build_parity(riscv_circuit_t* circuit, const uint32_t* x, size_t width) {
+    if (width == 0) return CONSTANT_0_WIRE;
+
+    uint32_t* level = malloc(width * sizeof(uint32_t));
+    memcpy(level, x, width * sizeof(uint32_t));
+    size_t n = width;
+    while (n > 1) {
+        size_t half = 0;
+        for (size_t i = 0; i + 1 < n; i += 2) {
+            level[half++] = gate_xor(circuit, level[i], level[i + 1]);
+        }
+        if (n & 1) level[half++] = level[n - 1];
+        n = half;
+    }
+
+    uint32_t result = level[0];
+    free(level);
+    return result;
+}
+
+// ============================================================================
+// Comparison and selection
+// ============================================================================
+
+uint32_t zkvm_build_eq(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                       size_t width) {
+    return build_compare_eq(circuit, a, b, width);
+}
+
+// Borrow chain shared with branches and SLTU
+uint32_t zkvm_build_ltu(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                        size_t width) {
+    return build_compare_lt(circuit, a, b, width, false);
+}
+
+void zkvm_build_select(riscv_circuit_t* circuit, uint32_t cond,
+                       const uint32_t* a, const uint32_t* b, size_t width, uint32_t* out) {
+    for (size_t i = 0; i < width; i++) {
+        out[i] = gate_mux(circuit, cond, a[i], b[i]);
+    }
+}
+
+void zkvm_build_min(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                    size_t width, uint32_t* out) {
+    uint32_t a_lt_b = zkvm_build_ltu(circuit, a, b, width);
+    zkvm_build_select(circuit, a_lt_b, a, b, width, out);
+}
+
+void zkvm_build_max(riscv_circuit_t* circuit, const uint32_t* a, const uint32_t* b,
+                    size_t width, uint32_t* out) {
+    uint32_t a_lt_b = zkvm_build_ltu(circuit, a, b, width);
+    zkvm_build_select(circuit, a_lt_b, b, a, width, out);
+}
+
+// |x| = (x ^ s) + s with s the sign bit; the +s is an incrementer chain
+void zkvm_build_abs(riscv_circuit_t* circuit, const uint32_t* x, size_t width,
+                    uint32_t* out) {
+    if (width == 0) return;
+
+    uint32_t sign = x[width - 1];
+    uint32_t carry = sign;
+    for (size_t i = 0; i < width; i++) {
+        uint32_t flipped = gate_xor(circuit, x[i], sign);
+        out[i] = gate_xor(circuit, flipped, carry);
+        if (i + 1 < width) carry = gate_and(circuit, flipped, carry);
+    }
+}
+
+// The arrays compare as one big number, so a single borrow chain decides
+// the order and a single AND tree decides equality
+void zkvm_build_memcmp(riscv_circuit_t* circuit, uint32_t* const* a, uint32_t* const* b,
+                       size_t words, uint32_t* out) {
+    size_t bits = words * 32;
+    uint32_t* flat_a = malloc((bits + 1) * sizeof(uint32_t));
+    uint32_t* flat_b = malloc((bits + 1) * sizeof(uint32_t));
+    for (size_t w = 0; w < words; w++) {
+        size_t base = (words - 1 - w) * 32;  // Word 0 is most significant
+        memcpy(flat_a + base, a[w], 32 * sizeof(uint32_t));
+        memcpy(flat_b + base, b[w], 32 * sizeof(uint32_t));
+    }
+
+    uint32_t less = zkvm_build_ltu(circuit, flat_a, flat_b, bits);
+    uint32_t equal = zkvm_build_eq(circuit, flat_a, flat_b, bits);
+
+    // -1 = all ones, 1 = just bit 0, 0 = nothing
+    out[0] = gate_not(circuit, equal);
+    for (int i = 1; i < 32; i++) out[i] = less;
+
+    free(flat_a);
+    free(flat_b);
+}
+
+// ============================================================================
+// Assertions
+// ============================================================================
+
+zkvm_constraints_t* zkvm_constraints_create(riscv_circuit_t* circuit) {
+    zkvm_constraints_t* cs = calloc(1, sizeof(zkvm_constraints_t));
+    if (!cs) return NULL;
+    cs->circuit = circuit;
+    cs->capacity = 64;
+    cs->conditions = malloc(cs->capacity * sizeof(uint32_t));
+    if (!cs->conditions) {
+        free(cs);
+        return NULL;
+    }
+    return cs;
+}
+
+void zkvm_constraints_destroy(zkvm_constraints_t* cs) {
+    if (!cs) return;
+    free(cs->conditions);
+    free(cs);
+}
+
+void zkvm_cs_assert(zkvm_constraints_t* cs, uint32_t condition) {
+    if (condition == CONSTANT_1_WIRE) return;  // Trivially satisfied
+
+    if (cs->num_conditions >= cs->capacity) {
+        size_t new_capacity = cs->capacity * 2;
+        uint32_t* grown = realloc(cs->conditions, new_capacity * sizeof(uint32_t));
+        if (!grown) {
+            fprintf(stderr, "❌ ERROR: Failed to grow constraint list\n");
+            return;
+        }
+        cs->conditions = grown;
+        cs->capacity = new_capacity;
+    }
+    cs->conditions[cs->num_conditions++] = condition;
+}
+
+void zkvm_cs_assert_eq(zkvm_constraints_t* cs, const uint32_t* a, const uint32_t* b,
+                       size_t width) {
+    zkvm_cs_assert(cs, zkvm_build_eq(cs->circuit, a, b, width));
+}
+
+void zkvm_cs_assert_ne(zkvm_constraints_t* cs, const uint32_t* a, const uint32_t* b,
+                       size_t width) {
+    zkvm_cs_assert(cs, gate_not(cs->circuit, zkvm_build_eq(cs->circuit, a, b, width)));
+}
+
+void zkvm_cs_assert_lt(zkvm_constraints_t* cs, const uint32_t* a, const uint32_t* b,
+                       size_t width) {
+    zkvm_cs_assert(cs, zkvm_build_ltu(cs->circuit, a, b, width));
+}
+
+void zkvm_cs_assert_le(zkvm_constraints_t* cs, const uint32_t* a, const uint32_t* b,
+                       size_t width) {
+    zkvm_cs_assert(cs, gate_not(cs->circuit, zkvm_build_ltu(cs->circuit, b, a, width)));
+}
+
+void zkvm_cs_assert_range(zkvm_constraints_t* cs, const uint32_t* value, size_t width,
+                          uint32_t min, uint32_t max) {
+    uint32_t* bound = calloc(width + 1, sizeof(uint32_t));
+
+    zkvm_build_const(min, width, bound);
+    zkvm_cs_assert_le(cs, bound, value, width);
+    zkvm_build_const(max, width, bound);
+    zkvm_cs_assert_le(cs, value, bound, width);
+
+    free(bound);
+}
+
+void zkvm_cs_assert_bit(zkvm_constraints_t* cs, const uint32_t* value, int bit_position) {
+    zkvm_cs_assert(cs, value[bit_position]);
+}
+
+uint32_t zkvm_constraints_finalize(zkvm_constraints_t* cs) {
+    return gate_and_reduce(cs->circuit, cs->conditions, cs->num_conditions);
+}
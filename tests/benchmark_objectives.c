@@ -0,0 +1,97 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include <stdio.h>
+#include <string.h>
+
+// Gates / AND gates / depth of each instruction under every objective.
+// The objective column a row is optimized for should win that metric.
+typedef struct {
+    const char* name;
+    uint32_t instruction;
+} objective_benchmark_t;
+
+static const objective_benchmark_t benchmarks[] = {
+    {"ADD",    0x002081B3},
+    {"SUB",    0x402081B3},
+    {"ADDI",   0x06408193},
+    {"SLT",    0x0020A1B3},
+    {"SLTU",   0x0020B1B3},
+    {"BLT",    0x0020C463},
+    {"BGEU",   0x0020F463},
+    {"SLL",    0x002091B3},
+    {"SRA",    0x4020D1B3},
+    {"JAL",    0x064000EF},
+    {"MUL",    0x022081B3},
+    {"MULHU",  0x0220B1B3},
+    {NULL, 0}
+};
+
+static const optimization_objective_t objectives[] = {
+    OPTIMIZE_GATES, OPTIMIZE_AND_COUNT, OPTIMIZE_DEPTH
+};
+#define NUM_OBJECTIVES (sizeof(objectives) / sizeof(objectives[0]))
+
+typedef struct {
+    size_t gates, ands, depth;
+} cost_t;
+
+static cost_t measure(uint32_t instruction, optimization_objective_t objective) {
+    cost_t cost = {0, 0, 0};
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    if (!compiler) return cost;
+
+    riscv_compiler_set_objective(compiler, objective);
+    riscv_compile_instruction(compiler, instruction);
+    cost.gates = compiler->circuit->num_gates;
+    cost.ands = riscv_circuit_count_and_gates(compiler->circuit);
+    cost.depth = riscv_circuit_depth(compiler->circuit);
+
+    riscv_compiler_destroy(compiler);
+    return cost;
+}
+
+int main(void) {
+    printf("Optimization Objective Trade-offs\n");
+    printf("=================================\n\n");
+    printf("%-7s", "");
+    for (size_t o = 0; o < NUM_OBJECTIVES; o++) {
+        printf(" | %-24s", optimization_objective_name(objectives[o]));
+    }
+    printf("\n%-7s", "Instr");
+    for (size_t o = 0; o < NUM_OBJECTIVES; o++) {
+        printf(" | %7s %7s %8s", "gates", "ANDs", "depth");
+    }
+    printf("\n");
+
+    cost_t totals[NUM_OBJECTIVES];
+    memset(totals, 0, sizeof(totals));
+
+    for (size_t i = 0; benchmarks[i].name; i++) {
+        printf("%-7s", benchmarks[i].name);
+        for (size_t o = 0; o < NUM_OBJECTIVES; o++) {
+            cost_t cost = measure(benchmarks[i].instruction, objectives[o]);
+            printf(" | %7zu %7zu %8zu", cost.gates, cost.ands, cost.depth);
+            totals[o].gates += cost.gates;
+            totals[o].ands += cost.ands;
+            totals[o].depth += cost.depth;
+        }
+        printf("\n");
+    }
+
+    printf("%-7s", "Total");
+    for (size_t o = 0; o < NUM_OBJECTIVES; o++) {
+        printf(" | %7zu %7zu %8zu", totals[o].gates, totals[o].ands, totals[o].depth);
+    }
+    printf("\n\n");
+
+    printf("gates:     ripple adders, borrow-chain comparators, 1-AND muxes\n");
+    printf("and-count: the same structures; each already has one AND per bit\n");
+    printf("depth:     Kogge-Stone adders, (lt, eq) tree comparators,\n");
+    printf("           two-level shifter muxes, Kogge-Stone multiplier final adder\n");
+
+    return 0;
+}
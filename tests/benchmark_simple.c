@@ -31,7 +31,7 @@ void benchmark_instruction_speed(void) {
     // Test instructions
     uint32_t test_instructions[] = {
         0x00208133,  // ADD x2, x1, x2
-        0x00214233,  // XOR x4, x1, x2
+        0x0020C233,  // XOR x4, x1, x2
         0x0020F2B3,  // AND x5, x1, x2
         0x40208333,  // SUB x6, x1, x2
         0x00509393,  // SLLI x7, x1, 5
@@ -141,7 +141,7 @@ void benchmark_memory_usage(void) {
         // Fill circuit with gates
         while (compiler->circuit->num_gates < target_gates) {
             // Add a simple XOR instruction
-            riscv_compile_instruction(compiler, 0x00214233);
+            riscv_compile_instruction(compiler, 0x0020C233);
         }
         
         // Estimate memory usage
@@ -0,0 +1,86 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef CIRCUIT_EVAL_H
+#define CIRCUIT_EVAL_H
+
+// Minimal gate-level evaluator shared by the functional tests.
+// Gates are stored in topological order, so a single forward sweep suffices.
+
+#include "riscv_compiler.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Allocate a zeroed wire-value table large enough for every wire in the circuit
+static inline uint8_t* eval_alloc(const riscv_circuit_t* circuit) {
+    size_t n = circuit->next_wire_id > circuit->num_inputs ?
+               circuit->next_wire_id : circuit->num_inputs;
+    uint8_t* values = calloc(n + 1, 1);
+    values[CONSTANT_1_WIRE] = 1;
+    return values;
+}
+
+static inline void eval_set_word(uint8_t* values, const uint32_t* wires,
+                                 uint64_t value, size_t bits) {
+    for (size_t i = 0; i < bits; i++) {
+        values[wires[i]] = (value >> i) & 1;
+    }
+}
+
+static inline uint64_t eval_get_word(const uint8_t* values, const uint32_t* wires,
+                                     size_t bits) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bits; i++) {
+        value |= (uint64_t)(values[wires[i]] & 1) << i;
+    }
+    return value;
+}
+
+static inline void eval_run(const riscv_circuit_t* circuit, uint8_t* values) {
+    values[CONSTANT_0_WIRE] = 0;
+    values[CONSTANT_1_WIRE] = 1;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        const gate_t* g = &circuit->gates[i];
+        values[g->output] = gate_eval_word(g, values[g->left_input], values[g->right_input],
+                                           values[g->select_input]) & 1;
+    }
+}
+
+// Load a full machine state (PC + registers) into the compiler's input wires
+static inline void eval_load_state(uint8_t* values, uint32_t pc, const uint32_t regs[32]) {
+    for (int i = 0; i < 32; i++) {
+        values[get_pc_wire(i)] = (pc >> i) & 1;
+    }
+    for (int r = 1; r < 32; r++) {
+        for (int i = 0; i < 32; i++) {
+            values[get_register_wire(r, i)] = (regs[r] >> i) & 1;
+        }
+    }
+}
+
+static inline uint32_t eval_get_reg(const riscv_compiler_t* compiler,
+                                    const uint8_t* values, int reg) {
+    return (uint32_t)eval_get_word(values, compiler->reg_wires[reg], 32);
+}
+
+static inline void eval_free_circuit(riscv_circuit_t* circuit) {
+    if (!circuit) return;
+    free(circuit->gates);
+    free(circuit->input_bits);
+    free(circuit->output_bits);
+    free(circuit);
+}
+
+// Deterministic xorshift generator so failures are reproducible
+static inline uint64_t eval_rand64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+#endif // CIRCUIT_EVAL_H
@@ -0,0 +1,100 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#ifndef CNF_FIXTURES_H
+#define CNF_FIXTURES_H
+
+// CNF instances shared by the SAT solver tests. Literals use the solvers'
+// encoding: 2 * v for x_v, 2 * v + 1 for its negation.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct {
+    int* lits;
+    int* starts;            // clause i is lits[starts[i] .. starts[i+1])
+    int  num_clauses;
+    int  num_lits;
+    int  num_vars;
+} cnf_t;
+
+static inline cnf_t* cnf_create(int num_vars, int max_clauses, int max_lits) {
+    cnf_t* cnf = calloc(1, sizeof(cnf_t));
+    cnf->lits = malloc(sizeof(int) * max_lits);
+    cnf->starts = malloc(sizeof(int) * (max_clauses + 1));
+    cnf->num_vars = num_vars;
+    return cnf;
+}
+
+static inline void cnf_destroy(cnf_t* cnf) {
+    free(cnf->lits);
+    free(cnf->starts);
+    free(cnf);
+}
+
+static inline void cnf_add(cnf_t* cnf, const int* lits, int n) {
+    cnf->starts[cnf->num_clauses++] = cnf->num_lits;
+    for (int i = 0; i < n; i++) cnf->lits[cnf->num_lits++] = lits[i];
+    cnf->starts[cnf->num_clauses] = cnf->num_lits;
+}
+
+// Every pigeon gets a hole, no hole takes two pigeons
+static inline cnf_t* cnf_pigeonhole(int pigeons, int holes) {
+    cnf_t* cnf = cnf_create(pigeons * holes, pigeons + holes * pigeons * pigeons,
+                            pigeons * holes * (pigeons + 1) * 2);
+    int clause[16];
+    for (int p = 0; p < pigeons; p++) {
+        for (int h = 0; h < holes; h++) clause[h] = 2 * (p * holes + h);
+        cnf_add(cnf, clause, holes);
+    }
+    for (int h = 0; h < holes; h++) {
+        for (int p = 0; p < pigeons; p++) {
+            for (int q = p + 1; q < pigeons; q++) {
+                clause[0] = 2 * (p * holes + h) + 1;
+                clause[1] = 2 * (q * holes + h) + 1;
+                cnf_add(cnf, clause, 2);
+            }
+        }
+    }
+    return cnf;
+}
+
+static inline uint32_t cnf_next_random(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// Random 3-SAT; with a planted assignment every clause agrees with it
+static inline cnf_t* cnf_random_3sat(int vars, int clauses, uint32_t seed, bool planted) {
+    cnf_t* cnf = cnf_create(vars, clauses, clauses * 3);
+    while (cnf->num_clauses < clauses) {
+        int clause[3];
+        bool agrees = false;
+        for (int i = 0; i < 3; i++) {
+            int v = (int)(cnf_next_random(&seed) % vars);
+            clause[i] = (cnf_next_random(&seed) & 1) ? 2 * v : 2 * v + 1;
+            agrees = agrees || (clause[i] & 1) == (v % 3 == 0);   // planted: x_v = (v % 3 != 0)
+        }
+        if (!planted || agrees) cnf_add(cnf, clause, 3);
+    }
+    return cnf;
+}
+
+// Whether every clause holds under value(ctx, v): 1 for true, -1 for false
+static inline bool cnf_satisfied(const cnf_t* cnf, int (*value)(const void* ctx, int v),
+                                 const void* ctx) {
+    for (int c = 0; c < cnf->num_clauses; c++) {
+        bool satisfied = false;
+        for (int i = cnf->starts[c]; i < cnf->starts[c + 1] && !satisfied; i++) {
+            int lit = cnf->lits[i];
+            satisfied = value(ctx, lit / 2) == ((lit & 1) ? -1 : 1);
+        }
+        if (!satisfied) return false;
+    }
+    return true;
+}
+
+#endif // CNF_FIXTURES_H
@@ -0,0 +1,298 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "circuit_passes.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define TRIALS 200
+
+static uint32_t raw_gate(riscv_circuit_t* circuit, uint32_t l, uint32_t r, gate_type_t type) {
+    uint32_t out = riscv_circuit_allocate_wire(circuit);
+    riscv_circuit_add_gate(circuit, l, r, out, type);
+    return out;
+}
+
+// x | y the way the compiler writes it: x ^ y ^ (x & y)
+static uint32_t raw_or(riscv_circuit_t* circuit, uint32_t x, uint32_t y) {
+    uint32_t t = raw_gate(circuit, x, y, GATE_XOR);
+    return raw_gate(circuit, t, raw_gate(circuit, x, y, GATE_AND), GATE_XOR);
+}
+
+static uint32_t raw_not(riscv_circuit_t* circuit, uint32_t x) {
+    return raw_gate(circuit, x, CONSTANT_1_WIRE, GATE_XOR);
+}
+
+// Truth table of a one-output circuit over free inputs 2..n+1
+static uint16_t truth_table(const riscv_circuit_t* circuit, uint32_t output, size_t num_inputs) {
+    uint16_t tt = 0;
+    uint8_t* values = eval_alloc(circuit);
+    for (uint32_t in = 0; in < (1u << num_inputs); in++) {
+        memset(values, 0, circuit->next_wire_id);
+        values[CONSTANT_1_WIRE] = 1;
+        for (size_t i = 0; i < num_inputs; i++) values[2 + i] = (in >> i) & 1;
+        eval_run(circuit, values);
+        tt |= (uint16_t)(values[output] << in);
+    }
+    free(values);
+    return tt;
+}
+
+// Runs andmin then DCE under the given objective
+static int run_andmin(riscv_circuit_t* circuit, uint32_t* output, optimization_objective_t objective) {
+    circuit->objective = objective;
+    pass_manager_t* pm = pass_manager_create();
+    pass_manager_add(pm, "andmin");
+    pass_manager_add(pm, "dce");
+    int rc = pass_manager_run(pm, circuit, output, 1);
+    pass_manager_destroy(pm);
+    return rc;
+}
+
+// Algebraic degree of a 3-input truth table
+static int degree3(uint8_t tt) {
+    uint8_t anf = tt;
+    for (int i = 0; i < 3; i++) {
+        for (int m = 0; m < 8; m++) {
+            if (m & (1 << i)) anf ^= (uint8_t)(((anf >> (m ^ (1 << i))) & 1) << m);
+        }
+    }
+    int degree = 0;
+    for (int m = 0; m < 8; m++) {
+        if (((anf >> m) & 1) && __builtin_popcount(m) > degree) degree = __builtin_popcount(m);
+    }
+    return degree;
+}
+
+void test_patterns(void) {
+    TEST_SUITE("Majority and Mux Forms");
+
+    // (a & b) | (a & c) | (b & c): 5 ANDs with the ORs
+    riscv_circuit_t* circuit = riscv_circuit_create(5, 1);
+    uint32_t a = 2, b = 3, c = 4;
+    uint32_t maj = raw_or(circuit, raw_or(circuit, raw_gate(circuit, a, b, GATE_AND),
+                                                   raw_gate(circuit, a, c, GATE_AND)),
+                          raw_gate(circuit, b, c, GATE_AND));
+    uint16_t tt = truth_table(circuit, maj, 3);
+    size_t ands = riscv_circuit_count_and_gates(circuit);
+    run_andmin(circuit, &maj, OPTIMIZE_AND_COUNT);
+
+    TEST("Sum-of-products majority becomes the one-AND carry");
+    printf("(%zu -> %zu ANDs) ", ands, riscv_circuit_count_and_gates(circuit));
+    ASSERT_TRUE(riscv_circuit_count_and_gates(circuit) == 1 &&
+                truth_table(circuit, maj, 3) == tt && tt == 0xE8);
+    eval_free_circuit(circuit);
+
+    // (s & t) ^ (~s & f): 2 ANDs, 4 gates
+    circuit = riscv_circuit_create(5, 1);
+    uint32_t s = 2, t = 3, f = 4;
+    uint32_t mux = raw_gate(circuit, raw_gate(circuit, s, t, GATE_AND),
+                            raw_gate(circuit, raw_not(circuit, s), f, GATE_AND), GATE_XOR);
+    tt = truth_table(circuit, mux, 3);
+    run_andmin(circuit, &mux, OPTIMIZE_GATES);
+
+    TEST("Two-AND mux becomes f ^ (s & (t ^ f)) without adding gates");
+    printf("(%zu gates) ", circuit->num_gates);
+    ASSERT_TRUE(riscv_circuit_count_and_gates(circuit) == 1 && circuit->num_gates <= 3 &&
+                truth_table(circuit, mux, 3) == tt);
+    eval_free_circuit(circuit);
+
+    // Same mux under the depth objective stays as it is
+    circuit = riscv_circuit_create(5, 1);
+    mux = raw_gate(circuit, raw_gate(circuit, s, t, GATE_AND),
+                   raw_gate(circuit, raw_not(circuit, s), f, GATE_AND), GATE_XOR);
+    run_andmin(circuit, &mux, OPTIMIZE_DEPTH);
+
+    TEST("Depth objective leaves the shallow mux alone");
+    ASSERT_EQ(2, riscv_circuit_count_and_gates(circuit));
+    eval_free_circuit(circuit);
+}
+
+// Every 3-input function written as an OR of minterms
+void test_all_3_input_functions(void) {
+    TEST_SUITE("All 3-Input Functions");
+
+    bool all_correct = true, all_optimal = true;
+    size_t ands_before = 0, ands_after = 0;
+    for (uint32_t fn = 0; fn < 256; fn++) {
+        riscv_circuit_t* circuit = riscv_circuit_create(5, 1);
+        uint32_t out = CONSTANT_0_WIRE;
+        bool first = true;
+        for (uint32_t m = 0; m < 8; m++) {
+            if (!((fn >> m) & 1)) continue;
+            uint32_t lit[3];
+            for (int i = 0; i < 3; i++) lit[i] = (m >> i) & 1 ? 2u + i : raw_not(circuit, 2u + i);
+            uint32_t term = raw_gate(circuit, raw_gate(circuit, lit[0], lit[1], GATE_AND),
+                                     lit[2], GATE_AND);
+            out = first ? term : raw_or(circuit, out, term);
+            first = false;
+        }
+        ands_before += riscv_circuit_count_and_gates(circuit);
+
+        if (run_andmin(circuit, &out, OPTIMIZE_AND_COUNT) != 0 ||
+            truth_table(circuit, out, 3) != fn) {
+            if (all_correct) printf("(function 0x%02X wrong) ", fn);
+            all_correct = false;
+        }
+        // Multiplicative complexity of a 3-input function is its degree - 1
+        size_t ands = riscv_circuit_count_and_gates(circuit);
+        int degree = degree3((uint8_t)fn);
+        size_t optimal = degree > 1 ? (size_t)degree - 1 : 0;
+        if (ands != optimal) all_optimal = false;
+        ands_after += ands;
+        eval_free_circuit(circuit);
+    }
+
+    TEST("Every 3-input function keeps its truth table");
+    ASSERT_TRUE(all_correct);
+
+    TEST("Every 3-input function reaches its multiplicative complexity");
+    printf("(%zu -> %zu ANDs in total) ", ands_before, ands_after);
+    ASSERT_TRUE(all_optimal);
+}
+
+void test_4_input_functions(void) {
+    TEST_SUITE("4-Input Functions");
+
+    // ab ^ ac ^ bd ^ cd = (a ^ d) & (b ^ c): 4 ANDs -> 1
+    riscv_circuit_t* circuit = riscv_circuit_create(6, 1);
+    uint32_t a = 2, b = 3, c = 4, d = 5;
+    uint32_t out = raw_gate(circuit, raw_gate(circuit, a, b, GATE_AND),
+                            raw_gate(circuit, a, c, GATE_AND), GATE_XOR);
+    out = raw_gate(circuit, out, raw_gate(circuit, b, d, GATE_AND), GATE_XOR);
+    out = raw_gate(circuit, out, raw_gate(circuit, c, d, GATE_AND), GATE_XOR);
+    uint16_t tt = truth_table(circuit, out, 4);
+    run_andmin(circuit, &out, OPTIMIZE_AND_COUNT);
+
+    TEST("Rank-2 quadratic form needs one AND");
+    ASSERT_TRUE(riscv_circuit_count_and_gates(circuit) == 1 && truth_table(circuit, out, 4) == tt);
+    eval_free_circuit(circuit);
+
+    // (a | b) ^ (c | d) ^ (a & c): quadratic of rank 4, 3 ANDs -> 2
+    circuit = riscv_circuit_create(6, 1);
+    out = raw_gate(circuit, raw_or(circuit, a, b), raw_or(circuit, c, d), GATE_XOR);
+    out = raw_gate(circuit, out, raw_gate(circuit, a, c, GATE_AND), GATE_XOR);
+    tt = truth_table(circuit, out, 4);
+    run_andmin(circuit, &out, OPTIMIZE_AND_COUNT);
+
+    TEST("Rank-4 quadratic form needs two ANDs");
+    ASSERT_TRUE(riscv_circuit_count_and_gates(circuit) == 2 && truth_table(circuit, out, 4) == tt);
+    eval_free_circuit(circuit);
+
+    // a & b & c & d is already optimal
+    circuit = riscv_circuit_create(6, 1);
+    out = raw_gate(circuit, raw_gate(circuit, a, b, GATE_AND),
+                   raw_gate(circuit, c, d, GATE_AND), GATE_AND);
+    run_andmin(circuit, &out, OPTIMIZE_AND_COUNT);
+
+    TEST("4-input AND is left at three ANDs");
+    ASSERT_TRUE(riscv_circuit_count_and_gates(circuit) == 3 &&
+                truth_table(circuit, out, 4) == 0x8000);
+    eval_free_circuit(circuit);
+}
+
+// A program compiled for depth has two-AND muxes and parallel-prefix
+// carries; andmin under the AND-count objective must keep every register
+static const uint32_t program[] = {
+    0x002081B3,  // add  x3, x1, x2
+    0x40310233,  // sub  x4, x2, x3
+    0x0020A3B3,  // slt  x7, x1, x2
+    0x00239433,  // sll  x8, x7, x2
+    0x0020D4B3,  // srl  x9, x1, x2
+    0x0041C2B3,  // xor  x5, x3, x4
+};
+#define PROGRAM_LEN (sizeof(program) / sizeof(program[0]))
+
+void test_compiled_program(void) {
+    TEST_SUITE("Compiled Program");
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    riscv_compiler_set_objective(compiler, OPTIMIZE_DEPTH);
+    for (size_t i = 0; i < PROGRAM_LEN; i++) riscv_compile_instruction(compiler, program[i]);
+    size_t gates_before = compiler->circuit->num_gates;
+    size_t ands_before = riscv_circuit_count_and_gates(compiler->circuit);
+
+    uint64_t seed = 0xA11D;
+    uint32_t inputs[TRIALS][32];
+    uint32_t expected[TRIALS][32];
+    uint8_t* values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS; t++) {
+        inputs[t][0] = 0;
+        for (int r = 1; r < 32; r++) inputs[t][r] = (uint32_t)eval_rand64(&seed);
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) expected[t][r] = eval_get_reg(compiler, values, r);
+    }
+    free(values);
+
+    riscv_compiler_set_objective(compiler, OPTIMIZE_AND_COUNT);
+    pass_manager_t* pm = pass_manager_create_preset(3);
+    int rc = pass_manager_run_compiler(pm, compiler);
+    size_t gates_after = compiler->circuit->num_gates;
+    size_t ands_after = riscv_circuit_count_and_gates(compiler->circuit);
+
+    bool ok = rc == 0;
+    values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) {
+            if (eval_get_reg(compiler, values, r) != expected[t][r]) {
+                printf("(x%d differs) ", r);
+                ok = false;
+                break;
+            }
+        }
+    }
+    free(values);
+
+    TEST("-O3 with the AND-count objective keeps every register");
+    ASSERT_TRUE(ok);
+
+    TEST("-O3 with the AND-count objective removes ANDs");
+    printf("(ANDs %zu -> %zu, gates %zu -> %zu) ", ands_before, ands_after,
+           gates_before, gates_after);
+    ASSERT_TRUE(ands_after < ands_before);
+
+    // The report carries AND and total counts around every andmin run
+    FILE* f = tmpfile();
+    pass_manager_write_report(pm, f);
+    long size = ftell(f);
+    rewind(f);
+    char* json = calloc((size_t)size + 1, 1);
+    size_t got = fread(json, 1, (size_t)size, f);
+    fclose(f);
+    const char* andmin = strstr(json, "\"name\": \"andmin\"");
+    long long and_delta = 0;
+    if (andmin) sscanf(strstr(andmin, "\"and_delta\": "), "\"and_delta\": %lld", &and_delta);
+
+    TEST("Report shows andmin's AND and gate counts before and after");
+    ASSERT_TRUE(got == (size_t)size && andmin && and_delta < 0 &&
+                strstr(andmin, "\"and_gates\"") && strstr(andmin, "\"gates\""));
+
+    free(json);
+    pass_manager_destroy(pm);
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("AND-Count Minimization Test Suite\n");
+    printf("=================================\n");
+
+    test_patterns();
+    test_all_3_input_functions();
+    test_4_input_functions();
+    test_compiled_program();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,198 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 64
+
+// R-type / I-type encoders; for I-type the rs2 slot is shamt or the selector
+#define ENC_R(f7, rs2, rs1, f3, rd) \
+    (((uint32_t)(f7) << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x33)
+#define ENC_I(f7, rs2, rs1, f3, rd) \
+    (((uint32_t)(f7) << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x13)
+
+static uint32_t rol32(uint32_t x, uint32_t n) { n &= 31; return n ? (x << n) | (x >> (32 - n)) : x; }
+static uint32_t ror32(uint32_t x, uint32_t n) { n &= 31; return n ? (x >> n) | (x << (32 - n)) : x; }
+
+static uint32_t orc_b(uint32_t x) {
+    uint32_t r = 0;
+    for (int b = 0; b < 4; b++) {
+        if ((x >> (8 * b)) & 0xFF) r |= 0xFFu << (8 * b);
+    }
+    return r;
+}
+
+// Reference semantics for x3 = op(x1, x2)
+typedef uint32_t (*ref_fn_t)(uint32_t a, uint32_t b, uint32_t imm);
+
+static uint32_t ref_sh1add(uint32_t a, uint32_t b, uint32_t i) { (void)i; return (a << 1) + b; }
+static uint32_t ref_sh2add(uint32_t a, uint32_t b, uint32_t i) { (void)i; return (a << 2) + b; }
+static uint32_t ref_sh3add(uint32_t a, uint32_t b, uint32_t i) { (void)i; return (a << 3) + b; }
+static uint32_t ref_andn(uint32_t a, uint32_t b, uint32_t i) { (void)i; return a & ~b; }
+static uint32_t ref_orn(uint32_t a, uint32_t b, uint32_t i) { (void)i; return a | ~b; }
+static uint32_t ref_xnor(uint32_t a, uint32_t b, uint32_t i) { (void)i; return ~(a ^ b); }
+static uint32_t ref_min(uint32_t a, uint32_t b, uint32_t i) { (void)i; return (int32_t)a < (int32_t)b ? a : b; }
+static uint32_t ref_minu(uint32_t a, uint32_t b, uint32_t i) { (void)i; return a < b ? a : b; }
+static uint32_t ref_max(uint32_t a, uint32_t b, uint32_t i) { (void)i; return (int32_t)a < (int32_t)b ? b : a; }
+static uint32_t ref_maxu(uint32_t a, uint32_t b, uint32_t i) { (void)i; return a < b ? b : a; }
+static uint32_t ref_rol(uint32_t a, uint32_t b, uint32_t i) { (void)i; return rol32(a, b); }
+static uint32_t ref_ror(uint32_t a, uint32_t b, uint32_t i) { (void)i; return ror32(a, b); }
+static uint32_t ref_bclr(uint32_t a, uint32_t b, uint32_t i) { (void)i; return a & ~(1u << (b & 31)); }
+static uint32_t ref_bset(uint32_t a, uint32_t b, uint32_t i) { (void)i; return a | (1u << (b & 31)); }
+static uint32_t ref_binv(uint32_t a, uint32_t b, uint32_t i) { (void)i; return a ^ (1u << (b & 31)); }
+static uint32_t ref_bext(uint32_t a, uint32_t b, uint32_t i) { (void)i; return (a >> (b & 31)) & 1; }
+static uint32_t ref_zexth(uint32_t a, uint32_t b, uint32_t i) { (void)b; (void)i; return a & 0xFFFF; }
+static uint32_t ref_clz(uint32_t a, uint32_t b, uint32_t i) { (void)b; (void)i; return a ? (uint32_t)__builtin_clz(a) : 32; }
+static uint32_t ref_ctz(uint32_t a, uint32_t b, uint32_t i) { (void)b; (void)i; return a ? (uint32_t)__builtin_ctz(a) : 32; }
+static uint32_t ref_cpop(uint32_t a, uint32_t b, uint32_t i) { (void)b; (void)i; return (uint32_t)__builtin_popcount(a); }
+static uint32_t ref_sextb(uint32_t a, uint32_t b, uint32_t i) { (void)b; (void)i; return (uint32_t)(int32_t)(int8_t)a; }
+static uint32_t ref_sexth(uint32_t a, uint32_t b, uint32_t i) { (void)b; (void)i; return (uint32_t)(int32_t)(int16_t)a; }
+static uint32_t ref_rori(uint32_t a, uint32_t b, uint32_t i) { (void)b; return ror32(a, i); }
+static uint32_t ref_orcb(uint32_t a, uint32_t b, uint32_t i) { (void)b; (void)i; return orc_b(a); }
+static uint32_t ref_rev8(uint32_t a, uint32_t b, uint32_t i) { (void)b; (void)i; return __builtin_bswap32(a); }
+static uint32_t ref_bclri(uint32_t a, uint32_t b, uint32_t i) { (void)b; return a & ~(1u << i); }
+static uint32_t ref_bseti(uint32_t a, uint32_t b, uint32_t i) { (void)b; return a | (1u << i); }
+static uint32_t ref_binvi(uint32_t a, uint32_t b, uint32_t i) { (void)b; return a ^ (1u << i); }
+static uint32_t ref_bexti(uint32_t a, uint32_t b, uint32_t i) { (void)b; return (a >> i) & 1; }
+
+typedef struct {
+    const char* name;
+    uint32_t instruction;   // Always x3 = op(x1, x2) or x3 = op(x1, imm)
+    ref_fn_t ref;
+    uint32_t imm;
+    size_t max_gates;
+} bitmanip_case_t;
+
+// Compile one instruction and compare against the reference on random state
+static bool check_instruction(const bitmanip_case_t* tc, size_t* gates) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    if (riscv_compile_instruction(compiler, tc->instruction) != 0) {
+        riscv_compiler_destroy(compiler);
+        return false;
+    }
+    *gates = compiler->circuit->num_gates;
+
+    uint8_t* values = eval_alloc(compiler->circuit);
+    uint64_t seed = 0x5EED ^ tc->instruction;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t regs[32] = {0};
+        for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(&seed);
+        if (trial == 0) regs[1] = 0;
+        if (trial == 1) regs[1] = regs[2];
+        if (trial % 4 == 2) regs[1] >>= regs[2] & 31;  // Sparse operands
+
+        eval_load_state(values, 0, regs);
+        eval_run(compiler->circuit, values);
+        uint32_t got = eval_get_reg(compiler, values, 3);
+        uint32_t want = tc->ref(regs[1], regs[2], tc->imm);
+        if (got != want) {
+            printf("(x1=0x%08x x2=0x%08x got 0x%08x want 0x%08x) ", regs[1], regs[2], got, want);
+            ok = false;
+        }
+    }
+
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+static void run_cases(const bitmanip_case_t* cases, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        size_t gates = 0;
+        TEST(cases[i].name);
+        bool ok = check_instruction(&cases[i], &gates);
+        printf("(%zu gates) ", gates);
+        ASSERT_TRUE(ok && gates <= cases[i].max_gates);
+    }
+}
+
+void test_zba(void) {
+    TEST_SUITE("Zba");
+    const bitmanip_case_t cases[] = {
+        {"SH1ADD", ENC_R(0x10, 2, 1, 2, 3), ref_sh1add, 0, 160},
+        {"SH2ADD", ENC_R(0x10, 2, 1, 4, 3), ref_sh2add, 0, 160},
+        {"SH3ADD", ENC_R(0x10, 2, 1, 6, 3), ref_sh3add, 0, 160},
+    };
+    run_cases(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+void test_zbb(void) {
+    TEST_SUITE("Zbb");
+    const bitmanip_case_t cases[] = {
+        {"ANDN",   ENC_R(0x20, 2, 1, 7, 3), ref_andn, 0, 64},
+        {"ORN",    ENC_R(0x20, 2, 1, 6, 3), ref_orn, 0, 96},
+        {"XNOR",   ENC_R(0x20, 2, 1, 4, 3), ref_xnor, 0, 64},
+        {"MIN",    ENC_R(0x05, 2, 1, 4, 3), ref_min, 0, 256},
+        {"MINU",   ENC_R(0x05, 2, 1, 5, 3), ref_minu, 0, 256},
+        {"MAX",    ENC_R(0x05, 2, 1, 6, 3), ref_max, 0, 256},
+        {"MAXU",   ENC_R(0x05, 2, 1, 7, 3), ref_maxu, 0, 256},
+        {"ROL",    ENC_R(0x30, 2, 1, 1, 3), ref_rol, 0, 480},
+        {"ROR",    ENC_R(0x30, 2, 1, 5, 3), ref_ror, 0, 480},
+        {"ZEXT.H (free)", ENC_R(0x04, 0, 1, 4, 3), ref_zexth, 0, 0},
+        {"CLZ",    ENC_I(0x30, 0, 1, 1, 3), ref_clz, 0, 200},
+        {"CTZ",    ENC_I(0x30, 1, 1, 1, 3), ref_ctz, 0, 200},
+        {"CPOP",   ENC_I(0x30, 2, 1, 1, 3), ref_cpop, 0, 200},
+        {"SEXT.B (free)", ENC_I(0x30, 4, 1, 1, 3), ref_sextb, 0, 0},
+        {"SEXT.H (free)", ENC_I(0x30, 5, 1, 1, 3), ref_sexth, 0, 0},
+        {"RORI 7 (free)", ENC_I(0x30, 7, 1, 5, 3), ref_rori, 7, 0},
+        {"ORC.B",  ENC_I(0x14, 7, 1, 5, 3), ref_orcb, 0, 64},
+        {"REV8 (free)", ENC_I(0x34, 0x18, 1, 5, 3), ref_rev8, 0, 0},
+    };
+    run_cases(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+void test_zbs(void) {
+    TEST_SUITE("Zbs");
+    const bitmanip_case_t cases[] = {
+        {"BCLR",   ENC_R(0x24, 2, 1, 1, 3), ref_bclr, 0, 160},
+        {"BSET",   ENC_R(0x14, 2, 1, 1, 3), ref_bset, 0, 192},
+        {"BINV",   ENC_R(0x34, 2, 1, 1, 3), ref_binv, 0, 128},
+        {"BEXT",   ENC_R(0x24, 2, 1, 5, 3), ref_bext, 0, 93},
+        {"BCLRI 13 (free)", ENC_I(0x24, 13, 1, 1, 3), ref_bclri, 13, 0},
+        {"BSETI 31 (free)", ENC_I(0x14, 31, 1, 1, 3), ref_bseti, 31, 0},
+        {"BINVI 0",  ENC_I(0x34, 0, 1, 1, 3), ref_binvi, 0, 1},
+        {"BEXTI 17 (free)", ENC_I(0x24, 17, 1, 5, 3), ref_bexti, 17, 0},
+    };
+    run_cases(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+// The bit-manipulation and M-extension encodings must not be claimed by
+// the base shift decoder
+void test_decoder_boundaries(void) {
+    TEST_SUITE("Decoder Boundaries");
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    TEST("MULH is not decoded as SLL");
+    ASSERT_EQ(-1, compile_shift_instruction(compiler, ENC_R(0x01, 2, 1, 1, 3)));
+    TEST("DIVU is not decoded as SRL");
+    ASSERT_EQ(-1, compile_shift_instruction(compiler, ENC_R(0x01, 2, 1, 5, 3)));
+    TEST("CLZ is not decoded as SLLI");
+    ASSERT_EQ(-1, compile_shift_instruction(compiler, ENC_I(0x30, 0, 1, 1, 3)));
+    TEST("ADD is not decoded as bit-manipulation");
+    ASSERT_EQ(-1, compile_bitmanip_instruction(compiler, ENC_R(0x00, 2, 1, 0, 3)));
+    TEST("Writes to x0 are discarded");
+    ASSERT_EQ(0, riscv_compile_instruction(compiler, ENC_R(0x20, 2, 1, 7, 0)) |
+                 (int)(compiler->reg_wires[0][0] != CONSTANT_0_WIRE));
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("Bit-Manipulation Extension Test Suite\n");
+    printf("=====================================\n");
+
+    test_zba();
+    test_zbb();
+    test_zbs();
+    test_decoder_boundaries();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+// Builds bits x bits -> 2 * bits over x1 and x2; returns the gate count
+static size_t build_product(riscv_compiler_t* compiler, size_t bits, uint32_t* product) {
+    size_t before = compiler->circuit->num_gates;
+    build_booth_multiplier_optimized(compiler->circuit, compiler->reg_wires[1],
+                                     compiler->reg_wires[2], product, bits);
+    return compiler->circuit->num_gates - before;
+}
+
+static uint64_t evaluate(riscv_compiler_t* compiler, uint8_t* values, const uint32_t* product,
+                         size_t bits, uint64_t a, uint64_t b) {
+    eval_set_word(values, compiler->reg_wires[1], a, bits);
+    eval_set_word(values, compiler->reg_wires[2], b, bits);
+    eval_run(compiler->circuit, values);
+    return eval_get_word(values, product, 2 * bits);
+}
+
+// ============================================================================
+// Products
+// ============================================================================
+
+void test_products(void) {
+    TEST_SUITE("Booth Products");
+
+    TEST("Every product of 1- to 9-bit operands is exact");
+    size_t wrong = 0;
+    for (size_t bits = 1; bits <= 9; bits++) {
+        riscv_compiler_t* compiler = riscv_compiler_create();
+        uint32_t product[18];
+        build_product(compiler, bits, product);
+        uint8_t* values = eval_alloc(compiler->circuit);
+        for (uint64_t a = 0; a < (1u << bits); a++) {
+            for (uint64_t b = 0; b < (1u << bits); b++) {
+                wrong += evaluate(compiler, values, product, bits, a, b) != a * b;
+            }
+        }
+        free(values);
+        riscv_compiler_destroy(compiler);
+    }
+    ASSERT_EQ(0, (int)wrong);
+
+    TEST("32-bit products are exact on corners and random operands");
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    uint32_t product[64];
+    size_t gates = build_product(compiler, 32, product);
+    uint8_t* values = eval_alloc(compiler->circuit);
+    static const uint32_t corners[] = {0, 1, 2, 3, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu,
+                                       0xAAAAAAAAu, 0x55555555u};
+    uint64_t seed = 0xB0078;
+    wrong = 0;
+    for (int trial = 0; trial < 2000; trial++) {
+        uint64_t a = (uint32_t)eval_rand64(&seed), b = (uint32_t)eval_rand64(&seed);
+        if (trial < 81) {
+            a = corners[trial % 9];
+            b = corners[trial / 9];
+        }
+        wrong += evaluate(compiler, values, product, 32, a, b) != a * b;
+    }
+    printf("(%zu gates) ", gates);
+    ASSERT_EQ(0, (int)wrong);
+    free(values);
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("Optimized Booth Multiplier Test Suite\n");
+    printf("=====================================\n");
+
+    test_products();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 300
+
+#define ENC_R(f3, rd, rs1, rs2) \
+    (((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x33)
+#define ENC_I(f3, rd, rs1, imm) \
+    ((((uint32_t)(imm) & 0xFFF) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x13)
+
+static uint32_t enc_branch(uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t offset) {
+    uint32_t imm = (uint32_t)offset;
+    return (((imm >> 12) & 1) << 31) | (((imm >> 5) & 0x3F) << 25) | (rs2 << 20) |
+           (rs1 << 15) | (f3 << 12) | (((imm >> 1) & 0xF) << 8) | (((imm >> 11) & 1) << 7) | 0x63;
+}
+
+static bool ref_compare(uint32_t f3, uint32_t a, uint32_t b) {
+    bool result;
+    switch (f3 & 6) {
+        case 0:  result = a == b; break;
+        case 4:  result = (int32_t)a < (int32_t)b; break;
+        default: result = a < b; break;
+    }
+    return (f3 & 1) ? !result : result;
+}
+
+// Operands that share long prefixes, so the low bits decide
+static void random_pair(uint64_t* seed, int trial, uint32_t* a, uint32_t* b) {
+    static const uint32_t corners[] = {0, 1, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu};
+    *a = (uint32_t)eval_rand64(seed);
+    *b = (uint32_t)eval_rand64(seed);
+    if (trial < 25) {
+        *a = corners[trial % 5];
+        *b = corners[trial / 5];
+    } else if (trial % 3 == 0) {
+        *b = *a ^ (1u << (trial % 32));
+    } else if (trial % 3 == 1) {
+        *b = *a;
+    }
+}
+
+// Every branch funct3 through build_compare on free inputs
+static bool check_builder(uint32_t f3, size_t* gates) {
+    riscv_circuit_t* circuit = riscv_circuit_create(66, 1);
+    uint32_t a[32], b[32];
+    for (int i = 0; i < 32; i++) {
+        a[i] = 2 + i;
+        b[i] = 34 + i;
+    }
+    uint32_t out = build_compare(circuit, a, b, 32, f3);
+    *gates = circuit->num_gates;
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 0xC0DE + f3;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t x, y;
+        random_pair(&seed, trial, &x, &y);
+        eval_set_word(values, a, x, 32);
+        eval_set_word(values, b, y, 32);
+        eval_run(circuit, values);
+        if (values[out] != ref_compare(f3, x, y)) {
+            printf("(f3=%u 0x%08x vs 0x%08x) ", f3, x, y);
+            ok = false;
+        }
+    }
+
+    free(values);
+    eval_free_circuit(circuit);
+    return ok;
+}
+
+void test_builders(void) {
+    TEST_SUITE("Comparator Builders");
+
+    static const uint32_t funct3s[] = {0, 1, 4, 5, 6, 7};
+    static const char* names[] = {"EQ", "NE", "LT", "GE", "LTU", "GEU"};
+    size_t gates[6];
+    for (int i = 0; i < 6; i++) {
+        TEST(names[i]);
+        bool ok = check_builder(funct3s[i], &gates[i]);
+        printf("(%zu gates) ", gates[i]);
+        ASSERT_TRUE(ok);
+    }
+
+    TEST("Less-than is a borrow chain of 4 gates per bit");
+    ASSERT_TRUE(gates[2] <= 4 * 32 && gates[4] <= 4 * 32);
+
+    TEST("Signed order costs no more than unsigned");
+    ASSERT_EQ(gates[4], gates[2]);
+
+    TEST("Equality uses one XNOR per bit and an AND tree");
+    ASSERT_TRUE(gates[0] <= 3 * 32);
+}
+
+// Compile a program and check x3 (set-less-than) or the PC (branches)
+static bool check_program(uint32_t instruction, bool check_pc, uint32_t f3, int32_t imm,
+                          bool use_imm, size_t* gates) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    int status = riscv_compile_instruction(compiler, instruction);
+    *gates = compiler->circuit->num_gates;
+    if (status != 0) {
+        riscv_compiler_destroy(compiler);
+        return false;
+    }
+
+    uint8_t* values = eval_alloc(compiler->circuit);
+    uint64_t seed = 0xB4A ^ instruction;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t regs[32] = {0};
+        for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(&seed);
+        random_pair(&seed, trial, &regs[1], &regs[2]);
+        uint32_t pc = (uint32_t)eval_rand64(&seed) & ~3u;
+        eval_load_state(values, pc, regs);
+        eval_run(compiler->circuit, values);
+
+        uint32_t b = use_imm ? (uint32_t)imm : regs[2];
+        bool cond = ref_compare(f3, regs[1], b);
+        uint32_t got, want;
+        if (check_pc) {
+            got = (uint32_t)eval_get_word(values, compiler->pc_wires, 32);
+            want = cond ? pc + (uint32_t)imm : pc + 4;
+        } else {
+            got = eval_get_reg(compiler, values, 3);
+            want = cond;
+        }
+        if (got != want) {
+            printf("(0x%08x vs 0x%08x got 0x%08x want 0x%08x) ", regs[1], b, got, want);
+            ok = false;
+        }
+    }
+
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_set_less_than(void) {
+    TEST_SUITE("SLT / SLTU / SLTI / SLTIU");
+
+    size_t gates = 0;
+    TEST("SLT");
+    bool ok = check_program(ENC_R(2, 3, 1, 2), false, 4, 0, false, &gates);
+    printf("(%zu gates) ", gates);
+    ASSERT_TRUE(ok);
+
+    TEST("SLTU");
+    ASSERT_TRUE(check_program(ENC_R(3, 3, 1, 2), false, 6, 0, false, &gates));
+
+    TEST("SLTI -5");
+    ASSERT_TRUE(check_program(ENC_I(2, 3, 1, -5), false, 4, -5, true, &gates));
+
+    TEST("SLTIU -1 (sign-extended, so x < 0xFFFFFFFF)");
+    ASSERT_TRUE(check_program(ENC_I(3, 3, 1, -1), false, 6, -1, true, &gates));
+
+    TEST("SLTIU 1 (seqz) folds against constants");
+    ok = check_program(ENC_I(3, 3, 1, 1), false, 6, 1, true, &gates);
+    printf("(%zu gates) ", gates);
+    ASSERT_TRUE(ok && gates < 64);
+}
+
+void test_branches(void) {
+    TEST_SUITE("Branches");
+
+    static const uint32_t funct3s[] = {0, 1, 4, 5, 6, 7};
+    static const char* names[] = {"BEQ", "BNE", "BLT", "BGE", "BLTU", "BGEU"};
+    static const int32_t offsets[] = {8, -16, 2048};
+    char name[64];
+
+    for (int i = 0; i < 6; i++) {
+        for (int o = 0; o < 3; o++) {
+            size_t gates = 0;
+            snprintf(name, sizeof(name), "%s x1, x2, %d", names[i], offsets[o]);
+            TEST(name);
+            bool ok = check_program(enc_branch(funct3s[i], 1, 2, offsets[o]), true,
+                                    funct3s[i], offsets[o], false, &gates);
+            if (o == 0) printf("(%zu gates) ", gates);
+            ASSERT_TRUE(ok);
+        }
+    }
+
+    size_t gates = 0;
+    TEST("BEQ under 400 gates");
+    check_program(enc_branch(0, 1, 2, 8), true, 0, 8, false, &gates);
+    ASSERT_TRUE(gates < 400);
+}
+
+int main(void) {
+    printf("Comparator Test Suite\n");
+    printf("=====================\n");
+
+    test_builders();
+    test_set_less_than();
+    test_branches();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 200
+
+#define ENC_M(f3, rd, rs1, rs2) \
+    ((0x01u << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x33)
+#define ENC_ADDI(rd, rs1, imm) \
+    ((((uint32_t)(imm) & 0xFFF) << 20) | ((rs1) << 15) | ((rd) << 7) | 0x13)
+#define ENC_LUI(rd, imm20) (((uint32_t)(imm20) << 12) | ((rd) << 7) | 0x37)
+
+// Build x * constant over a width-bit input and check it against C
+static bool check_constant(uint64_t constant, size_t width, size_t* gates) {
+    riscv_circuit_t* circuit = riscv_circuit_create(width + 2, width);
+    uint32_t x[64], product[64];
+    for (size_t i = 0; i < width; i++) x[i] = 2 + i;
+
+    build_constant_multiplier(circuit, x, width, constant, product);
+    *gates = circuit->num_gates;
+
+    uint64_t mask = width >= 64 ? ~0ULL : ((1ULL << width) - 1);
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 0x5EED ^ constant;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint64_t a = trial < 3 ? (uint64_t[]){0, 1, ~0ULL}[trial] : eval_rand64(&seed);
+        a &= mask;
+        eval_set_word(values, x, a, width);
+        eval_run(circuit, values);
+        uint64_t got = eval_get_word(values, product, width);
+        uint64_t want = (a * constant) & mask;
+        if (got != want) {
+            printf("(0x%llx * 0x%llx got 0x%llx want 0x%llx) ",
+                   (unsigned long long)a, (unsigned long long)constant,
+                   (unsigned long long)got, (unsigned long long)want);
+            ok = false;
+        }
+    }
+
+    free(values);
+    eval_free_circuit(circuit);
+    return ok;
+}
+
+void test_csd_recoding(void) {
+    TEST_SUITE("CSD Recoding");
+
+    int8_t digits[32];
+    TEST("0x7 recodes to 8 - 1");
+    int nonzero = csd_recode(7, 32, digits);
+    ASSERT_TRUE(nonzero == 2 && digits[0] == -1 && digits[3] == 1);
+
+    TEST("0xFFFFFFFF is -1 mod 2^32");
+    ASSERT_EQ(1, csd_recode(0xFFFFFFFFu, 32, digits));
+
+    TEST("No two adjacent non-zero digits");
+    csd_recode(0x9E3779B1u, 32, digits);
+    bool canonical = true;
+    for (int k = 0; k < 31; k++) {
+        if (digits[k] && digits[k + 1]) canonical = false;
+    }
+    ASSERT_TRUE(canonical);
+}
+
+void test_builder(void) {
+    TEST_SUITE("Constant Multiplier Builder");
+
+    static const uint64_t constants[] = {
+        0, 1, 3, 10, 255, 0x10000, 0x9E3779B1u, 0xFFFFFFFFu, 0x80000000u,
+        0xFFFFFFF6u, 0x9E3779B97F4A7C15ULL,
+    };
+    static const size_t widths[] = {32, 64};
+    char name[96];
+
+    for (size_t w = 0; w < 2; w++) {
+        for (size_t c = 0; c < sizeof(constants) / sizeof(constants[0]); c++) {
+            size_t gates = 0;
+            snprintf(name, sizeof(name), "x * 0x%llx (%zu bits)",
+                     (unsigned long long)constants[c], widths[w]);
+            TEST(name);
+            bool ok = check_constant(constants[c], widths[w], &gates);
+            printf("(%zu gates) ", gates);
+            ASSERT_TRUE(ok);
+        }
+    }
+
+    size_t gates = 0;
+    check_constant(1ULL << 7, 32, &gates);
+    TEST("Power of two is pure wiring");
+    ASSERT_EQ(0, gates);
+
+    check_constant(10, 32, &gates);
+    TEST("x * 10 costs a few hundred gates");
+    ASSERT_TRUE(gates < 300);
+}
+
+// Compile a program and check x3 against x1 * constant (or its high half)
+static bool check_program(uint32_t* program, size_t count, uint32_t constant,
+                          uint32_t f3, size_t* gates) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    for (size_t i = 0; i < count; i++) riscv_compile_instruction(compiler, program[i]);
+    *gates = compiler->circuit->num_gates;
+
+    uint8_t* values = eval_alloc(compiler->circuit);
+    uint64_t seed = 0xC0FFEE ^ constant;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t regs[32] = {0};
+        for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(&seed);
+        if (trial == 0) regs[1] = 0x80000000u;
+        eval_load_state(values, 0, regs);
+        eval_run(compiler->circuit, values);
+
+        uint32_t a = regs[1];
+        uint32_t want;
+        switch (f3) {
+            case 0:  want = a * constant; break;
+            case 1:  want = (uint32_t)((uint64_t)((int64_t)(int32_t)a * (int32_t)constant) >> 32); break;
+            default: want = (uint32_t)(((uint64_t)a * constant) >> 32); break;
+        }
+        uint32_t got = eval_get_reg(compiler, values, 3);
+        if (got != want) {
+            printf("(0x%08x * 0x%08x got 0x%08x want 0x%08x) ", a, constant, got, want);
+            ok = false;
+        }
+    }
+
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_instructions(void) {
+    TEST_SUITE("MUL by Loaded Constant");
+
+    size_t gates = 0;
+
+    // li x2, 10 ; mul x3, x1, x2
+    uint32_t mul10[2] = {ENC_ADDI(2, 0, 10), ENC_M(0, 3, 1, 2)};
+    TEST("li + MUL by 10");
+    bool ok = check_program(mul10, 2, 10, 0, &gates);
+    printf("(%zu gates) ", gates);
+    ASSERT_TRUE(ok);
+
+    TEST("MUL by 10 stays under 300 gates");
+    ASSERT_TRUE(gates < 300);
+
+    // li x2, -7 ; mul x3, x2, x1 (constant on the left)
+    uint32_t mulm7[2] = {ENC_ADDI(2, 0, -7), ENC_M(0, 3, 2, 1)};
+    TEST("li + MUL by -7, constant first");
+    ASSERT_TRUE(check_program(mulm7, 2, (uint32_t)-7, 0, &gates));
+
+    // lui x2, 0x9E378 ; addi x2, x2, -1615 (0x9E3779B1) ; mulhu x3, x1, x2
+    uint32_t golden[3] = {ENC_LUI(2, 0x9E378), ENC_ADDI(2, 2, -1615), ENC_M(3, 3, 1, 2)};
+    TEST("lui/addi + MULHU by 0x9E3779B1");
+    ASSERT_TRUE(check_program(golden, 3, 0x9E3779B1u, 3, &gates));
+
+    // lui x2, 0xFFFFF ; mulh x3, x1, x2 (signed -4096)
+    uint32_t high[2] = {ENC_LUI(2, 0xFFFFF), ENC_M(1, 3, 1, 2)};
+    TEST("lui + MULH by -4096");
+    ASSERT_TRUE(check_program(high, 2, 0xFFFFF000u, 1, &gates));
+
+    // li x1, 6 ; li x2, 7 ; mul x3, x1, x2 folds completely
+    uint32_t folded[3] = {ENC_ADDI(1, 0, 6), ENC_ADDI(2, 0, 7), ENC_M(0, 3, 1, 2)};
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    for (int i = 0; i < 3; i++) riscv_compile_instruction(compiler, folded[i]);
+    uint64_t value = 0;
+    TEST("Two constants fold to 42 with no gates");
+    ASSERT_TRUE(compiler->circuit->num_gates == 0 &&
+                wires_to_constant(compiler->reg_wires[3], 32, &value) && value == 42);
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("Constant Multiplier Test Suite\n");
+    printf("==============================\n");
+
+    test_csd_recoding();
+    test_builder();
+    test_instructions();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,301 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "circuit_passes.h"
+#include "npn4_library.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define TRIALS 200
+#define RANDOM_FUNCTIONS 2000
+
+static uint32_t raw_gate(riscv_circuit_t* circuit, uint32_t l, uint32_t r, gate_type_t type) {
+    uint32_t out = riscv_circuit_allocate_wire(circuit);
+    riscv_circuit_add_gate(circuit, l, r, out, type);
+    return out;
+}
+
+static uint32_t raw_or(riscv_circuit_t* circuit, uint32_t x, uint32_t y) {
+    uint32_t t = raw_gate(circuit, x, y, GATE_XOR);
+    return raw_gate(circuit, t, raw_gate(circuit, x, y, GATE_AND), GATE_XOR);
+}
+
+static uint32_t raw_not(riscv_circuit_t* circuit, uint32_t x) {
+    return raw_gate(circuit, x, CONSTANT_1_WIRE, GATE_XOR);
+}
+
+// Truth table of output over the free inputs 2..5
+static uint16_t truth_table(const riscv_circuit_t* circuit, uint32_t output) {
+    uint16_t tt = 0;
+    uint8_t* values = eval_alloc(circuit);
+    for (uint32_t in = 0; in < 16; in++) {
+        for (int i = 0; i < 4; i++) values[2 + i] = (in >> i) & 1;
+        eval_run(circuit, values);
+        tt |= (uint16_t)(values[output] << in);
+    }
+    free(values);
+    return tt;
+}
+
+static int run_passes(riscv_circuit_t* circuit, uint32_t* outputs, size_t n, const char* pass) {
+    pass_manager_t* pm = pass_manager_create();
+    pass_manager_add(pm, pass);
+    pass_manager_add(pm, "fold");
+    pass_manager_add(pm, "dce");
+    int rc = pass_manager_run(pm, circuit, outputs, n);
+    pass_manager_destroy(pm);
+    return rc;
+}
+
+// Evaluates the library circuit of a class member
+static uint16_t impl_tt(const npn4_impl_t* impl) {
+    static const uint16_t vars[4] = {0xAAAA, 0xCCCC, 0xF0F0, 0xFF00};
+    uint16_t sig[5 + NPN4_MAX_GATES];
+    memcpy(sig, vars, sizeof(vars));
+    sig[NPN4_CONST_1] = 0xFFFF;
+    for (size_t k = 0; k < impl->num_gates; k++) {
+        const npn4_gate_t* g = &impl->gates[k];
+        sig[5 + k] = g->type == GATE_AND ? (sig[g->a] & sig[g->b]) : (sig[g->a] ^ sig[g->b]);
+    }
+    return impl->out == NPN4_CONST_0 ? 0 : sig[impl->out];
+}
+
+// True if two gates of impl have the same type and operands
+static bool has_duplicate_gates(const npn4_impl_t* impl) {
+    for (size_t j = 0; j < impl->num_gates; j++) {
+        const npn4_gate_t* a = &impl->gates[j];
+        for (size_t k = j + 1; k < impl->num_gates; k++) {
+            const npn4_gate_t* b = &impl->gates[k];
+            if (a->type == b->type && ((a->a == b->a && a->b == b->b) ||
+                                       (a->a == b->b && a->b == b->a))) return true;
+        }
+    }
+    return false;
+}
+
+void test_library(void) {
+    TEST_SUITE("NPN Library");
+
+    bool all_correct = true;
+    size_t total = 0;
+    for (size_t c = 0; c < NPN4_NUM_CLASSES; c++) {
+        if (impl_tt(&npn4_library[c]) != npn4_library[c].tt) all_correct = false;
+        total += npn4_library[c].num_gates;
+    }
+
+    TEST("Every class circuit computes its member");
+    printf("(%zu gates over %d classes) ", total, NPN4_NUM_CLASSES);
+    ASSERT_TRUE(all_correct);
+
+    bool no_duplicates = true;
+    for (size_t c = 0; c < NPN4_NUM_CLASSES; c++) {
+        if (has_duplicate_gates(&npn4_library[c])) no_duplicates = false;
+    }
+    TEST("No class circuit builds the same gate twice");
+    ASSERT_TRUE(no_duplicates);
+
+    // Every function maps to a class and a transform that reproduces it
+    bool all_matched = true;
+    for (uint32_t tt = 0; tt < 65536 && all_matched; tt++) {
+        npn4_match_t m;
+        npn4_lookup((uint16_t)tt, &m);
+        uint16_t member = m.impl->tt, g = 0;
+        for (int x = 0; x < 16; x++) {
+            int y = 0;
+            for (int i = 0; i < 4; i++) y |= (((x >> m.perm[i]) ^ (m.in_neg >> i)) & 1) << i;
+            g |= (uint16_t)((((member >> y) & 1) ^ m.out_neg) << x);
+        }
+        if (g != tt) all_matched = false;
+    }
+
+    TEST("All 65536 functions match a class");
+    ASSERT_TRUE(all_matched);
+
+    npn4_match_t m;
+    npn4_lookup(0x6996, &m);
+    TEST("4-input parity needs three XORs and no inverter");
+    ASSERT_TRUE(m.impl->num_gates == 3 && m.in_neg == 0 && m.out_neg == 0);
+}
+
+// Random 4-input functions written as an OR of minterms
+void test_random_functions(void) {
+    TEST_SUITE("Random 4-Input Functions");
+
+    uint64_t seed = 0xC075;
+    bool all_correct = true, all_bounded = true;
+    size_t before = 0, after = 0;
+    for (int n = 0; n < RANDOM_FUNCTIONS; n++) {
+        uint16_t fn = (uint16_t)eval_rand64(&seed);
+        riscv_circuit_t* circuit = riscv_circuit_create(6, 1);
+        uint32_t out = CONSTANT_0_WIRE;
+        for (uint32_t m = 0; m < 16; m++) {
+            if (!((fn >> m) & 1)) continue;
+            uint32_t lit[4];
+            for (int i = 0; i < 4; i++) lit[i] = (m >> i) & 1 ? 2u + i : raw_not(circuit, 2u + i);
+            uint32_t term = raw_gate(circuit, raw_gate(circuit, lit[0], lit[1], GATE_AND),
+                                     raw_gate(circuit, lit[2], lit[3], GATE_AND), GATE_AND);
+            out = out == CONSTANT_0_WIRE ? term : raw_or(circuit, out, term);
+        }
+        before += circuit->num_gates;
+
+        if (run_passes(circuit, &out, 1, "rewrite") != 0 || truth_table(circuit, out) != fn) {
+            if (all_correct) printf("(0x%04X wrong) ", fn);
+            all_correct = false;
+        }
+        // At most the library circuit plus its inverters
+        npn4_match_t m;
+        npn4_lookup(fn, &m);
+        size_t bound = m.impl->num_gates + (size_t)__builtin_popcount(m.in_neg) + m.out_neg;
+        if (circuit->num_gates > bound) all_bounded = false;
+        after += circuit->num_gates;
+        eval_free_circuit(circuit);
+    }
+
+    TEST("Rewritten functions keep their truth tables");
+    ASSERT_TRUE(all_correct);
+
+    TEST("Each function ends up no larger than its library circuit");
+    printf("(%zu -> %zu gates) ", before, after);
+    ASSERT_TRUE(all_bounded);
+}
+
+void test_shared_logic(void) {
+    TEST_SUITE("Shared Logic");
+
+    // Full adder with a sum-of-products carry: 4 + 3 ANDs/ORs
+    riscv_circuit_t* circuit = riscv_circuit_create(6, 2);
+    uint32_t a = 2, b = 3, c = 4;
+    uint32_t outputs[2];
+    uint32_t ab = raw_gate(circuit, a, b, GATE_XOR);
+    outputs[0] = raw_gate(circuit, ab, c, GATE_XOR);
+    outputs[1] = raw_or(circuit, raw_or(circuit, raw_gate(circuit, a, b, GATE_AND),
+                                        raw_gate(circuit, a, c, GATE_AND)),
+                        raw_gate(circuit, b, c, GATE_AND));
+    uint16_t sum = truth_table(circuit, outputs[0]), carry = truth_table(circuit, outputs[1]);
+    size_t before = circuit->num_gates;
+    run_passes(circuit, outputs, 2, "rewrite");
+
+    TEST("Full adder carry shrinks, sum is kept");
+    printf("(%zu -> %zu gates) ", before, circuit->num_gates);
+    ASSERT_TRUE(circuit->num_gates <= 6 && truth_table(circuit, outputs[0]) == sum &&
+                truth_table(circuit, outputs[1]) == carry);
+    eval_free_circuit(circuit);
+
+    // Inner gates used elsewhere must survive: (a & b) is an output too
+    circuit = riscv_circuit_create(6, 2);
+    outputs[0] = raw_gate(circuit, a, b, GATE_AND);
+    outputs[1] = raw_or(circuit, outputs[0], raw_gate(circuit, a, c, GATE_AND));
+    uint16_t t0 = truth_table(circuit, outputs[0]), t1 = truth_table(circuit, outputs[1]);
+    run_passes(circuit, outputs, 2, "rewrite");
+
+    TEST("Shared inner gates are kept");
+    ASSERT_TRUE(truth_table(circuit, outputs[0]) == t0 && truth_table(circuit, outputs[1]) == t1 &&
+                circuit->num_gates <= 5);
+    eval_free_circuit(circuit);
+}
+
+static const uint32_t program[] = {
+    0x002081B3,  // add  x3, x1, x2
+    0x40310233,  // sub  x4, x2, x3
+    0x0020A3B3,  // slt  x7, x1, x2
+    0x00239433,  // sll  x8, x7, x2
+    0x0020D4B3,  // srl  x9, x1, x2
+    0x022085B3,  // mul  x11, x1, x2
+};
+#define PROGRAM_LEN (sizeof(program) / sizeof(program[0]))
+
+// -O2 then rewrite on compiled code, under an objective
+static bool check_program(optimization_objective_t objective, size_t* gates, size_t* ands,
+                          size_t* depth) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    riscv_compiler_set_objective(compiler, objective);
+    for (size_t i = 0; i < PROGRAM_LEN; i++) riscv_compile_instruction(compiler, program[i]);
+    pass_manager_t* pm = pass_manager_create_preset(2);
+    pass_manager_run_compiler(pm, compiler);
+    pass_manager_destroy(pm);
+    gates[0] = compiler->circuit->num_gates;
+    ands[0] = riscv_circuit_count_and_gates(compiler->circuit);
+    depth[0] = riscv_circuit_depth(compiler->circuit);
+
+    uint64_t seed = 0x5EED;
+    uint32_t inputs[TRIALS][32];
+    uint32_t expected[TRIALS][32];
+    uint8_t* values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS; t++) {
+        inputs[t][0] = 0;
+        for (int r = 1; r < 32; r++) inputs[t][r] = (uint32_t)eval_rand64(&seed);
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) expected[t][r] = eval_get_reg(compiler, values, r);
+    }
+    free(values);
+
+    pm = pass_manager_create();
+    pass_manager_add(pm, "rewrite");
+    pass_manager_add(pm, "fold");
+    pass_manager_add(pm, "dedup");
+    pass_manager_add(pm, "dce");
+    bool ok = pass_manager_run_compiler(pm, compiler) == 0;
+    pass_manager_destroy(pm);
+    gates[1] = compiler->circuit->num_gates;
+    ands[1] = riscv_circuit_count_and_gates(compiler->circuit);
+    depth[1] = riscv_circuit_depth(compiler->circuit);
+
+    values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) {
+            if (eval_get_reg(compiler, values, r) != expected[t][r]) {
+                printf("(x%d differs) ", r);
+                ok = false;
+                break;
+            }
+        }
+    }
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_compiled_program(void) {
+    TEST_SUITE("Compiled Program");
+
+    size_t gates[2], ands[2], depth[2];
+    TEST("Rewriting -O2 output keeps every register and removes gates");
+    bool ok = check_program(OPTIMIZE_GATES, gates, ands, depth);
+    printf("(%zu -> %zu gates) ", gates[0], gates[1]);
+    ASSERT_TRUE(ok && gates[1] < gates[0]);
+
+    TEST("AND-count objective: no rewrite adds ANDs");
+    ok = check_program(OPTIMIZE_AND_COUNT, gates, ands, depth);
+    printf("(ANDs %zu -> %zu) ", ands[0], ands[1]);
+    ASSERT_TRUE(ok && ands[1] <= ands[0] && gates[1] <= gates[0]);
+
+    TEST("Depth objective: no rewrite adds depth");
+    ok = check_program(OPTIMIZE_DEPTH, gates, ands, depth);
+    printf("(depth %zu -> %zu) ", depth[0], depth[1]);
+    ASSERT_TRUE(ok && depth[1] <= depth[0] && gates[1] <= gates[0]);
+}
+
+int main(void) {
+    printf("Cut Rewriting Test Suite\n");
+    printf("========================\n");
+
+    test_library();
+    test_random_functions();
+    test_shared_logic();
+    test_compiled_program();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
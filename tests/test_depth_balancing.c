@@ -0,0 +1,225 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "circuit_passes.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define TRIALS 200
+
+static uint32_t raw_gate(riscv_circuit_t* circuit, uint32_t l, uint32_t r, gate_type_t type) {
+    uint32_t out = riscv_circuit_allocate_wire(circuit);
+    riscv_circuit_add_gate(circuit, l, r, out, type);
+    return out;
+}
+
+// Linear chain over inputs 2..n+1
+static uint32_t raw_chain(riscv_circuit_t* circuit, size_t n, gate_type_t type) {
+    uint32_t acc = 2;
+    for (size_t i = 1; i < n; i++) acc = raw_gate(circuit, acc, (uint32_t)(2 + i), type);
+    return acc;
+}
+
+static uint64_t eval_outputs(const riscv_circuit_t* circuit, const uint32_t* outputs,
+                             size_t num_outputs, const uint8_t* inputs, size_t num_inputs) {
+    uint8_t* values = eval_alloc(circuit);
+    memcpy(values + 2, inputs, num_inputs);
+    eval_run(circuit, values);
+    uint64_t result = eval_get_word(values, outputs, num_outputs);
+    free(values);
+    return result;
+}
+
+// Runs balance and checks the outputs on random inputs against a copy of
+// the circuit taken before
+static bool balance_keeps_function(riscv_circuit_t* circuit, uint32_t* outputs,
+                                   size_t num_outputs, size_t num_inputs) {
+    riscv_circuit_t* original = riscv_circuit_create(circuit->num_inputs, circuit->num_outputs);
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        const gate_t* g = &circuit->gates[i];
+        riscv_circuit_add_gate(original, g->left_input, g->right_input, g->output, g->type);
+    }
+    original->next_wire_id = circuit->next_wire_id;
+    uint32_t* original_outputs = malloc(num_outputs * sizeof(uint32_t));
+    memcpy(original_outputs, outputs, num_outputs * sizeof(uint32_t));
+
+    pass_manager_t* pm = pass_manager_create();
+    pass_manager_add(pm, "balance");
+    bool ok = pass_manager_run(pm, circuit, outputs, num_outputs) == 0;
+    pass_manager_destroy(pm);
+
+    uint64_t seed = 0xBA1A;
+    uint8_t* inputs = malloc(num_inputs);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        for (size_t i = 0; i < num_inputs; i++) {
+            // Mostly ones so AND chains are not always 0
+            inputs[i] = (eval_rand64(&seed) & 15) != 0;
+        }
+        ok = eval_outputs(circuit, outputs, num_outputs, inputs, num_inputs) ==
+             eval_outputs(original, original_outputs, num_outputs, inputs, num_inputs);
+    }
+
+    free(inputs);
+    free(original_outputs);
+    eval_free_circuit(original);
+    return ok;
+}
+
+void test_chains(void) {
+    TEST_SUITE("Associative Chains");
+
+    riscv_circuit_t* circuit = riscv_circuit_create(34, 1);
+    uint32_t out = raw_chain(circuit, 32, GATE_AND);
+    size_t gates = circuit->num_gates;
+
+    TEST("32-input AND chain is 31 deep");
+    ASSERT_EQ(31, riscv_circuit_depth(circuit));
+
+    TEST("Balanced AND chain keeps its function");
+    ASSERT_TRUE(balance_keeps_function(circuit, &out, 1, 32));
+
+    TEST("Balanced AND chain is 5 deep with the same gate count");
+    ASSERT_TRUE(riscv_circuit_depth(circuit) == 5 && circuit->num_gates == gates);
+    eval_free_circuit(circuit);
+
+    circuit = riscv_circuit_create(66, 1);
+    out = raw_chain(circuit, 64, GATE_XOR);
+    gates = circuit->num_gates;
+
+    TEST("64-input parity chain balances to depth 6");
+    ASSERT_TRUE(balance_keeps_function(circuit, &out, 1, 64) &&
+                riscv_circuit_depth(circuit) == 6 && circuit->num_gates == gates);
+    eval_free_circuit(circuit);
+}
+
+void test_arrival_times(void) {
+    TEST_SUITE("Arrival Times and Sharing");
+
+    // One leaf is a 7-input XOR chain (level 3 once balanced), three more
+    // arrive at level 0: joining the late leaf last gives 4, not 6
+    riscv_circuit_t* circuit = riscv_circuit_create(12, 1);
+    uint32_t late = raw_chain(circuit, 7, GATE_XOR);
+    uint32_t out = raw_gate(circuit, late, 9, GATE_AND);
+    out = raw_gate(circuit, out, 10, GATE_AND);
+    out = raw_gate(circuit, out, 11, GATE_AND);
+
+    TEST("Late leaf is joined last");
+    bool ok = balance_keeps_function(circuit, &out, 1, 10);
+    printf("(depth %zu) ", riscv_circuit_depth(circuit));
+    ASSERT_TRUE(ok && riscv_circuit_depth(circuit) == 4 &&
+                circuit->num_gates == 6 + 3);
+    eval_free_circuit(circuit);
+
+    // A chain whose middle is also an output stays split there
+    circuit = riscv_circuit_create(18, 2);
+    uint32_t outputs[2];
+    outputs[0] = raw_chain(circuit, 8, GATE_XOR);
+    uint32_t acc = outputs[0];
+    for (uint32_t i = 10; i < 18; i++) acc = raw_gate(circuit, acc, i, GATE_XOR);
+    outputs[1] = acc;
+    size_t gates = circuit->num_gates;
+
+    TEST("Shared partial results are kept and both halves balance");
+    ok = balance_keeps_function(circuit, outputs, 2, 16);
+    printf("(depth %zu) ", riscv_circuit_depth(circuit));
+    ASSERT_TRUE(ok && circuit->num_gates == gates && riscv_circuit_depth(circuit) == 4);
+    eval_free_circuit(circuit);
+
+    // Already balanced input: nothing to do
+    circuit = riscv_circuit_create(6, 1);
+    uint32_t ab = raw_gate(circuit, 2, 3, GATE_AND);
+    uint32_t cd = raw_gate(circuit, 4, 5, GATE_AND);
+    out = raw_gate(circuit, ab, cd, GATE_AND);
+    uint32_t* roots[1] = {&out};
+    pass_context_t ctx = {circuit, roots, 1};
+
+    TEST("Balanced trees are reported as unchanged");
+    ASSERT_EQ(0, circuit_pass_balance(&ctx));
+    eval_free_circuit(circuit);
+}
+
+// Compiled code after -O2: balancing never costs gates or correctness
+static const uint32_t program[] = {
+    0x002081B3,  // add  x3, x1, x2
+    0x0041C2B3,  // xor  x5, x3, x4
+    0x0020A3B3,  // slt  x7, x1, x2
+    0x022084B3,  // mul  x9, x1, x2
+};
+#define PROGRAM_LEN (sizeof(program) / sizeof(program[0]))
+
+void test_compiled_program(void) {
+    TEST_SUITE("Compiled Program");
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    for (size_t i = 0; i < PROGRAM_LEN; i++) riscv_compile_instruction(compiler, program[i]);
+
+    pass_manager_t* pm = pass_manager_create_preset(2);
+    pass_manager_run_compiler(pm, compiler);
+    pass_manager_destroy(pm);
+    size_t gates = compiler->circuit->num_gates;
+    size_t depth = riscv_circuit_depth(compiler->circuit);
+
+    uint64_t seed = 0xDE9;
+    uint32_t inputs[TRIALS][32];
+    uint32_t expected[TRIALS][32];
+    uint8_t* values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS; t++) {
+        inputs[t][0] = 0;
+        for (int r = 1; r < 32; r++) inputs[t][r] = (uint32_t)eval_rand64(&seed);
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) expected[t][r] = eval_get_reg(compiler, values, r);
+    }
+    free(values);
+
+    pm = pass_manager_create();
+    pass_manager_add(pm, "balance");
+    bool ok = pass_manager_run_compiler(pm, compiler) == 0;
+    pass_manager_destroy(pm);
+
+    values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) {
+            if (eval_get_reg(compiler, values, r) != expected[t][r]) {
+                printf("(x%d differs) ", r);
+                ok = false;
+                break;
+            }
+        }
+    }
+    free(values);
+
+    TEST("Balancing an -O2 program keeps every register");
+    ASSERT_TRUE(ok);
+
+    TEST("Balancing never adds gates or depth");
+    printf("(depth %zu -> %zu, gates %zu -> %zu) ", depth, riscv_circuit_depth(compiler->circuit),
+           gates, compiler->circuit->num_gates);
+    ASSERT_TRUE(compiler->circuit->num_gates == gates &&
+                riscv_circuit_depth(compiler->circuit) <= depth);
+
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("Depth Balancing Test Suite\n");
+    printf("==========================\n");
+
+    test_chains();
+    test_arrival_times();
+    test_compiled_program();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
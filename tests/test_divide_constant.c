@@ -0,0 +1,140 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 200
+
+#define ENC_M(f3, rd, rs1, rs2) \
+    ((0x01u << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x33)
+#define ENC_ADDI(rd, rs1, imm) \
+    ((((uint32_t)(imm) & 0xFFF) << 20) | ((rs1) << 15) | ((rd) << 7) | 0x13)
+#define ENC_LUI(rd, imm20) ((((uint32_t)(imm20) & 0xFFFFF) << 12) | ((rd) << 7) | 0x37)
+
+enum { F3_DIV = 4, F3_DIVU = 5, F3_REM = 6, F3_REMU = 7 };
+
+static uint32_t ref_div(uint32_t f3, uint32_t a, uint32_t d) {
+    int32_t sa = (int32_t)a, sd = (int32_t)d;
+    switch (f3) {
+        case F3_DIV:
+            if (d == 0) return 0xFFFFFFFF;
+            if (sa == INT32_MIN && sd == -1) return a;
+            return (uint32_t)(sa / sd);
+        case F3_DIVU:
+            return d == 0 ? 0xFFFFFFFF : a / d;
+        case F3_REM:
+            if (d == 0) return a;
+            if (sa == INT32_MIN && sd == -1) return 0;
+            return (uint32_t)(sa % sd);
+        default:
+            return d == 0 ? a : a % d;
+    }
+}
+
+// li x2, d ; <op> x3, x1, x2 -- checked against C on random and corner x1
+static bool check_constant_divisor(uint32_t f3, uint32_t d, size_t* gates) {
+    uint32_t hi = (d + 0x800) >> 12;
+    uint32_t program[3] = {
+        ENC_LUI(2, hi), ENC_ADDI(2, 2, (int32_t)(d - (hi << 12))), ENC_M(f3, 3, 1, 2)
+    };
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    for (int i = 0; i < 3; i++) riscv_compile_instruction(compiler, program[i]);
+    *gates = compiler->circuit->num_gates;
+
+    static const uint32_t corners[] = {0, 1, 0xFFFFFFFFu, 0x80000000u, 0x7FFFFFFFu};
+    uint8_t* values = eval_alloc(compiler->circuit);
+    uint64_t seed = 0xD1D1 ^ ((uint64_t)d << 3) ^ f3;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t regs[32] = {0};
+        for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(&seed);
+        if (trial < 5) regs[1] = corners[trial];
+        else if (trial < 10) regs[1] = d * (uint32_t)(trial - 5) - 1;  // Around multiples
+        eval_load_state(values, 0, regs);
+        eval_run(compiler->circuit, values);
+
+        uint32_t got = eval_get_reg(compiler, values, 3);
+        uint32_t want = ref_div(f3, regs[1], d);
+        if (got != want) {
+            printf("(0x%08x op 0x%08x got 0x%08x want 0x%08x) ", regs[1], d, got, want);
+            ok = false;
+        }
+    }
+
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_constant_divisors(void) {
+    static const uint32_t divisors[] = {
+        0, 1, 2, 3, 7, 10, 16, 641, 1000, 0x7FFFFFFFu, 0x80000000u,
+        0xFFFFFFFFu, (uint32_t)-3, (uint32_t)-7, (uint32_t)-16,
+    };
+    static const char* names[] = {"DIV", "DIVU", "REM", "REMU"};
+    char name[64];
+
+    for (uint32_t f3 = F3_DIV; f3 <= F3_REMU; f3++) {
+        TEST_SUITE(names[f3 - F3_DIV]);
+        for (size_t i = 0; i < sizeof(divisors) / sizeof(divisors[0]); i++) {
+            size_t gates = 0;
+            snprintf(name, sizeof(name), "by %d", (int32_t)divisors[i]);
+            TEST(name);
+            bool ok = check_constant_divisor(f3, divisors[i], &gates);
+            printf("(%zu gates) ", gates);
+            ASSERT_TRUE(ok);
+        }
+    }
+}
+
+void test_costs(void) {
+    TEST_SUITE("Gate Budget");
+
+    size_t gates = 0;
+    check_constant_divisor(F3_DIVU, 16, &gates);
+    TEST("DIVU by a power of two is pure wiring");
+    ASSERT_EQ(0, gates);
+
+    check_constant_divisor(F3_REMU, 16, &gates);
+    TEST("REMU by a power of two is pure wiring");
+    ASSERT_EQ(0, gates);
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    riscv_compile_instruction(compiler, ENC_M(F3_DIVU, 3, 1, 2));
+    size_t general = compiler->circuit->num_gates;
+    riscv_compiler_destroy(compiler);
+
+    check_constant_divisor(F3_DIVU, 10, &gates);
+    TEST("DIVU by 10 is cheaper than the general divider");
+    printf("(%zu vs %zu) ", gates, general);
+    ASSERT_TRUE(gates * 3 < general * 2);
+
+    compiler = riscv_compiler_create();
+    uint32_t folded[3] = {ENC_ADDI(1, 0, -100), ENC_ADDI(2, 0, 7), ENC_M(F3_REM, 3, 1, 2)};
+    for (int i = 0; i < 3; i++) riscv_compile_instruction(compiler, folded[i]);
+    uint64_t value = 0;
+    TEST("Constant operands fold: -100 % 7 == -2");
+    ASSERT_TRUE(compiler->circuit->num_gates == 0 &&
+                wires_to_constant(compiler->reg_wires[3], 32, &value) &&
+                (uint32_t)value == (uint32_t)-2);
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("Division by Constant Test Suite\n");
+    printf("===============================\n");
+
+    test_constant_divisors();
+    test_costs();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
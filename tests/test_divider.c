@@ -0,0 +1,166 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 300
+
+#define ENC_M(f3, rd, rs1, rs2) \
+    ((0x01u << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x33)
+
+enum { F3_DIV = 4, F3_DIVU = 5, F3_REM = 6, F3_REMU = 7 };
+
+static uint32_t ref_div(uint32_t f3, uint32_t a, uint32_t d) {
+    int32_t sa = (int32_t)a, sd = (int32_t)d;
+    switch (f3) {
+        case F3_DIV:
+            if (d == 0) return 0xFFFFFFFF;
+            if (sa == INT32_MIN && sd == -1) return a;
+            return (uint32_t)(sa / sd);
+        case F3_DIVU:
+            return d == 0 ? 0xFFFFFFFF : a / d;
+        case F3_REM:
+            if (d == 0) return a;
+            if (sa == INT32_MIN && sd == -1) return 0;
+            return (uint32_t)(sa % sd);
+        default:
+            return d == 0 ? a : a % d;
+    }
+}
+
+// Random registers: corner pairs first, then small divisors, then anything
+static void random_regs(uint32_t regs[32], int trial, uint64_t* seed) {
+    static const uint32_t corners[] = {0, 1, 0xFFFFFFFFu, 0x80000000u, 0x7FFFFFFFu, 7};
+    regs[0] = 0;
+    for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(seed);
+    if (trial < 36) {
+        regs[1] = corners[trial % 6];
+        regs[2] = corners[trial / 6];
+    } else if (trial < 150) {
+        regs[2] >>= (trial % 31);
+    }
+}
+
+// Compile a block (fused or not) and check the named destinations
+static bool check_block(uint32_t* program, size_t count, bool fuse,
+                        const int* dest, const uint32_t* dest_f3, size_t num_dest,
+                        size_t* gates) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    if (fuse) {
+        compile_with_fusion(compiler, program, count);
+    } else {
+        for (size_t i = 0; i < count; i++) riscv_compile_instruction(compiler, program[i]);
+    }
+    *gates = compiler->circuit->num_gates;
+
+    uint8_t* values = eval_alloc(compiler->circuit);
+    uint64_t seed = 0x0D1F ^ program[0];
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t regs[32];
+        random_regs(regs, trial, &seed);
+        eval_load_state(values, 0, regs);
+        eval_run(compiler->circuit, values);
+        for (size_t d = 0; d < num_dest; d++) {
+            uint32_t got = eval_get_reg(compiler, values, dest[d]);
+            uint32_t want = ref_div(dest_f3[d], regs[1], regs[2]);
+            if (got != want) {
+                printf("(x%d: 0x%08x / 0x%08x got 0x%08x want 0x%08x) ",
+                       dest[d], regs[1], regs[2], got, want);
+                ok = false;
+            }
+        }
+    }
+
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_single_divisions(void) {
+    TEST_SUITE("M Extension Divisions");
+
+    const char* names[] = {"DIV", "DIVU", "REM", "REMU"};
+    for (uint32_t f3 = F3_DIV; f3 <= F3_REMU; f3++) {
+        uint32_t program[1] = {ENC_M(f3, 3, 1, 2)};
+        int dest[1] = {3};
+        size_t gates = 0;
+        TEST(names[f3 - F3_DIV]);
+        bool ok = check_block(program, 1, false, dest, &f3, 1, &gates);
+        printf("(%zu gates) ", gates);
+        ASSERT_TRUE(ok);
+    }
+
+    // The restoring divider needed 26112 gates for DIVU
+    uint32_t divu[1] = {ENC_M(F3_DIVU, 3, 1, 2)};
+    uint32_t divu_f3 = F3_DIVU;
+    int x3 = 3;
+    size_t gates = 0;
+    check_block(divu, 1, false, &x3, &divu_f3, 1, &gates);
+    TEST("DIVU under 8000 gates");
+    ASSERT_TRUE(gates < 8000);
+}
+
+void test_div_rem_fusion(void) {
+    TEST_SUITE("DIV/REM Fusion");
+
+    // divu x3, x1, x2 ; remu x4, x1, x2
+    uint32_t unsigned_pair[2] = {ENC_M(F3_DIVU, 3, 1, 2), ENC_M(F3_REMU, 4, 1, 2)};
+    int dest[2] = {3, 4};
+    uint32_t unsigned_f3[2] = {F3_DIVU, F3_REMU};
+    size_t fused = 0, separate = 0;
+
+    TEST("DIVU + REMU fused");
+    bool ok = check_block(unsigned_pair, 2, true, dest, unsigned_f3, 2, &fused);
+    printf("(%zu gates) ", fused);
+    ASSERT_TRUE(ok);
+
+    check_block(unsigned_pair, 2, false, dest, unsigned_f3, 2, &separate);
+    TEST("Fusion shares the divider");
+    printf("(%zu vs %zu unfused) ", fused, separate);
+    ASSERT_TRUE(fused * 3 < separate * 2);
+
+    // rem x4, x1, x2 ; div x3, x1, x2
+    uint32_t signed_pair[2] = {ENC_M(F3_REM, 4, 1, 2), ENC_M(F3_DIV, 3, 1, 2)};
+    int signed_dest[2] = {4, 3};
+    uint32_t signed_f3[2] = {F3_REM, F3_DIV};
+    TEST("REM + DIV fused");
+    ASSERT_TRUE(check_block(signed_pair, 2, true, signed_dest, signed_f3, 2, &fused));
+
+    // div x3, x1, x2 ; rem x3, x1, x2: last write wins
+    uint32_t same_rd[2] = {ENC_M(F3_DIV, 3, 1, 2), ENC_M(F3_REM, 3, 1, 2)};
+    uint32_t rem_f3 = F3_REM;
+    int x3 = 3;
+    TEST("Shared destination keeps the later result");
+    ASSERT_TRUE(check_block(same_rd, 2, true, &x3, &rem_f3, 1, &fused));
+
+    TEST("First result overwriting a source blocks fusion");
+    ASSERT_FALSE(match_div_pair(ENC_M(F3_DIVU, 2, 1, 2), ENC_M(F3_REMU, 3, 1, 2)));
+
+    TEST("Mixed signedness does not fuse");
+    ASSERT_FALSE(match_div_pair(ENC_M(F3_DIV, 3, 1, 2), ENC_M(F3_REMU, 4, 1, 2)));
+
+    TEST("Two quotients do not fuse");
+    ASSERT_FALSE(match_div_pair(ENC_M(F3_DIV, 3, 1, 2), ENC_M(F3_DIV, 4, 1, 2)));
+
+    TEST("MUL is not a division");
+    ASSERT_FALSE(match_div_pair(ENC_M(0, 3, 1, 2), ENC_M(F3_REM, 4, 1, 2)));
+}
+
+int main(void) {
+    printf("Divider Test Suite\n");
+    printf("==================\n");
+
+    test_single_divisions();
+    test_div_rem_fusion();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
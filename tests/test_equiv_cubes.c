@@ -0,0 +1,256 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "formal_verification.h"
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define ADD_X3   0x002081B3   // add   x3, x1, x2
+#define MUL_X3   0x022081B3   // mul   x3, x1, x2
+#define MUL_SQ   0x021081B3   // mul   x3, x1, x1
+#define MULHU_X3 0x0220B1B3   // mulhu x3, x1, x2
+#define DIVU_X3  0x0220D1B3   // divu  x3, x1, x2
+
+#define X1(bit) (32 + (bit))
+#define X2(bit) (64 + (bit))
+
+typedef struct {
+    size_t calls;
+    size_t last_done;
+} progress_log_t;
+
+static void log_progress(const equiv_cubes_t* cubes, void* ctx) {
+    progress_log_t* log = ctx;
+    log->calls++;
+    log->last_done = cubes->cubes_done;
+}
+
+static equiv_cubes_t* cubes_with(int cube_bits, size_t num_threads) {
+    equiv_cubes_t* cubes = equiv_cubes_create();
+    cubes->cube_bits = cube_bits;
+    cubes->num_threads = num_threads;
+    return cubes;
+}
+
+// Runs the checker's cubes; conflict_limit and fallback_tests as given
+static verification_result_t run_cubes(equivalence_checker_t* checker, equiv_cubes_t* cubes,
+                                       int conflict_limit, size_t fallback_tests) {
+    checker->conflict_limit = conflict_limit;
+    checker->fallback_tests = fallback_tests;
+    return equiv_checker_verify_cubes(checker, cubes);
+}
+
+// A MUL checker whose x3 is the Booth multiplier's product from bit `low`
+static equivalence_checker_t* booth_checker(riscv_instruction_t instruction, int low) {
+    equivalence_checker_t* checker = equiv_checker_create(instruction);
+    riscv_compiler_t* compiler = checker->compiler;
+    uint32_t product[64];
+    build_booth_multiplier_optimized(compiler->circuit, compiler->reg_wires[1],
+                                     compiler->reg_wires[2], product, 32);
+    for (int i = 0; i < 32; i++) compiler->reg_wires[3][i] = product[low + i];
+    return checker;
+}
+
+static size_t proven_bits(const equiv_cubes_t* cubes) {
+    size_t bits = 0;
+    for (int w = 0; w < 32; w++) bits += (size_t)__builtin_popcount(cubes->proven[w]);
+    return bits;
+}
+
+static void swap_x3_bits(equivalence_checker_t* checker, int a, int b) {
+    uint32_t* x3 = checker->compiler->reg_wires[3];
+    uint32_t t = x3[a]; x3[a] = x3[b]; x3[b] = t;
+}
+
+// ============================================================================
+// Splitting
+// ============================================================================
+
+void test_splitting(void) {
+    TEST_SUITE("Splitting");
+
+    TEST("Products split on both operands' low bits, quotients on their high bits");
+    equivalence_checker_t* mul = equiv_checker_create(MUL_X3);
+    equivalence_checker_t* divu = equiv_checker_create(DIVU_X3);
+    equiv_cubes_t* mul_cubes = cubes_with(4, 1);
+    equiv_cubes_t* divu_cubes = cubes_with(4, 1);
+    verification_result_t a = run_cubes(mul, mul_cubes, 10, 16);
+    verification_result_t b = run_cubes(divu, divu_cubes, 10, 16);
+    const int* m = mul_cubes->cube_vars;
+    const int* d = divu_cubes->cube_vars;
+    ASSERT_TRUE(mul_cubes->num_cubes == 16 && m[0] == X1(0) && m[1] == X2(0) &&
+                m[2] == X1(1) && m[3] == X2(1) && d[0] == X1(31) && d[1] == X2(31) &&
+                d[2] == X1(30) && d[3] == X2(30));
+    verification_result_free(&a);
+    verification_result_free(&b);
+    equiv_cubes_destroy(mul_cubes);
+    equiv_cubes_destroy(divu_cubes);
+    equiv_checker_destroy(divu);
+
+    TEST("Pinned cube variables are kept and not picked twice");
+    equiv_cubes_t* cubes = cubes_with(3, 1);
+    cubes->cube_vars[0] = X1(0);
+    cubes->cube_vars[2] = X2(31);
+    verification_result_t result = run_cubes(mul, cubes, 10, 16);
+    ASSERT_TRUE(cubes->cube_vars[0] == X1(0) && cubes->cube_vars[1] == X2(0) &&
+                cubes->cube_vars[2] == X2(31) && cubes->num_cubes == 8);
+    verification_result_free(&result);
+    equiv_cubes_destroy(cubes);
+    equiv_checker_destroy(mul);
+
+    TEST("A register read twice is one operand");
+    equivalence_checker_t* square = equiv_checker_create(MUL_SQ);
+    cubes = cubes_with(3, 1);
+    result = run_cubes(square, cubes, 10, 16);
+    ASSERT_TRUE(cubes->cube_vars[0] == X1(0) && cubes->cube_vars[1] == X1(1) &&
+                cubes->cube_vars[2] == X1(2));
+    verification_result_free(&result);
+    equiv_cubes_destroy(cubes);
+    equiv_checker_destroy(square);
+}
+
+// ============================================================================
+// Proofs
+// ============================================================================
+
+void test_proofs(void) {
+    TEST_SUITE("Proofs");
+
+    TEST("Every cube of ADD is proven, which proves ADD");
+    equivalence_checker_t* checker = equiv_checker_create(ADD_X3);
+    equiv_cubes_t* cubes = cubes_with(6, 4);
+    progress_log_t log = {0, 0};
+    cubes->progress = log_progress;
+    cubes->progress_ctx = &log;
+    verification_result_t result = run_cubes(checker, cubes, -1, 0);
+    printf("(%zu solves, %.1f s) ", result.test_cases_checked, cubes->wall_time_ms / 1000.0);
+    ASSERT_TRUE(result.verified && strcmp(result.method, "sat") == 0 &&
+                cubes->num_cubes == 64 && cubes->cubes_proven == 64);
+    verification_result_free(&result);
+
+    TEST("Progress is reported after every cube");
+    ASSERT_TRUE(log.calls == 64 && log.last_done == 64);
+
+    TEST("Every output bit is in the proven mask");
+    ASSERT_TRUE(proven_bits(cubes) == 32 * 32);
+
+    TEST("One thread gives the same proof");
+    equiv_cubes_destroy(cubes);
+    cubes = cubes_with(6, 1);
+    result = run_cubes(checker, cubes, -1, 0);
+    ASSERT_TRUE(result.verified && cubes->cubes_proven == 64);
+    verification_result_free(&result);
+
+    TEST("A wrong circuit is caught in its cube and stops the rest");
+    swap_x3_bits(checker, 5, 6);
+    result = run_cubes(checker, cubes, -1, 0);
+    ASSERT_TRUE(!result.verified && result.counterexample &&
+                strstr(result.counterexample, "x3 is") != NULL &&
+                cubes->cubes_done < cubes->num_cubes);
+    verification_result_free(&result);
+
+    TEST("A refuted proof proves no bits");
+    ASSERT_TRUE(proven_bits(cubes) == 0);
+    equiv_cubes_destroy(cubes);
+    equiv_checker_destroy(checker);
+
+    TEST("Undecided cubes fail the proof without fallback tests");
+    checker = equiv_checker_create(MUL_X3);
+    cubes = cubes_with(2, 2);
+    result = run_cubes(checker, cubes, 100, 0);
+    ASSERT_TRUE(!result.verified && cubes->cubes_undecided == 4 &&
+                strstr(result.counterexample, "4 of 4 cubes undecided") != NULL);
+    verification_result_free(&result);
+
+    TEST("The proven mask leaves out exactly x3's undecided high bits");
+    uint32_t x3 = cubes->proven[3];
+    ASSERT_TRUE(cubes->proven[0] == ~0u && cubes->proven[1] == ~0u && (x3 & 1) &&
+                (x3 & (x3 + 1)) == 0 && proven_bits(cubes) == 32 * 32 - checker->undecided_bits);
+
+    TEST("With fallback tests their undecided bits are simulated");
+    result = run_cubes(checker, cubes, 100, 256);
+    ASSERT_TRUE(verification_result_simulated(&result) &&
+                strcmp(result.method, "sat+simulation") == 0 &&
+                checker->undecided_bits > 0 && checker->undecided_bits < 32 &&
+                proven_bits(cubes) < 32 * 32);
+    verification_result_free(&result);
+
+    TEST("A timeout stops the workers");
+    cubes->timeout_seconds = 1e-9;
+    result = run_cubes(checker, cubes, 100, 256);
+    ASSERT_TRUE(!result.verified && strstr(result.counterexample, "timed out") != NULL);
+    verification_result_free(&result);
+    equiv_cubes_destroy(cubes);
+    equiv_checker_destroy(checker);
+}
+
+// ============================================================================
+// Multipliers and dividers
+// ============================================================================
+
+void test_multipliers_and_dividers(void) {
+    TEST_SUITE("Multipliers and Dividers");
+
+    TEST("Cubes leave fewer MUL bits undecided than one solve");
+    equivalence_checker_t* checker = equiv_checker_create(MUL_X3);
+    equiv_cubes_t* whole = cubes_with(0, 1);
+    equiv_cubes_t* cubes = cubes_with(4, 1);
+    verification_result_t a = run_cubes(checker, whole, 1000, 256);
+    size_t whole_bits = checker->undecided_bits;
+    verification_result_t b = run_cubes(checker, cubes, 1000, 256);
+    printf("(%zu vs %zu bits simulated) ", whole_bits, checker->undecided_bits);
+    ASSERT_TRUE(verification_result_simulated(&a) && verification_result_simulated(&b) &&
+                whole->num_cubes == 1 &&
+                checker->undecided_bits < whole_bits);
+    verification_result_free(&a);
+    verification_result_free(&b);
+    equiv_cubes_destroy(whole);
+    equiv_checker_destroy(checker);
+
+    TEST("build_booth_multiplier_optimized agrees with MUL in every cube");
+    checker = booth_checker(MUL_X3, 0);
+    verification_result_t result = run_cubes(checker, cubes, 1000, 1024);
+    ASSERT_TRUE(verification_result_simulated(&result) &&
+                strcmp(result.method, "sat+simulation") == 0);
+    verification_result_free(&result);
+    equiv_checker_destroy(checker);
+
+    TEST("Its high half agrees with MULHU");
+    checker = booth_checker(MULHU_X3, 32);
+    result = run_cubes(checker, cubes, 1000, 1024);
+    ASSERT_TRUE(verification_result_simulated(&result));
+    verification_result_free(&result);
+
+    TEST("A miswired product bit is caught with a counterexample");
+    swap_x3_bits(checker, 2, 3);
+    result = run_cubes(checker, cubes, 1000, 1024);
+    ASSERT_TRUE(!result.verified && result.counterexample &&
+                strstr(result.counterexample, "x3 is") != NULL);
+    verification_result_free(&result);
+    equiv_checker_destroy(checker);
+
+    TEST("The unsigned divider agrees with DIVU in every cube");
+    checker = equiv_checker_create(DIVU_X3);
+    result = run_cubes(checker, cubes, 500, 1024);
+    ASSERT_TRUE(verification_result_simulated(&result) && cubes->cubes_done == 16);
+    verification_result_free(&result);
+    equiv_cubes_destroy(cubes);
+    equiv_checker_destroy(checker);
+}
+
+int main(void) {
+    printf("Cube-and-Conquer Test Suite\n");
+    printf("===========================\n");
+
+    test_splitting();
+    test_proofs();
+    test_multipliers_and_dividers();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
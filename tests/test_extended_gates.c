@@ -0,0 +1,289 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "gate_primitives.h"
+#include "circuit_passes.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 64
+
+static bool only_and_xor(const riscv_circuit_t* circuit) {
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        if (circuit->gates[i].type != GATE_AND && circuit->gates[i].type != GATE_XOR) return false;
+    }
+    return true;
+}
+
+// Every 3-input function as one LUT, lowered, and through the AND/XOR
+// fallback: all three match the table on all 8 rows
+static bool luts_match(size_t* max_lowered_ands) {
+    bool ok = true;
+    *max_lowered_ands = 0;
+    for (int table = 0; table < 256 && ok; table++) {
+        riscv_circuit_t* native = riscv_circuit_create(5, 1);
+        riscv_circuit_t* basic = riscv_circuit_create(5, 1);
+        native->gate_set = GATE_SET_ALL;
+        uint32_t out = gate_lut3(native, (uint8_t)table, 2, 3, 4);
+        uint32_t basic_out = gate_lut3(basic, (uint8_t)table, 2, 3, 4);
+        ok = native->num_gates <= 1;
+        ok = ok && riscv_circuit_lower(native, 0) >= 0 && only_and_xor(native);
+        *max_lowered_ands = riscv_circuit_count_and_gates(native) > *max_lowered_ands ?
+                            riscv_circuit_count_and_gates(native) : *max_lowered_ands;
+
+        uint8_t* nv = eval_alloc(native);
+        uint8_t* bv = eval_alloc(basic);
+        for (int row = 0; row < 8 && ok; row++) {
+            for (int i = 0; i < 3; i++) nv[2 + i] = bv[2 + i] = (row >> i) & 1;
+            eval_run(native, nv);
+            eval_run(basic, bv);
+            int want = (table >> row) & 1;
+            if (nv[out] != want || bv[basic_out] != want) {
+                printf("(table 0x%02X, row %d) ", table, row);
+                ok = false;
+            }
+        }
+        free(nv);
+        free(bv);
+        eval_free_circuit(native);
+        eval_free_circuit(basic);
+    }
+    return ok;
+}
+
+void test_primitives(void) {
+    TEST_SUITE("Native Primitives");
+
+    riscv_circuit_t* circuit = riscv_circuit_create(5, 1);
+    circuit->gate_set = GATE_SET_ALL;
+    uint32_t x = 2, y = 3, z = 4, carry = z;
+    uint32_t outs[6];
+    outs[0] = gate_not(circuit, x);
+    outs[1] = gate_or(circuit, x, y);
+    outs[2] = gate_xnor(circuit, x, y);
+    outs[3] = gate_mux(circuit, z, x, y);
+    outs[4] = gate_full_add(circuit, x, y, &carry);
+    outs[5] = carry;
+
+    TEST("NOT, OR, XNOR and MUX are one gate, a full adder two");
+    ASSERT_EQ(6, circuit->num_gates);
+
+    TEST("Native gates evaluate to their truth tables");
+    uint8_t* values = eval_alloc(circuit);
+    bool ok = true;
+    for (int row = 0; row < 8; row++) {
+        int a = row & 1, b = (row >> 1) & 1, c = (row >> 2) & 1;
+        values[x] = a;
+        values[y] = b;
+        values[z] = c;
+        eval_run(circuit, values);
+        int want[6] = {!a, a | b, !(a ^ b), c ? a : b, a ^ b ^ c, a + b + c >= 2};
+        for (int i = 0; i < 6; i++) ok = ok && values[outs[i]] == want[i];
+    }
+    ASSERT_TRUE(ok);
+    free(values);
+
+    TEST("Constant inputs still fold to no gate");
+    size_t before = circuit->num_gates;
+    ok = gate_or(circuit, x, CONSTANT_0_WIRE) == x &&
+         gate_mux(circuit, z, CONSTANT_1_WIRE, CONSTANT_0_WIRE) == z &&
+         gate_xnor(circuit, x, CONSTANT_1_WIRE) == x &&
+         gate_lut3(circuit, 0x96, x, y, CONSTANT_0_WIRE) != CONSTANT_0_WIRE;
+    ASSERT_TRUE(ok && circuit->num_gates == before + 1);
+    eval_free_circuit(circuit);
+
+    size_t max_ands;
+    TEST("Every LUT3 matches its table, native, lowered and without LUTs");
+    ok = luts_match(&max_ands);
+    printf("(at most %zu ANDs lowered) ", max_ands);
+    ASSERT_TRUE(ok && max_ands <= 3);
+}
+
+// ============================================================================
+// Instructions
+// ============================================================================
+
+static riscv_compiler_t* compile(const uint32_t* program, size_t count, uint32_t gate_set) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    riscv_compiler_set_gate_set(compiler, gate_set);
+    for (size_t i = 0; i < count; i++) riscv_compile_instruction(compiler, program[i]);
+    return compiler;
+}
+
+// Same registers and PC on random states
+static bool circuits_agree(const riscv_compiler_t* a, const riscv_compiler_t* b) {
+    uint8_t* va = eval_alloc(a->circuit);
+    uint8_t* vb = eval_alloc(b->circuit);
+    uint64_t seed = 0xE17E4D;
+    bool ok = true;
+    for (int t = 0; t < TRIALS && ok; t++) {
+        uint32_t regs[32] = {0}, pc = (uint32_t)eval_rand64(&seed) & ~3u;
+        for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(&seed);
+        if (t & 1) regs[2] = regs[1];  // Taken equality branches
+        eval_load_state(va, pc, regs);
+        eval_load_state(vb, pc, regs);
+        eval_run(a->circuit, va);
+        eval_run(b->circuit, vb);
+        for (int r = 1; r < 32 && ok; r++) ok = eval_get_reg(a, va, r) == eval_get_reg(b, vb, r);
+        ok = ok && eval_get_word(va, a->pc_wires, 32) == eval_get_word(vb, b->pc_wires, 32);
+    }
+    free(va);
+    free(vb);
+    return ok;
+}
+
+// jalr only adds constants, which fold to ANDs either way
+static const struct {
+    const char* name;
+    uint32_t instruction;
+    bool mux_heavy;
+} workloads[] = {
+    {"or",   0x0020E1B3, true},   // or   x3, x1, x2
+    {"add",  0x002081B3, false},  // add  x3, x1, x2
+    {"sltu", 0x0020B1B3, true},   // sltu x3, x1, x2
+    {"beq",  0x00208463, true},   // beq  x1, x2, 8
+    {"bltu", 0x0020E463, true},   // bltu x1, x2, 8
+    {"sll",  0x002091B3, true},   // sll  x3, x1, x2
+    {"sra",  0x4020D1B3, true},   // sra  x3, x1, x2
+    {"jalr", 0x004100E7, false},  // jalr ra, 4(x2)
+    {"mul",  0x022081B3, false},  // mul  x3, x1, x2
+};
+#define NUM_WORKLOADS (sizeof(workloads) / sizeof(workloads[0]))
+
+void test_instructions(void) {
+    TEST_SUITE("Instructions With Extended Gates");
+
+    size_t mux_basic = 0, mux_extended = 0;
+    bool agree = true, lowered_agree = true, no_worse = true;
+    for (size_t i = 0; i < NUM_WORKLOADS; i++) {
+        riscv_compiler_t* basic = compile(&workloads[i].instruction, 1, 0);
+        riscv_compiler_t* extended = compile(&workloads[i].instruction, 1, GATE_SET_ALL);
+        size_t b = basic->circuit->num_gates, e = extended->circuit->num_gates;
+        printf("    %-5s %6zu -> %5zu gates (%.1fx)\n", workloads[i].name, b, e, (double)b / e);
+        if (workloads[i].mux_heavy) {
+            mux_basic += b;
+            mux_extended += e;
+        }
+        no_worse = no_worse && e <= b;
+        agree = agree && circuits_agree(basic, extended);
+
+        lowered_agree = lowered_agree && riscv_circuit_lower(extended->circuit, 0) >= 0 &&
+                        only_and_xor(extended->circuit) && circuits_agree(basic, extended);
+        riscv_compiler_destroy(basic);
+        riscv_compiler_destroy(extended);
+    }
+
+    TEST("Extended circuits compute the same state");
+    ASSERT_TRUE(agree);
+
+    TEST("No workload needs more gates");
+    ASSERT_TRUE(no_worse);
+
+    TEST("OR is a third of the gates");
+    riscv_compiler_t* basic = compile(&workloads[0].instruction, 1, 0);
+    riscv_compiler_t* extended = compile(&workloads[0].instruction, 1, GATE_SET_ALL);
+    ASSERT_EQ(3 * extended->circuit->num_gates, basic->circuit->num_gates);
+    riscv_compiler_destroy(basic);
+    riscv_compiler_destroy(extended);
+
+    TEST("Lowered circuits are AND/XOR only and still agree");
+    ASSERT_TRUE(lowered_agree);
+
+    TEST("OR, shifts and compares need at least 2x fewer gates");
+    printf("(%zu -> %zu) ", mux_basic, mux_extended);
+    ASSERT_TRUE(2 * mux_extended <= mux_basic);
+}
+
+// ============================================================================
+// Passes and export
+// ============================================================================
+
+void test_passes(void) {
+    TEST_SUITE("Passes and Export");
+
+    static const uint32_t program[] = {
+        0x0020E1B3,  // or   x3, x1, x2
+        0x0020E233,  // or   x4, x1, x2 (same as x3)
+        0x00208463,  // beq  x1, x2, 8
+        0x4020D2B3,  // sra  x5, x1, x2
+        0x0041F333,  // and  x6, x3, x4
+    };
+    size_t count = sizeof(program) / sizeof(program[0]);
+    riscv_compiler_t* basic = compile(program, count, 0);
+    riscv_compiler_t* extended = compile(program, count, GATE_SET_ALL);
+
+    TEST("-O3 keeps extended gates and the circuit's function");
+    pass_manager_t* pm = pass_manager_create_preset(3);
+    size_t before = extended->circuit->num_gates;
+    bool ok = pass_manager_run_compiler(pm, extended) == 0 && circuits_agree(basic, extended);
+    printf("(%zu -> %zu gates) ", before, extended->circuit->num_gates);
+    ASSERT_TRUE(ok && extended->circuit->num_gates < before &&
+                !only_and_xor(extended->circuit));
+    pass_manager_destroy(pm);
+
+    TEST("The lower pass clears the gate set, then AIG passes run");
+    pm = pass_manager_create();
+    pass_manager_add(pm, "lower");
+    pass_manager_add(pm, "fold");
+    pass_manager_add(pm, "rewrite");
+    ok = pass_manager_run_compiler(pm, extended) == 0 && extended->circuit->gate_set == 0 &&
+         only_and_xor(extended->circuit) && circuits_agree(basic, extended);
+    ASSERT_TRUE(ok);
+    pass_manager_destroy(pm);
+
+    TEST("Partial lowering keeps the allowed types");
+    riscv_compiler_t* partial = compile(program, count, GATE_SET_ALL);
+    uint32_t keep = GATE_SET_BIT(GATE_OR) | GATE_SET_BIT(GATE_NOT);
+    ok = riscv_circuit_lower(partial->circuit, keep) == 1 && circuits_agree(basic, partial);
+    size_t others = 0;
+    for (size_t i = 0; i < partial->circuit->num_gates; i++) {
+        if (!(GATE_SET_BIT(partial->circuit->gates[i].type) & (keep | GATE_SET_BASIC))) others++;
+    }
+    ASSERT_TRUE(ok && others == 0);
+    riscv_compiler_destroy(partial);
+
+    riscv_compiler_t* fresh = compile(program, count, GATE_SET_ALL);
+    const char* path = "/tmp/test_extended_gates.circuit";
+
+    TEST("gate_computer export refuses extended gates");
+    ASSERT_EQ(-1, riscv_circuit_to_gate_format(fresh->circuit, path));
+
+    TEST("Circuit files name every gate type");
+    ok = riscv_circuit_to_file(fresh->circuit, path) == 0;
+    FILE* f = fopen(path, "r");
+    char line[256];
+    bool mux = false, orr = false;
+    while (ok && f && fgets(line, sizeof(line), f)) {
+        mux = mux || strstr(line, " MUX ") != NULL;
+        orr = orr || strstr(line, " OR") != NULL;
+    }
+    if (f) fclose(f);
+    remove(path);
+    ASSERT_TRUE(ok && mux && orr);
+
+    TEST("Unknown gate types are rejected");
+    ASSERT_EQ(-1, riscv_compiler_set_gate_set(fresh, 1u << GATE_TYPE_COUNT));
+
+    riscv_compiler_destroy(fresh);
+    riscv_compiler_destroy(basic);
+    riscv_compiler_destroy(extended);
+}
+
+int main(void) {
+    printf("Extended Gate Set Test Suite\n");
+    printf("============================\n");
+
+    test_primitives();
+    test_instructions();
+    test_passes();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "formal_verification.h"
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define ADD_X3  0x002081B3   // add  x3, x1, x2
+#define SUB_X3  0x402081B3   // sub  x3, x1, x2
+#define AND_X3  0x0020F1B3   // and  x3, x1, x2
+#define SRA_X3  0x4020D1B3   // sra  x3, x1, x2
+#define MUL_X3  0x022081B3   // mul  x3, x1, x2
+#define DIV_X3  0x0220C1B3   // div  x3, x1, x2
+#define JAL_X1  0x008000EF   // jal  x1, 8
+#define JALR_X3 0x003081E7   // jalr x3, 3(x1)
+#define LW_X3   0x0000A183   // lw   x3, 0(x1)
+
+static bool is_m_extension(riscv_instruction_t instruction) {
+    return (instruction & 0x7F) == 0x33 && (instruction >> 25) == 0x01;
+}
+
+// ============================================================================
+// Reference model
+// ============================================================================
+
+static uint32_t execute(uint32_t instruction, uint32_t a, uint32_t b) {
+    riscv_verification_state_t state = {0};
+    state.regs[1] = a;
+    state.regs[2] = b;
+    reference_execute(instruction, &state);
+    return state.regs[3];
+}
+
+void test_reference(void) {
+    TEST_SUITE("Reference Model");
+
+    TEST("Arithmetic wraps and shifts use five bits");
+    ASSERT_TRUE(execute(ADD_X3, 0xFFFFFFFF, 2) == 1 && execute(SUB_X3, 0, 1) == 0xFFFFFFFF &&
+                execute(SRA_X3, 0x80000000, 33) == 0xC0000000);
+
+    TEST("Division follows the spec's corner cases");
+    ASSERT_TRUE(execute(DIV_X3, 7, 0) == 0xFFFFFFFF &&
+                execute(DIV_X3, 0x80000000, 0xFFFFFFFF) == 0x80000000 &&
+                execute(DIV_X3, (uint32_t)-7, 2) == (uint32_t)-3 &&
+                execute(0x0220E1B3, (uint32_t)-7, 2) == (uint32_t)-1 &&           // rem
+                execute(0x022091B3, 0x80000000, 0x80000000) == 0x40000000);       // mulh
+
+    TEST("Jumps link and only jumps move the PC");
+    riscv_verification_state_t state = {0};
+    state.pc = 0x100;
+    state.regs[1] = 0x2000;
+    reference_execute(JALR_X3, &state);
+    bool linked = state.regs[3] == 0x104 && state.pc == 0x2002;
+    reference_execute(ADD_X3, &state);
+    ASSERT_TRUE(linked && state.pc == 0x2002);
+}
+
+// ============================================================================
+// SAT equivalence
+// ============================================================================
+
+void test_equivalence(void) {
+    TEST_SUITE("SAT Equivalence");
+
+    const riscv_instruction_t* forms;
+    size_t count = verification_rv32im_forms(&forms);
+    sat_solver_t* solver = equiv_solver_create();
+
+    TEST("Every RV32I form is proven in one shared solver");
+    size_t proven = 0, failed = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (is_m_extension(forms[i])) continue;
+        equivalence_checker_t* checker = equiv_checker_create_with(solver, NULL, forms[i]);
+        verification_result_t result = equiv_checker_verify(checker);
+        if (result.verified && strcmp(result.method, "sat") == 0) proven++;
+        else {
+            failed++;
+            printf("\n    0x%08X: %s", forms[i], result.counterexample);
+        }
+        verification_result_free(&result);
+        equiv_checker_destroy(checker);
+    }
+    printf("(%zu forms) ", proven);
+    ASSERT_TRUE(failed == 0 && proven > 150);
+
+    TEST("A wrong circuit gives a counterexample");
+    equivalence_checker_t* checker = equiv_checker_create_with(solver, NULL, ADD_X3);
+    uint32_t* x3 = checker->compiler->reg_wires[3];
+    uint32_t t = x3[5]; x3[5] = x3[6]; x3[6] = t;
+    verification_result_t result = equiv_checker_verify(checker);
+    ASSERT_TRUE(!result.verified && result.counterexample &&
+                strstr(result.counterexample, "x3 is") != NULL);
+    verification_result_free(&result);
+    equiv_checker_destroy(checker);
+
+    TEST("A conflict limit leaves MUL's high bits undecided");
+    checker = equiv_checker_create_with(solver, NULL, MUL_X3);
+    checker->conflict_limit = 200;
+    result = equiv_checker_verify(checker);
+    ASSERT_TRUE(!result.verified && result.counterexample &&
+                strstr(result.counterexample, "undecided") != NULL);
+    verification_result_free(&result);
+
+    TEST("...which simulation covers when asked, without calling MUL proven");
+    checker->fallback_tests = 1024;
+    result = equiv_checker_verify(checker);
+    printf("(%zu bits simulated) ", checker->undecided_bits);
+    ASSERT_TRUE(!result.verified && verification_result_simulated(&result) &&
+                strcmp(result.method, "sat+simulation") == 0 &&
+                checker->undecided_bits > 0 && checker->undecided_bits < 32);
+    verification_result_free(&result);
+    equiv_checker_destroy(checker);
+
+    TEST("Loads have no reference");
+    ASSERT_TRUE(equiv_checker_create_with(solver, NULL, LW_X3) == NULL);
+
+    equiv_solver_destroy(solver);
+}
+
+// ============================================================================
+// Properties and bounds
+// ============================================================================
+
+static bool property_holds(property_type_t property, riscv_instruction_t instruction) {
+    property_verifier_t* verifier = property_verifier_create(property);
+    verifier->conflict_limit = 1000;
+    verification_result_t result = property_verify(verifier, instruction);
+    bool holds = result.verified;
+    verification_result_free(&result);
+    property_verifier_destroy(verifier);
+    return holds;
+}
+
+void test_properties(void) {
+    TEST_SUITE("Properties and Bounds");
+
+    TEST("ADD and AND are commutative and associative, SUB is not");
+    ASSERT_TRUE(property_holds(PROP_COMMUTATIVE, ADD_X3) &&
+                property_holds(PROP_ASSOCIATIVE, ADD_X3) &&
+                property_holds(PROP_ASSOCIATIVE, AND_X3) &&
+                !property_holds(PROP_COMMUTATIVE, SUB_X3));
+
+    TEST("Identities, inverses and shift amounts");
+    ASSERT_TRUE(property_holds(PROP_IDENTITY, AND_X3) && property_holds(PROP_INVERSE, ADD_X3) &&
+                property_holds(PROP_INVERSE, SUB_X3) && property_holds(PROP_SHIFT_BOUNDS, SRA_X3));
+
+    TEST("Structural properties hold for every kind of instruction");
+    static const riscv_instruction_t samples[] = {ADD_X3, MUL_X3, JAL_X1, JALR_X3, 0x00208463};
+    bool structural = true;
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        structural = structural && property_holds(PROP_DETERMINISTIC, samples[i]) &&
+                     property_holds(PROP_NO_SIDE_EFFECTS, samples[i]) &&
+                     property_holds(PROP_REGISTER_X0_ZERO, samples[i]);
+    }
+    ASSERT_TRUE(structural);
+
+    TEST("JAL keeps the PC aligned, JALR with an odd offset does not");
+    ASSERT_TRUE(property_holds(PROP_PC_ALIGNMENT, JAL_X1) &&
+                !property_holds(PROP_PC_ALIGNMENT, JALR_X3));
+
+    TEST("Bounds reject a circuit deeper than allowed");
+    verification_bounds_t bounds = {
+        .max_input_bits = MAX_INPUT_BITS, .max_output_bits = MAX_OUTPUT_BITS,
+        .max_gates = 100000, .max_depth = 100, .max_memory_bytes = 1 << 20,
+    };
+    bounded_verifier_t* verifier = bounded_verifier_create(&bounds);
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    riscv_compile_instruction(compiler, DIV_X3);
+    verification_result_t result = bounded_verify(verifier, compiler->circuit);
+    ASSERT_TRUE(!result.verified && verifier->actual_depth > 100);
+    verification_result_free(&result);
+    riscv_compiler_destroy(compiler);
+    bounded_verifier_destroy(verifier);
+}
+
+// ============================================================================
+// Differential testing and the pipeline
+// ============================================================================
+
+// A model whose MUL is off by one in the low bit
+static void broken_execute(uint32_t instruction, riscv_verification_state_t* state) {
+    reference_execute(instruction, state);
+    if (instruction == MUL_X3 && state->regs[1] == 0xFFFFFFFF) state->regs[3] ^= 1;
+}
+
+void test_differential(void) {
+    TEST_SUITE("Differential Testing and Pipeline");
+
+    differential_tester_t* tester = differential_tester_create();
+    tester->num_tests = 1024;
+
+    TEST("Compiled MUL and DIV match the reference on edge and random states");
+    verification_result_t mul = differential_verify(tester, MUL_X3);
+    verification_result_t div = differential_verify(tester, DIV_X3);
+    ASSERT_TRUE(mul.verified && div.verified && mul.test_cases_checked > 1024);
+    verification_result_free(&mul);
+    verification_result_free(&div);
+
+    TEST("A disagreeing implementation is reported");
+    tester->impls.execute_spike = broken_execute;
+    verification_result_t result = differential_verify(tester, MUL_X3);
+    ASSERT_TRUE(!result.verified && result.counterexample &&
+                strstr(result.counterexample, "x1=0xFFFFFFFF") != NULL);
+    verification_result_free(&result);
+    differential_tester_destroy(tester);
+
+    TEST("The pipeline finds no counterexample in any RV32IM form");
+    verification_pipeline_t* pipeline = verification_pipeline_create();
+    const riscv_instruction_t* forms;
+    size_t count = verification_rv32im_forms(&forms);
+    result = verify_riscv_compiler(pipeline, NULL);
+    printf("(%zu forms, %zu bits simulated, %.1f s) ", pipeline->instructions_checked,
+           pipeline->undecided_bits, result.verification_time_ms / 1000.0);
+    if (result.counterexample) printf("\n    %s ", result.counterexample);
+    ASSERT_TRUE(verification_result_simulated(&result) &&
+                strcmp(result.method, "pipeline+simulation") == 0 &&
+                pipeline->undecided_bits > 0 && pipeline->instructions_checked == count);
+    verification_result_free(&result);
+
+    TEST("...and runs every layer on one instruction");
+    result = verify_instruction(pipeline, SUB_X3);
+    ASSERT_TRUE(result.verified && pipeline->num_results == 6);
+    verification_result_free(&result);
+    verification_pipeline_destroy(pipeline);
+}
+
+int main(void) {
+    printf("Formal Verification Test Suite\n");
+    printf("==============================\n");
+
+    test_reference();
+    test_equivalence();
+    test_properties();
+    test_differential();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "riscv_memory.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+// 8-bit adder gadget; context counts how often the builder actually runs
+static void adder8_gadget(riscv_circuit_t* circuit, const uint32_t* inputs,
+                          uint32_t* outputs, void* context) {
+    (*(int*)context)++;
+    uint32_t a[8], b[8];
+    for (int i = 0; i < 8; i++) {
+        a[i] = inputs[i];
+        b[i] = inputs[8 + i];
+    }
+    build_ripple_carry_adder(circuit, a, b, outputs, 8);
+}
+
+// Gadget whose outputs include constants and pass-through inputs
+static void passthrough_gadget(riscv_circuit_t* circuit, const uint32_t* inputs,
+                               uint32_t* outputs, void* context) {
+    (void)context;
+    outputs[0] = inputs[1];
+    outputs[1] = CONSTANT_1_WIRE;
+    outputs[2] = riscv_circuit_allocate_wire(circuit);
+    riscv_circuit_add_gate(circuit, inputs[0], CONSTANT_1_WIRE, outputs[2], GATE_XOR);
+}
+
+// Sums three bytes through two nested instances of the 8-bit adder gadget
+static void add3_gadget(riscv_circuit_t* circuit, const uint32_t* inputs,
+                        uint32_t* outputs, void* context) {
+    uint32_t partial[16];
+    gadget_instantiate(circuit, "test_adder8", 16, 8, adder8_gadget, context, inputs, partial);
+    for (int i = 0; i < 8; i++) partial[8 + i] = inputs[16 + i];
+    gadget_instantiate(circuit, "test_adder8", 16, 8, adder8_gadget, context, partial, outputs);
+}
+
+void test_adder_template(void) {
+    TEST_SUITE("Template Instancing");
+
+    int builds = 0;
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 48, 0);
+    uint32_t x[16], y[16], z[16], sum1[8], sum2[8];
+    for (int i = 0; i < 16; i++) {
+        x[i] = 2 + i;
+        y[i] = 18 + i;
+        z[i] = 34 + i;
+    }
+
+    // Chain two instances, the second consuming the first's outputs
+    int status = gadget_instantiate(circuit, "test_adder8", 16, 8,
+                                    adder8_gadget, &builds, x, sum1);
+    uint32_t chained[16];
+    for (int i = 0; i < 8; i++) {
+        chained[i] = sum1[i];
+        chained[8 + i] = y[i];
+    }
+    status |= gadget_instantiate(circuit, "test_adder8", 16, 8,
+                                 adder8_gadget, &builds, chained, sum2);
+
+    TEST("Instantiation succeeds");
+    ASSERT_EQ(0, status);
+
+    TEST("Builder runs once per process");
+    ASSERT_EQ(1, builds);
+
+    gadget_template_t* tmpl = gadget_template_lookup("test_adder8");
+    TEST("Lookup finds registered template");
+    ASSERT_TRUE(tmpl != NULL);
+
+    TEST("Instances copy the template gate count");
+    ASSERT_EQ(2 * gadget_template_num_gates(tmpl), circuit->num_gates);
+
+    TEST("Mismatched ports are rejected");
+    ASSERT_EQ(-1, gadget_instantiate(circuit, "test_adder8", 15, 8,
+                                     adder8_gadget, &builds, z, sum2));
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 777;
+    bool ok = true;
+    for (int trial = 0; trial < 100; trial++) {
+        uint8_t a = (uint8_t)eval_rand64(&seed);
+        uint8_t b = (uint8_t)eval_rand64(&seed);
+        uint8_t c = (uint8_t)eval_rand64(&seed);
+        eval_set_word(values, x, a, 8);
+        eval_set_word(values, x + 8, b, 8);
+        eval_set_word(values, y, c, 8);
+        eval_run(circuit, values);
+        if (eval_get_word(values, sum1, 8) != (uint8_t)(a + b)) ok = false;
+        if (eval_get_word(values, sum2, 8) != (uint8_t)(a + b + c)) ok = false;
+    }
+    free(values);
+
+    TEST("Chained instances evaluate correctly");
+    ASSERT_TRUE(ok);
+
+    // Constants and input ports must survive relocation untouched
+    uint32_t out[3];
+    gadget_instantiate(circuit, "test_passthrough", 2, 3, passthrough_gadget, NULL, z, out);
+    TEST("Pass-through outputs map to bound inputs and constants");
+    ASSERT_TRUE(out[0] == z[1] && out[1] == CONSTANT_1_WIRE);
+
+    values = eval_alloc(circuit);
+    values[z[0]] = 1;
+    eval_run(circuit, values);
+    TEST("Relocated gate reads constant wire");
+    ASSERT_EQ(0, values[out[2]]);
+    free(values);
+
+    eval_free_circuit(circuit);
+}
+
+void test_nested_template(void) {
+    TEST_SUITE("Nested Templates");
+
+    int builds = 0;
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 24, 0);
+    uint32_t in[24], sum[8];
+    for (int i = 0; i < 24; i++) in[i] = 2 + i;
+
+    TEST("A builder may instantiate other gadgets");
+    ASSERT_EQ(0, gadget_instantiate(circuit, "test_add3", 24, 8, add3_gadget, &builds, in, sum));
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 99;
+    bool ok = true;
+    for (int trial = 0; trial < 100; trial++) {
+        uint8_t a = (uint8_t)eval_rand64(&seed);
+        uint8_t b = (uint8_t)eval_rand64(&seed);
+        uint8_t c = (uint8_t)eval_rand64(&seed);
+        eval_set_word(values, in, a, 8);
+        eval_set_word(values, in + 8, b, 8);
+        eval_set_word(values, in + 16, c, 8);
+        eval_run(circuit, values);
+        if (eval_get_word(values, sum, 8) != (uint8_t)(a + b + c)) ok = false;
+    }
+    free(values);
+
+    TEST("Nested instances evaluate correctly");
+    ASSERT_TRUE(ok);
+
+    eval_free_circuit(circuit);
+}
+
+void test_sha3_template(void) {
+    TEST_SUITE("SHA3 Template");
+
+    // Reference: the sponge built directly, no template
+    riscv_circuit_t* direct = riscv_circuit_create(2 + 512, 256);
+    uint32_t in[512], direct_out[256];
+    for (int i = 0; i < 512; i++) in[i] = 2 + i;
+    build_keccak_sponge(direct, in, 64, 136, KECCAK_PADDING_SHA3, direct_out, 256);
+
+    riscv_circuit_t* instanced = riscv_circuit_create(2 + 512, 256);
+    uint32_t inst_out[256];
+    build_sha3_256_circuit(instanced, in, inst_out);
+
+    TEST("Instance has the same gate count as a direct build");
+    ASSERT_EQ(direct->num_gates, instanced->num_gates);
+
+    uint8_t* dv = eval_alloc(direct);
+    uint8_t* iv = eval_alloc(instanced);
+    uint64_t seed = 4242;
+    bool ok = true;
+    for (int trial = 0; trial < 4; trial++) {
+        for (int i = 0; i < 512; i++) {
+            dv[in[i]] = iv[in[i]] = eval_rand64(&seed) & 1;
+        }
+        eval_run(direct, dv);
+        eval_run(instanced, iv);
+        for (int i = 0; i < 256; i++) {
+            if (dv[direct_out[i]] != iv[inst_out[i]]) ok = false;
+        }
+    }
+    free(dv);
+    free(iv);
+
+    TEST("Instance matches direct build on random inputs");
+    ASSERT_TRUE(ok);
+
+    eval_free_circuit(direct);
+    eval_free_circuit(instanced);
+}
+
+int main(void) {
+    printf("Gadget Template Test Suite\n");
+    printf("==========================\n");
+
+    test_adder_template();
+    test_nested_template();
+    test_sha3_template();
+
+    gadget_template_print_stats();
+    gadget_template_clear_all();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
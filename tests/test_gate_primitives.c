@@ -0,0 +1,262 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "gate_primitives.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 300
+
+static size_t count_and_gates(const riscv_circuit_t* circuit) {
+    size_t ands = 0;
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        if (circuit->gates[i].type == GATE_AND) ands++;
+    }
+    return ands;
+}
+
+typedef enum { PRIM_NOT, PRIM_OR, PRIM_MUX, PRIM_FULL_ADD } primitive_t;
+
+// Build one primitive on free inputs x, y, z and check all 8 input rows
+static bool check_truth_table(primitive_t prim, size_t* gates, size_t* ands) {
+    riscv_circuit_t* circuit = riscv_circuit_create(5, 2);
+    uint32_t x = 2, y = 3, z = 4;
+    uint32_t out = CONSTANT_0_WIRE, carry = z;
+
+    switch (prim) {
+        case PRIM_NOT:      out = gate_not(circuit, x); break;
+        case PRIM_OR:       out = gate_or(circuit, x, y); break;
+        case PRIM_MUX:      out = gate_mux(circuit, z, x, y); break;
+        case PRIM_FULL_ADD: out = gate_full_add(circuit, x, y, &carry); break;
+    }
+    *gates = circuit->num_gates;
+    *ands = count_and_gates(circuit);
+
+    uint8_t* values = eval_alloc(circuit);
+    bool ok = true;
+    for (int row = 0; row < 8; row++) {
+        int a = row & 1, b = (row >> 1) & 1, c = (row >> 2) & 1;
+        values[x] = a;
+        values[y] = b;
+        values[z] = c;
+        eval_run(circuit, values);
+
+        int want_out, want_carry = 0;
+        switch (prim) {
+            case PRIM_NOT:      want_out = !a; break;
+            case PRIM_OR:       want_out = a | b; break;
+            case PRIM_MUX:      want_out = c ? a : b; break;
+            default:            want_out = a ^ b ^ c; want_carry = (a + b + c) >= 2; break;
+        }
+        if (values[out] != want_out || (prim == PRIM_FULL_ADD && values[carry] != want_carry)) {
+            printf("(row %d) ", row);
+            ok = false;
+        }
+    }
+
+    free(values);
+    eval_free_circuit(circuit);
+    return ok;
+}
+
+void test_primitives(void) {
+    TEST_SUITE("Primitive Truth Tables and Costs");
+
+    static const struct {
+        primitive_t prim;
+        const char* name;
+        size_t gates, ands;
+    } cases[] = {
+        {PRIM_NOT,      "NOT: 1 gate, no AND",       1, 0},
+        {PRIM_OR,       "OR: 3 gates, 1 AND",        3, 1},
+        {PRIM_MUX,      "MUX: 3 gates, 1 AND",       3, 1},
+        {PRIM_FULL_ADD, "Full adder: 5 gates, 1 AND", 5, 1},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        size_t gates = 0, ands = 0;
+        TEST(cases[i].name);
+        bool ok = check_truth_table(cases[i].prim, &gates, &ands);
+        ASSERT_TRUE(ok && gates == cases[i].gates && ands == cases[i].ands);
+    }
+}
+
+void test_folding(void) {
+    TEST_SUITE("Constant Folding");
+
+    riscv_circuit_t* circuit = riscv_circuit_create(4, 1);
+    uint32_t x = 2, y = 3;
+
+    TEST("x ^ 0, x ^ x, x & 1, x & 0 and x & x are free");
+    ASSERT_TRUE(gate_xor(circuit, x, CONSTANT_0_WIRE) == x &&
+                gate_xor(circuit, x, x) == CONSTANT_0_WIRE &&
+                gate_and(circuit, x, CONSTANT_1_WIRE) == x &&
+                gate_and(circuit, CONSTANT_0_WIRE, x) == CONSTANT_0_WIRE &&
+                gate_and(circuit, x, x) == x && circuit->num_gates == 0);
+
+    TEST("OR with a constant or itself is free");
+    ASSERT_TRUE(gate_or(circuit, x, CONSTANT_1_WIRE) == CONSTANT_1_WIRE &&
+                gate_or(circuit, CONSTANT_0_WIRE, x) == x &&
+                gate_or(circuit, x, x) == x && circuit->num_gates == 0);
+
+    TEST("Mux with a constant select or equal inputs is free");
+    ASSERT_TRUE(gate_mux(circuit, CONSTANT_1_WIRE, x, y) == x &&
+                gate_mux(circuit, CONSTANT_0_WIRE, x, y) == y &&
+                gate_mux(circuit, y, x, x) == x && circuit->num_gates == 0);
+
+    TEST("Mux between 1 and 0 is the select itself");
+    ASSERT_TRUE(gate_mux(circuit, x, CONSTANT_1_WIRE, CONSTANT_0_WIRE) == x &&
+                circuit->num_gates == 0);
+
+    TEST("Mux against constant 0 is a single AND");
+    size_t before = circuit->num_gates;
+    gate_mux(circuit, x, y, CONSTANT_0_WIRE);
+    ASSERT_EQ(1, circuit->num_gates - before);
+
+    TEST("Full adder with zero carry-in is a half adder");
+    uint32_t carry = CONSTANT_0_WIRE;
+    before = circuit->num_gates;
+    gate_full_add(circuit, x, y, &carry);
+    ASSERT_EQ(2, circuit->num_gates - before);
+
+    eval_free_circuit(circuit);
+}
+
+// Balanced AND / OR trees over n free inputs
+static bool check_reduce(bool is_and, size_t n, size_t* gates) {
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + n, 1);
+    uint32_t wires[64];
+    for (size_t i = 0; i < n; i++) wires[i] = 2 + i;
+    uint32_t out = is_and ? gate_and_reduce(circuit, wires, n)
+                          : gate_or_reduce(circuit, wires, n);
+    *gates = circuit->num_gates;
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 0xA11 + n;
+    uint64_t mask = n >= 64 ? ~0ULL : ((1ULL << n) - 1);
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint64_t v = eval_rand64(&seed);
+        if (trial == 0) v = 0;
+        if (trial == 1) v = ~0ULL;
+        if (trial >= 2 && trial < 2 + (int)n) v = ~0ULL ^ (1ULL << (trial - 2));
+        if (!is_and && trial >= 2 && trial < 2 + (int)n) v = 1ULL << (trial - 2);
+        v &= mask;
+        eval_set_word(values, wires, v, n);
+        eval_run(circuit, values);
+        bool want = is_and ? v == mask : v != 0;
+        if (values[out] != want) {
+            printf("(n=%zu v=0x%llx) ", n, (unsigned long long)v);
+            ok = false;
+        }
+    }
+
+    free(values);
+    eval_free_circuit(circuit);
+    return ok;
+}
+
+void test_reductions(void) {
+    TEST_SUITE("AND / OR Reduction Trees");
+
+    size_t gates = 0;
+    TEST("AND of 32 wires");
+    ASSERT_TRUE(check_reduce(true, 32, &gates) && gates == 31);
+
+    TEST("AND of 7 wires (odd count)");
+    ASSERT_TRUE(check_reduce(true, 7, &gates) && gates == 6);
+
+    TEST("OR of 32 wires");
+    ASSERT_TRUE(check_reduce(false, 32, &gates) && gates == 31 * 3);
+
+    riscv_circuit_t* circuit = riscv_circuit_create(2, 1);
+    TEST("Empty reductions give the identity");
+    ASSERT_TRUE(gate_and_reduce(circuit, NULL, 0) == CONSTANT_1_WIRE &&
+                gate_or_reduce(circuit, NULL, 0) == CONSTANT_0_WIRE);
+    eval_free_circuit(circuit);
+}
+
+// The builders that moved onto the primitives: cost and correctness of
+// ADD / SUB / shifts through the full compiler
+static bool check_alu(uint32_t instruction, int op, size_t* gates) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    riscv_compile_instruction(compiler, instruction);
+    *gates = compiler->circuit->num_gates;
+
+    uint8_t* values = eval_alloc(compiler->circuit);
+    uint64_t seed = 0xADD + instruction;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t regs[32] = {0};
+        for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(&seed);
+        if (trial == 0) regs[1] = 0x80000000u;
+        eval_load_state(values, 0, regs);
+        eval_run(compiler->circuit, values);
+
+        uint32_t a = regs[1], b = regs[2], want;
+        switch (op) {
+            case 0:  want = a + b; break;
+            case 1:  want = a - b; break;
+            case 2:  want = a << (b & 31); break;
+            case 3:  want = a >> (b & 31); break;
+            case 4:  want = (uint32_t)((int32_t)a >> (b & 31)); break;
+            case 5:  want = a >> 7; break;
+            default: want = (uint32_t)((int32_t)a >> 7); break;
+        }
+        uint32_t got = eval_get_reg(compiler, values, 3);
+        if (got != want) {
+            printf("(a=0x%08x b=0x%08x got 0x%08x want 0x%08x) ", a, b, got, want);
+            ok = false;
+        }
+    }
+
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_builders(void) {
+    TEST_SUITE("Builders on the Shared Primitives");
+
+    static const struct {
+        const char* name;
+        uint32_t instruction;
+        int op;
+        size_t max_gates;
+    } cases[] = {
+        {"ADD x3, x1, x2",    0x002081B3, 0, 160},
+        {"SUB x3, x1, x2",    0x402081B3, 1, 160},
+        {"SLL x3, x1, x2",    0x002091B3, 2, 480},
+        {"SRL x3, x1, x2",    0x0020D1B3, 3, 480},
+        {"SRA x3, x1, x2",    0x4020D1B3, 4, 480},
+        {"SRLI x3, x1, 7",    0x0070D193, 5, 0},
+        {"SRAI x3, x1, 7",    0x4070D193, 6, 0},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        size_t gates = 0;
+        TEST(cases[i].name);
+        bool ok = check_alu(cases[i].instruction, cases[i].op, &gates);
+        printf("(%zu gates) ", gates);
+        ASSERT_TRUE(ok && gates <= cases[i].max_gates);
+    }
+}
+
+int main(void) {
+    printf("Gate Primitives Test Suite\n");
+    printf("==========================\n");
+
+    test_primitives();
+    test_folding();
+    test_reductions();
+    test_builders();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,263 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "circuit_passes.h"
+#include "gate_primitives.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define TRIALS 50
+
+static riscv_circuit_t* copy_circuit(const riscv_circuit_t* circuit) {
+    riscv_circuit_t* copy = riscv_circuit_create(circuit->num_inputs, circuit->num_outputs);
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        const gate_t* g = &circuit->gates[i];
+        riscv_circuit_add_gate(copy, g->left_input, g->right_input, g->output, g->type);
+    }
+    copy->next_wire_id = circuit->next_wire_id;
+    copy->objective = circuit->objective;
+    return copy;
+}
+
+static uint8_t* eval_inputs(const riscv_circuit_t* circuit, const uint8_t* inputs,
+                            size_t num_inputs) {
+    uint8_t* values = eval_alloc(circuit);
+    memcpy(values + 2, inputs, num_inputs);
+    eval_run(circuit, values);
+    return values;
+}
+
+// Runs one pass and checks every output bit on random inputs against a
+// copy taken before
+static bool pass_keeps_function(const char* pass, riscv_circuit_t* circuit, uint32_t* outputs,
+                                size_t num_outputs, size_t num_inputs) {
+    riscv_circuit_t* original = copy_circuit(circuit);
+    uint32_t* original_outputs = malloc(num_outputs * sizeof(uint32_t));
+    memcpy(original_outputs, outputs, num_outputs * sizeof(uint32_t));
+
+    pass_manager_t* pm = pass_manager_create();
+    pass_manager_add(pm, pass);
+    bool ok = pass_manager_run(pm, circuit, outputs, num_outputs) == 0;
+    pass_manager_destroy(pm);
+
+    uint64_t seed = 0x11AE;
+    uint8_t* inputs = malloc(num_inputs);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        for (size_t i = 0; i < num_inputs; i++) inputs[i] = (uint8_t)(eval_rand64(&seed) & 1);
+        uint8_t* after = eval_inputs(circuit, inputs, num_inputs);
+        uint8_t* before = eval_inputs(original, inputs, num_inputs);
+        for (size_t i = 0; i < num_outputs && ok; i++) {
+            ok = after[outputs[i]] == before[original_outputs[i]];
+        }
+        free(after);
+        free(before);
+    }
+
+    free(inputs);
+    free(original_outputs);
+    eval_free_circuit(original);
+    return ok;
+}
+
+static uint32_t xor_chain(riscv_circuit_t* circuit, const uint32_t* wires, size_t n) {
+    uint32_t acc = wires[0];
+    for (size_t i = 1; i < n; i++) acc = gate_xor(circuit, acc, wires[i]);
+    return acc;
+}
+
+// Keccak theta on a 5x5x8 state with every output XORed from scratch:
+// A[x][y][z] ^ column(x-1, z) ^ column(x+1, z-1), 10 gates per bit
+#define LANE 8
+#define BIT(x, y, z) (2 + ((x) + 5 * (y)) * LANE + (z))
+
+void test_linear_maps(void) {
+    TEST_SUITE("Linear Maps");
+
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 25 * LANE, 25 * LANE);
+    uint32_t outputs[25 * LANE];
+    for (int x = 0; x < 5; x++) {
+        for (int y = 0; y < 5; y++) {
+            for (int z = 0; z < LANE; z++) {
+                uint32_t terms[11];
+                terms[0] = BIT(x, y, z);
+                for (int k = 0; k < 5; k++) {
+                    terms[1 + k] = BIT((x + 4) % 5, k, z);
+                    terms[6 + k] = BIT((x + 1) % 5, k, (z + LANE - 1) % LANE);
+                }
+                outputs[(x + 5 * y) * LANE + z] = xor_chain(circuit, terms, 11);
+            }
+        }
+    }
+    size_t naive = circuit->num_gates;
+    // Column parities, D lanes, one XOR per bit
+    size_t shared = 5 * LANE * 4 + 5 * LANE + 25 * LANE;
+
+    TEST("Naive theta keeps its function");
+    ASSERT_TRUE(pass_keeps_function("linear", circuit, outputs, 25 * LANE, 25 * LANE));
+
+    TEST("Naive theta shrinks to the hand-shared gate count");
+    printf("(gates %zu -> %zu, hand-shared %zu) ", naive, circuit->num_gates, shared);
+    ASSERT_TRUE(circuit->num_gates <= shared);
+    eval_free_circuit(circuit);
+
+    // A random dense 32x32 matrix
+    circuit = riscv_circuit_create(34, 32);
+    uint64_t seed = 0x3A7;
+    uint32_t rows[32];
+    for (int r = 0; r < 32; r++) {
+        uint32_t terms[32];
+        size_t n = 0;
+        uint32_t mask = (uint32_t)eval_rand64(&seed) | 1u << r;
+        for (uint32_t c = 0; c < 32; c++) if (mask >> c & 1) terms[n++] = 2 + c;
+        rows[r] = xor_chain(circuit, terms, n);
+    }
+    naive = circuit->num_gates;
+
+    TEST("Random matrix keeps its function and loses at least a third");
+    bool ok = pass_keeps_function("linear", circuit, rows, 32, 32);
+    printf("(gates %zu -> %zu) ", naive, circuit->num_gates);
+    ASSERT_TRUE(ok && 3 * circuit->num_gates <= 2 * naive);
+    eval_free_circuit(circuit);
+
+    // (a ^ b ^ c) ^ (b ^ c ^ d) = a ^ d
+    circuit = riscv_circuit_create(6, 1);
+    uint32_t abc[3] = {2, 3, 4}, bcd[3] = {3, 4, 5};
+    uint32_t out = gate_xor(circuit, xor_chain(circuit, abc, 3), xor_chain(circuit, bcd, 3));
+
+    TEST("Cancelling terms drop out");
+    ok = pass_keeps_function("linear", circuit, &out, 1, 4);
+    ASSERT_TRUE(ok && circuit->num_gates == 1);
+    eval_free_circuit(circuit);
+}
+
+void test_mixed_logic(void) {
+    TEST_SUITE("XOR Networks Between ANDs");
+
+    // Adders interleave XOR networks with carries: nothing to gain, and
+    // outputs must stay in place
+    riscv_circuit_t* circuit = riscv_circuit_create(66, 32);
+    uint32_t a[32], b[32], sum[32];
+    for (uint32_t i = 0; i < 32; i++) {
+        a[i] = 2 + i;
+        b[i] = 34 + i;
+    }
+    build_ripple_carry_adder(circuit, a, b, sum, 32);
+    size_t gates = circuit->num_gates;
+
+    TEST("Ripple-carry adder keeps its function and size");
+    bool ok = pass_keeps_function("linear", circuit, sum, 32, 64);
+    ASSERT_TRUE(ok && circuit->num_gates <= gates);
+    eval_free_circuit(circuit);
+
+    // One Keccak-f permutation: theta is already hand-shared
+    circuit = riscv_circuit_create(1602, 1600);
+    uint32_t* state = malloc(1600 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < 1600; i++) state[i] = 2 + i;
+    build_keccak_f1600(circuit, state);
+    gates = circuit->num_gates;
+
+    TEST("Keccak-f1600 keeps its function and never grows");
+    ok = pass_keeps_function("linear", circuit, state, 1600, 1600);
+    printf("(gates %zu -> %zu) ", gates, circuit->num_gates);
+    ASSERT_TRUE(ok && circuit->num_gates <= gates);
+    free(state);
+    eval_free_circuit(circuit);
+
+    circuit = riscv_circuit_create(6, 1);
+    uint32_t abc[3] = {2, 3, 4}, bcd[3] = {3, 4, 5};
+    uint32_t out = gate_xor(circuit, xor_chain(circuit, abc, 3), xor_chain(circuit, bcd, 3));
+    circuit->objective = OPTIMIZE_DEPTH;
+    uint32_t* roots[1] = {&out};
+    pass_context_t ctx = {circuit, roots, 1};
+
+    TEST("The pass is off under OPTIMIZE_DEPTH");
+    ASSERT_EQ(0, circuit_pass_linear(&ctx));
+    eval_free_circuit(circuit);
+}
+
+// XOR chains through registers: x7 = x1 ^ x2 ^ x3 ^ x1 ^ x2 = x3
+static const uint32_t program[] = {
+    0x0020C2B3,  // xor  x5, x1, x2
+    0x0032C333,  // xor  x6, x5, x3
+    0x001343B3,  // xor  x7, x6, x1
+    0x0023C3B3,  // xor  x7, x7, x2
+    0x0020F433,  // and  x8, x1, x2
+    0x008344B3,  // xor  x9, x6, x8
+};
+#define PROGRAM_LEN (sizeof(program) / sizeof(program[0]))
+
+void test_compiled_program(void) {
+    TEST_SUITE("Compiled Program");
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    for (size_t i = 0; i < PROGRAM_LEN; i++) riscv_compile_instruction(compiler, program[i]);
+
+    pass_manager_t* pm = pass_manager_create_preset(2);
+    pass_manager_run_compiler(pm, compiler);
+    pass_manager_destroy(pm);
+    size_t gates = compiler->circuit->num_gates;
+
+    uint64_t seed = 0x11E;
+    uint32_t inputs[TRIALS][32];
+    uint32_t expected[TRIALS][32];
+    uint8_t* values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS; t++) {
+        inputs[t][0] = 0;
+        for (int r = 1; r < 32; r++) inputs[t][r] = (uint32_t)eval_rand64(&seed);
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) expected[t][r] = eval_get_reg(compiler, values, r);
+    }
+    free(values);
+
+    pm = pass_manager_create();
+    pass_manager_add(pm, "linear");
+    bool ok = pass_manager_run_compiler(pm, compiler) == 0;
+    pass_manager_destroy(pm);
+
+    values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) {
+            if (eval_get_reg(compiler, values, r) != expected[t][r]) {
+                printf("(x%d differs) ", r);
+                ok = false;
+                break;
+            }
+        }
+    }
+    free(values);
+
+    TEST("Linear minimization of an -O2 program keeps every register");
+    ASSERT_TRUE(ok);
+
+    TEST("x7 collapses to x3");
+    bool same = true;
+    for (int i = 0; i < 32; i++) same = same && compiler->reg_wires[7][i] == compiler->reg_wires[3][i];
+    printf("(gates %zu -> %zu) ", gates, compiler->circuit->num_gates);
+    ASSERT_TRUE(same && compiler->circuit->num_gates < gates);
+
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("Linear-Layer Minimization Test Suite\n");
+    printf("====================================\n");
+
+    test_linear_maps();
+    test_mixed_logic();
+    test_compiled_program();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "../src/minisat/solver.h"   // before stdbool: it typedefs its own bool
+#include "test_framework.h"
+#include "cnf_fixtures.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+// ============================================================================
+// CNF helpers
+// ============================================================================
+
+static solver* cnf_solver(const cnf_t* cnf, restart_policy restarts, phase_policy phases) {
+    solver* s = solver_new();
+    lit clause[16];
+    s->restart_mode = restarts;
+    s->phase_mode = phases;
+    solver_setnvars(s, cnf->num_vars);
+    for (int c = 0; c < cnf->num_clauses; c++) {
+        int n = cnf->starts[c + 1] - cnf->starts[c];
+        memcpy(clause, cnf->lits + cnf->starts[c], sizeof(lit) * n);   // addclause sorts
+        solver_addclause(s, clause, clause + n);
+    }
+    return s;
+}
+
+static int model_value(const void* s, int v) {
+    return solver_model_value((solver*)s, v);
+}
+
+static bool model_satisfies(solver* s, const cnf_t* cnf) {
+    return cnf_satisfied(cnf, model_value, s);
+}
+
+// ============================================================================
+// Solving
+// ============================================================================
+
+void test_solving(void) {
+    TEST_SUITE("Solving");
+
+    TEST("Pigeonhole 8 into 7 is unsatisfiable, with learnt clauses reduced");
+    cnf_t* cnf = cnf_pigeonhole(8, 7);
+    solver* s = cnf_solver(cnf, restart_glucose, phase_saving);
+    lbool status = solver_solve_limited(s, NULL, NULL, -1);
+    printf("(%d conflicts, %llu reductions) ", solver_nconflicts(s),
+           (unsigned long long)s->stats.reduces);
+    ASSERT_TRUE(status == l_False && s->stats.reduces > 0 && solver_model_value(s, 0) == l_Undef);
+    solver_delete(s);
+    cnf_destroy(cnf);
+
+    TEST("Pigeonhole 7 into 7 has a model that satisfies every clause");
+    cnf = cnf_pigeonhole(7, 7);
+    s = cnf_solver(cnf, restart_glucose, phase_saving);
+    ASSERT_TRUE(solver_solve(s, NULL, NULL) && model_satisfies(s, cnf));
+    solver_delete(s);
+    cnf_destroy(cnf);
+
+    TEST("Planted 3-SAT instances are solved with valid models");
+    bool valid = true;
+    for (uint32_t seed = 1; seed <= 10; seed++) {
+        cnf = cnf_random_3sat(300, 1260, seed, true);
+        s = cnf_solver(cnf, restart_glucose, phase_saving);
+        valid = valid && solver_solve(s, NULL, NULL) && model_satisfies(s, cnf);
+        solver_delete(s);
+        cnf_destroy(cnf);
+    }
+    ASSERT_TRUE(valid);
+
+    TEST("Every restart and phase policy agrees on random instances");
+    int sat = 0, unsat = 0;
+    bool agree = true;
+    for (uint32_t seed = 1; seed <= 12; seed++) {
+        cnf = cnf_random_3sat(120, 511, seed, false);
+        lbool first = l_Undef;
+        for (int r = restart_luby; r <= restart_geometric; r++) {
+            for (int p = phase_saving; p <= phase_random; p++) {
+                s = cnf_solver(cnf, (restart_policy)r, (phase_policy)p);
+                status = solver_solve_limited(s, NULL, NULL, -1);
+                if (first == l_Undef) first = status;
+                agree = agree && status == first && (status == l_False || model_satisfies(s, cnf));
+                solver_delete(s);
+            }
+        }
+        sat += first == l_True;
+        unsat += first == l_False;
+        cnf_destroy(cnf);
+    }
+    printf("(%d sat, %d unsat) ", sat, unsat);
+    ASSERT_TRUE(agree && sat > 0 && unsat > 0);
+}
+
+// ============================================================================
+// Incremental use
+// ============================================================================
+
+void test_incremental(void) {
+    TEST_SUITE("Incremental Use");
+
+    TEST("A failed assumption leaves the clauses satisfiable");
+    solver* s = solver_new();
+    lit c1[2] = {toLit(0), toLit(1)};
+    lit c2[2] = {lit_neg(toLit(0)), toLit(1)};
+    solver_addclause(s, c1, c1 + 2);
+    solver_addclause(s, c2, c2 + 2);
+    lit assume = lit_neg(toLit(1));
+    lbool assumed = solver_solve_limited(s, &assume, &assume + 1, -1);
+    lbool free_run = solver_solve_limited(s, NULL, NULL, -1);
+    ASSERT_TRUE(assumed == l_False && free_run == l_True && solver_model_value(s, 1) == l_True);
+
+    TEST("Blocking clauses enumerate every model of a parity constraint");
+    solver_delete(s);
+    s = solver_new();
+    static const int parity[4][3] = {{0, 0, 1}, {0, 1, 0}, {1, 0, 0}, {1, 1, 1}};   // odd parity
+    for (int c = 0; c < 4; c++) {
+        lit clause[3];   // rules out the even assignment that flips this row
+        for (int v = 0; v < 3; v++) clause[v] = parity[c][v] ? toLit(v) : lit_neg(toLit(v));
+        solver_addclause(s, clause, clause + 3);
+    }
+    int models = 0;
+    while (models < 16 && solver_solve(s, NULL, NULL)) {
+        lit block[3];
+        for (int v = 0; v < 3; v++) {
+            block[v] = solver_model_value(s, v) == l_True ? lit_neg(toLit(v)) : toLit(v);
+        }
+        models++;
+        if (!solver_addclause(s, block, block + 3)) break;
+    }
+    ASSERT_EQ(4, models);
+    solver_delete(s);
+
+    TEST("A conflict budget gives up with l_Undef");
+    cnf_t* cnf = cnf_pigeonhole(10, 9);
+    s = cnf_solver(cnf, restart_glucose, phase_saving);
+    lbool status = solver_solve_limited(s, NULL, NULL, 100);
+    printf("(%d conflicts) ", solver_nconflicts(s));
+    ASSERT_TRUE(status == l_Undef && solver_nconflicts(s) >= 100 &&
+                solver_model_value(s, 0) == l_Undef);
+    solver_delete(s);
+    cnf_destroy(cnf);
+
+    TEST("A top-level contradiction is permanent");
+    s = solver_new();
+    lit x = toLit(0), not_x = lit_neg(toLit(0));
+    bool added = solver_addclause(s, &x, &x + 1);
+    bool contradicted = !solver_addclause(s, &not_x, &not_x + 1);
+    ASSERT_TRUE(added && contradicted && !solver_solve(s, NULL, NULL) &&
+                solver_solve_limited(s, NULL, NULL, -1) == l_False &&
+                solver_model_value(s, 5) == l_Undef);
+    solver_delete(s);
+}
+
+int main(void) {
+    printf("MiniSAT Core Test Suite\n");
+    printf("=======================\n");
+
+    test_solving();
+    test_incremental();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
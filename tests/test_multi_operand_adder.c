@@ -0,0 +1,162 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define MAX_OPERANDS 9
+
+// Build an n-operand adder over fresh input wires and check it against C
+// arithmetic on random vectors
+static bool check_multi_operand_adder(size_t num_operands, size_t width,
+                                      final_adder_t final_adder, size_t* gates) {
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + num_operands * width, width);
+    uint32_t* operands[MAX_OPERANDS];
+    for (size_t i = 0; i < num_operands; i++) {
+        operands[i] = malloc(width * sizeof(uint32_t));
+        for (size_t b = 0; b < width; b++) {
+            operands[i][b] = (uint32_t)(2 + i * width + b);
+        }
+    }
+
+    uint32_t* sum = malloc(width * sizeof(uint32_t));
+    build_multi_operand_adder(circuit, operands, num_operands, width, sum, final_adder);
+    *gates = circuit->num_gates;
+
+    uint64_t mask = width == 64 ? ~0ULL : ((1ULL << width) - 1);
+    uint64_t seed = 0x9E3779B97F4A7C15ULL ^ (num_operands * 131 + width);
+    bool ok = true;
+    uint8_t* values = eval_alloc(circuit);
+
+    for (int trial = 0; trial < 200 && ok; trial++) {
+        uint64_t expected = 0;
+        for (size_t i = 0; i < num_operands; i++) {
+            uint64_t v = eval_rand64(&seed) & mask;
+            if (trial == 0) v = mask;  // All-ones maximises carries
+            eval_set_word(values, operands[i], v, width);
+            expected += v;
+        }
+        eval_run(circuit, values);
+        ok = (eval_get_word(values, sum, width) == (expected & mask));
+    }
+
+    free(values);
+    free(sum);
+    for (size_t i = 0; i < num_operands; i++) free(operands[i]);
+    eval_free_circuit(circuit);
+    return ok;
+}
+
+void test_compressors(void) {
+    TEST_SUITE("Compressors");
+
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 5, 3);
+    uint32_t sum3, carry3;
+    build_compressor_3_2(circuit, 2, 3, 4, &sum3, &carry3);
+
+    TEST("3:2 compressor gate count");
+    ASSERT_EQ(5, circuit->num_gates);
+
+    uint32_t sum4, carry4, cout4;
+    build_compressor_4_2(circuit, 2, 3, 4, 5, 6, &sum4, &carry4, &cout4);
+
+    bool ok3 = true, ok4 = true;
+    uint8_t* values = eval_alloc(circuit);
+    for (int v = 0; v < 32; v++) {
+        for (int i = 0; i < 5; i++) values[2 + i] = (v >> i) & 1;
+        eval_run(circuit, values);
+        int ones3 = (v & 1) + ((v >> 1) & 1) + ((v >> 2) & 1);
+        int ones5 = ones3 + ((v >> 3) & 1) + ((v >> 4) & 1);
+        if (values[sum3] + 2 * values[carry3] != ones3) ok3 = false;
+        if (values[sum4] + 2 * (values[carry4] + values[cout4]) != ones5) ok4 = false;
+    }
+    free(values);
+
+    TEST("3:2 compressor exhaustive");
+    ASSERT_TRUE(ok3);
+    TEST("4:2 compressor exhaustive");
+    ASSERT_TRUE(ok4);
+
+    eval_free_circuit(circuit);
+}
+
+void test_multi_operand_sums(void) {
+    TEST_SUITE("Multi-Operand Adder");
+
+    const final_adder_t adders[] = {
+        FINAL_ADDER_RIPPLE, FINAL_ADDER_KOGGE_STONE, FINAL_ADDER_SPARSE_KOGGE_STONE
+    };
+    const char* names[] = {"ripple", "kogge-stone", "sparse kogge-stone"};
+
+    for (size_t a = 0; a < 3; a++) {
+        for (size_t n = 2; n <= MAX_OPERANDS; n += 3) {
+            for (size_t width = 32; width <= 64; width += 32) {
+                char label[128];
+                size_t gates = 0;
+                snprintf(label, sizeof(label), "%zu x %zu-bit operands, %s",
+                         n, width, names[a]);
+                TEST(label);
+                bool ok = check_multi_operand_adder(n, width, adders[a], &gates);
+                printf("(%zu gates) ", gates);
+                ASSERT_TRUE(ok);
+            }
+        }
+    }
+
+    TEST("3-operand 32-bit ripple beats two chained adders");
+    size_t gates = 0;
+    check_multi_operand_adder(3, 32, FINAL_ADDER_RIPPLE, &gates);
+    printf("(%zu gates) ", gates);
+    ASSERT_TRUE(gates < 2 * 32 * 5);
+}
+
+void test_constant_and_sparse_operands(void) {
+    TEST_SUITE("Constant Operands");
+
+    // x + 5 + 3 + (x << 4): constants fold, shifted zeros are free
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 32, 32);
+    uint32_t x[32], five[32], three[32], shifted[32], sum[32];
+    for (int i = 0; i < 32; i++) {
+        x[i] = 2 + i;
+        five[i] = ((5 >> i) & 1) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+        three[i] = ((3 >> i) & 1) ? CONSTANT_1_WIRE : CONSTANT_0_WIRE;
+        shifted[i] = i >= 4 ? x[i - 4] : CONSTANT_0_WIRE;
+    }
+    uint32_t* operands[4] = {x, five, three, shifted};
+    build_multi_operand_adder(circuit, operands, 4, 32, sum, FINAL_ADDER_RIPPLE);
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 12345;
+    bool ok = true;
+    for (int trial = 0; trial < 200; trial++) {
+        uint32_t v = (uint32_t)eval_rand64(&seed);
+        eval_set_word(values, x, v, 32);
+        eval_run(circuit, values);
+        if ((uint32_t)eval_get_word(values, sum, 32) != v + 8 + (v << 4)) ok = false;
+    }
+    free(values);
+
+    TEST("x + 5 + 3 + (x << 4)");
+    printf("(%zu gates) ", circuit->num_gates);
+    ASSERT_TRUE(ok);
+
+    eval_free_circuit(circuit);
+}
+
+int main(void) {
+    printf("Multi-Operand Adder Test Suite\n");
+    printf("==============================\n");
+
+    test_compressors();
+    test_multi_operand_sums();
+    test_constant_and_sparse_operands();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
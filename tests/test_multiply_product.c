@@ -0,0 +1,150 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 200
+
+#define ENC_M(f3, rd, rs1, rs2) \
+    ((0x01u << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x33)
+
+enum { F3_MUL = 0, F3_MULH = 1, F3_MULHSU = 2, F3_MULHU = 3 };
+
+static uint32_t ref_mul(uint32_t f3, uint32_t a, uint32_t b) {
+    int64_t sa = (int32_t)a, sb = (int32_t)b;
+    switch (f3) {
+        case F3_MUL:    return a * b;
+        case F3_MULH:   return (uint32_t)((uint64_t)(sa * sb) >> 32);
+        case F3_MULHSU: return (uint32_t)((uint64_t)(sa * (int64_t)(uint64_t)b) >> 32);
+        default:        return (uint32_t)(((uint64_t)a * b) >> 32);
+    }
+}
+
+// Random registers, with the sign/magnitude corner cases first
+static void random_regs(uint32_t regs[32], int trial, uint64_t* seed) {
+    static const uint32_t corners[] = {0, 1, 0xFFFFFFFFu, 0x80000000u, 0x7FFFFFFFu};
+    regs[0] = 0;
+    for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(seed);
+    if (trial < 25) {
+        regs[1] = corners[trial % 5];
+        regs[2] = corners[trial / 5];
+    }
+}
+
+// Compile a block (fused or not) and check the named destinations
+static bool check_block(uint32_t* program, size_t count, bool fuse,
+                        const int* dest, const uint32_t* dest_f3, size_t num_dest,
+                        size_t* gates) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    if (fuse) {
+        compile_with_fusion(compiler, program, count);
+    } else {
+        for (size_t i = 0; i < count; i++) riscv_compile_instruction(compiler, program[i]);
+    }
+    *gates = compiler->circuit->num_gates;
+
+    uint8_t* values = eval_alloc(compiler->circuit);
+    uint64_t seed = 0xABCDEF ^ program[0];
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t regs[32];
+        random_regs(regs, trial, &seed);
+        eval_load_state(values, 0, regs);
+        eval_run(compiler->circuit, values);
+        for (size_t d = 0; d < num_dest; d++) {
+            uint32_t got = eval_get_reg(compiler, values, dest[d]);
+            uint32_t want = ref_mul(dest_f3[d], regs[1], regs[2]);
+            if (got != want) {
+                printf("(x%d: 0x%08x * 0x%08x got 0x%08x want 0x%08x) ",
+                       dest[d], regs[1], regs[2], got, want);
+                ok = false;
+            }
+        }
+    }
+
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_single_multiplies(void) {
+    TEST_SUITE("M Extension Multiplies");
+
+    const char* names[] = {"MUL", "MULH", "MULHSU", "MULHU"};
+    size_t low_gates = 0, high_gates = 0;
+    for (uint32_t f3 = 0; f3 < 4; f3++) {
+        uint32_t program[1] = {ENC_M(f3, 3, 1, 2)};
+        int dest[1] = {3};
+        size_t gates = 0;
+        TEST(names[f3]);
+        bool ok = check_block(program, 1, false, dest, &f3, 1, &gates);
+        printf("(%zu gates) ", gates);
+        ASSERT_TRUE(ok);
+        if (f3 == F3_MUL) low_gates = gates;
+        if (f3 == F3_MULHU) high_gates = gates;
+    }
+
+    TEST("MUL builds only the low columns");
+    ASSERT_TRUE(low_gates * 3 < high_gates * 2);
+}
+
+void test_mul_pair_fusion(void) {
+    TEST_SUITE("MUL/MULH Fusion");
+
+    // mulh x4, x1, x2 ; mul x3, x1, x2
+    uint32_t high_low[2] = {ENC_M(F3_MULH, 4, 1, 2), ENC_M(F3_MUL, 3, 1, 2)};
+    int dest[2] = {4, 3};
+    uint32_t dest_f3[2] = {F3_MULH, F3_MUL};
+    size_t fused = 0, separate = 0;
+
+    TEST("MULH + MUL fused");
+    bool ok = check_block(high_low, 2, true, dest, dest_f3, 2, &fused);
+    printf("(%zu gates) ", fused);
+    ASSERT_TRUE(ok);
+
+    check_block(high_low, 2, false, dest, dest_f3, 2, &separate);
+    TEST("Fusion shares the product");
+    printf("(%zu vs %zu unfused) ", fused, separate);
+    ASSERT_TRUE(fused < separate && fused <= separate - separate / 4);
+
+    // mul x3, x1, x2 ; mulhu x4, x1, x2
+    uint32_t low_high[2] = {ENC_M(F3_MUL, 3, 1, 2), ENC_M(F3_MULHU, 4, 1, 2)};
+    uint32_t low_high_f3[2] = {F3_MUL, F3_MULHU};
+    int low_high_dest[2] = {3, 4};
+    TEST("MUL + MULHU fused");
+    ASSERT_TRUE(check_block(low_high, 2, true, low_high_dest, low_high_f3, 2, &fused));
+
+    // mulhsu x3, x1, x2 ; mul x3, x1, x2: last write wins
+    uint32_t same_rd[2] = {ENC_M(F3_MULHSU, 3, 1, 2), ENC_M(F3_MUL, 3, 1, 2)};
+    uint32_t mul_f3 = F3_MUL;
+    int x3 = 3;
+    TEST("Shared destination keeps the later result");
+    ASSERT_TRUE(check_block(same_rd, 2, true, &x3, &mul_f3, 1, &fused));
+
+    TEST("First result overwriting a source blocks fusion");
+    ASSERT_FALSE(match_mul_pair(ENC_M(F3_MULH, 1, 1, 2), ENC_M(F3_MUL, 3, 1, 2)));
+
+    TEST("Different operands do not fuse");
+    ASSERT_FALSE(match_mul_pair(ENC_M(F3_MULH, 4, 1, 2), ENC_M(F3_MUL, 3, 2, 1)));
+
+    TEST("Two high halves do not fuse");
+    ASSERT_FALSE(match_mul_pair(ENC_M(F3_MULH, 4, 1, 2), ENC_M(F3_MULHU, 3, 1, 2)));
+}
+
+int main(void) {
+    printf("Multiplier Test Suite\n");
+    printf("=====================\n");
+
+    test_single_multiplies();
+    test_mul_pair_fusion();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
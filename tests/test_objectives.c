@@ -0,0 +1,180 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 300
+
+#define ENC_R(f7, f3, rd, rs1, rs2) \
+    (((f7) << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x33)
+#define ENC_I(f3, rd, rs1, imm) \
+    ((((uint32_t)(imm) & 0xFFF) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | 0x13)
+
+typedef enum { OP_ADD, OP_SUB, OP_ADDI, OP_SLT, OP_SLTU, OP_SLTI, OP_SLL, OP_SRA,
+               OP_MUL, OP_MULHU } op_t;
+
+static const struct {
+    const char* name;
+    uint32_t instruction;
+    op_t op;
+} cases[] = {
+    {"ADD",   ENC_R(0x00, 0, 3, 1, 2), OP_ADD},
+    {"SUB",   ENC_R(0x20, 0, 3, 1, 2), OP_SUB},
+    {"ADDI",  ENC_I(0, 3, 1, -5),      OP_ADDI},
+    {"SLT",   ENC_R(0x00, 2, 3, 1, 2), OP_SLT},
+    {"SLTU",  ENC_R(0x00, 3, 3, 1, 2), OP_SLTU},
+    {"SLTI",  ENC_I(2, 3, 1, -5),      OP_SLTI},
+    {"SLL",   ENC_R(0x00, 1, 3, 1, 2), OP_SLL},
+    {"SRA",   ENC_R(0x20, 5, 3, 1, 2), OP_SRA},
+    {"MUL",   ENC_R(0x01, 0, 3, 1, 2), OP_MUL},
+    {"MULHU", ENC_R(0x01, 3, 3, 1, 2), OP_MULHU},
+};
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+static uint32_t reference(op_t op, uint32_t a, uint32_t b) {
+    switch (op) {
+        case OP_ADD:   return a + b;
+        case OP_SUB:   return a - b;
+        case OP_ADDI:  return a - 5;
+        case OP_SLT:   return (int32_t)a < (int32_t)b;
+        case OP_SLTU:  return a < b;
+        case OP_SLTI:  return (int32_t)a < -5;
+        case OP_SLL:   return a << (b & 31);
+        case OP_SRA:   return (uint32_t)((int32_t)a >> (b & 31));
+        case OP_MUL:   return a * b;
+        case OP_MULHU: return (uint32_t)(((uint64_t)a * b) >> 32);
+    }
+    return 0;
+}
+
+typedef struct {
+    size_t gates, ands, depth;
+} cost_t;
+
+// Compile one instruction under an objective, measure it and check it
+// against the reference on random and corner operands
+static bool check_case(size_t index, optimization_objective_t objective, cost_t* cost) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    riscv_compiler_set_objective(compiler, objective);
+    riscv_compile_instruction(compiler, cases[index].instruction);
+    cost->gates = compiler->circuit->num_gates;
+    cost->ands = riscv_circuit_count_and_gates(compiler->circuit);
+    cost->depth = riscv_circuit_depth(compiler->circuit);
+
+    static const uint32_t corners[] = {0, 1, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu};
+    uint8_t* values = eval_alloc(compiler->circuit);
+    uint64_t seed = 0x0B1EC7 + index * 3 + objective;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t regs[32] = {0};
+        for (int r = 1; r < 32; r++) regs[r] = (uint32_t)eval_rand64(&seed);
+        if (trial < 25) {
+            regs[1] = corners[trial % 5];
+            regs[2] = corners[trial / 5];
+        } else if (trial % 4 == 0) {
+            regs[2] = regs[1];
+        }
+        eval_load_state(values, 0, regs);
+        eval_run(compiler->circuit, values);
+
+        uint32_t want = reference(cases[index].op, regs[1], regs[2]);
+        uint32_t got = eval_get_reg(compiler, values, 3);
+        if (got != want) {
+            printf("(a=0x%08x b=0x%08x got 0x%08x want 0x%08x) ", regs[1], regs[2], got, want);
+            ok = false;
+        }
+    }
+
+    free(values);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_correctness(void) {
+    static const optimization_objective_t objectives[] = {
+        OPTIMIZE_GATES, OPTIMIZE_AND_COUNT, OPTIMIZE_DEPTH
+    };
+
+    for (size_t o = 0; o < 3; o++) {
+        char suite[64];
+        snprintf(suite, sizeof(suite), "Correctness under objective '%s'",
+                 optimization_objective_name(objectives[o]));
+        TEST_SUITE(suite);
+
+        for (size_t i = 0; i < NUM_CASES; i++) {
+            cost_t cost;
+            TEST(cases[i].name);
+            ASSERT_TRUE(check_case(i, objectives[o], &cost));
+        }
+    }
+}
+
+void test_tradeoffs(void) {
+    TEST_SUITE("Each Objective Wins Its Own Metric");
+
+    for (size_t i = 0; i < NUM_CASES; i++) {
+        cost_t by_gates, by_ands, by_depth;
+        check_case(i, OPTIMIZE_GATES, &by_gates);
+        check_case(i, OPTIMIZE_AND_COUNT, &by_ands);
+        check_case(i, OPTIMIZE_DEPTH, &by_depth);
+
+        char name[96];
+        snprintf(name, sizeof(name), "%s: gates %zu/%zu, ANDs %zu/%zu, depth %zu/%zu",
+                 cases[i].name, by_gates.gates, by_depth.gates,
+                 by_ands.ands, by_depth.ands, by_depth.depth, by_gates.depth);
+        TEST(name);
+        ASSERT_TRUE(by_gates.gates <= by_depth.gates &&
+                    by_ands.ands <= by_gates.ands && by_ands.ands <= by_depth.ands &&
+                    by_depth.depth <= by_gates.depth);
+    }
+
+    // The structures that actually change must buy real depth
+    static const size_t deep[] = {0, 1, 3, 4, 6, 8};
+    for (size_t k = 0; k < sizeof(deep) / sizeof(deep[0]); k++) {
+        cost_t by_gates, by_depth;
+        check_case(deep[k], OPTIMIZE_GATES, &by_gates);
+        check_case(deep[k], OPTIMIZE_DEPTH, &by_depth);
+        char name[64];
+        snprintf(name, sizeof(name), "%s is shallower under 'depth'", cases[deep[k]].name);
+        TEST(name);
+        ASSERT_TRUE(by_depth.depth < by_gates.depth);
+    }
+}
+
+void test_api(void) {
+    TEST_SUITE("Objective API");
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+
+    TEST("Default objective is gate count");
+    ASSERT_EQ(OPTIMIZE_GATES, compiler->circuit->objective);
+
+    TEST("Unknown objective is rejected and leaves the setting alone");
+    int rc = riscv_compiler_set_objective(compiler, (optimization_objective_t)42);
+    ASSERT_TRUE(rc == -1 && compiler->circuit->objective == OPTIMIZE_GATES);
+
+    TEST("Setting depth is visible to the builders");
+    rc = riscv_compiler_set_objective(compiler, OPTIMIZE_DEPTH);
+    ASSERT_TRUE(rc == 0 && compiler->circuit->objective == OPTIMIZE_DEPTH);
+
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("Optimization Objective Test Suite\n");
+    printf("=================================\n");
+
+    test_api();
+    test_correctness();
+    test_tradeoffs();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
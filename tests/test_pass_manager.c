@@ -0,0 +1,354 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "circuit_passes.h"
+#include "riscv_memory.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define TRIALS 200
+
+static uint32_t raw_gate(riscv_circuit_t* circuit, uint32_t l, uint32_t r, gate_type_t type) {
+    uint32_t out = riscv_circuit_allocate_wire(circuit);
+    riscv_circuit_add_gate(circuit, l, r, out, type);
+    return out;
+}
+
+// Evaluate outputs of a circuit for one assignment of the free inputs 2..n+1
+static uint64_t eval_outputs(const riscv_circuit_t* circuit, const uint32_t* outputs,
+                             size_t num_outputs, uint64_t inputs, size_t num_inputs) {
+    uint8_t* values = eval_alloc(circuit);
+    for (size_t i = 0; i < num_inputs; i++) values[2 + i] = (inputs >> i) & 1;
+    eval_run(circuit, values);
+    uint64_t result = eval_get_word(values, outputs, num_outputs);
+    free(values);
+    return result;
+}
+
+// A circuit full of things the built-in passes remove, built with raw
+// gates so nothing folds on the way in:
+//   o0 = (a ^ 0) & 1            -> a
+//   o1 = ~~b                    -> b
+//   o2 = (a & b) ^ (a & b)      -> 0, after dedup
+//   o3 = a ^ (a ^ c)            -> c
+//   o4 = (a & d) & a            -> a & d, 1 gate
+//   o5 = (c & d) ^ (c & d ^ 1)  -> 1 after dedup + fold
+// plus a dead chain and a wire driven twice
+static riscv_circuit_t* build_redundant(uint32_t* outputs) {
+    riscv_circuit_t* circuit = riscv_circuit_create(6, 6);
+    uint32_t a = 2, b = 3, c = 4, d = 5;
+
+    uint32_t t = raw_gate(circuit, a, CONSTANT_0_WIRE, GATE_XOR);
+    outputs[0] = raw_gate(circuit, t, CONSTANT_1_WIRE, GATE_AND);
+
+    t = raw_gate(circuit, b, CONSTANT_1_WIRE, GATE_XOR);
+    outputs[1] = raw_gate(circuit, t, CONSTANT_1_WIRE, GATE_XOR);
+
+    uint32_t ab1 = raw_gate(circuit, a, b, GATE_AND);
+    uint32_t ab2 = raw_gate(circuit, b, a, GATE_AND);
+    outputs[2] = raw_gate(circuit, ab1, ab2, GATE_XOR);
+
+    t = raw_gate(circuit, a, c, GATE_XOR);
+    outputs[3] = raw_gate(circuit, a, t, GATE_XOR);
+
+    t = raw_gate(circuit, a, d, GATE_AND);
+    outputs[4] = raw_gate(circuit, t, a, GATE_AND);
+
+    uint32_t cd1 = raw_gate(circuit, c, d, GATE_AND);
+    uint32_t cd2 = raw_gate(circuit, d, c, GATE_AND);
+    uint32_t ncd = raw_gate(circuit, cd2, CONSTANT_1_WIRE, GATE_XOR);
+    outputs[5] = raw_gate(circuit, cd1, ncd, GATE_XOR);
+
+    // Dead chain
+    t = raw_gate(circuit, a, b, GATE_XOR);
+    t = raw_gate(circuit, t, c, GATE_AND);
+    raw_gate(circuit, t, d, GATE_XOR);
+
+    // A wire driven twice: readers after the second driver see b & c
+    uint32_t w = raw_gate(circuit, a, b, GATE_XOR);
+    riscv_circuit_add_gate(circuit, b, c, w, GATE_AND);
+    outputs[4] = raw_gate(circuit, outputs[4], w, GATE_XOR);  // (a & d) ^ (b & c)
+
+    return circuit;
+}
+
+static uint64_t reference_redundant(uint64_t in) {
+    int a = in & 1, b = (in >> 1) & 1, c = (in >> 2) & 1, d = (in >> 3) & 1;
+    return (uint64_t)a | ((uint64_t)b << 1) | 0 | ((uint64_t)c << 3) |
+           ((uint64_t)((a & d) ^ (b & c)) << 4) | (1ULL << 5);
+}
+
+static bool redundant_matches(const riscv_circuit_t* circuit, const uint32_t* outputs) {
+    for (uint64_t in = 0; in < 16; in++) {
+        if (eval_outputs(circuit, outputs, 6, in, 4) != reference_redundant(in)) {
+            printf("(input %llu) ", (unsigned long long)in);
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_builtin_passes(void) {
+    TEST_SUITE("Built-in Passes");
+
+    uint32_t outputs[6];
+    riscv_circuit_t* circuit = build_redundant(outputs);
+    size_t gates_before = circuit->num_gates;
+
+    TEST("Redundant circuit is correct before optimization");
+    ASSERT_TRUE(redundant_matches(circuit, outputs));
+
+    pass_manager_t* pm = pass_manager_create_preset(2);
+    int rc = pass_manager_run(pm, circuit, outputs, 6);
+
+    TEST("-O2 keeps the circuit's function");
+    ASSERT_TRUE(rc == 0 && redundant_matches(circuit, outputs));
+
+    // Left: a & d, b & c and their XOR
+    TEST("-O2 leaves only the three necessary gates");
+    printf("(%zu -> %zu) ", gates_before, circuit->num_gates);
+    ASSERT_EQ(3, circuit->num_gates);
+
+    TEST("Constant outputs fold to the constant wires");
+    ASSERT_TRUE(outputs[2] == CONSTANT_0_WIRE && outputs[5] == CONSTANT_1_WIRE);
+
+    TEST("Renumbering compacts gate outputs right after the inputs");
+    ASSERT_TRUE(circuit->next_wire_id == circuit->num_inputs + 3);
+
+    pass_manager_destroy(pm);
+    eval_free_circuit(circuit);
+
+    // DCE alone removes exactly the dead chain
+    circuit = build_redundant(outputs);
+    gates_before = circuit->num_gates;
+    pm = pass_manager_create();
+    pass_manager_add(pm, "dce");
+    pass_manager_run(pm, circuit, outputs, 6);
+
+    TEST("DCE alone drops the dead chain and the overwritten driver");
+    ASSERT_TRUE(gates_before - circuit->num_gates == 4 && redundant_matches(circuit, outputs));
+
+    pass_manager_destroy(pm);
+    eval_free_circuit(circuit);
+}
+
+// A short program through the compiler, then -O0..-O3 on the result
+static const uint32_t program[] = {
+    0x002081B3,  // add  x3, x1, x2
+    0x40310233,  // sub  x4, x2, x3
+    0x0041C2B3,  // xor  x5, x3, x4
+    0x00A28313,  // addi x6, x5, 10
+    0x002081B3,  // add  x3, x1, x2   (same as the first)
+    0x0020A3B3,  // slt  x7, x1, x2
+    0x00239433,  // sll  x8, x7, x2
+    0x00000513,  // addi x10, x0, 0
+    0x00150593,  // addi x11, x10, 1
+    0x022084B3,  // mul  x9, x1, x2
+};
+#define PROGRAM_LEN (sizeof(program) / sizeof(program[0]))
+
+static bool check_program(int opt_level, size_t* before, size_t* after, pass_manager_t** pm_out) {
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    for (size_t i = 0; i < PROGRAM_LEN; i++) riscv_compile_instruction(compiler, program[i]);
+    *before = compiler->circuit->num_gates;
+
+    // Reference results before any pass
+    uint64_t seed = 0x9A55 + opt_level;
+    uint32_t inputs[TRIALS][32];
+    uint32_t expected[TRIALS][32];
+    uint8_t* values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS; t++) {
+        inputs[t][0] = 0;
+        for (int r = 1; r < 32; r++) inputs[t][r] = (uint32_t)eval_rand64(&seed);
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) expected[t][r] = eval_get_reg(compiler, values, r);
+    }
+    free(values);
+
+    pass_manager_t* pm = pass_manager_create_preset(opt_level);
+    bool ok = pass_manager_run_compiler(pm, compiler) == 0;
+    *after = compiler->circuit->num_gates;
+
+    values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) {
+            if (eval_get_reg(compiler, values, r) != expected[t][r]) {
+                printf("(x%d differs) ", r);
+                ok = false;
+                break;
+            }
+        }
+    }
+    free(values);
+
+    if (pm_out) *pm_out = pm;
+    else pass_manager_destroy(pm);
+    riscv_compiler_destroy(compiler);
+    return ok;
+}
+
+void test_presets(void) {
+    TEST_SUITE("-O0..-O3 on a Compiled Program");
+
+    size_t before = 0, after = 0;
+    TEST("-O0 changes nothing");
+    ASSERT_TRUE(check_program(0, &before, &after, NULL) && before == after);
+
+    for (int level = 1; level <= 3; level++) {
+        char name[64];
+        snprintf(name, sizeof(name), "-O%d keeps every register and never adds gates", level);
+        TEST(name);
+        bool ok = check_program(level, &before, &after, NULL);
+        printf("(%zu -> %zu) ", before, after);
+        ASSERT_TRUE(ok && after <= before);
+    }
+
+    pass_manager_t* pm = NULL;
+    check_program(2, &before, &after, &pm);
+    TEST("-O2 removes the repeated ADD");
+    ASSERT_TRUE(before - after >= 150);
+
+    TEST("Level parsing accepts -O0..-O3 only");
+    ASSERT_TRUE(pass_manager_parse_opt_level("-O0") == 0 &&
+                pass_manager_parse_opt_level("-O3") == 3 &&
+                pass_manager_parse_opt_level("2") == 2 &&
+                pass_manager_parse_opt_level("-O4") == -1 &&
+                pass_manager_parse_opt_level("-Ox") == -1 &&
+                pass_manager_create_preset(7) == NULL);
+
+    // Report of the -O2 run
+    FILE* f = tmpfile();
+    pass_manager_write_report(pm, f);
+    long size = ftell(f);
+    rewind(f);
+    char* json = calloc((size_t)size + 1, 1);
+    size_t got = fread(json, 1, (size_t)size, f);
+    fclose(f);
+
+    TEST("Report is JSON with the pipeline, fixpoint and per-pass deltas");
+    ASSERT_TRUE(got == (size_t)size && json[0] == '{' &&
+                strstr(json, "\"opt_level\": 2") &&
+                strstr(json, "\"pipeline\": [\"fold\", \"dedup\", \"dce\", \"renumber\"]") &&
+                strstr(json, "\"converged\": true") &&
+                strstr(json, "\"gate_delta\"") && strstr(json, "\"time_ms\"") &&
+                strstr(json, "\"and_gates\""));
+
+    // The last round of a converged run changed nothing
+    size_t iterations = 0;
+    sscanf(strstr(json, "\"iterations\": "), "\"iterations\": %zu", &iterations);
+    char last_round[32];
+    snprintf(last_round, sizeof(last_round), "\"iteration\": %zu,", iterations);
+    const char* last = strstr(json, last_round);
+    TEST("Fixpoint: the final round reports no change");
+    printf("(%zu rounds) ", iterations);
+    ASSERT_TRUE(iterations >= 2 && last && strstr(last, "\"changed\": true") == NULL);
+
+    free(json);
+    pass_manager_destroy(pm);
+}
+
+// Store, optimize, load, optimize: the second pass must still see the store
+#define SW_X1_X2 0x00112023   // sw x1, 0(x2)
+#define LW_X5_X2 0x00012283   // lw x5, 0(x2)
+
+void test_memory_roots(void) {
+    TEST_SUITE("Memory Across Passes");
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    riscv_memory_t* memory = riscv_memory_create_ultra_simple(compiler->circuit);
+    compiler->memory = memory;
+    pass_manager_t* pm = pass_manager_create_preset(2);
+
+    TEST("Every memory cell is a pass root");
+    ASSERT_EQ(3 * 32 + 8 * 32, riscv_memory_roots(memory, NULL));
+
+    riscv_compile_instruction(compiler, SW_X1_X2);
+    size_t store_gates = compiler->circuit->num_gates;
+    bool ok = pass_manager_run_compiler(pm, compiler) == 0;
+    TEST("-O2 keeps the store's logic");
+    ASSERT_TRUE(ok && compiler->circuit->num_gates > store_gates / 2);
+
+    riscv_compile_instruction(compiler, LW_X5_X2);
+    ok = pass_manager_run_compiler(pm, compiler) == 0;
+
+    uint64_t seed = 0x5707E;
+    uint32_t regs[32] = {0};
+    uint8_t* values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        regs[1] = (uint32_t)eval_rand64(&seed);
+        regs[2] = (uint32_t)eval_rand64(&seed);
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, regs);
+        eval_run(compiler->circuit, values);
+        ok = eval_get_reg(compiler, values, 5) == regs[1];
+    }
+    free(values);
+    TEST("A load after -O2 reads the value stored before it");
+    ASSERT_TRUE(ok);
+
+    pass_manager_destroy(pm);
+    riscv_memory_destroy_ultra_simple(memory);
+    compiler->memory = NULL;
+    riscv_compiler_destroy(compiler);
+}
+
+static int custom_runs = 0;
+
+static int count_pass(pass_context_t* ctx) {
+    (void)ctx;
+    custom_runs++;
+    return custom_runs < 3;  // Claims a change twice, then settles
+}
+
+void test_registry(void) {
+    TEST_SUITE("Pass Registry");
+
+    TEST("Passes can be registered and found by name");
+    ASSERT_TRUE(circuit_pass_register("count", count_pass, "test pass") == 0 &&
+                circuit_pass_lookup("count") != NULL);
+
+    TEST("Duplicate and unknown names are rejected");
+    pass_manager_t* pm = pass_manager_create();
+    ASSERT_TRUE(circuit_pass_register("dce", count_pass, NULL) == -1 &&
+                pass_manager_add(pm, "no-such-pass") == -1);
+
+    TEST("Registered passes iterate to a fixpoint");
+    pass_manager_add(pm, "count");
+    riscv_circuit_t* circuit = riscv_circuit_create(2, 1);
+    pass_manager_run(pm, circuit, NULL, 0);
+    ASSERT_EQ(3, custom_runs);
+
+    TEST("Iteration limit stops a pass that never settles");
+    custom_runs = -100;
+    pass_manager_set_max_iterations(pm, 5);
+    pass_manager_run(pm, circuit, NULL, 0);
+    ASSERT_EQ(-95, custom_runs);
+
+    eval_free_circuit(circuit);
+    pass_manager_destroy(pm);
+}
+
+int main(void) {
+    printf("Pass Manager Test Suite\n");
+    printf("=======================\n");
+
+    test_builtin_passes();
+    test_presets();
+    test_memory_roots();
+    test_registry();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,372 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "r1cs.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define TRIALS 40
+
+static uint32_t random_word(uint64_t* seed) {
+    // Mix in the values edge cases live at
+    static const uint32_t special[] = {0, 1, 2, 31, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF};
+    uint64_t r = eval_rand64(seed);
+    if ((r & 3) == 0) return special[(r >> 8) % (sizeof(special) / sizeof(special[0]))];
+    return (uint32_t)(r >> 16);
+}
+
+// RV32IM reference, straight-line like both backends: the PC only moves
+// on branches and jumps
+static void reference_step(uint32_t* pc, uint32_t regs[32], uint32_t ins) {
+    uint32_t rd = (ins >> 7) & 31, f3 = (ins >> 12) & 7, f7 = ins >> 25;
+    uint32_t a = regs[(ins >> 15) & 31], b = regs[(ins >> 20) & 31];
+    uint32_t imm = (uint32_t)((int32_t)ins >> 20), result = regs[rd];
+    int32_t sa = (int32_t)a, sb = (int32_t)b;
+    switch (ins & 0x7F) {
+        case 0x13:
+            b = imm;
+            sb = (int32_t)imm;
+            if (f3 == 1 || f3 == 5) b &= 31;
+            // fall through
+        case 0x33:
+            if ((ins & 0x7F) == 0x33 && f7 == 1) {
+                switch (f3) {
+                    case 0: result = a * b; break;
+                    case 1: result = (uint32_t)((uint64_t)((int64_t)sa * sb) >> 32); break;
+                    case 2: result = (uint32_t)((uint64_t)((int64_t)sa * (int64_t)b) >> 32); break;
+                    case 3: result = (uint32_t)(((uint64_t)a * b) >> 32); break;
+                    case 4: result = b == 0 ? 0xFFFFFFFF : (sa == INT32_MIN && sb == -1) ? a
+                                   : (uint32_t)(sa / sb); break;
+                    case 5: result = b == 0 ? 0xFFFFFFFF : a / b; break;
+                    case 6: result = b == 0 ? a : (sa == INT32_MIN && sb == -1) ? 0
+                                   : (uint32_t)(sa % sb); break;
+                    case 7: result = b == 0 ? a : a % b; break;
+                }
+                break;
+            }
+            switch (f3) {
+                case 0: result = (ins & 0x7F) == 0x33 && f7 == 0x20 ? a - b : a + b; break;
+                case 1: result = a << (b & 31); break;
+                case 2: result = sa < sb; break;
+                case 3: result = a < b; break;
+                case 4: result = a ^ b; break;
+                case 5: result = f7 == 0x20 ? (uint32_t)(sa >> (b & 31)) : a >> (b & 31); break;
+                case 6: result = a | b; break;
+                case 7: result = a & b; break;
+            }
+            break;
+        case 0x37: result = ins & 0xFFFFF000u; break;
+        case 0x17: result = *pc + (ins & 0xFFFFF000u); break;
+        case 0x6F: {
+            uint32_t j = ((ins >> 31) & 1) << 20 | ((ins >> 12) & 0xFF) << 12 |
+                         ((ins >> 20) & 1) << 11 | ((ins >> 21) & 0x3FF) << 1;
+            result = *pc + 4;
+            *pc += (uint32_t)((int32_t)(j << 11) >> 11);
+            break;
+        }
+        case 0x67:
+            result = *pc + 4;
+            *pc = (a + imm) & ~1u;
+            break;
+        case 0x63: {
+            bool taken = f3 == 0 ? a == b : f3 == 1 ? a != b : f3 == 4 ? sa < sb :
+                         f3 == 5 ? sa >= sb : f3 == 6 ? a < b : a >= b;
+            uint32_t o = ((ins >> 31) & 1) << 12 | ((ins >> 7) & 1) << 11 |
+                         ((ins >> 25) & 0x3F) << 5 | ((ins >> 8) & 0xF) << 1;
+            *pc += taken ? (uint32_t)((int32_t)(o << 19) >> 19) : 4;
+            break;
+        }
+    }
+    if (rd != 0) regs[rd] = result;
+}
+
+// Compiles a program and checks, on random states, that the witness
+// satisfies the system and every register and the PC match the reference.
+// The gate backend compiles it too, for its gate count.
+static bool matches_reference(const uint32_t* program, size_t count, size_t* constraints,
+                              size_t* gates) {
+    r1cs_compiler_t* rc = r1cs_compiler_create();
+    bool ok = rc && r1cs_compile_program(rc, program, count) == 0 &&
+              r1cs_compiler_finalize(rc) == 0;
+    if (constraints && rc) *constraints = rc->system->num_constraints;
+    if (gates) {
+        riscv_compiler_t* gc = riscv_compiler_create();
+        for (size_t i = 0; i < count; i++) riscv_compile_instruction(gc, program[i]);
+        *gates = gc->circuit->num_gates;
+        riscv_compiler_destroy(gc);
+    }
+
+    uint64_t seed = 0x51C5 + count + (program[0] & 0xFFFF);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        uint32_t regs[32], pc = (uint32_t)eval_rand64(&seed) & ~3u;
+        regs[0] = 0;
+        for (int r = 1; r < 32; r++) regs[r] = random_word(&seed);
+        uint64_t* witness = r1cs_compiler_solve(rc, pc, regs);
+        for (size_t i = 0; i < count; i++) reference_step(&pc, regs, program[i]);
+
+        ok = witness && r1cs_is_satisfied(rc->system, witness);
+        if (!ok) printf("(unsatisfied, trial %d) ", t);
+        for (int r = 1; r < 32 && ok; r++) {
+            uint32_t actual = r1cs_compiler_get_reg(rc, witness, r);
+            if (regs[r] != actual) {
+                printf("(x%d: expected 0x%08X, got 0x%08X) ", r, regs[r], actual);
+                ok = false;
+            }
+            // The outputs recorded by finalize hold the registers
+            ok = ok && (uint32_t)r1cs_lc_eval(&rc->system->outputs[r], witness) == actual;
+        }
+        if (ok && pc != r1cs_compiler_get_pc(rc, witness)) {
+            printf("(pc: expected 0x%08X, got 0x%08X) ", pc, r1cs_compiler_get_pc(rc, witness));
+            ok = false;
+        }
+        free(witness);
+    }
+
+    r1cs_compiler_destroy(rc);
+    return ok;
+}
+
+static bool each_agrees(const uint32_t* instructions, size_t count) {
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        if (!matches_reference(&instructions[i], 1, NULL, NULL)) {
+            printf("(instruction 0x%08X) ", instructions[i]);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+#define COUNT(a) (sizeof(a) / sizeof(a[0]))
+
+void test_instructions(void) {
+    TEST_SUITE("Instructions Against a Reference Model");
+
+    static const uint32_t alu[] = {
+        0x002081B3,  // add   x3, x1, x2
+        0x402081B3,  // sub   x3, x1, x2
+        0x0020C1B3,  // xor   x3, x1, x2
+        0x0020E1B3,  // or    x3, x1, x2
+        0x0020F1B3,  // and   x3, x1, x2
+        0x001081B3,  // add   x3, x1, x1
+        0x401080B3,  // sub   x1, x1, x1
+        0x80008193,  // addi  x3, x1, -2048
+        0x7FF0C193,  // xori  x3, x1, 2047
+        0xFFF0C193,  // xori  x3, x1, -1
+        0x0F00E193,  // ori   x3, x1, 240
+        0x0FF0F193,  // andi  x3, x1, 255
+        0x123451B7,  // lui   x3, 0x12345
+    };
+    TEST("ALU and immediates");
+    ASSERT_TRUE(each_agrees(alu, COUNT(alu)));
+
+    static const uint32_t shifts[] = {
+        0x002091B3,  // sll   x3, x1, x2
+        0x0020D1B3,  // srl   x3, x1, x2
+        0x4020D1B3,  // sra   x3, x1, x2
+        0x00409193,  // slli  x3, x1, 4
+        0x01F0D193,  // srli  x3, x1, 31
+        0x4010D193,  // srai  x3, x1, 1
+        0x41F0D193,  // srai  x3, x1, 31
+    };
+    TEST("Shifts by registers and immediates");
+    ASSERT_TRUE(each_agrees(shifts, COUNT(shifts)));
+
+    static const uint32_t compares[] = {
+        0x0020A1B3,  // slt   x3, x1, x2
+        0x0020B1B3,  // sltu  x3, x1, x2
+        0xFFF0A193,  // slti  x3, x1, -1
+        0xFFF0B193,  // sltiu x3, x1, -1
+        0x0010B193,  // sltiu x3, x1, 1
+        0x00208463,  // beq   x1, x2, 8
+        0xFE209EE3,  // bne   x1, x2, -4
+        0x0020C463,  // blt   x1, x2, 8
+        0x0020D463,  // bge   x1, x2, 8
+        0x0020E463,  // bltu  x1, x2, 8
+        0x0020F463,  // bgeu  x1, x2, 8
+    };
+    TEST("Comparisons and branches");
+    ASSERT_TRUE(each_agrees(compares, COUNT(compares)));
+
+    static const uint32_t muldiv[] = {
+        0x022081B3,  // mul    x3, x1, x2
+        0x022091B3,  // mulh   x3, x1, x2
+        0x0220A1B3,  // mulhsu x3, x1, x2
+        0x0220B1B3,  // mulhu  x3, x1, x2
+        0x0220C1B3,  // div    x3, x1, x2
+        0x0220D1B3,  // divu   x3, x1, x2
+        0x0220E1B3,  // rem    x3, x1, x2
+        0x0220F1B3,  // remu   x3, x1, x2
+        0x020081B3,  // mul    x3, x1, x0
+        0x0200C1B3,  // div    x3, x1, x0
+        0x0200F1B3,  // remu   x3, x1, x0
+    };
+    TEST("M extension, including division by zero");
+    ASSERT_TRUE(each_agrees(muldiv, COUNT(muldiv)));
+
+    static const uint32_t control[] = {
+        0x008000EF,  // jal   ra, 8
+        0xFF9FF06F,  // jal   x0, -8
+        0x004100E7,  // jalr  ra, 4(x2)
+        0x12345197,  // auipc x3, 0x12345
+        0x00000073,  // ecall
+    };
+    TEST("Jumps and AUIPC");
+    ASSERT_TRUE(each_agrees(control, COUNT(control)));
+}
+
+void test_programs(void) {
+    TEST_SUITE("Programs");
+
+    // Horner evaluation of a cubic plus running checks: arithmetic-heavy
+    static const uint32_t poly[] = {
+        0x022081B3,  // mul   x3, x1, x2
+        0x003181B3,  // add   x3, x3, x3
+        0x00518193,  // addi  x3, x3, 5
+        0x022181B3,  // mul   x3, x3, x2
+        0x00418233,  // add   x4, x3, x4
+        0x402202B3,  // sub   x5, x4, x2
+        0x0252C333,  // div   x6, x5, x5
+        0x0062F3B3,  // and   x7, x5, x6
+        0x0053A433,  // slt   x8, x7, x5
+        0x00541493,  // slli  x9, x8, 5
+        0x0090D513,  // srli  x10, x1, 9
+        0x00A48463,  // beq   x9, x10, 8
+        0x00A505B3,  // add   x11, x10, x10
+    };
+    size_t constraints = 0, gates = 0;
+    TEST("Mixed program matches the reference");
+    bool ok = matches_reference(poly, COUNT(poly), &constraints, &gates);
+    printf("(%zu gates, %zu constraints) ", gates, constraints);
+    ASSERT_TRUE(ok);
+
+    // Twenty ADD/SUB/ADDI: all lazy, reduced once per register at the end
+    uint32_t adds[20];
+    for (int i = 0; i < 20; i++) {
+        uint32_t rd = 3 + i % 4, rs1 = 1 + i % 5, rs2 = 2 + i % 3;
+        adds[i] = i % 3 == 2 ? (0x07B00013u | rd << 7 | rs1 << 15)
+                             : ((i % 3 ? 0x40000033u : 0x33u) | rd << 7 | rs1 << 15 | rs2 << 20);
+    }
+    TEST("An ADD/SUB chain costs a small fraction of its gates");
+    ok = matches_reference(adds, 20, &constraints, &gates);
+    printf("(%zu gates, %zu constraints) ", gates, constraints);
+    ASSERT_TRUE(ok && constraints * 10 <= gates);
+
+    static const uint32_t mul[] = {0x022081B3};
+    TEST("MUL is under a hundred constraints");
+    ok = matches_reference(mul, 1, &constraints, &gates);
+    printf("(%zu gates, %zu constraints) ", gates, constraints);
+    ASSERT_TRUE(ok && constraints < 100);
+}
+
+void test_soundness(void) {
+    TEST_SUITE("Soundness");
+
+    static const uint32_t program[] = {
+        0x0220B1B3,  // mulhu x3, x1, x2
+        0x0220D233,  // divu  x4, x1, x2
+        0x4020D2B3,  // sra   x5, x1, x2
+        0x0020A333,  // slt   x6, x1, x2
+    };
+    r1cs_compiler_t* rc = r1cs_compiler_create();
+    r1cs_compile_program(rc, program, COUNT(program));
+    r1cs_compiler_finalize(rc);
+    uint32_t regs[32] = {0, 0x9E3779B9, 7};
+    uint64_t* witness = r1cs_compiler_solve(rc, 0x1000, regs);
+
+    TEST("Flipping any bit or product variable breaks the system");
+    bool ok = r1cs_is_satisfied(rc->system, witness);
+    size_t tampered = 0;
+    for (uint32_t v = rc->system->num_inputs + 1; v < rc->system->num_vars && ok; v++) {
+        r1cs_hint_kind_t kind = rc->system->hints[v].kind;
+        if (kind != R1CS_HINT_BIT && kind != R1CS_HINT_MUL && kind != R1CS_HINT_DIVU &&
+            kind != R1CS_HINT_REMU) continue;
+        uint64_t saved = witness[v];
+        witness[v] = kind == R1CS_HINT_BIT ? 1 - saved : r1cs_field_add(saved, 1);
+        ok = !r1cs_is_satisfied(rc->system, witness);
+        witness[v] = saved;
+        tampered++;
+    }
+    printf("(%zu variables) ", tampered);
+    ASSERT_TRUE(ok && tampered > 0);
+    free(witness);
+    r1cs_compiler_destroy(rc);
+
+    // Inputs are trusted unless checked
+    rc = r1cs_compiler_create();
+    r1cs_compile_instruction(rc, 0x002081B3);  // add x3, x1, x2
+    r1cs_compiler_check_inputs(rc);
+    r1cs_compiler_finalize(rc);
+    uint64_t inputs[R1CS_NUM_INPUTS] = {0};
+    inputs[1] = 5;
+
+    TEST("Checked inputs accept 32-bit values");
+    witness = r1cs_solve(rc->system, inputs);
+    ASSERT_TRUE(r1cs_is_satisfied(rc->system, witness));
+    free(witness);
+
+    TEST("Checked inputs reject values of 2^32 and above");
+    inputs[1] = (1ULL << 32) + 5;
+    witness = r1cs_solve(rc->system, inputs);
+    ASSERT_FALSE(r1cs_is_satisfied(rc->system, witness));
+    free(witness);
+    r1cs_compiler_destroy(rc);
+}
+
+void test_interface(void) {
+    TEST_SUITE("Interface");
+
+    r1cs_compiler_t* rc = r1cs_compiler_create();
+    r1cs_compile_instruction(rc, 0x022081B3);  // mul x3, x1, x2
+    size_t before = rc->system->num_constraints;
+
+    TEST("Loads are rejected without touching the system");
+    int result = r1cs_compile_instruction(rc, 0x0000A183);  // lw x3, 0(x1)
+    ASSERT_TRUE(result == -1 && rc->system->num_constraints == before);
+
+    r1cs_compiler_finalize(rc);
+    TEST("Nothing compiles after finalize");
+    ASSERT_EQ(-1, r1cs_compile_instruction(rc, 0x002081B3));
+
+    const char* path = "test_r1cs_output.r1cs";
+    TEST("Export writes a header, the outputs and every constraint");
+    bool ok = r1cs_to_file(rc->system, path) == 0;
+    FILE* f = fopen(path, "r");
+    unsigned vars = 0, inputs = 0;
+    size_t outputs = 0, constraints = 0, lines = 0;
+    char line[1 << 14];
+    while (f && fgets(line, sizeof(line), f)) {
+        if (lines == 2) {
+            sscanf(line, "variables %u inputs %u outputs %zu constraints %zu",
+                   &vars, &inputs, &outputs, &constraints);
+        }
+        if (strchr(line, '\n')) lines++;
+    }
+    if (f) fclose(f);
+    remove(path);
+    ok = ok && vars == rc->system->num_vars && inputs == R1CS_NUM_INPUTS &&
+         outputs == R1CS_NUM_INPUTS && constraints == rc->system->num_constraints &&
+         lines == 3 + outputs + constraints;
+    ASSERT_TRUE(ok);
+    r1cs_compiler_destroy(rc);
+}
+
+int main(void) {
+    printf("R1CS Backend Test Suite\n");
+    printf("=======================\n");
+
+    test_instructions();
+    test_programs();
+    test_soundness();
+    test_interface();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "sat_portfolio.h"
+#include "formal_verification.h"
+#include "riscv_compiler.h"
+#include "test_framework.h"
+#include "cnf_fixtures.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define POS(v) (2 * (v))
+#define NEG(v) (2 * (v) + 1)
+
+#define ADD_X3 0x002081B3   // add  x3, x1, x2
+#define MUL_X3 0x022081B3   // mul  x3, x1, x2
+#define DIV_X3 0x0220C1B3   // div  x3, x1, x2
+
+// ============================================================================
+// Instances
+// ============================================================================
+
+static void add_cnf(sat_portfolio_t* portfolio, const cnf_t* cnf) {
+    int clause[16];
+    sat_portfolio_set_vars(portfolio, cnf->num_vars);
+    for (int c = 0; c < cnf->num_clauses; c++) {
+        int n = cnf->starts[c + 1] - cnf->starts[c];
+        memcpy(clause, cnf->lits + cnf->starts[c], sizeof(int) * n);   // add_clause sorts
+        sat_portfolio_add_clause(portfolio, clause, (size_t)n);
+    }
+}
+
+static void add_pigeonhole(sat_portfolio_t* portfolio, int pigeons, int holes) {
+    cnf_t* cnf = cnf_pigeonhole(pigeons, holes);
+    add_cnf(portfolio, cnf);
+    cnf_destroy(cnf);
+}
+
+static int model_value(const void* portfolio, int v) {
+    return sat_portfolio_value(portfolio, v);
+}
+
+// ============================================================================
+// Racing
+// ============================================================================
+
+void test_racing(void) {
+    TEST_SUITE("Racing");
+
+    TEST("One solver answers in the caller's thread");
+    sat_portfolio_t* portfolio = sat_portfolio_create(1);
+    add_pigeonhole(portfolio, 7, 6);
+    ASSERT_TRUE(sat_portfolio_solve(portfolio, NULL, 0, -1) == -1 && portfolio->races == 0 &&
+                portfolio->winner == 0);
+    sat_portfolio_destroy(portfolio);
+
+    TEST("Four solvers race on pigeonhole 9 into 8");
+    portfolio = sat_portfolio_create(4);
+    add_pigeonhole(portfolio, 9, 8);
+    int result = sat_portfolio_solve(portfolio, NULL, 0, -1);
+    printf("(solver %d won, %zu clauses shared) ", portfolio->winner, portfolio->shared_clauses);
+    ASSERT_TRUE(result == -1 && portfolio->races == 1 && portfolio->winner >= 0 &&
+                portfolio->wins[portfolio->winner] == 1);
+
+    TEST("Glue clauses are shared while racing");
+    ASSERT_TRUE(portfolio->shared_clauses > 0);
+    sat_portfolio_destroy(portfolio);
+
+    TEST("A satisfiable race leaves the winner's model");
+    portfolio = sat_portfolio_create(3);
+    portfolio->solo_conflicts = 0;
+    cnf_t* cnf = cnf_random_3sat(400, 1700, 7, true);
+    add_cnf(portfolio, cnf);
+    result = sat_portfolio_solve(portfolio, NULL, 0, -1);
+    ASSERT_TRUE(result == 1 && portfolio->races == 1 &&
+                cnf_satisfied(cnf, model_value, portfolio));
+    cnf_destroy(cnf);
+    sat_portfolio_destroy(portfolio);
+
+    TEST("Every solver out of conflicts leaves the query undecided");
+    portfolio = sat_portfolio_create(4);
+    add_pigeonhole(portfolio, 11, 10);
+    result = sat_portfolio_solve(portfolio, NULL, 0, 300);
+    ASSERT_TRUE(result == 0 && portfolio->races == 1 && portfolio->winner == -1 &&
+                sat_portfolio_value(portfolio, 0) == 0);
+    sat_portfolio_destroy(portfolio);
+
+    TEST("Portfolios hold at most 16 solvers");
+    ASSERT_TRUE(sat_portfolio_create(0) == NULL && sat_portfolio_create(17) == NULL);
+}
+
+// ============================================================================
+// Incremental use
+// ============================================================================
+
+void test_incremental(void) {
+    TEST_SUITE("Incremental Use");
+
+    TEST("Races honour assumptions");
+    sat_portfolio_t* portfolio = sat_portfolio_create(4);
+    portfolio->solo_conflicts = 0;
+    add_pigeonhole(portfolio, 8, 8);
+    int both_in_hole_0[2] = {POS(0), POS(8)};
+    int assumed = sat_portfolio_solve(portfolio, both_in_hole_0, 2, -1);
+    int free_run = sat_portfolio_solve(portfolio, NULL, 0, -1);
+    ASSERT_TRUE(assumed == -1 && free_run == 1 && portfolio->races == 2);
+
+    TEST("Clauses added between races reach every solver");
+    bool consistent = true;
+    for (int p = 0; p < 8 && consistent; p++) {
+        int not_in_hole_7 = NEG(p * 8 + 7);
+        sat_portfolio_add_clause(portfolio, &not_in_hole_7, 1);
+        int result = sat_portfolio_solve(portfolio, NULL, 0, -1);
+        consistent = result == -1 || sat_portfolio_value(portfolio, p * 8 + 7) == -1;
+    }
+    ASSERT_TRUE(consistent && sat_portfolio_solve(portfolio, NULL, 0, -1) == -1);
+    sat_portfolio_destroy(portfolio);
+}
+
+// ============================================================================
+// Equivalence checking
+// ============================================================================
+
+static verification_result_t check_mul(sat_solver_t* solver, size_t* undecided_bits) {
+    equivalence_checker_t* checker = equiv_checker_create_with(solver, NULL, MUL_X3);
+    checker->conflict_limit = 1000;
+    checker->fallback_tests = 1024;
+    verification_result_t result = equiv_checker_verify(checker);
+    *undecided_bits = checker->undecided_bits;
+    equiv_checker_destroy(checker);
+    return result;
+}
+
+void test_equivalence(void) {
+    TEST_SUITE("Equivalence Checking");
+
+    TEST("A portfolio proves MUL's low bits at least as far as one solver");
+    sat_solver_t* single = equiv_solver_create();
+    sat_solver_t* portfolio = equiv_solver_create_portfolio(4);
+    size_t single_bits, portfolio_bits;
+    verification_result_t a = check_mul(single, &single_bits);
+    verification_result_t b = check_mul(portfolio, &portfolio_bits);
+    printf("(%zu vs %zu bits simulated) ", single_bits, portfolio_bits);
+    ASSERT_TRUE(verification_result_simulated(&a) && verification_result_simulated(&b) &&
+                portfolio_bits <= single_bits);
+    verification_result_free(&a);
+    verification_result_free(&b);
+    equiv_solver_destroy(single);
+
+    TEST("A wrong circuit still gives a counterexample");
+    equivalence_checker_t* checker = equiv_checker_create_with(portfolio, NULL, ADD_X3);
+    uint32_t* x3 = checker->compiler->reg_wires[3];
+    uint32_t t = x3[5]; x3[5] = x3[6]; x3[6] = t;
+    verification_result_t result = equiv_checker_verify(checker);
+    ASSERT_TRUE(!result.verified && result.counterexample &&
+                strstr(result.counterexample, "x3 is") != NULL);
+    verification_result_free(&result);
+    equiv_checker_destroy(checker);
+    equiv_solver_destroy(portfolio);
+
+    TEST("The driver lends spare threads to its jobs");
+    verification_driver_t* driver = verification_driver_create();
+    driver->num_threads = 4;
+    verification_driver_add_instruction(driver, MUL_X3);
+    verification_driver_add_instruction(driver, DIV_X3);
+    int failed = verification_driver_run(driver);
+    printf("(%.1f s) ", driver->wall_time_ms / 1000.0);
+    ASSERT_TRUE(failed == 0 && !driver->jobs[0].result.counterexample &&
+                !driver->jobs[1].result.counterexample);
+    verification_driver_destroy(driver);
+}
+
+int main(void) {
+    printf("SAT Portfolio Test Suite\n");
+    printf("========================\n");
+
+    test_racing();
+    test_incremental();
+    test_equivalence();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
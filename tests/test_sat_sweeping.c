@@ -0,0 +1,232 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "riscv_compiler.h"
+#include "circuit_passes.h"
+#include "gate_primitives.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define TRIALS 200
+
+static riscv_circuit_t* copy_circuit(const riscv_circuit_t* circuit) {
+    riscv_circuit_t* copy = riscv_circuit_create(circuit->num_inputs, circuit->num_outputs);
+    for (size_t i = 0; i < circuit->num_gates; i++) {
+        const gate_t* g = &circuit->gates[i];
+        riscv_circuit_add_gate(copy, g->left_input, g->right_input, g->output, g->type);
+    }
+    copy->next_wire_id = circuit->next_wire_id;
+    return copy;
+}
+
+static uint64_t eval_outputs(const riscv_circuit_t* circuit, const uint32_t* outputs,
+                             size_t num_outputs, const uint8_t* inputs, size_t num_inputs) {
+    uint8_t* values = eval_alloc(circuit);
+    memcpy(values + 2, inputs, num_inputs);
+    eval_run(circuit, values);
+    uint64_t result = eval_get_word(values, outputs, num_outputs);
+    free(values);
+    return result;
+}
+
+// Runs sweep and checks the outputs against a copy taken before, on
+// random inputs and on all-ones (the case rare AND cones need)
+static bool sweep_keeps_function(riscv_circuit_t* circuit, uint32_t* outputs,
+                                 size_t num_outputs, size_t num_inputs) {
+    riscv_circuit_t* original = copy_circuit(circuit);
+    uint32_t* original_outputs = malloc(num_outputs * sizeof(uint32_t));
+    memcpy(original_outputs, outputs, num_outputs * sizeof(uint32_t));
+
+    pass_manager_t* pm = pass_manager_create();
+    pass_manager_add(pm, "sweep");
+    bool ok = pass_manager_run(pm, circuit, outputs, num_outputs) == 0;
+    pass_manager_destroy(pm);
+
+    uint64_t seed = 0x5EE9;
+    uint8_t* inputs = malloc(num_inputs);
+    for (int t = 0; t <= TRIALS && ok; t++) {
+        for (size_t i = 0; i < num_inputs; i++) {
+            inputs[i] = t == TRIALS ? 1 : (uint8_t)(eval_rand64(&seed) & 1);
+        }
+        ok = eval_outputs(circuit, outputs, num_outputs, inputs, num_inputs) ==
+             eval_outputs(original, original_outputs, num_outputs, inputs, num_inputs);
+    }
+
+    free(inputs);
+    free(original_outputs);
+    eval_free_circuit(original);
+    return ok;
+}
+
+void test_equivalent_structures(void) {
+    TEST_SUITE("Equivalent Structures");
+
+    // The same 16-bit sum from a ripple-carry and a Kogge-Stone adder
+    riscv_circuit_t* ripple = riscv_circuit_create(34, 17);
+    uint32_t a[16], b[16], sum[16];
+    for (uint32_t i = 0; i < 16; i++) {
+        a[i] = 2 + i;
+        b[i] = 18 + i;
+    }
+    build_ripple_carry_adder(ripple, a, b, sum, 16);
+    size_t ripple_gates = ripple->num_gates;
+    eval_free_circuit(ripple);
+
+    riscv_circuit_t* circuit = riscv_circuit_create(34, 32);
+    uint32_t outputs[32];
+    build_ripple_carry_adder(circuit, a, b, outputs, 16);
+    build_kogge_stone_adder(circuit, a, b, outputs + 16, 16);
+    size_t gates = circuit->num_gates;
+
+    TEST("Sweeping two adders keeps the sum");
+    ASSERT_TRUE(sweep_keeps_function(circuit, outputs, 32, 32));
+
+    TEST("Kogge-Stone sum bits merge into the ripple-carry ones");
+    bool merged = true;
+    for (size_t i = 0; i < 16; i++) merged = merged && outputs[16 + i] == outputs[i];
+    printf("(gates %zu -> %zu, ripple alone %zu) ", gates, circuit->num_gates, ripple_gates);
+    ASSERT_TRUE(merged && circuit->num_gates <= ripple_gates);
+    eval_free_circuit(circuit);
+
+    // XNOR written as a sum of products is the complement of a ^ b
+    circuit = riscv_circuit_create(4, 2);
+    uint32_t pair[2];
+    pair[0] = gate_xor(circuit, 2, 3);
+    pair[1] = gate_or(circuit, gate_and(circuit, 2, 3),
+                      gate_and(circuit, gate_not(circuit, 2), gate_not(circuit, 3)));
+
+    TEST("Complements merge through an inverter");
+    bool ok = sweep_keeps_function(circuit, pair, 2, 2);
+    printf("(%zu gates) ", circuit->num_gates);
+    ASSERT_TRUE(ok && circuit->num_gates == 2);
+    eval_free_circuit(circuit);
+
+    // (a & b) & ~a never fires, but no local rule sees it
+    circuit = riscv_circuit_create(4, 1);
+    uint32_t out = gate_and(circuit, gate_and(circuit, 2, 3), gate_not(circuit, 2));
+
+    TEST("A constant cone becomes the constant wire");
+    ok = sweep_keeps_function(circuit, &out, 1, 2);
+    ASSERT_TRUE(ok && out == CONSTANT_0_WIRE && circuit->num_gates == 0);
+    eval_free_circuit(circuit);
+}
+
+void test_simulation_false_positives(void) {
+    TEST_SUITE("Candidates Refuted by SAT");
+
+    // Two 24-input ANDs over disjoint inputs: 0 on every random pattern,
+    // yet neither is constant nor equal to the other
+    riscv_circuit_t* circuit = riscv_circuit_create(50, 2);
+    uint32_t ands[2], in[2][24];
+    for (uint32_t i = 0; i < 24; i++) {
+        in[0][i] = 2 + i;
+        in[1][i] = 26 + i;
+    }
+    ands[0] = gate_and_reduce(circuit, in[0], 24);
+    ands[1] = gate_and_reduce(circuit, in[1], 24);
+    size_t gates = circuit->num_gates;
+
+    TEST("Rarely-one wires are kept");
+    bool ok = sweep_keeps_function(circuit, ands, 2, 48);
+    ASSERT_TRUE(ok && circuit->num_gates == gates && ands[0] != ands[1] &&
+                ands[0] != CONSTANT_0_WIRE && ands[1] != CONSTANT_0_WIRE);
+
+    uint32_t* roots[2] = {&ands[0], &ands[1]};
+    pass_context_t ctx = {circuit, roots, 2};
+
+    TEST("Nothing to merge is reported as unchanged");
+    ASSERT_EQ(0, circuit_pass_sweep(&ctx));
+    eval_free_circuit(circuit);
+}
+
+// The same sum compiled for gates and for depth, then -O2: dedup cannot
+// join the two adders, sweeping can
+static const uint32_t program[] = {
+    0x002081B3,  // add  x3, x1, x2
+    0x00208233,  // add  x4, x1, x2
+    0x0041C2B3,  // xor  x5, x3, x4
+    0x0020A3B3,  // slt  x7, x1, x2
+};
+#define PROGRAM_LEN (sizeof(program) / sizeof(program[0]))
+
+void test_compiled_program(void) {
+    TEST_SUITE("Compiled Program");
+
+    riscv_compiler_t* compiler = riscv_compiler_create();
+    for (size_t i = 0; i < PROGRAM_LEN; i++) {
+        riscv_compiler_set_objective(compiler, i == 1 ? OPTIMIZE_DEPTH : OPTIMIZE_GATES);
+        riscv_compile_instruction(compiler, program[i]);
+    }
+    riscv_compiler_set_objective(compiler, OPTIMIZE_GATES);
+
+    pass_manager_t* pm = pass_manager_create_preset(2);
+    pass_manager_run_compiler(pm, compiler);
+    pass_manager_destroy(pm);
+    size_t gates = compiler->circuit->num_gates;
+
+    uint64_t seed = 0x5A7;
+    uint32_t inputs[TRIALS][32];
+    uint32_t expected[TRIALS][32];
+    uint8_t* values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS; t++) {
+        inputs[t][0] = 0;
+        for (int r = 1; r < 32; r++) inputs[t][r] = (uint32_t)eval_rand64(&seed);
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) expected[t][r] = eval_get_reg(compiler, values, r);
+    }
+    free(values);
+
+    pm = pass_manager_create();
+    pass_manager_add(pm, "sweep");
+    bool ok = pass_manager_run_compiler(pm, compiler) == 0;
+    pass_manager_destroy(pm);
+
+    values = eval_alloc(compiler->circuit);
+    for (int t = 0; t < TRIALS && ok; t++) {
+        memset(values, 0, compiler->circuit->next_wire_id);
+        eval_load_state(values, 0x1000, inputs[t]);
+        eval_run(compiler->circuit, values);
+        for (int r = 0; r < 32; r++) {
+            if (eval_get_reg(compiler, values, r) != expected[t][r]) {
+                printf("(x%d differs) ", r);
+                ok = false;
+                break;
+            }
+        }
+    }
+    free(values);
+
+    TEST("Sweeping an -O2 program keeps every register");
+    ASSERT_TRUE(ok);
+
+    TEST("Both adds share one adder and x5 = x3 ^ x4 folds to 0");
+    bool shared = true, zero = true;
+    for (int i = 0; i < 32; i++) {
+        shared = shared && compiler->reg_wires[4][i] == compiler->reg_wires[3][i];
+        zero = zero && compiler->reg_wires[5][i] == CONSTANT_0_WIRE;
+    }
+    printf("(gates %zu -> %zu) ", gates, compiler->circuit->num_gates);
+    ASSERT_TRUE(shared && zero && compiler->circuit->num_gates < gates);
+
+    riscv_compiler_destroy(compiler);
+}
+
+int main(void) {
+    printf("SAT Sweeping Test Suite\n");
+    printf("=======================\n");
+
+    test_equivalent_structures();
+    test_simulation_false_positives();
+    test_compiled_program();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
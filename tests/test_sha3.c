@@ -6,11 +6,172 @@
 #include "riscv_compiler.h"
 #include "riscv_memory.h"
 #include "test_framework.h"
+#include "circuit_eval.h"
 #include <stdlib.h>
 #include <stdio.h>
 
 INIT_TESTS();
 
+// Straightforward software Keccak used as the oracle for the sponge gadget
+static uint64_t rotl64(uint64_t x, int n) {
+    return n ? (x << n) | (x >> (64 - n)) : x;
+}
+
+static void soft_keccak_f(uint64_t A[25]) {
+    static const uint64_t rc[24] = {
+        0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+        0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+        0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+        0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+        0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+        0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+        0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+        0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+    };
+    static const int r[25] = {
+         0,  1, 62, 28, 27, 36, 44,  6, 55, 20,  3, 10, 43, 25, 39,
+        41, 45, 15, 21,  8, 18,  2, 61, 56, 14
+    };
+
+    for (int round = 0; round < 24; round++) {
+        uint64_t C[5], B[25];
+        for (int x = 0; x < 5; x++) {
+            C[x] = A[x] ^ A[x + 5] ^ A[x + 10] ^ A[x + 15] ^ A[x + 20];
+        }
+        for (int x = 0; x < 5; x++) {
+            uint64_t D = C[(x + 4) % 5] ^ rotl64(C[(x + 1) % 5], 1);
+            for (int y = 0; y < 5; y++) A[x + 5 * y] ^= D;
+        }
+        for (int x = 0; x < 5; x++) {
+            for (int y = 0; y < 5; y++) {
+                B[y + 5 * ((2 * x + 3 * y) % 5)] = rotl64(A[x + 5 * y], r[x + 5 * y]);
+            }
+        }
+        for (int y = 0; y < 5; y++) {
+            for (int x = 0; x < 5; x++) {
+                A[x + 5 * y] = B[x + 5 * y] ^ (~B[(x + 1) % 5 + 5 * y] & B[(x + 2) % 5 + 5 * y]);
+            }
+        }
+        A[0] ^= rc[round];
+    }
+}
+
+static void soft_sponge(const uint8_t* msg, size_t len, size_t rate, uint8_t pad,
+                        uint8_t* out, size_t out_len) {
+    uint64_t A[25] = {0};
+    uint8_t* bytes = (uint8_t*)A;  // Little-endian host assumed
+
+    size_t blocks = len / rate + 1;
+    for (size_t b = 0; b < blocks; b++) {
+        for (size_t i = 0; i < rate; i++) {
+            size_t m = b * rate + i;
+            uint8_t v = 0;
+            if (m < len) v = msg[m];
+            else {
+                if (m == len) v |= pad;
+                if (i == rate - 1) v |= 0x80;
+            }
+            bytes[i] ^= v;
+        }
+        soft_keccak_f(A);
+    }
+
+    size_t done = 0;
+    while (done < out_len) {
+        size_t n = out_len - done < rate ? out_len - done : rate;
+        memcpy(out + done, bytes, n);
+        done += n;
+        if (done < out_len) soft_keccak_f(A);
+    }
+}
+
+// Build a sponge over len symbolic bytes and compare against the oracle
+static bool check_sponge(size_t len, size_t rate, keccak_padding_t pad,
+                         size_t out_len, size_t* gates) {
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + len * 8, out_len * 8);
+    uint32_t* msg_wires = malloc((len * 8 + 1) * sizeof(uint32_t));
+    uint32_t* out_wires = malloc(out_len * 8 * sizeof(uint32_t));
+    for (size_t i = 0; i < len * 8; i++) msg_wires[i] = (uint32_t)(2 + i);
+
+    build_keccak_sponge(circuit, msg_wires, len, rate, pad, out_wires, out_len * 8);
+    *gates = circuit->num_gates;
+
+    uint8_t* msg = malloc(len + 1);
+    uint8_t* expected = malloc(out_len);
+    uint64_t seed = 0xC0FFEE ^ len;
+    for (size_t i = 0; i < len; i++) msg[i] = (uint8_t)eval_rand64(&seed);
+    soft_sponge(msg, len, rate, (uint8_t)pad, expected, out_len);
+
+    uint8_t* values = eval_alloc(circuit);
+    for (size_t i = 0; i < len * 8; i++) values[msg_wires[i]] = (msg[i / 8] >> (i % 8)) & 1;
+    eval_run(circuit, values);
+
+    bool ok = true;
+    for (size_t i = 0; i < out_len * 8; i++) {
+        if (values[out_wires[i]] != ((expected[i / 8] >> (i % 8)) & 1)) ok = false;
+    }
+
+    free(values);
+    free(msg);
+    free(expected);
+    free(msg_wires);
+    free(out_wires);
+    eval_free_circuit(circuit);
+    return ok;
+}
+
+// Keccak sponge gadget against the software oracle
+void test_keccak_sponge(void) {
+    TEST_SUITE("Keccak Sponge Gadget");
+
+    size_t gates = 0;
+
+    TEST("SHA3-256, 64-byte message (Merkle node)");
+    ASSERT_TRUE(check_sponge(64, 136, KECCAK_PADDING_SHA3, 32, &gates));
+
+    TEST("SHA3-256 single-block gate count");
+    printf(" (gates: %zu)", gates);
+    ASSERT_TRUE(gates < 200000);
+
+    TEST("SHA3-256, empty message");
+    ASSERT_TRUE(check_sponge(0, 136, KECCAK_PADDING_SHA3, 32, &gates));
+
+    TEST("SHA3-256, 135 bytes (padding bytes coincide)");
+    ASSERT_TRUE(check_sponge(135, 136, KECCAK_PADDING_SHA3, 32, &gates));
+
+    TEST("Keccak-256, 136 bytes (extra padding block)");
+    ASSERT_TRUE(check_sponge(136, 136, KECCAK_PADDING_KECCAK, 32, &gates));
+
+    TEST("Keccak-256, 300 bytes (three blocks)");
+    bool three_blocks = check_sponge(300, 136, KECCAK_PADDING_KECCAK, 32, &gates);
+    printf(" (gates: %zu)", gates);
+    ASSERT_TRUE(three_blocks);
+
+    TEST("SHAKE128, 400-byte output (multi-block squeeze)");
+    ASSERT_TRUE(check_sponge(20, 168, KECCAK_PADDING_SHAKE, 400, &gates));
+
+    TEST("Keccak-256 of empty string matches Ethereum");
+    {
+        static const uint8_t empty_hash[32] = {
+            0xc5, 0xd2, 0x46, 0x01, 0x86, 0xf7, 0x23, 0x3c, 0x92, 0x7e, 0x7d, 0xb2,
+            0xdc, 0xc7, 0x03, 0xc0, 0xe5, 0x00, 0xb6, 0x53, 0xca, 0x82, 0x27, 0x3b,
+            0x7b, 0xfa, 0xd8, 0x04, 0x5d, 0x85, 0xa4, 0x70
+        };
+        riscv_circuit_t* circuit = riscv_circuit_create(2, 256);
+        uint32_t out[256];
+        build_keccak_256_circuit(circuit, NULL, 0, out);
+        uint8_t* values = eval_alloc(circuit);
+        eval_run(circuit, values);
+        bool ok = true;
+        for (int i = 0; i < 256; i++) {
+            if (values[out[i]] != ((empty_hash[i / 8] >> (i % 8)) & 1)) ok = false;
+        }
+        free(values);
+        eval_free_circuit(circuit);
+        ASSERT_TRUE(ok);
+    }
+}
+
 // Test the SHA3-256 circuit implementation
 void test_sha3_256_circuit(void) {
     TEST_SUITE("SHA3-256 Circuit Implementation");
@@ -126,6 +287,7 @@ int main(void) {
     printf("=======================================\n");
     
     test_sha3_256_circuit();
+    test_keccak_sponge();
     test_memory_with_sha3();
     test_sha3_performance_impact();
     
@@ -0,0 +1,199 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "formal_verification.h"
+#include "riscv_compiler.h"
+#include "circuit_passes.h"
+#include "test_framework.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+INIT_TESTS();
+
+#define CACHE_FILE  "test_verification_driver_cache.txt"
+#define REPORT_FILE "test_verification_driver_report.json"
+
+#define ADD_X3 0x002081B3   // add  x3, x1, x2
+#define MUL_X3 0x022081B3   // mul  x3, x1, x2
+#define DIV_X3 0x0220C1B3   // div  x3, x1, x2
+
+static bool is_m_extension(riscv_instruction_t instruction) {
+    return (instruction & 0x7F) == 0x33 && (instruction >> 25) == 0x01;
+}
+
+// Every RV32I form and one form of each M operation
+static void add_forms(verification_driver_t* driver) {
+    const riscv_instruction_t* forms;
+    size_t count = verification_rv32im_forms(&forms);
+    for (size_t i = 0; i < count; i++) {
+        if (!is_m_extension(forms[i]) || i % 7 == 0) {
+            verification_driver_add_instruction(driver, forms[i]);
+        }
+    }
+}
+
+static size_t count_cached(const verification_driver_t* driver) {
+    size_t cached = 0;
+    for (size_t i = 0; i < driver->num_jobs; i++) cached += driver->jobs[i].cached;
+    return cached;
+}
+
+// Wires the first root to the second: x1 bit 0 becomes a copy of bit 1
+static int broken_pass(pass_context_t* ctx) {
+    if (ctx->num_roots < 2 || *ctx->roots[0] == *ctx->roots[1]) return 0;
+    *ctx->roots[0] = *ctx->roots[1];
+    return 1;
+}
+
+// ============================================================================
+// Instruction jobs and the cache
+// ============================================================================
+
+void test_instruction_jobs(void) {
+    TEST_SUITE("Instruction Jobs and Cache");
+    remove(CACHE_FILE);
+
+    TEST("RV32IM forms verify on four threads");
+    verification_driver_t* driver = verification_driver_create();
+    driver->num_threads = 4;
+    add_forms(driver);
+    int failed = verification_driver_run(driver);
+    size_t simulated = 0;
+    for (size_t i = 0; i < driver->num_jobs; i++) {
+        if (verification_result_simulated(&driver->jobs[i].result)) simulated++;
+    }
+    printf("(%zu jobs, %zu partly simulated, %.1f s) ", driver->num_jobs, simulated,
+           driver->wall_time_ms / 1000.0);
+    ASSERT_TRUE(failed == 0 && simulated > 0 && driver->num_proven == driver->num_jobs - simulated);
+
+    TEST("The cache round-trips through a file");
+    ASSERT_TRUE(verification_cache_save(driver, CACHE_FILE) == 0);
+    size_t proven = driver->num_proven;
+    verification_driver_destroy(driver);
+
+    TEST("A second run re-proves only the partly simulated jobs");
+    driver = verification_driver_create();
+    bool loaded = verification_cache_load(driver, CACHE_FILE) == 0 && driver->num_proven == proven;
+    add_forms(driver);
+    failed = verification_driver_run(driver);
+    printf("(%zu cached, %.1f s) ", count_cached(driver), driver->wall_time_ms / 1000.0);
+    ASSERT_TRUE(loaded && failed == 0 && count_cached(driver) == proven);
+
+    TEST("The report keeps simulated bits apart and is not fully verified");
+    verification_report_t* report = verification_driver_report(driver);
+    ASSERT_TRUE(report && !report->fully_verified && report->simulated_bits > 0 &&
+                report->undecided_bits == 0 && report->proven_entries == proven);
+    verification_report_free(report);
+
+    TEST("A new solver budget keeps the cache");
+    driver->conflict_limit = 2000;
+    failed = verification_driver_run(driver);
+    ASSERT_TRUE(failed == 0 && count_cached(driver) == proven);
+
+    TEST("Other builders miss the cache");
+    riscv_compiler_t* config = riscv_compiler_create();
+    riscv_compiler_set_gate_set(config, GATE_SET_ALL);
+    driver->compiler = config;
+    failed = verification_driver_run(driver);
+    printf("(%zu cached) ", count_cached(driver));
+    ASSERT_TRUE(failed == 0 && count_cached(driver) < proven / 2);
+    riscv_compiler_destroy(config);
+    verification_driver_destroy(driver);
+
+    TEST("A job over its time limit fails");
+    driver = verification_driver_create();
+    driver->job_timeout_seconds = 1e-9;
+    verification_driver_add_instruction(driver, DIV_X3);
+    failed = verification_driver_run(driver);
+    ASSERT_TRUE(failed == 1 && strstr(driver->jobs[0].result.counterexample, "timed out"));
+    verification_driver_destroy(driver);
+
+    TEST("Without fallback tests the report counts the bits as undecided");
+    driver = verification_driver_create();
+    driver->conflict_limit = 100;
+    driver->fallback_tests = 0;
+    verification_driver_add_instruction(driver, MUL_X3);
+    failed = verification_driver_run(driver);
+    report = verification_driver_report(driver);
+    ASSERT_TRUE(failed == 1 && report && !report->fully_verified &&
+                report->undecided_bits > 0 && report->simulated_bits == 0);
+    verification_report_free(report);
+    verification_driver_destroy(driver);
+    remove(CACHE_FILE);
+}
+
+// ============================================================================
+// Pass jobs
+// ============================================================================
+
+void test_pass_jobs(void) {
+    TEST_SUITE("Pass Jobs");
+
+    const riscv_instruction_t* forms;
+    size_t count = verification_rv32im_forms(&forms);
+
+    TEST("Passes preserve every sampled form");
+    verification_driver_t* driver = verification_driver_create();
+    static const char* passes[] = {"fold", "dedup", "rewrite", "andmin", "balance", "linear"};
+    for (size_t p = 0; p < sizeof(passes) / sizeof(passes[0]); p++) {
+        for (size_t i = p; i < count; i += 5) {
+            verification_driver_add_pass(driver, passes[p], forms[i]);
+        }
+    }
+    int failed = verification_driver_run(driver);
+    printf("(%zu jobs, %.1f s) ", driver->num_jobs, driver->wall_time_ms / 1000.0);
+    ASSERT_TRUE(failed == 0);
+    verification_driver_destroy(driver);
+
+    TEST("Unknown passes are rejected");
+    driver = verification_driver_create();
+    ASSERT_TRUE(verification_driver_add_pass(driver, "no-such-pass", ADD_X3) == -1 &&
+                driver->num_jobs == 0);
+
+    TEST("A wrong pass is caught with a counterexample");
+    circuit_pass_register("copy-root", broken_pass, "copies a root wire (test)");
+    verification_driver_add_pass(driver, "copy-root", ADD_X3);
+    verification_driver_add_pass(driver, "copy-root", MUL_X3);
+    failed = verification_driver_run(driver);
+    ASSERT_TRUE(failed == 2 && strstr(driver->jobs[0].result.counterexample, "x1 is") != NULL);
+
+    TEST("The JSON report lists every job");
+    verification_report_t* report = verification_driver_report(driver);
+    bool saved = report && !report->fully_verified && report->num_entries == 2 &&
+                 save_verification_report(report, REPORT_FILE) == 0;
+    FILE* f = fopen(REPORT_FILE, "r");
+    char text[4096] = "";
+    size_t n = f ? fread(text, 1, sizeof(text) - 1, f) : 0;
+    text[n] = '\0';
+    if (f) fclose(f);
+    ASSERT_TRUE(saved && strstr(text, "\"fully_verified\": false") &&
+                strstr(text, "\"simulated_bits\": 0") && strstr(text, "\"undecided_bits\": 0") &&
+                strstr(text, "\"pass\": \"copy-root\"") && strstr(text, "\"counterexample\""));
+    verification_report_free(report);
+    verification_driver_destroy(driver);
+    remove(REPORT_FILE);
+
+    TEST("The pipeline reports one entry per layer");
+    verification_pipeline_t* pipeline = verification_pipeline_create();
+    verification_result_t result = verify_instruction(pipeline, ADD_X3);
+    report = generate_verification_report(pipeline);
+    ASSERT_TRUE(result.verified && report->fully_verified && report->num_entries == 6 &&
+                report->entries[0].instruction == ADD_X3);
+    verification_report_free(report);
+    verification_result_free(&result);
+    verification_pipeline_destroy(pipeline);
+}
+
+int main(void) {
+    printf("Verification Driver Test Suite\n");
+    printf("==============================\n");
+
+    test_instruction_jobs();
+    test_pass_jobs();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}
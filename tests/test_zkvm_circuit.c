@@ -0,0 +1,282 @@
+/* SPDX-FileCopyrightText: 2025 Rhett Creighton
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "zkvm_circuit.h"
+#include "test_framework.h"
+#include "circuit_eval.h"
+#include <stdlib.h>
+
+INIT_TESTS();
+
+#define TRIALS 300
+
+// Edge values first, then random words
+static uint32_t test_value(int trial, uint64_t* seed) {
+    static const uint32_t edges[] = {
+        0, 1, 2, 0x80000000u, 0xFFFFFFFFu, 0x7FFFFFFFu, 0x00010000u, 0x0000FFFFu
+    };
+    if (trial < (int)(sizeof(edges) / sizeof(edges[0]))) return edges[trial];
+    uint32_t v = (uint32_t)eval_rand64(seed);
+    // Sparse values exercise the zero-count paths
+    if (trial % 3 == 0) v >>= (eval_rand64(seed) % 32);
+    return v;
+}
+
+static uint32_t ref_popcnt(uint32_t x) { return (uint32_t)__builtin_popcount(x); }
+static uint32_t ref_clz(uint32_t x) { return x ? (uint32_t)__builtin_clz(x) : 32; }
+static uint32_t ref_ctz(uint32_t x) { return x ? (uint32_t)__builtin_ctz(x) : 32; }
+static uint32_t ref_parity(uint32_t x) { return (uint32_t)__builtin_parity(x); }
+static uint32_t ref_abs(uint32_t x) { return (int32_t)x < 0 ? 0u - x : x; }
+
+static uint32_t ref_reverse(uint32_t x) {
+    uint32_t r = 0;
+    for (int i = 0; i < 32; i++) r |= ((x >> i) & 1) << (31 - i);
+    return r;
+}
+
+typedef enum { OP_POPCNT, OP_CLZ, OP_CTZ, OP_PARITY, OP_REVERSE, OP_ABS } unary_op_t;
+
+// Build one unary gadget over 32 input wires and compare against C
+static bool check_unary(unary_op_t op, uint32_t (*ref)(uint32_t), size_t* gates) {
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 32, 32);
+    uint32_t x[32], out[32];
+    for (int i = 0; i < 32; i++) x[i] = 2 + i;
+
+    switch (op) {
+        case OP_POPCNT:  zkvm_build_popcnt(circuit, x, 32, out); break;
+        case OP_CLZ:     zkvm_build_clz(circuit, x, 32, out); break;
+        case OP_CTZ:     zkvm_build_ctz(circuit, x, 32, out); break;
+        case OP_REVERSE: zkvm_build_reverse_bits(x, 32, out); break;
+        case OP_ABS:     zkvm_build_abs(circuit, x, 32, out); break;
+        case OP_PARITY:
+            out[0] = zkvm_build_parity(circuit, x, 32);
+            for (int i = 1; i < 32; i++) out[i] = CONSTANT_0_WIRE;
+            break;
+    }
+    *gates = circuit->num_gates;
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 0xC0FFEE + op;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS && ok; trial++) {
+        uint32_t v = test_value(trial, &seed);
+        eval_set_word(values, x, v, 32);
+        eval_run(circuit, values);
+        ok = ((uint32_t)eval_get_word(values, out, 32) == ref(v));
+        if (!ok) printf("(x=0x%08x got 0x%08x) ", v, (uint32_t)eval_get_word(values, out, 32));
+    }
+
+    free(values);
+    eval_free_circuit(circuit);
+    return ok;
+}
+
+void test_bit_manipulation(void) {
+    TEST_SUITE("Bit Manipulation Builders");
+
+    struct { const char* name; unary_op_t op; uint32_t (*ref)(uint32_t); size_t max_gates; } cases[] = {
+        {"popcnt (32-bit)",  OP_POPCNT,  ref_popcnt,  200},
+        {"clz (32-bit)",     OP_CLZ,     ref_clz,     200},
+        {"ctz (32-bit)",     OP_CTZ,     ref_ctz,     200},
+        {"parity (32-bit)",  OP_PARITY,  ref_parity,  31},
+        {"reverse (free)",   OP_REVERSE, ref_reverse, 0},
+        {"abs (32-bit)",     OP_ABS,     ref_abs,     100},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        size_t gates = 0;
+        TEST(cases[i].name);
+        bool ok = check_unary(cases[i].op, cases[i].ref, &gates);
+        printf("(%zu gates) ", gates);
+        ASSERT_TRUE(ok && gates <= cases[i].max_gates);
+    }
+
+    // Non power-of-two width takes the padded priority encoder path
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 20, 20);
+    uint32_t x[20], clz[20], ctz[20];
+    for (int i = 0; i < 20; i++) x[i] = 2 + i;
+    zkvm_build_clz(circuit, x, 20, clz);
+    zkvm_build_ctz(circuit, x, 20, ctz);
+
+    uint8_t* values = eval_alloc(circuit);
+    bool ok = true;
+    for (uint32_t v = 0; v < (1u << 20); v += 4099) {
+        uint32_t probe[3] = {v, 1u << (v % 20), 0};
+        for (int p = 0; p < 3; p++) {
+            uint32_t w = probe[p];
+            eval_set_word(values, x, w, 20);
+            eval_run(circuit, values);
+            uint32_t want_clz = w ? (uint32_t)__builtin_clz(w) - 12 : 20;
+            uint32_t want_ctz = w ? (uint32_t)__builtin_ctz(w) : 20;
+            if (eval_get_word(values, clz, 20) != want_clz) ok = false;
+            if (eval_get_word(values, ctz, 20) != want_ctz) ok = false;
+        }
+    }
+    free(values);
+
+    TEST("clz/ctz on 20-bit words");
+    ASSERT_TRUE(ok);
+    eval_free_circuit(circuit);
+}
+
+void test_compare_select(void) {
+    TEST_SUITE("Comparison and Selection Builders");
+
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 65, 0);
+    uint32_t a[32], b[32], mn[32], mx[32], sel[32];
+    uint32_t cond = 2 + 64;
+    for (int i = 0; i < 32; i++) {
+        a[i] = 2 + i;
+        b[i] = 34 + i;
+    }
+
+    uint32_t eq = zkvm_build_eq(circuit, a, b, 32);
+    uint32_t lt = zkvm_build_ltu(circuit, a, b, 32);
+    zkvm_build_min(circuit, a, b, 32, mn);
+    zkvm_build_max(circuit, a, b, 32, mx);
+    zkvm_build_select(circuit, cond, a, b, 32, sel);
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 99;
+    bool ok_eq = true, ok_lt = true, ok_minmax = true, ok_sel = true;
+    for (int trial = 0; trial < TRIALS; trial++) {
+        uint32_t va = test_value(trial, &seed);
+        uint32_t vb = (trial % 5 == 0) ? va : test_value(trial / 2, &seed);
+        uint8_t vc = trial & 1;
+        eval_set_word(values, a, va, 32);
+        eval_set_word(values, b, vb, 32);
+        values[cond] = vc;
+        eval_run(circuit, values);
+
+        if (values[eq] != (va == vb)) ok_eq = false;
+        if (values[lt] != (va < vb)) ok_lt = false;
+        if (eval_get_word(values, mn, 32) != (va < vb ? va : vb)) ok_minmax = false;
+        if (eval_get_word(values, mx, 32) != (va < vb ? vb : va)) ok_minmax = false;
+        if (eval_get_word(values, sel, 32) != (vc ? va : vb)) ok_sel = false;
+    }
+    free(values);
+
+    TEST("eq");
+    ASSERT_TRUE(ok_eq);
+    TEST("ltu");
+    ASSERT_TRUE(ok_lt);
+    TEST("min/max");
+    ASSERT_TRUE(ok_minmax);
+    TEST("select");
+    ASSERT_TRUE(ok_sel);
+
+    eval_free_circuit(circuit);
+
+    // ltu costs one AND per bit
+    circuit = riscv_circuit_create(2 + 64, 0);
+    zkvm_build_ltu(circuit, a, b, 32);
+    TEST("ltu gate budget");
+    ASSERT_GATES_LT(circuit, 4 * 32);
+    eval_free_circuit(circuit);
+}
+
+void test_memcmp(void) {
+    TEST_SUITE("memcmp Builder");
+
+    enum { WORDS = 3 };
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 2 * WORDS * 32, 32);
+    uint32_t a_wires[WORDS][32], b_wires[WORDS][32], out[32];
+    uint32_t* a[WORDS];
+    uint32_t* b[WORDS];
+    for (int w = 0; w < WORDS; w++) {
+        for (int i = 0; i < 32; i++) {
+            a_wires[w][i] = 2 + w * 32 + i;
+            b_wires[w][i] = 2 + (WORDS + w) * 32 + i;
+        }
+        a[w] = a_wires[w];
+        b[w] = b_wires[w];
+    }
+    zkvm_build_memcmp(circuit, a, b, WORDS, out);
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 5;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS; trial++) {
+        uint32_t va[WORDS], vb[WORDS];
+        for (int w = 0; w < WORDS; w++) {
+            va[w] = (uint32_t)eval_rand64(&seed) & 0x3;  // Small values force ties
+            vb[w] = (uint32_t)eval_rand64(&seed) & 0x3;
+            eval_set_word(values, a[w], va[w], 32);
+            eval_set_word(values, b[w], vb[w], 32);
+        }
+        int32_t expected = 0;
+        for (int w = 0; w < WORDS && expected == 0; w++) {
+            if (va[w] != vb[w]) expected = va[w] < vb[w] ? -1 : 1;
+        }
+        eval_run(circuit, values);
+        if ((int32_t)eval_get_word(values, out, 32) != expected) ok = false;
+    }
+    free(values);
+
+    TEST("memcmp over 3 words");
+    ASSERT_TRUE(ok);
+    eval_free_circuit(circuit);
+}
+
+void test_constraints(void) {
+    TEST_SUITE("Constraint Accumulator");
+
+    riscv_circuit_t* circuit = riscv_circuit_create(2 + 64, 1);
+    uint32_t a[32], b[32];
+    for (int i = 0; i < 32; i++) {
+        a[i] = 2 + i;
+        b[i] = 34 + i;
+    }
+
+    zkvm_constraints_t* cs = zkvm_constraints_create(circuit);
+    zkvm_cs_assert_ne(cs, a, b, 32);
+    zkvm_cs_assert_le(cs, a, b, 32);
+    zkvm_cs_assert_range(cs, a, 32, 10, 1000);
+    zkvm_cs_assert_bit(cs, b, 4);
+    zkvm_cs_assert(cs, CONSTANT_1_WIRE);
+    uint32_t ok_wire = zkvm_constraints_finalize(cs);
+
+    TEST("Constant-true assertions are dropped (range adds two)");
+    ASSERT_EQ(5, cs->num_conditions);
+    zkvm_constraints_destroy(cs);
+
+    uint8_t* values = eval_alloc(circuit);
+    uint64_t seed = 31337;
+    bool ok = true;
+    for (int trial = 0; trial < TRIALS; trial++) {
+        uint32_t va = (uint32_t)(eval_rand64(&seed) % 1200);
+        uint32_t vb = (uint32_t)(eval_rand64(&seed) % 1200);
+        if (trial % 7 == 0) vb = va;
+        eval_set_word(values, a, va, 32);
+        eval_set_word(values, b, vb, 32);
+        eval_run(circuit, values);
+        bool expected = va != vb && va <= vb && va >= 10 && va <= 1000 && ((vb >> 4) & 1);
+        if (values[ok_wire] != expected) ok = false;
+    }
+    free(values);
+
+    TEST("Finalized wire is the conjunction of all constraints");
+    ASSERT_TRUE(ok);
+
+    cs = zkvm_constraints_create(circuit);
+    TEST("Empty constraint set is trivially satisfied");
+    ASSERT_EQ(CONSTANT_1_WIRE, zkvm_constraints_finalize(cs));
+    zkvm_constraints_destroy(cs);
+
+    eval_free_circuit(circuit);
+}
+
+int main(void) {
+    printf("zkVM Circuit Builder Test Suite\n");
+    printf("===============================\n");
+
+    test_bit_manipulation();
+    test_compare_select();
+    test_memcmp();
+    test_constraints();
+
+    print_test_summary();
+    return g_test_results.failed_tests > 0 ? 1 : 0;
+}